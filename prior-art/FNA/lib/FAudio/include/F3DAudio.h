@@ -231,6 +231,30 @@ struct F3DAUDIO_DSP_SETTINGS
 
 #pragma pack(pop)
 
+/* See "extensions/F3DAudioBatchEXT.txt" for more details. */
+typedef struct F3DAUDIO_EMITTER_BATCH_EXT
+{
+	/* Everything but the vectors is shared by the whole batch */
+	const F3DAUDIO_EMITTER *pTemplate;
+	uint32_t EmitterCount;
+
+	/* EmitterCount entries each */
+	const float *pPositionX;
+	const float *pPositionY;
+	const float *pPositionZ;
+
+	/* Optional, each set falls back to pTemplate when NULL */
+	const float *pVelocityX;
+	const float *pVelocityY;
+	const float *pVelocityZ;
+	const float *pOrientFrontX;
+	const float *pOrientFrontY;
+	const float *pOrientFrontZ;
+	const float *pOrientTopX;
+	const float *pOrientTopY;
+	const float *pOrientTopZ;
+} F3DAUDIO_EMITTER_BATCH_EXT;
+
 /* Functions */
 
 F3DAUDIOAPI void F3DAudioInitialize(
@@ -253,6 +277,15 @@ F3DAUDIOAPI void F3DAudioCalculate(
 	F3DAUDIO_DSP_SETTINGS *pDSPSettings
 );
 
+/* See "extensions/F3DAudioBatchEXT.txt" for more details. */
+F3DAUDIOAPI void F3DAudioCalculateBatchEXT(
+	const F3DAUDIO_HANDLE Instance,
+	const F3DAUDIO_LISTENER *pListener,
+	const F3DAUDIO_EMITTER_BATCH_EXT *pEmitters,
+	uint32_t Flags,
+	F3DAUDIO_DSP_SETTINGS *pDSPSettings
+);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
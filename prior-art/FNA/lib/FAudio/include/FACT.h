@@ -538,6 +538,24 @@ FACTAPI uint32_t FACTAudioEngine_CreateStreamingWaveBank(
 	FACTWaveBank **ppWaveBank
 );
 
+/* See "extensions/MappedBankEXT.txt" for more details. */
+FACTAPI uint32_t FACTAudioEngine_CreateSoundBankFromFileEXT(
+	FACTAudioEngine *pEngine,
+	const char *szPath,
+	uint32_t dwFlags,
+	uint32_t dwAllocAttributes,
+	FACTSoundBank **ppSoundBank
+);
+
+/* See "extensions/MappedBankEXT.txt" for more details. */
+FACTAPI uint32_t FACTAudioEngine_CreateInMemoryWaveBankFromFileEXT(
+	FACTAudioEngine *pEngine,
+	const char *szPath,
+	uint32_t dwFlags,
+	uint32_t dwAllocAttributes,
+	FACTWaveBank **ppWaveBank
+);
+
 FACTAPI uint32_t FACTAudioEngine_PrepareWave(
 	FACTAudioEngine *pEngine,
 	uint32_t dwFlags,
@@ -378,7 +378,10 @@ typedef struct FAudioXMA2WaveFormatEx
 #define FAUDIO_END_OF_STREAM		0x0040
 #define FAUDIO_SEND_USEFILTER		0x0080
 #define FAUDIO_VOICE_NOSAMPLESPLAYED	0x0100
+#define FAUDIO_VOICE_SINC_EXT		0x0200
+#define FAUDIO_PARALLEL_MIX_EXT		0x4000
 #define FAUDIO_1024_QUANTUM		0x8000
+#define FAUDIO_OFFLINE_RENDER_EXT	0x20000
 
 #define FAUDIO_DEFAULT_FILTER_TYPE	FAudioLowPassFilter
 #define FAUDIO_DEFAULT_FILTER_FREQUENCY	FAUDIO_MAX_FILTER_FREQUENCY
@@ -485,6 +488,10 @@ typedef struct FAudioXMA2WaveFormatEx
 #define FAUDIO_FORMAT_XMAUDIO2		0x0166
 #define FAUDIO_FORMAT_EXTENSIBLE	0xFFFE
 
+/* See "extensions/CompressedVoiceEXT.txt" for more details. */
+#define FAUDIO_FORMAT_VORBIS_EXT	0x674F
+#define FAUDIO_FORMAT_QOA_EXT		0x514F
+
 extern FAudioGUID DATAFORMAT_SUBTYPE_PCM;
 extern FAudioGUID DATAFORMAT_SUBTYPE_IEEE_FLOAT;
 
@@ -511,7 +518,11 @@ FAUDIOAPI uint32_t FAudioLinkedVersion(void);
 /* This should be your first FAudio call.
  *
  * ppFAudio:		Filled with the FAudio core context.
- * Flags:		Can be 0 or a combination of FAUDIO_DEBUG_ENGINE and FAUDIO_1024_QUANTUM.
+ * Flags:		Can be 0 or a combination of FAUDIO_DEBUG_ENGINE,
+ *			FAUDIO_1024_QUANTUM, FAUDIO_PARALLEL_MIX_EXT and
+ *			FAUDIO_OFFLINE_RENDER_EXT.
+ *			See "extensions/ParallelMixEXT.txt" and
+ *			"extensions/OfflineRenderEXT.txt" for the latter two.
  * XAudio2Processor:	Set this to FAUDIO_DEFAULT_PROCESSOR.
  *
  * Returns 0 on success.
@@ -1342,6 +1353,81 @@ FAUDIOAPI void FAudio_SetEngineProcedureEXT(
 	void *user
 );
 
+/* FAudio Offline Render API
+ * See "extensions/OfflineRenderEXT.txt" for more information.
+ */
+
+FAUDIOAPI uint32_t FAudio_RenderEXT(
+	FAudio *audio,
+	float *pOutput,
+	uint32_t QuantumCount
+);
+
+/* FAudio Timing API
+ * See "extensions/TimingEXT.txt" for more information.
+ */
+
+#define FAUDIO_TIMING_STAGE_DECODE_EXT		0
+#define FAUDIO_TIMING_STAGE_RESAMPLE_EXT	1
+#define FAUDIO_TIMING_STAGE_EFFECT_EXT		2
+#define FAUDIO_TIMING_STAGE_MIX_EXT		3
+#define FAUDIO_TIMING_STAGE_SUBMIX_EXT		4
+#define FAUDIO_TIMING_STAGE_MASTER_EXT		5
+#define FAUDIO_TIMING_STAGE_COUNT_EXT		6
+
+typedef struct FAudioQuantumTimingEXT
+{
+	uint64_t Quantum;	/* Engine updates since the engine was created */
+	uint64_t TotalNS;	/* Wall time for the whole update */
+	uint64_t StageNS[FAUDIO_TIMING_STAGE_COUNT_EXT];
+	uint64_t SlowestVoiceNS;
+	FAudioVoice *SlowestVoice; /* Compare only, it may be destroyed! */
+	uint32_t DroppedQuanta;	/* Updates lost to a full ring before this one */
+} FAudioQuantumTimingEXT;
+
+typedef struct FAudioVoiceTimingEXT
+{
+	uint64_t TotalNS;	/* Summed over every timed update */
+	uint64_t PeakNS;	/* Slowest single update */
+	uint64_t LastNS;	/* Most recent update */
+	uint64_t Quanta;	/* Number of timed updates */
+} FAudioVoiceTimingEXT;
+
+FAUDIOAPI uint32_t FAudio_GetQuantumTimingsEXT(
+	FAudio *audio,
+	FAudioQuantumTimingEXT *pTimings,
+	uint32_t TimingCount
+);
+
+FAUDIOAPI void FAudioVoice_GetTimingEXT(
+	FAudioVoice *voice,
+	FAudioVoiceTimingEXT *pTiming
+);
+
+/* FAudio MSADPCM Cache API
+ * See "extensions/ADPCMCacheEXT.txt" for more information.
+ */
+
+typedef struct FAudioADPCMCacheStatsEXT
+{
+	uint32_t BudgetBytes;
+	uint32_t UsedBytes;	/* Can exceed the budget while entries are pinned */
+	uint32_t Entries;
+	uint64_t Hits;
+	uint64_t Misses;
+	uint64_t Evictions;
+} FAudioADPCMCacheStatsEXT;
+
+FAUDIOAPI void FAudio_SetADPCMCacheBudgetEXT(
+	FAudio *audio,
+	uint32_t BudgetBytes
+);
+
+FAUDIOAPI void FAudio_GetADPCMCacheStatsEXT(
+	FAudio *audio,
+	FAudioADPCMCacheStatsEXT *pStats
+);
+
 
 /* FAudio I/O API */
 
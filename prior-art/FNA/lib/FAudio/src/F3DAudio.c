@@ -30,6 +30,17 @@
 #include <math.h> /* ONLY USE THIS FOR isnan! */
 #include <float.h> /* ONLY USE THIS FOR FLT_MIN/FLT_MAX! */
 
+/* F3DAudioCalculateBatchEXT only needs the baseline instruction sets, see
+ * FAudio_internal_simd.c for the full detection.
+ */
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm64ec__) || defined(_M_ARM64EC)
+#include <arm_neon.h>
+#define HAVE_NEON_INTRINSICS 1
+#elif defined(__SSE2__) || defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HAVE_SSE2_INTRINSICS 1
+#endif
+
 /* VS2010 doesn't define isnan (which is C99), so here it is. */
 #if defined(_MSC_VER) && !defined(isnan)
 #define isnan(x) _isnan(x)
@@ -1177,7 +1188,8 @@ static inline void ComputeEmitterChannelCoefficients(
  * -Adrien
  */
 static inline void CalculateMatrix(
-	uint32_t ChannelMask,
+	const ConfigInfo *curConfig,
+	const F3DAUDIO_BASIS *listenerBasis,
 	uint32_t Flags,
 	const F3DAUDIO_LISTENER *pListener,
 	const F3DAUDIO_EMITTER *pEmitter,
@@ -1190,7 +1202,6 @@ static inline void CalculateMatrix(
 ) {
 	uint32_t iEC;
 	float curEmAzimuth;
-	const ConfigInfo* curConfig = GetConfigInfo(ChannelMask);
 	float attenuation = ComputeDistanceAttenuation(
 		normalizedDistance,
 		pEmitter->pVolumeCurve
@@ -1203,7 +1214,6 @@ static inline void CalculateMatrix(
 
 	F3DAUDIO_VECTOR listenerToEmitter;
 	F3DAUDIO_VECTOR listenerToEmChannel;
-	F3DAUDIO_BASIS listenerBasis;
 
 	/* Note: For both cone calculations, the angle might be NaN or infinite
 	 * if distance == 0... ComputeConeParameter *does* check for this
@@ -1278,12 +1288,6 @@ static inline void CalculateMatrix(
 	{
 		listenerToEmitter = VectorScale(emitterToListener, -1.0f);
 
-		/* Remember here that the coordinate system is Left-Handed. */
-		listenerBasis.front = pListener->OrientFront;
-		listenerBasis.right = VectorCross(pListener->OrientTop, pListener->OrientFront);
-		listenerBasis.top = pListener->OrientTop;
-
-
 		/* Handling the mono-channel emitter case separately is easier
 		 * than having it as a separate case of a for-loop; indeed, in
 		 * this case, we need to ignore the non-relevant values from the
@@ -1295,7 +1299,7 @@ static inline void CalculateMatrix(
 
 			ComputeEmitterChannelCoefficients(
 				curConfig,
-				&listenerBasis,
+				listenerBasis,
 				pEmitter->InnerRadius,
 				listenerToEmChannel,
 				attenuation,
@@ -1338,7 +1342,7 @@ static inline void CalculateMatrix(
 
 					ComputeEmitterChannelCoefficients(
 						curConfig,
-						&listenerBasis,
+						listenerBasis,
 						pEmitter->InnerRadius,
 						listenerToEmChannel,
 						attenuation,
@@ -1376,7 +1380,8 @@ static inline void CalculateMatrix(
 static inline void CalculateDoppler(
 	float SpeedOfSound,
 	const F3DAUDIO_LISTENER* pListener,
-	const F3DAUDIO_EMITTER* pEmitter,
+	F3DAUDIO_VECTOR emitterVelocity,
+	float DopplerScaler,
 	F3DAUDIO_VECTOR emitterToListener,
 	float eToLDistance,
 	float* listenerVelocityComponent,
@@ -1392,7 +1397,7 @@ static inline void CalculateDoppler(
 		*listenerVelocityComponent =
 			VectorDot(emitterToListener, pListener->Velocity) / eToLDistance;
 		*emitterVelocityComponent =
-			VectorDot(emitterToListener, pEmitter->Velocity) / eToLDistance;
+			VectorDot(emitterToListener, emitterVelocity) / eToLDistance;
 	}
 	else
 	{
@@ -1400,9 +1405,9 @@ static inline void CalculateDoppler(
 		*emitterVelocityComponent = 0.0f;
 	}
 
-	if (pEmitter->DopplerScaler > 0.0f)
+	if (DopplerScaler > 0.0f)
 	{
-		scaledSpeedOfSound = SpeedOfSound / pEmitter->DopplerScaler;
+		scaledSpeedOfSound = SpeedOfSound / DopplerScaler;
 
 		/* Clamp... */
 		*listenerVelocityComponent = FAudio_min(
@@ -1416,9 +1421,9 @@ static inline void CalculateDoppler(
 
 		/* ... then Multiply. */
 		*DopplerFactor = (
-			SpeedOfSound - pEmitter->DopplerScaler * *listenerVelocityComponent
+			SpeedOfSound - DopplerScaler * *listenerVelocityComponent
 		) / (
-			SpeedOfSound - pEmitter->DopplerScaler * *emitterVelocityComponent
+			SpeedOfSound - DopplerScaler * *emitterVelocityComponent
 		);
 		if (isnan(*DopplerFactor)) /* If emitter/listener are at the same pos... */
 		{
@@ -1434,38 +1439,49 @@ static inline void CalculateDoppler(
 	}
 }
 
-void F3DAudioCalculate(
+/* Used when the emitter doesn't have its own LPF/reverb curves */
+#define DEFAULT_POINTS(name, x1, y1, x2, y2) \
+	static F3DAUDIO_DISTANCE_CURVE_POINT name##Points[2] = \
+	{ \
+		{ x1, y1 }, \
+		{ x2, y2 } \
+	}; \
+	static F3DAUDIO_DISTANCE_CURVE name##Default = \
+	{ \
+		(F3DAUDIO_DISTANCE_CURVE_POINT*) &name##Points[0], 2 \
+	};
+DEFAULT_POINTS(lpfDirect, 0.0f, 1.0f, 1.0f, 0.75f)
+DEFAULT_POINTS(lpfReverb, 0.0f, 0.75f, 1.0f, 0.75f)
+DEFAULT_POINTS(reverb, 0.0f, 1.0f, 1.0f, 0.0f)
+#undef DEFAULT_POINTS
+
+static inline void ComputeListenerBasis(
+	const F3DAUDIO_LISTENER *pListener,
+	F3DAUDIO_BASIS *listenerBasis
+) {
+	/* Remember here that the coordinate system is Left-Handed. */
+	listenerBasis->front = pListener->OrientFront;
+	listenerBasis->right = VectorCross(pListener->OrientTop, pListener->OrientFront);
+	listenerBasis->top = pListener->OrientTop;
+}
+
+/* Everything but the distance and Doppler, which F3DAudioCalculateBatchEXT
+ * computes for several emitters at once. curConfig and listenerBasis only
+ * depend on the Instance and listener, and are only needed for MATRIX.
+ */
+static inline void CalculateEmitter(
 	const F3DAUDIO_HANDLE Instance,
+	const ConfigInfo *curConfig,
+	const F3DAUDIO_BASIS *listenerBasis,
 	const F3DAUDIO_LISTENER *pListener,
 	const F3DAUDIO_EMITTER *pEmitter,
 	uint32_t Flags,
+	F3DAUDIO_VECTOR emitterToListener,
+	float eToLDistance,
 	F3DAUDIO_DSP_SETTINGS *pDSPSettings
 ) {
 	uint32_t i;
-	F3DAUDIO_VECTOR emitterToListener;
-	float eToLDistance, normalizedDistance, dp;
-
-	#define DEFAULT_POINTS(name, x1, y1, x2, y2) \
-		static F3DAUDIO_DISTANCE_CURVE_POINT name##Points[2] = \
-		{ \
-			{ x1, y1 }, \
-			{ x2, y2 } \
-		}; \
-		static F3DAUDIO_DISTANCE_CURVE name##Default = \
-		{ \
-			(F3DAUDIO_DISTANCE_CURVE_POINT*) &name##Points[0], 2 \
-		};
-	DEFAULT_POINTS(lpfDirect, 0.0f, 1.0f, 1.0f, 0.75f)
-	DEFAULT_POINTS(lpfReverb, 0.0f, 0.75f, 1.0f, 0.75f)
-	DEFAULT_POINTS(reverb, 0.0f, 1.0f, 1.0f, 0.0f)
-	#undef DEFAULT_POINTS
-
-	/* For XACT, this calculates "Distance" */
-	emitterToListener = VectorSub(pListener->Position, pEmitter->Position);
-	eToLDistance = VectorLength(emitterToListener);
-	pDSPSettings->EmitterToListenerDistance = eToLDistance;
-
-	F3DAudioCheckCalculateParams(Instance, pListener, pEmitter, Flags, pDSPSettings);
+	float normalizedDistance, dp;
 
 	/* This is used by MATRIX, LPF, and REVERB */
 	normalizedDistance = eToLDistance / pEmitter->CurveDistanceScaler;
@@ -1473,7 +1489,8 @@ void F3DAudioCalculate(
 	if (Flags & F3DAUDIO_CALCULATE_MATRIX)
 	{
 		CalculateMatrix(
-			SPEAKERMASK(Instance),
+			curConfig,
+			listenerBasis,
 			Flags,
 			pListener,
 			pEmitter,
@@ -1516,21 +1533,6 @@ void F3DAudioCalculate(
 		);
 	}
 
-	/* For XACT, this calculates "DopplerPitchScalar" */
-	if (Flags & F3DAUDIO_CALCULATE_DOPPLER)
-	{
-		CalculateDoppler(
-			SPEEDOFSOUND(Instance),
-			pListener,
-			pEmitter,
-			emitterToListener,
-			eToLDistance,
-			&pDSPSettings->ListenerVelocityComponent,
-			&pDSPSettings->EmitterVelocityComponent,
-			&pDSPSettings->DopplerFactor
-		);
-	}
-
 	/* For XACT, this calculates "OrientationAngle" */
 	if (Flags & F3DAUDIO_CALCULATE_EMITTER_ANGLE)
 	{
@@ -1562,4 +1564,439 @@ void F3DAudioCalculate(
 	}
 }
 
+void F3DAudioCalculate(
+	const F3DAUDIO_HANDLE Instance,
+	const F3DAUDIO_LISTENER *pListener,
+	const F3DAUDIO_EMITTER *pEmitter,
+	uint32_t Flags,
+	F3DAUDIO_DSP_SETTINGS *pDSPSettings
+) {
+	F3DAUDIO_VECTOR emitterToListener;
+	float eToLDistance;
+	const ConfigInfo *curConfig = NULL;
+	F3DAUDIO_BASIS listenerBasis;
+
+	/* For XACT, this calculates "Distance" */
+	emitterToListener = VectorSub(pListener->Position, pEmitter->Position);
+	eToLDistance = VectorLength(emitterToListener);
+	pDSPSettings->EmitterToListenerDistance = eToLDistance;
+
+	F3DAudioCheckCalculateParams(Instance, pListener, pEmitter, Flags, pDSPSettings);
+
+	if (Flags & F3DAUDIO_CALCULATE_MATRIX)
+	{
+		curConfig = GetConfigInfo(SPEAKERMASK(Instance));
+		ComputeListenerBasis(pListener, &listenerBasis);
+	}
+
+	CalculateEmitter(
+		Instance,
+		curConfig,
+		&listenerBasis,
+		pListener,
+		pEmitter,
+		Flags,
+		emitterToListener,
+		eToLDistance,
+		pDSPSettings
+	);
+
+	/* For XACT, this calculates "DopplerPitchScalar" */
+	if (Flags & F3DAUDIO_CALCULATE_DOPPLER)
+	{
+		CalculateDoppler(
+			SPEEDOFSOUND(Instance),
+			pListener,
+			pEmitter->Velocity,
+			pEmitter->DopplerScaler,
+			emitterToListener,
+			eToLDistance,
+			&pDSPSettings->ListenerVelocityComponent,
+			&pDSPSettings->EmitterVelocityComponent,
+			&pDSPSettings->DopplerFactor
+		);
+	}
+}
+
+/*
+ * BATCH CALCULATION
+ */
+
+/* Batches are done a block at a time: first the distance and Doppler of every
+ * emitter in the block, 4 at a time, then everything else one emitter at a
+ * time. The blocks are kept small enough to live on the stack.
+ */
+#define BATCH_BLOCK_SIZE 64
+
+typedef struct BatchBlock
+{
+	float toListenerX[BATCH_BLOCK_SIZE];
+	float toListenerY[BATCH_BLOCK_SIZE];
+	float toListenerZ[BATCH_BLOCK_SIZE];
+	float distance[BATCH_BLOCK_SIZE];
+	float listenerVelocity[BATCH_BLOCK_SIZE];
+	float emitterVelocity[BATCH_BLOCK_SIZE];
+	float doppler[BATCH_BLOCK_SIZE];
+} BatchBlock;
+
+/* The SIMD paths do exactly the same operations as VectorSub, VectorLength and
+ * CalculateDoppler, in the same order, so both produce identical results.
+ */
+static void CalculateBatchDistances(
+	float SpeedOfSound,
+	const F3DAUDIO_LISTENER *pListener,
+	const F3DAUDIO_EMITTER_BATCH_EXT *pEmitters,
+	uint32_t start,
+	uint32_t count,
+	uint8_t doppler,
+	BatchBlock *block
+) {
+	uint32_t i = 0;
+	const float *px = pEmitters->pPositionX + start;
+	const float *py = pEmitters->pPositionY + start;
+	const float *pz = pEmitters->pPositionZ + start;
+	const float *vx = NULL, *vy = NULL, *vz = NULL;
+	const float dopplerScaler = pEmitters->pTemplate->DopplerScaler;
+	F3DAUDIO_VECTOR emitterToListener, emitterVelocity;
+
+	emitterVelocity = pEmitters->pTemplate->Velocity;
+	if (pEmitters->pVelocityX != NULL)
+	{
+		vx = pEmitters->pVelocityX + start;
+		vy = pEmitters->pVelocityY + start;
+		vz = pEmitters->pVelocityZ + start;
+	}
+
+#if HAVE_SSE2_INTRINSICS
+	{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 four = _mm_set1_ps(4.0f);
+	const __m128 lx = _mm_set1_ps(pListener->Position.x);
+	const __m128 ly = _mm_set1_ps(pListener->Position.y);
+	const __m128 lz = _mm_set1_ps(pListener->Position.z);
+	const __m128 lvx = _mm_set1_ps(pListener->Velocity.x);
+	const __m128 lvy = _mm_set1_ps(pListener->Velocity.y);
+	const __m128 lvz = _mm_set1_ps(pListener->Velocity.z);
+	const __m128 sos = _mm_set1_ps(SpeedOfSound);
+	const __m128 ds = _mm_set1_ps(dopplerScaler);
+	const __m128 scaledSos = _mm_set1_ps(
+		(dopplerScaler > 0.0f) ? (SpeedOfSound / dopplerScaler) : 0.0f
+	);
+	__m128 dx, dy, dz, dist, nonZero, evx, evy, evz, lv, ev, factor, isNaN;
+
+	evx = _mm_set1_ps(emitterVelocity.x);
+	evy = _mm_set1_ps(emitterVelocity.y);
+	evz = _mm_set1_ps(emitterVelocity.z);
+
+	for (; (i + 4) <= count; i += 4)
+	{
+		dx = _mm_sub_ps(lx, _mm_loadu_ps(px + i));
+		dy = _mm_sub_ps(ly, _mm_loadu_ps(py + i));
+		dz = _mm_sub_ps(lz, _mm_loadu_ps(pz + i));
+		dist = _mm_sqrt_ps(_mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+			_mm_mul_ps(dz, dz)
+		));
+		_mm_storeu_ps(block->toListenerX + i, dx);
+		_mm_storeu_ps(block->toListenerY + i, dy);
+		_mm_storeu_ps(block->toListenerZ + i, dz);
+		_mm_storeu_ps(block->distance + i, dist);
+
+		if (!doppler)
+		{
+			continue;
+		}
+
+		if (vx != NULL)
+		{
+			evx = _mm_loadu_ps(vx + i);
+			evy = _mm_loadu_ps(vy + i);
+			evz = _mm_loadu_ps(vz + i);
+		}
+
+		/* Project... */
+		nonZero = _mm_cmpneq_ps(dist, zero);
+		lv = _mm_and_ps(nonZero, _mm_div_ps(_mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(dx, lvx), _mm_mul_ps(dy, lvy)),
+			_mm_mul_ps(dz, lvz)
+		), dist));
+		ev = _mm_and_ps(nonZero, _mm_div_ps(_mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(dx, evx), _mm_mul_ps(dy, evy)),
+			_mm_mul_ps(dz, evz)
+		), dist));
+
+		if (dopplerScaler > 0.0f)
+		{
+			/* Clamp... (minps is exactly FAudio_min) */
+			lv = _mm_min_ps(lv, scaledSos);
+			ev = _mm_min_ps(ev, scaledSos);
+
+			/* ... then Multiply. */
+			factor = _mm_div_ps(
+				_mm_sub_ps(sos, _mm_mul_ps(ds, lv)),
+				_mm_sub_ps(sos, _mm_mul_ps(ds, ev))
+			);
+			isNaN = _mm_cmpunord_ps(factor, factor);
+			factor = _mm_or_ps(
+				_mm_and_ps(isNaN, one),
+				_mm_andnot_ps(isNaN, factor)
+			);
+			factor = _mm_max_ps(_mm_min_ps(factor, four), half);
+		}
+		else
+		{
+			factor = one;
+		}
+		_mm_storeu_ps(block->listenerVelocity + i, lv);
+		_mm_storeu_ps(block->emitterVelocity + i, ev);
+		_mm_storeu_ps(block->doppler + i, factor);
+	}
+	}
+#elif HAVE_NEON_INTRINSICS
+	{
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+	const float32x4_t one = vdupq_n_f32(1.0f);
+	const float32x4_t half = vdupq_n_f32(0.5f);
+	const float32x4_t four = vdupq_n_f32(4.0f);
+	const float32x4_t lx = vdupq_n_f32(pListener->Position.x);
+	const float32x4_t ly = vdupq_n_f32(pListener->Position.y);
+	const float32x4_t lz = vdupq_n_f32(pListener->Position.z);
+	const float32x4_t lvx = vdupq_n_f32(pListener->Velocity.x);
+	const float32x4_t lvy = vdupq_n_f32(pListener->Velocity.y);
+	const float32x4_t lvz = vdupq_n_f32(pListener->Velocity.z);
+	const float32x4_t sos = vdupq_n_f32(SpeedOfSound);
+	const float32x4_t ds = vdupq_n_f32(dopplerScaler);
+	const float32x4_t scaledSos = vdupq_n_f32(
+		(dopplerScaler > 0.0f) ? (SpeedOfSound / dopplerScaler) : 0.0f
+	);
+	float32x4_t dx, dy, dz, dist, evx, evy, evz, lv, ev, factor;
+	uint32x4_t isZero;
+
+	evx = vdupq_n_f32(emitterVelocity.x);
+	evy = vdupq_n_f32(emitterVelocity.y);
+	evz = vdupq_n_f32(emitterVelocity.z);
+
+	/* vminq/vmaxq don't match FAudio_min/clamp for NaN, so we select */
+	for (; (i + 4) <= count; i += 4)
+	{
+		dx = vsubq_f32(lx, vld1q_f32(px + i));
+		dy = vsubq_f32(ly, vld1q_f32(py + i));
+		dz = vsubq_f32(lz, vld1q_f32(pz + i));
+		dist = vsqrtq_f32(vaddq_f32(
+			vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy)),
+			vmulq_f32(dz, dz)
+		));
+		vst1q_f32(block->toListenerX + i, dx);
+		vst1q_f32(block->toListenerY + i, dy);
+		vst1q_f32(block->toListenerZ + i, dz);
+		vst1q_f32(block->distance + i, dist);
+
+		if (!doppler)
+		{
+			continue;
+		}
+
+		if (vx != NULL)
+		{
+			evx = vld1q_f32(vx + i);
+			evy = vld1q_f32(vy + i);
+			evz = vld1q_f32(vz + i);
+		}
+
+		/* Project... */
+		isZero = vceqq_f32(dist, zero);
+		lv = vbslq_f32(isZero, zero, vdivq_f32(vaddq_f32(
+			vaddq_f32(vmulq_f32(dx, lvx), vmulq_f32(dy, lvy)),
+			vmulq_f32(dz, lvz)
+		), dist));
+		ev = vbslq_f32(isZero, zero, vdivq_f32(vaddq_f32(
+			vaddq_f32(vmulq_f32(dx, evx), vmulq_f32(dy, evy)),
+			vmulq_f32(dz, evz)
+		), dist));
+
+		if (dopplerScaler > 0.0f)
+		{
+			/* Clamp... */
+			lv = vbslq_f32(vcltq_f32(lv, scaledSos), lv, scaledSos);
+			ev = vbslq_f32(vcltq_f32(ev, scaledSos), ev, scaledSos);
+
+			/* ... then Multiply. */
+			factor = vdivq_f32(
+				vsubq_f32(sos, vmulq_f32(ds, lv)),
+				vsubq_f32(sos, vmulq_f32(ds, ev))
+			);
+			factor = vbslq_f32(vceqq_f32(factor, factor), factor, one);
+			factor = vbslq_f32(
+				vcgtq_f32(factor, four),
+				four,
+				vbslq_f32(vcltq_f32(factor, half), half, factor)
+			);
+		}
+		else
+		{
+			factor = one;
+		}
+		vst1q_f32(block->listenerVelocity + i, lv);
+		vst1q_f32(block->emitterVelocity + i, ev);
+		vst1q_f32(block->doppler + i, factor);
+	}
+	}
+#endif
+
+	/* Whatever's left over (or everything, without SIMD) */
+	for (; i < count; i += 1)
+	{
+		emitterToListener = VectorSub(
+			pListener->Position,
+			Vec(px[i], py[i], pz[i])
+		);
+		block->toListenerX[i] = emitterToListener.x;
+		block->toListenerY[i] = emitterToListener.y;
+		block->toListenerZ[i] = emitterToListener.z;
+		block->distance[i] = VectorLength(emitterToListener);
+
+		if (doppler)
+		{
+			if (vx != NULL)
+			{
+				emitterVelocity = Vec(vx[i], vy[i], vz[i]);
+			}
+			CalculateDoppler(
+				SpeedOfSound,
+				pListener,
+				emitterVelocity,
+				dopplerScaler,
+				emitterToListener,
+				block->distance[i],
+				&block->listenerVelocity[i],
+				&block->emitterVelocity[i],
+				&block->doppler[i]
+			);
+		}
+	}
+}
+
+void F3DAudioCalculateBatchEXT(
+	const F3DAUDIO_HANDLE Instance,
+	const F3DAUDIO_LISTENER *pListener,
+	const F3DAUDIO_EMITTER_BATCH_EXT *pEmitters,
+	uint32_t Flags,
+	F3DAUDIO_DSP_SETTINGS *pDSPSettings
+) {
+	uint32_t start, count, i;
+	const uint8_t doppler = (Flags & F3DAUDIO_CALCULATE_DOPPLER) != 0;
+	const ConfigInfo *curConfig = NULL;
+	F3DAUDIO_BASIS listenerBasis;
+	F3DAUDIO_EMITTER emitter;
+	F3DAUDIO_DSP_SETTINGS *settings;
+	BatchBlock block;
+
+	POINTER_CHECK(Instance);
+	POINTER_CHECK(pListener);
+	POINTER_CHECK(pEmitters);
+	POINTER_CHECK(pEmitters->pTemplate);
+	if (pEmitters->EmitterCount == 0)
+	{
+		return;
+	}
+	POINTER_CHECK(pDSPSettings);
+	POINTER_CHECK(pEmitters->pPositionX);
+	POINTER_CHECK(pEmitters->pPositionY);
+	POINTER_CHECK(pEmitters->pPositionZ);
+	if (pEmitters->pVelocityX != NULL)
+	{
+		POINTER_CHECK(pEmitters->pVelocityY);
+		POINTER_CHECK(pEmitters->pVelocityZ);
+	}
+	if (pEmitters->pOrientFrontX != NULL)
+	{
+		POINTER_CHECK(pEmitters->pOrientFrontY);
+		POINTER_CHECK(pEmitters->pOrientFrontZ);
+	}
+	if (pEmitters->pOrientTopX != NULL)
+	{
+		POINTER_CHECK(pEmitters->pOrientTopY);
+		POINTER_CHECK(pEmitters->pOrientTopZ);
+	}
+
+	/* This is all F3DAudioCalculate would otherwise redo for every emitter */
+	if (Flags & F3DAUDIO_CALCULATE_MATRIX)
+	{
+		curConfig = GetConfigInfo(SPEAKERMASK(Instance));
+		ComputeListenerBasis(pListener, &listenerBasis);
+	}
+
+	/* Position and Velocity are only used by CalculateBatchDistances */
+	emitter = *pEmitters->pTemplate;
+
+	for (start = 0; start < pEmitters->EmitterCount; start += BATCH_BLOCK_SIZE)
+	{
+		count = pEmitters->EmitterCount - start;
+		if (count > BATCH_BLOCK_SIZE)
+		{
+			count = BATCH_BLOCK_SIZE;
+		}
+
+		CalculateBatchDistances(
+			SPEEDOFSOUND(Instance),
+			pListener,
+			pEmitters,
+			start,
+			count,
+			doppler,
+			&block
+		);
+
+		for (i = 0; i < count; i += 1)
+		{
+			if (pEmitters->pOrientFrontX != NULL)
+			{
+				emitter.OrientFront = Vec(
+					pEmitters->pOrientFrontX[start + i],
+					pEmitters->pOrientFrontY[start + i],
+					pEmitters->pOrientFrontZ[start + i]
+				);
+			}
+			if (pEmitters->pOrientTopX != NULL)
+			{
+				emitter.OrientTop = Vec(
+					pEmitters->pOrientTopX[start + i],
+					pEmitters->pOrientTopY[start + i],
+					pEmitters->pOrientTopZ[start + i]
+				);
+			}
+
+			settings = &pDSPSettings[start + i];
+			settings->EmitterToListenerDistance = block.distance[i];
+
+			F3DAudioCheckCalculateParams(Instance, pListener, &emitter, Flags, settings);
+
+			CalculateEmitter(
+				Instance,
+				curConfig,
+				&listenerBasis,
+				pListener,
+				&emitter,
+				Flags,
+				Vec(
+					block.toListenerX[i],
+					block.toListenerY[i],
+					block.toListenerZ[i]
+				),
+				block.distance[i],
+				settings
+			);
+
+			if (doppler)
+			{
+				settings->ListenerVelocityComponent = block.listenerVelocity[i];
+				settings->EmitterVelocityComponent = block.emitterVelocity[i];
+				settings->DopplerFactor = block.doppler[i];
+			}
+		}
+	}
+}
+
 /* vim: set noexpandtab shiftwidth=8 tabstop=8: */
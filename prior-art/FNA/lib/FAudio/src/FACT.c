@@ -223,6 +223,8 @@ uint32_t FACTAudioEngine_Initialize(
 		pEngine->variableNames = NULL;
 		pEngine->globalVariableValues = NULL;
 		pEngine->rpcs = NULL;
+		pEngine->rpcResults = NULL;
+		pEngine->dirtyVariables = NULL;
 		pEngine->dspPresets = NULL;
 	}
 	else
@@ -321,9 +323,14 @@ uint32_t FACTAudioEngine_Initialize(
 
 		/* We can release now, the submix owns this! */
 		FAPOBase_Release((FAPOBase*) reverbDesc.pEffect);
+
+		/* The engine thread sets the parameters on its first update */
+		pEngine->reverbDirty = true;
 	}
 
 	pEngine->initialized = true;
+	pEngine->apiWake = FAudio_PlatformCreateSemaphore(0);
+	pEngine->waveEndedLock = FAudio_PlatformCreateMutex();
 	pEngine->apiThread = FAudio_PlatformCreateThread(
 		FACT_INTERNAL_APIThread,
 		"FACT Thread",
@@ -344,6 +351,7 @@ uint32_t FACTAudioEngine_ShutDown(FACTAudioEngine *pEngine)
 
 	/* Close thread, then lock ASAP */
 	pEngine->initialized = false;
+	FAudio_PlatformSignalSemaphore(pEngine->apiWake);
 	FAudio_PlatformWaitThread(pEngine->apiThread, NULL);
 	FAudio_PlatformLockMutex(pEngine->apiLock);
 
@@ -372,6 +380,9 @@ uint32_t FACTAudioEngine_ShutDown(FACTAudioEngine *pEngine)
 		FACTSoundBank_Destroy((FACTSoundBank*) pEngine->sbList->entry);
 	}
 
+	/* Every streaming Wave is gone, nothing is left to read */
+	FACT_INTERNAL_StopStreamingThreads(pEngine);
+
 	/* Category data */
 	for (i = 0; i < pEngine->categoryCount; i += 1)
 	{
@@ -393,9 +404,12 @@ uint32_t FACTAudioEngine_ShutDown(FACTAudioEngine *pEngine)
 	for (i = 0; i < pEngine->rpcCount; i += 1)
 	{
 		pEngine->pFree(pEngine->rpcs[i].points);
+		pEngine->pFree(pEngine->rpcs[i].segments);
 	}
 	pEngine->pFree(pEngine->rpcs);
 	pEngine->pFree(pEngine->rpcCodes);
+	pEngine->pFree(pEngine->rpcResults);
+	pEngine->pFree(pEngine->dirtyVariables);
 
 	/* DSP data */
 	for (i = 0; i < pEngine->dspPresetCount; i += 1)
@@ -419,6 +433,11 @@ uint32_t FACTAudioEngine_ShutDown(FACTAudioEngine *pEngine)
 		FAudio_Release(pEngine->audio);
 	}
 
+	/* Engine thread data */
+	FAudio_PlatformDestroySemaphore(pEngine->apiWake);
+	FAudio_PlatformDestroyMutex(pEngine->waveEndedLock);
+	pEngine->pFree(pEngine->cueHeap);
+
 	/* Finally. */
 	refcount = pEngine->refcount;
 	mutex = pEngine->apiLock;
@@ -500,6 +519,86 @@ uint32_t FACTAudioEngine_CreateSoundBank(
 	return retval;
 }
 
+uint32_t FACTAudioEngine_CreateSoundBankFromFileEXT(
+	FACTAudioEngine *pEngine,
+	const char *szPath,
+	uint32_t dwFlags,
+	uint32_t dwAllocAttributes,
+	FACTSoundBank **ppSoundBank
+) {
+	void *mem;
+	size_t size;
+	uint32_t retval;
+
+	mem = FAudio_PlatformMapFile(szPath, &size);
+	if (mem == NULL)
+	{
+		return FAUDIO_E_INVALID_ARG;
+	}
+	if (size > 0x7FFFFFFF) /* FAudio_memopen takes an int */
+	{
+		FAudio_PlatformUnmapFile(mem, size);
+		return FACTENGINE_E_INVALIDDATA;
+	}
+
+	/* The parser copies everything it keeps, so we're done with it after */
+	retval = FACTAudioEngine_CreateSoundBank(
+		pEngine,
+		mem,
+		(uint32_t) size,
+		dwFlags & ~FACT_FLAG_MANAGEDATA,
+		dwAllocAttributes,
+		ppSoundBank
+	);
+	FAudio_PlatformUnmapFile(mem, size);
+	return retval;
+}
+
+uint32_t FACTAudioEngine_CreateInMemoryWaveBankFromFileEXT(
+	FACTAudioEngine *pEngine,
+	const char *szPath,
+	uint32_t dwFlags,
+	uint32_t dwAllocAttributes,
+	FACTWaveBank **ppWaveBank
+) {
+	void *mem;
+	size_t size;
+	uint32_t retval;
+
+	mem = FAudio_PlatformMapFile(szPath, &size);
+	if (mem == NULL)
+	{
+		return FAUDIO_E_INVALID_ARG;
+	}
+	if (size > 0x7FFFFFFF) /* FAudio_memopen takes an int */
+	{
+		FAudio_PlatformUnmapFile(mem, size);
+		return FACTENGINE_E_INVALIDDATA;
+	}
+
+	/* Waves point straight into the mapping, which the WaveBank owns */
+	FAudio_PlatformLockMutex(pEngine->apiLock);
+	retval = FACTAudioEngine_CreateInMemoryWaveBank(
+		pEngine,
+		mem,
+		(uint32_t) size,
+		dwFlags,
+		dwAllocAttributes,
+		ppWaveBank
+	);
+	if (retval == 0)
+	{
+		(*ppWaveBank)->mapping = mem;
+		(*ppWaveBank)->mappingSize = size;
+	}
+	else
+	{
+		FAudio_PlatformUnmapFile(mem, size);
+	}
+	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	return retval;
+}
+
 uint32_t FACTAudioEngine_CreateInMemoryWaveBank(
 	FACTAudioEngine *pEngine,
 	const void *pvBuffer,
@@ -566,6 +665,12 @@ uint32_t FACTAudioEngine_CreateStreamingWaveBank(
 		true,
 		ppWaveBank
 	);
+	if (retval == 0)
+	{
+		/* Waves read ahead in packets of this size, see PrepareStream */
+		(*ppWaveBank)->streamPacketSize = pParms->packetSize * 2048;
+		FACT_INTERNAL_StartStreamingThreads(pEngine);
+	}
 	if (pEngine->notifications & (1u << FACTNOTIFICATIONTYPE_WAVEBANKPREPARED))
 	{
 		if (pEngine->wavebank_notification_count == pEngine->wavebank_notifications_capacity)
@@ -994,6 +1099,9 @@ uint32_t FACTAudioEngine_SetVolume(
 			);
 		}
 	}
+
+	/* Playing Waves pick up category volumes when their Cue updates */
+	FACT_INTERNAL_WakeAllCues(pEngine);
 	FAudio_PlatformUnlockMutex(pEngine->apiLock);
 	return 0;
 }
@@ -1065,6 +1173,8 @@ uint32_t FACTAudioEngine_SetGlobalVariable(
 		var->minValue,
 		var->maxValue
 	);
+	FACT_MARK_VARIABLE(pEngine->dirtyVariables, nIndex);
+	FAudio_PlatformSignalSemaphore(pEngine->apiWake);
 	FAudio_PlatformUnlockMutex(pEngine->apiLock);
 	return 0;
 }
@@ -1202,6 +1312,7 @@ uint32_t FACTSoundBank_Prepare(
 	FACTCue** ppCue
 ) {
 	uint16_t i;
+	size_t memsize;
 	FACTCue *latest;
 
 	if (pSoundBank == NULL)
@@ -1263,10 +1374,31 @@ uint32_t FACTSoundBank_Prepare(
 		(*ppCue)->variableValues[i] =
 			pSoundBank->parentEngine->variables[i].initialValue;
 	}
+	if (pSoundBank->parentEngine->rpcCount > 0)
+	{
+		(*ppCue)->rpcResults = (float*) pSoundBank->parentEngine->pMalloc(
+			sizeof(float) * pSoundBank->parentEngine->rpcCount
+		);
+		memsize = sizeof(uint32_t) * FACT_VARIABLE_WORDS(
+			pSoundBank->parentEngine->variableCount
+		);
+		(*ppCue)->dirtyVariables = (uint32_t*) pSoundBank->parentEngine->pMalloc(
+			FAudio_max(memsize, sizeof(uint32_t))
+		);
+		FAudio_memset((*ppCue)->dirtyVariables, 0xFF, memsize);
+	}
 
 	/* Playback */
 	(*ppCue)->state = FACT_STATE_PREPARED;
 
+	/* Interactive variations poll their variable, even before playing */
+	if (	!((*ppCue)->data->flags & CUE_FLAG_SINGLE_SOUND) &&
+		(*ppCue)->variation &&
+		(*ppCue)->variation->type == VARIATION_TABLE_TYPE_INTERACTIVE	)
+	{
+		FACT_INTERNAL_WakeCue(*ppCue);
+	}
+
 	/* Add to the SoundBank Cue list */
 	if (pSoundBank->cueList == NULL)
 	{
@@ -1482,9 +1614,12 @@ uint32_t FACTSoundBank_Destroy(FACTSoundBank *pSoundBank)
 			pSoundBank->parentEngine->pFree(
 				pSoundBank->sounds[i].tracks[j].events
 			);
+			pSoundBank->parentEngine->pFree(
+				pSoundBank->sounds[i].tracks[j].rpcs
+			);
 		}
 		pSoundBank->parentEngine->pFree(pSoundBank->sounds[i].tracks);
-		pSoundBank->parentEngine->pFree(pSoundBank->sounds[i].rpcCodes);
+		pSoundBank->parentEngine->pFree(pSoundBank->sounds[i].rpcs);
 		pSoundBank->parentEngine->pFree(pSoundBank->sounds[i].dspCodes);
 	}
 	pSoundBank->parentEngine->pFree(pSoundBank->sounds);
@@ -1632,6 +1767,13 @@ uint32_t FACTWaveBank_Destroy(FACTWaveBank *pWaveBank)
 	{
 		FAudio_close(pWaveBank->io);
 	}
+	if (pWaveBank->mapping != NULL)
+	{
+		FAudio_PlatformUnmapFile(
+			pWaveBank->mapping,
+			pWaveBank->mappingSize
+		);
+	}
 
 	if (pWaveBank->packetBuffer != NULL)
 	{
@@ -1653,7 +1795,7 @@ uint32_t FACTWaveBank_Destroy(FACTWaveBank *pWaveBank)
 	}
 	FAudio_PlatformDestroyMutex(pWaveBank->waveLock);
 
-	if (pWaveBank->waveBankNames != NULL)
+	if (pWaveBank->waveBankNames != NULL && pWaveBank->streaming)
 	{
 		pWaveBank->parentEngine->pFree(pWaveBank->waveBankNames);
 	}
@@ -1813,6 +1955,7 @@ uint32_t FACTWaveBank_Prepare(
 	} format;
 	FACTWaveBankEntry *entry;
 	FACTSeekTable *seek;
+	uint32_t bytesPerSecond;
 	if (pWaveBank == NULL)
 	{
 		*ppWave = NULL;
@@ -1966,41 +2109,67 @@ uint32_t FACTWaveBank_Prepare(
 	if (pWaveBank->streaming)
 	{
 		/* Init stream cache info */
-		if (format.pcm.wFormatTag == FAUDIO_FORMAT_PCM)
+		if (	format.pcm.wFormatTag == FAUDIO_FORMAT_PCM ||
+			format.pcm.wFormatTag == FAUDIO_FORMAT_MSADPCM	)
 		{
-			(*ppWave)->streamSize = (
-				format.pcm.nSamplesPerSec *
-				format.pcm.nBlockAlign
-			);
-		}
-		else if (format.pcm.wFormatTag == FAUDIO_FORMAT_MSADPCM)
-		{
-			(*ppWave)->streamSize = (
-				format.pcm.nSamplesPerSec /
-				format.adpcm.wSamplesPerBlock *
-				format.pcm.nBlockAlign
+			if (format.pcm.wFormatTag == FAUDIO_FORMAT_PCM)
+			{
+				bytesPerSecond = (
+					format.pcm.nSamplesPerSec *
+					format.pcm.nBlockAlign
+				);
+			}
+			else
+			{
+				bytesPerSecond = (
+					format.pcm.nSamplesPerSec /
+					format.adpcm.wSamplesPerBlock *
+					format.pcm.nBlockAlign
+				);
+			}
+
+			/* Use the packet size the application asked for, rounded
+			 * down to whole blocks. Without one, a second per packet.
+			 */
+			if (pWaveBank->streamPacketSize > 0)
+			{
+				(*ppWave)->streamSize = FAudio_max(
+					pWaveBank->streamPacketSize / format.pcm.nBlockAlign,
+					1
+				) * format.pcm.nBlockAlign;
+			}
+			else
+			{
+				(*ppWave)->streamSize = bytesPerSecond;
+			}
+
+			/* Small packets still keep a quarter second in flight */
+			(*ppWave)->streamPacketCount = (uint8_t) FAudio_clamp(
+				(bytesPerSecond / 4 + (*ppWave)->streamSize - 1) /
+					(*ppWave)->streamSize,
+				pWaveBank->parentEngine->streamPrefetch,
+				FACT_STREAM_MAX_PACKETS
 			);
 		}
 		else
 		{
 			/* Screw it, load the whole thing */
 			(*ppWave)->streamSize = entry->PlayRegion.dwLength;
+			(*ppWave)->streamPacketCount = 1;
 
 			/* XACT does NOT support loop subregions for these formats */
 			FAudio_assert(entry->LoopRegion.dwStartSample == 0);
 			FAudio_assert(entry->LoopRegion.dwTotalSamples == 0 || entry->LoopRegion.dwTotalSamples == entry->Duration);
 		}
-		(*ppWave)->streamCache = (uint8_t*) pWaveBank->parentEngine->pMalloc(
-			(*ppWave)->streamSize
-		);
 		(*ppWave)->streamOffset = entry->PlayRegion.dwOffset;
 
-		/* Read and submit first buffer from the WaveBank */
-		FACT_INTERNAL_OnBufferEnd(&(*ppWave)->callback.callback, NULL);
+		/* Allocate the packets, read the first one and queue the rest */
+		FACT_INTERNAL_PrepareStream(*ppWave);
 	}
 	else
 	{
 		(*ppWave)->streamCache = NULL;
+		(*ppWave)->streamPackets = NULL;
 
 		buffer.Flags = FAUDIO_END_OF_STREAM;
 		buffer.AudioBytes = entry->PlayRegion.dwLength;
@@ -2133,11 +2302,22 @@ uint32_t FACTWave_Destroy(FACTWave *pWave)
 		pWave->parentBank->parentEngine->pFree
 	);
 
+	/* The I/O threads may still be reading into this Wave */
+	if (pWave->streamPackets != NULL)
+	{
+		FACT_INTERNAL_CancelStream(pWave);
+	}
+
 	FAudioVoice_DestroyVoice(pWave->voice);
 	if (pWave->streamCache != NULL)
 	{
 		pWave->parentBank->parentEngine->pFree(pWave->streamCache);
 	}
+	if (pWave->streamPackets != NULL)
+	{
+		pWave->parentBank->parentEngine->pFree(pWave->streamPackets);
+		FAudio_PlatformDestroyMutex(pWave->streamLock);
+	}
 	if (pWave->notifyOnDestroy || (pWave->parentBank->parentEngine->notifications & (1u << FACTNOTIFICATIONTYPE_WAVEDESTROYED)))
 	{
 		note.type = FACTNOTIFICATIONTYPE_WAVEDESTROYED;
@@ -2417,7 +2597,8 @@ uint32_t FACTWave_GetProperties(
 
 uint32_t FACTCue_Destroy(FACTCue *pCue)
 {
-	FACTCue *cue, *prev;
+	FACTAudioEngine *engine;
+	FACTCue *cue, *prev, **link;
 	FAudioMutex mutex;
 	if (pCue == NULL)
 	{
@@ -2428,6 +2609,22 @@ uint32_t FACTCue_Destroy(FACTCue *pCue)
 
 	/* Stop before we start deleting everything */
 	FACTCue_Stop(pCue, FACT_FLAG_STOP_IMMEDIATE);
+	FACT_INTERNAL_UnscheduleCue(pCue);
+
+	/* Don't leave this Cue for the engine thread's Wave end check */
+	engine = pCue->parentBank->parentEngine;
+	FAudio_PlatformLockMutex(engine->waveEndedLock);
+	if (pCue->waveEndedQueued)
+	{
+		link = &engine->waveEndedList;
+		while (*link != pCue)
+		{
+			link = &(*link)->waveEndedNext;
+		}
+		*link = pCue->waveEndedNext;
+		pCue->waveEndedQueued = false;
+	}
+	FAudio_PlatformUnlockMutex(engine->waveEndedLock);
 
 	/* Remove this Cue from the SoundBank list */
 	cue = pCue->parentBank->cueList;
@@ -2452,6 +2649,8 @@ uint32_t FACTCue_Destroy(FACTCue *pCue)
 	FAudio_assert(cue != NULL && "Could not find Cue reference!");
 
 	pCue->parentBank->parentEngine->pFree(pCue->variableValues);
+	pCue->parentBank->parentEngine->pFree(pCue->rpcResults);
+	pCue->parentBank->parentEngine->pFree(pCue->dirtyVariables);
 	FACT_INTERNAL_SendCueNotification(pCue, FACTNOTIFICATIONTYPE_CUEDESTROYED);
 
 	mutex = pCue->parentBank->parentEngine->apiLock;
@@ -2576,6 +2775,7 @@ uint32_t FACTCue_Play(FACTCue *pCue)
 	FACT_INTERNAL_SendCueNotification(pCue, FACTNOTIFICATIONTYPE_CUEPLAY);
 
 	pCue->start = FAudio_timems();
+	FACT_INTERNAL_WakeCue(pCue);
 
 	/* If it's a simple wave, just play it! */
 	if (pCue->simpleWave != NULL)
@@ -2681,6 +2881,7 @@ uint32_t FACTCue_Stop(FACTCue *pCue, uint32_t dwFlags)
 	}
 
 	FACT_INTERNAL_SendCueNotification(pCue, FACTNOTIFICATIONTYPE_CUESTOP);
+	FACT_INTERNAL_WakeCue(pCue);
 
 	FAudio_PlatformUnlockMutex(pCue->parentBank->parentEngine->apiLock);
 	return 0;
@@ -2800,6 +3001,7 @@ uint32_t FACTCue_SetVariable(
 		var->minValue,
 		var->maxValue
 	);
+	FACT_MARK_VARIABLE(pCue->dirtyVariables, nIndex);
 
 	FAudio_PlatformUnlockMutex(pCue->parentBank->parentEngine->apiLock);
 	return 0;
@@ -2870,6 +3072,9 @@ uint32_t FACTCue_Pause(FACTCue *pCue, int32_t fPause)
 		pCue->state &= ~FACT_STATE_PAUSED;
 	}
 
+	/* Paused Cues go idle, resumed ones pick up where they left off */
+	FACT_INTERNAL_WakeCue(pCue);
+
 	/* Pause the Waves */
 	if (pCue->simpleWave != NULL)
 	{
@@ -803,24 +803,18 @@ bool FACT_INTERNAL_CreateSound(FACTCue *cue, uint16_t fadeInMS)
 		cue->maxRpcReleaseTime = 0;
 		for (i = 0; i < newSound->sound->trackCount; i += 1)
 		{
-			for (j = 0; j < newSound->sound->tracks[i].rpcCodeCount; j += 1)
+			for (j = 0; j < newSound->sound->tracks[i].rpcCount; j += 1)
 			{
-				rpc = FACT_INTERNAL_GetRPC(
-					newSound->parentCue->parentBank->parentEngine,
-					newSound->sound->tracks[i].rpcCodes[j]
-				);
+				rpc = &newSound->parentCue->parentBank->parentEngine->rpcs[
+					newSound->sound->tracks[i].rpcs[j]
+				];
 				if (	rpc->parameter == RPC_PARAMETER_VOLUME &&
-					(cue->parentBank->parentEngine->variables[rpc->variable].accessibility & ACCESSIBILITY_CUE))
+					rpc->source == RPC_SOURCE_RELEASETIME	)
 				{
-					if (FAudio_strcmp(
-						newSound->parentCue->parentBank->parentEngine->variableNames[rpc->variable],
-						"ReleaseTime"
-					) == 0) {
-						lastX = rpc->points[rpc->pointCount - 1].x;
-						if (lastX > cue->maxRpcReleaseTime)
-						{
-							cue->maxRpcReleaseTime = (uint32_t) lastX /* bleh */;
-						}
+					lastX = rpc->points[rpc->pointCount - 1].x;
+					if (lastX > cue->maxRpcReleaseTime)
+					{
+						cue->maxRpcReleaseTime = (uint32_t) lastX /* bleh */;
 					}
 				}
 			}
@@ -911,6 +905,7 @@ void FACT_INTERNAL_BeginFadeOut(FACTSoundInstance *sound, uint16_t fadeOutMS)
 	sound->fadeTarget = fadeOutMS;
 
 	sound->parentCue->state |= FACT_STATE_STOPPING;
+	FACT_INTERNAL_WakeCue(sound->parentCue);
 }
 
 void FACT_INTERNAL_BeginReleaseRPC(FACTSoundInstance *sound, uint16_t releaseMS)
@@ -927,11 +922,12 @@ void FACT_INTERNAL_BeginReleaseRPC(FACTSoundInstance *sound, uint16_t releaseMS)
 	sound->fadeTarget = releaseMS;
 
 	sound->parentCue->state |= FACT_STATE_STOPPING;
+	FACT_INTERNAL_WakeCue(sound->parentCue);
 }
 
 /* RPC Helper Functions */
 
-FACTRPC* FACT_INTERNAL_GetRPC(
+uint16_t FACT_INTERNAL_GetRPCIndex(
 	FACTAudioEngine *engine,
 	uint32_t code
 ) {
@@ -940,19 +936,68 @@ FACTRPC* FACT_INTERNAL_GetRPC(
 	{
 		if (engine->rpcCodes[i] == code)
 		{
-			return &engine->rpcs[i];
+			return i;
 		}
 	}
 
 	FAudio_assert(0 && "RPC code not found!");
-	return NULL;
+	return 0;
+}
+
+void FACT_INTERNAL_CompileRPC(
+	FACTAudioEngine *engine,
+	FACTRPC *rpc
+) {
+	FACTRPCSegment *seg;
+	uint8_t i;
+
+	/* Cue variables are looked up by name, so do that just once */
+	if (!(engine->variables[rpc->variable].accessibility & ACCESSIBILITY_CUE))
+	{
+		rpc->source = RPC_SOURCE_GLOBAL;
+	}
+	else if (FAudio_strcmp(
+		engine->variableNames[rpc->variable],
+		"AttackTime"
+	) == 0) {
+		rpc->source = RPC_SOURCE_ATTACKTIME;
+	}
+	else if (FAudio_strcmp(
+		engine->variableNames[rpc->variable],
+		"ReleaseTime"
+	) == 0) {
+		rpc->source = RPC_SOURCE_RELEASETIME;
+	}
+	else
+	{
+		rpc->source = RPC_SOURCE_CUE;
+	}
+
+	if (rpc->pointCount < 2)
+	{
+		rpc->segments = NULL;
+		return;
+	}
+	rpc->segments = (FACTRPCSegment*) engine->pMalloc(
+		sizeof(FACTRPCSegment) * (rpc->pointCount - 1)
+	);
+	for (i = 0; i < rpc->pointCount - 1; i += 1)
+	{
+		seg = &rpc->segments[i];
+		seg->x = rpc->points[i].x;
+		seg->y = rpc->points[i].y;
+		seg->width = rpc->points[i + 1].x - rpc->points[i].x;
+		seg->height = rpc->points[i + 1].y - rpc->points[i].y;
+		seg->type = rpc->points[i].type;
+	}
 }
 
 float FACT_INTERNAL_CalculateRPC(
 	FACTRPC *rpc,
 	float var
 ) {
-	float result;
+	const FACTRPCSegment *seg;
+	float t;
 	uint8_t i;
 
 	/* Min/Max */
@@ -968,53 +1013,84 @@ float FACT_INTERNAL_CalculateRPC(
 	}
 
 	/* Something between points */
-	result = 0.0f;
-	for (i = 0; i < rpc->pointCount - 1; i += 1)
+	for (i = 0; i < rpc->pointCount - 2; i += 1)
 	{
-		/* y = b */
-		result = rpc->points[i].y;
-		if (var >= rpc->points[i].x && var <= rpc->points[i + 1].x)
+		if (var <= rpc->points[i + 1].x && var >= rpc->points[i].x)
 		{
-			const float maxX = rpc->points[i + 1].x - rpc->points[i].x;
-			const float maxY = rpc->points[i + 1].y - rpc->points[i].y;
-			const float deltaX = (var - rpc->points[i].x);
-			const float deltaXNormalized = deltaX / maxX;
+			break;
+		}
+	}
+	seg = &rpc->segments[i];
+	if (var < seg->x || var > rpc->points[i + 1].x || seg->width == 0.0f)
+	{
+		/* Points out of order or stacked, hold the segment's start */
+		return seg->y;
+	}
+	t = (var - seg->x) / seg->width;
 
-			switch (rpc->points[i].type)
-			{
-				case RPC_POINT_TYPE_LINEAR:
-					result += maxY * deltaXNormalized;
-					break;
+	switch (seg->type)
+	{
+		case RPC_POINT_TYPE_LINEAR:
+			return seg->y + seg->height * t;
 
-				case RPC_POINT_TYPE_FAST:
-					result += maxY * (1.0f - FAudio_powf(1.0f - FAudio_powf(deltaXNormalized, 1.0f / 1.5f), 1.5f));
-					break;
+		case RPC_POINT_TYPE_FAST:
+			return seg->y + seg->height * (1.0f - FAudio_powf(1.0f - FAudio_powf(t, 1.0f / 1.5f), 1.5f));
 
-				case RPC_POINT_TYPE_SLOW:
-					result += maxY * (1.0f - FAudio_powf(1.0f - FAudio_powf(deltaXNormalized, 1.5f), 1.0f / 1.5f));
-					break;
+		case RPC_POINT_TYPE_SLOW:
+			return seg->y + seg->height * (1.0f - FAudio_powf(1.0f - FAudio_powf(t, 1.5f), 1.0f / 1.5f));
 
-				case RPC_POINT_TYPE_SINCOS:
-					if (maxY > 0.0f)
-						result += maxY * (1.0f - FAudio_powf(1.0f - FAudio_sqrtf(deltaXNormalized), 2.0f));
-					else
-						result += maxY * (1.0f - FAudio_sqrtf(1.0f - FAudio_powf(deltaXNormalized, 2.0f)));
-					break;
+		case RPC_POINT_TYPE_SINCOS:
+			if (seg->height > 0.0f)
+				return seg->y + seg->height * (1.0f - FAudio_powf(1.0f - FAudio_sqrtf(t), 2.0f));
+			return seg->y + seg->height * (1.0f - FAudio_sqrtf(1.0f - FAudio_powf(t, 2.0f)));
 
-				default:
-					FAudio_assert(0 && "Unrecognized curve type!");
-			}
+		default:
+			FAudio_assert(0 && "Unrecognized curve type!");
+	}
+	return seg->y;
+}
 
-			break;
+void FACT_INTERNAL_CalculateDirtyRPCs(
+	FACTAudioEngine *engine,
+	uint8_t source,
+	const float *variableValues,
+	uint32_t *dirtyVariables,
+	float *results
+) {
+	const uint16_t words = FACT_VARIABLE_WORDS(engine->variableCount);
+	uint32_t dirty = 0;
+	FACTRPC *rpc;
+	uint16_t i;
+
+	for (i = 0; i < words; i += 1)
+	{
+		dirty |= dirtyVariables[i];
+	}
+	if (dirty == 0)
+	{
+		return;
+	}
+
+	/* Redo every curve reading a variable that changed, in one pass */
+	for (i = 0; i < engine->rpcCount; i += 1)
+	{
+		rpc = &engine->rpcs[i];
+		if (	rpc->source == source &&
+			FACT_VARIABLE_MARKED(dirtyVariables, rpc->variable)	)
+		{
+			results[i] = FACT_INTERNAL_CalculateRPC(
+				rpc,
+				variableValues[rpc->variable]
+			);
 		}
 	}
-	return result;
+	FAudio_zero(dirtyVariables, sizeof(uint32_t) * words);
 }
 
-void FACT_INTERNAL_UpdateRPCs(
+static void FACT_INTERNAL_UpdateRPCs(
 	FACTCue *cue,
-	uint8_t codeCount,
-	uint32_t *codes,
+	uint8_t rpcCount,
+	uint16_t *rpcs,
 	FACTInstanceRPCData *data,
 	uint32_t timestamp,
 	uint32_t elapsedTrack
@@ -1022,58 +1098,50 @@ void FACT_INTERNAL_UpdateRPCs(
 	uint8_t i;
 	FACTRPC *rpc;
 	float rpcResult;
-	float variableValue;
 	FACTAudioEngine *engine = cue->parentBank->parentEngine;
 
-	if (codeCount > 0)
+	if (rpcCount > 0)
 	{
 		/* Do NOT overwrite Frequency/QFactor! */
 		data->rpcVolume = 0.0f;
 		data->rpcPitch = 0.0f;
 		data->rpcReverbSend = 0.0f;
-		for (i = 0; i < codeCount; i += 1)
+		for (i = 0; i < rpcCount; i += 1)
 		{
-			rpc = FACT_INTERNAL_GetRPC(
-				engine,
-				codes[i]
-			);
-			if (engine->variables[rpc->variable].accessibility & ACCESSIBILITY_CUE)
+			rpc = &engine->rpcs[rpcs[i]];
+			switch (rpc->source)
 			{
-				if (FAudio_strcmp(
-					engine->variableNames[rpc->variable],
-					"AttackTime"
-				) == 0) {
-					variableValue = (float) elapsedTrack;
-				}
-				else if (FAudio_strcmp(
-					engine->variableNames[rpc->variable],
-					"ReleaseTime"
-				) == 0) {
+				case RPC_SOURCE_ATTACKTIME:
+					rpcResult = FACT_INTERNAL_CalculateRPC(
+						rpc,
+						(float) elapsedTrack
+					);
+					break;
+
+				case RPC_SOURCE_RELEASETIME:
 					if (cue->playingSound->fadeType == 3) /* Release RPC */
 					{
-						variableValue = (float) (timestamp - cue->playingSound->fadeStart);
+						rpcResult = FACT_INTERNAL_CalculateRPC(
+							rpc,
+							(float) (timestamp - cue->playingSound->fadeStart)
+						);
 					}
 					else
 					{
-						variableValue = 0.0f;
+						rpcResult = FACT_INTERNAL_CalculateRPC(
+							rpc,
+							0.0f
+						);
 					}
-				}
-				else
-				{
-					variableValue = cue->variableValues[rpc->variable];
-				}
+					break;
 
-				rpcResult = FACT_INTERNAL_CalculateRPC(
-					rpc,
-					variableValue
-				);
-			}
-			else
-			{
-				rpcResult = FACT_INTERNAL_CalculateRPC(
-					rpc,
-					engine->globalVariableValues[rpc->variable]
-				);
+				case RPC_SOURCE_CUE:
+					rpcResult = cue->rpcResults[rpcs[i]];
+					break;
+
+				default:
+					rpcResult = engine->rpcResults[rpcs[i]];
+					break;
 			}
 			if (rpc->parameter == RPC_PARAMETER_VOLUME)
 			{
@@ -1114,30 +1182,55 @@ void FACT_INTERNAL_UpdateEngine(FACTAudioEngine *engine)
 {
 	FAudioFXReverbParameters rvbPar;
 	uint16_t i, j, par;
-	float rpcResult;
+
+	/* DSP parameters only change when their variable does */
 	for (i = 0; i < engine->rpcCount; i += 1)
 	{
 		if (engine->rpcs[i].parameter >= RPC_PARAMETER_COUNT)
 		{
 			/* FIXME: Why did I make this global vars only...? */
-			if (!(engine->variables[engine->rpcs[i].variable].accessibility & ACCESSIBILITY_CUE))
+			if (	engine->rpcs[i].source == RPC_SOURCE_GLOBAL &&
+				FACT_VARIABLE_MARKED(engine->dirtyVariables, engine->rpcs[i].variable)	)
 			{
-				for (j = 0; j < engine->dspPresetCount; j += 1)
-				{
-					/* FIXME: This affects all DSP presets!
-					 * What if there's more than one?
-					 */
-					par = engine->rpcs[i].parameter - RPC_PARAMETER_COUNT;
-					rpcResult = FACT_INTERNAL_CalculateRPC(
-						&engine->rpcs[i],
-						engine->globalVariableValues[engine->rpcs[i].variable]
-					);
-					engine->dspPresets[j].parameters[par].value = FAudio_clamp(
-						rpcResult,
-						engine->dspPresets[j].parameters[par].minVal,
-						engine->dspPresets[j].parameters[par].maxVal
-					);
-				}
+				engine->reverbDirty = true;
+			}
+		}
+	}
+
+	/* Global RPCs are shared by every Cue, so do them all at once */
+	if (engine->rpcCount > 0)
+	{
+		FACT_INTERNAL_CalculateDirtyRPCs(
+			engine,
+			RPC_SOURCE_GLOBAL,
+			engine->globalVariableValues,
+			engine->dirtyVariables,
+			engine->rpcResults
+		);
+	}
+
+	if (!engine->reverbDirty)
+	{
+		return;
+	}
+	engine->reverbDirty = false;
+
+	for (i = 0; i < engine->rpcCount; i += 1)
+	{
+		if (	engine->rpcs[i].parameter >= RPC_PARAMETER_COUNT &&
+			engine->rpcs[i].source == RPC_SOURCE_GLOBAL	)
+		{
+			for (j = 0; j < engine->dspPresetCount; j += 1)
+			{
+				/* FIXME: This affects all DSP presets!
+				 * What if there's more than one?
+				 */
+				par = engine->rpcs[i].parameter - RPC_PARAMETER_COUNT;
+				engine->dspPresets[j].parameters[par].value = FAudio_clamp(
+					engine->rpcResults[i],
+					engine->dspPresets[j].parameters[par].minVal,
+					engine->dspPresets[j].parameters[par].maxVal
+				);
 			}
 		}
 	}
@@ -1465,13 +1558,23 @@ bool FACT_INTERNAL_UpdateSound(FACTSoundInstance *sound, uint32_t timestamp)
 	 */
 	elapsedCue = timestamp - (sound->parentCue->start - sound->parentCue->elapsed);
 
-	/* RPC updates */
+	/* RPC updates, only redoing curves for Cue variables that changed */
+	if (sound->parentCue->rpcResults != NULL)
+	{
+		FACT_INTERNAL_CalculateDirtyRPCs(
+			sound->parentCue->parentBank->parentEngine,
+			RPC_SOURCE_CUE,
+			sound->parentCue->variableValues,
+			sound->parentCue->dirtyVariables,
+			sound->parentCue->rpcResults
+		);
+	}
 	sound->rpcData.rpcFilterFreq = -1.0f;
 	sound->rpcData.rpcFilterQFactor = -1.0f;
 	FACT_INTERNAL_UpdateRPCs(
 		sound->parentCue,
-		sound->sound->rpcCodeCount,
-		sound->sound->rpcCodes,
+		sound->sound->rpcCount,
+		sound->sound->rpcs,
 		&sound->rpcData,
 		timestamp,
 		elapsedCue - sound->tracks[0].events[0].timestamp
@@ -1482,8 +1585,8 @@ bool FACT_INTERNAL_UpdateSound(FACTSoundInstance *sound, uint32_t timestamp)
 		sound->tracks[i].rpcData.rpcFilterQFactor = sound->rpcData.rpcFilterQFactor;
 		FACT_INTERNAL_UpdateRPCs(
 			sound->parentCue,
-			sound->sound->tracks[i].rpcCodeCount,
-			sound->sound->tracks[i].rpcCodes,
+			sound->sound->tracks[i].rpcCount,
+			sound->sound->tracks[i].rpcs,
 			&sound->tracks[i].rpcData,
 			timestamp,
 			elapsedCue - sound->sound->tracks[i].events[0].timestamp
@@ -1677,14 +1780,281 @@ void FACT_INTERNAL_UpdateCue(FACTCue *cue)
 	}
 }
 
-/* FACT Thread */
+/* FACT Thread
+ *
+ * Rather than walking every Cue of every SoundBank each update, the thread
+ * keeps a min-heap of the Cues that need attention, keyed on when they next
+ * need it. Prepared and stopped Cues aren't in the heap at all. Cues with
+ * fades, RPCs or events that are due are updated every FACT_UPDATE_MS as
+ * before; Cues that are only waiting on a Wave or a future event sleep until
+ * then. When nothing is due, the thread sleeps until an API call or a Wave
+ * ending wakes it up.
+ */
+
+/* FIXME: 10ms is based on the XAudio2 update time...? */
+#define FACT_UPDATE_MS 10
+
+/* Far enough away to mean "when something wakes us", close enough to compare */
+#define FACT_UPDATE_NEVER 0x3FFFFFFF
+
+#define CUE_DUE_BEFORE(a, b) ((int32_t) ((a)->due - (b)->due) < 0)
+
+static void FACT_INTERNAL_HeapSet(FACTAudioEngine *engine, uint32_t i, FACTCue *cue)
+{
+	engine->cueHeap[i] = cue;
+	cue->heapPos = i + 1;
+}
+
+static void FACT_INTERNAL_HeapSiftUp(FACTAudioEngine *engine, uint32_t i)
+{
+	FACTCue *cue = engine->cueHeap[i];
+	uint32_t parent;
+	while (i > 0)
+	{
+		parent = (i - 1) / 2;
+		if (!CUE_DUE_BEFORE(cue, engine->cueHeap[parent]))
+		{
+			break;
+		}
+		FACT_INTERNAL_HeapSet(engine, i, engine->cueHeap[parent]);
+		i = parent;
+	}
+	FACT_INTERNAL_HeapSet(engine, i, cue);
+}
+
+static void FACT_INTERNAL_HeapSiftDown(FACTAudioEngine *engine, uint32_t i)
+{
+	FACTCue *cue = engine->cueHeap[i];
+	uint32_t child;
+	while ((child = (i * 2) + 1) < engine->cueHeapCount)
+	{
+		if (	child + 1 < engine->cueHeapCount &&
+			CUE_DUE_BEFORE(engine->cueHeap[child + 1], engine->cueHeap[child])	)
+		{
+			child += 1;
+		}
+		if (!CUE_DUE_BEFORE(engine->cueHeap[child], cue))
+		{
+			break;
+		}
+		FACT_INTERNAL_HeapSet(engine, i, engine->cueHeap[child]);
+		i = child;
+	}
+	FACT_INTERNAL_HeapSet(engine, i, cue);
+}
+
+/* Call these with apiLock held */
+static void FACT_INTERNAL_ScheduleCue(FACTCue *cue, uint32_t due)
+{
+	FACTAudioEngine *engine = cue->parentBank->parentEngine;
+
+	cue->due = due;
+	if (cue->heapPos > 0)
+	{
+		FACT_INTERNAL_HeapSiftUp(engine, cue->heapPos - 1);
+		FACT_INTERNAL_HeapSiftDown(engine, cue->heapPos - 1);
+		return;
+	}
+
+	if (engine->cueHeapCount == engine->cueHeapCapacity)
+	{
+		engine->cueHeapCapacity = FAudio_max(
+			engine->cueHeapCapacity * 2,
+			64
+		);
+		engine->cueHeap = (FACTCue**) engine->pRealloc(
+			engine->cueHeap,
+			sizeof(FACTCue*) * engine->cueHeapCapacity
+		);
+	}
+	engine->cueHeap[engine->cueHeapCount] = cue;
+	engine->cueHeapCount += 1;
+	FACT_INTERNAL_HeapSiftUp(engine, engine->cueHeapCount - 1);
+}
+
+void FACT_INTERNAL_UnscheduleCue(FACTCue *cue)
+{
+	FACTAudioEngine *engine = cue->parentBank->parentEngine;
+	FACTCue *last;
+	uint32_t i;
+
+	if (cue->heapPos == 0)
+	{
+		return;
+	}
+	i = cue->heapPos - 1;
+	cue->heapPos = 0;
+	engine->cueHeapCount -= 1;
+	if (i < engine->cueHeapCount)
+	{
+		/* Fill the hole with the last Cue, then put that one in its place */
+		last = engine->cueHeap[engine->cueHeapCount];
+		FACT_INTERNAL_HeapSet(engine, i, last);
+		FACT_INTERNAL_HeapSiftUp(engine, i);
+		FACT_INTERNAL_HeapSiftDown(engine, last->heapPos - 1);
+	}
+}
+
+void FACT_INTERNAL_WakeCue(FACTCue *cue)
+{
+	FACTAudioEngine *engine = cue->parentBank->parentEngine;
+	uint32_t now = FAudio_timems();
+
+	if (cue->heapPos == 0 || (int32_t) (cue->due - now) > 0)
+	{
+		FACT_INTERNAL_ScheduleCue(cue, now);
+	}
+	FAudio_PlatformSignalSemaphore(engine->apiWake);
+}
+
+void FACT_INTERNAL_WakeAllCues(FACTAudioEngine *engine)
+{
+	uint32_t i, now = FAudio_timems();
+
+	/* Every key is the same afterward, so this is still a heap */
+	for (i = 0; i < engine->cueHeapCount; i += 1)
+	{
+		engine->cueHeap[i]->due = now;
+	}
+	FAudio_PlatformSignalSemaphore(engine->apiWake);
+}
+
+/* Returns true if the Cue was destroyed */
+static bool FACT_INTERNAL_ProcessCue(FACTCue *cue, uint32_t timestamp)
+{
+	FACT_INTERNAL_UpdateCue(cue);
+
+	if (cue->state & FACT_STATE_PAUSED)
+	{
+		/* Funky edge case where we need to keep updating even when paused */
+		if (!(cue->state & FACT_STATE_STOPPING))
+		{
+			return false;
+		}
+	}
+
+	if (cue->playingSound != NULL)
+	{
+		if (FACT_INTERNAL_UpdateSound(cue->playingSound, timestamp))
+		{
+			FACT_INTERNAL_DestroySound(cue->playingSound);
+		}
+	}
+
+	/* Destroy if it's done and not user-handled. */
+	if (cue->managed && (cue->state & FACT_STATE_STOPPED))
+	{
+		FACTCue_Destroy(cue);
+		return true;
+	}
+	return false;
+}
+
+/* Returns false if the Cue can sit idle until an API call wakes it */
+static bool FACT_INTERNAL_NextCueUpdate(
+	FACTCue *cue,
+	uint32_t timestamp,
+	uint32_t *due
+) {
+	FACTSoundInstance *sound = cue->playingSound;
+	FACTEventInstance *evtInst;
+	uint32_t fire;
+	uint8_t i, j;
+	bool finished;
+
+	/* Interactive variations poll their variable */
+	if (	!(cue->data->flags & CUE_FLAG_SINGLE_SOUND) &&
+		cue->variation &&
+		cue->variation->type == VARIATION_TABLE_TYPE_INTERACTIVE	)
+	{
+		*due = timestamp + FACT_UPDATE_MS;
+		return true;
+	}
+
+	if (sound == NULL)
+	{
+		if (cue->simpleWave != NULL && !(cue->state & FACT_STATE_STOPPED))
+		{
+			/* OnStreamEnd will wake us */
+			*due = timestamp + FACT_UPDATE_NEVER;
+			return true;
+		}
+		if (cue->state & FACT_STATE_STOPPING)
+		{
+			*due = timestamp + FACT_UPDATE_MS;
+			return true;
+		}
+		return false;
+	}
+
+	if ((cue->state & FACT_STATE_PAUSED) && !(cue->state & FACT_STATE_STOPPING))
+	{
+		/* FACTCue_Pause will wake us */
+		return false;
+	}
+
+	/* Fades and RPCs change every update */
+	if (sound->fadeType != 0 || sound->sound->rpcCount > 0)
+	{
+		*due = timestamp + FACT_UPDATE_MS;
+		return true;
+	}
+	for (i = 0; i < sound->sound->trackCount; i += 1)
+	{
+		if (sound->sound->tracks[i].rpcCount > 0)
+		{
+			*due = timestamp + FACT_UPDATE_MS;
+			return true;
+		}
+	}
+
+	/* Otherwise, only events and Waves ending can change anything */
+	*due = timestamp + FACT_UPDATE_NEVER;
+	finished = true;
+	for (i = 0; i < sound->sound->trackCount; i += 1)
+	{
+		if (sound->tracks[i].activeWave.wave != NULL)
+		{
+			finished = false;
+		}
+		for (j = 0; j < sound->sound->tracks[i].eventCount; j += 1)
+		{
+			evtInst = &sound->tracks[i].events[j];
+			if (evtInst->finished)
+			{
+				continue;
+			}
+			finished = false;
+
+			/* See elapsedCue in UpdateSound */
+			fire = evtInst->timestamp + (cue->start - cue->elapsed);
+			if ((int32_t) (fire - timestamp) <= 0)
+			{
+				/* Already running, SetVolume ramps for example */
+				*due = timestamp + FACT_UPDATE_MS;
+				return true;
+			}
+			if ((int32_t) (fire - *due) < 0)
+			{
+				*due = fire;
+			}
+		}
+	}
+
+	/* The last Wave was cleared out, UpdateSound will destroy it next */
+	if (finished)
+	{
+		*due = timestamp;
+	}
+	return true;
+}
 
 int32_t FACT_INTERNAL_APIThread(void* enginePtr)
 {
 	FACTAudioEngine *engine = (FACTAudioEngine*) enginePtr;
-	LinkedList *sbList;
-	FACTCue *cue, *cBackup;
-	uint32_t timestamp, updateTime;
+	FACTCue *cue, *next;
+	uint32_t timestamp, due, wait;
+	int32_t remaining;
 
 	/* Needs to match the audio thread priority, or else the scheduler will
 	 * let this thread sit around with a lock while the audio thread spins
@@ -1705,56 +2075,61 @@ threadstart:
 
 	FACT_INTERNAL_UpdateEngine(engine);
 
-	sbList = engine->sbList;
-	while (sbList != NULL)
+	/* Waves ended on the audio thread, their Cues may be waiting on them */
+	FAudio_PlatformLockMutex(engine->waveEndedLock);
+	cue = engine->waveEndedList;
+	engine->waveEndedList = NULL;
+	while (cue != NULL)
 	{
-		cue = ((FACTSoundBank*) sbList->entry)->cueList;
-		while (cue != NULL)
+		next = cue->waveEndedNext;
+		cue->waveEndedNext = NULL;
+		cue->waveEndedQueued = false;
+		if (	cue->heapPos > 0 &&
+			(int32_t) (cue->due - timestamp) > 0	)
 		{
-			FACT_INTERNAL_UpdateCue(cue);
-
-			if (cue->state & FACT_STATE_PAUSED)
-			{
-				/* Funky edge case where we need to keep updating even when paused */
-				if (!(cue->state & FACT_STATE_STOPPING))
-				{
-					cue = cue->next;
-					continue;
-				}
-			}
+			FACT_INTERNAL_ScheduleCue(cue, timestamp);
+		}
+		cue = next;
+	}
+	FAudio_PlatformUnlockMutex(engine->waveEndedLock);
 
-			if (cue->playingSound != NULL)
-			{
-				if (FACT_INTERNAL_UpdateSound(cue->playingSound, timestamp))
-				{
-					FACT_INTERNAL_DestroySound(cue->playingSound);
-				}
-			}
+	while (	engine->cueHeapCount > 0 &&
+		(int32_t) (engine->cueHeap[0]->due - timestamp) <= 0	)
+	{
+		cue = engine->cueHeap[0];
+		FACT_INTERNAL_UnscheduleCue(cue);
+		if (FACT_INTERNAL_ProcessCue(cue, timestamp))
+		{
+			continue;
+		}
 
-			/* Destroy if it's done and not user-handled. */
-			if (cue->managed && (cue->state & FACT_STATE_STOPPED))
-			{
-				cBackup = cue->next;
-				FACTCue_Destroy(cue);
-				cue = cBackup;
-			}
-			else
-			{
-				cue = cue->next;
-			}
+		/* Something may have already woken it up again */
+		if (	cue->heapPos == 0 &&
+			FACT_INTERNAL_NextCueUpdate(cue, timestamp, &due)	)
+		{
+			FACT_INTERNAL_ScheduleCue(cue, due);
 		}
-		sbList = sbList->next;
+	}
+
+	/* Sleep until the next Cue is due, or until we're woken up */
+	wait = FACT_UPDATE_NEVER;
+	if (engine->cueHeapCount > 0)
+	{
+		remaining = (int32_t) (engine->cueHeap[0]->due - FAudio_timems());
+		wait = (uint32_t) FAudio_max(remaining, 0);
 	}
 
 	FAudio_PlatformUnlockMutex(engine->apiLock);
 
 	if (engine->initialized)
 	{
-		/* FIXME: 10ms is based on the XAudio2 update time...? */
-		updateTime = FAudio_timems() - timestamp;
-		if (updateTime < 10)
+		if (wait == FACT_UPDATE_NEVER)
 		{
-			FAudio_sleep(10 - updateTime);
+			FAudio_PlatformWaitSemaphore(engine->apiWake);
+		}
+		else if (wait > 0)
+		{
+			FAudio_PlatformWaitSemaphoreTimeout(engine->apiWake, wait);
 		}
 		goto threadstart;
 	}
@@ -1762,20 +2137,27 @@ threadstart:
 	return 0;
 }
 
-/* FAudio callbacks */
+/* Streaming WaveBank I/O
+ *
+ * Every streaming Wave owns a small ring of packets. The first packet is read
+ * on the thread that prepares the Wave; after that, whenever the voice is done
+ * with a packet, OnBufferEnd only plans the next read and hands the packet to
+ * the engine's I/O threads. The threads read the file and submit finished
+ * packets to the voice in the order they were planned, so the audio thread
+ * never waits on the disk as long as the reads keep ahead of playback.
+ */
 
-void FACT_INTERNAL_OnBufferEnd(FAudioVoiceCallback *callback, void* pContext)
-{
-	FAudioBuffer buffer;
-	FAudioBufferWMA bufferWMA;
-	FACTWaveCallback *c = (FACTWaveCallback*) callback;
+static bool FACT_INTERNAL_PlanStreamPacket(
+	FACTWave *wave,
+	FACTStreamPacket *packet
+) {
 	FACTWaveBankEntry *entry;
 	uint32_t end, left, length;
 
-	entry = &c->wave->parentBank->entries[c->wave->index];
+	entry = &wave->parentBank->entries[wave->index];
 
 	/* Calculate total bytes left in this wave iteration */
-	if (c->wave->loopCount > 0 && entry->LoopRegion.dwTotalSamples > 0)
+	if (wave->loopCount > 0 && entry->LoopRegion.dwTotalSamples > 0)
 	{
 		length = entry->LoopRegion.dwStartSample + entry->LoopRegion.dwTotalSamples;
 		if (entry->Format.wFormatTag == FACT_WAVEBANKMINIFORMAT_TAG_PCM)
@@ -1806,54 +2188,36 @@ void FACT_INTERNAL_OnBufferEnd(FAudioVoiceCallback *callback, void* pContext)
 		length = entry->PlayRegion.dwLength;
 	}
 	end = entry->PlayRegion.dwOffset + length;
-	left = length - (c->wave->streamOffset - entry->PlayRegion.dwOffset);
+	left = length - (wave->streamOffset - entry->PlayRegion.dwOffset);
 
-	/* Don't bother if we're EOS or the Wave has stopped */
-	if (	(c->wave->streamOffset >= end) ||
-		(c->wave->state & FACT_STATE_STOPPED)	)
+	/* Don't bother if we're EOS */
+	if (wave->streamOffset >= end)
 	{
-		return;
+		return false;
 	}
 
-	/* Assign buffer memory */
-	buffer.pAudioData = c->wave->streamCache;
-	buffer.AudioBytes = FAudio_min(
-		c->wave->streamSize,
-		left
-	);
-
-	/* Read! */
-	FACT_INTERNAL_ReadFile(
-		c->wave->parentBank->parentEngine->pReadFile,
-		c->wave->parentBank->parentEngine->pGetOverlappedResult,
-		c->wave->parentBank->io,
-		c->wave->streamOffset,
-		c->wave->parentBank->packetSize,
-		&c->wave->parentBank->packetBuffer,
-		&c->wave->parentBank->packetBufferLen,
-		c->wave->parentBank->parentEngine->pRealloc,
-		c->wave->streamCache,
-		buffer.AudioBytes
-	);
-	c->wave->streamOffset += buffer.AudioBytes;
+	packet->offset = wave->streamOffset;
+	packet->length = FAudio_min(wave->streamSize, left);
+	packet->sequence = wave->streamPlanned++;
+	wave->streamOffset += packet->length;
 
 	/* Last buffer in the stream? */
-	buffer.Flags = 0;
-	if (c->wave->streamOffset >= end)
+	packet->flags = 0;
+	if (wave->streamOffset >= end)
 	{
 		/* Loop if applicable */
-		if (c->wave->loopCount > 0)
+		if (wave->loopCount > 0)
 		{
-			if (c->wave->loopCount != 255)
+			if (wave->loopCount != 255)
 			{
-				c->wave->loopCount -= 1;
+				wave->loopCount -= 1;
 			}
-			c->wave->streamOffset = entry->PlayRegion.dwOffset;
+			wave->streamOffset = entry->PlayRegion.dwOffset;
 
 			/* Loop start */
 			if (entry->Format.wFormatTag == FACT_WAVEBANKMINIFORMAT_TAG_PCM)
 			{
-				c->wave->streamOffset += (
+				wave->streamOffset += (
 					entry->LoopRegion.dwStartSample *
 					entry->Format.nChannels *
 					(1 << entry->Format.wBitsPerSample)
@@ -1861,7 +2225,7 @@ void FACT_INTERNAL_OnBufferEnd(FAudioVoiceCallback *callback, void* pContext)
 			}
 			else if (entry->Format.wFormatTag == FACT_WAVEBANKMINIFORMAT_TAG_ADPCM)
 			{
-				c->wave->streamOffset += (
+				wave->streamOffset += (
 					entry->LoopRegion.dwStartSample /
 					/* wSamplesPerBlock */
 					((entry->Format.wBlockAlign + 16) * 2) *
@@ -1872,9 +2236,65 @@ void FACT_INTERNAL_OnBufferEnd(FAudioVoiceCallback *callback, void* pContext)
 		}
 		else
 		{
-			buffer.Flags = FAUDIO_END_OF_STREAM;
+			packet->flags = FAUDIO_END_OF_STREAM;
 		}
 	}
+	return true;
+}
+
+static void FACT_INTERNAL_ReadStreamPacket(FACTStreamPacket *packet)
+{
+	FACTOverlapped ovlp;
+	FACTWaveBank *wb = packet->wave->parentBank;
+	uint32_t realOffset, realLen, offPacket, lenPacket, result;
+
+	ovlp.Internal = NULL;
+	ovlp.InternalHigh = NULL;
+	ovlp.OffsetHigh = 0;
+	ovlp.hEvent = NULL;
+
+	/* Same sector alignment rules as FACT_INTERNAL_ReadFile, but packet
+	 * memory has room for the padding, so we read in place and just point
+	 * the buffer at the part we asked for.
+	 */
+	realOffset = packet->offset;
+	realLen = packet->length;
+	offPacket = 0;
+	if (wb->packetSize > 0)
+	{
+		offPacket = realOffset % wb->packetSize;
+		realOffset -= offPacket;
+		realLen += offPacket;
+		lenPacket = realLen % wb->packetSize;
+		if (lenPacket > 0)
+		{
+			realLen += (wb->packetSize - lenPacket);
+		}
+	}
+
+	ovlp.Offset = realOffset;
+	if (!wb->parentEngine->pReadFile(wb->io, packet->memory, realLen, NULL, &ovlp))
+	{
+		while (ovlp.Internal == (void*) 0x103) /* STATUS_PENDING */
+		{
+			FAudio_sleep(0);
+		}
+	}
+	wb->parentEngine->pGetOverlappedResult(wb->io, &ovlp, &result, 1);
+
+	packet->data = packet->memory + offPacket;
+}
+
+/* Call this with streamLock held */
+static void FACT_INTERNAL_SubmitStreamPackets(FACTWave *wave)
+{
+	FAudioBuffer buffer;
+	FAudioBufferWMA bufferWMA;
+	FACTWaveBankEntry *entry;
+	FACTStreamPacket *packet;
+	uint8_t i;
+
+	entry = &wave->parentBank->entries[wave->index];
 
 	/* Unused properties */
 	buffer.PlayBegin = 0;
@@ -1882,34 +2302,363 @@ void FACT_INTERNAL_OnBufferEnd(FAudioVoiceCallback *callback, void* pContext)
 	buffer.LoopBegin = 0;
 	buffer.LoopLength = 0;
 	buffer.LoopCount = 0;
-	buffer.pContext = NULL;
-
-	/* Submit, finally. */
-	if (entry->Format.wFormatTag == FACT_WAVEBANKMINIFORMAT_TAG_WMA)
-	{
-		bufferWMA.pDecodedPacketCumulativeBytes =
-			c->wave->parentBank->seekTables[c->wave->index].entries;
-		bufferWMA.PacketCount =
-			c->wave->parentBank->seekTables[c->wave->index].entryCount;
-		FAudioSourceVoice_SubmitSourceBuffer(
-			c->wave->voice,
-			&buffer,
-			&bufferWMA
-		);
+
+	/* Reads can finish out of order, only submit the next one in line */
+	i = 0;
+	while (i < wave->streamPacketCount)
+	{
+		packet = &wave->streamPackets[i];
+		if (	packet->state != FACT_STREAM_PACKET_READY ||
+			packet->sequence != wave->streamSubmitted	)
+		{
+			i += 1;
+			continue;
+		}
+
+		buffer.Flags = packet->flags;
+		buffer.AudioBytes = packet->length;
+		buffer.pAudioData = packet->data;
+		buffer.pContext = packet;
+		packet->state = FACT_STREAM_PACKET_QUEUED;
+		wave->streamSubmitted += 1;
+
+		if (entry->Format.wFormatTag == FACT_WAVEBANKMINIFORMAT_TAG_WMA)
+		{
+			bufferWMA.pDecodedPacketCumulativeBytes =
+				wave->parentBank->seekTables[wave->index].entries;
+			bufferWMA.PacketCount =
+				wave->parentBank->seekTables[wave->index].entryCount;
+			FAudioSourceVoice_SubmitSourceBuffer(
+				wave->voice,
+				&buffer,
+				&bufferWMA
+			);
+		}
+		else
+		{
+			FAudioSourceVoice_SubmitSourceBuffer(
+				wave->voice,
+				&buffer,
+				NULL
+			);
+		}
+
+		/* The packet after it could be anywhere in the ring */
+		i = 0;
+	}
+}
+
+static void FACT_INTERNAL_CompleteStreamPacket(FACTStreamPacket *packet)
+{
+	FACTWave *wave = packet->wave;
+
+	FAudio_PlatformLockMutex(wave->streamLock);
+	wave->streamReads -= 1;
+	if (wave->streamCancel || (wave->state & FACT_STATE_STOPPED))
+	{
+		packet->state = FACT_STREAM_PACKET_FREE;
 	}
 	else
 	{
-		FAudioSourceVoice_SubmitSourceBuffer(
-			c->wave->voice,
-			&buffer,
-			NULL
+		packet->state = FACT_STREAM_PACKET_READY;
+		FACT_INTERNAL_SubmitStreamPackets(wave);
+	}
+	FAudio_PlatformUnlockMutex(wave->streamLock);
+}
+
+static void FACT_INTERNAL_QueueStreamPacket(FACTStreamPacket *packet)
+{
+	FACTAudioEngine *engine = packet->wave->parentBank->parentEngine;
+
+	/* FACT_STREAMING_THREADS=0, read on the calling thread */
+	if (engine->ioThreadCount == 0)
+	{
+		FACT_INTERNAL_ReadStreamPacket(packet);
+		FACT_INTERNAL_CompleteStreamPacket(packet);
+		return;
+	}
+
+	FAudio_PlatformLockMutex(engine->ioLock);
+	packet->next = NULL;
+	if (engine->ioTail == NULL)
+	{
+		engine->ioHead = packet;
+	}
+	else
+	{
+		engine->ioTail->next = packet;
+	}
+	engine->ioTail = packet;
+	FAudio_PlatformUnlockMutex(engine->ioLock);
+	FAudio_PlatformSignalSemaphore(engine->ioWake);
+}
+
+static void FACT_INTERNAL_RefillStreamPacket(
+	FACTWave *wave,
+	FACTStreamPacket *packet
+) {
+	bool planned;
+
+	FAudio_PlatformLockMutex(wave->streamLock);
+	packet->state = FACT_STREAM_PACKET_FREE;
+	planned = (
+		!wave->streamCancel &&
+		!(wave->state & FACT_STATE_STOPPED) &&
+		FACT_INTERNAL_PlanStreamPacket(wave, packet)
+	);
+	if (planned)
+	{
+		packet->state = FACT_STREAM_PACKET_READING;
+		wave->streamReads += 1;
+	}
+	FAudio_PlatformUnlockMutex(wave->streamLock);
+
+	if (planned)
+	{
+		FACT_INTERNAL_QueueStreamPacket(packet);
+	}
+}
+
+static int32_t FAUDIOCALL FACT_INTERNAL_StreamingThread(void* enginePtr)
+{
+	FACTAudioEngine *engine = (FACTAudioEngine*) enginePtr;
+	FACTStreamPacket *packet;
+
+	/* Finished reads take streamLock, which the audio thread also needs */
+	FAudio_PlatformThreadPriority(FAUDIO_THREAD_PRIORITY_HIGH);
+
+	while (1)
+	{
+		FAudio_PlatformWaitSemaphore(engine->ioWake);
+		FAudio_PlatformLockMutex(engine->ioLock);
+		if (engine->ioQuit)
+		{
+			FAudio_PlatformUnlockMutex(engine->ioLock);
+			break;
+		}
+		packet = engine->ioHead;
+		if (packet != NULL)
+		{
+			engine->ioHead = packet->next;
+			if (engine->ioHead == NULL)
+			{
+				engine->ioTail = NULL;
+			}
+		}
+		FAudio_PlatformUnlockMutex(engine->ioLock);
+
+		/* Cancelled packets leave stray wakeups behind */
+		if (packet != NULL)
+		{
+			FACT_INTERNAL_ReadStreamPacket(packet);
+			FACT_INTERNAL_CompleteStreamPacket(packet);
+		}
+	}
+	return 0;
+}
+
+void FACT_INTERNAL_StartStreamingThreads(FACTAudioEngine *engine)
+{
+	const char *env;
+	uint32_t i, count;
+
+	if (engine->ioStarted)
+	{
+		return;
+	}
+
+	count = FACT_STREAM_DEFAULT_THREADS;
+	env = FAudio_getenv("FACT_STREAMING_THREADS");
+	if (env != NULL)
+	{
+		count = (uint32_t) FAudio_max(FAudio_atoi(env), 0);
+	}
+	engine->streamPrefetch = FACT_STREAM_DEFAULT_PREFETCH;
+	env = FAudio_getenv("FACT_STREAMING_PREFETCH");
+	if (env != NULL)
+	{
+		engine->streamPrefetch = (uint8_t) FAudio_clamp(
+			FAudio_atoi(env),
+			2,
+			FACT_STREAM_MAX_PACKETS
 		);
 	}
+
+	engine->ioLock = FAudio_PlatformCreateMutex();
+	engine->ioWake = FAudio_PlatformCreateSemaphore(0);
+	engine->ioHead = NULL;
+	engine->ioTail = NULL;
+	engine->ioQuit = false;
+	if (count > 0)
+	{
+		engine->ioThreads = (FAudioThread*) engine->pMalloc(
+			sizeof(FAudioThread) * count
+		);
+		for (i = 0; i < count; i += 1)
+		{
+			engine->ioThreads[i] = FAudio_PlatformCreateThread(
+				FACT_INTERNAL_StreamingThread,
+				"FACT Streaming",
+				engine
+			);
+			FAudio_assert(engine->ioThreads[i] != NULL);
+		}
+	}
+	engine->ioThreadCount = count;
+	engine->ioStarted = true;
+}
+
+void FACT_INTERNAL_StopStreamingThreads(FACTAudioEngine *engine)
+{
+	uint32_t i;
+
+	if (!engine->ioStarted)
+	{
+		return;
+	}
+
+	FAudio_PlatformLockMutex(engine->ioLock);
+	engine->ioQuit = true;
+	FAudio_PlatformUnlockMutex(engine->ioLock);
+	for (i = 0; i < engine->ioThreadCount; i += 1)
+	{
+		FAudio_PlatformSignalSemaphore(engine->ioWake);
+	}
+	for (i = 0; i < engine->ioThreadCount; i += 1)
+	{
+		FAudio_PlatformWaitThread(engine->ioThreads[i], NULL);
+	}
+	if (engine->ioThreads != NULL)
+	{
+		engine->pFree(engine->ioThreads);
+		engine->ioThreads = NULL;
+	}
+	FAudio_PlatformDestroySemaphore(engine->ioWake);
+	FAudio_PlatformDestroyMutex(engine->ioLock);
+	engine->ioThreadCount = 0;
+	engine->ioStarted = false;
+}
+
+void FACT_INTERNAL_PrepareStream(FACTWave *wave)
+{
+	FACTWaveBank *wb = wave->parentBank;
+	FACTStreamPacket *packet;
+	uint32_t i, stride;
+
+	/* Sector alignment can add up to a sector on either end */
+	stride = wave->streamSize + (wb->packetSize * 2);
+	wave->streamCache = (uint8_t*) wb->parentEngine->pMalloc(
+		stride * wave->streamPacketCount
+	);
+	wave->streamPackets = (FACTStreamPacket*) wb->parentEngine->pMalloc(
+		sizeof(FACTStreamPacket) * wave->streamPacketCount
+	);
+	FAudio_zero(
+		wave->streamPackets,
+		sizeof(FACTStreamPacket) * wave->streamPacketCount
+	);
+	for (i = 0; i < wave->streamPacketCount; i += 1)
+	{
+		wave->streamPackets[i].wave = wave;
+		wave->streamPackets[i].memory = wave->streamCache + (stride * i);
+	}
+	wave->streamPlanned = 0;
+	wave->streamSubmitted = 0;
+	wave->streamReads = 0;
+	wave->streamCancel = false;
+	wave->streamLock = FAudio_PlatformCreateMutex();
+
+	/* Read and submit first buffer from the WaveBank, so it's ready to Play */
+	packet = &wave->streamPackets[0];
+	FAudio_PlatformLockMutex(wave->streamLock);
+	if (FACT_INTERNAL_PlanStreamPacket(wave, packet))
+	{
+		FACT_INTERNAL_ReadStreamPacket(packet);
+		packet->state = FACT_STREAM_PACKET_READY;
+		FACT_INTERNAL_SubmitStreamPackets(wave);
+	}
+	FAudio_PlatformUnlockMutex(wave->streamLock);
+
+	/* ... then let the I/O threads read ahead */
+	for (i = 1; i < wave->streamPacketCount; i += 1)
+	{
+		FACT_INTERNAL_RefillStreamPacket(wave, &wave->streamPackets[i]);
+	}
+}
+
+void FACT_INTERNAL_CancelStream(FACTWave *wave)
+{
+	FACTAudioEngine *engine = wave->parentBank->parentEngine;
+	FACTStreamPacket *packet, *prev, *next;
+	uint32_t reads;
+
+	FAudio_PlatformLockMutex(wave->streamLock);
+	wave->streamCancel = true;
+
+	/* Pull any reads that haven't started yet out of the queue... */
+	if (engine->ioStarted)
+	{
+		FAudio_PlatformLockMutex(engine->ioLock);
+		prev = NULL;
+		packet = engine->ioHead;
+		while (packet != NULL)
+		{
+			next = packet->next;
+			if (packet->wave == wave)
+			{
+				if (prev == NULL)
+				{
+					engine->ioHead = next;
+				}
+				else
+				{
+					prev->next = next;
+				}
+				packet->state = FACT_STREAM_PACKET_FREE;
+				wave->streamReads -= 1;
+			}
+			else
+			{
+				prev = packet;
+			}
+			packet = next;
+		}
+		engine->ioTail = prev;
+		FAudio_PlatformUnlockMutex(engine->ioLock);
+	}
+	FAudio_PlatformUnlockMutex(wave->streamLock);
+
+	/* ... then wait for the ones that have */
+	do
+	{
+		FAudio_PlatformLockMutex(wave->streamLock);
+		reads = wave->streamReads;
+		FAudio_PlatformUnlockMutex(wave->streamLock);
+		if (reads > 0)
+		{
+			FAudio_sleep(1);
+		}
+	} while (reads > 0);
+}
+
+/* FAudio callbacks */
+
+void FACT_INTERNAL_OnBufferEnd(FAudioVoiceCallback *callback, void* pContext)
+{
+	FACTWaveCallback *c = (FACTWaveCallback*) callback;
+
+	/* The voice is done with this packet, read the next one into it */
+	FACT_INTERNAL_RefillStreamPacket(
+		c->wave,
+		(FACTStreamPacket*) pContext
+	);
 }
 
 void FACT_INTERNAL_OnStreamEnd(FAudioVoiceCallback *callback)
 {
 	FACTWaveCallback *c = (FACTWaveCallback*) callback;
+	FACTAudioEngine *engine;
+	FACTCue *cue;
 
 	c->wave->state = FACT_STATE_STOPPED;
 
@@ -1923,6 +2672,22 @@ void FACT_INTERNAL_OnStreamEnd(FAudioVoiceCallback *callback)
 		);
 		c->wave->parentCue->data->instanceCount -= 1;
 	}
+
+	/* We can't take apiLock here, just let the engine thread know */
+	cue = c->wave->parentCue;
+	if (cue != NULL)
+	{
+		engine = c->wave->parentBank->parentEngine;
+		FAudio_PlatformLockMutex(engine->waveEndedLock);
+		if (!cue->waveEndedQueued)
+		{
+			cue->waveEndedQueued = true;
+			cue->waveEndedNext = engine->waveEndedList;
+			engine->waveEndedList = cue;
+		}
+		FAudio_PlatformUnlockMutex(engine->waveEndedLock);
+		FAudio_PlatformSignalSemaphore(engine->apiWake);
+	}
 }
 
 /* FAudioIOStream functions */
@@ -2239,6 +3004,20 @@ uint32_t FACT_INTERNAL_ParseAudioEngine(
 		FAudio_memcpy(pEngine->variableNames[i], ptr, memsize);
 	}
 
+	/* Compile the RPC curves, now that the variables have names */
+	for (i = 0; i < pEngine->rpcCount; i += 1)
+	{
+		FACT_INTERNAL_CompileRPC(pEngine, &pEngine->rpcs[i]);
+	}
+	pEngine->rpcResults = (float*) pEngine->pMalloc(
+		sizeof(float) * FAudio_max(pEngine->rpcCount, 1)
+	);
+	memsize = sizeof(uint32_t) * FACT_VARIABLE_WORDS(pEngine->variableCount);
+	pEngine->dirtyVariables = (uint32_t*) pEngine->pMalloc(
+		FAudio_max(memsize, sizeof(uint32_t))
+	);
+	FAudio_memset(pEngine->dirtyVariables, 0xFF, memsize);
+
 	/* Store this pointer in case we're asked to free it */
 	if (pParams->globalSettingsFlags & FACT_FLAG_MANAGEDATA)
 	{
@@ -2652,12 +3431,15 @@ uint32_t FACT_INTERNAL_ParseSoundBank(
 			ptrBookmark = ptr - 2;
 
 			#define COPYRPCBLOCK(loc) \
-				loc.rpcCodeCount = read_u8(&ptr); \
-				memsize = sizeof(uint32_t) * loc.rpcCodeCount; \
-				loc.rpcCodes = (uint32_t*) pEngine->pMalloc(memsize); \
-				for (k = 0; k < loc.rpcCodeCount; k += 1) \
+				loc.rpcCount = read_u8(&ptr); \
+				memsize = sizeof(uint16_t) * loc.rpcCount; \
+				loc.rpcs = (uint16_t*) pEngine->pMalloc(memsize); \
+				for (k = 0; k < loc.rpcCount; k += 1) \
 				{ \
-					loc.rpcCodes[k] = read_u32(&ptr, se); \
+					loc.rpcs[k] = FACT_INTERNAL_GetRPCIndex( \
+						pEngine, \
+						read_u32(&ptr, se) \
+					); \
 				} \
 
 			if (sb->sounds[i].flags & SOUND_FLAG_HAS_RPC)
@@ -2666,8 +3448,8 @@ uint32_t FACT_INTERNAL_ParseSoundBank(
 			}
 			else
 			{
-				sb->sounds[i].rpcCodeCount = 0;
-				sb->sounds[i].rpcCodes = NULL;
+				sb->sounds[i].rpcCount = 0;
+				sb->sounds[i].rpcs = NULL;
 			}
 
 			if (sb->sounds[i].flags & SOUND_FLAG_HAS_TRACK_RPC)
@@ -2681,8 +3463,8 @@ uint32_t FACT_INTERNAL_ParseSoundBank(
 			{
 				for (j = 0; j < sb->sounds[i].trackCount; j += 1)
 				{
-					sb->sounds[i].tracks[j].rpcCodeCount = 0;
-					sb->sounds[i].tracks[j].rpcCodes = NULL;
+					sb->sounds[i].tracks[j].rpcCount = 0;
+					sb->sounds[i].tracks[j].rpcs = NULL;
 				}
 			}
 
@@ -2694,12 +3476,12 @@ uint32_t FACT_INTERNAL_ParseSoundBank(
 		}
 		else
 		{
-			sb->sounds[i].rpcCodeCount = 0;
-			sb->sounds[i].rpcCodes = NULL;
+			sb->sounds[i].rpcCount = 0;
+			sb->sounds[i].rpcs = NULL;
 			for (j = 0; j < sb->sounds[i].trackCount; j += 1)
 			{
-				sb->sounds[i].tracks[j].rpcCodeCount = 0;
-				sb->sounds[i].tracks[j].rpcCodes = NULL;
+				sb->sounds[i].tracks[j].rpcCount = 0;
+				sb->sounds[i].tracks[j].rpcs = NULL;
 			}
 		}
 
@@ -3102,6 +3884,8 @@ uint32_t FACT_INTERNAL_ParseWaveBank(
 	wb->waveLock = FAudio_PlatformCreateMutex();
 	wb->packetSize = packetSize;
 	wb->io = io;
+	wb->mapping = NULL;
+	wb->mappingSize = 0;
 	wb->notifyOnDestroy = false;
 	wb->usercontext = NULL;
 
@@ -3296,8 +4080,19 @@ uint32_t FACT_INTERNAL_ParseWaveBank(
 	if (wbinfo.dwFlags & FACT_WAVEBANK_FLAGS_ENTRYNAMES)
 	{
 		SEEKSET(header.Segments[FACT_WAVEBANK_SEGIDX_ENTRYNAMES].dwOffset)
-		wb->waveBankNames = (char*) pEngine->pMalloc(64 * wbinfo.dwEntryCount);
-		READ(wb->waveBankNames, 64 * wbinfo.dwEntryCount);
+		if (isStreaming)
+		{
+			wb->waveBankNames = (char*) pEngine->pMalloc(64 * wbinfo.dwEntryCount);
+			READ(wb->waveBankNames, 64 * wbinfo.dwEntryCount);
+		}
+		else
+		{
+			/* In-memory banks outlive us, no need for a copy */
+			wb->waveBankNames = (char*) FAudio_memptr(
+				(FAudioIOStream*) io,
+				fileOffset
+			);
+		}
 	}
 	else
 	{
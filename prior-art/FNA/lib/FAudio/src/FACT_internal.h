@@ -81,6 +81,27 @@ typedef struct FACTRPCPoint
 	enum rpc_point_type type;
 } FACTRPCPoint;
 
+/* Where an RPC's input comes from, decided once at load time */
+enum rpc_source
+{
+	RPC_SOURCE_GLOBAL = 0,
+	RPC_SOURCE_CUE = 1,
+	RPC_SOURCE_ATTACKTIME = 2,
+	RPC_SOURCE_RELEASETIME = 3
+};
+
+/* One segment of a curve, with everything that doesn't depend on the input
+ * worked out ahead of time
+ */
+typedef struct FACTRPCSegment
+{
+	float x;
+	float y;
+	float width;
+	float height;
+	enum rpc_point_type type;
+} FACTRPCSegment;
+
 typedef enum FACTRPCParameter
 {
 	RPC_PARAMETER_VOLUME,
@@ -97,6 +118,10 @@ typedef struct FACTRPC
 	uint8_t pointCount;
 	uint16_t parameter;
 	FACTRPCPoint *points;
+
+	/* Compiled by FACT_INTERNAL_CompileRPC */
+	uint8_t source;
+	FACTRPCSegment *segments; /* pointCount - 1 */
 } FACTRPC;
 
 typedef struct FACTDSPParameter
@@ -247,8 +272,8 @@ typedef struct FACTTrack
 	uint8_t qfactor;
 	uint16_t frequency;
 
-	uint8_t rpcCodeCount;
-	uint32_t *rpcCodes;
+	uint8_t rpcCount;
+	uint16_t *rpcs; /* Indices into the engine's RPCs */
 
 	uint8_t eventCount;
 	FACTEvent *events;
@@ -269,11 +294,11 @@ typedef struct FACTSound
 	uint8_t priority;
 
 	uint8_t trackCount;
-	uint8_t rpcCodeCount;
+	uint8_t rpcCount;
 	uint8_t dspCodeCount;
 
 	FACTTrack *tracks;
-	uint32_t *rpcCodes;
+	uint16_t *rpcs; /* Indices into the engine's RPCs */
 	uint32_t *dspCodes;
 } FACTSound;
 
@@ -444,6 +469,34 @@ typedef struct FACTWaveCallback
 	FACTWave *wave;
 } FACTWaveCallback;
 
+/* Streaming WaveBank I/O */
+
+#define FACT_STREAM_DEFAULT_THREADS	2
+#define FACT_STREAM_DEFAULT_PREFETCH	3
+#define FACT_STREAM_MAX_PACKETS		16
+
+#define FACT_STREAM_PACKET_FREE		0
+#define FACT_STREAM_PACKET_READING	1
+#define FACT_STREAM_PACKET_READY	2
+#define FACT_STREAM_PACKET_QUEUED	3
+
+typedef struct FACTStreamPacket FACTStreamPacket;
+struct FACTStreamPacket
+{
+	FACTWave *wave;
+	FACTStreamPacket *next; /* I/O queue link */
+
+	/* memory is sector-aligned, data is where the audio actually starts */
+	uint8_t *memory;
+	uint8_t *data;
+
+	uint32_t offset;
+	uint32_t length;
+	uint32_t flags;
+	uint32_t sequence;
+	uint8_t state;
+};
+
 /* Public XACT Types */
 
 struct FACTAudioEngine
@@ -476,6 +529,11 @@ struct FACTAudioEngine
 	FAudioMutex wbLock;
 	float *globalVariableValues;
 
+	/* RPC results for global variables, redone when a variable changes */
+	float *rpcResults;
+	uint32_t *dirtyVariables; /* Bitset, one bit per variable */
+	bool reverbDirty;
+
 	/* FAudio references */
 	FAudio *audio;
 	FAudioMasteringVoice *master;
@@ -484,8 +542,29 @@ struct FACTAudioEngine
 	/* Engine thread */
 	FAudioThread apiThread;
 	FAudioMutex apiLock;
+	FAudioSemaphore apiWake;
 	bool initialized;
 
+	/* Cues whose Waves ended on the audio thread, see OnStreamEnd */
+	FAudioMutex waveEndedLock;
+	FACTCue *waveEndedList;
+
+	/* Cues the engine thread has to look at, by next update time */
+	FACTCue **cueHeap;
+	uint32_t cueHeapCount;
+	uint32_t cueHeapCapacity;
+
+	/* Streaming I/O threads, started with the first streaming WaveBank */
+	FAudioThread *ioThreads;
+	uint32_t ioThreadCount;
+	FAudioMutex ioLock;
+	FAudioSemaphore ioWake;
+	FACTStreamPacket *ioHead;
+	FACTStreamPacket *ioTail;
+	bool ioStarted;
+	bool ioQuit;
+	uint8_t streamPrefetch;
+
 	/* Allocator callbacks */
 	FAudioMallocFunc pMalloc;
 	FAudioFreeFunc pFree;
@@ -553,10 +632,15 @@ struct FACTWaveBank
 
 	/* I/O information */
 	uint32_t packetSize;
+	uint32_t streamPacketSize;
 	bool streaming;
 	uint8_t *packetBuffer;
 	uint32_t packetBufferLen;
 	void* io;
+
+	/* Set for WaveBanks from CreateInMemoryWaveBankFromFileEXT */
+	void *mapping;
+	size_t mappingSize;
 };
 
 struct FACTWave
@@ -578,6 +662,13 @@ struct FACTWave
 	uint32_t streamSize;
 	uint32_t streamOffset;
 	uint8_t *streamCache;
+	FACTStreamPacket *streamPackets;
+	uint8_t streamPacketCount;
+	uint32_t streamPlanned;
+	uint32_t streamSubmitted;
+	uint32_t streamReads;
+	bool streamCancel;
+	FAudioMutex streamLock;
 
 	/* FAudio references */
 	uint16_t srcChannels;
@@ -612,6 +703,10 @@ struct FACTCue
 	float *variableValues;
 	float interactive;
 
+	/* RPC results for Cue variables, redone when a variable changes */
+	float *rpcResults;
+	uint32_t *dirtyVariables; /* Bitset, one bit per variable */
+
 	/* Playback */
 	uint32_t state;
 	FACTWave *simpleWave;
@@ -628,6 +723,12 @@ struct FACTCue
 	/* Timer */
 	uint32_t start;
 	uint32_t elapsed;
+
+	/* Engine thread scheduling */
+	uint32_t due;
+	uint32_t heapPos; /* Index in cueHeap plus one, 0 when idle */
+	FACTCue *waveEndedNext;
+	bool waveEndedQueued;
 };
 
 /* Internal functions */
@@ -649,12 +750,37 @@ void FACT_INTERNAL_SendCueNotification(FACTCue *cue, uint8_t type);
 
 /* RPC Helper Functions */
 
-FACTRPC* FACT_INTERNAL_GetRPC(FACTAudioEngine *engine, uint32_t code);
+#define FACT_VARIABLE_WORDS(count) (((count) + 31) / 32)
+#define FACT_MARK_VARIABLE(bits, index) \
+	((bits)[(index) >> 5] |= (1u << ((index) & 31)))
+#define FACT_VARIABLE_MARKED(bits, index) \
+	((bits)[(index) >> 5] & (1u << ((index) & 31)))
+
+uint16_t FACT_INTERNAL_GetRPCIndex(FACTAudioEngine *engine, uint32_t code);
+void FACT_INTERNAL_CompileRPC(FACTAudioEngine *engine, FACTRPC *rpc);
+float FACT_INTERNAL_CalculateRPC(FACTRPC *rpc, float var);
+void FACT_INTERNAL_CalculateDirtyRPCs(
+	FACTAudioEngine *engine,
+	uint8_t source,
+	const float *variableValues,
+	uint32_t *dirtyVariables,
+	float *results
+);
 
 /* FACT Thread */
 
+void FACT_INTERNAL_WakeCue(FACTCue *cue);
+void FACT_INTERNAL_WakeAllCues(FACTAudioEngine *engine);
+void FACT_INTERNAL_UnscheduleCue(FACTCue *cue);
 int32_t FAUDIOCALL FACT_INTERNAL_APIThread(void* enginePtr);
 
+/* Streaming WaveBank I/O */
+
+void FACT_INTERNAL_StartStreamingThreads(FACTAudioEngine *engine);
+void FACT_INTERNAL_StopStreamingThreads(FACTAudioEngine *engine);
+void FACT_INTERNAL_PrepareStream(FACTWave *wave);
+void FACT_INTERNAL_CancelStream(FACTWave *wave);
+
 /* FAudio callbacks */
 
 void FACT_INTERNAL_OnBufferEnd(FAudioVoiceCallback *callback, void* pContext);
@@ -123,7 +123,7 @@ uint32_t FAudioCOMConstructWithCustomAllocatorEXT(
 #ifndef FAUDIO_DISABLE_DEBUGCONFIGURATION
 	FAudioDebugConfiguration debugInit = {0};
 #endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
-	FAudio_PlatformAddRef();
+	FAudio_PlatformInitSIMD();
 	*ppFAudio = (FAudio*) customMalloc(sizeof(FAudio));
 	FAudio_zero(*ppFAudio, sizeof(FAudio));
 	(*ppFAudio)->version = version;
@@ -138,6 +138,10 @@ uint32_t FAudioCOMConstructWithCustomAllocatorEXT(
 	LOG_MUTEX_CREATE((*ppFAudio), (*ppFAudio)->callbackLock)
 	(*ppFAudio)->operationLock = FAudio_PlatformCreateMutex();
 	LOG_MUTEX_CREATE((*ppFAudio), (*ppFAudio)->operationLock)
+	(*ppFAudio)->adpcmCacheLock = FAudio_PlatformCreateMutex();
+	LOG_MUTEX_CREATE((*ppFAudio), (*ppFAudio)->adpcmCacheLock)
+	(*ppFAudio)->slabLock = FAudio_PlatformCreateMutex();
+	LOG_MUTEX_CREATE((*ppFAudio), (*ppFAudio)->slabLock)
 	(*ppFAudio)->pMalloc = customMalloc;
 	(*ppFAudio)->pFree = customFree;
 	(*ppFAudio)->pRealloc = customRealloc;
@@ -145,6 +149,18 @@ uint32_t FAudioCOMConstructWithCustomAllocatorEXT(
 	return 0;
 }
 
+static void FAudio_INTERNAL_AcquirePlatform(FAudio *audio)
+{
+	/* The platform ref is taken lazily so that offline engines can be
+	 * created without initializing the host's audio backend.
+	 */
+	if (!audio->platformRef)
+	{
+		FAudio_PlatformAddRef();
+		audio->platformRef = 1;
+	}
+}
+
 uint32_t FAudio_AddRef(FAudio *audio)
 {
 	LOG_API_ENTER(audio)
@@ -179,9 +195,13 @@ uint32_t FAudio_Release(FAudio *audio)
 			destroy_voice(audio->master);
 		FAudio_OPERATIONSET_ClearAll(audio);
 		FAudio_StopEngine(audio);
-		audio->pFree(audio->decodeCache);
-		audio->pFree(audio->resampleCache);
-		audio->pFree(audio->effectChainCache);
+		FAudio_INTERNAL_DestroyMixWorkers(audio);
+		audio->pFree(audio->mixContext.decodeCache);
+		audio->pFree(audio->mixContext.resampleCache);
+		audio->pFree(audio->mixContext.effectChainCache);
+		audio->pFree(audio->mixContext.sincCache);
+		FAudio_INTERNAL_ClearADPCMCache(audio);
+		FAudio_INTERNAL_SlabDestroy(audio);
 		LOG_MUTEX_DESTROY(audio, audio->sourceLock)
 		FAudio_PlatformDestroyMutex(audio->sourceLock);
 		LOG_MUTEX_DESTROY(audio, audio->submixLock)
@@ -190,8 +210,15 @@ uint32_t FAudio_Release(FAudio *audio)
 		FAudio_PlatformDestroyMutex(audio->callbackLock);
 		LOG_MUTEX_DESTROY(audio, audio->operationLock)
 		FAudio_PlatformDestroyMutex(audio->operationLock);
+		LOG_MUTEX_DESTROY(audio, audio->adpcmCacheLock)
+		FAudio_PlatformDestroyMutex(audio->adpcmCacheLock);
+		LOG_MUTEX_DESTROY(audio, audio->slabLock)
+		FAudio_PlatformDestroyMutex(audio->slabLock);
+		if (audio->platformRef)
+		{
+			FAudio_PlatformRelease();
+		}
 		audio->pFree(audio);
-		FAudio_PlatformRelease();
 	}
 	else
 	{
@@ -203,6 +230,7 @@ uint32_t FAudio_Release(FAudio *audio)
 uint32_t FAudio_GetDeviceCount(FAudio *audio, uint32_t *pCount)
 {
 	LOG_API_ENTER(audio)
+	FAudio_INTERNAL_AcquirePlatform(audio);
 	*pCount = FAudio_PlatformGetDeviceCount();
 	LOG_API_EXIT(audio)
 	return 0;
@@ -215,6 +243,7 @@ uint32_t FAudio_GetDeviceDetails(
 ) {
 	uint32_t result;
 	LOG_API_ENTER(audio)
+	FAudio_INTERNAL_AcquirePlatform(audio);
 	result = FAudio_PlatformGetDeviceDetails(Index, pDeviceDetails);
 	LOG_API_EXIT(audio)
 	return result;
@@ -225,17 +254,54 @@ uint32_t FAudio_Initialize(
 	uint32_t Flags,
 	FAudioProcessor XAudio2Processor
 ) {
+	const char *env;
+	uint32_t mixWorkers;
+
 	LOG_API_ENTER(audio)
-	FAudio_assert((Flags & ~(FAUDIO_DEBUG_ENGINE | FAUDIO_1024_QUANTUM)) == 0);
+	FAudio_assert((Flags & ~(
+		FAUDIO_DEBUG_ENGINE |
+		FAUDIO_PARALLEL_MIX_EXT |
+		FAUDIO_1024_QUANTUM |
+		FAUDIO_OFFLINE_RENDER_EXT
+	)) == 0);
 	FAudio_assert(XAudio2Processor == FAUDIO_DEFAULT_PROCESSOR);
 
 	audio->initFlags = Flags;
 
+	/* Offline engines never open a device */
+	if (!(Flags & FAUDIO_OFFLINE_RENDER_EXT))
+	{
+		FAudio_INTERNAL_AcquirePlatform(audio);
+	}
+
 	/* FIXME: This is lazy... */
-	audio->decodeCache = (float*) audio->pMalloc(sizeof(float));
-	audio->resampleCache = (float*) audio->pMalloc(sizeof(float));
-	audio->decodeSamples = 1;
-	audio->resampleSamples = 1;
+	audio->mixContext.decodeCache = (float*) audio->pMalloc(sizeof(float));
+	audio->mixContext.resampleCache = (float*) audio->pMalloc(sizeof(float));
+	audio->mixContext.decodeSamples = 1;
+	audio->mixContext.resampleSamples = 1;
+	audio->mixContext.holdsSourceLock = 1;
+
+	/* ParallelMixEXT, one worker per core unless told otherwise */
+	if (Flags & FAUDIO_PARALLEL_MIX_EXT)
+	{
+		mixWorkers = FAudio_PlatformGetCPUCount();
+		env = FAudio_getenv("FAUDIO_MIX_THREADS");
+		if (env != NULL)
+		{
+			mixWorkers = (uint32_t) FAudio_max(FAudio_atoi(env), 0);
+		}
+		FAudio_INTERNAL_CreateMixWorkers(audio, mixWorkers);
+	}
+
+	/* ADPCMCacheEXT, for applications that can't call it themselves */
+	env = FAudio_getenv("FAUDIO_ADPCM_CACHE_BUDGET");
+	if (env != NULL)
+	{
+		FAudio_SetADPCMCacheBudgetEXT(
+			audio,
+			(uint32_t) FAudio_max(FAudio_atoi(env), 0)
+		);
+	}
 
 	FAudio_StartEngine(audio);
 	LOG_API_EXIT(audio)
@@ -286,7 +352,10 @@ uint32_t FAudio_CreateSourceVoice(
 	LOG_API_ENTER(audio)
 	LOG_FORMAT(audio, pSourceFormat)
 
-	*ppSourceVoice = (FAudioSourceVoice*) audio->pMalloc(sizeof(FAudioVoice));
+	*ppSourceVoice = (FAudioSourceVoice*) FAudio_INTERNAL_SlabAlloc(
+		audio,
+		sizeof(FAudioVoice)
+	);
 	FAudio_zero(*ppSourceVoice, sizeof(FAudioSourceVoice));
 	(*ppSourceVoice)->audio = audio;
 	(*ppSourceVoice)->type = FAUDIO_VOICE_SOURCE;
@@ -313,7 +382,8 @@ uint32_t FAudio_CreateSourceVoice(
 		pSourceFormat->wFormatTag == FAUDIO_FORMAT_WMAUDIO2 ||
 		pSourceFormat->wFormatTag == FAUDIO_FORMAT_WMAUDIO3	)
 	{
-		FAudioWaveFormatExtensible *fmtex = (FAudioWaveFormatExtensible*) audio->pMalloc(
+		FAudioWaveFormatExtensible *fmtex = (FAudioWaveFormatExtensible*) FAudio_INTERNAL_SlabAlloc(
+			audio,
 			sizeof(FAudioWaveFormatExtensible)
 		);
 		/* convert PCM to EXTENSIBLE */
@@ -346,7 +416,8 @@ uint32_t FAudio_CreateSourceVoice(
 	}
 	else if (pSourceFormat->wFormatTag == FAUDIO_FORMAT_MSADPCM)
 	{
-		FAudioADPCMWaveFormat *fmtex = (FAudioADPCMWaveFormat*) audio->pMalloc(
+		FAudioADPCMWaveFormat *fmtex = (FAudioADPCMWaveFormat*) FAudio_INTERNAL_SlabAlloc(
+			audio,
 			sizeof(FAudioADPCMWaveFormat)
 		);
 
@@ -374,7 +445,8 @@ uint32_t FAudio_CreateSourceVoice(
 	}
 	else if (pSourceFormat->wFormatTag == FAUDIO_FORMAT_XMAUDIO2)
 	{
-		FAudioXMA2WaveFormat *fmtex = (FAudioXMA2WaveFormat*) audio->pMalloc(
+		FAudioXMA2WaveFormat *fmtex = (FAudioXMA2WaveFormat*) FAudio_INTERNAL_SlabAlloc(
+			audio,
 			sizeof(FAudioXMA2WaveFormat)
 		);
 
@@ -400,7 +472,8 @@ uint32_t FAudio_CreateSourceVoice(
 	else
 	{
 		/* direct copy anything else */
-		(*ppSourceVoice)->src.format = (FAudioWaveFormatEx*) audio->pMalloc(
+		(*ppSourceVoice)->src.format = (FAudioWaveFormatEx*) FAudio_INTERNAL_SlabAlloc(
+			audio,
 			sizeof(FAudioWaveFormatEx) + pSourceFormat->cbSize
 		);
 		FAudio_memcpy(
@@ -416,6 +489,11 @@ uint32_t FAudio_CreateSourceVoice(
 	(*ppSourceVoice)->src.totalSamples = 0;
 	(*ppSourceVoice)->src.bufferList = NULL;
 	(*ppSourceVoice)->src.flushList = NULL;
+	(*ppSourceVoice)->src.queue = (FAudioBufferQueue*) FAudio_INTERNAL_SlabAlloc(
+		audio,
+		sizeof(FAudioBufferQueue)
+	);
+	FAudio_INTERNAL_InitBufferQueue((*ppSourceVoice)->src.queue);
 	(*ppSourceVoice)->src.bufferLock = FAudio_PlatformCreateMutex();
 	LOG_MUTEX_CREATE(audio, (*ppSourceVoice)->src.bufferLock)
 
@@ -503,16 +581,78 @@ uint32_t FAudio_CreateSourceVoice(
 	}
 	else if ((*ppSourceVoice)->src.format->wFormatTag == FAUDIO_FORMAT_MSADPCM)
 	{
+		uint32_t blockBytes = (
+			((FAudioADPCMWaveFormat*) (*ppSourceVoice)->src.format)->wSamplesPerBlock *
+			(*ppSourceVoice)->src.format->nChannels *
+			sizeof(int16_t)
+		);
+
 		(*ppSourceVoice)->src.decode = ((*ppSourceVoice)->src.format->nChannels == 2) ?
 			FAudio_INTERNAL_DecodeStereoMSADPCM :
 			FAudio_INTERNAL_DecodeMonoMSADPCM;
+
+		/* Enough blocks for the SIMD decoder to work with, within reason */
+		(*ppSourceVoice)->src.adpcmBlocksMax = FAudio_clamp(
+			FAUDIO_MSADPCM_DECODE_BYTES / blockBytes,
+			1,
+			FAUDIO_MSADPCM_DECODE_BLOCKS
+		);
+		(*ppSourceVoice)->src.adpcmBlocks = (int16_t*) FAudio_INTERNAL_SlabAlloc(
+			audio,
+			(*ppSourceVoice)->src.adpcmBlocksMax * blockBytes
+		);
+	}
+	else if ((*ppSourceVoice)->src.format->wFormatTag == FAUDIO_FORMAT_VORBIS_EXT)
+	{
+#ifndef DISABLE_XNASONG
+		(*ppSourceVoice)->src.decode = FAudio_INTERNAL_DecodeVorbis;
+#else
+		FAudio_assert(0 && "Vorbis is not supported!");
+		(*ppSourceVoice)->src.decode = FAudio_INTERNAL_DecodeWMAERROR;
+#endif /* DISABLE_XNASONG */
+	}
+	else if ((*ppSourceVoice)->src.format->wFormatTag == FAUDIO_FORMAT_QOA_EXT)
+	{
+#ifndef DISABLE_XNASONG
+		(*ppSourceVoice)->src.decode = FAudio_INTERNAL_DecodeQOA;
+#else
+		FAudio_assert(0 && "QOA is not supported!");
+		(*ppSourceVoice)->src.decode = FAudio_INTERNAL_DecodeWMAERROR;
+#endif /* DISABLE_XNASONG */
 	}
 	else
 	{
 		FAudio_assert(0 && "Unsupported format tag!");
 	}
 
-	if ((*ppSourceVoice)->src.format->nChannels == 1)
+	if (Flags & FAUDIO_VOICE_SINC_EXT)
+	{
+		if ((*ppSourceVoice)->src.format->nChannels == 1)
+		{
+			(*ppSourceVoice)->src.resample = FAudio_INTERNAL_ResampleSincMono;
+		}
+		else if ((*ppSourceVoice)->src.format->nChannels == 2)
+		{
+			(*ppSourceVoice)->src.resample = FAudio_INTERNAL_ResampleSincStereo;
+		}
+		else
+		{
+			(*ppSourceVoice)->src.resample = FAudio_INTERNAL_ResampleSincGeneric;
+		}
+		(*ppSourceVoice)->src.sincHistory = (float*) FAudio_INTERNAL_SlabAlloc(
+			audio,
+			sizeof(float) *
+			FAUDIO_SINC_HISTORY *
+			(*ppSourceVoice)->src.format->nChannels
+		);
+		FAudio_zero(
+			(*ppSourceVoice)->src.sincHistory,
+			sizeof(float) *
+			FAUDIO_SINC_HISTORY *
+			(*ppSourceVoice)->src.format->nChannels
+		);
+	}
+	else if ((*ppSourceVoice)->src.format->nChannels == 1)
 	{
 		(*ppSourceVoice)->src.resample = FAudio_INTERNAL_ResampleMono;
 	}
@@ -533,7 +673,8 @@ uint32_t FAudio_CreateSourceVoice(
 
 	/* Default Levels */
 	(*ppSourceVoice)->volume = 1.0f;
-	(*ppSourceVoice)->channelVolume = (float*) audio->pMalloc(
+	(*ppSourceVoice)->channelVolume = (float*) FAudio_INTERNAL_SlabAlloc(
+		audio,
 		sizeof(float) * (*ppSourceVoice)->outputChannels
 	);
 	for (i = 0; i < (*ppSourceVoice)->outputChannels; i += 1)
@@ -546,7 +687,8 @@ uint32_t FAudio_CreateSourceVoice(
 	/* Filters */
 	if (Flags & FAUDIO_VOICE_USEFILTER)
 	{
-		(*ppSourceVoice)->filterState = (FAudioFilterState*) audio->pMalloc(
+		(*ppSourceVoice)->filterState = (FAudioFilterState*) FAudio_INTERNAL_SlabAlloc(
+			audio,
 			sizeof(FAudioFilterState) * (*ppSourceVoice)->src.format->nChannels
 		);
 		FAudio_zero(
@@ -562,10 +704,6 @@ uint32_t FAudio_CreateSourceVoice(
 		(double) (*ppSourceVoice)->src.format->nSamplesPerSec /
 		(double) audio->master->master.inputSampleRate
 	)) + EXTRA_DECODE_PADDING * (*ppSourceVoice)->src.format->nChannels;
-	FAudio_INTERNAL_ResizeDecodeCache(
-		audio,
-		((*ppSourceVoice)->src.decodeSamples + EXTRA_DECODE_PADDING) * (*ppSourceVoice)->src.format->nChannels
-	);
 
 	LOG_INFO(audio, "-> %p", (void*) (*ppSourceVoice))
 
@@ -576,6 +714,7 @@ uint32_t FAudio_CreateSourceVoice(
 		audio->sourceLock,
 		audio->pMalloc
 	);
+	FAudio_INTERNAL_ReserveMixCaches(*ppSourceVoice);
 
 #ifdef FAUDIO_DUMP_VOICES
 	FAudio_DUMPVOICE_Init(*ppSourceVoice);
@@ -599,7 +738,10 @@ uint32_t FAudio_CreateSubmixVoice(
 
 	LOG_API_ENTER(audio)
 
-	*ppSubmixVoice = (FAudioSubmixVoice*) audio->pMalloc(sizeof(FAudioVoice));
+	*ppSubmixVoice = (FAudioSubmixVoice*) FAudio_INTERNAL_SlabAlloc(
+		audio,
+		sizeof(FAudioVoice)
+	);
 	FAudio_zero(*ppSubmixVoice, sizeof(FAudioSubmixVoice));
 	(*ppSubmixVoice)->audio = audio;
 	(*ppSubmixVoice)->type = FAUDIO_VOICE_SUBMIX;
@@ -656,7 +798,8 @@ uint32_t FAudio_CreateSubmixVoice(
 
 	/* Default Levels */
 	(*ppSubmixVoice)->volume = 1.0f;
-	(*ppSubmixVoice)->channelVolume = (float*) audio->pMalloc(
+	(*ppSubmixVoice)->channelVolume = (float*) FAudio_INTERNAL_SlabAlloc(
+		audio,
 		sizeof(float) * (*ppSubmixVoice)->outputChannels
 	);
 	for (i = 0; i < (*ppSubmixVoice)->outputChannels; i += 1)
@@ -669,7 +812,8 @@ uint32_t FAudio_CreateSubmixVoice(
 	/* Filters */
 	if (Flags & FAUDIO_VOICE_USEFILTER)
 	{
-		(*ppSubmixVoice)->filterState = (FAudioFilterState*) audio->pMalloc(
+		(*ppSubmixVoice)->filterState = (FAudioFilterState*) FAudio_INTERNAL_SlabAlloc(
+			audio,
 			sizeof(FAudioFilterState) * InputChannels
 		);
 		FAudio_zero(
@@ -685,11 +829,35 @@ uint32_t FAudio_CreateSubmixVoice(
 		audio->submixLock,
 		audio->pMalloc
 	);
+	FAudio_INTERNAL_ReserveMixCaches(*ppSubmixVoice);
 
 	LOG_API_EXIT(audio)
 	return 0;
 }
 
+/* Null Device, see "extensions/OfflineRenderEXT.txt" */
+
+static void FAudio_INTERNAL_NullDeviceInit(
+	uint32_t flags,
+	FAudioWaveFormatExtensible *mixFormat,
+	uint32_t *updateSize
+) {
+	/* Same quantum as the platforms would request, so that offline
+	 * renders match what a real device would have played.
+	 */
+	if (flags & FAUDIO_1024_QUANTUM)
+	{
+		*updateSize = (uint32_t) (
+			mixFormat->Format.nSamplesPerSec /
+			(1000.0 / (64.0 / 3.0))
+		);
+	}
+	else
+	{
+		*updateSize = mixFormat->Format.nSamplesPerSec / 100;
+	}
+}
+
 uint32_t FAudio_CreateMasteringVoice(
 	FAudio *audio,
 	FAudioMasteringVoice **ppMasteringVoice,
@@ -704,8 +872,20 @@ uint32_t FAudio_CreateMasteringVoice(
 	/* For now we only support one allocated master voice at a time */
 	FAudio_assert(audio->master == NULL);
 
-	if (	InputChannels == FAUDIO_DEFAULT_CHANNELS ||
-		InputSampleRate == FAUDIO_DEFAULT_SAMPLERATE	)
+	if (audio->initFlags & FAUDIO_OFFLINE_RENDER_EXT)
+	{
+		/* No device to ask, so pick what most devices would say */
+		if (InputChannels == FAUDIO_DEFAULT_CHANNELS)
+		{
+			InputChannels = 2;
+		}
+		if (InputSampleRate == FAUDIO_DEFAULT_SAMPLERATE)
+		{
+			InputSampleRate = 48000;
+		}
+	}
+	else if (	InputChannels == FAUDIO_DEFAULT_CHANNELS ||
+			InputSampleRate == FAUDIO_DEFAULT_SAMPLERATE	)
 	{
 		FAudioDeviceDetails details;
 		if (FAudio_GetDeviceDetails(audio, DeviceIndex, &details) != 0)
@@ -722,7 +902,10 @@ uint32_t FAudio_CreateMasteringVoice(
 		}
 	}
 
-	*ppMasteringVoice = (FAudioMasteringVoice*) audio->pMalloc(sizeof(FAudioVoice));
+	*ppMasteringVoice = (FAudioMasteringVoice*) FAudio_INTERNAL_SlabAlloc(
+		audio,
+		sizeof(FAudioVoice)
+	);
 	FAudio_zero(*ppMasteringVoice, sizeof(FAudioMasteringVoice));
 	(*ppMasteringVoice)->audio = audio;
 	(*ppMasteringVoice)->type = FAUDIO_VOICE_MASTER;
@@ -761,21 +944,36 @@ uint32_t FAudio_CreateMasteringVoice(
 	);
 
 	/* Platform Device */
-	FAudio_PlatformInit(
-		audio,
-		audio->initFlags,
-		DeviceIndex,
-		&audio->mixFormat,
-		&audio->updateSize,
-		&audio->platform
-	);
-	if (audio->platform == NULL)
+	if (audio->initFlags & FAUDIO_OFFLINE_RENDER_EXT)
 	{
-		FAudioVoice_DestroyVoice(*ppMasteringVoice);
-		*ppMasteringVoice = NULL;
+		/* The null device never opens anything, FAudio_RenderEXT
+		 * drives the engine instead. audio->platform stays NULL so
+		 * that destroying the voice skips FAudio_PlatformQuit.
+		 */
+		FAudio_INTERNAL_NullDeviceInit(
+			audio->initFlags,
+			&audio->mixFormat,
+			&audio->updateSize
+		);
+	}
+	else
+	{
+		FAudio_PlatformInit(
+			audio,
+			audio->initFlags,
+			DeviceIndex,
+			&audio->mixFormat,
+			&audio->updateSize,
+			&audio->platform
+		);
+		if (audio->platform == NULL)
+		{
+			FAudioVoice_DestroyVoice(*ppMasteringVoice);
+			*ppMasteringVoice = NULL;
 
-		/* Not the best code, but it's probably true? */
-		return FAUDIO_E_DEVICE_INVALIDATED;
+			/* Not the best code, but it's probably true? */
+			return FAUDIO_E_DEVICE_INVALIDATED;
+		}
 	}
 	audio->master->outputChannels = audio->mixFormat.Format.nChannels;
 	audio->master->master.inputSampleRate = audio->mixFormat.Format.nSamplesPerSec;
@@ -789,6 +987,7 @@ uint32_t FAudio_CreateMasteringVoice(
 			(*ppMasteringVoice)->master.inputChannels
 		);
 	}
+	FAudio_INTERNAL_ReserveMixCaches(*ppMasteringVoice);
 
 	LOG_API_EXIT(audio)
 	return 0;
@@ -813,8 +1012,11 @@ uint32_t FAudio_CreateMasteringVoice8(
 	 * For now, use our little ID hack to turn szDeviceId into DeviceIndex.
 	 * -flibit
 	 */
-	if (szDeviceId == NULL || szDeviceId[0] == 0)
+	if (	szDeviceId == NULL ||
+		szDeviceId[0] == 0 ||
+		(audio->initFlags & FAUDIO_OFFLINE_RENDER_EXT)	)
 	{
+		/* Offline engines have no devices to pick from */
 		DeviceIndex = 0;
 	}
 	else
@@ -852,6 +1054,43 @@ void FAudio_SetEngineProcedureEXT(
 	LOG_API_EXIT(audio)
 }
 
+uint32_t FAudio_RenderEXT(
+	FAudio *audio,
+	float *pOutput,
+	uint32_t QuantumCount
+) {
+	uint32_t i, quantumSamples;
+
+	LOG_API_ENTER(audio)
+
+	if (	!(audio->initFlags & FAUDIO_OFFLINE_RENDER_EXT) ||
+		audio->master == NULL	)
+	{
+		LOG_ERROR(
+			audio,
+			"%s",
+			"Offline rendering needs FAUDIO_OFFLINE_RENDER_EXT and a mastering voice!"
+		)
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_CALL;
+	}
+
+	quantumSamples = audio->updateSize * audio->master->outputChannels;
+	for (i = 0; i < QuantumCount; i += 1)
+	{
+		/* Same as the platform mix callbacks, stopped engines are silent */
+		FAudio_zero(pOutput, sizeof(float) * quantumSamples);
+		if (audio->active)
+		{
+			FAudio_INTERNAL_UpdateEngine(audio, pOutput);
+		}
+		pOutput += quantumSamples;
+	}
+
+	LOG_API_EXIT(audio)
+	return 0;
+}
+
 uint32_t FAudio_StartEngine(FAudio *audio)
 {
 	LOG_API_ENTER(audio)
@@ -1024,6 +1263,72 @@ void FAudio_SetDebugConfiguration(
 #endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
 }
 
+uint32_t FAudio_GetQuantumTimingsEXT(
+	FAudio *audio,
+	FAudioQuantumTimingEXT *pTimings,
+	uint32_t TimingCount
+) {
+#ifndef FAUDIO_DISABLE_DEBUGCONFIGURATION
+	uint32_t i, read, write;
+
+	LOG_API_ENTER(audio)
+
+	/* Single consumer, so only the audio thread can move under us */
+	read = (uint32_t) FAudio_PlatformAtomicGet(&audio->timingRead);
+	write = (uint32_t) FAudio_PlatformAtomicGet(&audio->timingWrite);
+	for (i = 0; i < TimingCount && read != write; i += 1, read += 1)
+	{
+		FAudio_memcpy(
+			&pTimings[i],
+			&audio->timingRing[read % FAUDIO_TIMING_RING_SIZE],
+			sizeof(FAudioQuantumTimingEXT)
+		);
+	}
+	FAudio_PlatformAtomicSet(&audio->timingRead, (int32_t) read);
+
+	LOG_API_EXIT(audio)
+	return i;
+#else
+	return 0;
+#endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
+}
+
+void FAudio_SetADPCMCacheBudgetEXT(
+	FAudio *audio,
+	uint32_t BudgetBytes
+) {
+	LOG_API_ENTER(audio)
+	FAudio_PlatformLockMutex(audio->adpcmCacheLock);
+	LOG_MUTEX_LOCK(audio, audio->adpcmCacheLock)
+	audio->adpcmCacheBudget = BudgetBytes;
+	FAudio_INTERNAL_TrimADPCMCache(audio);
+	FAudio_PlatformUnlockMutex(audio->adpcmCacheLock);
+	LOG_MUTEX_UNLOCK(audio, audio->adpcmCacheLock)
+	LOG_API_EXIT(audio)
+}
+
+void FAudio_GetADPCMCacheStatsEXT(
+	FAudio *audio,
+	FAudioADPCMCacheStatsEXT *pStats
+) {
+	LOG_API_ENTER(audio)
+	FAudio_PlatformLockMutex(audio->adpcmCacheLock);
+	LOG_MUTEX_LOCK(audio, audio->adpcmCacheLock)
+
+	/* The mixer may have released entries since the last submission */
+	FAudio_INTERNAL_TrimADPCMCache(audio);
+
+	FAudio_memcpy(
+		pStats,
+		&audio->adpcmCacheStats,
+		sizeof(FAudioADPCMCacheStatsEXT)
+	);
+	pStats->BudgetBytes = audio->adpcmCacheBudget;
+	FAudio_PlatformUnlockMutex(audio->adpcmCacheLock);
+	LOG_MUTEX_UNLOCK(audio, audio->adpcmCacheLock)
+	LOG_API_EXIT(audio)
+}
+
 void FAudio_GetProcessingQuantum(
 	FAudio *audio,
 	uint32_t *quantumNumerator,
@@ -1075,6 +1380,13 @@ static void FAudio_RecalcMixMatrix(FAudioVoice *voice, uint32_t sendIndex)
 				voice->sendCoefficients[sendIndex][d * voice->outputChannels + s];
 		}
 	}
+
+	FAudio_INTERNAL_BuildSendPlan(
+		&voice->sendPlans[sendIndex],
+		voice->outputChannels,
+		oChan,
+		matrix
+	);
 }
 
 void FAudioVoice_GetVoiceDetails(
@@ -1108,6 +1420,41 @@ void FAudioVoice_GetVoiceDetails(
 	LOG_API_EXIT(voice->audio)
 }
 
+void FAudioVoice_GetTimingEXT(
+	FAudioVoice *voice,
+	FAudioVoiceTimingEXT *pTiming
+) {
+#ifndef FAUDIO_DISABLE_DEBUGCONFIGURATION
+	FAudioMutex lock;
+
+	LOG_API_ENTER(voice->audio)
+
+	/* The mixer only writes these under the lock it mixes this voice with */
+	if (voice->type == FAUDIO_VOICE_SOURCE)
+	{
+		lock = voice->audio->sourceLock;
+	}
+	else if (voice->type == FAUDIO_VOICE_SUBMIX)
+	{
+		lock = voice->audio->submixLock;
+	}
+	else
+	{
+		lock = voice->effectLock;
+	}
+
+	FAudio_PlatformLockMutex(lock);
+	LOG_MUTEX_LOCK(voice->audio, lock)
+	FAudio_memcpy(pTiming, &voice->timing, sizeof(FAudioVoiceTimingEXT));
+	FAudio_PlatformUnlockMutex(lock);
+	LOG_MUTEX_UNLOCK(voice->audio, lock)
+
+	LOG_API_EXIT(voice->audio)
+#else
+	FAudio_zero(pTiming, sizeof(FAudioVoiceTimingEXT));
+#endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
+}
+
 uint32_t FAudioVoice_SetOutputVoices(
 	FAudioVoice *voice,
 	const FAudioVoiceSends *pSendList
@@ -1147,27 +1494,31 @@ uint32_t FAudioVoice_SetOutputVoices(
 	/* FIXME: This is lazy... */
 	for (i = 0; i < voice->sends.SendCount; i += 1)
 	{
-		voice->audio->pFree(voice->sendCoefficients[i]);
+		FAudio_INTERNAL_SlabFree(voice->audio, voice->sendCoefficients[i]);
 	}
 	if (voice->sendCoefficients != NULL)
 	{
-		voice->audio->pFree(voice->sendCoefficients);
+		FAudio_INTERNAL_SlabFree(voice->audio, voice->sendCoefficients);
 	}
 	for (i = 0; i < voice->sends.SendCount; i += 1)
 	{
-		voice->audio->pFree(voice->mixCoefficients[i]);
+		FAudio_INTERNAL_SlabFree(voice->audio, voice->mixCoefficients[i]);
 	}
 	if (voice->mixCoefficients != NULL)
 	{
-		voice->audio->pFree(voice->mixCoefficients);
+		FAudio_INTERNAL_SlabFree(voice->audio, voice->mixCoefficients);
 	}
 	if (voice->sendMix != NULL)
 	{
-		voice->audio->pFree(voice->sendMix);
+		FAudio_INTERNAL_SlabFree(voice->audio, voice->sendMix);
+	}
+	if (voice->sendPlans != NULL)
+	{
+		FAudio_INTERNAL_SlabFree(voice->audio, voice->sendPlans);
 	}
 	if (voice->sendFilter != NULL)
 	{
-		voice->audio->pFree(voice->sendFilter);
+		FAudio_INTERNAL_SlabFree(voice->audio, voice->sendFilter);
 		voice->sendFilter = NULL;
 	}
 	if (voice->sendFilterState != NULL)
@@ -1176,15 +1527,15 @@ uint32_t FAudioVoice_SetOutputVoices(
 		{
 			if (voice->sendFilterState[i] != NULL)
 			{
-				voice->audio->pFree(voice->sendFilterState[i]);
+				FAudio_INTERNAL_SlabFree(voice->audio, voice->sendFilterState[i]);
 			}
 		}
-		voice->audio->pFree(voice->sendFilterState);
+		FAudio_INTERNAL_SlabFree(voice->audio, voice->sendFilterState);
 		voice->sendFilterState = NULL;
 	}
 	if (voice->sends.pSends != NULL)
 	{
-		voice->audio->pFree(voice->sends.pSends);
+		FAudio_INTERNAL_SlabFree(voice->audio, voice->sends.pSends);
 	}
 
 	if (pSendList == NULL)
@@ -1202,19 +1553,22 @@ uint32_t FAudioVoice_SetOutputVoices(
 		voice->sendCoefficients = NULL;
 		voice->mixCoefficients = NULL;
 		voice->sendMix = NULL;
+		voice->sendPlans = NULL;
 		FAudio_zero(&voice->sends, sizeof(FAudioVoiceSends));
 
 		FAudio_PlatformUnlockMutex(voice->volumeLock);
 		LOG_MUTEX_UNLOCK(voice->audio, voice->volumeLock)
 		FAudio_PlatformUnlockMutex(voice->sendLock);
 		LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
+		FAudio_INTERNAL_ReserveMixCaches(voice);
 		LOG_API_EXIT(voice->audio)
 		return 0;
 	}
 
 	/* Copy send list */
 	voice->sends.SendCount = pSendList->SendCount;
-	voice->sends.pSends = (FAudioSendDescriptor*) voice->audio->pMalloc(
+	voice->sends.pSends = (FAudioSendDescriptor*) FAudio_INTERNAL_SlabAlloc(
+		voice->audio,
 		pSendList->SendCount * sizeof(FAudioSendDescriptor)
 	);
 	FAudio_memcpy(
@@ -1224,15 +1578,22 @@ uint32_t FAudioVoice_SetOutputVoices(
 	);
 
 	/* Allocate/Reset default output matrix, mixer function, filters */
-	voice->sendCoefficients = (float**) voice->audio->pMalloc(
+	voice->sendCoefficients = (float**) FAudio_INTERNAL_SlabAlloc(
+		voice->audio,
 		sizeof(float*) * pSendList->SendCount
 	);
-	voice->mixCoefficients = (float**) voice->audio->pMalloc(
+	voice->mixCoefficients = (float**) FAudio_INTERNAL_SlabAlloc(
+		voice->audio,
 		sizeof(float*) * pSendList->SendCount
 	);
-	voice->sendMix = (FAudioMixCallback*) voice->audio->pMalloc(
+	voice->sendMix = (FAudioMixCallback*) FAudio_INTERNAL_SlabAlloc(
+		voice->audio,
 		sizeof(FAudioMixCallback) * pSendList->SendCount
 	);
+	voice->sendPlans = (FAudioSendPlan*) FAudio_INTERNAL_SlabAlloc(
+		voice->audio,
+		sizeof(FAudioSendPlan) * pSendList->SendCount
+	);
 
 	for (i = 0; i < pSendList->SendCount; i += 1)
 	{
@@ -1244,10 +1605,12 @@ uint32_t FAudioVoice_SetOutputVoices(
 		{
 			outChannels = pSendList->pSends[i].pOutputVoice->mix.inputChannels;
 		}
-		voice->sendCoefficients[i] = (float*) voice->audio->pMalloc(
+		voice->sendCoefficients[i] = (float*) FAudio_INTERNAL_SlabAlloc(
+			voice->audio,
 			sizeof(float) * voice->outputChannels * outChannels
 		);
-		voice->mixCoefficients[i] = (float*) voice->audio->pMalloc(
+		voice->mixCoefficients[i] = (float*) FAudio_INTERNAL_SlabAlloc(
+			voice->audio,
 			sizeof(float) * voice->outputChannels * outChannels
 		);
 
@@ -1264,19 +1627,19 @@ uint32_t FAudioVoice_SetOutputVoices(
 		{
 			if (outChannels == 1)
 			{
-				voice->sendMix[i] = FAudio_INTERNAL_Mix_1in_1out_Scalar;
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_1in_1out;
 			}
 			else if (outChannels == 2)
 			{
-				voice->sendMix[i] = FAudio_INTERNAL_Mix_1in_2out_Scalar;
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_1in_2out;
 			}
 			else if (outChannels == 6)
 			{
-				voice->sendMix[i] = FAudio_INTERNAL_Mix_1in_6out_Scalar;
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_1in_6out;
 			}
 			else if (outChannels == 8)
 			{
-				voice->sendMix[i] = FAudio_INTERNAL_Mix_1in_8out_Scalar;
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_1in_8out;
 			}
 			else
 			{
@@ -1287,19 +1650,19 @@ uint32_t FAudioVoice_SetOutputVoices(
 		{
 			if (outChannels == 1)
 			{
-				voice->sendMix[i] = FAudio_INTERNAL_Mix_2in_1out_Scalar;
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_2in_1out;
 			}
 			else if (outChannels == 2)
 			{
-				voice->sendMix[i] = FAudio_INTERNAL_Mix_2in_2out_Scalar;
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_2in_2out;
 			}
 			else if (outChannels == 6)
 			{
-				voice->sendMix[i] = FAudio_INTERNAL_Mix_2in_6out_Scalar;
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_2in_6out;
 			}
 			else if (outChannels == 8)
 			{
-				voice->sendMix[i] = FAudio_INTERNAL_Mix_2in_8out_Scalar;
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_2in_8out;
 			}
 			else
 			{
@@ -1316,13 +1679,15 @@ uint32_t FAudioVoice_SetOutputVoices(
 			/* Allocate the whole send filter array if needed... */
 			if (voice->sendFilter == NULL)
 			{
-				voice->sendFilter = (FAudioFilterParametersEXT*) voice->audio->pMalloc(
+				voice->sendFilter = (FAudioFilterParametersEXT*) FAudio_INTERNAL_SlabAlloc(
+					voice->audio,
 					sizeof(FAudioFilterParametersEXT) * pSendList->SendCount
 				);
 			}
 			if (voice->sendFilterState == NULL)
 			{
-				voice->sendFilterState = (FAudioFilterState**) voice->audio->pMalloc(
+				voice->sendFilterState = (FAudioFilterState**) FAudio_INTERNAL_SlabAlloc(
+					voice->audio,
 					sizeof(FAudioFilterState*) * pSendList->SendCount
 				);
 				FAudio_zero(
@@ -1336,7 +1701,8 @@ uint32_t FAudioVoice_SetOutputVoices(
 			voice->sendFilter[i].Frequency = FAUDIO_DEFAULT_FILTER_FREQUENCY;
 			voice->sendFilter[i].OneOverQ = FAUDIO_DEFAULT_FILTER_ONEOVERQ;
 			voice->sendFilter[i].WetDryMix = FAUDIO_DEFAULT_FILTER_WETDRYMIX_EXT;
-			voice->sendFilterState[i] = (FAudioFilterState*) voice->audio->pMalloc(
+			voice->sendFilterState[i] = (FAudioFilterState*) FAudio_INTERNAL_SlabAlloc(
+				voice->audio,
 				sizeof(FAudioFilterState) * outChannels
 			);
 			FAudio_zero(
@@ -1351,6 +1717,7 @@ uint32_t FAudioVoice_SetOutputVoices(
 
 	FAudio_PlatformUnlockMutex(voice->sendLock);
 	LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
+	FAudio_INTERNAL_ReserveMixCaches(voice);
 	LOG_API_EXIT(voice->audio)
 	return 0;
 }
@@ -1520,6 +1887,7 @@ uint32_t FAudioVoice_SetEffectChain(
 
 	FAudio_PlatformUnlockMutex(voice->effectLock);
 	LOG_MUTEX_UNLOCK(voice->audio, voice->effectLock)
+	FAudio_INTERNAL_ReserveMixCaches(voice);
 	LOG_API_EXIT(voice->audio)
 	return 0;
 }
@@ -1627,7 +1995,8 @@ uint32_t FAudioVoice_SetEffectParameters(
 
 	if (voice->effects.parameters[EffectIndex] == NULL)
 	{
-		voice->effects.parameters[EffectIndex] = voice->audio->pMalloc(
+		voice->effects.parameters[EffectIndex] = FAudio_INTERNAL_SlabAlloc(
+			voice->audio,
 			ParametersByteSize
 		);
 		voice->effects.parameterSizes[EffectIndex] = ParametersByteSize;
@@ -1636,7 +2005,8 @@ uint32_t FAudioVoice_SetEffectParameters(
 	LOG_MUTEX_LOCK(voice->audio, voice->effectLock)
 	if (voice->effects.parameterSizes[EffectIndex] < ParametersByteSize)
 	{
-		voice->effects.parameters[EffectIndex] = voice->audio->pRealloc(
+		voice->effects.parameters[EffectIndex] = FAudio_INTERNAL_SlabRealloc(
+			voice->audio,
 			voice->effects.parameters[EffectIndex],
 			ParametersByteSize
 		);
@@ -2347,8 +2717,6 @@ static void destroy_voice(FAudioVoice *voice)
 
 	if (voice->type == FAUDIO_VOICE_SOURCE)
 	{
-		FAudioBufferEntry *entry, *next;
-
 #ifdef FAUDIO_DUMP_VOICES
 		FAudio_DUMPVOICE_Finalize((FAudioSourceVoice*) voice);
 #endif /* FAUDIO_DUMP_VOICES */
@@ -2371,23 +2739,21 @@ static void destroy_voice(FAudioVoice *voice)
 		FAudio_PlatformUnlockMutex(voice->audio->sourceLock);
 		LOG_MUTEX_UNLOCK(voice->audio, voice->audio->sourceLock)
 
-		entry = voice->src.bufferList;
-		while (entry != NULL)
+		/* Every buffer entry lives in the queue's pool */
+		FAudio_INTERNAL_UnpinADPCMCache(voice);
+#ifndef DISABLE_XNASONG
+		FAudio_INTERNAL_CloseCompressedEntries(voice, 0);
+#endif /* DISABLE_XNASONG */
+		FAudio_INTERNAL_SlabFree(voice->audio, voice->src.queue);
+		if (voice->src.adpcmBlocks != NULL)
 		{
-			next = entry->next;
-			voice->audio->pFree(entry);
-			entry = next;
+			FAudio_INTERNAL_SlabFree(voice->audio, voice->src.adpcmBlocks);
 		}
-
-		entry = voice->src.flushList;
-		while (entry != NULL)
+		if (voice->src.sincHistory != NULL)
 		{
-			next = entry->next;
-			voice->audio->pFree(entry);
-			entry = next;
+			FAudio_INTERNAL_SlabFree(voice->audio, voice->src.sincHistory);
 		}
-
-		voice->audio->pFree(voice->src.format);
+		FAudio_INTERNAL_SlabFree(voice->audio, voice->src.format);
 		LOG_MUTEX_DESTROY(voice->audio, voice->src.bufferLock)
 		FAudio_PlatformDestroyMutex(voice->src.bufferLock);
 #ifdef HAVE_WMADEC
@@ -2430,27 +2796,31 @@ static void destroy_voice(FAudioVoice *voice)
 		LOG_MUTEX_LOCK(voice->audio, voice->sendLock)
 		for (i = 0; i < voice->sends.SendCount; i += 1)
 		{
-			voice->audio->pFree(voice->sendCoefficients[i]);
+			FAudio_INTERNAL_SlabFree(voice->audio, voice->sendCoefficients[i]);
 		}
 		if (voice->sendCoefficients != NULL)
 		{
-			voice->audio->pFree(voice->sendCoefficients);
+			FAudio_INTERNAL_SlabFree(voice->audio, voice->sendCoefficients);
 		}
 		for (i = 0; i < voice->sends.SendCount; i += 1)
 		{
-			voice->audio->pFree(voice->mixCoefficients[i]);
+			FAudio_INTERNAL_SlabFree(voice->audio, voice->mixCoefficients[i]);
 		}
 		if (voice->mixCoefficients != NULL)
 		{
-			voice->audio->pFree(voice->mixCoefficients);
+			FAudio_INTERNAL_SlabFree(voice->audio, voice->mixCoefficients);
 		}
 		if (voice->sendMix != NULL)
 		{
-			voice->audio->pFree(voice->sendMix);
+			FAudio_INTERNAL_SlabFree(voice->audio, voice->sendMix);
+		}
+		if (voice->sendPlans != NULL)
+		{
+			FAudio_INTERNAL_SlabFree(voice->audio, voice->sendPlans);
 		}
 		if (voice->sendFilter != NULL)
 		{
-			voice->audio->pFree(voice->sendFilter);
+			FAudio_INTERNAL_SlabFree(voice->audio, voice->sendFilter);
 		}
 		if (voice->sendFilterState != NULL)
 		{
@@ -2458,14 +2828,14 @@ static void destroy_voice(FAudioVoice *voice)
 			{
 				if (voice->sendFilterState[i] != NULL)
 				{
-					voice->audio->pFree(voice->sendFilterState[i]);
+					FAudio_INTERNAL_SlabFree(voice->audio, voice->sendFilterState[i]);
 				}
 			}
-			voice->audio->pFree(voice->sendFilterState);
+			FAudio_INTERNAL_SlabFree(voice->audio, voice->sendFilterState);
 		}
 		if (voice->sends.pSends != NULL)
 		{
-			voice->audio->pFree(voice->sends.pSends);
+			FAudio_INTERNAL_SlabFree(voice->audio, voice->sends.pSends);
 		}
 		FAudio_PlatformUnlockMutex(voice->sendLock);
 		LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
@@ -2490,7 +2860,7 @@ static void destroy_voice(FAudioVoice *voice)
 		LOG_MUTEX_LOCK(voice->audio, voice->filterLock)
 		if (voice->filterState != NULL)
 		{
-			voice->audio->pFree(voice->filterState);
+			FAudio_INTERNAL_SlabFree(voice->audio, voice->filterState);
 		}
 		FAudio_PlatformUnlockMutex(voice->filterLock);
 		LOG_MUTEX_UNLOCK(voice->audio, voice->filterLock)
@@ -2504,7 +2874,7 @@ static void destroy_voice(FAudioVoice *voice)
 		LOG_MUTEX_LOCK(voice->audio, voice->volumeLock)
 		if (voice->channelVolume != NULL)
 		{
-			voice->audio->pFree(voice->channelVolume);
+			FAudio_INTERNAL_SlabFree(voice->audio, voice->channelVolume);
 		}
 		FAudio_PlatformUnlockMutex(voice->volumeLock);
 		LOG_MUTEX_UNLOCK(voice->audio, voice->volumeLock)
@@ -2512,7 +2882,7 @@ static void destroy_voice(FAudioVoice *voice)
 		FAudio_PlatformDestroyMutex(voice->volumeLock);
 	}
 
-	voice->audio->pFree(voice);
+	FAudio_INTERNAL_SlabFree(voice->audio, voice);
 }
 
 uint32_t FAudioVoice_DestroyVoiceSafeEXT(FAudioVoice *voice)
@@ -2611,7 +2981,10 @@ uint32_t FAudioSourceVoice_SubmitSourceBuffer(
 ) {
 	uint32_t adpcmMask, *adpcmByteCount;
 	uint32_t playBegin, playLength, loopBegin, loopLength, bufferLength;
-	FAudioBufferEntry *entry, *list;
+	FAudioBufferEntry *entry;
+#ifndef DISABLE_XNASONG
+	FAudioCompressedDecoder *compressed = NULL;
+#endif /* DISABLE_XNASONG */
 
 	LOG_API_ENTER(voice->audio)
 	LOG_INFO(
@@ -2668,6 +3041,26 @@ uint32_t FAudioSourceVoice_SubmitSourceBuffer(
 			pBufferWMA->pDecodedPacketCumulativeBytes[pBufferWMA->PacketCount - 1] /
 			(voice->src.format->nChannels * voice->src.format->wBitsPerSample / 8);
 	}
+#ifndef DISABLE_XNASONG
+	else if (	voice->src.format->wFormatTag == FAUDIO_FORMAT_VORBIS_EXT ||
+			voice->src.format->wFormatTag == FAUDIO_FORMAT_QOA_EXT	)
+	{
+		/* The buffer is a whole file, we need its decoder for the length.
+		 * Opening it here also keeps allocations off the mixer thread.
+		 */
+		bufferLength = 0;
+		if (pBuffer->AudioBytes > 0)
+		{
+			compressed = FAudio_INTERNAL_OpenCompressed(voice, pBuffer);
+			if (compressed == NULL)
+			{
+				LOG_API_EXIT(voice->audio)
+				return FAUDIO_E_INVALID_CALL;
+			}
+			bufferLength = compressed->length;
+		}
+	}
+#endif /* DISABLE_XNASONG */
 	else
 	{
 		bufferLength =
@@ -2684,8 +3077,7 @@ uint32_t FAudioSourceVoice_SubmitSourceBuffer(
 	{
 		/* Reading past the end of the buffer, or begin + length overflow uint32_t, which
 		 * would also read past the end of the buffer. */
-		LOG_API_EXIT(voice->audio)
-		return FAUDIO_E_INVALID_CALL;
+		goto invalid;
 	}
 
 	if (pBuffer->LoopCount > 0 && pBufferWMA == NULL && voice->src.format->wFormatTag != FAUDIO_FORMAT_XMAUDIO2)
@@ -2693,8 +3085,7 @@ uint32_t FAudioSourceVoice_SubmitSourceBuffer(
 		/* "The value of LoopBegin must be less than PlayBegin + PlayLength" */
 		if (loopBegin >= (playBegin + playLength))
 		{
-			LOG_API_EXIT(voice->audio)
-			return FAUDIO_E_INVALID_CALL;
+			goto invalid;
 		}
 
 		/* LoopLength Default */
@@ -2710,8 +3101,7 @@ uint32_t FAudioSourceVoice_SubmitSourceBuffer(
 			(loopBegin + loopLength) <= playBegin ||
 			(loopBegin + loopLength) > (playBegin + playLength))	)
 		{
-			LOG_API_EXIT(voice->audio)
-			return FAUDIO_E_INVALID_CALL;
+			goto invalid;
 		}
 	}
 
@@ -2737,8 +3127,29 @@ uint32_t FAudioSourceVoice_SubmitSourceBuffer(
 		loopLength = playBegin + playLength;
 	}
 
-	/* Allocate, now that we have valid input */
-	entry = (FAudioBufferEntry*) voice->audio->pMalloc(sizeof(FAudioBufferEntry));
+	/* Grab an entry from the pool, now that we have valid input */
+	FAudio_PlatformLockMutex(voice->src.bufferLock);
+	LOG_MUTEX_LOCK(voice->audio, voice->src.bufferLock)
+#ifndef DISABLE_XNASONG
+	if (	voice->src.format->wFormatTag == FAUDIO_FORMAT_VORBIS_EXT ||
+		voice->src.format->wFormatTag == FAUDIO_FORMAT_QOA_EXT	)
+	{
+		FAudio_INTERNAL_CloseCompressedEntries(voice, 1);
+	}
+#endif /* DISABLE_XNASONG */
+	entry = FAudio_INTERNAL_AcquireBufferEntry(voice->src.queue);
+	if (entry == NULL)
+	{
+		LOG_ERROR(
+			voice->audio,
+			"%p: more than %d buffers queued",
+			(void*) voice,
+			FAUDIO_MAX_QUEUED_BUFFERS
+		)
+		FAudio_PlatformUnlockMutex(voice->src.bufferLock);
+		LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
+		goto invalid;
+	}
 	FAudio_memcpy(&entry->buffer, pBuffer, sizeof(FAudioBuffer));
 	entry->buffer.PlayBegin = playBegin;
 	entry->buffer.PlayLength = playLength;
@@ -2750,6 +3161,21 @@ uint32_t FAudioSourceVoice_SubmitSourceBuffer(
 	}
 	entry->next = NULL;
 
+	/* ADPCMCacheEXT, decodes the whole buffer now if it's not cached */
+	if (	voice->src.format->wFormatTag == FAUDIO_FORMAT_MSADPCM &&
+		pBuffer->pAudioData != NULL	)
+	{
+		FAudio_INTERNAL_PinADPCMCache(voice, entry);
+	}
+#ifndef DISABLE_XNASONG
+	else if (compressed != NULL)
+	{
+		/* Closed right away if the PCM gets cached */
+		entry->compressed = compressed;
+		FAudio_INTERNAL_PinADPCMCache(voice, entry);
+	}
+#endif /* DISABLE_XNASONG */
+
 	if (	voice->audio->version <= 7 && (
 		entry->buffer.LoopCount > 0 &&
 		entry->buffer.LoopBegin + entry->buffer.LoopLength <= entry->buffer.PlayBegin))
@@ -2765,30 +3191,12 @@ uint32_t FAudioSourceVoice_SubmitSourceBuffer(
 	}
 #endif /* FAUDIO_DUMP_VOICES */
 
-	/* Submit! */
-	FAudio_PlatformLockMutex(voice->src.bufferLock);
-	LOG_MUTEX_LOCK(voice->audio, voice->src.bufferLock)
-	if (voice->src.bufferList == NULL)
-	{
-		voice->src.bufferList = entry;
-		voice->src.curBufferOffset = entry->buffer.PlayBegin;
-		voice->src.newBuffer = 1;
-	}
-	else
-	{
-		list = voice->src.bufferList;
-		while (list->next != NULL)
-		{
-			list = list->next;
-		}
-		list->next = entry;
-
-		/* For some bizarre reason we get scenarios where a buffer is freed, only to
-		 * have the allocator give us the exact same address and somehow get a single
-		 * buffer referencing itself. I don't even know.
-		 */
-		FAudio_assert(list != entry);
-	}
+	/* Submit! The entry was checked out with a command slot, this can't fail */
+	FAudio_INTERNAL_PushBufferCommand(
+		voice->src.queue,
+		FAUDIO_BUFFER_COMMAND_SUBMIT,
+		entry
+	);
 	LOG_INFO(
 		voice->audio,
 		"%p: appended buffer %p",
@@ -2799,84 +3207,88 @@ uint32_t FAudioSourceVoice_SubmitSourceBuffer(
 	LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
 	LOG_API_EXIT(voice->audio)
 	return 0;
+
+invalid:
+#ifndef DISABLE_XNASONG
+	if (compressed != NULL)
+	{
+		FAudio_INTERNAL_CloseCompressed(voice->audio, compressed);
+	}
+#endif /* DISABLE_XNASONG */
+	LOG_API_EXIT(voice->audio)
+	return FAUDIO_E_INVALID_CALL;
 }
 
-uint32_t FAudioSourceVoice_FlushSourceBuffers(
-	FAudioSourceVoice *voice
+static uint32_t FAudio_INTERNAL_QueueBufferCommand(
+	FAudioSourceVoice *voice,
+	FAudioBufferCommandType type
 ) {
-	FAudioBufferEntry *entry, *latest;
-
-	LOG_API_ENTER(voice->audio)
-	FAudio_assert(voice->type == FAUDIO_VOICE_SOURCE);
+	uint8_t queued;
 
 	FAudio_PlatformLockMutex(voice->src.bufferLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->src.bufferLock)
+	queued = FAudio_INTERNAL_PushBufferCommand(voice->src.queue, type, NULL);
+	FAudio_PlatformUnlockMutex(voice->src.bufferLock);
+	LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
 
-	/* If the source is playing, don't flush the active buffer */
-	entry = voice->src.bufferList;
-	if ((voice->src.active == 1) && entry != NULL && !voice->src.newBuffer)
+	if (!queued)
 	{
-		entry = entry->next;
-		voice->src.bufferList->next = NULL;
-	}
-	else
-	{
-		voice->src.curBufferOffset = 0;
-		voice->src.bufferList = NULL;
-		voice->src.newBuffer = 0;
+		/* Only happens when the mixer hasn't run for a long while */
+		LOG_ERROR(
+			voice->audio,
+			"%p: buffer command queue is full",
+			(void*) voice
+		)
+		return FAUDIO_E_INVALID_CALL;
 	}
+	return 0;
+}
 
-	/* Move them to the pending flush list */
-	if (entry != NULL)
-	{
-		if (voice->src.flushList == NULL)
-		{
-			voice->src.flushList = entry;
-		}
-		else
-		{
-			latest = voice->src.flushList;
-			while (latest->next != NULL)
-			{
-				latest = latest->next;
-			}
-			latest->next = entry;
-		}
-	}
+uint32_t FAudioSourceVoice_FlushSourceBuffers(
+	FAudioSourceVoice *voice
+) {
+	uint32_t result;
+
+	LOG_API_ENTER(voice->audio)
+	FAudio_assert(voice->type == FAUDIO_VOICE_SOURCE);
+
+	/* If the source is playing, don't flush the active buffer. The mixer
+	 * does the actual flushing, but whether we're playing is decided now.
+	 */
+	result = FAudio_INTERNAL_QueueBufferCommand(
+		voice,
+		(voice->src.active == 1) ?
+			FAUDIO_BUFFER_COMMAND_FLUSH_PENDING :
+			FAUDIO_BUFFER_COMMAND_FLUSH_ALL
+	);
 
-	FAudio_PlatformUnlockMutex(voice->src.bufferLock);
-	LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
 	LOG_API_EXIT(voice->audio)
-	return 0;
+	return result;
 }
 
 uint32_t FAudioSourceVoice_Discontinuity(
 	FAudioSourceVoice *voice
 ) {
-	FAudioBufferEntry *buf;
+	uint32_t result;
 
 	LOG_API_ENTER(voice->audio)
 	FAudio_assert(voice->type == FAUDIO_VOICE_SOURCE);
 
-	FAudio_PlatformLockMutex(voice->src.bufferLock);
-	LOG_MUTEX_LOCK(voice->audio, voice->src.bufferLock)
-
-	if (voice->src.bufferList != NULL)
-	{
-		for (buf = voice->src.bufferList; buf->next != NULL; buf = buf->next);
-		buf->buffer.Flags |= FAUDIO_END_OF_STREAM;
-	}
+	result = FAudio_INTERNAL_QueueBufferCommand(
+		voice,
+		FAUDIO_BUFFER_COMMAND_DISCONTINUITY
+	);
 
-	FAudio_PlatformUnlockMutex(voice->src.bufferLock);
-	LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
 	LOG_API_EXIT(voice->audio)
-	return 0;
+	return result;
 }
 
 uint32_t FAudioSourceVoice_ExitLoop(
 	FAudioSourceVoice *voice,
 	uint32_t OperationSet
 ) {
+	uint32_t result;
+
 	LOG_API_ENTER(voice->audio)
 
 	if (OperationSet != FAUDIO_COMMIT_NOW && voice->audio->active)
@@ -2891,18 +3303,13 @@ uint32_t FAudioSourceVoice_ExitLoop(
 
 	FAudio_assert(voice->type == FAUDIO_VOICE_SOURCE);
 
-	FAudio_PlatformLockMutex(voice->src.bufferLock);
-	LOG_MUTEX_LOCK(voice->audio, voice->src.bufferLock)
-
-	if (voice->src.bufferList != NULL)
-	{
-		voice->src.bufferList->buffer.LoopCount = 0;
-	}
+	result = FAudio_INTERNAL_QueueBufferCommand(
+		voice,
+		FAUDIO_BUFFER_COMMAND_EXITLOOP
+	);
 
-	FAudio_PlatformUnlockMutex(voice->src.bufferLock);
-	LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
 	LOG_API_EXIT(voice->audio)
-	return 0;
+	return result;
 }
 
 void FAudioSourceVoice_GetState(
@@ -2910,8 +3317,6 @@ void FAudioSourceVoice_GetState(
 	FAudioVoiceState *pVoiceState,
 	uint32_t Flags
 ) {
-	FAudioBufferEntry *entry;
-
 	LOG_API_ENTER(voice->audio)
 	FAudio_assert(voice->type == FAUDIO_VOICE_SOURCE);
 
@@ -2923,29 +3328,11 @@ void FAudioSourceVoice_GetState(
 		pVoiceState->SamplesPlayed = voice->src.totalSamples;
 	}
 
-	pVoiceState->BuffersQueued = 0;
-	pVoiceState->pCurrentBufferContext = NULL;
-	if (voice->src.bufferList != NULL)
-	{
-		entry = voice->src.bufferList;
-		if (!voice->src.newBuffer)
-		{
-			pVoiceState->pCurrentBufferContext = entry->buffer.pContext;
-		}
-		do
-		{
-			pVoiceState->BuffersQueued += 1;
-			entry = entry->next;
-		} while (entry != NULL);
-	}
-
 	/* Pending flushed buffers also count */
-	entry = voice->src.flushList;
-	while (entry != NULL)
-	{
-		pVoiceState->BuffersQueued += 1;
-		entry = entry->next;
-	}
+	pVoiceState->BuffersQueued = FAudio_INTERNAL_BuffersQueued(voice->src.queue);
+	pVoiceState->pCurrentBufferContext = FAudio_PlatformAtomicGetPtr(
+		&voice->src.queue->currentContext
+	);
 
 	LOG_INFO(
 		voice->audio,
@@ -3019,7 +3406,7 @@ uint32_t FAudioSourceVoice_SetSourceSampleRate(
 	FAudio_PlatformLockMutex(voice->src.bufferLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->src.bufferLock)
 	if (	voice->audio->version > 7 &&
-		voice->src.bufferList != NULL	)
+		FAudio_INTERNAL_BuffersQueued(voice->src.queue) > 0	)
 	{
 		FAudio_PlatformUnlockMutex(voice->src.bufferLock);
 		LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
@@ -3038,10 +3425,6 @@ uint32_t FAudioSourceVoice_SetSourceSampleRate(
 		(double) NewSourceSampleRate /
 		(double) voice->audio->master->master.inputSampleRate
 	) + EXTRA_DECODE_PADDING * voice->src.format->nChannels;
-	FAudio_INTERNAL_ResizeDecodeCache(
-		voice->audio,
-		(newDecodeSamples + EXTRA_DECODE_PADDING) * voice->src.format->nChannels
-	);
 	voice->src.decodeSamples = newDecodeSamples;
 
 	FAudio_PlatformLockMutex(voice->sendLock);
@@ -3051,6 +3434,7 @@ uint32_t FAudioSourceVoice_SetSourceSampleRate(
 	{
 		FAudio_PlatformUnlockMutex(voice->sendLock);
 		LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
+		FAudio_INTERNAL_ReserveMixCaches(voice);
 		LOG_API_EXIT(voice->audio)
 		return 0;
 	}
@@ -3068,6 +3452,7 @@ uint32_t FAudioSourceVoice_SetSourceSampleRate(
 	FAudio_PlatformUnlockMutex(voice->sendLock);
 	LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
 
+	FAudio_INTERNAL_ReserveMixCaches(voice);
 	LOG_API_EXIT(voice->audio)
 	return 0;
 }
@@ -104,30 +104,60 @@ static inline void DspDelay_Change(DspDelay *filter, float delay_ms)
 	filter->read_idx = (filter->write_idx - filter->delay + filter->capacity) % filter->capacity;
 }
 
-static inline float DspDelay_Read(DspDelay *filter)
+/* Delay lines are processed a block at a time. A block is cut wherever the
+ * read or write index wraps, so the loops only ever see contiguous memory.
+ */
+static inline uint32_t DspDelay_Contiguous(DspDelay *filter, uint32_t samples)
 {
-	float delay_out;
-
 	FAudio_assert(filter->read_idx < filter->capacity);
+	FAudio_assert(filter->write_idx < filter->capacity);
 
-	delay_out = filter->buffer[filter->read_idx];
-	filter->read_idx = (filter->read_idx + 1) % filter->capacity;
-	return delay_out;
+	samples = FAudio_min(samples, filter->capacity - filter->read_idx);
+	return FAudio_min(samples, filter->capacity - filter->write_idx);
 }
 
-static inline void DspDelay_Write(DspDelay *filter, float sample)
+static inline void DspDelay_Advance(DspDelay *filter, uint32_t samples)
 {
-	FAudio_assert(filter->write_idx < filter->capacity);
-
-	filter->buffer[filter->write_idx] = sample;
-	filter->write_idx = (filter->write_idx + 1) % filter->capacity;
+	filter->read_idx += samples;
+	if (filter->read_idx == filter->capacity)
+	{
+		filter->read_idx = 0;
+	}
+	filter->write_idx += samples;
+	if (filter->write_idx == filter->capacity)
+	{
+		filter->write_idx = 0;
+	}
 }
 
-static inline float DspDelay_Process(DspDelay *filter, float sample_in)
-{
-	float delay_out = DspDelay_Read(filter);
-	DspDelay_Write(filter, sample_in);
-	return delay_out;
+/* samples_in and samples_out may be the same buffer */
+static inline void DspDelay_Process(
+	DspDelay *filter,
+	const float *samples_in,
+	float *samples_out,
+	uint32_t sample_count
+) {
+	uint32_t i, span;
+	const float *read;
+	float *write;
+	float sample_in;
+
+	while (sample_count > 0)
+	{
+		span = DspDelay_Contiguous(filter, sample_count);
+		read = filter->buffer + filter->read_idx;
+		write = filter->buffer + filter->write_idx;
+		for (i = 0; i < span; i += 1)
+		{
+			sample_in = samples_in[i];
+			samples_out[i] = read[i];
+			write[i] = sample_in;
+		}
+		DspDelay_Advance(filter, span);
+		samples_in += span;
+		samples_out += span;
+		sample_count -= span;
+	}
 }
 
 /* FIXME: This is currently unused! What was it for...? -flibit
@@ -296,25 +326,6 @@ static inline void DspCombShelving_Initialize(
 	);
 }
 
-static inline float DspCombShelving_Process(
-	DspCombShelving *filter,
-	float sample_in
-) {
-	float delay_out, feedback, to_buf;
-
-	delay_out = DspDelay_Read(&filter->comb_delay);
-
-	/* Apply shelving filters */
-	feedback = DspBiQuad_Process(&filter->high_shelving, delay_out);
-	feedback = DspBiQuad_Process(&filter->low_shelving, feedback);
-
-	/* Apply comb filter */
-	to_buf = Undenormalize(sample_in + (filter->comb_feedback_gain * feedback));
-	DspDelay_Write(&filter->comb_delay, to_buf);
-
-	return delay_out;
-}
-
 static inline void DspCombShelving_Reset(DspCombShelving *filter)
 {
 	DspDelay_Reset(&filter->comb_delay);
@@ -356,16 +367,37 @@ static inline void DspAllPass_Change(DspAllPass *filter, float delay_ms, float g
 	filter->feedback_gain = gain;
 }
 
-static inline float DspAllPass_Process(DspAllPass *filter, float sample_in)
-{
+/* samples_in and samples_out may be the same buffer */
+static inline void DspAllPass_Process(
+	DspAllPass *filter,
+	const float *samples_in,
+	float *samples_out,
+	uint32_t sample_count
+) {
+	uint32_t i, span;
+	const float *read;
+	float *write;
 	float delay_out, to_buf;
 
-	delay_out = DspDelay_Read(&filter->delay);
+	while (sample_count > 0)
+	{
+		span = DspDelay_Contiguous(&filter->delay, sample_count);
+		read = filter->delay.buffer + filter->delay.read_idx;
+		write = filter->delay.buffer + filter->delay.write_idx;
+		for (i = 0; i < span; i += 1)
+		{
+			delay_out = read[i];
 
-	to_buf = Undenormalize(sample_in + (filter->feedback_gain * delay_out));
-	DspDelay_Write(&filter->delay, to_buf);
+			to_buf = Undenormalize(samples_in[i] + (filter->feedback_gain * delay_out));
+			write[i] = to_buf;
 
-	return Undenormalize(delay_out - (filter->feedback_gain * to_buf));
+			samples_out[i] = Undenormalize(delay_out - (filter->feedback_gain * to_buf));
+		}
+		DspDelay_Advance(&filter->delay, span);
+		samples_in += span;
+		samples_out += span;
+		sample_count -= span;
+	}
 }
 
 static inline void DspAllPass_Reset(DspAllPass *filter)
@@ -452,6 +484,7 @@ float RoomSize;			1 - 100 feet (NOT USED YET)
 #define REVERB_COUNT_COMB	8
 #define REVERB_COUNT_APF_IN	1
 #define REVERB_COUNT_APF_OUT	4
+#define REVERB_BLOCK_SIZE	256
 
 static float COMB_DELAYS[REVERB_COUNT_COMB] =
 {
@@ -567,6 +600,12 @@ typedef struct DspReverb
 	float room_gain;
 	float wet_ratio;
 	float dry_ratio;
+
+	/* Scratch space for one block, see DspReverb_INTERNAL_ProcessBlock */
+	float in_block[REVERB_BLOCK_SIZE];
+	float early_block[REVERB_BLOCK_SIZE];
+	float comb_block[REVERB_BLOCK_SIZE];
+	float late_block[5][REVERB_BLOCK_SIZE];
 } DspReverb;
 
 static inline void DspReverb_Create(
@@ -865,68 +904,197 @@ static inline void DspReverb_SetParameters9(
 	DspReverb_SetParameters(reverb, &oldParams);
 }
 
-static inline float DspReverb_INTERNAL_ProcessEarly(
+/* The network runs a block of up to REVERB_BLOCK_SIZE samples at a time, one
+ * stage after the other, rather than one sample at a time through all of it.
+ * Stages only feed back into themselves, so each channel's stages still see
+ * exactly the samples they always have. The eight combs of a channel are run
+ * side by side by FAudio_INTERNAL_ProcessCombBank.
+ *
+ * The output is bit-identical to the old per-sample network, as long as the
+ * compiler doesn't contract multiply-adds into FMAs; when it does, samples can
+ * differ by a few ULPs, which the allpasses don't amplify (they have unity
+ * gain), so the difference stays below 1e-6 of full scale. The comb kernels
+ * don't know about DISABLE_SUBNORMALS, so it only applies to the other stages.
+ */
+
+static inline void DspReverb_INTERNAL_ProcessEarly(
 	DspReverb *reverb,
-	float sample_in
+	uint32_t sample_count
 ) {
-	float early;
 	int32_t i;
 
 	/* Pre-Delay */
-	early = DspDelay_Process(&reverb->early_delay, sample_in);
+	DspDelay_Process(
+		&reverb->early_delay,
+		reverb->in_block,
+		reverb->early_block,
+		sample_count
+	);
 
 	/* Early Reflections */
 	for (i = 0; i < REVERB_COUNT_APF_IN; i += 1)
 	{
-		early = DspAllPass_Process(&reverb->apf_in[i], early);
+		DspAllPass_Process(
+			&reverb->apf_in[i],
+			reverb->early_block,
+			reverb->early_block,
+			sample_count
+		);
 	}
-
-	return early;
 }
 
-static inline float DspReverb_INTERNAL_ProcessChannel(
-	DspReverb *reverb,
+static inline void DspReverb_INTERNAL_ProcessCombs(
 	DspReverbChannel *channel,
-	float sample_in
+	const float *samples_in,
+	float *samples_out,
+	uint32_t sample_count
 ) {
-	float revdelay, early_late, sample_out;
+	FAudioCombBank bank;
+	DspCombShelving *comb;
+	uint32_t span;
 	int32_t i;
 
-	revdelay = DspDelay_Process(&channel->reverb_delay, sample_in);
+	for (i = 0; i < REVERB_COUNT_COMB; i += 1)
+	{
+		comb = &channel->lpf_comb[i];
+		bank.feedback[i] = comb->comb_feedback_gain;
+
+		/* Shelving filters are first-order, so delay1 is always 0 */
+		#define BANK_SHELF(shelf, prefix) \
+			bank.prefix##_a0[i] = comb->shelf.a0; \
+			bank.prefix##_a1[i] = comb->shelf.a1; \
+			bank.prefix##_b1[i] = comb->shelf.b1; \
+			bank.prefix##_c0[i] = comb->shelf.c0; \
+			bank.prefix##_d0[i] = comb->shelf.d0; \
+			bank.prefix##_state[i] = comb->shelf.delay0;
+		BANK_SHELF(high_shelving, high)
+		BANK_SHELF(low_shelving, low)
+		#undef BANK_SHELF
+	}
+
+	while (sample_count > 0)
+	{
+		span = sample_count;
+		for (i = 0; i < REVERB_COUNT_COMB; i += 1)
+		{
+			comb = &channel->lpf_comb[i];
+			span = DspDelay_Contiguous(&comb->comb_delay, span);
+		}
+		for (i = 0; i < REVERB_COUNT_COMB; i += 1)
+		{
+			comb = &channel->lpf_comb[i];
+			bank.read[i] = comb->comb_delay.buffer + comb->comb_delay.read_idx;
+			bank.write[i] = comb->comb_delay.buffer + comb->comb_delay.write_idx;
+		}
+
+		FAudio_INTERNAL_ProcessCombBank(&bank, samples_in, samples_out, span);
+
+		for (i = 0; i < REVERB_COUNT_COMB; i += 1)
+		{
+			DspDelay_Advance(&channel->lpf_comb[i].comb_delay, span);
+		}
+		samples_in += span;
+		samples_out += span;
+		sample_count -= span;
+	}
 
-	sample_out = 0.0f;
 	for (i = 0; i < REVERB_COUNT_COMB; i += 1)
 	{
-		sample_out += DspCombShelving_Process(
-			&channel->lpf_comb[i],
-			revdelay
-		);
+		comb = &channel->lpf_comb[i];
+		comb->high_shelving.delay0 = bank.high_state[i];
+		comb->low_shelving.delay0 = bank.low_state[i];
+	}
+}
+
+static inline void DspReverb_INTERNAL_ProcessChannel(
+	DspReverb *reverb,
+	DspReverbChannel *channel,
+	float *samples_out,
+	uint32_t sample_count
+) {
+	const float *early = reverb->early_block;
+	float *late = reverb->comb_block;
+	float early_late;
+	uint32_t i;
+
+	/* samples_out doubles as the delayed input to the combs */
+	DspDelay_Process(
+		&channel->reverb_delay,
+		early,
+		samples_out,
+		sample_count
+	);
+
+	DspReverb_INTERNAL_ProcessCombs(
+		channel,
+		samples_out,
+		late,
+		sample_count
+	);
+	for (i = 0; i < sample_count; i += 1)
+	{
+		late[i] /= (float) REVERB_COUNT_COMB;
 	}
-	sample_out /= (float) REVERB_COUNT_COMB;
 
 	/* Output Diffusion */
 	for (i = 0; i < REVERB_COUNT_APF_OUT; i += 1)
 	{
-		sample_out = DspAllPass_Process(
+		DspAllPass_Process(
 			&channel->apf_out[i],
-			sample_out
+			late,
+			late,
+			sample_count
 		);
 	}
 
 	/* Combine early reflections and reverberation */
-	early_late = (
-		(sample_in * channel->early_gain) +
-		(sample_out * reverb->reverb_gain)
-	);
+	for (i = 0; i < sample_count; i += 1)
+	{
+		early_late = (
+			(early[i] * channel->early_gain) +
+			(late[i] * reverb->reverb_gain)
+		);
+		samples_out[i] = early_late * reverb->room_gain;
+	}
+}
 
-	/* Room filter */
-	sample_out = DspBiQuad_Process(
-		&channel->room_high_shelf,
-		early_late * reverb->room_gain
-	);
+/* Runs in_block through the network, into late_block[0 .. reverb_channels] */
+static inline void DspReverb_INTERNAL_ProcessBlock(
+	DspReverb *reverb,
+	uint32_t sample_count
+) {
+	uint32_t i;
+	int32_t c;
+
+	/* Early Reflections */
+	DspReverb_INTERNAL_ProcessEarly(reverb, sample_count);
 
-	/* PositionMatrixLeft/Right */
-	return sample_out * channel->gain;
+	/* Reverberation */
+	for (c = 0; c < reverb->reverb_channels; c += 1)
+	{
+		DspReverb_INTERNAL_ProcessChannel(
+			reverb,
+			&reverb->channel[c],
+			reverb->late_block[c],
+			sample_count
+		);
+	}
+
+	/* The room filters are serial, so run the channels' filters together */
+	for (i = 0; i < sample_count; i += 1)
+	{
+		for (c = 0; c < reverb->reverb_channels; c += 1)
+		{
+			/* Room filter */
+			reverb->late_block[c][i] = DspBiQuad_Process(
+				&reverb->channel[c].room_high_shelf,
+				reverb->late_block[c][i]
+			);
+
+			/* PositionMatrixLeft/Right */
+			reverb->late_block[c][i] *= reverb->channel[c].gain;
+		}
+	}
 }
 
 /* Reverb Process Functions */
@@ -938,30 +1106,31 @@ static inline float DspReverb_INTERNAL_Process_1_to_1(
 	size_t sample_count
 ) {
 	const float *in_end = samples_in + sample_count;
-	float in, early, late, out;
+	const float *late = reverb->late_block[0];
+	float out;
 	float squared_sum = 0.0f;
+	uint32_t i, block;
 
 	while (samples_in < in_end)
 	{
-		/* Input */
-		in = *samples_in++;
+		block = (uint32_t) FAudio_min(in_end - samples_in, REVERB_BLOCK_SIZE);
 
-		/* Early Reflections */
-		early = DspReverb_INTERNAL_ProcessEarly(reverb, in);
+		/* Input */
+		FAudio_memcpy(reverb->in_block, samples_in, block * sizeof(float));
 
-		/* Reverberation */
-		late = DspReverb_INTERNAL_ProcessChannel(
-			reverb,
-			&reverb->channel[0],
-			early
-		);
+		/* Early Reflections and Reverberation */
+		DspReverb_INTERNAL_ProcessBlock(reverb, block);
 
-		/* Wet/Dry Mix */
-		out = (late * reverb->wet_ratio) + (in * reverb->dry_ratio);
-		squared_sum += out * out;
+		for (i = 0; i < block; i += 1)
+		{
+			/* Wet/Dry Mix */
+			out = (late[i] * reverb->wet_ratio) + (reverb->in_block[i] * reverb->dry_ratio);
+			squared_sum += out * out;
 
-		/* Output */
-		*samples_out++ = out;
+			/* Output */
+			*samples_out++ = out;
+		}
+		samples_in += block;
 	}
 
 	return squared_sum;
@@ -974,37 +1143,41 @@ static inline float DspReverb_INTERNAL_Process_1_to_5p1(
 	size_t sample_count
 ) {
 	const float *in_end = samples_in + sample_count;
-	float in, in_ratio, early, late[4];
+	float in_ratio, late[4];
 	float squared_sum = 0.0f;
+	uint32_t i, block;
 	int32_t c;
 
 	while (samples_in < in_end)
 	{
+		block = (uint32_t) FAudio_min(in_end - samples_in, REVERB_BLOCK_SIZE);
+
 		/* Input */
-		in = *samples_in++;
-		in_ratio = in * reverb->dry_ratio;
+		FAudio_memcpy(reverb->in_block, samples_in, block * sizeof(float));
+		samples_in += block;
 
-		/* Early Reflections */
-		early = DspReverb_INTERNAL_ProcessEarly(reverb, in);
+		/* Early Reflections and Reverberation */
+		DspReverb_INTERNAL_ProcessBlock(reverb, block);
 
-		/* Reverberation with Wet/Dry Mix */
-		for (c = 0; c < 4; c += 1)
+		for (i = 0; i < block; i += 1)
 		{
-			late[c] = (DspReverb_INTERNAL_ProcessChannel(
-				reverb,
-				&reverb->channel[c],
-				early
-			) * reverb->wet_ratio) + in_ratio;
-			squared_sum += late[c] * late[c];
-		}
+			in_ratio = reverb->in_block[i] * reverb->dry_ratio;
+
+			/* Wet/Dry Mix */
+			for (c = 0; c < 4; c += 1)
+			{
+				late[c] = (reverb->late_block[c][i] * reverb->wet_ratio) + in_ratio;
+				squared_sum += late[c] * late[c];
+			}
 
-		/* Output */
-		*samples_out++ = late[0];	/* Front Left */
-		*samples_out++ = late[1];	/* Front Right */
-		*samples_out++ = 0.0f;		/* Center */
-		*samples_out++ = 0.0f;		/* LFE */
-		*samples_out++ = late[2];	/* Rear Left */
-		*samples_out++ = late[3];	/* Rear Right */
+			/* Output */
+			*samples_out++ = late[0];	/* Front Left */
+			*samples_out++ = late[1];	/* Front Right */
+			*samples_out++ = 0.0f;		/* Center */
+			*samples_out++ = 0.0f;		/* LFE */
+			*samples_out++ = late[2];	/* Rear Left */
+			*samples_out++ = late[3];	/* Rear Right */
+		}
 	}
 
 	return squared_sum;
@@ -1017,35 +1190,36 @@ static inline float DspReverb_INTERNAL_Process_2_to_2(
 	size_t sample_count
 ) {
 	const float *in_end = samples_in + sample_count;
-	float in, early, late[2];
+	float late[2];
 	float squared_sum = 0;
+	uint32_t i, block;
 
 	while (samples_in < in_end)
 	{
+		block = (uint32_t) FAudio_min((in_end - samples_in) / 2, REVERB_BLOCK_SIZE);
+
 		/* Input - Combine 2 channels into 1 */
-		in = (samples_in[0] + samples_in[1]) / 2.0f;
+		for (i = 0; i < block; i += 1)
+		{
+			reverb->in_block[i] = (samples_in[i * 2] + samples_in[i * 2 + 1]) / 2.0f;
+		}
 
-		/* Early Reflections */
-		early = DspReverb_INTERNAL_ProcessEarly(reverb, in);
+		/* Early Reflections and Reverberation */
+		DspReverb_INTERNAL_ProcessBlock(reverb, block);
 
-		/* Reverberation with Wet/Dry Mix */
-		late[0] = (DspReverb_INTERNAL_ProcessChannel(
-			reverb,
-			&reverb->channel[0],
-			early
-		) * reverb->wet_ratio) + samples_in[0] * reverb->dry_ratio;
-		late[1] = (DspReverb_INTERNAL_ProcessChannel(
-			reverb,
-			&reverb->channel[1],
-			early
-		) * reverb->wet_ratio) + samples_in[1] * reverb->dry_ratio;
-		squared_sum += (late[0] * late[0]) + (late[1] * late[1]);
+		for (i = 0; i < block; i += 1)
+		{
+			/* Wet/Dry Mix */
+			late[0] = (reverb->late_block[0][i] * reverb->wet_ratio) + samples_in[0] * reverb->dry_ratio;
+			late[1] = (reverb->late_block[1][i] * reverb->wet_ratio) + samples_in[1] * reverb->dry_ratio;
+			squared_sum += (late[0] * late[0]) + (late[1] * late[1]);
 
-		/* Output */
-		*samples_out++ = late[0];
-		*samples_out++ = late[1];
+			/* Output */
+			*samples_out++ = late[0];
+			*samples_out++ = late[1];
 
-		samples_in += 2;
+			samples_in += 2;
+		}
 	}
 
 	return squared_sum;
@@ -1058,38 +1232,44 @@ static inline float DspReverb_INTERNAL_Process_2_to_5p1(
 	size_t sample_count
 ) {
 	const float *in_end = samples_in + sample_count;
-	float in, in_ratio, early, late[4];
+	float in_ratio, late[4];
 	float squared_sum = 0;
+	uint32_t i, block;
 	int32_t c;
 
 	while (samples_in < in_end)
 	{
+		block = (uint32_t) FAudio_min((in_end - samples_in) / 2, REVERB_BLOCK_SIZE);
+
 		/* Input - Combine 2 channels into 1 */
-		in = (samples_in[0] + samples_in[1]) / 2.0f;
-		in_ratio = in * reverb->dry_ratio;
-		samples_in += 2;
+		for (i = 0; i < block; i += 1)
+		{
+			reverb->in_block[i] = (samples_in[0] + samples_in[1]) / 2.0f;
+			samples_in += 2;
+		}
 
-		/* Early Reflections */
-		early = DspReverb_INTERNAL_ProcessEarly(reverb, in);
+		/* Early Reflections and Reverberation */
+		DspReverb_INTERNAL_ProcessBlock(reverb, block);
 
-		/* Reverberation with Wet/Dry Mix */
-		for (c = 0; c < 4; c += 1)
+		for (i = 0; i < block; i += 1)
 		{
-			late[c] = (DspReverb_INTERNAL_ProcessChannel(
-				reverb,
-				&reverb->channel[c],
-				early
-			) * reverb->wet_ratio) + in_ratio;
-			squared_sum += late[c] * late[c];
-		}
+			in_ratio = reverb->in_block[i] * reverb->dry_ratio;
 
-		/* Output */
-		*samples_out++ = late[0];	/* Front Left */
-		*samples_out++ = late[1];	/* Front Right */
-		*samples_out++ = 0.0f;		/* Center */
-		*samples_out++ = 0.0f;		/* LFE */
-		*samples_out++ = late[2];	/* Rear Left */
-		*samples_out++ = late[3];	/* Rear Right */
+			/* Wet/Dry Mix */
+			for (c = 0; c < 4; c += 1)
+			{
+				late[c] = (reverb->late_block[c][i] * reverb->wet_ratio) + in_ratio;
+				squared_sum += late[c] * late[c];
+			}
+
+			/* Output */
+			*samples_out++ = late[0];	/* Front Left */
+			*samples_out++ = late[1];	/* Front Right */
+			*samples_out++ = 0.0f;		/* Center */
+			*samples_out++ = 0.0f;		/* LFE */
+			*samples_out++ = late[2];	/* Rear Left */
+			*samples_out++ = late[3];	/* Rear Right */
+		}
 	}
 
 	return squared_sum;
@@ -1102,40 +1282,47 @@ static inline float DspReverb_INTERNAL_Process_5p1_to_5p1(
 	size_t sample_count
 ) {
 	const float *in_end = samples_in + sample_count;
-	float in, in_ratio, early, late[5];
+	float in_ratio, late[5];
 	float squared_sum = 0;
+	uint32_t i, block;
 	int32_t c;
 
 	while (samples_in < in_end)
 	{
+		block = (uint32_t) FAudio_min((in_end - samples_in) / 6, REVERB_BLOCK_SIZE);
+
 		/* Input - Combine non-LFE channels into 1 */
-		in = (samples_in[0] + samples_in[1] + samples_in[2] +
-				samples_in[4] + samples_in[5]) / 5.0f;
-		in_ratio = in * reverb->dry_ratio;
+		for (i = 0; i < block; i += 1)
+		{
+			reverb->in_block[i] = (samples_in[i * 6 + 0] + samples_in[i * 6 + 1] +
+					samples_in[i * 6 + 2] + samples_in[i * 6 + 4] +
+					samples_in[i * 6 + 5]) / 5.0f;
+		}
 
-		/* Early Reflections */
-		early = DspReverb_INTERNAL_ProcessEarly(reverb, in);
+		/* Early Reflections and Reverberation */
+		DspReverb_INTERNAL_ProcessBlock(reverb, block);
 
-		/* Reverberation with Wet/Dry Mix */
-		for (c = 0; c < 5; c += 1)
+		for (i = 0; i < block; i += 1)
 		{
-			late[c] = (DspReverb_INTERNAL_ProcessChannel(
-				reverb,
-				&reverb->channel[c],
-				early
-			) * reverb->wet_ratio) + in_ratio;
-			squared_sum += late[c] * late[c];
-		}
+			in_ratio = reverb->in_block[i] * reverb->dry_ratio;
 
-		/* Output */
-		*samples_out++ = late[0];	/* Front Left */
-		*samples_out++ = late[1];	/* Front Right */
-		*samples_out++ = late[2];	/* Center */
-		*samples_out++ = samples_in[3];	/* LFE, pass through */
-		*samples_out++ = late[3];	/* Rear Left */
-		*samples_out++ = late[4];	/* Rear Right */
+			/* Wet/Dry Mix */
+			for (c = 0; c < 5; c += 1)
+			{
+				late[c] = (reverb->late_block[c][i] * reverb->wet_ratio) + in_ratio;
+				squared_sum += late[c] * late[c];
+			}
 
-		samples_in += 6;
+			/* Output */
+			*samples_out++ = late[0];	/* Front Left */
+			*samples_out++ = late[1];	/* Front Right */
+			*samples_out++ = late[2];	/* Center */
+			*samples_out++ = samples_in[3];	/* LFE, pass through */
+			*samples_out++ = late[3];	/* Rear Left */
+			*samples_out++ = late[4];	/* Rear Right */
+
+			samples_in += 6;
+		}
 	}
 
 	return squared_sum;
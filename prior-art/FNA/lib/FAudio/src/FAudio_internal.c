@@ -107,6 +107,8 @@ static const char *get_wformattag_string(const FAudioWaveFormatEx *fmt)
 	FMT_STRING(WMAUDIO2)
 	FMT_STRING(WMAUDIO3)
 	FMT_STRING(EXTENSIBLE)
+	FMT_STRING(VORBIS_EXT)
+	FMT_STRING(QOA_EXT)
 #undef FMT_STRING
 	return "UNKNOWN!";
 }
@@ -161,6 +163,122 @@ void FAudio_INTERNAL_debug_fmt(
 		get_subformat_string(fmt)
 	);
 }
+
+static void FAudio_INTERNAL_CollectTiming(
+	FAudioQuantumTimingEXT *timing,
+	FAudioMixContext *ctx
+) {
+	uint32_t i;
+	for (i = 0; i < FAUDIO_TIMING_STAGE_COUNT_EXT; i += 1)
+	{
+		timing->StageNS[i] += ctx->timingStage[i];
+		ctx->timingStage[i] = 0;
+	}
+	if (ctx->timingSlowestNS > timing->SlowestVoiceNS)
+	{
+		timing->SlowestVoiceNS = ctx->timingSlowestNS;
+		timing->SlowestVoice = ctx->timingSlowestVoice;
+	}
+	ctx->timingSlowestNS = 0;
+	ctx->timingSlowestVoice = NULL;
+}
+
+void FAudio_INTERNAL_BeginQuantumTiming(FAudio *audio)
+{
+	/* Latched for the whole update, so stages never see a partial one */
+	audio->timingQuantum += 1;
+	audio->mixContext.timingEnabled = (
+		(audio->debug.TraceMask & FAUDIO_LOG_TIMING) != 0
+	);
+	if (audio->mixContext.timingEnabled)
+	{
+		audio->mixContext.timingStart[FAUDIO_TIMING_TOTAL] = FAudio_timens();
+	}
+}
+
+void FAudio_INTERNAL_EndQuantumTiming(FAudio *audio)
+{
+	FAudioQuantumTimingEXT timing;
+	uint32_t i, read, write;
+	uint64_t budget;
+
+	if (!audio->mixContext.timingEnabled)
+	{
+		return;
+	}
+
+	FAudio_zero(&timing, sizeof(timing));
+	timing.Quantum = audio->timingQuantum;
+	timing.TotalNS = (
+		FAudio_timens() -
+		audio->mixContext.timingStart[FAUDIO_TIMING_TOTAL]
+	);
+
+	/* Stages are CPU time, so sum every thread that worked on this one */
+	FAudio_INTERNAL_CollectTiming(&timing, &audio->mixContext);
+	for (i = 0; i < audio->mixWorkerCount; i += 1)
+	{
+		FAudio_INTERNAL_CollectTiming(
+			&timing,
+			&audio->mixWorkers[i].context
+		);
+	}
+
+	/* Single producer, so only the reader can move under us */
+	write = (uint32_t) FAudio_PlatformAtomicGet(&audio->timingWrite);
+	read = (uint32_t) FAudio_PlatformAtomicGet(&audio->timingRead);
+	if (write - read >= FAUDIO_TIMING_RING_SIZE)
+	{
+		audio->timingDropped += 1;
+	}
+	else
+	{
+		timing.DroppedQuanta = audio->timingDropped;
+		audio->timingDropped = 0;
+		FAudio_memcpy(
+			&audio->timingRing[write % FAUDIO_TIMING_RING_SIZE],
+			&timing,
+			sizeof(timing)
+		);
+		FAudio_PlatformAtomicSet(&audio->timingWrite, (int32_t) (write + 1));
+	}
+
+	budget = (
+		(uint64_t) audio->updateSize * 1000000000 /
+		audio->master->master.inputSampleRate
+	);
+	if (timing.TotalNS > budget)
+	{
+		PRINT_DEBUG(
+			audio,
+			TIMING,
+			"TIMING",
+			"Quantum %llu took %lluns, budget is %lluns",
+			(unsigned long long) timing.Quantum,
+			(unsigned long long) timing.TotalNS,
+			(unsigned long long) budget
+		)
+	}
+}
+
+void FAudio_INTERNAL_TimeVoice(FAudioVoice *voice, FAudioMixContext *ctx)
+{
+	uint64_t elapsed = FAudio_timens() - ctx->timingStart[FAUDIO_TIMING_VOICE];
+
+	voice->timing.TotalNS += elapsed;
+	voice->timing.LastNS = elapsed;
+	if (elapsed > voice->timing.PeakNS)
+	{
+		voice->timing.PeakNS = elapsed;
+	}
+	voice->timing.Quanta += 1;
+
+	if (elapsed > ctx->timingSlowestNS)
+	{
+		ctx->timingSlowestNS = elapsed;
+		ctx->timingSlowestVoice = voice;
+	}
+}
 #endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
 
 void LinkedList_AddEntry(
@@ -295,187 +413,777 @@ void FAudio_INTERNAL_InsertSubmixSorted(
 	FAudio_PlatformUnlockMutex(lock);
 }
 
-static uint32_t FAudio_INTERNAL_GetBytesRequested(
-	FAudioSourceVoice *voice,
-	uint32_t decoding
-) {
-	uint32_t end, result;
-	FAudioBuffer *buffer;
-	FAudioWaveFormatExtensible *fmt;
-	FAudioBufferEntry *list = voice->src.bufferList;
+/* Source Buffer Queue */
 
-	LOG_FUNC_ENTER(voice->audio)
+void FAudio_INTERNAL_InitBufferQueue(FAudioBufferQueue *queue)
+{
+	uint32_t i;
 
-#ifdef HAVE_WMADEC
-	if (voice->src.wmadec != NULL)
+	FAudio_zero(queue, sizeof(FAudioBufferQueue));
+	for (i = 0; i < FAUDIO_MAX_QUEUED_BUFFERS; i += 1)
 	{
-		/* Always 0, per the spec */
-		LOG_FUNC_EXIT(voice->audio)
-		return 0;
+		queue->freeEntries[i] = &queue->entries[i];
 	}
-#endif /* HAVE_WMADEC */
-	while (list != NULL && decoding > 0)
+	queue->freeWrite.value = FAUDIO_MAX_QUEUED_BUFFERS;
+}
+
+/* Application side, call these with src.bufferLock held */
+
+FAudioBufferEntry* FAudio_INTERNAL_AcquireBufferEntry(FAudioBufferQueue *queue)
+{
+	uint32_t read = (uint32_t) FAudio_PlatformAtomicGet(&queue->freeRead);
+	uint32_t write = (uint32_t) FAudio_PlatformAtomicGet(&queue->freeWrite);
+	uint32_t commandRead = (uint32_t) FAudio_PlatformAtomicGet(&queue->commandRead);
+	uint32_t commandWrite = (uint32_t) FAudio_PlatformAtomicGet(&queue->commandWrite);
+	FAudioBufferEntry *entry;
+
+	/* The submission needs a command slot too, check that first so we
+	 * never take an entry we can't hand over to the mixer
+	 */
+	if (	read == write ||
+		(commandWrite - commandRead) == FAUDIO_BUFFER_QUEUE_COMMANDS	)
 	{
-		buffer = &list->buffer;
-		if (buffer->LoopCount > 0)
-		{
-			end = (
-				/* Current loop... */
-				((buffer->LoopBegin + buffer->LoopLength) - voice->src.curBufferOffset) +
-				/* Remaining loops... */
-				(buffer->LoopLength * buffer->LoopCount - 1) +
-				/* ... Final iteration */
-				buffer->PlayLength
-			);
-		}
-		else
-		{
-			end = (buffer->PlayBegin + buffer->PlayLength) - voice->src.curBufferOffset;
-		}
-		if (end > decoding)
-		{
-			decoding = 0;
-			break;
-		}
-		decoding -= end;
-		list = list->next;
+		return NULL;
 	}
 
-	/* Convert samples to bytes, factoring block alignment */
-	if (voice->src.format->wFormatTag == FAUDIO_FORMAT_MSADPCM)
+	entry = queue->freeEntries[read % FAUDIO_MAX_QUEUED_BUFFERS];
+	FAudio_PlatformAtomicSet(&queue->freeRead, (int32_t) (read + 1));
+	return entry;
+}
+
+uint8_t FAudio_INTERNAL_PushBufferCommand(
+	FAudioBufferQueue *queue,
+	FAudioBufferCommandType type,
+	FAudioBufferEntry *entry
+) {
+	uint32_t read = (uint32_t) FAudio_PlatformAtomicGet(&queue->commandRead);
+	uint32_t write = (uint32_t) FAudio_PlatformAtomicGet(&queue->commandWrite);
+	FAudioBufferCommand *command;
+
+	/* Repeating a command the mixer hasn't seen yet does nothing new */
+	if (	type != FAUDIO_BUFFER_COMMAND_SUBMIT &&
+		write != read &&
+		(int32_t) (queue->lastCommand - read) >= 0 &&
+		queue->lastCommandType == type	)
 	{
-		fmt = (FAudioWaveFormatExtensible*) voice->src.format;
-		result = (
-			(decoding / fmt->Samples.wSamplesPerBlock) +
-			((decoding % fmt->Samples.wSamplesPerBlock) > 0)
-		) * voice->src.format->nBlockAlign;
+		return 1;
 	}
-	else
+
+	if ((write - read) == FAUDIO_BUFFER_QUEUE_COMMANDS)
 	{
-		result = decoding * voice->src.format->nBlockAlign;
+		return 0;
 	}
 
-	LOG_FUNC_EXIT(voice->audio)
-	return result;
+	command = &queue->commands[write % FAUDIO_BUFFER_QUEUE_COMMANDS];
+	command->type = type;
+	command->entry = entry;
+	queue->lastCommand = write;
+	queue->lastCommandType = type;
+	if (type == FAUDIO_BUFFER_COMMAND_SUBMIT)
+	{
+		queue->submitted += 1;
+	}
+
+	/* Publishes the command contents along with the new write index */
+	FAudio_PlatformAtomicSet(&queue->commandWrite, (int32_t) (write + 1));
+	return 1;
 }
 
-static void FAudio_INTERNAL_DecodeBuffers(
-	FAudioSourceVoice *voice,
-	uint64_t *toDecode
-) {
-	uint32_t end, endRead, decoding, decoded = 0;
-	FAudioBuffer *buffer = &voice->src.bufferList->buffer;
-	FAudioBufferEntry *toDelete;
+uint32_t FAudio_INTERNAL_BuffersQueued(FAudioBufferQueue *queue)
+{
+	/* Flushed buffers count until the mixer has sent OnBufferEnd */
+	return queue->submitted - (uint32_t) FAudio_PlatformAtomicGet(&queue->retired);
+}
 
-	LOG_FUNC_ENTER(voice->audio)
+/* Decoded MSADPCM/Vorbis/QOA cache, application side */
 
-	/* This should never go past the max ratio size */
-	FAudio_assert(*toDecode <= voice->src.decodeSamples);
+#define ADPCM_CACHE_BUCKET(data) \
+	((((size_t) (data)) >> 4) % FAUDIO_ADPCM_CACHE_BUCKETS)
 
-	while (decoded < *toDecode && buffer != NULL)
+static uint64_t FAudio_INTERNAL_HashADPCM(const uint8_t *data, uint32_t len)
+{
+	/* This runs for every submission, but it's a lot cheaper than decoding,
+	 * and it keeps buffers that get refilled in place from hitting stale PCM
+	 */
+	uint64_t hash = 0xCBF29CE484222325ULL ^ len;
+	uint64_t word;
+	uint32_t i;
+
+	for (i = 0; (i + sizeof(word)) <= len; i += sizeof(word))
 	{
-		decoding = (uint32_t) *toDecode - decoded;
+		FAudio_memcpy(&word, data + i, sizeof(word));
+		hash = (hash ^ word) * 0x100000001B3ULL;
+		hash ^= hash >> 32;
+	}
+	for (; i < len; i += 1)
+	{
+		hash = (hash ^ data[i]) * 0x100000001B3ULL;
+	}
+	return hash;
+}
 
-		/* Start-of-buffer behavior */
-		if (voice->src.newBuffer)
-		{
-			voice->src.newBuffer = 0;
-			if (	voice->src.callback != NULL &&
-				voice->src.callback->OnBufferStart != NULL	)
-			{
-				FAudio_PlatformUnlockMutex(voice->src.bufferLock);
-				LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
+static void FAudio_INTERNAL_UnlinkADPCMCacheLRU(
+	FAudio *audio,
+	FAudioADPCMCacheEntry *entry
+) {
+	if (entry->lruPrev != NULL)
+	{
+		entry->lruPrev->lruNext = entry->lruNext;
+	}
+	else
+	{
+		audio->adpcmCacheHead = entry->lruNext;
+	}
+	if (entry->lruNext != NULL)
+	{
+		entry->lruNext->lruPrev = entry->lruPrev;
+	}
+	else
+	{
+		audio->adpcmCacheTail = entry->lruPrev;
+	}
+}
 
-				FAudio_PlatformUnlockMutex(voice->sendLock);
-				LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
+static void FAudio_INTERNAL_EvictADPCMCacheEntry(
+	FAudio *audio,
+	FAudioADPCMCacheEntry *entry
+) {
+	FAudioADPCMCacheEntry **bucket;
 
-				FAudio_PlatformUnlockMutex(voice->audio->sourceLock);
-				LOG_MUTEX_UNLOCK(voice->audio, voice->audio->sourceLock)
+	bucket = &audio->adpcmCacheBuckets[ADPCM_CACHE_BUCKET(entry->pAudioData)];
+	while (*bucket != entry)
+	{
+		bucket = &(*bucket)->hashNext;
+	}
+	*bucket = entry->hashNext;
 
-				voice->src.callback->OnBufferStart(
-					voice->src.callback,
-					buffer->pContext
-				);
+	FAudio_INTERNAL_UnlinkADPCMCacheLRU(audio, entry);
 
-				FAudio_PlatformLockMutex(voice->audio->sourceLock);
-				LOG_MUTEX_LOCK(voice->audio, voice->audio->sourceLock)
+	audio->adpcmCacheStats.UsedBytes -= entry->size;
+	audio->adpcmCacheStats.Entries -= 1;
+	audio->pFree(entry);
+}
 
-				FAudio_PlatformLockMutex(voice->sendLock);
-				LOG_MUTEX_LOCK(voice->audio, voice->sendLock)
+/* Call with adpcmCacheLock held */
+void FAudio_INTERNAL_TrimADPCMCache(FAudio *audio)
+{
+	FAudioADPCMCacheEntry *entry, *prev;
 
-				FAudio_PlatformLockMutex(voice->src.bufferLock);
-				LOG_MUTEX_LOCK(voice->audio, voice->src.bufferLock)
-			}
+	/* Pinned entries stay, they get another chance when they're unpinned */
+	entry = audio->adpcmCacheTail;
+	while (	entry != NULL &&
+		audio->adpcmCacheStats.UsedBytes > audio->adpcmCacheBudget	)
+	{
+		prev = entry->lruPrev;
+		if (FAudio_PlatformAtomicGet(&entry->pins) == 0)
+		{
+			FAudio_INTERNAL_EvictADPCMCacheEntry(audio, entry);
+			audio->adpcmCacheStats.Evictions += 1;
 		}
+		entry = prev;
+	}
+}
 
-		/* Check for end-of-buffer */
-		end = (buffer->LoopCount > 0) ?
-			(buffer->LoopBegin + buffer->LoopLength) :
-			buffer->PlayBegin + buffer->PlayLength;
-		endRead = FAudio_min(
-			end - voice->src.curBufferOffset,
-			decoding
-		);
-
-		/* Decode... */
-		voice->src.decode(
-			voice,
-			buffer,
-			voice->audio->decodeCache + (
-				decoded * voice->src.format->nChannels
-			),
-			endRead
-		);
+void FAudio_INTERNAL_ClearADPCMCache(FAudio *audio)
+{
+	while (audio->adpcmCacheHead != NULL)
+	{
+		FAudio_INTERNAL_EvictADPCMCacheEntry(audio, audio->adpcmCacheHead);
+	}
+}
 
-		LOG_INFO(
-			voice->audio,
-			"Voice %p, buffer %p, decoded %u samples from [%u,%u)",
-			(void*) voice,
-			(void*) buffer,
-			endRead,
-			voice->src.curBufferOffset,
-			voice->src.curBufferOffset + endRead
-		)
+/* Call with adpcmCacheLock held */
+static FAudioADPCMCacheEntry* FAudio_INTERNAL_FindADPCMCacheEntry(
+	FAudio *audio,
+	const FAudioADPCMCacheEntry *key
+) {
+	FAudioADPCMCacheEntry *cached, *next;
 
-		decoded += endRead;
-		voice->src.curBufferOffset += endRead;
-		voice->src.totalSamples += endRead;
+	cached = audio->adpcmCacheBuckets[ADPCM_CACHE_BUCKET(key->pAudioData)];
+	for (; cached != NULL; cached = next)
+	{
+		next = cached->hashNext;
+		if (cached->pAudioData != key->pAudioData)
+		{
+			continue;
+		}
+		if (	cached->AudioBytes == key->AudioBytes &&
+			cached->formatTag == key->formatTag &&
+			cached->blockAlign == key->blockAlign &&
+			cached->channels == key->channels &&
+			cached->hash == key->hash	)
+		{
+			return cached;
+		}
 
-		/* End-of-buffer behavior */
-		if (endRead < decoding)
+		/* Same memory, new contents, nothing can hit this again */
+		if (FAudio_PlatformAtomicGet(&cached->pins) == 0)
 		{
-			if (buffer->LoopCount > 0)
-			{
-				voice->src.curBufferOffset = buffer->LoopBegin;
-				if (buffer->LoopCount < FAUDIO_LOOP_INFINITE)
-				{
-					buffer->LoopCount -= 1;
-				}
-				if (	voice->src.callback != NULL &&
-					voice->src.callback->OnLoopEnd != NULL	)
-				{
-					FAudio_PlatformUnlockMutex(voice->src.bufferLock);
-					LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
+			FAudio_INTERNAL_EvictADPCMCacheEntry(audio, cached);
+			audio->adpcmCacheStats.Evictions += 1;
+		}
+	}
+	return NULL;
+}
 
-					FAudio_PlatformUnlockMutex(voice->sendLock);
-					LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
+/* Call these with src.bufferLock held */
 
-					FAudio_PlatformUnlockMutex(voice->audio->sourceLock);
-					LOG_MUTEX_UNLOCK(voice->audio, voice->audio->sourceLock)
+void FAudio_INTERNAL_PinADPCMCache(
+	FAudioSourceVoice *voice,
+	FAudioBufferEntry *entry
+) {
+	FAudio *audio = voice->audio;
+	const FAudioBuffer *buffer = &entry->buffer;
+	FAudioADPCMCacheEntry key, *cached, *decoded = NULL, **bucket;
+	uint32_t blocks = 0, budget;
+	uint64_t size = 0;
+
+	FAudio_zero(&key, sizeof(key));
+	key.pAudioData = buffer->pAudioData;
+	key.AudioBytes = buffer->AudioBytes;
+	key.formatTag = voice->src.format->wFormatTag;
+	key.blockAlign = voice->src.format->nBlockAlign;
+	key.channels = voice->src.format->nChannels;
+
+	if (key.formatTag == FAUDIO_FORMAT_MSADPCM)
+	{
+		/* AudioBytes was already rounded down to whole blocks */
+		blocks = buffer->AudioBytes / key.blockAlign;
+		size = (
+			(uint64_t) blocks *
+			((FAudioADPCMWaveFormat*) voice->src.format)->wSamplesPerBlock *
+			key.channels *
+			sizeof(int16_t)
+		);
+	}
+#ifndef DISABLE_XNASONG
+	else
+	{
+		/* The whole file, decoded with the decoder opened at submission */
+		size = (uint64_t) entry->compressed->length * key.channels * (
+			(key.formatTag == FAUDIO_FORMAT_VORBIS_EXT) ?
+				sizeof(float) :
+				sizeof(int16_t)
+		);
+	}
+#endif /* DISABLE_XNASONG */
 
-					voice->src.callback->OnLoopEnd(
-						voice->src.callback,
-						buffer->pContext
-					);
+	FAudio_PlatformLockMutex(audio->adpcmCacheLock);
+	LOG_MUTEX_LOCK(audio, audio->adpcmCacheLock)
+	budget = audio->adpcmCacheBudget;
+	FAudio_PlatformUnlockMutex(audio->adpcmCacheLock);
+	LOG_MUTEX_UNLOCK(audio, audio->adpcmCacheLock)
+	if (size == 0 || size > budget)
+	{
+		return;
+	}
 
+	/* Hashing and decoding take as long as the buffer is big, so neither
+	 * happens under the lock, which every other voice's submission needs
+	 */
+	key.hash = FAudio_INTERNAL_HashADPCM(buffer->pAudioData, buffer->AudioBytes);
+
+	FAudio_PlatformLockMutex(audio->adpcmCacheLock);
+	LOG_MUTEX_LOCK(audio, audio->adpcmCacheLock)
+	cached = FAudio_INTERNAL_FindADPCMCacheEntry(audio, &key);
+	if (cached == NULL)
+	{
+		FAudio_PlatformUnlockMutex(audio->adpcmCacheLock);
+		LOG_MUTEX_UNLOCK(audio, audio->adpcmCacheLock)
+
+		/* The PCM goes right after the entry */
+		decoded = (FAudioADPCMCacheEntry*) audio->pMalloc(
+			sizeof(FAudioADPCMCacheEntry) + (size_t) size
+		);
+		if (decoded == NULL)
+		{
+			/* The mixer can still decode it as it plays */
+			return;
+		}
+		FAudio_memcpy(decoded, &key, sizeof(key));
+		decoded->size = (uint32_t) size;
+		decoded->pcm = decoded + 1;
+		FAudio_PlatformAtomicSet(&decoded->pins, 0);
+		if (key.formatTag == FAUDIO_FORMAT_MSADPCM)
+		{
+			FAudio_INTERNAL_DecodeMSADPCMBlocks(
+				buffer->pAudioData,
+				(int16_t*) decoded->pcm,
+				blocks,
+				key.blockAlign,
+				key.channels
+			);
+		}
+#ifndef DISABLE_XNASONG
+		else
+		{
+			FAudio_INTERNAL_DecodeCompressedEntire(
+				entry->compressed,
+				decoded->pcm
+			);
+		}
+#endif /* DISABLE_XNASONG */
+
+		/* Someone else may have decoded the same buffer in the meantime */
+		FAudio_PlatformLockMutex(audio->adpcmCacheLock);
+		LOG_MUTEX_LOCK(audio, audio->adpcmCacheLock)
+		cached = FAudio_INTERNAL_FindADPCMCacheEntry(audio, &key);
+	}
+
+	if (cached != NULL)
+	{
+		/* Pull it out of the LRU list, it goes back in at the front */
+		FAudio_INTERNAL_UnlinkADPCMCacheLRU(audio, cached);
+		if (decoded == NULL)
+		{
+			audio->adpcmCacheStats.Hits += 1;
+		}
+		else
+		{
+			audio->adpcmCacheStats.Misses += 1;
+			audio->pFree(decoded);
+		}
+	}
+	else
+	{
+		audio->adpcmCacheStats.Misses += 1;
+		cached = decoded;
+		bucket = &audio->adpcmCacheBuckets[ADPCM_CACHE_BUCKET(key.pAudioData)];
+		cached->hashNext = *bucket;
+		*bucket = cached;
+		audio->adpcmCacheStats.UsedBytes += (uint32_t) size;
+		audio->adpcmCacheStats.Entries += 1;
+	}
+
+	cached->lruPrev = NULL;
+	cached->lruNext = audio->adpcmCacheHead;
+	if (audio->adpcmCacheHead != NULL)
+	{
+		audio->adpcmCacheHead->lruPrev = cached;
+	}
+	else
+	{
+		audio->adpcmCacheTail = cached;
+	}
+	audio->adpcmCacheHead = cached;
+
+	/* Dropped by the mixer when it retires the buffer */
+	FAudio_PlatformAtomicAdd(&cached->pins, 1);
+	entry->adpcm = cached;
+
+	FAudio_INTERNAL_TrimADPCMCache(audio);
+	FAudio_PlatformUnlockMutex(audio->adpcmCacheLock);
+	LOG_MUTEX_UNLOCK(audio, audio->adpcmCacheLock)
+
+#ifndef DISABLE_XNASONG
+	/* The mixer only needs the PCM now */
+	if (entry->compressed != NULL)
+	{
+		FAudio_INTERNAL_CloseCompressed(audio, entry->compressed);
+		entry->compressed = NULL;
+	}
+#endif /* DISABLE_XNASONG */
+}
+
+void FAudio_INTERNAL_UnpinADPCMCache(FAudioSourceVoice *voice)
+{
+	FAudioBufferQueue *queue = voice->src.queue;
+	uint32_t i;
+
+	/* Buffers the mixer never retired still hold their pins */
+	FAudio_PlatformLockMutex(voice->audio->adpcmCacheLock);
+	LOG_MUTEX_LOCK(voice->audio, voice->audio->adpcmCacheLock)
+	for (i = 0; i < FAUDIO_MAX_QUEUED_BUFFERS; i += 1)
+	{
+		if (queue->entries[i].adpcm != NULL)
+		{
+			FAudio_PlatformAtomicAdd(&queue->entries[i].adpcm->pins, -1);
+			queue->entries[i].adpcm = NULL;
+		}
+	}
+	FAudio_INTERNAL_TrimADPCMCache(voice->audio);
+	FAudio_PlatformUnlockMutex(voice->audio->adpcmCacheLock);
+	LOG_MUTEX_UNLOCK(voice->audio, voice->audio->adpcmCacheLock)
+}
+
+#undef ADPCM_CACHE_BUCKET
+
+#ifndef DISABLE_XNASONG
+void FAudio_INTERNAL_CloseCompressedEntries(
+	FAudioSourceVoice *voice,
+	uint8_t retiredOnly
+) {
+	FAudioBufferQueue *queue = voice->src.queue;
+	FAudioBufferEntry *entry;
+	uint32_t i, read, write;
+
+	if (retiredOnly)
+	{
+		read = (uint32_t) FAudio_PlatformAtomicGet(&queue->freeRead);
+		write = (uint32_t) FAudio_PlatformAtomicGet(&queue->freeWrite);
+	}
+	else
+	{
+		read = 0;
+		write = FAUDIO_MAX_QUEUED_BUFFERS;
+	}
+	for (i = read; i != write; i += 1)
+	{
+		entry = retiredOnly ?
+			queue->freeEntries[i % FAUDIO_MAX_QUEUED_BUFFERS] :
+			&queue->entries[i];
+		if (entry->compressed != NULL)
+		{
+			FAudio_INTERNAL_CloseCompressed(voice->audio, entry->compressed);
+			entry->compressed = NULL;
+		}
+	}
+}
+#endif /* DISABLE_XNASONG */
+
+/* Mixer side */
+
+static void FAudio_INTERNAL_RetireBuffer(
+	FAudioSourceVoice *voice,
+	FAudioBufferEntry *entry
+) {
+	FAudioBufferQueue *queue = voice->src.queue;
+	uint32_t write = (uint32_t) FAudio_PlatformAtomicGet(&queue->freeWrite);
+
+	/* Callers copy what they need out of the entry first, the application
+	 * may reuse it as soon as it's back in the free ring
+	 */
+	if (voice->src.adpcmBlocksEntry == entry)
+	{
+		voice->src.adpcmBlocksEntry = NULL;
+	}
+
+	/* ADPCMCacheEXT, the PCM is evictable again once nothing plays it */
+	if (entry->adpcm != NULL)
+	{
+		FAudio_PlatformAtomicAdd(&entry->adpcm->pins, -1);
+		entry->adpcm = NULL;
+	}
+	queue->freeEntries[write % FAUDIO_MAX_QUEUED_BUFFERS] = entry;
+	FAudio_PlatformAtomicSet(&queue->freeWrite, (int32_t) (write + 1));
+	FAudio_PlatformAtomicSet(
+		&queue->retired,
+		FAudio_PlatformAtomicGet(&queue->retired) + 1
+	);
+}
+
+static void FAudio_INTERNAL_PublishCurrentBuffer(FAudioSourceVoice *voice)
+{
+	FAudio_PlatformAtomicSetPtr(
+		&voice->src.queue->currentContext,
+		(voice->src.bufferList != NULL && !voice->src.newBuffer) ?
+			voice->src.bufferList->buffer.pContext :
+			NULL
+	);
+}
+
+static void FAudio_INTERNAL_FlushBufferList(
+	FAudioSourceVoice *voice,
+	uint8_t keepActive
+) {
+	FAudioBufferEntry *entry, *latest;
+
+	/* If the source is playing, don't flush the active buffer */
+	entry = voice->src.bufferList;
+	if (keepActive && entry != NULL && !voice->src.newBuffer)
+	{
+		entry = entry->next;
+		voice->src.bufferList->next = NULL;
+	}
+	else
+	{
+		voice->src.curBufferOffset = 0;
+		voice->src.bufferList = NULL;
+		voice->src.newBuffer = 0;
+		if (voice->src.sincHistory != NULL)
+		{
+			FAudio_zero(
+				voice->src.sincHistory,
+				sizeof(float) *
+				FAUDIO_SINC_HISTORY *
+				voice->src.format->nChannels
+			);
+		}
+	}
+
+	/* Move them to the pending flush list */
+	if (entry != NULL)
+	{
+		if (voice->src.flushList == NULL)
+		{
+			voice->src.flushList = entry;
+		}
+		else
+		{
+			latest = voice->src.flushList;
+			while (latest->next != NULL)
+			{
+				latest = latest->next;
+			}
+			latest->next = entry;
+		}
+	}
+}
+
+void FAudio_INTERNAL_DrainBufferQueue(FAudioSourceVoice *voice)
+{
+	FAudioBufferQueue *queue = voice->src.queue;
+	uint32_t read = (uint32_t) FAudio_PlatformAtomicGet(&queue->commandRead);
+	uint32_t write = (uint32_t) FAudio_PlatformAtomicGet(&queue->commandWrite);
+	FAudioBufferCommand *command;
+	FAudioBufferEntry *list;
+
+	if (read == write)
+	{
+		return;
+	}
+
+	LOG_FUNC_ENTER(voice->audio)
+	while (read != write)
+	{
+		command = &queue->commands[read % FAUDIO_BUFFER_QUEUE_COMMANDS];
+		switch (command->type)
+		{
+		case FAUDIO_BUFFER_COMMAND_SUBMIT:
+			command->entry->next = NULL;
+			if (voice->src.bufferList == NULL)
+			{
+				voice->src.bufferList = command->entry;
+				voice->src.curBufferOffset = command->entry->buffer.PlayBegin;
+				voice->src.newBuffer = 1;
+			}
+			else
+			{
+				list = voice->src.bufferList;
+				while (list->next != NULL)
+				{
+					list = list->next;
+				}
+				list->next = command->entry;
+			}
+			break;
+		case FAUDIO_BUFFER_COMMAND_FLUSH_PENDING:
+			FAudio_INTERNAL_FlushBufferList(voice, 1);
+			break;
+		case FAUDIO_BUFFER_COMMAND_FLUSH_ALL:
+			FAudio_INTERNAL_FlushBufferList(voice, 0);
+			break;
+		case FAUDIO_BUFFER_COMMAND_DISCONTINUITY:
+			if (voice->src.bufferList != NULL)
+			{
+				for (list = voice->src.bufferList; list->next != NULL; list = list->next);
+				list->buffer.Flags |= FAUDIO_END_OF_STREAM;
+			}
+			break;
+		case FAUDIO_BUFFER_COMMAND_EXITLOOP:
+			if (voice->src.bufferList != NULL)
+			{
+				voice->src.bufferList->buffer.LoopCount = 0;
+			}
+			break;
+		default:
+			FAudio_assert(0 && "Unrecognized buffer command!");
+			break;
+		}
+		read += 1;
+	}
+
+	/* Hands the command slots back to the application */
+	FAudio_PlatformAtomicSet(&queue->commandRead, (int32_t) read);
+	FAudio_INTERNAL_PublishCurrentBuffer(voice);
+	LOG_FUNC_EXIT(voice->audio)
+}
+
+static uint32_t FAudio_INTERNAL_GetBytesRequested(
+	FAudioSourceVoice *voice,
+	uint32_t decoding
+) {
+	uint32_t end, result;
+	FAudioBuffer *buffer;
+	FAudioWaveFormatExtensible *fmt;
+	FAudioBufferEntry *list = voice->src.bufferList;
+
+	LOG_FUNC_ENTER(voice->audio)
+
+#ifdef HAVE_WMADEC
+	if (voice->src.wmadec != NULL)
+	{
+		/* Always 0, per the spec */
+		LOG_FUNC_EXIT(voice->audio)
+		return 0;
+	}
+#endif /* HAVE_WMADEC */
+	while (list != NULL && decoding > 0)
+	{
+		buffer = &list->buffer;
+		if (buffer->LoopCount > 0)
+		{
+			end = (
+				/* Current loop... */
+				((buffer->LoopBegin + buffer->LoopLength) - voice->src.curBufferOffset) +
+				/* Remaining loops... */
+				(buffer->LoopLength * buffer->LoopCount - 1) +
+				/* ... Final iteration */
+				buffer->PlayLength
+			);
+		}
+		else
+		{
+			end = (buffer->PlayBegin + buffer->PlayLength) - voice->src.curBufferOffset;
+		}
+		if (end > decoding)
+		{
+			decoding = 0;
+			break;
+		}
+		decoding -= end;
+		list = list->next;
+	}
+
+	/* Convert samples to bytes, factoring block alignment */
+	if (voice->src.format->wFormatTag == FAUDIO_FORMAT_MSADPCM)
+	{
+		fmt = (FAudioWaveFormatExtensible*) voice->src.format;
+		result = (
+			(decoding / fmt->Samples.wSamplesPerBlock) +
+			((decoding % fmt->Samples.wSamplesPerBlock) > 0)
+		) * voice->src.format->nBlockAlign;
+	}
+	else
+	{
+		result = decoding * voice->src.format->nBlockAlign;
+	}
+
+	LOG_FUNC_EXIT(voice->audio)
+	return result;
+}
+
+static void FAudio_INTERNAL_DecodeBuffers(
+	FAudioSourceVoice *voice,
+	FAudioMixContext *ctx,
+	uint64_t *toDecode
+) {
+	uint32_t end, endRead, decoding, decoded = 0;
+	FAudioBuffer *buffer = &voice->src.bufferList->buffer;
+	FAudioBufferEntry *toDelete;
+	void *toDeleteContext;
+	uint32_t toDeleteFlags;
+
+	LOG_FUNC_ENTER(voice->audio)
+
+	/* This should never go past the max ratio size */
+	FAudio_assert(*toDecode <= voice->src.decodeSamples);
+
+	while (decoded < *toDecode && buffer != NULL)
+	{
+		decoding = (uint32_t) *toDecode - decoded;
+
+		/* Start-of-buffer behavior */
+		if (voice->src.newBuffer)
+		{
+			voice->src.newBuffer = 0;
+			FAudio_INTERNAL_PublishCurrentBuffer(voice);
+			if (	voice->src.callback != NULL &&
+				voice->src.callback->OnBufferStart != NULL	)
+			{
+				FAudio_PlatformUnlockMutex(voice->sendLock);
+				LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
+
+				if (ctx->holdsSourceLock)
+				{
+					FAudio_PlatformUnlockMutex(voice->audio->sourceLock);
+					LOG_MUTEX_UNLOCK(voice->audio, voice->audio->sourceLock)
+				}
+
+				voice->src.callback->OnBufferStart(
+					voice->src.callback,
+					buffer->pContext
+				);
+
+				if (ctx->holdsSourceLock)
+				{
 					FAudio_PlatformLockMutex(voice->audio->sourceLock);
 					LOG_MUTEX_LOCK(voice->audio, voice->audio->sourceLock)
+				}
+
+				FAudio_PlatformLockMutex(voice->sendLock);
+				LOG_MUTEX_LOCK(voice->audio, voice->sendLock)
+			}
+		}
+
+		/* Check for end-of-buffer */
+		end = (buffer->LoopCount > 0) ?
+			(buffer->LoopBegin + buffer->LoopLength) :
+			buffer->PlayBegin + buffer->PlayLength;
+		endRead = FAudio_min(
+			end - voice->src.curBufferOffset,
+			decoding
+		);
+
+		/* Decode... */
+		voice->src.decode(
+			voice,
+			buffer,
+			ctx->decodeCache + (
+				decoded * voice->src.format->nChannels
+			),
+			endRead
+		);
+
+		LOG_INFO(
+			voice->audio,
+			"Voice %p, buffer %p, decoded %u samples from [%u,%u)",
+			(void*) voice,
+			(void*) buffer,
+			endRead,
+			voice->src.curBufferOffset,
+			voice->src.curBufferOffset + endRead
+		)
+
+		decoded += endRead;
+		voice->src.curBufferOffset += endRead;
+		voice->src.totalSamples += endRead;
+
+		/* End-of-buffer behavior */
+		if (endRead < decoding)
+		{
+			if (buffer->LoopCount > 0)
+			{
+				voice->src.curBufferOffset = buffer->LoopBegin;
+				if (buffer->LoopCount < FAUDIO_LOOP_INFINITE)
+				{
+					buffer->LoopCount -= 1;
+				}
+				if (	voice->src.callback != NULL &&
+					voice->src.callback->OnLoopEnd != NULL	)
+				{
+					FAudio_PlatformUnlockMutex(voice->sendLock);
+					LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
+
+					if (ctx->holdsSourceLock)
+					{
+						FAudio_PlatformUnlockMutex(voice->audio->sourceLock);
+						LOG_MUTEX_UNLOCK(voice->audio, voice->audio->sourceLock)
+					}
+
+					voice->src.callback->OnLoopEnd(
+						voice->src.callback,
+						buffer->pContext
+					);
+
+					if (ctx->holdsSourceLock)
+					{
+						FAudio_PlatformLockMutex(voice->audio->sourceLock);
+						LOG_MUTEX_LOCK(voice->audio, voice->audio->sourceLock)
+					}
 
 					FAudio_PlatformLockMutex(voice->sendLock);
 					LOG_MUTEX_LOCK(voice->audio, voice->sendLock)
-
-					FAudio_PlatformLockMutex(voice->src.bufferLock);
-					LOG_MUTEX_LOCK(voice->audio, voice->src.bufferLock)
 				}
 			}
 			else
@@ -500,9 +1208,13 @@ static void FAudio_INTERNAL_DecodeBuffers(
 					(void*) buffer
 				)
 
-				/* Change active buffer, delete finished buffer */
+				/* Change active buffer, retire finished buffer */
 				toDelete = voice->src.bufferList;
+				toDeleteContext = toDelete->buffer.pContext;
+				toDeleteFlags = toDelete->buffer.Flags;
 				voice->src.bufferList = voice->src.bufferList->next;
+				FAudio_INTERNAL_RetireBuffer(voice, toDelete);
+				FAudio_INTERNAL_PublishCurrentBuffer(voice);
 				if (voice->src.bufferList != NULL)
 				{
 					buffer = &voice->src.bufferList->buffer;
@@ -514,7 +1226,7 @@ static void FAudio_INTERNAL_DecodeBuffers(
 
 					/* FIXME: I keep going past the buffer so fuck it */
 					FAudio_zero(
-						voice->audio->decodeCache + (
+						ctx->decodeCache + (
 							decoded *
 							voice->src.format->nChannels
 						),
@@ -528,23 +1240,23 @@ static void FAudio_INTERNAL_DecodeBuffers(
 				/* Callbacks */
 				if (voice->src.callback != NULL)
 				{
-					FAudio_PlatformUnlockMutex(voice->src.bufferLock);
-					LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
-
 					FAudio_PlatformUnlockMutex(voice->sendLock);
 					LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
 
-					FAudio_PlatformUnlockMutex(voice->audio->sourceLock);
-					LOG_MUTEX_UNLOCK(voice->audio, voice->audio->sourceLock)
+					if (ctx->holdsSourceLock)
+					{
+						FAudio_PlatformUnlockMutex(voice->audio->sourceLock);
+						LOG_MUTEX_UNLOCK(voice->audio, voice->audio->sourceLock)
+					}
 
 					if (voice->src.callback->OnBufferEnd != NULL)
 					{
 						voice->src.callback->OnBufferEnd(
 							voice->src.callback,
-							toDelete->buffer.pContext
+							toDeleteContext
 						);
 					}
-					if (	toDelete->buffer.Flags & FAUDIO_END_OF_STREAM &&
+					if (	toDeleteFlags & FAUDIO_END_OF_STREAM &&
 						voice->src.callback->OnStreamEnd != NULL	)
 					{
 						voice->src.callback->OnStreamEnd(
@@ -552,16 +1264,17 @@ static void FAudio_INTERNAL_DecodeBuffers(
 						);
 					}
 
-					FAudio_PlatformLockMutex(voice->audio->sourceLock);
-					LOG_MUTEX_LOCK(voice->audio, voice->audio->sourceLock)
+					if (ctx->holdsSourceLock)
+					{
+						FAudio_PlatformLockMutex(voice->audio->sourceLock);
+						LOG_MUTEX_LOCK(voice->audio, voice->audio->sourceLock)
+					}
 
 					FAudio_PlatformLockMutex(voice->sendLock);
 					LOG_MUTEX_LOCK(voice->audio, voice->sendLock)
 
-					FAudio_PlatformLockMutex(voice->src.bufferLock);
-					LOG_MUTEX_LOCK(voice->audio, voice->src.bufferLock)
-
 					/* One last chance at redemption */
+					FAudio_INTERNAL_DrainBufferQueue(voice);
 					if (buffer == NULL && voice->src.bufferList != NULL)
 					{
 						buffer = &voice->src.bufferList->buffer;
@@ -570,32 +1283,30 @@ static void FAudio_INTERNAL_DecodeBuffers(
 
 					if (buffer != NULL && voice->src.callback->OnBufferStart != NULL)
 					{
-						FAudio_PlatformUnlockMutex(voice->src.bufferLock);
-						LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
-
 						FAudio_PlatformUnlockMutex(voice->sendLock);
 						LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
 
-						FAudio_PlatformUnlockMutex(voice->audio->sourceLock);
-						LOG_MUTEX_UNLOCK(voice->audio, voice->audio->sourceLock)
+						if (ctx->holdsSourceLock)
+						{
+							FAudio_PlatformUnlockMutex(voice->audio->sourceLock);
+							LOG_MUTEX_UNLOCK(voice->audio, voice->audio->sourceLock)
+						}
 
 						voice->src.callback->OnBufferStart(
 							voice->src.callback,
 							buffer->pContext
 						);
 
-						FAudio_PlatformLockMutex(voice->audio->sourceLock);
-						LOG_MUTEX_LOCK(voice->audio, voice->audio->sourceLock)
+						if (ctx->holdsSourceLock)
+						{
+							FAudio_PlatformLockMutex(voice->audio->sourceLock);
+							LOG_MUTEX_LOCK(voice->audio, voice->audio->sourceLock)
+						}
 
 						FAudio_PlatformLockMutex(voice->sendLock);
 						LOG_MUTEX_LOCK(voice->audio, voice->sendLock)
-
-						FAudio_PlatformLockMutex(voice->src.bufferLock);
-						LOG_MUTEX_LOCK(voice->audio, voice->src.bufferLock)
 					}
 				}
-
-				voice->audio->pFree(toDelete);
 			}
 		}
 	}
@@ -614,7 +1325,7 @@ static void FAudio_INTERNAL_DecodeBuffers(
 		voice->src.decode(
 			voice,
 			buffer,
-			voice->audio->decodeCache + (
+			ctx->decodeCache + (
 				decoded * voice->src.format->nChannels
 			),
 			endRead
@@ -624,7 +1335,7 @@ static void FAudio_INTERNAL_DecodeBuffers(
 		if (endRead < EXTRA_DECODE_PADDING)
 		{
 			FAudio_zero(
-				voice->audio->decodeCache + (
+				ctx->decodeCache + (
 					decoded * voice->src.format->nChannels
 				),
 				sizeof(float) * (
@@ -637,7 +1348,7 @@ static void FAudio_INTERNAL_DecodeBuffers(
 	else
 	{
 		FAudio_zero(
-			voice->audio->decodeCache + (
+			ctx->decodeCache + (
 				decoded * voice->src.format->nChannels
 			),
 			sizeof(float) * (
@@ -691,15 +1402,18 @@ static inline void FAudio_INTERNAL_FilterVoice(
 	LOG_FUNC_EXIT(audio)
 }
 
-static void FAudio_INTERNAL_ResizeEffectChainCache(FAudio *audio, uint32_t samples)
-{
+static void FAudio_INTERNAL_ResizeEffectChainCache(
+	FAudio *audio,
+	FAudioMixContext *ctx,
+	uint32_t samples
+) {
 	LOG_FUNC_ENTER(audio)
-	if (samples > audio->effectChainSamples)
+	if (samples > ctx->effectChainSamples)
 	{
-		audio->effectChainSamples = samples;
-		audio->effectChainCache = (float*) audio->pRealloc(
-			audio->effectChainCache,
-			sizeof(float) * audio->effectChainSamples
+		ctx->effectChainSamples = samples;
+		ctx->effectChainCache = (float*) audio->pRealloc(
+			ctx->effectChainCache,
+			sizeof(float) * ctx->effectChainSamples
 		);
 	}
 	LOG_FUNC_EXIT(audio)
@@ -707,6 +1421,7 @@ static void FAudio_INTERNAL_ResizeEffectChainCache(FAudio *audio, uint32_t sampl
 
 static inline float *FAudio_INTERNAL_ProcessEffectChain(
 	FAudioVoice *voice,
+	FAudioMixContext *ctx,
 	float *buffer,
 	uint32_t *samples
 ) {
@@ -745,9 +1460,10 @@ static inline float *FAudio_INTERNAL_ProcessEffectChain(
 			{
 				FAudio_INTERNAL_ResizeEffectChainCache(
 					voice->audio,
+					ctx,
 					voice->effects.desc[i].OutputChannels * srcParams.ValidFrameCount
 				);
-				dstParams.pBuffer = voice->audio->effectChainCache;
+				dstParams.pBuffer = ctx->effectChainCache;
 			}
 			else
 			{
@@ -794,22 +1510,267 @@ static inline float *FAudio_INTERNAL_ProcessEffectChain(
 	return (float*) dstParams.pBuffer;
 }
 
-static void FAudio_INTERNAL_ResizeResampleCache(FAudio *audio, uint32_t samples)
-{
-       LOG_FUNC_ENTER(audio)
-       if (samples > audio->resampleSamples)
-       {
-               audio->resampleSamples = samples;
-               audio->resampleCache = (float*) audio->pRealloc(
-                       audio->resampleCache,
-                       sizeof(float) * audio->resampleSamples
-               );
-       }
-       LOG_FUNC_EXIT(audio)
-}
-
-static void FAudio_INTERNAL_MixSource(FAudioSourceVoice *voice)
-{
+static void FAudio_INTERNAL_ResizeResampleCache(
+	FAudio *audio,
+	FAudioMixContext *ctx,
+	uint32_t samples
+) {
+	LOG_FUNC_ENTER(audio)
+	if (samples > ctx->resampleSamples)
+	{
+		ctx->resampleSamples = samples;
+		ctx->resampleCache = (float*) audio->pRealloc(
+			ctx->resampleCache,
+			sizeof(float) * ctx->resampleSamples
+		);
+	}
+	LOG_FUNC_EXIT(audio)
+}
+
+static void FAudio_INTERNAL_ResizeSincCache(
+	FAudio *audio,
+	FAudioMixContext *ctx,
+	uint32_t samples
+) {
+	LOG_FUNC_ENTER(audio)
+	if (samples > ctx->sincSamples)
+	{
+		ctx->sincSamples = samples;
+		ctx->sincCache = (float*) audio->pRealloc(
+			ctx->sincCache,
+			sizeof(float) * ctx->sincSamples
+		);
+	}
+	LOG_FUNC_EXIT(audio)
+}
+
+static void FAudio_INTERNAL_ResizeDecodeCache(
+	FAudio *audio,
+	FAudioMixContext *ctx,
+	uint32_t samples
+) {
+	LOG_FUNC_ENTER(audio)
+	if (samples > ctx->decodeSamples)
+	{
+		ctx->decodeSamples = samples;
+		ctx->decodeCache = (float*) audio->pRealloc(
+			ctx->decodeCache,
+			sizeof(float) * ctx->decodeSamples
+		);
+	}
+	LOG_FUNC_EXIT(audio)
+}
+
+static void FAudio_INTERNAL_ResizeSendCache(
+	FAudio *audio,
+	FAudioMixContext *ctx,
+	uint32_t samples
+) {
+	LOG_FUNC_ENTER(audio)
+	if (samples > ctx->sendSamples)
+	{
+		ctx->sendSamples = samples;
+		ctx->sendCache = (float*) audio->pRealloc(
+			ctx->sendCache,
+			sizeof(float) * ctx->sendSamples
+		);
+	}
+	LOG_FUNC_EXIT(audio)
+}
+
+/* FAUDIO_VOICE_SINC_EXT resampling. The filter runs FAUDIO_SINC_DELAY frames
+ * behind the decode position, so the frames before the decode window come from
+ * the voice's history, and the end of a stream is flushed out of the filter
+ * with silence. Returns the resampled output, *toResample frames of it.
+ */
+static float *FAudio_INTERNAL_ResampleSinc(
+	FAudioSourceVoice *voice,
+	FAudioMixContext *ctx,
+	uint64_t decoded,
+	uint64_t *toResample
+) {
+	uint32_t channels = voice->src.format->nChannels;
+	uint32_t historySize = FAUDIO_SINC_HISTORY * channels * sizeof(float);
+	uint64_t offset = voice->src.curBufferOffsetDec;
+	uint64_t next;
+	float *window, *result;
+
+	FAudio_INTERNAL_ResizeSincCache(
+		voice->audio,
+		ctx,
+		(
+			FAUDIO_SINC_HISTORY +
+			voice->src.decodeSamples +
+			EXTRA_DECODE_PADDING +
+			FAUDIO_SINC_DELAY
+		) * channels
+	);
+	window = ctx->sincCache + (FAUDIO_SINC_HISTORY * channels);
+	FAudio_memcpy(ctx->sincCache, voice->src.sincHistory, historySize);
+	FAudio_memcpy(
+		window,
+		ctx->decodeCache,
+		(decoded + EXTRA_DECODE_PADDING) * channels * sizeof(float)
+	);
+
+	if (voice->src.bufferList == NULL)
+	{
+		/* Out of buffers, play what's left in the filter */
+		FAudio_zero(
+			window + (decoded * channels),
+			(FAUDIO_SINC_DELAY + EXTRA_DECODE_PADDING) * channels * sizeof(float)
+		);
+		*toResample = (
+			((decoded + FAUDIO_SINC_DELAY) << FIXED_PRECISION) -
+			offset +
+			FIXED_FRACTION_MASK
+		) / voice->src.resampleStep;
+		*toResample = FAudio_min(*toResample, voice->src.resampleSamples);
+	}
+
+	if (	voice->src.resampleStep == FIXED_ONE &&
+		offset == 0	)
+	{
+		/* Nothing to interpolate, just delay the input */
+		result = window - (FAUDIO_SINC_DELAY * channels);
+	}
+	else
+	{
+		FAudio_INTERNAL_ResizeResampleCache(
+			voice->audio,
+			ctx,
+			voice->src.resampleSamples * channels
+		);
+		voice->src.resample(
+			window,
+			ctx->resampleCache,
+			&offset,
+			voice->src.resampleStep,
+			*toResample,
+			(uint8_t) channels
+		);
+		result = ctx->resampleCache;
+	}
+
+	/* The next window starts at the frame the last output stepped into */
+	if (voice->src.bufferList == NULL)
+	{
+		FAudio_zero(voice->src.sincHistory, historySize);
+	}
+	else
+	{
+		next = (
+			voice->src.curBufferOffsetDec +
+			*toResample * voice->src.resampleStep
+		) >> FIXED_PRECISION;
+		FAudio_memcpy(
+			voice->src.sincHistory,
+			ctx->sincCache + (next * channels),
+			historySize
+		);
+	}
+	return result;
+}
+
+static inline float *FAudio_INTERNAL_GetPartialStream(
+	FAudio *audio,
+	FAudioMixContext *ctx,
+	FAudioVoice *out
+) {
+	uint32_t index;
+	float *stream;
+
+	index = (out->type == FAUDIO_VOICE_MASTER) ? 0 : out->mix.partialIndex;
+	stream = ctx->partialCache + audio->mixPartialOffsets[index];
+
+	/* Partial mixes are only cleared when a worker first writes to them */
+	if (!ctx->partialUsed[index])
+	{
+		FAudio_zero(
+			stream,
+			sizeof(float) * (
+				audio->mixPartialOffsets[index + 1] -
+				audio->mixPartialOffsets[index]
+			)
+		);
+		ctx->partialUsed[index] = 1;
+	}
+	return stream;
+}
+
+static inline void FAudio_INTERNAL_MixSend(
+	FAudioVoice *voice,
+	uint32_t send,
+	uint32_t samples,
+	uint32_t oChan,
+	float *restrict srcData,
+	float *restrict dstData
+) {
+	if (voice->sendPlans[send].sparse)
+	{
+		FAudio_INTERNAL_Mix_Sparse(
+			samples,
+			voice->outputChannels,
+			oChan,
+			srcData,
+			dstData,
+			&voice->sendPlans[send]
+		);
+	}
+	else
+	{
+		voice->sendMix[send](
+			samples,
+			voice->outputChannels,
+			oChan,
+			srcData,
+			dstData,
+			voice->mixCoefficients[send]
+		);
+	}
+}
+
+static void FAudio_INTERNAL_MixFilteredSend(
+	FAudioSourceVoice *voice,
+	FAudioMixContext *ctx,
+	uint32_t send,
+	uint32_t samples,
+	uint32_t oChan,
+	float *restrict srcData,
+	float *restrict dstData
+) {
+	uint32_t i, total = samples * oChan;
+
+	FAudio_INTERNAL_ResizeSendCache(voice->audio, ctx, total);
+	FAudio_zero(ctx->sendCache, sizeof(float) * total);
+
+	FAudio_INTERNAL_MixSend(
+		voice,
+		send,
+		samples,
+		oChan,
+		srcData,
+		ctx->sendCache
+	);
+	FAudio_INTERNAL_FilterVoice(
+		voice->audio,
+		&voice->sendFilter[send],
+		voice->sendFilterState[send],
+		ctx->sendCache,
+		samples,
+		oChan
+	);
+
+	for (i = 0; i < total; i += 1)
+	{
+		dstData[i] += ctx->sendCache[i];
+	}
+}
+
+static void FAudio_INTERNAL_MixSource(
+	FAudioSourceVoice *voice,
+	FAudioMixContext *ctx
+) {
 	/* Iterators */
 	uint32_t i;
 	/* Decode/Resample variables */
@@ -851,15 +1812,16 @@ static void FAudio_INTERNAL_MixSource(FAudioSourceVoice *voice)
 	{
 		/* We're just playing tails, skip all buffer stuff */
 		FAudio_INTERNAL_ResizeResampleCache(
-				voice->audio,
-				voice->src.resampleSamples * voice->src.format->nChannels
+			voice->audio,
+			ctx,
+			voice->src.resampleSamples * voice->src.format->nChannels
 		);
 		mixed = voice->src.resampleSamples;
 		FAudio_zero(
-			voice->audio->resampleCache,
+			ctx->resampleCache,
 			mixed * voice->src.format->nChannels * sizeof(float)
 		);
-		finalSamples = voice->audio->resampleCache;
+		finalSamples = ctx->resampleCache;
 		goto sendwork;
 	}
 
@@ -877,51 +1839,58 @@ static void FAudio_INTERNAL_MixSource(FAudioSourceVoice *voice)
 		FAudio_PlatformUnlockMutex(voice->sendLock);
 		LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
 
-		FAudio_PlatformUnlockMutex(voice->audio->sourceLock);
-		LOG_MUTEX_UNLOCK(voice->audio, voice->audio->sourceLock)
+		if (ctx->holdsSourceLock)
+		{
+			FAudio_PlatformUnlockMutex(voice->audio->sourceLock);
+			LOG_MUTEX_UNLOCK(voice->audio, voice->audio->sourceLock)
+		}
 
 		voice->src.callback->OnVoiceProcessingPassStart(
 			voice->src.callback,
 			FAudio_INTERNAL_GetBytesRequested(voice, (uint32_t) toDecode)
 		);
 
-		FAudio_PlatformLockMutex(voice->audio->sourceLock);
-		LOG_MUTEX_LOCK(voice->audio, voice->audio->sourceLock)
+		if (ctx->holdsSourceLock)
+		{
+			FAudio_PlatformLockMutex(voice->audio->sourceLock);
+			LOG_MUTEX_LOCK(voice->audio, voice->audio->sourceLock)
+		}
 
 		FAudio_PlatformLockMutex(voice->sendLock);
 		LOG_MUTEX_LOCK(voice->audio, voice->sendLock)
-	}
 
-	FAudio_PlatformLockMutex(voice->src.bufferLock);
-	LOG_MUTEX_LOCK(voice->audio, voice->src.bufferLock)
+		/* Streaming clients like to submit from this callback */
+		FAudio_INTERNAL_DrainBufferQueue(voice);
+	}
 
 	/* Nothing to do? */
 	if (voice->src.bufferList == NULL)
 	{
-		FAudio_PlatformUnlockMutex(voice->src.bufferLock);
-		LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
-
 		if (voice->effects.count > 0 && voice->effects.state != FAPO_BUFFER_SILENT)
 		{
 			/* do not stop while the effect chain generates a non-silent buffer */
 			FAudio_INTERNAL_ResizeResampleCache(
-					voice->audio,
-					voice->src.resampleSamples * voice->src.format->nChannels
+				voice->audio,
+				ctx,
+				voice->src.resampleSamples * voice->src.format->nChannels
 			);
 			mixed = voice->src.resampleSamples;
 			FAudio_zero(
-				voice->audio->resampleCache,
+				ctx->resampleCache,
 				mixed * voice->src.format->nChannels * sizeof(float)
 			);
-			finalSamples = voice->audio->resampleCache;
+			finalSamples = ctx->resampleCache;
 			goto sendwork;
 		}
 
 		FAudio_PlatformUnlockMutex(voice->sendLock);
 		LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
 
-		FAudio_PlatformUnlockMutex(voice->audio->sourceLock);
-		LOG_MUTEX_UNLOCK(voice->audio, voice->audio->sourceLock)
+		if (ctx->holdsSourceLock)
+		{
+			FAudio_PlatformUnlockMutex(voice->audio->sourceLock);
+			LOG_MUTEX_UNLOCK(voice->audio, voice->audio->sourceLock)
+		}
 
 		if (	voice->src.callback != NULL &&
 			voice->src.callback->OnVoiceProcessingPassEnd != NULL)
@@ -931,15 +1900,28 @@ static void FAudio_INTERNAL_MixSource(FAudioSourceVoice *voice)
 			);
 		}
 
-		FAudio_PlatformLockMutex(voice->audio->sourceLock);
-		LOG_MUTEX_LOCK(voice->audio, voice->audio->sourceLock)
+		if (ctx->holdsSourceLock)
+		{
+			FAudio_PlatformLockMutex(voice->audio->sourceLock);
+			LOG_MUTEX_LOCK(voice->audio, voice->audio->sourceLock)
+		}
 
 		LOG_FUNC_EXIT(voice->audio)
 		return;
 	}
 
 	/* Decode... */
-	FAudio_INTERNAL_DecodeBuffers(voice, &toDecode);
+	LOG_TIMING_BEGIN(ctx, FAUDIO_TIMING_STAGE_DECODE_EXT)
+	FAudio_INTERNAL_ResizeDecodeCache(
+		voice->audio,
+		ctx,
+		(
+			voice->src.decodeSamples +
+			EXTRA_DECODE_PADDING
+		) * voice->src.format->nChannels
+	);
+	FAudio_INTERNAL_DecodeBuffers(voice, ctx, &toDecode);
+	LOG_TIMING_END(ctx, FAUDIO_TIMING_STAGE_DECODE_EXT)
 
 	/* Subtract any padding samples from the total, if applicable */
 	if (	voice->src.curBufferOffsetDec > 0 &&
@@ -952,35 +1934,32 @@ static void FAudio_INTERNAL_MixSource(FAudioSourceVoice *voice)
 	if (	voice->src.callback != NULL &&
 		voice->src.callback->OnVoiceProcessingPassEnd != NULL)
 	{
-		FAudio_PlatformUnlockMutex(voice->src.bufferLock);
-		LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
-
 		FAudio_PlatformUnlockMutex(voice->sendLock);
 		LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
 
-		FAudio_PlatformUnlockMutex(voice->audio->sourceLock);
-		LOG_MUTEX_UNLOCK(voice->audio, voice->audio->sourceLock)
+		if (ctx->holdsSourceLock)
+		{
+			FAudio_PlatformUnlockMutex(voice->audio->sourceLock);
+			LOG_MUTEX_UNLOCK(voice->audio, voice->audio->sourceLock)
+		}
 
 		voice->src.callback->OnVoiceProcessingPassEnd(
 			voice->src.callback
 		);
 
-		FAudio_PlatformLockMutex(voice->audio->sourceLock);
-		LOG_MUTEX_LOCK(voice->audio, voice->audio->sourceLock)
+		if (ctx->holdsSourceLock)
+		{
+			FAudio_PlatformLockMutex(voice->audio->sourceLock);
+			LOG_MUTEX_LOCK(voice->audio, voice->audio->sourceLock)
+		}
 
 		FAudio_PlatformLockMutex(voice->sendLock);
 		LOG_MUTEX_LOCK(voice->audio, voice->sendLock)
-
-		FAudio_PlatformLockMutex(voice->src.bufferLock);
-		LOG_MUTEX_LOCK(voice->audio, voice->src.bufferLock)
 	}
 
-	/* Nothing to resample? */
-	if (toDecode == 0)
+	/* Nothing to resample? The sinc filter may still hold a tail, though */
+	if (toDecode == 0 && voice->src.sincHistory == NULL)
 	{
-		FAudio_PlatformUnlockMutex(voice->src.bufferLock);
-		LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
-
 		FAudio_PlatformUnlockMutex(voice->sendLock);
 		LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
 
@@ -1002,26 +1981,40 @@ static void FAudio_INTERNAL_MixSource(FAudioSourceVoice *voice)
 	toResample = FAudio_min(toResample, voice->src.resampleSamples);
 
 	/* Resample... */
-	if (voice->src.resampleStep == FIXED_ONE)
+	if (voice->src.sincHistory != NULL)
+	{
+		LOG_TIMING_BEGIN(ctx, FAUDIO_TIMING_STAGE_RESAMPLE_EXT)
+		finalSamples = FAudio_INTERNAL_ResampleSinc(
+			voice,
+			ctx,
+			toDecode,
+			&toResample
+		);
+		LOG_TIMING_END(ctx, FAUDIO_TIMING_STAGE_RESAMPLE_EXT)
+	}
+	else if (voice->src.resampleStep == FIXED_ONE)
 	{
 		/* Actually, just use the existing buffer... */
-		finalSamples = voice->audio->decodeCache;
+		finalSamples = ctx->decodeCache;
 	}
 	else
 	{
+		LOG_TIMING_BEGIN(ctx, FAUDIO_TIMING_STAGE_RESAMPLE_EXT)
 		FAudio_INTERNAL_ResizeResampleCache(
-				voice->audio,
-				voice->src.resampleSamples * voice->src.format->nChannels
+			voice->audio,
+			ctx,
+			voice->src.resampleSamples * voice->src.format->nChannels
 		);
 		voice->src.resample(
-			voice->audio->decodeCache,
-			voice->audio->resampleCache,
+			ctx->decodeCache,
+			ctx->resampleCache,
 			&voice->src.resampleOffset,
 			voice->src.resampleStep,
 			toResample,
 			(uint8_t) voice->src.format->nChannels
 		);
-		finalSamples = voice->audio->resampleCache;
+		finalSamples = ctx->resampleCache;
+		LOG_TIMING_END(ctx, FAUDIO_TIMING_STAGE_RESAMPLE_EXT)
 	}
 
 	/* Update buffer offsets */
@@ -1048,8 +2041,6 @@ static void FAudio_INTERNAL_MixSource(FAudioSourceVoice *voice)
 	}
 
 	/* Done with buffers, finally. */
-	FAudio_PlatformUnlockMutex(voice->src.bufferLock);
-	LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
 	mixed = (uint32_t) toResample;
 
 sendwork:
@@ -1087,11 +2078,14 @@ sendwork:
 			);
 			mixed = voice->src.resampleSamples;
 		}
+		LOG_TIMING_BEGIN(ctx, FAUDIO_TIMING_STAGE_EFFECT_EXT)
 		finalSamples = FAudio_INTERNAL_ProcessEffectChain(
 			voice,
+			ctx,
 			finalSamples,
 			&mixed
 		);
+		LOG_TIMING_END(ctx, FAUDIO_TIMING_STAGE_EFFECT_EXT)
 	}
 	FAudio_PlatformUnlockMutex(voice->effectLock);
 	LOG_MUTEX_UNLOCK(voice->audio, voice->effectLock)
@@ -1106,30 +2100,70 @@ sendwork:
 	}
 
 	/* Send float cache to sends */
+	LOG_TIMING_BEGIN(ctx, FAUDIO_TIMING_STAGE_MIX_EXT)
 	FAudio_PlatformLockMutex(voice->volumeLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->volumeLock)
 	for (i = 0; i < voice->sends.SendCount; i += 1)
 	{
+		/* Silent sends are skipped, unless a filter may still be ringing */
+		if (	voice->sendPlans[i].taps == 0 &&
+			!(voice->sends.pSends[i].Flags & FAUDIO_SEND_USEFILTER)	)
+		{
+			continue;
+		}
+
 		out = voice->sends.pSends[i].pOutputVoice;
 		if (out->type == FAUDIO_VOICE_MASTER)
 		{
 			stream = out->master.output;
 			oChan = out->master.inputChannels;
 		}
-		else
+		else
+		{
+			stream = out->mix.inputCache;
+			oChan = out->mix.inputChannels;
+		}
+
+		/* Parallel workers write to their own partial mix instead */
+		if (ctx->partialCache != NULL)
+		{
+			stream = FAudio_INTERNAL_GetPartialStream(
+				voice->audio,
+				ctx,
+				out
+			);
+
+			/* Filter this send alone, not the whole partial mix */
+			if (voice->sends.pSends[i].Flags & FAUDIO_SEND_USEFILTER)
+			{
+				FAudio_INTERNAL_MixFilteredSend(
+					voice,
+					ctx,
+					i,
+					mixed,
+					oChan,
+					finalSamples,
+					stream
+				);
+				continue;
+			}
+		}
+		else if (out->type == FAUDIO_VOICE_SUBMIX)
 		{
-			stream = out->mix.inputCache;
-			oChan = out->mix.inputChannels;
+			out->mix.inputActive = 1;
 		}
 
-		voice->sendMix[i](
-			mixed,
-			voice->outputChannels,
-			oChan,
-			finalSamples,
-			stream,
-			voice->mixCoefficients[i]
-		);
+		if (voice->sendPlans[i].taps > 0)
+		{
+			FAudio_INTERNAL_MixSend(
+				voice,
+				i,
+				mixed,
+				oChan,
+				finalSamples,
+				stream
+			);
+		}
 
 		if (voice->sends.pSends[i].Flags & FAUDIO_SEND_USEFILTER)
 		{
@@ -1145,14 +2179,17 @@ sendwork:
 	}
 	FAudio_PlatformUnlockMutex(voice->volumeLock);
 	LOG_MUTEX_UNLOCK(voice->audio, voice->volumeLock)
+	LOG_TIMING_END(ctx, FAUDIO_TIMING_STAGE_MIX_EXT)
 
 	FAudio_PlatformUnlockMutex(voice->sendLock);
 	LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
 	LOG_FUNC_EXIT(voice->audio)
 }
 
-static void FAudio_INTERNAL_MixSubmix(FAudioSubmixVoice *voice)
-{
+static void FAudio_INTERNAL_MixSubmix(
+	FAudioSubmixVoice *voice,
+	FAudioMixContext *ctx
+) {
 	uint32_t i;
 	float *stream;
 	uint32_t oChan;
@@ -1160,11 +2197,44 @@ static void FAudio_INTERNAL_MixSubmix(FAudioSubmixVoice *voice)
 	uint32_t resampled;
 	uint64_t resampleOffset = 0;
 	float *finalSamples;
+	uint8_t silent;
 
 	LOG_FUNC_ENTER(voice->audio)
+	LOG_TIMING_BEGIN(ctx, FAUDIO_TIMING_STAGE_SUBMIX_EXT)
 	FAudio_PlatformLockMutex(voice->sendLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->sendLock)
 
+	/* Nothing was mixed in and nothing is still ringing? Then the output
+	 * is silent too, skip everything so the voices downstream see no input
+	 * from us either.
+	 */
+	silent = (
+		!voice->mix.inputActive &&
+		!(voice->flags & FAUDIO_VOICE_USEFILTER)
+	);
+	for (i = 0; silent && i < voice->sends.SendCount; i += 1)
+	{
+		if (voice->sends.pSends[i].Flags & FAUDIO_SEND_USEFILTER)
+		{
+			silent = 0;
+		}
+	}
+	if (silent)
+	{
+		FAudio_PlatformLockMutex(voice->effectLock);
+		LOG_MUTEX_LOCK(voice->audio, voice->effectLock)
+		silent = (
+			voice->effects.count == 0 ||
+			voice->effects.state == FAPO_BUFFER_SILENT
+		);
+		FAudio_PlatformUnlockMutex(voice->effectLock);
+		LOG_MUTEX_UNLOCK(voice->audio, voice->effectLock)
+	}
+	if (silent)
+	{
+		goto end;
+	}
+
 	/* Resample */
 	if (voice->mix.resampleStep == FIXED_ONE)
 	{
@@ -1174,18 +2244,19 @@ static void FAudio_INTERNAL_MixSubmix(FAudioSubmixVoice *voice)
 	else
 	{
 		FAudio_INTERNAL_ResizeResampleCache(
-				voice->audio,
-				voice->mix.outputSamples * voice->mix.inputChannels
+			voice->audio,
+			ctx,
+			voice->mix.outputSamples * voice->mix.inputChannels
 		);
 		voice->mix.resample(
 			voice->mix.inputCache,
-			voice->audio->resampleCache,
+			ctx->resampleCache,
 			&resampleOffset,
 			voice->mix.resampleStep,
 			voice->mix.outputSamples,
 			(uint8_t) voice->mix.inputChannels
 		);
-		finalSamples = voice->audio->resampleCache;
+		finalSamples = ctx->resampleCache;
 	}
 	resampled = voice->mix.outputSamples * voice->mix.inputChannels;
 
@@ -1224,6 +2295,7 @@ static void FAudio_INTERNAL_MixSubmix(FAudioSubmixVoice *voice)
 	{
 		finalSamples = FAudio_INTERNAL_ProcessEffectChain(
 			voice,
+			ctx,
 			finalSamples,
 			&resampled
 		);
@@ -1242,6 +2314,13 @@ static void FAudio_INTERNAL_MixSubmix(FAudioSubmixVoice *voice)
 	LOG_MUTEX_LOCK(voice->audio, voice->volumeLock)
 	for (i = 0; i < voice->sends.SendCount; i += 1)
 	{
+		/* Silent sends are skipped, unless a filter may still be ringing */
+		if (	voice->sendPlans[i].taps == 0 &&
+			!(voice->sends.pSends[i].Flags & FAUDIO_SEND_USEFILTER)	)
+		{
+			continue;
+		}
+
 		out = voice->sends.pSends[i].pOutputVoice;
 		if (out->type == FAUDIO_VOICE_MASTER)
 		{
@@ -1254,14 +2333,46 @@ static void FAudio_INTERNAL_MixSubmix(FAudioSubmixVoice *voice)
 			oChan = out->mix.inputChannels;
 		}
 
-		voice->sendMix[i](
-			resampled,
-			voice->outputChannels,
-			oChan,
-			finalSamples,
-			stream,
-			voice->mixCoefficients[i]
-		);
+		/* Parallel workers write to their own partial mix instead */
+		if (ctx->partialCache != NULL)
+		{
+			stream = FAudio_INTERNAL_GetPartialStream(
+				voice->audio,
+				ctx,
+				out
+			);
+
+			/* Filter this send alone, not the whole partial mix */
+			if (voice->sends.pSends[i].Flags & FAUDIO_SEND_USEFILTER)
+			{
+				FAudio_INTERNAL_MixFilteredSend(
+					voice,
+					ctx,
+					i,
+					resampled,
+					oChan,
+					finalSamples,
+					stream
+				);
+				continue;
+			}
+		}
+		else if (out->type == FAUDIO_VOICE_SUBMIX)
+		{
+			out->mix.inputActive = 1;
+		}
+
+		if (voice->sendPlans[i].taps > 0)
+		{
+			FAudio_INTERNAL_MixSend(
+				voice,
+				i,
+				resampled,
+				oChan,
+				finalSamples,
+				stream
+			);
+		}
 
 		if (voice->sends.pSends[i].Flags & FAUDIO_SEND_USEFILTER)
 		{
@@ -1282,50 +2393,449 @@ static void FAudio_INTERNAL_MixSubmix(FAudioSubmixVoice *voice)
 end:
 	FAudio_PlatformUnlockMutex(voice->sendLock);
 	LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
-	FAudio_zero(
-		voice->mix.inputCache,
-		sizeof(float) * voice->mix.inputSamples
-	);
+	if (!silent)
+	{
+		FAudio_zero(
+			voice->mix.inputCache,
+			sizeof(float) * voice->mix.inputSamples
+		);
+	}
+	voice->mix.inputActive = 0;
+	LOG_TIMING_END(ctx, FAUDIO_TIMING_STAGE_SUBMIX_EXT)
 	LOG_FUNC_EXIT(voice->audio)
 }
 
-static void FAudio_INTERNAL_FlushPendingBuffers(FAudioSourceVoice *voice)
-{
+static void FAudio_INTERNAL_FlushPendingBuffers(
+	FAudioSourceVoice *voice,
+	FAudioMixContext *ctx
+) {
 	FAudioBufferEntry *entry;
+	void *context;
 
-	FAudio_PlatformLockMutex(voice->src.bufferLock);
-	LOG_MUTEX_LOCK(voice->audio, voice->src.bufferLock)
+	/* Pick up anything the application queued since the last update */
+	FAudio_INTERNAL_DrainBufferQueue(voice);
 
 	/* Remove pending flushed buffers and send an event for each one */
 	while (voice->src.flushList != NULL)
 	{
 		entry = voice->src.flushList;
 		voice->src.flushList = voice->src.flushList->next;
+		context = entry->buffer.pContext;
+		FAudio_INTERNAL_RetireBuffer(voice, entry);
 
 		if (voice->src.callback != NULL && voice->src.callback->OnBufferEnd != NULL)
 		{
-			FAudio_PlatformUnlockMutex(voice->src.bufferLock);
-			LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
-
-			FAudio_PlatformUnlockMutex(voice->audio->sourceLock);
-			LOG_MUTEX_UNLOCK(voice->audio, voice->audio->sourceLock)
+			if (ctx->holdsSourceLock)
+			{
+				FAudio_PlatformUnlockMutex(voice->audio->sourceLock);
+				LOG_MUTEX_UNLOCK(voice->audio, voice->audio->sourceLock)
+			}
 
 			voice->src.callback->OnBufferEnd(
 				voice->src.callback,
-				entry->buffer.pContext
+				context
 			);
 
-			FAudio_PlatformLockMutex(voice->audio->sourceLock);
-			LOG_MUTEX_LOCK(voice->audio, voice->audio->sourceLock)
+			if (ctx->holdsSourceLock)
+			{
+				FAudio_PlatformLockMutex(voice->audio->sourceLock);
+				LOG_MUTEX_LOCK(voice->audio, voice->audio->sourceLock)
+			}
+
+			/* The callback may have flushed even more buffers */
+			FAudio_INTERNAL_DrainBufferQueue(voice);
+		}
+	}
+}
+
+/* Parallel Mixing */
+
+static void FAudio_INTERNAL_ResizePartialCaches(
+	FAudio *audio,
+	FAudioMixContext *ctx,
+	uint32_t partialSamples,
+	uint32_t partialCount
+) {
+	if (ctx->partialSamples < partialSamples)
+	{
+		ctx->partialSamples = partialSamples;
+		ctx->partialCache = (float*) audio->pRealloc(
+			ctx->partialCache,
+			sizeof(float) * ctx->partialSamples
+		);
+	}
+	if (ctx->partialUsedCount < partialCount)
+	{
+		ctx->partialUsedCount = partialCount;
+		ctx->partialUsed = (uint8_t*) audio->pRealloc(
+			ctx->partialUsed,
+			sizeof(uint8_t) * ctx->partialUsedCount
+		);
+	}
+}
+
+/* Source/submix lists, partial mix offsets and submix levels */
+static void FAudio_INTERNAL_ResizeMixGraph(
+	FAudio *audio,
+	uint32_t voiceCount,
+	uint32_t submixCount
+) {
+	voiceCount = FAudio_max(voiceCount, submixCount);
+	if (voiceCount > audio->mixVoiceCapacity)
+	{
+		audio->mixVoiceCapacity = voiceCount;
+		audio->mixVoices = (FAudioVoice**) audio->pRealloc(
+			audio->mixVoices,
+			sizeof(FAudioVoice*) * audio->mixVoiceCapacity
+		);
+	}
+	if (submixCount + 2 > audio->mixPartialCapacity)
+	{
+		audio->mixPartialCapacity = submixCount + 2;
+		audio->mixPartialOffsets = (uint32_t*) audio->pRealloc(
+			audio->mixPartialOffsets,
+			sizeof(uint32_t) * audio->mixPartialCapacity
+		);
+	}
+	if (submixCount > audio->mixSubmixCapacity)
+	{
+		audio->mixSubmixCapacity = submixCount;
+		audio->mixSubmixLevels = (uint32_t*) audio->pRealloc(
+			audio->mixSubmixLevels,
+			sizeof(uint32_t) * audio->mixSubmixCapacity
+		);
+		audio->mixLevelOffsets = (uint32_t*) audio->pRealloc(
+			audio->mixLevelOffsets,
+			sizeof(uint32_t) * (audio->mixSubmixCapacity + 1)
+		);
+	}
+}
+
+static void FAudio_INTERNAL_PrepareMixWorker(
+	FAudio *audio,
+	FAudioMixWorker *worker,
+	uint32_t partialCount
+) {
+	FAudioMixContext *ctx = &worker->context;
+
+	/* FAudio_INTERNAL_ReserveMixCaches has normally done this already */
+	FAudio_INTERNAL_ResizePartialCaches(
+		audio,
+		ctx,
+		audio->mixPartialOffsets[partialCount],
+		partialCount
+	);
+	FAudio_zero(ctx->partialUsed, sizeof(uint8_t) * partialCount);
+
+#ifndef FAUDIO_DISABLE_DEBUGCONFIGURATION
+	ctx->timingEnabled = audio->mixContext.timingEnabled;
+#endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
+}
+
+static void FAudio_INTERNAL_MixWorkerVoices(FAudioMixWorker *worker)
+{
+	uint32_t i;
+	FAudioVoice *voice;
+
+	for (i = 0; i < worker->voiceCount; i += 1)
+	{
+		voice = worker->voices[i];
+		if (voice->type == FAUDIO_VOICE_SUBMIX)
+		{
+			LOG_TIMING_VOICE_BEGIN(&worker->context)
+			FAudio_INTERNAL_MixSubmix(voice, &worker->context);
+			LOG_TIMING_VOICE_END(voice, &worker->context)
+			continue;
+		}
+		FAudio_INTERNAL_FlushPendingBuffers(voice, &worker->context);
+		if (voice->src.active)
+		{
+			LOG_TIMING_VOICE_BEGIN(&worker->context)
+			FAudio_INTERNAL_MixSource(voice, &worker->context);
+			LOG_TIMING_VOICE_END(voice, &worker->context)
+			FAudio_INTERNAL_FlushPendingBuffers(voice, &worker->context);
+		}
+	}
+}
+
+static int32_t FAUDIOCALL FAudio_INTERNAL_MixWorkerThread(void *data)
+{
+	FAudioMixWorker *worker = (FAudioMixWorker*) data;
+
+	FAudio_PlatformThreadPriority(FAUDIO_THREAD_PRIORITY_HIGH);
+	while (1)
+	{
+		FAudio_PlatformWaitSemaphore(worker->wake);
+		if (worker->quit)
+		{
+			break;
+		}
+		FAudio_INTERNAL_MixWorkerVoices(worker);
+		FAudio_PlatformSignalSemaphore(worker->audio->mixWorkersDone);
+	}
+	return 0;
+}
+
+/* Call this with submixLock held, the submix list decides the layout */
+static uint32_t FAudio_INTERNAL_LayoutPartialMixes(FAudio *audio)
+{
+	uint32_t i, partialCount;
+	LinkedList *list;
+	FAudioSubmixVoice *submix;
+
+	/* One partial mix per destination: master first, then each submix */
+	partialCount = 1;
+	list = audio->submixes;
+	while (list != NULL)
+	{
+		partialCount += 1;
+		list = list->next;
+	}
+	FAudio_INTERNAL_ResizeMixGraph(audio, 0, partialCount - 1);
+	audio->mixPartialOffsets[0] = 0;
+	audio->mixPartialOffsets[1] = (
+		audio->updateSize *
+		audio->master->master.inputChannels
+	);
+	i = 1;
+	list = audio->submixes;
+	while (list != NULL)
+	{
+		submix = (FAudioSubmixVoice*) list->entry;
+		submix->mix.partialIndex = i;
+		audio->mixPartialOffsets[i + 1] = (
+			audio->mixPartialOffsets[i] +
+			submix->mix.inputSamples
+		);
+		i += 1;
+		list = list->next;
+	}
+	return partialCount;
+}
+
+static void FAudio_INTERNAL_RunMixWorkers(
+	FAudio *audio,
+	FAudioVoice **voices,
+	uint32_t voiceCount,
+	uint32_t partialCount
+) {
+	uint32_t i, chunk, start, woken;
+	FAudioMixWorker *worker;
+
+	/* Contiguous ranges in list order keep the reduction deterministic */
+	chunk = (voiceCount + audio->mixWorkerCount - 1) / audio->mixWorkerCount;
+	woken = 0;
+	for (i = 0; i < audio->mixWorkerCount; i += 1)
+	{
+		worker = &audio->mixWorkers[i];
+		start = FAudio_min(i * chunk, voiceCount);
+		worker->voices = voices + start;
+		worker->voiceCount = FAudio_min(chunk, voiceCount - start);
+		FAudio_INTERNAL_PrepareMixWorker(audio, worker, partialCount);
+
+		/* Worker 0 is the audio thread itself */
+		if (i > 0 && worker->voiceCount > 0)
+		{
+			FAudio_PlatformSignalSemaphore(worker->wake);
+			woken += 1;
+		}
+	}
+	FAudio_INTERNAL_MixWorkerVoices(&audio->mixWorkers[0]);
+	for (i = 0; i < woken; i += 1)
+	{
+		FAudio_PlatformWaitSemaphore(audio->mixWorkersDone);
+	}
+}
+
+static void FAudio_INTERNAL_ReducePartialMixes(
+	FAudio *audio,
+	uint32_t partialCount
+) {
+	uint32_t i, j, k, partialLen;
+	LinkedList *list;
+	FAudioMixWorker *worker;
+	FAudioSubmixVoice *submix;
+	float *stream, *partial;
+
+	/* Always in worker order, whatever order the workers finished in */
+	list = audio->submixes;
+	for (j = 0; j < partialCount; j += 1)
+	{
+		if (j == 0)
+		{
+			submix = NULL;
+			stream = audio->master->master.output;
+		}
+		else
+		{
+			submix = (FAudioSubmixVoice*) list->entry;
+			stream = submix->mix.inputCache;
+			list = list->next;
+		}
+		partialLen = (
+			audio->mixPartialOffsets[j + 1] -
+			audio->mixPartialOffsets[j]
+		);
+		for (i = 0; i < audio->mixWorkerCount; i += 1)
+		{
+			worker = &audio->mixWorkers[i];
+			if (!worker->context.partialUsed[j])
+			{
+				continue;
+			}
+			if (submix != NULL)
+			{
+				submix->mix.inputActive = 1;
+			}
+			partial = (
+				worker->context.partialCache +
+				audio->mixPartialOffsets[j]
+			);
+			for (k = 0; k < partialLen; k += 1)
+			{
+				stream[k] += partial[k];
+			}
+		}
+	}
+}
+
+static void FAudio_INTERNAL_MixSourcesParallel(FAudio *audio)
+{
+	uint32_t i, voiceCount, partialCount;
+	LinkedList *list;
 
-			FAudio_PlatformLockMutex(voice->src.bufferLock);
-			LOG_MUTEX_LOCK(voice->audio, voice->src.bufferLock)
+	LOG_FUNC_ENTER(audio)
+
+	/* The submix list decides the partial layout, keep it stable */
+	FAudio_PlatformLockMutex(audio->submixLock);
+	LOG_MUTEX_LOCK(audio, audio->submixLock)
+
+	partialCount = FAudio_INTERNAL_LayoutPartialMixes(audio);
+
+	/* Snapshot the source list, it can't change while we hold sourceLock
+	 * since workers never drop it around voice callbacks.
+	 */
+	voiceCount = 0;
+	list = audio->sources;
+	while (list != NULL)
+	{
+		voiceCount += 1;
+		list = list->next;
+	}
+	FAudio_INTERNAL_ResizeMixGraph(audio, voiceCount, 0);
+	i = 0;
+	list = audio->sources;
+	while (list != NULL)
+	{
+		audio->mixVoices[i++] = (FAudioVoice*) list->entry;
+		list = list->next;
+	}
+
+	FAudio_INTERNAL_RunMixWorkers(
+		audio,
+		audio->mixVoices,
+		voiceCount,
+		partialCount
+	);
+	FAudio_INTERNAL_ReducePartialMixes(audio, partialCount);
+
+	FAudio_PlatformUnlockMutex(audio->submixLock);
+	LOG_MUTEX_UNLOCK(audio, audio->submixLock)
+	LOG_FUNC_EXIT(audio)
+}
+
+/* Call this with submixLock held */
+static void FAudio_INTERNAL_MixSubmixesParallel(FAudio *audio)
+{
+	uint32_t i, j, submixCount, partialCount, levelCount, level, dst;
+	LinkedList *list;
+	FAudioSubmixVoice *submix;
+	FAudioVoice *out;
+
+	LOG_FUNC_ENTER(audio)
+
+	partialCount = FAudio_INTERNAL_LayoutPartialMixes(audio);
+	submixCount = partialCount - 1;
+	if (submixCount == 0)
+	{
+		LOG_FUNC_EXIT(audio)
+		return;
+	}
+	FAudio_INTERNAL_ResizeMixGraph(audio, 0, submixCount);
+
+	/* Build the dependency levels from the sends. The list is sorted by
+	 * processing stage, so a single pass sees every submix after all of
+	 * the submixes that feed it. A send to an earlier submix lands after
+	 * that submix has been mixed, same as the serial mixer, so it does not
+	 * count as an edge.
+	 */
+	FAudio_zero(audio->mixSubmixLevels, sizeof(uint32_t) * submixCount);
+	levelCount = 1;
+	i = 0;
+	list = audio->submixes;
+	while (list != NULL)
+	{
+		submix = (FAudioSubmixVoice*) list->entry;
+		level = audio->mixSubmixLevels[i];
+		FAudio_PlatformLockMutex(submix->sendLock);
+		LOG_MUTEX_LOCK(audio, submix->sendLock)
+		for (j = 0; j < submix->sends.SendCount; j += 1)
+		{
+			out = submix->sends.pSends[j].pOutputVoice;
+			if (out->type != FAUDIO_VOICE_SUBMIX)
+			{
+				continue;
+			}
+			dst = out->mix.partialIndex - 1;
+			if (dst > i && audio->mixSubmixLevels[dst] <= level)
+			{
+				audio->mixSubmixLevels[dst] = level + 1;
+				levelCount = FAudio_max(levelCount, level + 2);
+			}
 		}
-		voice->audio->pFree(entry);
+		FAudio_PlatformUnlockMutex(submix->sendLock);
+		LOG_MUTEX_UNLOCK(audio, submix->sendLock)
+		i += 1;
+		list = list->next;
+	}
+
+	/* Bucket the submixes by level, keeping list order within a level */
+	FAudio_zero(audio->mixLevelOffsets, sizeof(uint32_t) * (levelCount + 1));
+	for (i = 0; i < submixCount; i += 1)
+	{
+		audio->mixLevelOffsets[audio->mixSubmixLevels[i] + 1] += 1;
+	}
+	for (i = 0; i < levelCount; i += 1)
+	{
+		audio->mixLevelOffsets[i + 1] += audio->mixLevelOffsets[i];
+	}
+	i = 0;
+	list = audio->submixes;
+	while (list != NULL)
+	{
+		level = audio->mixSubmixLevels[i];
+		audio->mixVoices[audio->mixLevelOffsets[level]] = (FAudioVoice*) list->entry;
+		audio->mixLevelOffsets[level] += 1;
+		i += 1;
+		list = list->next;
+	}
+
+	/* Bucketing moved each level's start offset to its end, so each level
+	 * now starts where the previous one ends.
+	 */
+	for (level = 0; level < levelCount; level += 1)
+	{
+		i = (level == 0) ? 0 : audio->mixLevelOffsets[level - 1];
+		FAudio_INTERNAL_RunMixWorkers(
+			audio,
+			audio->mixVoices + i,
+			audio->mixLevelOffsets[level] - i,
+			partialCount
+		);
+		FAudio_INTERNAL_ReducePartialMixes(audio, partialCount);
 	}
 
-	FAudio_PlatformUnlockMutex(voice->src.bufferLock);
-	LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
+	LOG_FUNC_EXIT(audio)
 }
 
 static void FAUDIOCALL FAudio_INTERNAL_GenerateOutput(FAudio *audio, float *output)
@@ -1342,6 +2852,8 @@ static void FAUDIOCALL FAudio_INTERNAL_GenerateOutput(FAudio *audio, float *outp
 		return;
 	}
 
+	LOG_TIMING_QUANTUM_BEGIN(audio)
+
 	/* Apply any committed changes */
 	FAudio_OPERATIONSET_Execute(audio);
 
@@ -1386,37 +2898,75 @@ static void FAUDIOCALL FAudio_INTERNAL_GenerateOutput(FAudio *audio, float *outp
 	/* Mix sources */
 	FAudio_PlatformLockMutex(audio->sourceLock);
 	LOG_MUTEX_LOCK(audio, audio->sourceLock)
-	list = audio->sources;
-	while (list != NULL)
+	if (audio->mixWorkerCount > 0)
 	{
-		audio->processingSource = (FAudioSourceVoice*) list->entry;
-
-		FAudio_INTERNAL_FlushPendingBuffers(audio->processingSource);
-		if (audio->processingSource->src.active)
+		FAudio_INTERNAL_MixSourcesParallel(audio);
+	}
+	else
+	{
+		list = audio->sources;
+		while (list != NULL)
 		{
-			FAudio_INTERNAL_MixSource(audio->processingSource);
-			FAudio_INTERNAL_FlushPendingBuffers(audio->processingSource);
-		}
+			audio->processingSource = (FAudioSourceVoice*) list->entry;
 
-		list = list->next;
+			FAudio_INTERNAL_FlushPendingBuffers(
+				audio->processingSource,
+				&audio->mixContext
+			);
+			if (audio->processingSource->src.active)
+			{
+				LOG_TIMING_VOICE_BEGIN(&audio->mixContext)
+				FAudio_INTERNAL_MixSource(
+					audio->processingSource,
+					&audio->mixContext
+				);
+				LOG_TIMING_VOICE_END(
+					audio->processingSource,
+					&audio->mixContext
+				)
+				FAudio_INTERNAL_FlushPendingBuffers(
+					audio->processingSource,
+					&audio->mixContext
+				);
+			}
+
+			list = list->next;
+		}
+		audio->processingSource = NULL;
 	}
-	audio->processingSource = NULL;
 	FAudio_PlatformUnlockMutex(audio->sourceLock);
 	LOG_MUTEX_UNLOCK(audio, audio->sourceLock)
 
 	/* Mix submixes, ordered by processing stage */
 	FAudio_PlatformLockMutex(audio->submixLock);
 	LOG_MUTEX_LOCK(audio, audio->submixLock)
-	list = audio->submixes;
-	while (list != NULL)
+	if (audio->mixWorkerCount > 0)
 	{
-		FAudio_INTERNAL_MixSubmix((FAudioSubmixVoice*) list->entry);
-		list = list->next;
+		FAudio_INTERNAL_MixSubmixesParallel(audio);
+	}
+	else
+	{
+		list = audio->submixes;
+		while (list != NULL)
+		{
+			LOG_TIMING_VOICE_BEGIN(&audio->mixContext)
+			FAudio_INTERNAL_MixSubmix(
+				(FAudioSubmixVoice*) list->entry,
+				&audio->mixContext
+			);
+			LOG_TIMING_VOICE_END(
+				(FAudioSubmixVoice*) list->entry,
+				&audio->mixContext
+			)
+			list = list->next;
+		}
 	}
 	FAudio_PlatformUnlockMutex(audio->submixLock);
 	LOG_MUTEX_UNLOCK(audio, audio->submixLock)
 
 	/* Apply master volume */
+	LOG_TIMING_BEGIN(&audio->mixContext, FAUDIO_TIMING_STAGE_MASTER_EXT)
+	LOG_TIMING_VOICE_BEGIN(&audio->mixContext)
 	if (audio->master->volume != 1.0f)
 	{
 		FAudio_INTERNAL_Amplify(
@@ -1434,6 +2984,7 @@ static void FAUDIOCALL FAudio_INTERNAL_GenerateOutput(FAudio *audio, float *outp
 		totalSamples = audio->updateSize;
 		effectOut = FAudio_INTERNAL_ProcessEffectChain(
 			audio->master,
+			&audio->mixContext,
 			audio->master->master.output,
 			&totalSamples
 		);
@@ -1454,6 +3005,8 @@ static void FAUDIOCALL FAudio_INTERNAL_GenerateOutput(FAudio *audio, float *outp
 			);
 		}
 	}
+	LOG_TIMING_END(&audio->mixContext, FAUDIO_TIMING_STAGE_MASTER_EXT)
+	LOG_TIMING_VOICE_END(audio->master, &audio->mixContext)
 	FAudio_PlatformUnlockMutex(audio->master->effectLock);
 	LOG_MUTEX_UNLOCK(audio, audio->master->effectLock)
 
@@ -1475,6 +3028,7 @@ static void FAUDIOCALL FAudio_INTERNAL_GenerateOutput(FAudio *audio, float *outp
 	FAudio_PlatformUnlockMutex(audio->callbackLock);
 	LOG_MUTEX_UNLOCK(audio, audio->callbackLock)
 
+	LOG_TIMING_QUANTUM_END(audio)
 	LOG_FUNC_EXIT(audio)
 }
 
@@ -1497,24 +3051,422 @@ void FAudio_INTERNAL_UpdateEngine(FAudio *audio, float *output)
 	LOG_FUNC_EXIT(audio)
 }
 
-void FAudio_INTERNAL_ResizeDecodeCache(FAudio *audio, uint32_t samples)
+static void FAudio_INTERNAL_ReserveMixContext(
+	FAudio *audio,
+	FAudioMixContext *ctx,
+	uint32_t decodeSamples,
+	uint32_t resampleSamples,
+	uint32_t sincSamples,
+	uint32_t effectChainSamples
+) {
+	FAudio_INTERNAL_ResizeDecodeCache(audio, ctx, decodeSamples);
+	FAudio_INTERNAL_ResizeResampleCache(audio, ctx, resampleSamples);
+	FAudio_INTERNAL_ResizeSincCache(audio, ctx, sincSamples);
+	FAudio_INTERNAL_ResizeEffectChainCache(audio, ctx, effectChainSamples);
+}
+
+/* Grows every mixer cache to the worst case this voice can ask for, so that
+ * the mixer itself never has to call the allocator. Call this from the
+ * application thread after the voice is created or reconfigured.
+ */
+void FAudio_INTERNAL_ReserveMixCaches(FAudioVoice *voice)
 {
+	FAudio *audio = voice->audio;
+	uint32_t samples, channels, i;
+	uint32_t decodeSamples = 0, resampleSamples = 0, sincSamples = 0;
+	uint32_t effectChainSamples = 0, sendSamples = 0, outChannels = 0;
+	uint32_t sourceCount = 0, submixCount = 0, partialSamples = 0;
+	FAudioVoice *out;
+	LinkedList *list;
+
 	LOG_FUNC_ENTER(audio)
+
+	/* Work out what this voice needs before taking the engine locks */
+	if (voice->type == FAUDIO_VOICE_SOURCE)
+	{
+		samples = voice->src.resampleSamples;
+		channels = voice->src.format->nChannels;
+		decodeSamples = (
+			voice->src.decodeSamples +
+			EXTRA_DECODE_PADDING
+		) * channels;
+		resampleSamples = samples * channels;
+		if (voice->src.sincHistory != NULL)
+		{
+			sincSamples = (
+				FAUDIO_SINC_HISTORY +
+				voice->src.decodeSamples +
+				EXTRA_DECODE_PADDING +
+				FAUDIO_SINC_DELAY
+			) * channels;
+		}
+	}
+	else if (voice->type == FAUDIO_VOICE_SUBMIX)
+	{
+		samples = voice->mix.outputSamples;
+		resampleSamples = samples * voice->mix.inputChannels;
+	}
+	else
+	{
+		samples = audio->updateSize;
+	}
+
+	FAudio_PlatformLockMutex(voice->effectLock);
+	LOG_MUTEX_LOCK(audio, voice->effectLock)
+	for (i = 0; i < voice->effects.count; i += 1)
+	{
+		effectChainSamples = FAudio_max(
+			effectChainSamples,
+			voice->effects.desc[i].OutputChannels * samples
+		);
+	}
+	FAudio_PlatformUnlockMutex(voice->effectLock);
+	LOG_MUTEX_UNLOCK(audio, voice->effectLock)
+
+	FAudio_PlatformLockMutex(voice->sendLock);
+	LOG_MUTEX_LOCK(audio, voice->sendLock)
+	for (i = 0; i < voice->sends.SendCount; i += 1)
+	{
+		out = voice->sends.pSends[i].pOutputVoice;
+		outChannels = FAudio_max(
+			outChannels,
+			(out->type == FAUDIO_VOICE_MASTER) ?
+				out->master.inputChannels :
+				out->mix.inputChannels
+		);
+	}
+	sendSamples = samples * outChannels;
+	FAudio_PlatformUnlockMutex(voice->sendLock);
+	LOG_MUTEX_UNLOCK(audio, voice->sendLock)
+
+	/* The audio thread uses mixContext through all three stages */
 	FAudio_PlatformLockMutex(audio->sourceLock);
 	LOG_MUTEX_LOCK(audio, audio->sourceLock)
-	if (samples > audio->decodeSamples)
+	FAudio_PlatformLockMutex(audio->submixLock);
+	LOG_MUTEX_LOCK(audio, audio->submixLock)
+	if (audio->master != NULL && audio->master != voice)
+	{
+		FAudio_PlatformLockMutex(audio->master->effectLock);
+		LOG_MUTEX_LOCK(audio, audio->master->effectLock)
+	}
+
+	FAudio_INTERNAL_ReserveMixContext(
+		audio,
+		&audio->mixContext,
+		decodeSamples,
+		resampleSamples,
+		sincSamples,
+		effectChainSamples
+	);
+
+	if (audio->mixWorkerCount > 0 && audio->master != NULL)
 	{
-		audio->decodeSamples = samples;
-		audio->decodeCache = (float*) audio->pRealloc(
-			audio->decodeCache,
-			sizeof(float) * audio->decodeSamples
+		list = audio->sources;
+		while (list != NULL)
+		{
+			sourceCount += 1;
+			list = list->next;
+		}
+		partialSamples = (
+			audio->updateSize *
+			audio->master->master.inputChannels
 		);
+		list = audio->submixes;
+		while (list != NULL)
+		{
+			submixCount += 1;
+			partialSamples += (
+				(FAudioSubmixVoice*) list->entry
+			)->mix.inputSamples;
+			list = list->next;
+		}
+		FAudio_INTERNAL_ResizeMixGraph(audio, sourceCount, submixCount);
+
+		for (i = 0; i < audio->mixWorkerCount; i += 1)
+		{
+			FAudio_INTERNAL_ReserveMixContext(
+				audio,
+				&audio->mixWorkers[i].context,
+				decodeSamples,
+				resampleSamples,
+				sincSamples,
+				effectChainSamples
+			);
+			FAudio_INTERNAL_ResizeSendCache(
+				audio,
+				&audio->mixWorkers[i].context,
+				sendSamples
+			);
+			FAudio_INTERNAL_ResizePartialCaches(
+				audio,
+				&audio->mixWorkers[i].context,
+				partialSamples,
+				submixCount + 1
+			);
+		}
+	}
+
+	if (audio->master != NULL && audio->master != voice)
+	{
+		FAudio_PlatformUnlockMutex(audio->master->effectLock);
+		LOG_MUTEX_UNLOCK(audio, audio->master->effectLock)
 	}
+	FAudio_PlatformUnlockMutex(audio->submixLock);
+	LOG_MUTEX_UNLOCK(audio, audio->submixLock)
 	FAudio_PlatformUnlockMutex(audio->sourceLock);
 	LOG_MUTEX_UNLOCK(audio, audio->sourceLock)
 	LOG_FUNC_EXIT(audio)
 }
 
+/* Voice-lifetime allocations: voice structs, send/volume/filter arrays,
+ * effect chains and their parameter blocks. These come and go with every
+ * voice, so rather than hitting the system allocator for each one they are
+ * carved out of large chunks and recycled through per-size free lists.
+ *
+ * Every block starts with a header holding its size class, so blocks can be
+ * freed and resized without the caller keeping track of their size.
+ */
+
+#define FAUDIO_SLAB_HEADER 16 /* Keeps the payload aligned for SIMD */
+#define FAUDIO_SLAB_MIN 32
+#define FAUDIO_SLAB_LARGE 0xFF
+
+static inline uint32_t FAudio_INTERNAL_SlabClass(size_t size)
+{
+	uint32_t c = 0;
+	size += FAUDIO_SLAB_HEADER;
+	while ((size_t) (FAUDIO_SLAB_MIN << c) < size)
+	{
+		c += 1;
+		if (c == FAUDIO_SLAB_CLASSES)
+		{
+			return FAUDIO_SLAB_LARGE;
+		}
+	}
+	return c;
+}
+
+void* FAudio_INTERNAL_SlabAlloc(FAudio *audio, size_t size)
+{
+	uint32_t c, tail;
+	size_t blockSize, tailSize;
+	uint8_t *block, *chunk;
+
+	c = FAudio_INTERNAL_SlabClass(size);
+	if (c == FAUDIO_SLAB_LARGE)
+	{
+		block = (uint8_t*) audio->pMalloc(FAUDIO_SLAB_HEADER + size);
+		*((uint32_t*) block) = FAUDIO_SLAB_LARGE;
+		return block + FAUDIO_SLAB_HEADER;
+	}
+	blockSize = (size_t) FAUDIO_SLAB_MIN << c;
+
+	FAudio_PlatformLockMutex(audio->slabLock);
+	LOG_MUTEX_LOCK(audio, audio->slabLock)
+	if (audio->slabFree[c] != NULL)
+	{
+		block = (uint8_t*) audio->slabFree[c];
+		audio->slabFree[c] = *((void**) (block + FAUDIO_SLAB_HEADER));
+	}
+	else
+	{
+		if (audio->slabRemaining < blockSize)
+		{
+			/* Keep what's left of the old chunk on the smaller lists */
+			tail = c;
+			while (tail > 0)
+			{
+				tailSize = (size_t) FAUDIO_SLAB_MIN << (tail - 1);
+				if (audio->slabRemaining < tailSize)
+				{
+					tail -= 1;
+					continue;
+				}
+				block = audio->slabCursor;
+				*((void**) (block + FAUDIO_SLAB_HEADER)) = audio->slabFree[tail - 1];
+				audio->slabFree[tail - 1] = block;
+				audio->slabCursor += tailSize;
+				audio->slabRemaining -= tailSize;
+			}
+
+			/* The first header's worth of every chunk links the chunks */
+			chunk = (uint8_t*) audio->pMalloc(FAUDIO_SLAB_CHUNK_SIZE);
+			*((void**) chunk) = audio->slabChunks;
+			audio->slabChunks = chunk;
+			audio->slabCursor = chunk + FAUDIO_SLAB_HEADER;
+			audio->slabRemaining = FAUDIO_SLAB_CHUNK_SIZE - FAUDIO_SLAB_HEADER;
+		}
+		block = audio->slabCursor;
+		audio->slabCursor += blockSize;
+		audio->slabRemaining -= blockSize;
+	}
+	FAudio_PlatformUnlockMutex(audio->slabLock);
+	LOG_MUTEX_UNLOCK(audio, audio->slabLock)
+
+	*((uint32_t*) block) = c;
+	return block + FAUDIO_SLAB_HEADER;
+}
+
+void* FAudio_INTERNAL_SlabRealloc(FAudio *audio, void *ptr, size_t size)
+{
+	uint32_t c;
+	size_t capacity;
+	void *result;
+
+	if (ptr == NULL)
+	{
+		return FAudio_INTERNAL_SlabAlloc(audio, size);
+	}
+
+	c = *((uint32_t*) ((uint8_t*) ptr - FAUDIO_SLAB_HEADER));
+	if (c == FAUDIO_SLAB_LARGE)
+	{
+		result = audio->pRealloc(
+			(uint8_t*) ptr - FAUDIO_SLAB_HEADER,
+			FAUDIO_SLAB_HEADER + size
+		);
+		return (uint8_t*) result + FAUDIO_SLAB_HEADER;
+	}
+
+	capacity = ((size_t) FAUDIO_SLAB_MIN << c) - FAUDIO_SLAB_HEADER;
+	if (size <= capacity)
+	{
+		return ptr;
+	}
+	result = FAudio_INTERNAL_SlabAlloc(audio, size);
+	FAudio_memcpy(result, ptr, capacity);
+	FAudio_INTERNAL_SlabFree(audio, ptr);
+	return result;
+}
+
+void FAudio_INTERNAL_SlabFree(FAudio *audio, void *ptr)
+{
+	uint8_t *block;
+	uint32_t c;
+
+	if (ptr == NULL)
+	{
+		return;
+	}
+
+	block = (uint8_t*) ptr - FAUDIO_SLAB_HEADER;
+	c = *((uint32_t*) block);
+	if (c == FAUDIO_SLAB_LARGE)
+	{
+		audio->pFree(block);
+		return;
+	}
+
+	FAudio_PlatformLockMutex(audio->slabLock);
+	LOG_MUTEX_LOCK(audio, audio->slabLock)
+	*((void**) ptr) = audio->slabFree[c];
+	audio->slabFree[c] = block;
+	FAudio_PlatformUnlockMutex(audio->slabLock);
+	LOG_MUTEX_UNLOCK(audio, audio->slabLock)
+}
+
+/* Only call this once every voice is gone, it frees every chunk at once */
+void FAudio_INTERNAL_SlabDestroy(FAudio *audio)
+{
+	void *chunk, *next;
+
+	chunk = audio->slabChunks;
+	while (chunk != NULL)
+	{
+		next = *((void**) chunk);
+		audio->pFree(chunk);
+		chunk = next;
+	}
+	audio->slabChunks = NULL;
+	audio->slabCursor = NULL;
+	audio->slabRemaining = 0;
+	FAudio_zero(audio->slabFree, sizeof(audio->slabFree));
+}
+
+void FAudio_INTERNAL_CreateMixWorkers(FAudio *audio, uint32_t count)
+{
+	uint32_t i;
+
+	LOG_FUNC_ENTER(audio)
+	count = FAudio_min(count, FAUDIO_MAX_MIX_WORKERS);
+	if (count < 2)
+	{
+		/* Nothing to split, stay on the serial path */
+		LOG_FUNC_EXIT(audio)
+		return;
+	}
+
+	audio->mixWorkers = (FAudioMixWorker*) audio->pMalloc(
+		sizeof(FAudioMixWorker) * count
+	);
+	FAudio_zero(audio->mixWorkers, sizeof(FAudioMixWorker) * count);
+	audio->mixWorkersDone = FAudio_PlatformCreateSemaphore(0);
+	for (i = 0; i < count; i += 1)
+	{
+		audio->mixWorkers[i].audio = audio;
+
+		/* Worker 0 runs on the audio thread */
+		if (i == 0)
+		{
+			continue;
+		}
+		audio->mixWorkers[i].wake = FAudio_PlatformCreateSemaphore(0);
+		audio->mixWorkers[i].thread = FAudio_PlatformCreateThread(
+			FAudio_INTERNAL_MixWorkerThread,
+			"FAudio Mixer",
+			&audio->mixWorkers[i]
+		);
+		FAudio_assert(audio->mixWorkers[i].thread != NULL);
+	}
+	audio->mixWorkerCount = count;
+	LOG_FUNC_EXIT(audio)
+}
+
+void FAudio_INTERNAL_DestroyMixWorkers(FAudio *audio)
+{
+	uint32_t i;
+	FAudioMixWorker *worker;
+
+	LOG_FUNC_ENTER(audio)
+	for (i = 0; i < audio->mixWorkerCount; i += 1)
+	{
+		worker = &audio->mixWorkers[i];
+		if (worker->thread != NULL)
+		{
+			worker->quit = 1;
+			FAudio_PlatformSignalSemaphore(worker->wake);
+			FAudio_PlatformWaitThread(worker->thread, NULL);
+		}
+		if (worker->wake != NULL)
+		{
+			FAudio_PlatformDestroySemaphore(worker->wake);
+		}
+		audio->pFree(worker->context.decodeCache);
+		audio->pFree(worker->context.resampleCache);
+		audio->pFree(worker->context.effectChainCache);
+		audio->pFree(worker->context.sincCache);
+		audio->pFree(worker->context.partialCache);
+		audio->pFree(worker->context.partialUsed);
+		audio->pFree(worker->context.sendCache);
+	}
+	if (audio->mixWorkers != NULL)
+	{
+		FAudio_PlatformDestroySemaphore(audio->mixWorkersDone);
+		audio->pFree(audio->mixWorkers);
+	}
+	audio->pFree(audio->mixVoices);
+	audio->pFree(audio->mixPartialOffsets);
+	audio->pFree(audio->mixSubmixLevels);
+	audio->pFree(audio->mixLevelOffsets);
+	audio->mixWorkerCount = 0;
+	audio->mixWorkers = NULL;
+	audio->mixVoices = NULL;
+	audio->mixPartialOffsets = NULL;
+	audio->mixSubmixLevels = NULL;
+	audio->mixLevelOffsets = NULL;
+	LOG_FUNC_EXIT(audio)
+}
+
 void FAudio_INTERNAL_AllocEffectChain(
 	FAudioVoice *voice,
 	const FAudioEffectChain *pEffectChain
@@ -1535,7 +3487,8 @@ void FAudio_INTERNAL_AllocEffectChain(
 		pEffectChain->pEffectDescriptors[i].pEffect->AddRef(pEffectChain->pEffectDescriptors[i].pEffect);
 	}
 
-	voice->effects.desc = (FAudioEffectDescriptor*) voice->audio->pMalloc(
+	voice->effects.desc = (FAudioEffectDescriptor*) FAudio_INTERNAL_SlabAlloc(
+		voice->audio,
 		voice->effects.count * sizeof(FAudioEffectDescriptor)
 	);
 	FAudio_memcpy(
@@ -1544,7 +3497,8 @@ void FAudio_INTERNAL_AllocEffectChain(
 		voice->effects.count * sizeof(FAudioEffectDescriptor)
 	);
 	#define ALLOC_EFFECT_PROPERTY(prop, type) \
-		voice->effects.prop = (type*) voice->audio->pMalloc( \
+		voice->effects.prop = (type*) FAudio_INTERNAL_SlabAlloc( \
+			voice->audio, \
 			voice->effects.count * sizeof(type) \
 		); \
 		FAudio_zero( \
@@ -1574,13 +3528,14 @@ void FAudio_INTERNAL_FreeEffectChain(FAudioVoice *voice)
 	{
 		voice->effects.desc[i].pEffect->UnlockForProcess(voice->effects.desc[i].pEffect);
 		voice->effects.desc[i].pEffect->Release(voice->effects.desc[i].pEffect);
+		FAudio_INTERNAL_SlabFree(voice->audio, voice->effects.parameters[i]);
 	}
 
-	voice->audio->pFree(voice->effects.desc);
-	voice->audio->pFree(voice->effects.parameters);
-	voice->audio->pFree(voice->effects.parameterSizes);
-	voice->audio->pFree(voice->effects.parameterUpdates);
-	voice->audio->pFree(voice->effects.inPlaceProcessing);
+	FAudio_INTERNAL_SlabFree(voice->audio, voice->effects.desc);
+	FAudio_INTERNAL_SlabFree(voice->audio, voice->effects.parameters);
+	FAudio_INTERNAL_SlabFree(voice->audio, voice->effects.parameterSizes);
+	FAudio_INTERNAL_SlabFree(voice->audio, voice->effects.parameterUpdates);
+	FAudio_INTERNAL_SlabFree(voice->audio, voice->effects.inPlaceProcessing);
 	LOG_FUNC_EXIT(voice->audio)
 }
 
@@ -1761,258 +3716,108 @@ void FAudio_INTERNAL_DecodePCM32F(
 
 /* MSADPCM Decoding */
 
-static inline int16_t FAudio_INTERNAL_ParseNibble(
-	uint8_t nibble,
-	uint8_t predictor,
-	int16_t *delta,
-	int16_t *sample1,
-	int16_t *sample2
-) {
-	static const int32_t AdaptionTable[16] =
-	{
-		230, 230, 230, 230, 307, 409, 512, 614,
-		768, 614, 512, 409, 307, 230, 230, 230
-	};
-	static const int32_t AdaptCoeff_1[7] =
-	{
-		256, 512, 0, 192, 240, 460, 392
-	};
-	static const int32_t AdaptCoeff_2[7] =
-	{
-		0, -256, 0, 64, 0, -208, -232
-	};
-
-	int8_t signedNibble;
-	int32_t sampleInt;
-	int16_t sample;
-
-	signedNibble = (int8_t) nibble;
-	if (signedNibble & 0x08)
-	{
-		signedNibble -= 0x10;
-	}
-
-	sampleInt = (
-		(*sample1 * AdaptCoeff_1[predictor]) +
-		(*sample2 * AdaptCoeff_2[predictor])
-	) / 256;
-	sampleInt += signedNibble * (*delta);
-	sample = FAudio_clamp(sampleInt, -32768, 32767);
-
-	*sample2 = *sample1;
-	*sample1 = sample;
-	*delta = (int16_t) (AdaptionTable[nibble] * (int32_t) (*delta) / 256);
-	if (*delta < 16)
-	{
-		*delta = 16;
-	}
-	return sample;
-}
-
-#define READ(item, type) \
-	item = *((type*) *buf); \
-	*buf += sizeof(type);
-
-static inline void FAudio_INTERNAL_DecodeMonoMSADPCMBlock(
-	uint8_t **buf,
-	int16_t *blockCache,
-	uint32_t align
-) {
-	uint32_t i;
-
-	/* Temp storage for ADPCM blocks */
-	uint8_t predictor;
-	int16_t delta;
-	int16_t sample1;
-	int16_t sample2;
-
-	/* Preamble */
-	READ(predictor, uint8_t)
-	READ(delta, int16_t)
-	READ(sample1, int16_t)
-	READ(sample2, int16_t)
-	align -= 7;
-
-	/* Samples */
-	*blockCache++ = sample2;
-	*blockCache++ = sample1;
-	for (i = 0; i < align; i += 1, *buf += 1)
-	{
-		*blockCache++ = FAudio_INTERNAL_ParseNibble(
-			*(*buf) >> 4,
-			predictor,
-			&delta,
-			&sample1,
-			&sample2
-		);
-		*blockCache++ = FAudio_INTERNAL_ParseNibble(
-			*(*buf) & 0x0F,
-			predictor,
-			&delta,
-			&sample1,
-			&sample2
-		);
-	}
-}
-
-static inline void FAudio_INTERNAL_DecodeStereoMSADPCMBlock(
-	uint8_t **buf,
-	int16_t *blockCache,
-	uint32_t align
-) {
-	uint32_t i;
-
-	/* Temp storage for ADPCM blocks */
-	uint8_t l_predictor;
-	uint8_t r_predictor;
-	int16_t l_delta;
-	int16_t r_delta;
-	int16_t l_sample1;
-	int16_t r_sample1;
-	int16_t l_sample2;
-	int16_t r_sample2;
-
-	/* Preamble */
-	READ(l_predictor, uint8_t)
-	READ(r_predictor, uint8_t)
-	READ(l_delta, int16_t)
-	READ(r_delta, int16_t)
-	READ(l_sample1, int16_t)
-	READ(r_sample1, int16_t)
-	READ(l_sample2, int16_t)
-	READ(r_sample2, int16_t)
-	align -= 14;
-
-	/* Samples */
-	*blockCache++ = l_sample2;
-	*blockCache++ = r_sample2;
-	*blockCache++ = l_sample1;
-	*blockCache++ = r_sample1;
-	for (i = 0; i < align; i += 1, *buf += 1)
-	{
-		*blockCache++ = FAudio_INTERNAL_ParseNibble(
-			*(*buf) >> 4,
-			l_predictor,
-			&l_delta,
-			&l_sample1,
-			&l_sample2
-		);
-		*blockCache++ = FAudio_INTERNAL_ParseNibble(
-			*(*buf) & 0x0F,
-			r_predictor,
-			&r_delta,
-			&r_sample1,
-			&r_sample2
-		);
-	}
-}
-
-#undef READ
-
-void FAudio_INTERNAL_DecodeMonoMSADPCM(
+static inline void FAudio_INTERNAL_DecodeMSADPCM(
 	FAudioVoice *voice,
 	FAudioBuffer *buffer,
 	float *decodeCache,
-	uint32_t samples
+	uint32_t samples,
+	uint32_t channels
 ) {
 	/* Loop variables */
-	uint32_t copy, done = 0;
+	uint32_t copy, block, blocks, done = 0;
 
 	/* Read pointers */
-	uint8_t *buf;
-	int32_t midOffset;
-
-	/* PCM block cache */
-	int16_t *blockCache;
+	uint32_t midOffset;
+	FAudioBufferEntry *entry;
+	FAudioADPCMCacheEntry *cached;
 
-	/* Block size */
+	/* Align, block size */
+	uint32_t align = voice->src.format->nBlockAlign;
 	uint32_t bsize = ((FAudioADPCMWaveFormat*) voice->src.format)->wSamplesPerBlock;
 
 	LOG_FUNC_ENTER(voice->audio)
 
+	/* Buffers always live in an entry, see FAudioBufferEntry */
+	entry = (FAudioBufferEntry*) buffer;
+
+	/* Already decoded at submission? */
+	cached = entry->adpcm;
+	if (cached != NULL)
+	{
+		FAudio_INTERNAL_Convert_S16_To_F32(
+			(int16_t*) cached->pcm + (voice->src.curBufferOffset * channels),
+			decodeCache,
+			samples * channels
+		);
+		LOG_FUNC_EXIT(voice->audio)
+		return;
+	}
+
 	/* Where are we starting? */
-	buf = (uint8_t*) buffer->pAudioData + (
-		(voice->src.curBufferOffset / bsize) *
-		voice->src.format->nBlockAlign
-	);
+	block = voice->src.curBufferOffset / bsize;
 
 	/* Are we starting in the middle? */
 	midOffset = (voice->src.curBufferOffset % bsize);
 
-	/* Read in each block directly to the decode cache */
-	blockCache = (int16_t*) FAudio_alloca(bsize * sizeof(int16_t));
 	while (done < samples)
 	{
-		copy = FAudio_min(samples - done, bsize - midOffset);
-		FAudio_INTERNAL_DecodeMonoMSADPCMBlock(
-			&buf,
-			blockCache,
-			voice->src.format->nBlockAlign
+		/* Blocks usually outlast an update, so decode a run of them at
+		 * once, which is also what lets the SIMD decoder go wide
+		 */
+		if (	entry != voice->src.adpcmBlocksEntry ||
+			block < voice->src.adpcmBlocksFirst ||
+			block >= (voice->src.adpcmBlocksFirst + voice->src.adpcmBlocksCount)	)
+		{
+			blocks = FAudio_min(
+				voice->src.adpcmBlocksMax,
+				(buffer->AudioBytes / align) - block
+			);
+			FAudio_assert(blocks > 0);
+			FAudio_INTERNAL_DecodeMSADPCMBlocks(
+				buffer->pAudioData + (block * align),
+				voice->src.adpcmBlocks,
+				blocks,
+				align,
+				channels
+			);
+			voice->src.adpcmBlocksEntry = entry;
+			voice->src.adpcmBlocksFirst = block;
+			voice->src.adpcmBlocksCount = blocks;
+		}
+		midOffset += (block - voice->src.adpcmBlocksFirst) * bsize;
+		copy = FAudio_min(
+			samples - done,
+			(voice->src.adpcmBlocksCount * bsize) - midOffset
 		);
 		FAudio_INTERNAL_Convert_S16_To_F32(
-			blockCache + midOffset,
+			voice->src.adpcmBlocks + (midOffset * channels),
 			decodeCache,
-			copy
+			copy * channels
 		);
-		decodeCache += copy;
+		decodeCache += copy * channels;
 		done += copy;
+		block = voice->src.adpcmBlocksFirst + voice->src.adpcmBlocksCount;
 		midOffset = 0;
 	}
-	FAudio_dealloca(blockCache);
 	LOG_FUNC_EXIT(voice->audio)
 }
 
-void FAudio_INTERNAL_DecodeStereoMSADPCM(
+void FAudio_INTERNAL_DecodeMonoMSADPCM(
 	FAudioVoice *voice,
 	FAudioBuffer *buffer,
 	float *decodeCache,
 	uint32_t samples
 ) {
-	/* Loop variables */
-	uint32_t copy, done = 0;
-
-	/* Read pointers */
-	uint8_t *buf;
-	int32_t midOffset;
-
-	/* PCM block cache */
-	int16_t *blockCache;
-
-	/* Align, block size */
-	uint32_t bsize = ((FAudioADPCMWaveFormat*) voice->src.format)->wSamplesPerBlock;
-
-	LOG_FUNC_ENTER(voice->audio)
-
-	/* Where are we starting? */
-	buf = (uint8_t*) buffer->pAudioData + (
-		(voice->src.curBufferOffset / bsize) *
-		voice->src.format->nBlockAlign
-	);
-
-	/* Are we starting in the middle? */
-	midOffset = (voice->src.curBufferOffset % bsize);
+	FAudio_INTERNAL_DecodeMSADPCM(voice, buffer, decodeCache, samples, 1);
+}
 
-	/* Read in each block directly to the decode cache */
-	blockCache = (int16_t*) FAudio_alloca(bsize * 2 * sizeof(int16_t));
-	while (done < samples)
-	{
-		copy = FAudio_min(samples - done, bsize - midOffset);
-		FAudio_INTERNAL_DecodeStereoMSADPCMBlock(
-			&buf,
-			blockCache,
-			voice->src.format->nBlockAlign
-		);
-		FAudio_INTERNAL_Convert_S16_To_F32(
-			blockCache + (midOffset * 2),
-			decodeCache,
-			copy * 2
-		);
-		decodeCache += copy * 2;
-		done += copy;
-		midOffset = 0;
-	}
-	FAudio_dealloca(blockCache);
-	LOG_FUNC_EXIT(voice->audio)
+void FAudio_INTERNAL_DecodeStereoMSADPCM(
+	FAudioVoice *voice,
+	FAudioBuffer *buffer,
+	float *decodeCache,
+	uint32_t samples
+) {
+	FAudio_INTERNAL_DecodeMSADPCM(voice, buffer, decodeCache, samples, 2);
 }
 
 /* Fallback WMA decoder, get ready for spam! */
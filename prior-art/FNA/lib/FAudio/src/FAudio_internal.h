@@ -71,6 +71,7 @@
 #define FAudio_abs(x) abs(x)
 #define FAudio_ldexp(v, e) ldexp(v, e)
 #define FAudio_exp(x) exp(x)
+#define FAudio_sqrt(x) sqrt(x)
 
 #define FAudio_cosf(x) cosf(x)
 #define FAudio_sinf(x) sinf(x)
@@ -85,6 +86,7 @@
 #define FAudio_snprintf snprintf
 #define FAudio_vsnprintf vsnprintf
 #define FAudio_getenv getenv
+#define FAudio_atoi atoi
 #define FAudio_PRIu64 PRIu64
 #define FAudio_PRIx64 PRIx64
 
@@ -163,7 +165,7 @@ extern void FAudio_Log(char const *msg);
 
 #define FAudio_strlen(ptr) SDL_strlen(ptr)
 #define FAudio_strcmp(str1, str2) SDL_strcmp(str1, str2)
-#define FAudio_strncmp(str1, str2, size) SDL_strncmp(str1, str1, size)
+#define FAudio_strncmp(str1, str2, size) SDL_strncmp(str1, str2, size)
 #define FAudio_strlcpy(ptr1, ptr2, size) SDL_strlcpy(ptr1, ptr2, size)
 
 #define FAudio_pow(x, y) SDL_pow(x, y)
@@ -179,6 +181,7 @@ extern void FAudio_Log(char const *msg);
 #define FAudio_abs(x) SDL_abs(x)
 #define FAudio_ldexp(v, e) SDL_scalbn(v, e)
 #define FAudio_exp(x) SDL_exp(x)
+#define FAudio_sqrt(x) SDL_sqrt(x)
 
 #define FAudio_cosf(x) SDL_cosf(x)
 #define FAudio_sinf(x) SDL_sinf(x)
@@ -206,6 +209,7 @@ extern void FAudio_Log(char const *msg);
 #define FAudio_vsnprintf SDL_vsnprintf
 #define FAudio_Log(msg) SDL_Log("%s", msg)
 #define FAudio_getenv SDL_getenv
+#define FAudio_atoi SDL_atoi
 #define FAudio_PRIu64 SDL_PRIu64
 #define FAudio_PRIx64 SDL_PRIx64
 #endif
@@ -253,6 +257,11 @@ extern void FAudio_Log(char const *msg);
 
 typedef void* FAudioThread;
 typedef void* FAudioMutex;
+typedef void* FAudioSemaphore;
+typedef struct FAudioAtomic
+{
+	int value;
+} FAudioAtomic;
 typedef int32_t (FAUDIOCALL * FAudioThreadFunc)(void* data);
 typedef enum FAudioThreadPriority
 {
@@ -297,14 +306,131 @@ typedef enum FAudioVoiceType
 	FAUDIO_VOICE_MASTER
 } FAudioVoiceType;
 
+/* Decoded MSADPCM/Vorbis/QOA cache, see "extensions/ADPCMCacheEXT.txt".
+ *
+ * Entries are only ever looked up, pinned and evicted by the application
+ * threads, under adpcmCacheLock. The mixer reads the PCM of entries that are
+ * pinned by the buffers it's playing and drops the pin when it retires the
+ * buffer, which is why pins is atomic; it never takes the lock.
+ */
+
+#define FAUDIO_ADPCM_CACHE_BUCKETS 256
+
+typedef struct FAudioADPCMCacheEntry FAudioADPCMCacheEntry;
+struct FAudioADPCMCacheEntry
+{
+	/* Key */
+	const uint8_t *pAudioData;
+	uint32_t AudioBytes;
+	uint16_t formatTag;
+	uint16_t blockAlign;
+	uint16_t channels;
+	uint64_t hash;
+
+	FAudioAtomic pins;
+	uint32_t size;
+	void *pcm;	/* int16_t, except for Vorbis which decodes to float */
+
+	FAudioADPCMCacheEntry *hashNext;
+	FAudioADPCMCacheEntry *lruPrev;
+	FAudioADPCMCacheEntry *lruNext;
+};
+
 typedef struct FAudioBufferEntry FAudioBufferEntry;
 struct FAudioBufferEntry
 {
 	FAudioBuffer buffer;
 	FAudioBufferWMA bufferWMA;
 	FAudioBufferEntry *next;
+
+	/* Pinned while the entry is queued, cleared by the mixer on retirement */
+	FAudioADPCMCacheEntry *adpcm;
+
+#ifndef DISABLE_XNASONG
+	/* Vorbis/QOA only, opened at submission unless the buffer was cached,
+	 * closed by the application once the entry has been retired
+	 */
+	struct FAudioCompressedDecoder *compressed;
+#endif /* DISABLE_XNASONG */
 };
 
+/* Source buffer queue. The application submits buffers and the mixer consumes
+ * them through a single-producer/single-consumer ring, so the mixer never
+ * waits on the application. Entries come from a pool that is allocated along
+ * with the voice, which is also why a voice can only have
+ * FAUDIO_MAX_QUEUED_BUFFERS buffers queued at once.
+ *
+ * Only the mixer touches bufferList/flushList. Anything the application wants
+ * to do to queued buffers (flushing, ending the stream, breaking a loop) is
+ * sent down the ring as a command, in order with the submissions.
+ */
+
+#define FAUDIO_BUFFER_QUEUE_COMMANDS (FAUDIO_MAX_QUEUED_BUFFERS * 2)
+
+typedef enum FAudioBufferCommandType
+{
+	FAUDIO_BUFFER_COMMAND_SUBMIT,
+	FAUDIO_BUFFER_COMMAND_FLUSH_PENDING,	/* Voice was playing, keep the active buffer */
+	FAUDIO_BUFFER_COMMAND_FLUSH_ALL,
+	FAUDIO_BUFFER_COMMAND_DISCONTINUITY,
+	FAUDIO_BUFFER_COMMAND_EXITLOOP
+} FAudioBufferCommandType;
+
+typedef struct FAudioBufferCommand
+{
+	FAudioBufferCommandType type;
+	FAudioBufferEntry *entry;	/* SUBMIT only */
+} FAudioBufferCommand;
+
+typedef struct FAudioBufferQueue
+{
+	/* Application side, serialized by src.bufferLock */
+	uint32_t submitted;
+	uint32_t lastCommand;
+	FAudioBufferCommandType lastCommandType;
+
+	/* Mixer side */
+	FAudioAtomic retired;
+	void *currentContext;
+
+	/* Application -> mixer */
+	FAudioAtomic commandRead;
+	FAudioAtomic commandWrite;
+	FAudioBufferCommand commands[FAUDIO_BUFFER_QUEUE_COMMANDS];
+
+	/* Mixer -> application */
+	FAudioAtomic freeRead;
+	FAudioAtomic freeWrite;
+	FAudioBufferEntry *freeEntries[FAUDIO_MAX_QUEUED_BUFFERS];
+
+	FAudioBufferEntry entries[FAUDIO_MAX_QUEUED_BUFFERS];
+} FAudioBufferQueue;
+
+void FAudio_INTERNAL_InitBufferQueue(FAudioBufferQueue *queue);
+FAudioBufferEntry* FAudio_INTERNAL_AcquireBufferEntry(FAudioBufferQueue *queue);
+uint8_t FAudio_INTERNAL_PushBufferCommand(
+	FAudioBufferQueue *queue,
+	FAudioBufferCommandType type,
+	FAudioBufferEntry *entry
+);
+uint32_t FAudio_INTERNAL_BuffersQueued(FAudioBufferQueue *queue);
+void FAudio_INTERNAL_DrainBufferQueue(FAudioSourceVoice *voice);
+
+void FAudio_INTERNAL_PinADPCMCache(
+	FAudioSourceVoice *voice,
+	FAudioBufferEntry *entry
+);
+void FAudio_INTERNAL_UnpinADPCMCache(FAudioSourceVoice *voice);
+void FAudio_INTERNAL_TrimADPCMCache(FAudio *audio);
+void FAudio_INTERNAL_ClearADPCMCache(FAudio *audio);
+
+#ifndef DISABLE_XNASONG
+void FAudio_INTERNAL_CloseCompressedEntries(
+	FAudioSourceVoice *voice,
+	uint8_t retiredOnly
+);
+#endif /* DISABLE_XNASONG */
+
 typedef void (FAUDIOCALL * FAudioDecodeCallback)(
 	FAudioVoice *voice,
 	FAudioBuffer *buffer,	/* Buffer to decode */
@@ -330,11 +456,27 @@ typedef void (FAUDIOCALL * FAudioMixCallback)(
 	float *restrict coefficients
 );
 
+/* The nonzero entries of a send's mix matrix, rebuilt whenever the matrix
+ * changes. taps == 0 means the send is silent and isn't mixed at all.
+ */
+#define FAUDIO_MAX_SEND_TAPS 64
+typedef struct FAudioSendPlan
+{
+	uint32_t taps;
+	uint8_t sparse; /* Few enough taps to beat the dense mixer */
+	uint8_t src[FAUDIO_MAX_SEND_TAPS];
+	uint8_t dst[FAUDIO_MAX_SEND_TAPS];
+	float coefficients[FAUDIO_MAX_SEND_TAPS];
+} FAudioSendPlan;
+
 typedef float FAudioFilterState[4];
 
 /* Operation Sets, original implementation by Tyler Glaiel */
 
 typedef struct FAudio_OPERATIONSET_Operation FAudio_OPERATIONSET_Operation;
+typedef struct FAudio_OPERATIONSET_Set FAudio_OPERATIONSET_Set;
+
+#define FAUDIO_OPERATIONSET_BUCKETS 256
 
 void FAudio_OPERATIONSET_Commit(FAudio *audio, uint32_t OperationSet);
 void FAudio_OPERATIONSET_CommitAll(FAudio *audio);
@@ -410,12 +552,80 @@ void FAudio_OPERATIONSET_QueueSetFrequencyRatio(
 	uint32_t OperationSet
 );
 
+/* Mixer scratch space. The engine owns one context for the audio thread, and
+ * each parallel mix worker owns another so that sources can be decoded,
+ * resampled and processed concurrently.
+ */
+typedef struct FAudioMixContext
+{
+	/* Temp storage for processing, interleaved PCM32F */
+	#define EXTRA_DECODE_PADDING 2
+	uint32_t decodeSamples;
+	uint32_t resampleSamples;
+	uint32_t effectChainSamples;
+	float *decodeCache;
+	float *resampleCache;
+	float *effectChainCache;
+
+	/* FAUDIO_VOICE_SINC_EXT only, the voice's history followed by the
+	 * decoded samples, since the filter reaches back past the decode window
+	 */
+	uint32_t sincSamples;
+	float *sincCache;
+
+	/* Only the audio thread may drop sourceLock around voice callbacks */
+	uint8_t holdsSourceLock;
+
+	/* Parallel mixing only: one partial mix per destination voice, laid
+	 * out according to FAudio.mixPartialOffsets, reduced into the real
+	 * destination buffers by the audio thread once every worker is done.
+	 */
+	float *partialCache;
+	uint32_t partialSamples;
+	uint8_t *partialUsed;
+	uint32_t partialUsedCount;
+	float *sendCache;
+	uint32_t sendSamples;
+
+#ifndef FAUDIO_DISABLE_DEBUGCONFIGURATION
+	/* LOG_TIMING, the audio thread sums these into the quantum record
+	 * once every mixer thread is done with the update.
+	 */
+	#define FAUDIO_TIMING_VOICE FAUDIO_TIMING_STAGE_COUNT_EXT
+	#define FAUDIO_TIMING_TOTAL (FAUDIO_TIMING_STAGE_COUNT_EXT + 1)
+	uint8_t timingEnabled;
+	uint64_t timingStart[FAUDIO_TIMING_STAGE_COUNT_EXT + 2];
+	uint64_t timingStage[FAUDIO_TIMING_STAGE_COUNT_EXT];
+	FAudioVoice *timingSlowestVoice;
+	uint64_t timingSlowestNS;
+#endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
+} FAudioMixContext;
+
+typedef struct FAudioMixWorker
+{
+	FAudio *audio;
+	FAudioThread thread;
+	FAudioSemaphore wake;
+	uint8_t quit;
+
+	/* Assigned by the audio thread before each wake, either source voices
+	 * or submix voices from a single graph level, never both.
+	 */
+	FAudioVoice **voices;
+	uint32_t voiceCount;
+
+	FAudioMixContext context;
+} FAudioMixWorker;
+
+#define FAUDIO_MAX_MIX_WORKERS 64
+
 /* Public FAudio Types */
 
 struct FAudio
 {
 	uint8_t version;
 	uint8_t active;
+	uint8_t platformRef;
 	uint32_t refcount;
 	uint32_t initFlags;
 	uint32_t updateSize;
@@ -430,32 +640,72 @@ struct FAudio
 	FAudioWaveFormatExtensible mixFormat;
 
 	FAudio_OPERATIONSET_Operation *queuedOperations;
+	FAudio_OPERATIONSET_Operation *queuedOperationsTail;
 	FAudio_OPERATIONSET_Operation *committedOperations;
+	FAudio_OPERATIONSET_Operation *committedOperationsTail;
+	FAudio_OPERATIONSET_Operation *freeOperations;
+	FAudio_OPERATIONSET_Set *operationSets[FAUDIO_OPERATIONSET_BUCKETS];
+	FAudio_OPERATIONSET_Set *freeOperationSets;
+	uint32_t queuedOperationSets;
+	FAudio_OPERATIONSET_Operation *coalescedOperations[FAUDIO_OPERATIONSET_BUCKETS];
 
 	/* Used to prevent destroying an active voice */
 	FAudioSourceVoice *processingSource;
 
-	/* Temp storage for processing, interleaved PCM32F */
-	#define EXTRA_DECODE_PADDING 2
-	uint32_t decodeSamples;
-	uint32_t resampleSamples;
-	uint32_t effectChainSamples;
-	float *decodeCache;
-	float *resampleCache;
-	float *effectChainCache;
+	/* Temp storage for the audio thread */
+	FAudioMixContext mixContext;
+
+	/* Parallel mixing, see FAUDIO_PARALLEL_MIX_EXT */
+	uint32_t mixWorkerCount;
+	FAudioMixWorker *mixWorkers;
+	FAudioSemaphore mixWorkersDone;
+	FAudioVoice **mixVoices;
+	uint32_t mixVoiceCapacity;
+	uint32_t *mixPartialOffsets;
+	uint32_t mixPartialCapacity;
+
+	/* Submix dependency levels, indexed by position in the submix list */
+	uint32_t *mixSubmixLevels;
+	uint32_t *mixLevelOffsets;
+	uint32_t mixSubmixCapacity;
 
 	/* Allocator callbacks */
 	FAudioMallocFunc pMalloc;
 	FAudioFreeFunc pFree;
 	FAudioReallocFunc pRealloc;
 
+	/* Voice-lifetime blocks, see FAudio_INTERNAL_SlabAlloc */
+	#define FAUDIO_SLAB_CLASSES 10 /* 32 bytes to 16KB */
+	#define FAUDIO_SLAB_CHUNK_SIZE (64 * 1024)
+	FAudioMutex slabLock;
+	void *slabFree[FAUDIO_SLAB_CLASSES];
+	void *slabChunks;
+	uint8_t *slabCursor;
+	size_t slabRemaining;
+
 	/* EngineProcedureEXT */
 	void *clientEngineUser;
 	FAudioEngineProcedureEXT pClientEngineProc;
 
+	/* ADPCMCacheEXT, most recently used entry first */
+	FAudioMutex adpcmCacheLock;
+	FAudioADPCMCacheEntry *adpcmCacheBuckets[FAUDIO_ADPCM_CACHE_BUCKETS];
+	FAudioADPCMCacheEntry *adpcmCacheHead;
+	FAudioADPCMCacheEntry *adpcmCacheTail;
+	uint32_t adpcmCacheBudget;
+	FAudioADPCMCacheStatsEXT adpcmCacheStats;
+
 #ifndef FAUDIO_DISABLE_DEBUGCONFIGURATION
 	/* Debug Information */
 	FAudioDebugConfiguration debug;
+
+	/* LOG_TIMING, written by the audio thread, read by one poller */
+	#define FAUDIO_TIMING_RING_SIZE 256
+	FAudioQuantumTimingEXT timingRing[FAUDIO_TIMING_RING_SIZE];
+	FAudioAtomic timingRead;
+	FAudioAtomic timingWrite;
+	uint32_t timingDropped;
+	uint64_t timingQuantum;
 #endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
 
 	/* Platform opaque pointer */
@@ -472,6 +722,7 @@ struct FAudioVoice
 	float **sendCoefficients;
 	float **mixCoefficients;
 	FAudioMixCallback *sendMix;
+	FAudioSendPlan *sendPlans;
 	FAudioFilterParametersEXT *sendFilter;
 	FAudioFilterState **sendFilterState;
 	struct
@@ -490,6 +741,13 @@ struct FAudioVoice
 	FAudioMutex effectLock;
 	FAudioMutex filterLock;
 
+#ifndef FAUDIO_DISABLE_DEBUGCONFIGURATION
+	/* LOG_TIMING, only written while the mixer holds the voice list lock
+	 * (or effectLock, for the mastering voice)
+	 */
+	FAudioVoiceTimingEXT timing;
+#endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
+
 	float volume;
 	float *channelVolume;
 	uint32_t outputChannels;
@@ -510,11 +768,27 @@ struct FAudioVoice
 			uint64_t curBufferOffsetDec;
 			uint32_t curBufferOffset;
 
+			/* FAUDIO_VOICE_SINC_EXT only, the FAUDIO_SINC_HISTORY
+			 * frames before the next decode window
+			 */
+			float *sincHistory;
+
 			/* WMA decoding */
 #ifdef HAVE_WMADEC
 			struct FAudioWMADEC *wmadec;
 #endif /* HAVE_WMADEC*/
 
+			/* MSADPCM decoding, the last run of blocks decoded from
+			 * adpcmBlocksEntry. Only the mixer touches these.
+			 */
+			#define FAUDIO_MSADPCM_DECODE_BLOCKS 8
+			#define FAUDIO_MSADPCM_DECODE_BYTES 16384
+			int16_t *adpcmBlocks;
+			uint32_t adpcmBlocksMax;
+			FAudioBufferEntry *adpcmBlocksEntry;
+			uint32_t adpcmBlocksFirst;
+			uint32_t adpcmBlocksCount;
+
 			/* Read-only */
 			float maxFreqRatio;
 			FAudioWaveFormatEx *format;
@@ -529,6 +803,9 @@ struct FAudioVoice
 			uint64_t totalSamples;
 			FAudioBufferEntry *bufferList;
 			FAudioBufferEntry *flushList;
+			FAudioBufferQueue *queue;
+
+			/* Serializes application threads, never taken by the mixer */
 			FAudioMutex bufferLock;
 		} src;
 		struct
@@ -544,6 +821,12 @@ struct FAudioVoice
 			uint32_t inputChannels;
 			uint32_t inputSampleRate;
 			uint32_t processingStage;
+
+			/* Parallel mixing, index into mixPartialOffsets */
+			uint32_t partialIndex;
+
+			/* Did anything get mixed into inputCache this update? */
+			uint8_t inputActive;
 		} mix;
 		struct
 		{
@@ -568,7 +851,13 @@ void FAudio_INTERNAL_InsertSubmixSorted(
 	FAudioMallocFunc pMalloc
 );
 void FAudio_INTERNAL_UpdateEngine(FAudio *audio, float *output);
-void FAudio_INTERNAL_ResizeDecodeCache(FAudio *audio, uint32_t size);
+void FAudio_INTERNAL_ReserveMixCaches(FAudioVoice *voice);
+void* FAudio_INTERNAL_SlabAlloc(FAudio *audio, size_t size);
+void* FAudio_INTERNAL_SlabRealloc(FAudio *audio, void *ptr, size_t size);
+void FAudio_INTERNAL_SlabFree(FAudio *audio, void *ptr);
+void FAudio_INTERNAL_SlabDestroy(FAudio *audio);
+void FAudio_INTERNAL_CreateMixWorkers(FAudio *audio, uint32_t count);
+void FAudio_INTERNAL_DestroyMixWorkers(FAudio *audio);
 void FAudio_INTERNAL_AllocEffectChain(
 	FAudioVoice *voice,
 	const FAudioEffectChain *pEffectChain
@@ -592,7 +881,12 @@ extern const float FAUDIO_INTERNAL_MATRIX_DEFAULTS[8][8][64];
 #define LOG_API_EXIT(engine)
 #define LOG_FUNC_ENTER(engine)
 #define LOG_FUNC_EXIT(engine)
-/* TODO: LOG_TIMING */
+#define LOG_TIMING_QUANTUM_BEGIN(engine)
+#define LOG_TIMING_QUANTUM_END(engine)
+#define LOG_TIMING_BEGIN(ctx, stage)
+#define LOG_TIMING_END(ctx, stage)
+#define LOG_TIMING_VOICE_BEGIN(ctx)
+#define LOG_TIMING_VOICE_END(voice, ctx)
 #define LOG_MUTEX_CREATE(engine, mutex)
 #define LOG_MUTEX_DESTROY(engine, mutex)
 #define LOG_MUTEX_LOCK(engine, mutex)
@@ -634,6 +928,9 @@ void FAudio_INTERNAL_debug_fmt(
 	const char *func,
 	const FAudioWaveFormatEx *fmt
 );
+void FAudio_INTERNAL_BeginQuantumTiming(FAudio *audio);
+void FAudio_INTERNAL_EndQuantumTiming(FAudio *audio);
+void FAudio_INTERNAL_TimeVoice(FAudioVoice *voice, FAudioMixContext *ctx);
 
 #define PRINT_DEBUG(engine, cond, type, fmt, ...) \
 	if (engine->debug.TraceMask & FAUDIO_LOG_##cond) \
@@ -656,7 +953,24 @@ void FAudio_INTERNAL_debug_fmt(
 #define LOG_API_EXIT(engine) PRINT_DEBUG(engine, API_CALLS, "API Exit", "%s", __func__)
 #define LOG_FUNC_ENTER(engine) PRINT_DEBUG(engine, FUNC_CALLS, "FUNC Enter", "%s", __func__)
 #define LOG_FUNC_EXIT(engine) PRINT_DEBUG(engine, FUNC_CALLS, "FUNC Exit", "%s", __func__)
-/* TODO: LOG_TIMING */
+#define LOG_TIMING_QUANTUM_BEGIN(engine) FAudio_INTERNAL_BeginQuantumTiming(engine);
+#define LOG_TIMING_QUANTUM_END(engine) FAudio_INTERNAL_EndQuantumTiming(engine);
+#define LOG_TIMING_BEGIN(ctx, stage) \
+	if ((ctx)->timingEnabled) \
+	{ \
+		(ctx)->timingStart[stage] = FAudio_timens(); \
+	}
+#define LOG_TIMING_END(ctx, stage) \
+	if ((ctx)->timingEnabled) \
+	{ \
+		(ctx)->timingStage[stage] += FAudio_timens() - (ctx)->timingStart[stage]; \
+	}
+#define LOG_TIMING_VOICE_BEGIN(ctx) LOG_TIMING_BEGIN(ctx, FAUDIO_TIMING_VOICE)
+#define LOG_TIMING_VOICE_END(voice, ctx) \
+	if ((ctx)->timingEnabled) \
+	{ \
+		FAudio_INTERNAL_TimeVoice(voice, ctx); \
+	}
 #define LOG_MUTEX_CREATE(engine, mutex) PRINT_DEBUG(engine, LOCKS, "Mutex Create", "%p (%s)", mutex, #mutex)
 #define LOG_MUTEX_DESTROY(engine, mutex) PRINT_DEBUG(engine, LOCKS, "Mutex Destroy", "%p (%s)", mutex, #mutex)
 #define LOG_MUTEX_LOCK(engine, mutex) PRINT_DEBUG(engine, LOCKS, "Mutex Lock", "%p (%s)", mutex, #mutex)
@@ -729,6 +1043,24 @@ extern void FAudio_INTERNAL_ResampleGeneric(
 	uint8_t channels
 );
 
+/* The sinc resamplers read FAUDIO_SINC_HISTORY frames before dCache, and run
+ * FAUDIO_SINC_DELAY frames behind the linear resamplers so that they need no
+ * more than the usual EXTRA_DECODE_PADDING after it.
+ */
+#define FAUDIO_SINC_TAPS 16
+#define FAUDIO_SINC_DELAY (FAUDIO_SINC_TAPS / 2 - 1)
+#define FAUDIO_SINC_HISTORY (FAUDIO_SINC_TAPS - 2)
+extern FAudioResampleCallback FAudio_INTERNAL_ResampleSincMono;
+extern FAudioResampleCallback FAudio_INTERNAL_ResampleSincStereo;
+extern void FAudio_INTERNAL_ResampleSincGeneric(
+	float *restrict dCache,
+	float *restrict resampleCache,
+	uint64_t *resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint8_t channels
+);
+
 extern void (*FAudio_INTERNAL_Amplify)(
 	float *output,
 	uint32_t totalSamples,
@@ -736,6 +1068,14 @@ extern void (*FAudio_INTERNAL_Amplify)(
 );
 
 extern FAudioMixCallback FAudio_INTERNAL_Mix_Generic;
+extern FAudioMixCallback FAudio_INTERNAL_Mix_1in_1out;
+extern FAudioMixCallback FAudio_INTERNAL_Mix_1in_2out;
+extern FAudioMixCallback FAudio_INTERNAL_Mix_1in_6out;
+extern FAudioMixCallback FAudio_INTERNAL_Mix_1in_8out;
+extern FAudioMixCallback FAudio_INTERNAL_Mix_2in_1out;
+extern FAudioMixCallback FAudio_INTERNAL_Mix_2in_2out;
+extern FAudioMixCallback FAudio_INTERNAL_Mix_2in_6out;
+extern FAudioMixCallback FAudio_INTERNAL_Mix_2in_8out;
 
 #define MIX_FUNC(type) \
 	extern void FAudio_INTERNAL_Mix_##type##_Scalar( \
@@ -757,7 +1097,81 @@ MIX_FUNC(2in_6out)
 MIX_FUNC(2in_8out)
 #undef MIX_FUNC
 
-void FAudio_INTERNAL_InitSIMDFunctions(uint8_t hasSSE2, uint8_t hasNEON);
+void FAudio_INTERNAL_BuildSendPlan(
+	FAudioSendPlan *plan,
+	uint32_t srcChans,
+	uint32_t dstChans,
+	const float *coefficients
+);
+void FAudio_INTERNAL_Mix_Sparse(
+	uint32_t toMix,
+	uint32_t srcChans,
+	uint32_t dstChans,
+	float *restrict srcData,
+	float *restrict dstData,
+	const FAudioSendPlan *plan
+);
+
+/* Decodes whole MSADPCM blocks into interleaved PCM16, 1 or 2 channels */
+extern void (*FAudio_INTERNAL_DecodeMSADPCMBlocks)(
+	const uint8_t *restrict buf,
+	int16_t *restrict output,
+	uint32_t blocks,
+	uint32_t align,
+	uint32_t channels
+);
+extern void FAudio_INTERNAL_DecodeMSADPCMBlocks_Scalar(
+	const uint8_t *restrict buf,
+	int16_t *restrict output,
+	uint32_t blocks,
+	uint32_t align,
+	uint32_t channels
+);
+
+/* A bank of FAudioFX reverb comb filters sharing one input. Each lane is a
+ * delay line with a first-order high shelf and low shelf in its feedback
+ * path. The caller points read/write at each lane's delay line, which must be
+ * contiguous for the whole call and at least 4 samples long; out receives
+ * the sum of the lanes' delay outputs.
+ */
+#define FAUDIO_COMB_BANK_SIZE 8
+typedef struct FAudioCombBank
+{
+	const float *read[FAUDIO_COMB_BANK_SIZE];
+	float *write[FAUDIO_COMB_BANK_SIZE];
+	float feedback[FAUDIO_COMB_BANK_SIZE];
+	float high_a0[FAUDIO_COMB_BANK_SIZE];
+	float high_a1[FAUDIO_COMB_BANK_SIZE];
+	float high_b1[FAUDIO_COMB_BANK_SIZE];
+	float high_c0[FAUDIO_COMB_BANK_SIZE];
+	float high_d0[FAUDIO_COMB_BANK_SIZE];
+	float high_state[FAUDIO_COMB_BANK_SIZE];
+	float low_a0[FAUDIO_COMB_BANK_SIZE];
+	float low_a1[FAUDIO_COMB_BANK_SIZE];
+	float low_b1[FAUDIO_COMB_BANK_SIZE];
+	float low_c0[FAUDIO_COMB_BANK_SIZE];
+	float low_d0[FAUDIO_COMB_BANK_SIZE];
+	float low_state[FAUDIO_COMB_BANK_SIZE];
+} FAudioCombBank;
+extern void (*FAudio_INTERNAL_ProcessCombBank)(
+	FAudioCombBank *bank,
+	const float *restrict in,
+	float *restrict out,
+	uint32_t samples
+);
+extern void FAudio_INTERNAL_ProcessCombBank_Scalar(
+	FAudioCombBank *bank,
+	const float *restrict in,
+	float *restrict out,
+	uint32_t samples
+);
+
+void FAudio_INTERNAL_InitSIMDFunctions(
+	uint8_t hasSSE2,
+	uint8_t hasNEON,
+	uint8_t hasAVX2,
+	uint8_t hasAVX512F
+);
 
 /* Decoders */
 
@@ -776,8 +1190,54 @@ DECODE_FUNC(PCM32F)
 DECODE_FUNC(MonoMSADPCM)
 DECODE_FUNC(StereoMSADPCM)
 DECODE_FUNC(WMAERROR)
+#ifndef DISABLE_XNASONG
+DECODE_FUNC(Vorbis)
+DECODE_FUNC(QOA)
+#endif /* DISABLE_XNASONG */
 #undef DECODE_FUNC
 
+/* Vorbis/QOA decoding, see "extensions/CompressedVoiceEXT.txt".
+ * The codecs are built along with XNA_Song.
+ */
+
+#ifndef DISABLE_XNASONG
+typedef struct FAudioCompressedDecoder
+{
+	uint16_t formatTag;
+	uint16_t channels;
+	uint32_t length;	/* Total samples in the file */
+
+	/* Vorbis, position is the next sample the decoder will produce.
+	 * lookahead holds the last lookaheadCount samples before position, so
+	 * the mixer reading EXTRA_DECODE_PADDING past the buffer offset doesn't
+	 * make the next update seek back.
+	 */
+	struct stb_vorbis *vorbis;
+	uint32_t position;
+	float *lookahead;
+	uint32_t lookaheadCount;
+
+	/* QOA, frameData holds frameSamples samples of frame number frame */
+	struct qoa *qoa;
+	uint32_t frame;
+	uint32_t frameSamples;
+	int16_t *frameData;
+} FAudioCompressedDecoder;
+
+FAudioCompressedDecoder* FAudio_INTERNAL_OpenCompressed(
+	FAudioSourceVoice *voice,
+	const FAudioBuffer *buffer
+);
+void FAudio_INTERNAL_CloseCompressed(
+	FAudio *audio,
+	FAudioCompressedDecoder *decoder
+);
+void FAudio_INTERNAL_DecodeCompressedEntire(
+	FAudioCompressedDecoder *decoder,
+	void *pcm
+);
+#endif /* DISABLE_XNASONG */
+
 /* WMA decoding */
 
 #ifdef HAVE_WMADEC
@@ -788,6 +1248,7 @@ void FAudio_WMADEC_end_buffer(FAudioSourceVoice *voice);
 
 /* Platform Functions */
 
+void FAudio_PlatformInitSIMD(void);
 void FAudio_PlatformAddRef(void);
 void FAudio_PlatformRelease(void);
 void FAudio_PlatformInit(
@@ -820,11 +1281,31 @@ FAudioMutex FAudio_PlatformCreateMutex(void);
 void FAudio_PlatformDestroyMutex(FAudioMutex mutex);
 void FAudio_PlatformLockMutex(FAudioMutex mutex);
 void FAudio_PlatformUnlockMutex(FAudioMutex mutex);
+FAudioSemaphore FAudio_PlatformCreateSemaphore(uint32_t initialValue);
+void FAudio_PlatformDestroySemaphore(FAudioSemaphore semaphore);
+void FAudio_PlatformWaitSemaphore(FAudioSemaphore semaphore);
+void FAudio_PlatformWaitSemaphoreTimeout(
+	FAudioSemaphore semaphore,
+	uint32_t timeoutMS
+);
+void FAudio_PlatformSignalSemaphore(FAudioSemaphore semaphore);
+uint32_t FAudio_PlatformGetCPUCount(void);
+int32_t FAudio_PlatformAtomicGet(FAudioAtomic *atomic);
+void FAudio_PlatformAtomicSet(FAudioAtomic *atomic, int32_t value);
+int32_t FAudio_PlatformAtomicAdd(FAudioAtomic *atomic, int32_t value);
+void* FAudio_PlatformAtomicGetPtr(void **ptr);
+void FAudio_PlatformAtomicSetPtr(void **ptr, void *value);
 void FAudio_sleep(uint32_t ms);
 
 /* Time */
 
 uint32_t FAudio_timems(void);
+uint64_t FAudio_timens(void);
+
+/* Memory-mapped files, NULL if the platform or the file can't do it */
+
+void* FAudio_PlatformMapFile(const char *path, size_t *size);
+void FAudio_PlatformUnmapFile(void *mem, size_t size);
 
 /* WaveFormatExtensible Helpers */
 
@@ -73,6 +73,27 @@
 #define HAVE_SSE2_INTRINSICS 1
 #endif
 
+/* AVX2/FMA and AVX-512 paths are compiled per-function and picked at runtime,
+ * so the rest of the library can still be built for baseline x86_64.
+ */
+#if HAVE_SSE2_INTRINSICS && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)) && !defined(__arm64ec__) && !defined(_M_ARM64EC)
+	#if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+		#include <immintrin.h>
+		#include <cpuid.h>
+		#define FAUDIO_TARGET_AVX2 __attribute__((target("avx2,fma")))
+		#define FAUDIO_TARGET_AVX512F __attribute__((target("avx512f")))
+		#define HAVE_AVX2_INTRINSICS 1
+		#define HAVE_AVX512F_INTRINSICS 1
+	#elif defined(_MSC_VER) && _MSC_VER >= 1910
+		#include <immintrin.h>
+		#include <intrin.h>
+		#define FAUDIO_TARGET_AVX2
+		#define FAUDIO_TARGET_AVX512F
+		#define HAVE_AVX2_INTRINSICS 1
+		#define HAVE_AVX512F_INTRINSICS 1
+	#endif
+#endif
+
 /* SECTION 1: Type Converters */
 
 /* The SSE/NEON converters are based on SDL_audiotypecvt:
@@ -256,6 +277,161 @@ void FAudio_INTERNAL_Convert_S32_To_F32_SSE2(
 }
 #endif /* HAVE_SSE2_INTRINSICS */
 
+#if HAVE_AVX2_INTRINSICS
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_Convert_U8_To_F32_AVX2(
+	const uint8_t *restrict src,
+	float *restrict dst,
+	uint32_t len
+) {
+	uint32_t i;
+	const __m256 divby128 = _mm256_set1_ps(DIVBY128);
+	const __m256 minus1 = _mm256_set1_ps(-1.0f);
+	for (i = 0; i + 8 <= len; i += 8)
+	{
+		/* Zero-extend 8 uint8 to int32, then scale and bias in one go */
+		const __m256i ints = _mm256_cvtepu8_epi32(
+			_mm_loadl_epi64((const __m128i*) (src + i))
+		);
+		_mm256_storeu_ps(
+			dst + i,
+			_mm256_fmadd_ps(_mm256_cvtepi32_ps(ints), divby128, minus1)
+		);
+	}
+	for (; i < len; i += 1)
+	{
+		dst[i] = (src[i] * DIVBY128) - 1.0f;
+	}
+}
+
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_Convert_S16_To_F32_AVX2(
+	const int16_t *restrict src,
+	float *restrict dst,
+	uint32_t len
+) {
+	uint32_t i;
+	const __m256 divby32768 = _mm256_set1_ps(DIVBY32768);
+	for (i = 0; i + 8 <= len; i += 8)
+	{
+		/* Sign-extend 8 int16 to int32 */
+		const __m256i ints = _mm256_cvtepi16_epi32(
+			_mm_loadu_si128((const __m128i*) (src + i))
+		);
+		_mm256_storeu_ps(
+			dst + i,
+			_mm256_mul_ps(_mm256_cvtepi32_ps(ints), divby32768)
+		);
+	}
+	for (; i < len; i += 1)
+	{
+		dst[i] = src[i] * DIVBY32768;
+	}
+}
+
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_Convert_S32_To_F32_AVX2(
+	const int32_t *restrict src,
+	float *restrict dst,
+	uint32_t len
+) {
+	uint32_t i;
+	const __m256 divby8388607 = _mm256_set1_ps(DIVBY8388607);
+	for (i = 0; i + 8 <= len; i += 8)
+	{
+		/* Same 8-bit precision loss as the SSE2 path */
+		const __m256i ints = _mm256_srai_epi32(
+			_mm256_loadu_si256((const __m256i*) (src + i)),
+			8
+		);
+		_mm256_storeu_ps(
+			dst + i,
+			_mm256_mul_ps(_mm256_cvtepi32_ps(ints), divby8388607)
+		);
+	}
+	for (; i < len; i += 1)
+	{
+		dst[i] = (src[i] >> 8) * DIVBY8388607;
+	}
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if HAVE_AVX512F_INTRINSICS
+FAUDIO_TARGET_AVX512F
+void FAudio_INTERNAL_Convert_U8_To_F32_AVX512F(
+	const uint8_t *restrict src,
+	float *restrict dst,
+	uint32_t len
+) {
+	uint32_t i;
+	const __m512 divby128 = _mm512_set1_ps(DIVBY128);
+	const __m512 minus1 = _mm512_set1_ps(-1.0f);
+	for (i = 0; i + 16 <= len; i += 16)
+	{
+		const __m512i ints = _mm512_cvtepu8_epi32(
+			_mm_loadu_si128((const __m128i*) (src + i))
+		);
+		_mm512_storeu_ps(
+			dst + i,
+			_mm512_fmadd_ps(_mm512_cvtepi32_ps(ints), divby128, minus1)
+		);
+	}
+	for (; i < len; i += 1)
+	{
+		dst[i] = (src[i] * DIVBY128) - 1.0f;
+	}
+}
+
+FAUDIO_TARGET_AVX512F
+void FAudio_INTERNAL_Convert_S16_To_F32_AVX512F(
+	const int16_t *restrict src,
+	float *restrict dst,
+	uint32_t len
+) {
+	uint32_t i;
+	const __m512 divby32768 = _mm512_set1_ps(DIVBY32768);
+	for (i = 0; i + 16 <= len; i += 16)
+	{
+		const __m512i ints = _mm512_cvtepi16_epi32(
+			_mm256_loadu_si256((const __m256i*) (src + i))
+		);
+		_mm512_storeu_ps(
+			dst + i,
+			_mm512_mul_ps(_mm512_cvtepi32_ps(ints), divby32768)
+		);
+	}
+	for (; i < len; i += 1)
+	{
+		dst[i] = src[i] * DIVBY32768;
+	}
+}
+
+FAUDIO_TARGET_AVX512F
+void FAudio_INTERNAL_Convert_S32_To_F32_AVX512F(
+	const int32_t *restrict src,
+	float *restrict dst,
+	uint32_t len
+) {
+	uint32_t i;
+	const __m512 divby8388607 = _mm512_set1_ps(DIVBY8388607);
+	for (i = 0; i + 16 <= len; i += 16)
+	{
+		const __m512i ints = _mm512_srai_epi32(
+			_mm512_loadu_si512((const void*) (src + i)),
+			8
+		);
+		_mm512_storeu_ps(
+			dst + i,
+			_mm512_mul_ps(_mm512_cvtepi32_ps(ints), divby8388607)
+		);
+	}
+	for (; i < len; i += 1)
+	{
+		dst[i] = (src[i] >> 8) * DIVBY8388607;
+	}
+}
+#endif /* HAVE_AVX512F_INTRINSICS */
+
 #if HAVE_NEON_INTRINSICS
 void FAudio_INTERNAL_Convert_U8_To_F32_NEON(
 	const uint8_t *restrict src,
@@ -523,6 +699,11 @@ void FAudio_INTERNAL_ResampleMono_SSE2(
 	{
 		header = 0;
 	}
+	if (header > toResample)
+	{
+		/* Too short to ever reach the aligned loop */
+		header = (uint32_t) toResample;
+	}
 	for (i = 0; i < header; i += 1)
 	{
 		/* lerp, then convert to float value */
@@ -693,6 +874,11 @@ void FAudio_INTERNAL_ResampleStereo_SSE2(
 	{
 		header = 0;
 	}
+	if (header > toResample)
+	{
+		/* Too short to ever reach the aligned loop */
+		header = (uint32_t) toResample;
+	}
 	cur_scalar = *resampleOffset & FIXED_FRACTION_MASK;
 	for (i = 0; i < header; i += 2)
 	{
@@ -843,6 +1029,273 @@ void FAudio_INTERNAL_ResampleStereo_SSE2(
 }
 #endif /* HAVE_SSE2_INTRINSICS */
 
+/* The AVX2 resamplers follow the SSE2 ones, eight output samples at a time */
+
+#if HAVE_AVX2_INTRINSICS
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_ResampleMono_AVX2(
+	float *restrict dCache,
+	float *restrict resampleCache,
+	uint64_t *resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint8_t UNUSED
+) {
+	uint32_t i, j, tail;
+	uint64_t steps[8];
+	float *src[8];
+	uint64_t cur_scalar = *resampleOffset & FIXED_FRACTION_MASK;
+	__m128 current_next_0_1, current_next_2_3, current_next_4_5, current_next_6_7;
+	__m256 one_over_fixed_one, half, current_next_lo, current_next_hi,
+		current, next, cur_fixed, res;
+	__m256i cur_frac, adder_frac_loop;
+
+	for (j = 0; j < 8; j += 1)
+	{
+		steps[j] = resampleStep * j;
+	}
+
+	/* See the SSE2 mono resampler for the 0.5 trick */
+	cur_frac = _mm256_add_epi32(
+		_mm256_set1_epi32(
+			(uint32_t) (cur_scalar & FIXED_FRACTION_MASK) - DOUBLE_TO_FIXED(0.5)
+		),
+		_mm256_setr_epi32(
+			(uint32_t) steps[0],
+			(uint32_t) steps[1],
+			(uint32_t) steps[2],
+			(uint32_t) steps[3],
+			(uint32_t) steps[4],
+			(uint32_t) steps[5],
+			(uint32_t) steps[6],
+			(uint32_t) steps[7]
+		)
+	);
+	adder_frac_loop = _mm256_set1_epi32(
+		(uint32_t) ((resampleStep * 8) & FIXED_FRACTION_MASK)
+	);
+
+	/* Constants */
+	one_over_fixed_one = _mm256_set1_ps(1.0f / FIXED_ONE);
+	half = _mm256_set1_ps(0.5f);
+
+	tail = toResample % 8;
+	for (i = 0; i < toResample - tail; i += 8, resampleCache += 8)
+	{
+		for (j = 0; j < 8; j += 1)
+		{
+			src[j] = dCache + ((cur_scalar + steps[j]) >> FIXED_PRECISION);
+		}
+
+		/* Gather the (current, next) pairs, with lanes 0-1 and 4-5 in
+		 * one vector and lanes 2-3 and 6-7 in the other, so that the
+		 * in-lane shuffles below leave everything in order.
+		 */
+		current_next_0_1 = _mm_loadl_pi(_mm_setzero_ps(), (__m64*) src[0]);
+		current_next_0_1 = _mm_loadh_pi(current_next_0_1, (__m64*) src[1]);
+		current_next_2_3 = _mm_loadl_pi(_mm_setzero_ps(), (__m64*) src[2]);
+		current_next_2_3 = _mm_loadh_pi(current_next_2_3, (__m64*) src[3]);
+		current_next_4_5 = _mm_loadl_pi(_mm_setzero_ps(), (__m64*) src[4]);
+		current_next_4_5 = _mm_loadh_pi(current_next_4_5, (__m64*) src[5]);
+		current_next_6_7 = _mm_loadl_pi(_mm_setzero_ps(), (__m64*) src[6]);
+		current_next_6_7 = _mm_loadh_pi(current_next_6_7, (__m64*) src[7]);
+		current_next_lo = _mm256_insertf128_ps(
+			_mm256_castps128_ps256(current_next_0_1),
+			current_next_4_5,
+			1
+		);
+		current_next_hi = _mm256_insertf128_ps(
+			_mm256_castps128_ps256(current_next_2_3),
+			current_next_6_7,
+			1
+		);
+		current = _mm256_shuffle_ps(current_next_lo, current_next_hi, 0x88);
+		next = _mm256_shuffle_ps(current_next_lo, current_next_hi, 0xdd);
+
+		/* lerp */
+		cur_fixed = _mm256_fmadd_ps(
+			_mm256_cvtepi32_ps(cur_frac),
+			one_over_fixed_one,
+			half
+		);
+		res = _mm256_fmadd_ps(
+			_mm256_sub_ps(next, current),
+			cur_fixed,
+			current
+		);
+		_mm256_storeu_ps(resampleCache, res);
+
+		/* Update dCache for next iteration */
+		cur_scalar += resampleStep * 8;
+		dCache += (cur_scalar >> FIXED_PRECISION);
+		cur_scalar &= FIXED_FRACTION_MASK;
+
+		cur_frac = _mm256_add_epi32(cur_frac, adder_frac_loop);
+	}
+	*resampleOffset += resampleStep * (toResample - tail);
+
+	/* This is the tail. */
+	for (i = 0; i < tail; i += 1)
+	{
+		/* lerp, then convert to float value */
+		*resampleCache++ = (float) (
+			dCache[0] +
+			(dCache[1] - dCache[0]) *
+			FIXED_TO_FLOAT(cur_scalar)
+		);
+
+		/* Increment fraction offset by the stepping value */
+		*resampleOffset += resampleStep;
+		cur_scalar += resampleStep;
+
+		/* Only increment the sample offset by integer values.
+		 * Sometimes this will be 0 until cur accumulates
+		 * enough steps, especially for "slow" rates.
+		 */
+		dCache += (cur_scalar >> FIXED_PRECISION);
+
+		/* Now that any integer has been added, drop it.
+		 * The offset pointer will preserve the total.
+		 */
+		cur_scalar &= FIXED_FRACTION_MASK;
+	}
+}
+
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_ResampleStereo_AVX2(
+	float *restrict dCache,
+	float *restrict resampleCache,
+	uint64_t *resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint8_t UNUSED
+) {
+	uint32_t i, j, tail;
+	uint64_t steps[4];
+	float *src[4];
+	uint64_t cur_scalar = *resampleOffset & FIXED_FRACTION_MASK;
+	__m256 one_over_fixed_one, half, current_next_lo, current_next_hi,
+		current, next, cur_fixed, res;
+	__m256i cur_frac, adder_frac_loop;
+
+	for (j = 0; j < 4; j += 1)
+	{
+		steps[j] = resampleStep * j;
+	}
+
+	/* Both channels of a frame share the same fraction */
+	cur_frac = _mm256_add_epi32(
+		_mm256_set1_epi32(
+			(uint32_t) (cur_scalar & FIXED_FRACTION_MASK) - DOUBLE_TO_FIXED(0.5)
+		),
+		_mm256_setr_epi32(
+			(uint32_t) steps[0],
+			(uint32_t) steps[0],
+			(uint32_t) steps[1],
+			(uint32_t) steps[1],
+			(uint32_t) steps[2],
+			(uint32_t) steps[2],
+			(uint32_t) steps[3],
+			(uint32_t) steps[3]
+		)
+	);
+	adder_frac_loop = _mm256_set1_epi32(
+		(uint32_t) ((resampleStep * 4) & FIXED_FRACTION_MASK)
+	);
+
+	/* Constants */
+	one_over_fixed_one = _mm256_set1_ps(1.0f / FIXED_ONE);
+	half = _mm256_set1_ps(0.5f);
+
+	tail = toResample % 4;
+	for (i = 0; i < toResample - tail; i += 4, resampleCache += 8)
+	{
+		for (j = 0; j < 4; j += 1)
+		{
+			src[j] = dCache + ((cur_scalar + steps[j]) >> FIXED_PRECISION) * 2;
+		}
+
+		/* Each load is (current_ch_1, current_ch_2, next_ch_1, next_ch_2),
+		 * frames 0 and 2 in one vector, frames 1 and 3 in the other.
+		 */
+		current_next_lo = _mm256_insertf128_ps(
+			_mm256_castps128_ps256(_mm_loadu_ps(src[0])),
+			_mm_loadu_ps(src[2]),
+			1
+		);
+		current_next_hi = _mm256_insertf128_ps(
+			_mm256_castps128_ps256(_mm_loadu_ps(src[1])),
+			_mm_loadu_ps(src[3]),
+			1
+		);
+		current = _mm256_castpd_ps(
+			_mm256_unpacklo_pd(
+				_mm256_castps_pd(current_next_lo),
+				_mm256_castps_pd(current_next_hi)
+			)
+		);
+		next = _mm256_castpd_ps(
+			_mm256_unpackhi_pd(
+				_mm256_castps_pd(current_next_lo),
+				_mm256_castps_pd(current_next_hi)
+			)
+		);
+
+		/* lerp */
+		cur_fixed = _mm256_fmadd_ps(
+			_mm256_cvtepi32_ps(cur_frac),
+			one_over_fixed_one,
+			half
+		);
+		res = _mm256_fmadd_ps(
+			_mm256_sub_ps(next, current),
+			cur_fixed,
+			current
+		);
+		_mm256_storeu_ps(resampleCache, res);
+
+		/* Update dCache for next iteration */
+		cur_scalar += resampleStep * 4;
+		dCache += (cur_scalar >> FIXED_PRECISION) * 2;
+		cur_scalar &= FIXED_FRACTION_MASK;
+
+		cur_frac = _mm256_add_epi32(cur_frac, adder_frac_loop);
+	}
+	*resampleOffset += resampleStep * (toResample - tail);
+
+	/* This is the tail. */
+	for (i = 0; i < tail; i += 1)
+	{
+		/* lerp, then convert to float value */
+		*resampleCache++ = (float) (
+			dCache[0] +
+			(dCache[2] - dCache[0]) *
+			FIXED_TO_FLOAT(cur_scalar)
+		);
+		*resampleCache++ = (float) (
+			dCache[1] +
+			(dCache[3] - dCache[1]) *
+			FIXED_TO_FLOAT(cur_scalar)
+		);
+
+		/* Increment fraction offset by the stepping value */
+		*resampleOffset += resampleStep;
+		cur_scalar += resampleStep;
+
+		/* Only increment the sample offset by integer values.
+		 * Sometimes this will be 0 until cur accumulates
+		 * enough steps, especially for "slow" rates.
+		 */
+		dCache += (cur_scalar >> FIXED_PRECISION) * 2;
+
+		/* Now that any integer has been added, drop it.
+		 * The offset pointer will preserve the total.
+		 */
+		cur_scalar &= FIXED_FRACTION_MASK;
+	}
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
 #if HAVE_NEON_INTRINSICS
 void FAudio_INTERNAL_ResampleMono_NEON(
 	float *restrict dCache,
@@ -866,6 +1319,11 @@ void FAudio_INTERNAL_ResampleMono_NEON(
 	{
 		header = 0;
 	}
+	if (header > toResample)
+	{
+		/* Too short to ever reach the aligned loop */
+		header = (uint32_t) toResample;
+	}
 	for (i = 0; i < header; i += 1)
 	{
 		/* lerp, then convert to float value */
@@ -1036,6 +1494,11 @@ void FAudio_INTERNAL_ResampleStereo_NEON(
 	{
 		header = 0;
 	}
+	if (header > toResample)
+	{
+		/* Too short to ever reach the aligned loop */
+		header = (uint32_t) toResample;
+	}
 	cur_scalar = *resampleOffset & FIXED_FRACTION_MASK;
 	for (i = 0; i < header; i += 2)
 	{
@@ -1216,6 +1679,12 @@ void FAudio_INTERNAL_Amplify_SSE2(
 	{
 		tail = 0;
 	}
+	if (header > totalSamples)
+	{
+		/* Too short to ever reach the aligned loop */
+		header = totalSamples;
+		tail = 0;
+	}
 
 	for (i = 0; i < header; i += 1)
 	{
@@ -1237,6 +1706,52 @@ void FAudio_INTERNAL_Amplify_SSE2(
 }
 #endif /* HAVE_SSE2_INTRINSICS */
 
+#if HAVE_AVX2_INTRINSICS
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_Amplify_AVX2(
+	float* output,
+	uint32_t totalSamples,
+	float volume
+) {
+	uint32_t i;
+	const __m256 volumeVec = _mm256_set1_ps(volume);
+	for (i = 0; i + 8 <= totalSamples; i += 8)
+	{
+		_mm256_storeu_ps(
+			output + i,
+			_mm256_mul_ps(_mm256_loadu_ps(output + i), volumeVec)
+		);
+	}
+	for (; i < totalSamples; i += 1)
+	{
+		output[i] *= volume;
+	}
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if HAVE_AVX512F_INTRINSICS
+FAUDIO_TARGET_AVX512F
+void FAudio_INTERNAL_Amplify_AVX512F(
+	float* output,
+	uint32_t totalSamples,
+	float volume
+) {
+	uint32_t i;
+	const __m512 volumeVec = _mm512_set1_ps(volume);
+	for (i = 0; i + 16 <= totalSamples; i += 16)
+	{
+		_mm512_storeu_ps(
+			output + i,
+			_mm512_mul_ps(_mm512_loadu_ps(output + i), volumeVec)
+		);
+	}
+	for (; i < totalSamples; i += 1)
+	{
+		output[i] *= volume;
+	}
+}
+#endif /* HAVE_AVX512F_INTRINSICS */
+
 #if HAVE_NEON_INTRINSICS
 void FAudio_INTERNAL_Amplify_NEON(
 	float* output,
@@ -1255,6 +1770,12 @@ void FAudio_INTERNAL_Amplify_NEON(
 	{
 		tail = 0;
 	}
+	if (header > totalSamples)
+	{
+		/* Too short to ever reach the aligned loop */
+		header = totalSamples;
+		tail = 0;
+	}
 
 	for (i = 0; i < header; i += 1)
 	{
@@ -1344,6 +1865,58 @@ void FAudio_INTERNAL_Mix_Generic_SSE2(
 }
 #endif /* HAVE_SSE2_INTRINSICS */
 
+#if HAVE_AVX2_INTRINSICS
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_Mix_Generic_AVX2(
+	uint32_t toMix,
+	uint32_t srcChans,
+	uint32_t dstChans,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i, co, ci;
+	__m256 sum;
+
+	/* Masked loads pick up the last 1-7 channels, which is all of them for
+	 * the common layouts (quad, 5.1, 7.1) that don't have a fixed mixer.
+	 */
+	const uint32_t remainder = srcChans % 8;
+	const __m256i mask = _mm256_cmpgt_epi32(
+		_mm256_set1_epi32(remainder),
+		_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)
+	);
+
+	for (i = 0; i < toMix; i += 1, src += srcChans, dst += dstChans)
+	for (co = 0; co < dstChans; co += 1)
+	{
+		sum = _mm256_setzero_ps();
+		for (ci = 0; srcChans - ci >= 8; ci += 8)
+		{
+			sum = _mm256_fmadd_ps(
+				_mm256_loadu_ps(&src[ci]),
+				_mm256_loadu_ps(&coefficients[co * srcChans + ci]),
+				sum
+			);
+		}
+		if (remainder > 0)
+		{
+			sum = _mm256_fmadd_ps(
+				_mm256_maskload_ps(&src[ci], mask),
+				_mm256_maskload_ps(&coefficients[co * srcChans + ci], mask),
+				sum
+			);
+		}
+		dst[co] += FAudio_simd_hadd(
+			_mm_add_ps(
+				_mm256_castps256_ps128(sum),
+				_mm256_extractf128_ps(sum, 1)
+			)
+		);
+	}
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
 void FAudio_INTERNAL_Mix_1in_1out_Scalar(
 	uint32_t toMix,
 	uint32_t UNUSED1,
@@ -1543,47 +2116,1870 @@ void FAudio_INTERNAL_Mix_2in_8out_Scalar(
 	}
 }
 
-/* SECTION 5: InitSIMDFunctions. Assigns based on SSE2/NEON support. */
+/* The SSE2 fixed mixers keep the scalar operation order, so they produce the
+ * exact same output. The AVX2 mixers use FMA and may differ in the last bit.
+ * Leftover frames fall back to the scalar mixers.
+ */
 
-void (*FAudio_INTERNAL_Convert_U8_To_F32)(
-	const uint8_t *restrict src,
+#if HAVE_SSE2_INTRINSICS
+void FAudio_INTERNAL_Mix_1in_1out_SSE2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
 	float *restrict dst,
-	uint32_t len
-);
-void (*FAudio_INTERNAL_Convert_S16_To_F32)(
-	const int16_t *restrict src,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	const __m128 c = _mm_set1_ps(coefficients[0]);
+	for (i = 0; i + 4 <= toMix; i += 4, src += 4, dst += 4)
+	{
+		_mm_storeu_ps(dst, _mm_add_ps(
+			_mm_loadu_ps(dst),
+			_mm_mul_ps(_mm_loadu_ps(src), c)
+		));
+	}
+	FAudio_INTERNAL_Mix_1in_1out_Scalar(
+		toMix - i,
+		UNUSED1,
+		UNUSED2,
+		src,
+		dst,
+		coefficients
+	);
+}
+
+void FAudio_INTERNAL_Mix_1in_2out_SSE2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
 	float *restrict dst,
-	uint32_t len
-);
-void (*FAudio_INTERNAL_Convert_S32_To_F32)(
-	const int32_t *restrict src,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	__m128 s;
+	const __m128 c = _mm_setr_ps(
+		coefficients[0], coefficients[1],
+		coefficients[0], coefficients[1]
+	);
+	for (i = 0; i + 4 <= toMix; i += 4, src += 4, dst += 8)
+	{
+		s = _mm_loadu_ps(src);
+		_mm_storeu_ps(dst, _mm_add_ps(
+			_mm_loadu_ps(dst),
+			_mm_mul_ps(_mm_unpacklo_ps(s, s), c)
+		));
+		_mm_storeu_ps(dst + 4, _mm_add_ps(
+			_mm_loadu_ps(dst + 4),
+			_mm_mul_ps(_mm_unpackhi_ps(s, s), c)
+		));
+	}
+	FAudio_INTERNAL_Mix_1in_2out_Scalar(
+		toMix - i,
+		UNUSED1,
+		UNUSED2,
+		src,
+		dst,
+		coefficients
+	);
+}
+
+void FAudio_INTERNAL_Mix_1in_6out_SSE2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
 	float *restrict dst,
-	uint32_t len
-);
+	float *restrict coefficients
+) {
+	uint32_t i;
+	__m128 s;
 
-FAudioResampleCallback FAudio_INTERNAL_ResampleMono;
-FAudioResampleCallback FAudio_INTERNAL_ResampleStereo;
+	/* Two frames make three full vectors */
+	const __m128 c0 = _mm_setr_ps(
+		coefficients[0], coefficients[1],
+		coefficients[2], coefficients[3]
+	);
+	const __m128 c1 = _mm_setr_ps(
+		coefficients[4], coefficients[5],
+		coefficients[0], coefficients[1]
+	);
+	const __m128 c2 = _mm_setr_ps(
+		coefficients[2], coefficients[3],
+		coefficients[4], coefficients[5]
+	);
+	for (i = 0; i + 2 <= toMix; i += 2, src += 2, dst += 12)
+	{
+		s = _mm_loadl_pi(_mm_setzero_ps(), (__m64*) src);
+		_mm_storeu_ps(dst, _mm_add_ps(
+			_mm_loadu_ps(dst),
+			_mm_mul_ps(_mm_shuffle_ps(s, s, _MM_SHUFFLE(0, 0, 0, 0)), c0)
+		));
+		_mm_storeu_ps(dst + 4, _mm_add_ps(
+			_mm_loadu_ps(dst + 4),
+			_mm_mul_ps(_mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 1, 0, 0)), c1)
+		));
+		_mm_storeu_ps(dst + 8, _mm_add_ps(
+			_mm_loadu_ps(dst + 8),
+			_mm_mul_ps(_mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 1, 1, 1)), c2)
+		));
+	}
+	FAudio_INTERNAL_Mix_1in_6out_Scalar(
+		toMix - i,
+		UNUSED1,
+		UNUSED2,
+		src,
+		dst,
+		coefficients
+	);
+}
 
-void (*FAudio_INTERNAL_Amplify)(
-	float *output,
-	uint32_t totalSamples,
-	float volume
-);
+void FAudio_INTERNAL_Mix_1in_8out_SSE2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	__m128 s;
+	const __m128 c0 = _mm_loadu_ps(coefficients);
+	const __m128 c1 = _mm_loadu_ps(coefficients + 4);
+	for (i = 0; i < toMix; i += 1, src += 1, dst += 8)
+	{
+		s = _mm_set1_ps(src[0]);
+		_mm_storeu_ps(dst, _mm_add_ps(
+			_mm_loadu_ps(dst),
+			_mm_mul_ps(s, c0)
+		));
+		_mm_storeu_ps(dst + 4, _mm_add_ps(
+			_mm_loadu_ps(dst + 4),
+			_mm_mul_ps(s, c1)
+		));
+	}
+}
 
-FAudioMixCallback FAudio_INTERNAL_Mix_Generic;
+void FAudio_INTERNAL_Mix_2in_1out_SSE2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	__m128 a, b;
+	const __m128 c = _mm_setr_ps(
+		coefficients[0], coefficients[1],
+		coefficients[0], coefficients[1]
+	);
+	for (i = 0; i + 4 <= toMix; i += 4, src += 8, dst += 4)
+	{
+		a = _mm_mul_ps(_mm_loadu_ps(src), c);
+		b = _mm_mul_ps(_mm_loadu_ps(src + 4), c);
+
+		/* Left products plus right products, one frame per lane */
+		_mm_storeu_ps(dst, _mm_add_ps(
+			_mm_loadu_ps(dst),
+			_mm_add_ps(
+				_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)),
+				_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))
+			)
+		));
+	}
+	FAudio_INTERNAL_Mix_2in_1out_Scalar(
+		toMix - i,
+		UNUSED1,
+		UNUSED2,
+		src,
+		dst,
+		coefficients
+	);
+}
 
-void FAudio_INTERNAL_InitSIMDFunctions(uint8_t hasSSE2, uint8_t hasNEON)
-{
-#if HAVE_SSE2_INTRINSICS
-	if (hasSSE2)
+void FAudio_INTERNAL_Mix_2in_2out_SSE2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	__m128 s;
+	const __m128 cl = _mm_setr_ps(
+		coefficients[0], coefficients[2],
+		coefficients[0], coefficients[2]
+	);
+	const __m128 cr = _mm_setr_ps(
+		coefficients[1], coefficients[3],
+		coefficients[1], coefficients[3]
+	);
+	for (i = 0; i + 2 <= toMix; i += 2, src += 4, dst += 4)
 	{
-		FAudio_INTERNAL_Convert_U8_To_F32 = FAudio_INTERNAL_Convert_U8_To_F32_SSE2;
-		FAudio_INTERNAL_Convert_S16_To_F32 = FAudio_INTERNAL_Convert_S16_To_F32_SSE2;
-		FAudio_INTERNAL_Convert_S32_To_F32 = FAudio_INTERNAL_Convert_S32_To_F32_SSE2;
-		FAudio_INTERNAL_ResampleMono = FAudio_INTERNAL_ResampleMono_SSE2;
-		FAudio_INTERNAL_ResampleStereo = FAudio_INTERNAL_ResampleStereo_SSE2;
-		FAudio_INTERNAL_Amplify = FAudio_INTERNAL_Amplify_SSE2;
-		FAudio_INTERNAL_Mix_Generic = FAudio_INTERNAL_Mix_Generic_SSE2;
+		s = _mm_loadu_ps(src);
+		_mm_storeu_ps(dst, _mm_add_ps(
+			_mm_loadu_ps(dst),
+			_mm_add_ps(
+				_mm_mul_ps(_mm_shuffle_ps(s, s, _MM_SHUFFLE(2, 2, 0, 0)), cl),
+				_mm_mul_ps(_mm_shuffle_ps(s, s, _MM_SHUFFLE(3, 3, 1, 1)), cr)
+			)
+		));
+	}
+	FAudio_INTERNAL_Mix_2in_2out_Scalar(
+		toMix - i,
+		UNUSED1,
+		UNUSED2,
+		src,
+		dst,
+		coefficients
+	);
+}
+
+void FAudio_INTERNAL_Mix_2in_6out_SSE2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	__m128 s;
+
+	/* Two frames make three full vectors, see 1in_6out */
+	const __m128 cl0 = _mm_setr_ps(
+		coefficients[0], coefficients[2],
+		coefficients[4], coefficients[6]
+	);
+	const __m128 cl1 = _mm_setr_ps(
+		coefficients[8], coefficients[10],
+		coefficients[0], coefficients[2]
+	);
+	const __m128 cl2 = _mm_setr_ps(
+		coefficients[4], coefficients[6],
+		coefficients[8], coefficients[10]
+	);
+	const __m128 cr0 = _mm_setr_ps(
+		coefficients[1], coefficients[3],
+		coefficients[5], coefficients[7]
+	);
+	const __m128 cr1 = _mm_setr_ps(
+		coefficients[9], coefficients[11],
+		coefficients[1], coefficients[3]
+	);
+	const __m128 cr2 = _mm_setr_ps(
+		coefficients[5], coefficients[7],
+		coefficients[9], coefficients[11]
+	);
+	for (i = 0; i + 2 <= toMix; i += 2, src += 4, dst += 12)
+	{
+		s = _mm_loadu_ps(src);
+		_mm_storeu_ps(dst, _mm_add_ps(
+			_mm_loadu_ps(dst),
+			_mm_add_ps(
+				_mm_mul_ps(_mm_shuffle_ps(s, s, _MM_SHUFFLE(0, 0, 0, 0)), cl0),
+				_mm_mul_ps(_mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 1, 1, 1)), cr0)
+			)
+		));
+		_mm_storeu_ps(dst + 4, _mm_add_ps(
+			_mm_loadu_ps(dst + 4),
+			_mm_add_ps(
+				_mm_mul_ps(_mm_shuffle_ps(s, s, _MM_SHUFFLE(2, 2, 0, 0)), cl1),
+				_mm_mul_ps(_mm_shuffle_ps(s, s, _MM_SHUFFLE(3, 3, 1, 1)), cr1)
+			)
+		));
+		_mm_storeu_ps(dst + 8, _mm_add_ps(
+			_mm_loadu_ps(dst + 8),
+			_mm_add_ps(
+				_mm_mul_ps(_mm_shuffle_ps(s, s, _MM_SHUFFLE(2, 2, 2, 2)), cl2),
+				_mm_mul_ps(_mm_shuffle_ps(s, s, _MM_SHUFFLE(3, 3, 3, 3)), cr2)
+			)
+		));
+	}
+	FAudio_INTERNAL_Mix_2in_6out_Scalar(
+		toMix - i,
+		UNUSED1,
+		UNUSED2,
+		src,
+		dst,
+		coefficients
+	);
+}
+
+void FAudio_INTERNAL_Mix_2in_8out_SSE2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	__m128 l, r;
+	const __m128 cl0 = _mm_setr_ps(
+		coefficients[0], coefficients[2],
+		coefficients[4], coefficients[6]
+	);
+	const __m128 cl1 = _mm_setr_ps(
+		coefficients[8], coefficients[10],
+		coefficients[12], coefficients[14]
+	);
+	const __m128 cr0 = _mm_setr_ps(
+		coefficients[1], coefficients[3],
+		coefficients[5], coefficients[7]
+	);
+	const __m128 cr1 = _mm_setr_ps(
+		coefficients[9], coefficients[11],
+		coefficients[13], coefficients[15]
+	);
+	for (i = 0; i < toMix; i += 1, src += 2, dst += 8)
+	{
+		l = _mm_set1_ps(src[0]);
+		r = _mm_set1_ps(src[1]);
+		_mm_storeu_ps(dst, _mm_add_ps(
+			_mm_loadu_ps(dst),
+			_mm_add_ps(_mm_mul_ps(l, cl0), _mm_mul_ps(r, cr0))
+		));
+		_mm_storeu_ps(dst + 4, _mm_add_ps(
+			_mm_loadu_ps(dst + 4),
+			_mm_add_ps(_mm_mul_ps(l, cl1), _mm_mul_ps(r, cr1))
+		));
+	}
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_AVX2_INTRINSICS
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_Mix_1in_1out_AVX2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	const __m256 c = _mm256_set1_ps(coefficients[0]);
+	for (i = 0; i + 8 <= toMix; i += 8, src += 8, dst += 8)
+	{
+		_mm256_storeu_ps(dst, _mm256_fmadd_ps(
+			_mm256_loadu_ps(src),
+			c,
+			_mm256_loadu_ps(dst)
+		));
+	}
+	FAudio_INTERNAL_Mix_1in_1out_Scalar(
+		toMix - i,
+		UNUSED1,
+		UNUSED2,
+		src,
+		dst,
+		coefficients
+	);
+}
+
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_Mix_1in_2out_AVX2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	__m256 s, lo, hi;
+	const __m256 c = _mm256_setr_ps(
+		coefficients[0], coefficients[1],
+		coefficients[0], coefficients[1],
+		coefficients[0], coefficients[1],
+		coefficients[0], coefficients[1]
+	);
+	for (i = 0; i + 8 <= toMix; i += 8, src += 8, dst += 16)
+	{
+		/* Unpacking works per 128-bit lane, put the halves back in order */
+		s = _mm256_loadu_ps(src);
+		lo = _mm256_unpacklo_ps(s, s);
+		hi = _mm256_unpackhi_ps(s, s);
+		_mm256_storeu_ps(dst, _mm256_fmadd_ps(
+			_mm256_permute2f128_ps(lo, hi, 0x20),
+			c,
+			_mm256_loadu_ps(dst)
+		));
+		_mm256_storeu_ps(dst + 8, _mm256_fmadd_ps(
+			_mm256_permute2f128_ps(lo, hi, 0x31),
+			c,
+			_mm256_loadu_ps(dst + 8)
+		));
+	}
+	FAudio_INTERNAL_Mix_1in_2out_Scalar(
+		toMix - i,
+		UNUSED1,
+		UNUSED2,
+		src,
+		dst,
+		coefficients
+	);
+}
+
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_Mix_1in_6out_AVX2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	__m256 s;
+
+	/* Four frames make three full vectors */
+	const __m256i s0 = _mm256_setr_epi32(0, 0, 0, 0, 0, 0, 1, 1);
+	const __m256i s1 = _mm256_setr_epi32(1, 1, 1, 1, 2, 2, 2, 2);
+	const __m256i s2 = _mm256_setr_epi32(2, 2, 3, 3, 3, 3, 3, 3);
+	const __m256 c0 = _mm256_setr_ps(
+		coefficients[0], coefficients[1], coefficients[2], coefficients[3],
+		coefficients[4], coefficients[5], coefficients[0], coefficients[1]
+	);
+	const __m256 c1 = _mm256_setr_ps(
+		coefficients[2], coefficients[3], coefficients[4], coefficients[5],
+		coefficients[0], coefficients[1], coefficients[2], coefficients[3]
+	);
+	const __m256 c2 = _mm256_setr_ps(
+		coefficients[4], coefficients[5], coefficients[0], coefficients[1],
+		coefficients[2], coefficients[3], coefficients[4], coefficients[5]
+	);
+	for (i = 0; i + 4 <= toMix; i += 4, src += 4, dst += 24)
+	{
+		s = _mm256_castps128_ps256(_mm_loadu_ps(src));
+		_mm256_storeu_ps(dst, _mm256_fmadd_ps(
+			_mm256_permutevar8x32_ps(s, s0),
+			c0,
+			_mm256_loadu_ps(dst)
+		));
+		_mm256_storeu_ps(dst + 8, _mm256_fmadd_ps(
+			_mm256_permutevar8x32_ps(s, s1),
+			c1,
+			_mm256_loadu_ps(dst + 8)
+		));
+		_mm256_storeu_ps(dst + 16, _mm256_fmadd_ps(
+			_mm256_permutevar8x32_ps(s, s2),
+			c2,
+			_mm256_loadu_ps(dst + 16)
+		));
+	}
+	FAudio_INTERNAL_Mix_1in_6out_Scalar(
+		toMix - i,
+		UNUSED1,
+		UNUSED2,
+		src,
+		dst,
+		coefficients
+	);
+}
+
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_Mix_1in_8out_AVX2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	const __m256 c = _mm256_loadu_ps(coefficients);
+	for (i = 0; i < toMix; i += 1, src += 1, dst += 8)
+	{
+		_mm256_storeu_ps(dst, _mm256_fmadd_ps(
+			_mm256_set1_ps(src[0]),
+			c,
+			_mm256_loadu_ps(dst)
+		));
+	}
+}
+
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_Mix_2in_1out_AVX2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	__m256 a, b, sum;
+	const __m256 c = _mm256_setr_ps(
+		coefficients[0], coefficients[1],
+		coefficients[0], coefficients[1],
+		coefficients[0], coefficients[1],
+		coefficients[0], coefficients[1]
+	);
+	for (i = 0; i + 8 <= toMix; i += 8, src += 16, dst += 8)
+	{
+		a = _mm256_mul_ps(_mm256_loadu_ps(src), c);
+		b = _mm256_mul_ps(_mm256_loadu_ps(src + 8), c);
+
+		/* Frames come out as 0 1 4 5 2 3 6 7, swap the middle pairs */
+		sum = _mm256_add_ps(
+			_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)),
+			_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))
+		);
+		sum = _mm256_castpd_ps(_mm256_permute4x64_pd(
+			_mm256_castps_pd(sum),
+			_MM_SHUFFLE(3, 1, 2, 0)
+		));
+		_mm256_storeu_ps(dst, _mm256_add_ps(_mm256_loadu_ps(dst), sum));
+	}
+	FAudio_INTERNAL_Mix_2in_1out_Scalar(
+		toMix - i,
+		UNUSED1,
+		UNUSED2,
+		src,
+		dst,
+		coefficients
+	);
+}
+
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_Mix_2in_2out_AVX2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	__m256 s;
+	const __m256 cl = _mm256_setr_ps(
+		coefficients[0], coefficients[2],
+		coefficients[0], coefficients[2],
+		coefficients[0], coefficients[2],
+		coefficients[0], coefficients[2]
+	);
+	const __m256 cr = _mm256_setr_ps(
+		coefficients[1], coefficients[3],
+		coefficients[1], coefficients[3],
+		coefficients[1], coefficients[3],
+		coefficients[1], coefficients[3]
+	);
+	for (i = 0; i + 4 <= toMix; i += 4, src += 8, dst += 8)
+	{
+		s = _mm256_loadu_ps(src);
+		_mm256_storeu_ps(dst, _mm256_add_ps(
+			_mm256_loadu_ps(dst),
+			_mm256_fmadd_ps(
+				_mm256_moveldup_ps(s),
+				cl,
+				_mm256_mul_ps(_mm256_movehdup_ps(s), cr)
+			)
+		));
+	}
+	FAudio_INTERNAL_Mix_2in_2out_Scalar(
+		toMix - i,
+		UNUSED1,
+		UNUSED2,
+		src,
+		dst,
+		coefficients
+	);
+}
+
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_Mix_2in_6out_AVX2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	__m256 s;
+
+	/* Four frames make three full vectors, see 1in_6out */
+	const __m256i l0 = _mm256_setr_epi32(0, 0, 0, 0, 0, 0, 2, 2);
+	const __m256i l1 = _mm256_setr_epi32(2, 2, 2, 2, 4, 4, 4, 4);
+	const __m256i l2 = _mm256_setr_epi32(4, 4, 6, 6, 6, 6, 6, 6);
+	const __m256i r0 = _mm256_setr_epi32(1, 1, 1, 1, 1, 1, 3, 3);
+	const __m256i r1 = _mm256_setr_epi32(3, 3, 3, 3, 5, 5, 5, 5);
+	const __m256i r2 = _mm256_setr_epi32(5, 5, 7, 7, 7, 7, 7, 7);
+	const __m256 cl0 = _mm256_setr_ps(
+		coefficients[0], coefficients[2], coefficients[4], coefficients[6],
+		coefficients[8], coefficients[10], coefficients[0], coefficients[2]
+	);
+	const __m256 cl1 = _mm256_setr_ps(
+		coefficients[4], coefficients[6], coefficients[8], coefficients[10],
+		coefficients[0], coefficients[2], coefficients[4], coefficients[6]
+	);
+	const __m256 cl2 = _mm256_setr_ps(
+		coefficients[8], coefficients[10], coefficients[0], coefficients[2],
+		coefficients[4], coefficients[6], coefficients[8], coefficients[10]
+	);
+	const __m256 cr0 = _mm256_setr_ps(
+		coefficients[1], coefficients[3], coefficients[5], coefficients[7],
+		coefficients[9], coefficients[11], coefficients[1], coefficients[3]
+	);
+	const __m256 cr1 = _mm256_setr_ps(
+		coefficients[5], coefficients[7], coefficients[9], coefficients[11],
+		coefficients[1], coefficients[3], coefficients[5], coefficients[7]
+	);
+	const __m256 cr2 = _mm256_setr_ps(
+		coefficients[9], coefficients[11], coefficients[1], coefficients[3],
+		coefficients[5], coefficients[7], coefficients[9], coefficients[11]
+	);
+	for (i = 0; i + 4 <= toMix; i += 4, src += 8, dst += 24)
+	{
+		s = _mm256_loadu_ps(src);
+		_mm256_storeu_ps(dst, _mm256_add_ps(
+			_mm256_loadu_ps(dst),
+			_mm256_fmadd_ps(
+				_mm256_permutevar8x32_ps(s, l0),
+				cl0,
+				_mm256_mul_ps(_mm256_permutevar8x32_ps(s, r0), cr0)
+			)
+		));
+		_mm256_storeu_ps(dst + 8, _mm256_add_ps(
+			_mm256_loadu_ps(dst + 8),
+			_mm256_fmadd_ps(
+				_mm256_permutevar8x32_ps(s, l1),
+				cl1,
+				_mm256_mul_ps(_mm256_permutevar8x32_ps(s, r1), cr1)
+			)
+		));
+		_mm256_storeu_ps(dst + 16, _mm256_add_ps(
+			_mm256_loadu_ps(dst + 16),
+			_mm256_fmadd_ps(
+				_mm256_permutevar8x32_ps(s, l2),
+				cl2,
+				_mm256_mul_ps(_mm256_permutevar8x32_ps(s, r2), cr2)
+			)
+		));
+	}
+	FAudio_INTERNAL_Mix_2in_6out_Scalar(
+		toMix - i,
+		UNUSED1,
+		UNUSED2,
+		src,
+		dst,
+		coefficients
+	);
+}
+
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_Mix_2in_8out_AVX2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	float *restrict coefficients
+) {
+	uint32_t i;
+	const __m256 cl = _mm256_setr_ps(
+		coefficients[0], coefficients[2], coefficients[4], coefficients[6],
+		coefficients[8], coefficients[10], coefficients[12], coefficients[14]
+	);
+	const __m256 cr = _mm256_setr_ps(
+		coefficients[1], coefficients[3], coefficients[5], coefficients[7],
+		coefficients[9], coefficients[11], coefficients[13], coefficients[15]
+	);
+	for (i = 0; i < toMix; i += 1, src += 2, dst += 8)
+	{
+		_mm256_storeu_ps(dst, _mm256_add_ps(
+			_mm256_loadu_ps(dst),
+			_mm256_fmadd_ps(
+				_mm256_set1_ps(src[0]),
+				cl,
+				_mm256_mul_ps(_mm256_set1_ps(src[1]), cr)
+			)
+		));
+	}
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
+/* Sends from a mono emitter panned into 5.1/7.1, or a stereo voice sent to one
+ * side of a surround mix, are mostly zeroes. Those only mix the taps that are
+ * left, in the same order the dense mixers add them.
+ */
+
+void FAudio_INTERNAL_BuildSendPlan(
+	FAudioSendPlan *plan,
+	uint32_t srcChans,
+	uint32_t dstChans,
+	const float *coefficients
+) {
+	uint32_t co, ci;
+
+	FAudio_assert(srcChans * dstChans <= FAUDIO_MAX_SEND_TAPS);
+
+	plan->taps = 0;
+	for (co = 0; co < dstChans; co += 1)
+	for (ci = 0; ci < srcChans; ci += 1)
+	{
+		if (coefficients[co * srcChans + ci] != 0.0f)
+		{
+			plan->src[plan->taps] = (uint8_t) ci;
+			plan->dst[plan->taps] = (uint8_t) co;
+			plan->coefficients[plan->taps] = coefficients[co * srcChans + ci];
+			plan->taps += 1;
+		}
+	}
+
+	/* The fixed mixers are vectorized, so only go sparse for 3/4 zeroes */
+	plan->sparse = (plan->taps * 4 <= srcChans * dstChans);
+}
+
+void FAudio_INTERNAL_Mix_Sparse(
+	uint32_t toMix,
+	uint32_t srcChans,
+	uint32_t dstChans,
+	float *restrict src,
+	float *restrict dst,
+	const FAudioSendPlan *plan
+) {
+	uint32_t i, t;
+	for (i = 0; i < toMix; i += 1, src += srcChans, dst += dstChans)
+	for (t = 0; t < plan->taps; t += 1)
+	{
+		dst[plan->dst[t]] += src[plan->src[t]] * plan->coefficients[t];
+	}
+}
+
+/* SECTION 5: MSADPCM Block Decoders */
+
+/* Each channel of an MSADPCM block is a serial chain, every sample depends on
+ * the one before it. What's independent is the blocks themselves, so the SIMD
+ * decoders work on several blocks (and both channels of stereo blocks) at
+ * once, one chain per lane, and match the scalar decoder bit for bit.
+ */
+
+static inline int16_t FAudio_INTERNAL_ParseNibble(
+	uint8_t nibble,
+	uint8_t predictor,
+	int16_t *delta,
+	int16_t *sample1,
+	int16_t *sample2
+) {
+	static const int32_t AdaptionTable[16] =
+	{
+		230, 230, 230, 230, 307, 409, 512, 614,
+		768, 614, 512, 409, 307, 230, 230, 230
+	};
+	static const int32_t AdaptCoeff_1[7] =
+	{
+		256, 512, 0, 192, 240, 460, 392
+	};
+	static const int32_t AdaptCoeff_2[7] =
+	{
+		0, -256, 0, 64, 0, -208, -232
+	};
+
+	int8_t signedNibble;
+	int32_t sampleInt;
+	int16_t sample;
+
+	signedNibble = (int8_t) nibble;
+	if (signedNibble & 0x08)
+	{
+		signedNibble -= 0x10;
+	}
+
+	sampleInt = (
+		(*sample1 * AdaptCoeff_1[predictor]) +
+		(*sample2 * AdaptCoeff_2[predictor])
+	) / 256;
+	sampleInt += signedNibble * (*delta);
+	sample = FAudio_clamp(sampleInt, -32768, 32767);
+
+	*sample2 = *sample1;
+	*sample1 = sample;
+	*delta = (int16_t) (AdaptionTable[nibble] * (int32_t) (*delta) / 256);
+	if (*delta < 16)
+	{
+		*delta = 16;
+	}
+	return sample;
+}
+
+/* Corrupt data can name a predictor past the end of the coefficient tables */
+#define MSADPCM_MAX_PREDICTOR 6
+
+#define READ(item, type) \
+	item = *((type*) *buf); \
+	*buf += sizeof(type);
+
+static inline void FAudio_INTERNAL_DecodeMonoMSADPCMBlock(
+	const uint8_t **buf,
+	int16_t *blockCache,
+	uint32_t align
+) {
+	uint32_t i;
+
+	/* Temp storage for ADPCM blocks */
+	uint8_t predictor;
+	int16_t delta;
+	int16_t sample1;
+	int16_t sample2;
+
+	/* Preamble */
+	READ(predictor, uint8_t)
+	READ(delta, int16_t)
+	READ(sample1, int16_t)
+	READ(sample2, int16_t)
+	align -= 7;
+	predictor = FAudio_min(predictor, MSADPCM_MAX_PREDICTOR);
+
+	/* Samples */
+	*blockCache++ = sample2;
+	*blockCache++ = sample1;
+	for (i = 0; i < align; i += 1, *buf += 1)
+	{
+		*blockCache++ = FAudio_INTERNAL_ParseNibble(
+			*(*buf) >> 4,
+			predictor,
+			&delta,
+			&sample1,
+			&sample2
+		);
+		*blockCache++ = FAudio_INTERNAL_ParseNibble(
+			*(*buf) & 0x0F,
+			predictor,
+			&delta,
+			&sample1,
+			&sample2
+		);
+	}
+}
+
+static inline void FAudio_INTERNAL_DecodeStereoMSADPCMBlock(
+	const uint8_t **buf,
+	int16_t *blockCache,
+	uint32_t align
+) {
+	uint32_t i;
+
+	/* Temp storage for ADPCM blocks */
+	uint8_t l_predictor;
+	uint8_t r_predictor;
+	int16_t l_delta;
+	int16_t r_delta;
+	int16_t l_sample1;
+	int16_t r_sample1;
+	int16_t l_sample2;
+	int16_t r_sample2;
+
+	/* Preamble */
+	READ(l_predictor, uint8_t)
+	READ(r_predictor, uint8_t)
+	READ(l_delta, int16_t)
+	READ(r_delta, int16_t)
+	READ(l_sample1, int16_t)
+	READ(r_sample1, int16_t)
+	READ(l_sample2, int16_t)
+	READ(r_sample2, int16_t)
+	align -= 14;
+	l_predictor = FAudio_min(l_predictor, MSADPCM_MAX_PREDICTOR);
+	r_predictor = FAudio_min(r_predictor, MSADPCM_MAX_PREDICTOR);
+
+	/* Samples */
+	*blockCache++ = l_sample2;
+	*blockCache++ = r_sample2;
+	*blockCache++ = l_sample1;
+	*blockCache++ = r_sample1;
+	for (i = 0; i < align; i += 1, *buf += 1)
+	{
+		*blockCache++ = FAudio_INTERNAL_ParseNibble(
+			*(*buf) >> 4,
+			l_predictor,
+			&l_delta,
+			&l_sample1,
+			&l_sample2
+		);
+		*blockCache++ = FAudio_INTERNAL_ParseNibble(
+			*(*buf) & 0x0F,
+			r_predictor,
+			&r_delta,
+			&r_sample1,
+			&r_sample2
+		);
+	}
+}
+
+#undef READ
+
+void FAudio_INTERNAL_DecodeMSADPCMBlocks_Scalar(
+	const uint8_t *restrict buf,
+	int16_t *restrict output,
+	uint32_t blocks,
+	uint32_t align,
+	uint32_t channels
+) {
+	const uint32_t blockSamples = ((align / channels) - 6) * 2 * channels;
+	const uint8_t *block = buf;
+	uint32_t i;
+
+	for (i = 0; i < blocks; i += 1, output += blockSamples)
+	{
+		if (channels == 2)
+		{
+			FAudio_INTERNAL_DecodeStereoMSADPCMBlock(&block, output, align);
+		}
+		else
+		{
+			FAudio_INTERNAL_DecodeMonoMSADPCMBlock(&block, output, align);
+		}
+	}
+}
+
+#if HAVE_SSE2_INTRINSICS
+
+/* Eight chains at a time, in two vectors so the two dependency chains can
+ * overlap. That's eight mono blocks or four stereo blocks per group.
+ */
+#define MSADPCM_SSE2_LANES 8
+
+/* The parts of a nibble that don't depend on the chain, for all eight lanes
+ * at once in 16-bit lanes. Both results come back zero-extended to 32 bits,
+ * low four lanes first.
+ */
+static inline void FAudio_INTERNAL_ParseNibbleValues_SSE2(
+	__m128i nibbles,
+	__m128i *signedNibbles,
+	__m128i *adaptions
+) {
+	const __m128i eight = _mm_set1_epi16(8);
+	__m128i signedNibble, distance, sign, adaption;
+
+	signedNibble = _mm_sub_epi16(_mm_xor_si128(nibbles, eight), eight);
+
+	/* AdaptionTable is symmetric around 8, so look it up by distance */
+	distance = _mm_sub_epi16(nibbles, eight);
+	sign = _mm_srai_epi16(distance, 15);
+	distance = _mm_sub_epi16(_mm_xor_si128(distance, sign), sign);
+	adaption = _mm_set1_epi16(230);
+	#define ADAPTION_STEP(below, add) \
+		adaption = _mm_add_epi16( \
+			adaption, \
+			_mm_and_si128( \
+				_mm_cmplt_epi16(distance, _mm_set1_epi16(below)), \
+				_mm_set1_epi16(add) \
+			) \
+		);
+	ADAPTION_STEP(5, 307 - 230)
+	ADAPTION_STEP(4, 409 - 307)
+	ADAPTION_STEP(3, 512 - 409)
+	ADAPTION_STEP(2, 614 - 512)
+	ADAPTION_STEP(1, 768 - 614)
+	#undef ADAPTION_STEP
+
+	signedNibbles[0] = _mm_unpacklo_epi16(signedNibble, _mm_setzero_si128());
+	signedNibbles[1] = _mm_unpackhi_epi16(signedNibble, _mm_setzero_si128());
+	adaptions[0] = _mm_unpacklo_epi16(adaption, _mm_setzero_si128());
+	adaptions[1] = _mm_unpackhi_epi16(adaption, _mm_setzero_si128());
+}
+
+/* The rest of a nibble, for four chains. `samples` holds sample1 in the low
+ * 16 bits of each lane and sample2 in the high 16 bits, so one madd does the
+ * whole prediction. Only the low 16 bits of `delta` are meaningful. SSE2 has
+ * no 32-bit multiply, but every factor here fits in 16 bits, so madd against
+ * a value with a zeroed high half does the job. Returns the unclamped sample.
+ */
+static inline __m128i FAudio_INTERNAL_ParseNibbles_SSE2(
+	__m128i signedNibble,
+	__m128i adaption,
+	__m128i coefficients,
+	__m128i *samples,
+	__m128i *delta
+) {
+	const __m128i round = _mm_set1_epi32(255);
+	__m128i sampleInt, sample;
+
+	/* Same truncating division as the scalar decoder */
+	sampleInt = _mm_madd_epi16(*samples, coefficients);
+	sampleInt = _mm_srai_epi32(
+		_mm_add_epi32(
+			sampleInt,
+			_mm_and_si128(_mm_srai_epi32(sampleInt, 31), round)
+		),
+		8
+	);
+	sampleInt = _mm_add_epi32(
+		sampleInt,
+		_mm_madd_epi16(signedNibble, *delta)
+	);
+
+	/* Clamp, then shift sample1 over to sample2 */
+	sample = _mm_packs_epi32(sampleInt, sampleInt);
+	sample = _mm_unpacklo_epi16(sample, _mm_setzero_si128());
+	*samples = _mm_or_si128(sample, _mm_slli_epi32(*samples, 16));
+
+	/* The low 16 bits are the int16_t cast, then clamp to 16 */
+	*delta = _mm_madd_epi16(adaption, *delta);
+	*delta = _mm_srai_epi32(
+		_mm_add_epi32(
+			*delta,
+			_mm_and_si128(_mm_srai_epi32(*delta, 31), round)
+		),
+		8
+	);
+	*delta = _mm_max_epi16(*delta, _mm_set1_epi32(16));
+
+	return sampleInt;
+}
+
+void FAudio_INTERNAL_DecodeMSADPCMBlocks_SSE2(
+	const uint8_t *restrict buf,
+	int16_t *restrict output,
+	uint32_t blocks,
+	uint32_t align,
+	uint32_t channels
+) {
+	/* Mono steps through the high then low nibble of each byte. Stereo
+	 * takes the high nibble for the left channel and the low nibble for
+	 * the right, which gets pre-shifted so both use the high nibble.
+	 */
+	static const uint8_t monoShifts[8] = { 4, 0, 12, 8, 20, 16, 28, 24 };
+	static const uint8_t stereoShifts[4] = { 4, 12, 20, 28 };
+	static const int32_t AdaptCoeff_1[7] =
+	{
+		256, 512, 0, 192, 240, 460, 392
+	};
+	static const int32_t AdaptCoeff_2[7] =
+	{
+		0, -256, 0, 64, 0, -208, -232
+	};
+
+	const uint32_t blockSamples = ((align / channels) - 6) * 2 * channels;
+	const uint32_t groupBlocks = MSADPCM_SSE2_LANES / channels;
+	const uint32_t dataBytes = align - (7 * channels);
+	const uint8_t *shifts = (channels == 2) ? stereoShifts : monoShifts;
+	const uint32_t wordSteps = (3 - channels) * 4;
+
+	const uint8_t *data[MSADPCM_SSE2_LANES];
+	int16_t *out[MSADPCM_SSE2_LANES];
+	uint32_t preshift[MSADPCM_SSE2_LANES];
+	int32_t coefficients[MSADPCM_SSE2_LANES];
+	int32_t samples[MSADPCM_SSE2_LANES];
+	int32_t deltas[MSADPCM_SSE2_LANES];
+	uint32_t words[MSADPCM_SSE2_LANES];
+
+	/* One vector per step, each with every lane's sample for that step */
+	__m128i decoded[MSADPCM_SSE2_LANES];
+	int16_t partial[MSADPCM_SSE2_LANES];
+	__m128i t[MSADPCM_SSE2_LANES];
+
+	__m128i coefA, coefB, samplesA, samplesB, deltaA, deltaB;
+	__m128i wordsA, wordsB, count, mask, sampleA, sampleB;
+	__m128i signedNibbles[2], adaptions[2];
+	const uint8_t *block;
+	uint32_t lane, chan, predictor, i, step, steps, bytes;
+	int16_t value;
+
+	mask = _mm_set1_epi32(0x0F);
+	while (blocks >= groupBlocks)
+	{
+		/* Preambles, one lane per channel per block */
+		for (lane = 0; lane < MSADPCM_SSE2_LANES; lane += 1)
+		{
+			chan = lane % channels;
+			block = buf + ((lane / channels) * align);
+			predictor = FAudio_min(block[chan], MSADPCM_MAX_PREDICTOR);
+			coefficients[lane] = (int32_t) (
+				((uint32_t) AdaptCoeff_1[predictor] & 0xFFFF) |
+				((uint32_t) AdaptCoeff_2[predictor] << 16)
+			);
+			value = *((int16_t*) (block + channels + (chan * 2)));
+			deltas[lane] = (uint16_t) value;
+			value = *((int16_t*) (block + (channels * 5) + (chan * 2)));
+			output[((lane / channels) * blockSamples) + chan] = value;
+			samples[lane] = (int32_t) ((uint32_t) (uint16_t) value << 16);
+			value = *((int16_t*) (block + (channels * 3) + (chan * 2)));
+			output[((lane / channels) * blockSamples) + channels + chan] = value;
+			samples[lane] |= (uint16_t) value;
+			data[lane] = block + (channels * 7);
+			preshift[lane] = chan * 4;
+		}
+		for (lane = 0; lane < groupBlocks; lane += 1)
+		{
+			out[lane] = output + (lane * blockSamples) + (channels * 2);
+		}
+		coefA = _mm_loadu_si128((__m128i*) coefficients);
+		coefB = _mm_loadu_si128((__m128i*) (coefficients + 4));
+		samplesA = _mm_loadu_si128((__m128i*) samples);
+		samplesB = _mm_loadu_si128((__m128i*) (samples + 4));
+		deltaA = _mm_loadu_si128((__m128i*) deltas);
+		deltaB = _mm_loadu_si128((__m128i*) (deltas + 4));
+
+		/* Four bytes per lane at a time */
+		for (i = 0; i < dataBytes; i += 4)
+		{
+			bytes = FAudio_min(dataBytes - i, 4);
+			for (lane = 0; lane < MSADPCM_SSE2_LANES; lane += 1)
+			{
+				if (bytes == 4)
+				{
+					/* Blocks can start at any byte */
+					FAudio_memcpy(&words[lane], data[lane] + i, 4);
+				}
+				else
+				{
+					/* Never read past the end of the block */
+					for (words[lane] = 0, step = 0; step < bytes; step += 1)
+					{
+						words[lane] |= (uint32_t) data[lane][i + step] << (step * 8);
+					}
+				}
+				words[lane] <<= preshift[lane];
+			}
+			wordsA = _mm_setr_epi32(words[0], words[1], words[2], words[3]);
+			wordsB = _mm_setr_epi32(words[4], words[5], words[6], words[7]);
+
+			steps = bytes * wordSteps / 4;
+			for (step = 0; step < steps; step += 1)
+			{
+				count = _mm_cvtsi32_si128(shifts[step]);
+				FAudio_INTERNAL_ParseNibbleValues_SSE2(
+					_mm_packs_epi32(
+						_mm_and_si128(_mm_srl_epi32(wordsA, count), mask),
+						_mm_and_si128(_mm_srl_epi32(wordsB, count), mask)
+					),
+					signedNibbles,
+					adaptions
+				);
+				sampleA = FAudio_INTERNAL_ParseNibbles_SSE2(
+					signedNibbles[0],
+					adaptions[0],
+					coefA,
+					&samplesA,
+					&deltaA
+				);
+				sampleB = FAudio_INTERNAL_ParseNibbles_SSE2(
+					signedNibbles[1],
+					adaptions[1],
+					coefB,
+					&samplesB,
+					&deltaB
+				);
+				decoded[step] = _mm_packs_epi32(sampleA, sampleB);
+			}
+			for (; step < wordSteps; step += 1)
+			{
+				decoded[step] = _mm_setzero_si128();
+			}
+
+			/* Transpose, so each block's samples are contiguous */
+			if (channels == 2)
+			{
+				/* Left/right pairs stay together as 32-bit values */
+				t[0] = _mm_unpacklo_epi32(decoded[0], decoded[1]);
+				t[1] = _mm_unpackhi_epi32(decoded[0], decoded[1]);
+				t[2] = _mm_unpacklo_epi32(decoded[2], decoded[3]);
+				t[3] = _mm_unpackhi_epi32(decoded[2], decoded[3]);
+				decoded[0] = _mm_unpacklo_epi64(t[0], t[2]);
+				decoded[1] = _mm_unpackhi_epi64(t[0], t[2]);
+				decoded[2] = _mm_unpacklo_epi64(t[1], t[3]);
+				decoded[3] = _mm_unpackhi_epi64(t[1], t[3]);
+			}
+			else
+			{
+				t[0] = _mm_unpacklo_epi16(decoded[0], decoded[1]);
+				t[1] = _mm_unpackhi_epi16(decoded[0], decoded[1]);
+				t[2] = _mm_unpacklo_epi16(decoded[2], decoded[3]);
+				t[3] = _mm_unpackhi_epi16(decoded[2], decoded[3]);
+				t[4] = _mm_unpacklo_epi16(decoded[4], decoded[5]);
+				t[5] = _mm_unpackhi_epi16(decoded[4], decoded[5]);
+				t[6] = _mm_unpacklo_epi16(decoded[6], decoded[7]);
+				t[7] = _mm_unpackhi_epi16(decoded[6], decoded[7]);
+				decoded[0] = _mm_unpacklo_epi32(t[0], t[2]);
+				decoded[1] = _mm_unpackhi_epi32(t[0], t[2]);
+				decoded[2] = _mm_unpacklo_epi32(t[4], t[6]);
+				decoded[3] = _mm_unpackhi_epi32(t[4], t[6]);
+				decoded[4] = _mm_unpacklo_epi32(t[1], t[3]);
+				decoded[5] = _mm_unpackhi_epi32(t[1], t[3]);
+				decoded[6] = _mm_unpacklo_epi32(t[5], t[7]);
+				decoded[7] = _mm_unpackhi_epi32(t[5], t[7]);
+				t[0] = _mm_unpacklo_epi64(decoded[0], decoded[2]);
+				t[1] = _mm_unpackhi_epi64(decoded[0], decoded[2]);
+				t[2] = _mm_unpacklo_epi64(decoded[1], decoded[3]);
+				t[3] = _mm_unpackhi_epi64(decoded[1], decoded[3]);
+				t[4] = _mm_unpacklo_epi64(decoded[4], decoded[6]);
+				t[5] = _mm_unpackhi_epi64(decoded[4], decoded[6]);
+				t[6] = _mm_unpacklo_epi64(decoded[5], decoded[7]);
+				t[7] = _mm_unpackhi_epi64(decoded[5], decoded[7]);
+				for (lane = 0; lane < MSADPCM_SSE2_LANES; lane += 1)
+				{
+					decoded[lane] = t[lane];
+				}
+			}
+
+			/* Either way, that's steps * channels samples per block */
+			steps *= channels;
+			for (lane = 0; lane < groupBlocks; lane += 1)
+			{
+				if (steps == 8)
+				{
+					_mm_storeu_si128((__m128i*) out[lane], decoded[lane]);
+				}
+				else
+				{
+					_mm_storeu_si128((__m128i*) partial, decoded[lane]);
+					for (step = 0; step < steps; step += 1)
+					{
+						out[lane][step] = partial[step];
+					}
+				}
+				out[lane] += steps;
+			}
+		}
+
+		buf += groupBlocks * align;
+		output += groupBlocks * blockSamples;
+		blocks -= groupBlocks;
+	}
+
+	/* Whatever doesn't fill a group */
+	FAudio_INTERNAL_DecodeMSADPCMBlocks_Scalar(
+		buf,
+		output,
+		blocks,
+		align,
+		channels
+	);
+}
+
+#undef MSADPCM_SSE2_LANES
+
+#endif /* HAVE_SSE2_INTRINSICS */
+
+/* SECTION 6: Windowed Sinc Resamplers */
+
+/* Kaiser-windowed sinc, FAUDIO_SINC_TAPS taps wide. Each table is a bank of
+ * SINC_PHASES filters, one per fraction of an input frame, and the kernels
+ * lerp between neighboring phases. Every row holds a phase's coefficients
+ * followed by their difference to the next phase's, so that lerp only ever
+ * needs the one row.
+ *
+ * Upsampling uses a cutoff at the input's Nyquist frequency, so phase 0 is a
+ * unit impulse and integer positions come out unchanged. Downsampling lowers
+ * the cutoff to the output's Nyquist frequency to keep aliasing down, which
+ * takes one table per ratio; ratios are rounded up to the next table.
+ */
+
+#define SINC_PHASE_BITS 7
+#define SINC_PHASES (1 << SINC_PHASE_BITS)
+#define SINC_PHASE_SHIFT (FIXED_PRECISION - SINC_PHASE_BITS)
+#define SINC_PHASE_MASK ((1ULL << SINC_PHASE_SHIFT) - 1)
+#define SINC_PHASE_SCALE (1.0f / (1ULL << SINC_PHASE_SHIFT))
+#define SINC_ROW (FAUDIO_SINC_TAPS * 2)
+#define SINC_RATIOS 6
+#define SINC_KAISER_BETA 6.0
+#define SINC_PI 3.14159265358979323846
+
+static const double FAudio_INTERNAL_SincRatios[SINC_RATIOS] =
+{
+	1.0, 1.25, 1.5, 2.0, 3.0, 4.0
+};
+static float FAudio_INTERNAL_SincTables[SINC_RATIOS][SINC_PHASES * SINC_ROW];
+static uint64_t FAudio_INTERNAL_SincSteps[SINC_RATIOS];
+static uint8_t FAudio_INTERNAL_SincTablesReady = 0;
+
+static double FAudio_INTERNAL_BesselI0(double x)
+{
+	double sum = 1.0, term = 1.0, y = x * x / 4.0;
+	uint32_t k;
+	for (k = 1; k < 32; k += 1)
+	{
+		term *= y / (double) (k * k);
+		sum += term;
+	}
+	return sum;
+}
+
+static void FAudio_INTERNAL_InitSincTables()
+{
+	double coefficients[SINC_PHASES + 1][FAUDIO_SINC_TAPS];
+	double cutoff, x, w, sum;
+	uint32_t i, p, k;
+	float *row;
+
+	for (i = 0; i < SINC_RATIOS; i += 1)
+	{
+		cutoff = 1.0 / FAudio_INTERNAL_SincRatios[i];
+		for (p = 0; p <= SINC_PHASES; p += 1)
+		{
+			sum = 0.0;
+			for (k = 0; k < FAUDIO_SINC_TAPS; k += 1)
+			{
+				/* Distance from this tap to the delayed output */
+				x = (double) k - FAUDIO_SINC_DELAY - (double) p / SINC_PHASES;
+				w = x / (FAUDIO_SINC_TAPS / 2);
+				w = (w * w >= 1.0) ? 0.0 : (
+					FAudio_INTERNAL_BesselI0(SINC_KAISER_BETA * FAudio_sqrt(1.0 - w * w)) /
+					FAudio_INTERNAL_BesselI0(SINC_KAISER_BETA)
+				);
+				coefficients[p][k] = w * ((x == 0.0) ?
+					cutoff :
+					FAudio_sin(SINC_PI * cutoff * x) / (SINC_PI * x)
+				);
+				sum += coefficients[p][k];
+			}
+
+			/* Unity gain at DC for every phase */
+			for (k = 0; k < FAUDIO_SINC_TAPS; k += 1)
+			{
+				coefficients[p][k] /= sum;
+			}
+		}
+
+		for (p = 0; p < SINC_PHASES; p += 1)
+		{
+			row = FAudio_INTERNAL_SincTables[i] + p * SINC_ROW;
+			for (k = 0; k < FAUDIO_SINC_TAPS; k += 1)
+			{
+				row[k] = (float) coefficients[p][k];
+				row[FAUDIO_SINC_TAPS + k] = (float) (
+					coefficients[p + 1][k] - coefficients[p][k]
+				);
+			}
+		}
+		FAudio_INTERNAL_SincSteps[i] = DOUBLE_TO_FIXED(FAudio_INTERNAL_SincRatios[i]);
+	}
+}
+
+static inline const float *FAudio_INTERNAL_SincTable(uint64_t resampleStep)
+{
+	uint32_t i = 0;
+	while (	i < (SINC_RATIOS - 1) &&
+		resampleStep > FAudio_INTERNAL_SincSteps[i]	)
+	{
+		i += 1;
+	}
+	return FAudio_INTERNAL_SincTables[i];
+}
+
+void FAudio_INTERNAL_ResampleSincGeneric(
+	float *restrict dCache,
+	float *restrict resampleCache,
+	uint64_t *resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint8_t channels
+) {
+	uint32_t i, j, k;
+	float frac, sum;
+	const float *row;
+	const float *table = FAudio_INTERNAL_SincTable(resampleStep);
+	uint64_t cur = *resampleOffset & FIXED_FRACTION_MASK;
+
+	dCache -= FAUDIO_SINC_HISTORY * channels;
+	for (i = 0; i < toResample; i += 1)
+	{
+		row = table + (cur >> SINC_PHASE_SHIFT) * SINC_ROW;
+		frac = (float) (cur & SINC_PHASE_MASK) * SINC_PHASE_SCALE;
+		for (j = 0; j < channels; j += 1)
+		{
+			sum = 0.0f;
+			for (k = 0; k < FAUDIO_SINC_TAPS; k += 1)
+			{
+				sum += dCache[k * channels + j] * (
+					row[k] +
+					row[FAUDIO_SINC_TAPS + k] * frac
+				);
+			}
+			*resampleCache++ = sum;
+		}
+
+		/* Same stepping as the linear resamplers */
+		cur += resampleStep;
+		dCache += (cur >> FIXED_PRECISION) * channels;
+		cur &= FIXED_FRACTION_MASK;
+	}
+
+	/* The whole update in one go, not one step per sample */
+	*resampleOffset += resampleStep * toResample;
+}
+
+#if HAVE_SSE2_INTRINSICS
+
+/* Four partial sums of one mono output */
+static inline __m128 FAudio_INTERNAL_SincMono_SSE2(
+	const float *dCache,
+	const float *row,
+	__m128 frac
+) {
+	uint32_t k;
+	__m128 coefficients, sum = _mm_setzero_ps();
+	for (k = 0; k < FAUDIO_SINC_TAPS; k += 4)
+	{
+		coefficients = _mm_add_ps(
+			_mm_loadu_ps(row + k),
+			_mm_mul_ps(_mm_loadu_ps(row + FAUDIO_SINC_TAPS + k), frac)
+		);
+		sum = _mm_add_ps(
+			sum,
+			_mm_mul_ps(_mm_loadu_ps(dCache + k), coefficients)
+		);
+	}
+	return sum;
+}
+
+/* Partial sums of one stereo output, as L, R, L, R */
+static inline __m128 FAudio_INTERNAL_SincStereo_SSE2(
+	const float *dCache,
+	const float *row,
+	__m128 frac
+) {
+	uint32_t k;
+	__m128 coefficients, sum = _mm_setzero_ps();
+	for (k = 0; k < FAUDIO_SINC_TAPS; k += 4)
+	{
+		coefficients = _mm_add_ps(
+			_mm_loadu_ps(row + k),
+			_mm_mul_ps(_mm_loadu_ps(row + FAUDIO_SINC_TAPS + k), frac)
+		);
+		sum = _mm_add_ps(
+			sum,
+			_mm_mul_ps(
+				_mm_loadu_ps(dCache + k * 2),
+				_mm_unpacklo_ps(coefficients, coefficients)
+			)
+		);
+		sum = _mm_add_ps(
+			sum,
+			_mm_mul_ps(
+				_mm_loadu_ps(dCache + k * 2 + 4),
+				_mm_unpackhi_ps(coefficients, coefficients)
+			)
+		);
+	}
+	return sum;
+}
+
+#define SINC_NEXT(cur, dCache, channels) \
+	row = table + (cur >> SINC_PHASE_SHIFT) * SINC_ROW; \
+	frac = _mm_set1_ps((float) (cur & SINC_PHASE_MASK) * SINC_PHASE_SCALE); \
+	src = dCache; \
+	cur += resampleStep; \
+	dCache += (cur >> FIXED_PRECISION) * channels; \
+	cur &= FIXED_FRACTION_MASK;
+
+void FAudio_INTERNAL_ResampleSincMono_SSE2(
+	float *restrict dCache,
+	float *restrict resampleCache,
+	uint64_t *resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint8_t UNUSED
+) {
+	uint32_t i, tail;
+	const float *row, *src;
+	const float *table = FAudio_INTERNAL_SincTable(resampleStep);
+	uint64_t cur = *resampleOffset & FIXED_FRACTION_MASK;
+	__m128 frac, sum0, sum1, sum2, sum3;
+
+	dCache -= FAUDIO_SINC_HISTORY;
+	tail = toResample % 4;
+
+	/* Four outputs at a time, one transpose to finish all four sums */
+	for (i = 0; i < toResample - tail; i += 4, resampleCache += 4)
+	{
+		SINC_NEXT(cur, dCache, 1)
+		sum0 = FAudio_INTERNAL_SincMono_SSE2(src, row, frac);
+		SINC_NEXT(cur, dCache, 1)
+		sum1 = FAudio_INTERNAL_SincMono_SSE2(src, row, frac);
+		SINC_NEXT(cur, dCache, 1)
+		sum2 = FAudio_INTERNAL_SincMono_SSE2(src, row, frac);
+		SINC_NEXT(cur, dCache, 1)
+		sum3 = FAudio_INTERNAL_SincMono_SSE2(src, row, frac);
+		_MM_TRANSPOSE4_PS(sum0, sum1, sum2, sum3);
+		_mm_storeu_ps(
+			resampleCache,
+			_mm_add_ps(_mm_add_ps(sum0, sum1), _mm_add_ps(sum2, sum3))
+		);
+	}
+	for (i = 0; i < tail; i += 1)
+	{
+		SINC_NEXT(cur, dCache, 1)
+		*resampleCache++ = FAudio_simd_hadd(
+			FAudio_INTERNAL_SincMono_SSE2(src, row, frac)
+		);
+	}
+
+	*resampleOffset += resampleStep * toResample;
+}
+
+void FAudio_INTERNAL_ResampleSincStereo_SSE2(
+	float *restrict dCache,
+	float *restrict resampleCache,
+	uint64_t *resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint8_t UNUSED
+) {
+	uint32_t i, tail;
+	const float *row, *src;
+	const float *table = FAudio_INTERNAL_SincTable(resampleStep);
+	uint64_t cur = *resampleOffset & FIXED_FRACTION_MASK;
+	__m128 frac, sum0, sum1;
+
+	dCache -= FAUDIO_SINC_HISTORY * 2;
+	tail = toResample % 2;
+
+	/* Two frames at a time, folding the even and odd taps together */
+	for (i = 0; i < toResample - tail; i += 2, resampleCache += 4)
+	{
+		SINC_NEXT(cur, dCache, 2)
+		sum0 = FAudio_INTERNAL_SincStereo_SSE2(src, row, frac);
+		SINC_NEXT(cur, dCache, 2)
+		sum1 = FAudio_INTERNAL_SincStereo_SSE2(src, row, frac);
+		_mm_storeu_ps(
+			resampleCache,
+			_mm_add_ps(
+				_mm_movelh_ps(sum0, sum1),
+				_mm_movehl_ps(sum1, sum0)
+			)
+		);
+	}
+	if (tail)
+	{
+		SINC_NEXT(cur, dCache, 2)
+		sum0 = FAudio_INTERNAL_SincStereo_SSE2(src, row, frac);
+		_mm_storel_pi(
+			(__m64*) resampleCache,
+			_mm_add_ps(sum0, _mm_movehl_ps(sum0, sum0))
+		);
+	}
+
+	*resampleOffset += resampleStep * toResample;
+}
+
+#undef SINC_NEXT
+
+#endif /* HAVE_SSE2_INTRINSICS */
+
+/* SECTION 7: Reverb Comb Banks */
+
+/* Every lane's recursion only goes through its own shelves, so the lanes run
+ * side by side; the delay lines are far longer than a call, so a call never
+ * reads what it writes. Both versions do each lane's math in the same order
+ * as FAudioFX_reverb.c always has, and sum the lanes from first to last, so
+ * their output is bit-identical unless the compiler contracts multiply-adds.
+ */
+
+void FAudio_INTERNAL_ProcessCombBank_Scalar(
+	FAudioCombBank *bank,
+	const float *restrict in,
+	float *restrict out,
+	uint32_t samples
+) {
+	uint32_t i, k;
+	const float *read;
+	float *write;
+	float x, result, feedback;
+	float high_state, low_state;
+
+	for (k = 0; k < FAUDIO_COMB_BANK_SIZE; k += 1)
+	{
+		read = bank->read[k];
+		write = bank->write[k];
+		high_state = bank->high_state[k];
+		low_state = bank->low_state[k];
+		for (i = 0; i < samples; i += 1)
+		{
+			x = read[i];
+
+			result = (bank->high_a0[k] * x) + high_state;
+			high_state = (bank->high_a1[k] * x) - (bank->high_b1[k] * result);
+			feedback = (result * bank->high_c0[k]) + (x * bank->high_d0[k]);
+
+			result = (bank->low_a0[k] * feedback) + low_state;
+			low_state = (bank->low_a1[k] * feedback) - (bank->low_b1[k] * result);
+			feedback = (result * bank->low_c0[k]) + (feedback * bank->low_d0[k]);
+
+			write[i] = in[i] + (bank->feedback[k] * feedback);
+			out[i] = (k == 0) ? x : (out[i] + x);
+		}
+		bank->high_state[k] = high_state;
+		bank->low_state[k] = low_state;
+	}
+}
+
+#if HAVE_SSE2_INTRINSICS
+
+/* Four lanes of one time step: x is a column of the lanes' delay outputs, and
+ * the return value is what goes back into the lanes' delay lines.
+ */
+#define COMB_STEP(x, h, l, to_buf) \
+	result = _mm_add_ps(_mm_mul_ps(high_a0##h, x), high_state##h); \
+	high_state##h = _mm_sub_ps( \
+		_mm_mul_ps(high_a1##h, x), \
+		_mm_mul_ps(high_b1##h, result) \
+	); \
+	feedback = _mm_add_ps( \
+		_mm_mul_ps(result, high_c0##h), \
+		_mm_mul_ps(x, high_d0##h) \
+	); \
+	result = _mm_add_ps(_mm_mul_ps(low_a0##l, feedback), low_state##l); \
+	low_state##l = _mm_sub_ps( \
+		_mm_mul_ps(low_a1##l, feedback), \
+		_mm_mul_ps(low_b1##l, result) \
+	); \
+	feedback = _mm_add_ps( \
+		_mm_mul_ps(result, low_c0##l), \
+		_mm_mul_ps(feedback, low_d0##l) \
+	); \
+	to_buf = _mm_add_ps(input, _mm_mul_ps(gain##h, feedback));
+
+void FAudio_INTERNAL_ProcessCombBank_SSE2(
+	FAudioCombBank *bank,
+	const float *restrict in,
+	float *restrict out,
+	uint32_t samples
+) {
+	uint32_t i, k, tail;
+	__m128 x0, x1, x2, x3, y0, y1, y2, y3, sum;
+	__m128 input, result, feedback;
+	__m128 gain0, gain1;
+	__m128 high_a00, high_a10, high_b10, high_c00, high_d00, high_state0;
+	__m128 high_a01, high_a11, high_b11, high_c01, high_d01, high_state1;
+	__m128 low_a00, low_a10, low_b10, low_c00, low_d00, low_state0;
+	__m128 low_a01, low_a11, low_b11, low_c01, low_d01, low_state1;
+	FAudioCombBank rest;
+
+	#define LOAD_LANES(name) \
+		name##0 = _mm_loadu_ps(bank->name); \
+		name##1 = _mm_loadu_ps(bank->name + 4);
+	LOAD_LANES(high_a0)
+	LOAD_LANES(high_a1)
+	LOAD_LANES(high_b1)
+	LOAD_LANES(high_c0)
+	LOAD_LANES(high_d0)
+	LOAD_LANES(high_state)
+	LOAD_LANES(low_a0)
+	LOAD_LANES(low_a1)
+	LOAD_LANES(low_b1)
+	LOAD_LANES(low_c0)
+	LOAD_LANES(low_d0)
+	LOAD_LANES(low_state)
+	#undef LOAD_LANES
+	gain0 = _mm_loadu_ps(bank->feedback);
+	gain1 = _mm_loadu_ps(bank->feedback + 4);
+
+	/* Four samples of four lanes at a time, transposed into one column per
+	 * time step so that each step is a single pass over the vectors.
+	 */
+	tail = samples % 4;
+	for (i = 0; i < samples - tail; i += 4)
+	{
+		/* The lane sums come straight from the rows, in lane order */
+		x0 = _mm_loadu_ps(bank->read[0] + i);
+		x1 = _mm_loadu_ps(bank->read[1] + i);
+		x2 = _mm_loadu_ps(bank->read[2] + i);
+		x3 = _mm_loadu_ps(bank->read[3] + i);
+		y0 = _mm_loadu_ps(bank->read[4] + i);
+		y1 = _mm_loadu_ps(bank->read[5] + i);
+		y2 = _mm_loadu_ps(bank->read[6] + i);
+		y3 = _mm_loadu_ps(bank->read[7] + i);
+		sum = _mm_add_ps(_mm_add_ps(_mm_add_ps(x0, x1), x2), x3);
+		sum = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(sum, y0), y1), y2), y3);
+		_mm_storeu_ps(out + i, sum);
+		_MM_TRANSPOSE4_PS(x0, x1, x2, x3);
+		_MM_TRANSPOSE4_PS(y0, y1, y2, y3);
+
+		input = _mm_set1_ps(in[i]);
+		COMB_STEP(x0, 0, 0, x0)
+		COMB_STEP(y0, 1, 1, y0)
+		input = _mm_set1_ps(in[i + 1]);
+		COMB_STEP(x1, 0, 0, x1)
+		COMB_STEP(y1, 1, 1, y1)
+		input = _mm_set1_ps(in[i + 2]);
+		COMB_STEP(x2, 0, 0, x2)
+		COMB_STEP(y2, 1, 1, y2)
+		input = _mm_set1_ps(in[i + 3]);
+		COMB_STEP(x3, 0, 0, x3)
+		COMB_STEP(y3, 1, 1, y3)
+
+		_MM_TRANSPOSE4_PS(x0, x1, x2, x3);
+		_MM_TRANSPOSE4_PS(y0, y1, y2, y3);
+		_mm_storeu_ps(bank->write[0] + i, x0);
+		_mm_storeu_ps(bank->write[1] + i, x1);
+		_mm_storeu_ps(bank->write[2] + i, x2);
+		_mm_storeu_ps(bank->write[3] + i, x3);
+		_mm_storeu_ps(bank->write[4] + i, y0);
+		_mm_storeu_ps(bank->write[5] + i, y1);
+		_mm_storeu_ps(bank->write[6] + i, y2);
+		_mm_storeu_ps(bank->write[7] + i, y3);
+	}
+
+	_mm_storeu_ps(bank->high_state, high_state0);
+	_mm_storeu_ps(bank->high_state + 4, high_state1);
+	_mm_storeu_ps(bank->low_state, low_state0);
+	_mm_storeu_ps(bank->low_state + 4, low_state1);
+
+	if (tail)
+	{
+		rest = *bank;
+		for (k = 0; k < FAUDIO_COMB_BANK_SIZE; k += 1)
+		{
+			rest.read[k] += i;
+			rest.write[k] += i;
+		}
+		FAudio_INTERNAL_ProcessCombBank_Scalar(&rest, in + i, out + i, tail);
+		FAudio_memcpy(bank->high_state, rest.high_state, sizeof(rest.high_state));
+		FAudio_memcpy(bank->low_state, rest.low_state, sizeof(rest.low_state));
+	}
+}
+
+#undef COMB_STEP
+
+#endif /* HAVE_SSE2_INTRINSICS */
+
+/* SECTION 8: InitSIMDFunctions. Assigns based on SSE2/AVX/NEON support. */
+
+void (*FAudio_INTERNAL_Convert_U8_To_F32)(
+	const uint8_t *restrict src,
+	float *restrict dst,
+	uint32_t len
+);
+void (*FAudio_INTERNAL_Convert_S16_To_F32)(
+	const int16_t *restrict src,
+	float *restrict dst,
+	uint32_t len
+);
+void (*FAudio_INTERNAL_Convert_S32_To_F32)(
+	const int32_t *restrict src,
+	float *restrict dst,
+	uint32_t len
+);
+
+FAudioResampleCallback FAudio_INTERNAL_ResampleMono;
+FAudioResampleCallback FAudio_INTERNAL_ResampleStereo;
+FAudioResampleCallback FAudio_INTERNAL_ResampleSincMono;
+FAudioResampleCallback FAudio_INTERNAL_ResampleSincStereo;
+
+void (*FAudio_INTERNAL_Amplify)(
+	float *output,
+	uint32_t totalSamples,
+	float volume
+);
+
+FAudioMixCallback FAudio_INTERNAL_Mix_Generic;
+FAudioMixCallback FAudio_INTERNAL_Mix_1in_1out;
+FAudioMixCallback FAudio_INTERNAL_Mix_1in_2out;
+FAudioMixCallback FAudio_INTERNAL_Mix_1in_6out;
+FAudioMixCallback FAudio_INTERNAL_Mix_1in_8out;
+FAudioMixCallback FAudio_INTERNAL_Mix_2in_1out;
+FAudioMixCallback FAudio_INTERNAL_Mix_2in_2out;
+FAudioMixCallback FAudio_INTERNAL_Mix_2in_6out;
+FAudioMixCallback FAudio_INTERNAL_Mix_2in_8out;
+
+void (*FAudio_INTERNAL_DecodeMSADPCMBlocks)(
+	const uint8_t *restrict buf,
+	int16_t *restrict output,
+	uint32_t blocks,
+	uint32_t align,
+	uint32_t channels
+);
+
+/* Reverb FAPOs can be processed without an engine, so this one has a default */
+void (*FAudio_INTERNAL_ProcessCombBank)(
+	FAudioCombBank *bank,
+	const float *restrict in,
+	float *restrict out,
+	uint32_t samples
+) = FAudio_INTERNAL_ProcessCombBank_Scalar;
+
+#if HAVE_AVX2_INTRINSICS
+/* SDL and Win32 only report AVX2, but every AVX2 path here also uses FMA */
+static uint8_t FAudio_INTERNAL_HasFMA()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] >> 12) & 1;
+#else
+	unsigned int eax, ebx, ecx, edx;
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+	{
+		return 0;
+	}
+	return (ecx >> 12) & 1;
+#endif
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
+void FAudio_INTERNAL_InitSIMDFunctions(
+	uint8_t hasSSE2,
+	uint8_t hasNEON,
+	uint8_t hasAVX2,
+	uint8_t hasAVX512F
+) {
+	/* Same values every time, so racing engines don't matter */
+	if (!FAudio_INTERNAL_SincTablesReady)
+	{
+		FAudio_INTERNAL_InitSincTables();
+		FAudio_INTERNAL_SincTablesReady = 1;
+	}
+
+#if HAVE_SSE2_INTRINSICS
+	if (hasSSE2)
+	{
+		FAudio_INTERNAL_Convert_U8_To_F32 = FAudio_INTERNAL_Convert_U8_To_F32_SSE2;
+		FAudio_INTERNAL_Convert_S16_To_F32 = FAudio_INTERNAL_Convert_S16_To_F32_SSE2;
+		FAudio_INTERNAL_Convert_S32_To_F32 = FAudio_INTERNAL_Convert_S32_To_F32_SSE2;
+		FAudio_INTERNAL_ResampleMono = FAudio_INTERNAL_ResampleMono_SSE2;
+		FAudio_INTERNAL_ResampleStereo = FAudio_INTERNAL_ResampleStereo_SSE2;
+		FAudio_INTERNAL_ResampleSincMono = FAudio_INTERNAL_ResampleSincMono_SSE2;
+		FAudio_INTERNAL_ResampleSincStereo = FAudio_INTERNAL_ResampleSincStereo_SSE2;
+		FAudio_INTERNAL_Amplify = FAudio_INTERNAL_Amplify_SSE2;
+		FAudio_INTERNAL_Mix_Generic = FAudio_INTERNAL_Mix_Generic_SSE2;
+		FAudio_INTERNAL_Mix_1in_1out = FAudio_INTERNAL_Mix_1in_1out_SSE2;
+		FAudio_INTERNAL_Mix_1in_2out = FAudio_INTERNAL_Mix_1in_2out_SSE2;
+		FAudio_INTERNAL_Mix_1in_6out = FAudio_INTERNAL_Mix_1in_6out_SSE2;
+		FAudio_INTERNAL_Mix_1in_8out = FAudio_INTERNAL_Mix_1in_8out_SSE2;
+		FAudio_INTERNAL_Mix_2in_1out = FAudio_INTERNAL_Mix_2in_1out_SSE2;
+		FAudio_INTERNAL_Mix_2in_2out = FAudio_INTERNAL_Mix_2in_2out_SSE2;
+		FAudio_INTERNAL_Mix_2in_6out = FAudio_INTERNAL_Mix_2in_6out_SSE2;
+		FAudio_INTERNAL_Mix_2in_8out = FAudio_INTERNAL_Mix_2in_8out_SSE2;
+		FAudio_INTERNAL_DecodeMSADPCMBlocks = FAudio_INTERNAL_DecodeMSADPCMBlocks_SSE2;
+		FAudio_INTERNAL_ProcessCombBank = FAudio_INTERNAL_ProcessCombBank_SSE2;
+#if HAVE_AVX2_INTRINSICS
+		if (hasAVX2 && FAudio_INTERNAL_HasFMA())
+		{
+			FAudio_INTERNAL_Convert_U8_To_F32 = FAudio_INTERNAL_Convert_U8_To_F32_AVX2;
+			FAudio_INTERNAL_Convert_S16_To_F32 = FAudio_INTERNAL_Convert_S16_To_F32_AVX2;
+			FAudio_INTERNAL_Convert_S32_To_F32 = FAudio_INTERNAL_Convert_S32_To_F32_AVX2;
+			FAudio_INTERNAL_ResampleMono = FAudio_INTERNAL_ResampleMono_AVX2;
+			FAudio_INTERNAL_ResampleStereo = FAudio_INTERNAL_ResampleStereo_AVX2;
+			FAudio_INTERNAL_Amplify = FAudio_INTERNAL_Amplify_AVX2;
+			FAudio_INTERNAL_Mix_Generic = FAudio_INTERNAL_Mix_Generic_AVX2;
+			FAudio_INTERNAL_Mix_1in_1out = FAudio_INTERNAL_Mix_1in_1out_AVX2;
+			FAudio_INTERNAL_Mix_1in_2out = FAudio_INTERNAL_Mix_1in_2out_AVX2;
+			FAudio_INTERNAL_Mix_1in_6out = FAudio_INTERNAL_Mix_1in_6out_AVX2;
+			FAudio_INTERNAL_Mix_1in_8out = FAudio_INTERNAL_Mix_1in_8out_AVX2;
+			FAudio_INTERNAL_Mix_2in_1out = FAudio_INTERNAL_Mix_2in_1out_AVX2;
+			FAudio_INTERNAL_Mix_2in_2out = FAudio_INTERNAL_Mix_2in_2out_AVX2;
+			FAudio_INTERNAL_Mix_2in_6out = FAudio_INTERNAL_Mix_2in_6out_AVX2;
+			FAudio_INTERNAL_Mix_2in_8out = FAudio_INTERNAL_Mix_2in_8out_AVX2;
+		}
+#endif
+#if HAVE_AVX512F_INTRINSICS
+		/* Only the purely streaming kernels benefit from the wider registers */
+		if (hasAVX512F)
+		{
+			FAudio_INTERNAL_Convert_U8_To_F32 = FAudio_INTERNAL_Convert_U8_To_F32_AVX512F;
+			FAudio_INTERNAL_Convert_S16_To_F32 = FAudio_INTERNAL_Convert_S16_To_F32_AVX512F;
+			FAudio_INTERNAL_Convert_S32_To_F32 = FAudio_INTERNAL_Convert_S32_To_F32_AVX512F;
+			FAudio_INTERNAL_Amplify = FAudio_INTERNAL_Amplify_AVX512F;
+		}
+#endif
 		return;
 	}
 #endif
@@ -1595,8 +3991,20 @@ void FAudio_INTERNAL_InitSIMDFunctions(uint8_t hasSSE2, uint8_t hasNEON)
 		FAudio_INTERNAL_Convert_S32_To_F32 = FAudio_INTERNAL_Convert_S32_To_F32_NEON;
 		FAudio_INTERNAL_ResampleMono = FAudio_INTERNAL_ResampleMono_NEON;
 		FAudio_INTERNAL_ResampleStereo = FAudio_INTERNAL_ResampleStereo_NEON;
+		FAudio_INTERNAL_ResampleSincMono = FAudio_INTERNAL_ResampleSincGeneric;
+		FAudio_INTERNAL_ResampleSincStereo = FAudio_INTERNAL_ResampleSincGeneric;
 		FAudio_INTERNAL_Amplify = FAudio_INTERNAL_Amplify_NEON;
 		FAudio_INTERNAL_Mix_Generic = FAudio_INTERNAL_Mix_Generic_Scalar;
+		FAudio_INTERNAL_Mix_1in_1out = FAudio_INTERNAL_Mix_1in_1out_Scalar;
+		FAudio_INTERNAL_Mix_1in_2out = FAudio_INTERNAL_Mix_1in_2out_Scalar;
+		FAudio_INTERNAL_Mix_1in_6out = FAudio_INTERNAL_Mix_1in_6out_Scalar;
+		FAudio_INTERNAL_Mix_1in_8out = FAudio_INTERNAL_Mix_1in_8out_Scalar;
+		FAudio_INTERNAL_Mix_2in_1out = FAudio_INTERNAL_Mix_2in_1out_Scalar;
+		FAudio_INTERNAL_Mix_2in_2out = FAudio_INTERNAL_Mix_2in_2out_Scalar;
+		FAudio_INTERNAL_Mix_2in_6out = FAudio_INTERNAL_Mix_2in_6out_Scalar;
+		FAudio_INTERNAL_Mix_2in_8out = FAudio_INTERNAL_Mix_2in_8out_Scalar;
+		FAudio_INTERNAL_DecodeMSADPCMBlocks = FAudio_INTERNAL_DecodeMSADPCMBlocks_Scalar;
+		FAudio_INTERNAL_ProcessCombBank = FAudio_INTERNAL_ProcessCombBank_Scalar;
 		return;
 	}
 #endif
@@ -1606,8 +4014,20 @@ void FAudio_INTERNAL_InitSIMDFunctions(uint8_t hasSSE2, uint8_t hasNEON)
 	FAudio_INTERNAL_Convert_S32_To_F32 = FAudio_INTERNAL_Convert_S32_To_F32_Scalar;
 	FAudio_INTERNAL_ResampleMono = FAudio_INTERNAL_ResampleMono_Scalar;
 	FAudio_INTERNAL_ResampleStereo = FAudio_INTERNAL_ResampleStereo_Scalar;
+	FAudio_INTERNAL_ResampleSincMono = FAudio_INTERNAL_ResampleSincGeneric;
+	FAudio_INTERNAL_ResampleSincStereo = FAudio_INTERNAL_ResampleSincGeneric;
 	FAudio_INTERNAL_Amplify = FAudio_INTERNAL_Amplify_Scalar;
 	FAudio_INTERNAL_Mix_Generic = FAudio_INTERNAL_Mix_Generic_Scalar;
+	FAudio_INTERNAL_Mix_1in_1out = FAudio_INTERNAL_Mix_1in_1out_Scalar;
+	FAudio_INTERNAL_Mix_1in_2out = FAudio_INTERNAL_Mix_1in_2out_Scalar;
+	FAudio_INTERNAL_Mix_1in_6out = FAudio_INTERNAL_Mix_1in_6out_Scalar;
+	FAudio_INTERNAL_Mix_1in_8out = FAudio_INTERNAL_Mix_1in_8out_Scalar;
+	FAudio_INTERNAL_Mix_2in_1out = FAudio_INTERNAL_Mix_2in_1out_Scalar;
+	FAudio_INTERNAL_Mix_2in_2out = FAudio_INTERNAL_Mix_2in_2out_Scalar;
+	FAudio_INTERNAL_Mix_2in_6out = FAudio_INTERNAL_Mix_2in_6out_Scalar;
+	FAudio_INTERNAL_Mix_2in_8out = FAudio_INTERNAL_Mix_2in_8out_Scalar;
+	FAudio_INTERNAL_DecodeMSADPCMBlocks = FAudio_INTERNAL_DecodeMSADPCMBlocks_Scalar;
+	FAudio_INTERNAL_ProcessCombBank = FAudio_INTERNAL_ProcessCombBank_Scalar;
 #else
 	FAudio_assert(0 && "Need converter functions!");
 #endif
@@ -112,28 +112,162 @@ struct FAudio_OPERATIONSET_Operation
 		} SetFrequencyRatio;
 	} Data;
 
+	/* Backs pParameters/pVolumes/pLevelMatrix. It stays with the operation
+	 * when it goes back to the pool, so it only grows.
+	 */
+	void *payload;
+	uint32_t payloadSize;
+
+	/* Queued: all queued operations, in order
+	 * Committed: all committed operations, in order
+	 * Otherwise: the pool, next only
+	 */
+	FAudio_OPERATIONSET_Operation *prev;
 	FAudio_OPERATIONSET_Operation *next;
+
+	/* Queued only: the rest of this OperationSet, in order */
+	FAudio_OPERATIONSET_Operation *setPrev;
+	FAudio_OPERATIONSET_Operation *setNext;
+
+	/* Queued only: the coalescing table bucket we're in, newest first */
+	FAudio_OPERATIONSET_Operation **hashBucket;
+	FAudio_OPERATIONSET_Operation *hashNext;
 };
 
+struct FAudio_OPERATIONSET_Set
+{
+	uint32_t OperationSet;
+	FAudio_OPERATIONSET_Operation *head;
+	FAudio_OPERATIONSET_Operation *tail;
+	FAudio_OPERATIONSET_Set *next;
+};
+
+/* Operations and sets come from pools that live as long as the engine, so once
+ * the pools have grown to fit a frame's worth of calls, queueing and
+ * committing never allocate. Everything here is done with operationLock held.
+ */
+
+#define SET_BUCKET(set) ((set) % FAUDIO_OPERATIONSET_BUCKETS)
+
+static inline uint32_t OperationBucket(
+	FAudioVoice *voice,
+	FAudio_OPERATIONSET_Type type,
+	uint32_t operationSet,
+	size_t key
+) {
+	size_t hash = ((size_t) voice >> 4) ^ (key * 0x9E3779B1u);
+	hash ^= (operationSet * 0x85EBCA6Bu) ^ ((size_t) type << 24);
+	hash ^= hash >> 16;
+	return (uint32_t) (hash % FAUDIO_OPERATIONSET_BUCKETS);
+}
+
+static inline void* ReservePayload(
+	FAudio *audio,
+	FAudio_OPERATIONSET_Operation *op,
+	uint32_t size
+) {
+	if (size > op->payloadSize)
+	{
+		audio->pFree(op->payload);
+		op->payload = audio->pMalloc(size);
+		op->payloadSize = size;
+	}
+	return op->payload;
+}
+
+static inline void ReleaseOperation(
+	FAudio *audio,
+	FAudio_OPERATIONSET_Operation *op
+) {
+	op->next = audio->freeOperations;
+	audio->freeOperations = op;
+}
+
 /* Used by both Commit and Clear routines */
 
 static inline void DeleteOperation(
 	FAudio_OPERATIONSET_Operation *op,
 	FAudioFreeFunc pFree
 ) {
-	if (op->Type == FAUDIOOP_SETEFFECTPARAMETERS)
+	if (op->payload != NULL)
+	{
+		pFree(op->payload);
+	}
+	pFree(op);
+}
+
+static inline void DeleteList(
+	FAudio_OPERATIONSET_Operation *op,
+	FAudioFreeFunc pFree
+) {
+	FAudio_OPERATIONSET_Operation *next;
+
+	while (op != NULL)
 	{
-		pFree(op->Data.SetEffectParameters.pParameters);
+		next = op->next;
+		DeleteOperation(op, pFree);
+		op = next;
 	}
-	else if (op->Type == FAUDIOOP_SETCHANNELVOLUMES)
+}
+
+static inline void UnhashOperation(FAudio_OPERATIONSET_Operation *op)
+{
+	FAudio_OPERATIONSET_Operation **bucket = op->hashBucket;
+
+	if (bucket == NULL)
 	{
-		pFree(op->Data.SetChannelVolumes.pVolumes);
+		return;
 	}
-	else if (op->Type == FAUDIOOP_SETOUTPUTMATRIX)
+	while (*bucket != op)
 	{
-		pFree(op->Data.SetOutputMatrix.pLevelMatrix);
+		bucket = &(*bucket)->hashNext;
 	}
-	pFree(op);
+	*bucket = op->hashNext;
+	op->hashBucket = NULL;
+}
+
+/* Forgets every set and coalescing entry, once nothing is queued anymore */
+static void ResetQueueTables(FAudio *audio)
+{
+	FAudio_OPERATIONSET_Set *set, *next;
+	uint32_t i;
+
+	if (audio->queuedOperationSets > 0)
+	{
+		for (i = 0; i < FAUDIO_OPERATIONSET_BUCKETS; i += 1)
+		{
+			for (set = audio->operationSets[i]; set != NULL; set = next)
+			{
+				next = set->next;
+				set->next = audio->freeOperationSets;
+				audio->freeOperationSets = set;
+			}
+			audio->operationSets[i] = NULL;
+		}
+		audio->queuedOperationSets = 0;
+	}
+	FAudio_zero(
+		audio->coalescedOperations,
+		sizeof(audio->coalescedOperations)
+	);
+}
+
+/* Appends a chain of operations to the committed list */
+static inline void AppendCommitted(
+	FAudio *audio,
+	FAudio_OPERATIONSET_Operation *head,
+	FAudio_OPERATIONSET_Operation *tail
+) {
+	head->prev = audio->committedOperationsTail;
+	if (audio->committedOperationsTail != NULL)
+	{
+		audio->committedOperationsTail->next = head;
+	}
+	else
+	{
+		audio->committedOperations = head;
+	}
+	audio->committedOperationsTail = tail;
 }
 
 /* OperationSet Execution */
@@ -252,8 +386,6 @@ static inline void ExecuteOperation(FAudio_OPERATIONSET_Operation *op)
 
 void FAudio_OPERATIONSET_CommitAll(FAudio *audio)
 {
-	FAudio_OPERATIONSET_Operation *op, *next, **committed_end;
-
 	FAudio_PlatformLockMutex(audio->operationLock);
 	LOG_MUTEX_LOCK(audio, audio->operationLock)
 
@@ -264,24 +396,15 @@ void FAudio_OPERATIONSET_CommitAll(FAudio *audio)
 		return;
 	}
 
-	committed_end = &audio->committedOperations;
-	while (*committed_end)
-	{
-		committed_end = &((*committed_end)->next);
-	}
-
-	op = audio->queuedOperations;
-	do
-	{
-		next = op->next;
-
-		*committed_end = op;
-		op->next = NULL;
-		committed_end = &op->next;
-
-		op = next;
-	} while (op != NULL);
+	/* Everything queued goes, in order */
+	AppendCommitted(
+		audio,
+		audio->queuedOperations,
+		audio->queuedOperationsTail
+	);
 	audio->queuedOperations = NULL;
+	audio->queuedOperationsTail = NULL;
+	ResetQueueTables(audio);
 
 	FAudio_PlatformUnlockMutex(audio->operationLock);
 	LOG_MUTEX_UNLOCK(audio, audio->operationLock)
@@ -289,50 +412,56 @@ void FAudio_OPERATIONSET_CommitAll(FAudio *audio)
 
 void FAudio_OPERATIONSET_Commit(FAudio *audio, uint32_t OperationSet)
 {
-	FAudio_OPERATIONSET_Operation *op, *next, *prev, **committed_end;
+	FAudio_OPERATIONSET_Set **bucket, *set;
+	FAudio_OPERATIONSET_Operation *op, *next;
 
 	FAudio_PlatformLockMutex(audio->operationLock);
 	LOG_MUTEX_LOCK(audio, audio->operationLock)
 
-	if (audio->queuedOperations == NULL)
+	bucket = &audio->operationSets[SET_BUCKET(OperationSet)];
+	while (*bucket != NULL && (*bucket)->OperationSet != OperationSet)
+	{
+		bucket = &(*bucket)->next;
+	}
+	set = *bucket;
+	if (set == NULL)
 	{
 		FAudio_PlatformUnlockMutex(audio->operationLock);
 		LOG_MUTEX_UNLOCK(audio, audio->operationLock)
 		return;
 	}
 
-	committed_end = &audio->committedOperations;
-	while (*committed_end)
+	/* Only this set's operations are visited, not the whole queue */
+	for (op = set->head; op != NULL; op = next)
 	{
-		committed_end = &((*committed_end)->next);
-	}
+		next = op->setNext;
 
-	op = audio->queuedOperations;
-	prev = NULL;
-	do
-	{
-		next = op->next;
-		if (op->OperationSet == OperationSet)
+		if (op->prev == NULL) /* Start of linked list */
 		{
-			if (prev == NULL) /* Start of linked list */
-			{
-				audio->queuedOperations = next;
-			}
-			else
-			{
-				prev->next = next;
-			}
-
-			*committed_end = op;
-			op->next = NULL;
-			committed_end = &op->next;
+			audio->queuedOperations = op->next;
 		}
 		else
 		{
-			prev = op;
+			op->prev->next = op->next;
 		}
-		op = next;
-	} while (op != NULL);
+		if (op->next == NULL) /* End of linked list */
+		{
+			audio->queuedOperationsTail = op->prev;
+		}
+		else
+		{
+			op->next->prev = op->prev;
+		}
+		UnhashOperation(op);
+
+		op->next = NULL;
+		AppendCommitted(audio, op, op);
+	}
+
+	*bucket = set->next;
+	set->next = audio->freeOperationSets;
+	audio->freeOperationSets = set;
+	audio->queuedOperationSets -= 1;
 
 	FAudio_PlatformUnlockMutex(audio->operationLock);
 	LOG_MUTEX_UNLOCK(audio, audio->operationLock)
@@ -350,10 +479,11 @@ void FAudio_OPERATIONSET_Execute(FAudio *audio)
 	{
 		next = op->next;
 		ExecuteOperation(op);
-		DeleteOperation(op, audio->pFree);
+		ReleaseOperation(audio, op);
 		op = next;
 	}
 	audio->committedOperations = NULL;
+	audio->committedOperationsTail = NULL;
 
 	FAudio_PlatformUnlockMutex(audio->operationLock);
 	LOG_MUTEX_UNLOCK(audio, audio->operationLock)
@@ -366,33 +496,197 @@ static inline FAudio_OPERATIONSET_Operation* QueueOperation(
 	FAudio_OPERATIONSET_Type type,
 	uint32_t operationSet
 ) {
-	FAudio_OPERATIONSET_Operation *latest;
-	FAudio_OPERATIONSET_Operation *newop = voice->audio->pMalloc(
-		sizeof(FAudio_OPERATIONSET_Operation)
-	);
+	FAudio *audio = voice->audio;
+	FAudio_OPERATIONSET_Set **bucket, *set;
+	FAudio_OPERATIONSET_Operation *newop;
+
+	newop = audio->freeOperations;
+	if (newop != NULL)
+	{
+		audio->freeOperations = newop->next;
+	}
+	else
+	{
+		newop = (FAudio_OPERATIONSET_Operation*) audio->pMalloc(
+			sizeof(FAudio_OPERATIONSET_Operation)
+		);
+		newop->payload = NULL;
+		newop->payloadSize = 0;
+	}
 
 	newop->Type = type;
 	newop->Voice = voice;
 	newop->OperationSet = operationSet;
 	newop->next = NULL;
+	newop->setNext = NULL;
+	newop->hashBucket = NULL;
+	newop->hashNext = NULL;
 
-	if (voice->audio->queuedOperations == NULL)
+	newop->prev = audio->queuedOperationsTail;
+	if (audio->queuedOperationsTail != NULL)
 	{
-		voice->audio->queuedOperations = newop;
+		audio->queuedOperationsTail->next = newop;
 	}
 	else
 	{
-		latest = voice->audio->queuedOperations;
-		while (latest->next != NULL)
+		audio->queuedOperations = newop;
+	}
+	audio->queuedOperationsTail = newop;
+
+	/* Find this operation's set, or start a new one */
+	bucket = &audio->operationSets[SET_BUCKET(operationSet)];
+	for (set = *bucket; set != NULL; set = set->next)
+	{
+		if (set->OperationSet == operationSet)
+		{
+			break;
+		}
+	}
+	if (set == NULL)
+	{
+		set = audio->freeOperationSets;
+		if (set != NULL)
+		{
+			audio->freeOperationSets = set->next;
+		}
+		else
 		{
-			latest = latest->next;
+			set = (FAudio_OPERATIONSET_Set*) audio->pMalloc(
+				sizeof(FAudio_OPERATIONSET_Set)
+			);
 		}
-		latest->next = newop;
+		set->OperationSet = operationSet;
+		set->head = NULL;
+		set->tail = NULL;
+		set->next = *bucket;
+		*bucket = set;
+		audio->queuedOperationSets += 1;
+	}
+	newop->setPrev = set->tail;
+	if (set->tail != NULL)
+	{
+		set->tail->setNext = newop;
+	}
+	else
+	{
+		set->head = newop;
 	}
+	set->tail = newop;
 
 	return newop;
 }
 
+/* Moves a queued operation to the end of both the queue and its set, as if it
+ * had just been queued
+ */
+static inline void RequeueOperation(
+	FAudio *audio,
+	FAudio_OPERATIONSET_Operation *op
+) {
+	FAudio_OPERATIONSET_Set *set;
+
+	if (op->next != NULL)
+	{
+		if (op->prev == NULL) /* Start of linked list */
+		{
+			audio->queuedOperations = op->next;
+		}
+		else
+		{
+			op->prev->next = op->next;
+		}
+		op->next->prev = op->prev;
+
+		op->prev = audio->queuedOperationsTail;
+		op->next = NULL;
+		audio->queuedOperationsTail->next = op;
+		audio->queuedOperationsTail = op;
+	}
+
+	if (op->setNext != NULL)
+	{
+		set = audio->operationSets[SET_BUCKET(op->OperationSet)];
+		while (set->OperationSet != op->OperationSet)
+		{
+			set = set->next;
+		}
+
+		if (op->setPrev == NULL)
+		{
+			set->head = op->setNext;
+		}
+		else
+		{
+			op->setPrev->setNext = op->setNext;
+		}
+		op->setNext->setPrev = op->setPrev;
+
+		op->setPrev = set->tail;
+		op->setNext = NULL;
+		set->tail->setNext = op;
+		set->tail = op;
+	}
+}
+
+/* Operations that only set a value can be coalesced: the last call for the
+ * same voice and parameter in an OperationSet is the only one that matters,
+ * so later calls overwrite the queued operation instead of adding another.
+ * The operation is moved to where the latest call would have queued it, so
+ * that it still runs after anything other sets queued in between.
+ * key tells parameters apart (effect index, destination voice).
+ */
+static inline FAudio_OPERATIONSET_Operation* CoalesceOperation(
+	FAudioVoice *voice,
+	FAudio_OPERATIONSET_Type type,
+	uint32_t operationSet,
+	size_t key,
+	FAudio_OPERATIONSET_Operation ***bucket
+) {
+	FAudio_OPERATIONSET_Operation *op;
+
+	*bucket = &voice->audio->coalescedOperations[OperationBucket(
+		voice,
+		type,
+		operationSet,
+		key
+	)];
+	for (op = **bucket; op != NULL; op = op->hashNext)
+	{
+		if (	op->Voice == voice &&
+			op->Type == type &&
+			op->OperationSet == operationSet	)
+		{
+			if (	(type == FAUDIOOP_SETEFFECTPARAMETERS &&
+				 op->Data.SetEffectParameters.EffectIndex != key) ||
+				(type == FAUDIOOP_SETOUTPUTFILTERPARAMETERS &&
+				 (size_t) op->Data.SetOutputFilterParameters.pDestinationVoice != key) ||
+				(type == FAUDIOOP_SETOUTPUTMATRIX &&
+				 (size_t) op->Data.SetOutputMatrix.pDestinationVoice != key)	)
+			{
+				continue;
+			}
+			RequeueOperation(voice->audio, op);
+			return op;
+		}
+	}
+	return NULL;
+}
+
+static inline FAudio_OPERATIONSET_Operation* QueueCoalescedOperation(
+	FAudioVoice *voice,
+	FAudio_OPERATIONSET_Type type,
+	uint32_t operationSet,
+	FAudio_OPERATIONSET_Operation **bucket
+) {
+	FAudio_OPERATIONSET_Operation *op;
+
+	op = QueueOperation(voice, type, operationSet);
+	op->hashBucket = bucket;
+	op->hashNext = *bucket;
+	*bucket = op;
+	return op;
+}
+
 void FAudio_OPERATIONSET_QueueEnableEffect(
 	FAudioVoice *voice,
 	uint32_t EffectIndex,
@@ -444,19 +738,33 @@ void FAudio_OPERATIONSET_QueueSetEffectParameters(
 	uint32_t ParametersByteSize,
 	uint32_t OperationSet
 ) {
-	FAudio_OPERATIONSET_Operation *op;
+	FAudio_OPERATIONSET_Operation *op, **bucket;
 
 	FAudio_PlatformLockMutex(voice->audio->operationLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->audio->operationLock)
 
-	op = QueueOperation(
+	op = CoalesceOperation(
 		voice,
 		FAUDIOOP_SETEFFECTPARAMETERS,
-		OperationSet
+		OperationSet,
+		EffectIndex,
+		&bucket
 	);
+	if (	op == NULL ||
+		op->Data.SetEffectParameters.ParametersByteSize != ParametersByteSize	)
+	{
+		op = QueueCoalescedOperation(
+			voice,
+			FAUDIOOP_SETEFFECTPARAMETERS,
+			OperationSet,
+			bucket
+		);
+	}
 
 	op->Data.SetEffectParameters.EffectIndex = EffectIndex;
-	op->Data.SetEffectParameters.pParameters = voice->audio->pMalloc(
+	op->Data.SetEffectParameters.pParameters = ReservePayload(
+		voice->audio,
+		op,
 		ParametersByteSize
 	);
 	FAudio_memcpy(
@@ -475,16 +783,27 @@ void FAudio_OPERATIONSET_QueueSetFilterParameters(
 	const FAudioFilterParametersEXT *pParameters,
 	uint32_t OperationSet
 ) {
-	FAudio_OPERATIONSET_Operation *op;
+	FAudio_OPERATIONSET_Operation *op, **bucket;
 
 	FAudio_PlatformLockMutex(voice->audio->operationLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->audio->operationLock)
 
-	op = QueueOperation(
+	op = CoalesceOperation(
 		voice,
 		FAUDIOOP_SETFILTERPARAMETERS,
-		OperationSet
+		OperationSet,
+		0,
+		&bucket
 	);
+	if (op == NULL)
+	{
+		op = QueueCoalescedOperation(
+			voice,
+			FAUDIOOP_SETFILTERPARAMETERS,
+			OperationSet,
+			bucket
+		);
+	}
 
 	FAudio_memcpy(
 		&op->Data.SetFilterParameters.Parameters,
@@ -502,16 +821,27 @@ void FAudio_OPERATIONSET_QueueSetOutputFilterParameters(
 	const FAudioFilterParametersEXT *pParameters,
 	uint32_t OperationSet
 ) {
-	FAudio_OPERATIONSET_Operation *op;
+	FAudio_OPERATIONSET_Operation *op, **bucket;
 
 	FAudio_PlatformLockMutex(voice->audio->operationLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->audio->operationLock)
 
-	op = QueueOperation(
+	op = CoalesceOperation(
 		voice,
 		FAUDIOOP_SETOUTPUTFILTERPARAMETERS,
-		OperationSet
+		OperationSet,
+		(size_t) pDestinationVoice,
+		&bucket
 	);
+	if (op == NULL)
+	{
+		op = QueueCoalescedOperation(
+			voice,
+			FAUDIOOP_SETOUTPUTFILTERPARAMETERS,
+			OperationSet,
+			bucket
+		);
+	}
 
 	op->Data.SetOutputFilterParameters.pDestinationVoice = pDestinationVoice;
 	FAudio_memcpy(
@@ -529,16 +859,27 @@ void FAudio_OPERATIONSET_QueueSetVolume(
 	float Volume,
 	uint32_t OperationSet
 ) {
-	FAudio_OPERATIONSET_Operation *op;
+	FAudio_OPERATIONSET_Operation *op, **bucket;
 
 	FAudio_PlatformLockMutex(voice->audio->operationLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->audio->operationLock)
 
-	op = QueueOperation(
+	op = CoalesceOperation(
 		voice,
 		FAUDIOOP_SETVOLUME,
-		OperationSet
+		OperationSet,
+		0,
+		&bucket
 	);
+	if (op == NULL)
+	{
+		op = QueueCoalescedOperation(
+			voice,
+			FAUDIOOP_SETVOLUME,
+			OperationSet,
+			bucket
+		);
+	}
 
 	op->Data.SetVolume.Volume = Volume;
 
@@ -552,19 +893,32 @@ void FAudio_OPERATIONSET_QueueSetChannelVolumes(
 	const float *pVolumes,
 	uint32_t OperationSet
 ) {
-	FAudio_OPERATIONSET_Operation *op;
+	FAudio_OPERATIONSET_Operation *op, **bucket;
 
 	FAudio_PlatformLockMutex(voice->audio->operationLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->audio->operationLock)
 
-	op = QueueOperation(
+	op = CoalesceOperation(
 		voice,
 		FAUDIOOP_SETCHANNELVOLUMES,
-		OperationSet
+		OperationSet,
+		0,
+		&bucket
 	);
+	if (op == NULL || op->Data.SetChannelVolumes.Channels != Channels)
+	{
+		op = QueueCoalescedOperation(
+			voice,
+			FAUDIOOP_SETCHANNELVOLUMES,
+			OperationSet,
+			bucket
+		);
+	}
 
 	op->Data.SetChannelVolumes.Channels = Channels;
-	op->Data.SetChannelVolumes.pVolumes = voice->audio->pMalloc(
+	op->Data.SetChannelVolumes.pVolumes = ReservePayload(
+		voice->audio,
+		op,
 		sizeof(float) * Channels
 	);
 	FAudio_memcpy(
@@ -585,21 +939,36 @@ void FAudio_OPERATIONSET_QueueSetOutputMatrix(
 	const float *pLevelMatrix,
 	uint32_t OperationSet
 ) {
-	FAudio_OPERATIONSET_Operation *op;
+	FAudio_OPERATIONSET_Operation *op, **bucket;
 
 	FAudio_PlatformLockMutex(voice->audio->operationLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->audio->operationLock)
 
-	op = QueueOperation(
+	op = CoalesceOperation(
 		voice,
 		FAUDIOOP_SETOUTPUTMATRIX,
-		OperationSet
+		OperationSet,
+		(size_t) pDestinationVoice,
+		&bucket
 	);
+	if (	op == NULL ||
+		op->Data.SetOutputMatrix.SourceChannels != SourceChannels ||
+		op->Data.SetOutputMatrix.DestinationChannels != DestinationChannels	)
+	{
+		op = QueueCoalescedOperation(
+			voice,
+			FAUDIOOP_SETOUTPUTMATRIX,
+			OperationSet,
+			bucket
+		);
+	}
 
 	op->Data.SetOutputMatrix.pDestinationVoice = pDestinationVoice;
 	op->Data.SetOutputMatrix.SourceChannels = SourceChannels;
 	op->Data.SetOutputMatrix.DestinationChannels = DestinationChannels;
-	op->Data.SetOutputMatrix.pLevelMatrix = voice->audio->pMalloc(
+	op->Data.SetOutputMatrix.pLevelMatrix = ReservePayload(
+		voice->audio,
+		op,
 		sizeof(float) * SourceChannels * DestinationChannels
 	);
 	FAudio_memcpy(
@@ -680,16 +1049,27 @@ void FAudio_OPERATIONSET_QueueSetFrequencyRatio(
 	float Ratio,
 	uint32_t OperationSet
 ) {
-	FAudio_OPERATIONSET_Operation *op;
+	FAudio_OPERATIONSET_Operation *op, **bucket;
 
 	FAudio_PlatformLockMutex(voice->audio->operationLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->audio->operationLock)
 
-	op = QueueOperation(
+	op = CoalesceOperation(
 		voice,
 		FAUDIOOP_SETFREQUENCYRATIO,
-		OperationSet
+		OperationSet,
+		0,
+		&bucket
 	);
+	if (op == NULL)
+	{
+		op = QueueCoalescedOperation(
+			voice,
+			FAUDIOOP_SETFREQUENCYRATIO,
+			OperationSet,
+			bucket
+		);
+	}
 
 	op->Data.SetFrequencyRatio.Ratio = Ratio;
 
@@ -701,19 +1081,27 @@ void FAudio_OPERATIONSET_QueueSetFrequencyRatio(
 
 void FAudio_OPERATIONSET_ClearAll(FAudio *audio)
 {
-	FAudio_OPERATIONSET_Operation *current, *next;
+	FAudio_OPERATIONSET_Set *set, *next;
 
 	FAudio_PlatformLockMutex(audio->operationLock);
 	LOG_MUTEX_LOCK(audio, audio->operationLock)
 
-	current = audio->queuedOperations;
-	while (current != NULL)
+	DeleteList(audio->queuedOperations, audio->pFree);
+	DeleteList(audio->committedOperations, audio->pFree);
+	DeleteList(audio->freeOperations, audio->pFree);
+	audio->queuedOperations = NULL;
+	audio->queuedOperationsTail = NULL;
+	audio->committedOperations = NULL;
+	audio->committedOperationsTail = NULL;
+	audio->freeOperations = NULL;
+
+	ResetQueueTables(audio);
+	for (set = audio->freeOperationSets; set != NULL; set = next)
 	{
-		next = current->next;
-		DeleteOperation(current, audio->pFree);
-		current = next;
+		next = set->next;
+		audio->pFree(set);
 	}
-	audio->queuedOperations = NULL;
+	audio->freeOperationSets = NULL;
 
 	FAudio_PlatformUnlockMutex(audio->operationLock);
 	LOG_MUTEX_UNLOCK(audio, audio->operationLock)
@@ -723,7 +1111,8 @@ void FAudio_OPERATIONSET_ClearAll(FAudio *audio)
 
 static inline void RemoveFromList(
 	FAudioVoice *voice,
-	FAudio_OPERATIONSET_Operation **list
+	FAudio_OPERATIONSET_Operation **list,
+	FAudio_OPERATIONSET_Operation **tail
 ) {
 	FAudio_OPERATIONSET_Operation *current, *next, *prev;
 
@@ -751,8 +1140,12 @@ static inline void RemoveFromList(
 			{
 				prev->next = next;
 			}
+			if (next != NULL)
+			{
+				next->prev = prev;
+			}
 
-			DeleteOperation(current, voice->audio->pFree);
+			ReleaseOperation(voice->audio, current);
 		}
 		else
 		{
@@ -760,18 +1153,100 @@ static inline void RemoveFromList(
 		}
 		current = next;
 	}
+	*tail = prev;
 }
 
 void FAudio_OPERATIONSET_ClearAllForVoice(FAudioVoice *voice)
 {
-	FAudio_PlatformLockMutex(voice->audio->operationLock);
-	LOG_MUTEX_LOCK(voice->audio, voice->audio->operationLock)
+	FAudio *audio = voice->audio;
+	FAudio_OPERATIONSET_Operation *op;
+	FAudio_OPERATIONSET_Set **bucket, *set;
+	size_t key;
 
-	RemoveFromList(voice, &voice->audio->queuedOperations);
-	RemoveFromList(voice, &voice->audio->committedOperations);
+	FAudio_PlatformLockMutex(audio->operationLock);
+	LOG_MUTEX_LOCK(audio, audio->operationLock)
 
-	FAudio_PlatformUnlockMutex(voice->audio->operationLock);
-	LOG_MUTEX_UNLOCK(voice->audio, voice->audio->operationLock)
+	RemoveFromList(
+		voice,
+		&audio->queuedOperations,
+		&audio->queuedOperationsTail
+	);
+	RemoveFromList(
+		voice,
+		&audio->committedOperations,
+		&audio->committedOperationsTail
+	);
+
+	/* Voices aren't destroyed often, so rather than unlinking the removed
+	 * operations from every set and bucket, just rebuild both tables from
+	 * what's left in the queue.
+	 */
+	ResetQueueTables(audio);
+	for (op = audio->queuedOperations; op != NULL; op = op->next)
+	{
+		op->setNext = NULL;
+
+		bucket = &audio->operationSets[SET_BUCKET(op->OperationSet)];
+		for (set = *bucket; set != NULL; set = set->next)
+		{
+			if (set->OperationSet == op->OperationSet)
+			{
+				break;
+			}
+		}
+		if (set == NULL)
+		{
+			set = audio->freeOperationSets;
+			audio->freeOperationSets = set->next;
+			set->OperationSet = op->OperationSet;
+			set->head = NULL;
+			set->tail = NULL;
+			set->next = *bucket;
+			*bucket = set;
+			audio->queuedOperationSets += 1;
+		}
+		op->setPrev = set->tail;
+		if (set->tail != NULL)
+		{
+			set->tail->setNext = op;
+		}
+		else
+		{
+			set->head = op;
+		}
+		set->tail = op;
+
+		if (op->hashBucket != NULL)
+		{
+			if (op->Type == FAUDIOOP_SETEFFECTPARAMETERS)
+			{
+				key = op->Data.SetEffectParameters.EffectIndex;
+			}
+			else if (op->Type == FAUDIOOP_SETOUTPUTFILTERPARAMETERS)
+			{
+				key = (size_t) op->Data.SetOutputFilterParameters.pDestinationVoice;
+			}
+			else if (op->Type == FAUDIOOP_SETOUTPUTMATRIX)
+			{
+				key = (size_t) op->Data.SetOutputMatrix.pDestinationVoice;
+			}
+			else
+			{
+				key = 0;
+			}
+			op->hashBucket = &audio->coalescedOperations[OperationBucket(
+				op->Voice,
+				op->Type,
+				op->OperationSet,
+				key
+			)];
+			op->hashNext = *op->hashBucket;
+			*op->hashBucket = op;
+		}
+	}
+
+	FAudio_PlatformUnlockMutex(audio->operationLock);
+	LOG_MUTEX_UNLOCK(audio, audio->operationLock)
 }
 
 /* vim: set noexpandtab shiftwidth=8 tabstop=8: */
@@ -30,6 +30,16 @@
 
 #include <SDL3/SDL.h>
 
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /* _WIN32 */
+
 typedef struct SDLAudioDevice
 {
 	FAudio *audio;
@@ -129,6 +139,16 @@ static void FAudio_INTERNAL_PrioritizeDirectSound()
 	}
 }
 
+void FAudio_PlatformInitSIMD()
+{
+	FAudio_INTERNAL_InitSIMDFunctions(
+		SDL_HasSSE2(),
+		SDL_HasNEON(),
+		SDL_HasAVX2(),
+		SDL_HasAVX512F()
+	);
+}
+
 void FAudio_PlatformAddRef()
 {
 	FAudio_INTERNAL_PrioritizeDirectSound();
@@ -138,10 +158,6 @@ void FAudio_PlatformAddRef()
 	{
 		SDL_Log("SDL_INIT_AUDIO failed: %s", SDL_GetError());
 	}
-	FAudio_INTERNAL_InitSIMDFunctions(
-		SDL_HasSSE2(),
-		SDL_HasNEON()
-	);
 }
 
 void FAudio_PlatformRelease()
@@ -415,6 +431,63 @@ void FAudio_PlatformUnlockMutex(FAudioMutex mutex)
 	SDL_UnlockMutex((SDL_Mutex*) mutex);
 }
 
+FAudioSemaphore FAudio_PlatformCreateSemaphore(uint32_t initialValue)
+{
+	return (FAudioSemaphore) SDL_CreateSemaphore(initialValue);
+}
+
+void FAudio_PlatformDestroySemaphore(FAudioSemaphore semaphore)
+{
+	SDL_DestroySemaphore((SDL_Semaphore*) semaphore);
+}
+
+void FAudio_PlatformWaitSemaphore(FAudioSemaphore semaphore)
+{
+	SDL_WaitSemaphore((SDL_Semaphore*) semaphore);
+}
+
+void FAudio_PlatformWaitSemaphoreTimeout(
+	FAudioSemaphore semaphore,
+	uint32_t timeoutMS
+) {
+	SDL_WaitSemaphoreTimeout((SDL_Semaphore*) semaphore, (Sint32) timeoutMS);
+}
+
+void FAudio_PlatformSignalSemaphore(FAudioSemaphore semaphore)
+{
+	SDL_SignalSemaphore((SDL_Semaphore*) semaphore);
+}
+
+uint32_t FAudio_PlatformGetCPUCount(void)
+{
+	return (uint32_t) SDL_GetNumLogicalCPUCores();
+}
+
+int32_t FAudio_PlatformAtomicGet(FAudioAtomic *atomic)
+{
+	return SDL_GetAtomicInt((SDL_AtomicInt*) atomic);
+}
+
+void FAudio_PlatformAtomicSet(FAudioAtomic *atomic, int32_t value)
+{
+	SDL_SetAtomicInt((SDL_AtomicInt*) atomic, value);
+}
+
+int32_t FAudio_PlatformAtomicAdd(FAudioAtomic *atomic, int32_t value)
+{
+	return SDL_AddAtomicInt((SDL_AtomicInt*) atomic, value);
+}
+
+void* FAudio_PlatformAtomicGetPtr(void **ptr)
+{
+	return SDL_GetAtomicPointer(ptr);
+}
+
+void FAudio_PlatformAtomicSetPtr(void **ptr, void *value)
+{
+	SDL_SetAtomicPointer(ptr, value);
+}
+
 void FAudio_sleep(uint32_t ms)
 {
 	SDL_Delay(ms);
@@ -427,6 +500,119 @@ uint32_t FAudio_timems()
 	return (uint32_t)SDL_GetTicks();
 }
 
+uint64_t FAudio_timens()
+{
+	return SDL_GetTicksNS();
+}
+
+/* Memory-mapped files */
+
+#if defined(_WIN32)
+
+void* FAudio_PlatformMapFile(const char *path, size_t *size)
+{
+	HANDLE file, mapping;
+	LARGE_INTEGER len;
+	void *mem;
+
+	file = CreateFileA(
+		path,
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		NULL,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		NULL
+	);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return NULL;
+	}
+	if (!GetFileSizeEx(file, &len) || len.QuadPart <= 0 || len.QuadPart > SIZE_MAX)
+	{
+		CloseHandle(file);
+		return NULL;
+	}
+
+	/* Copy-on-write, so FACT can still byteswap in place */
+	mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	CloseHandle(file);
+	if (mapping == NULL)
+	{
+		return NULL;
+	}
+	mem = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(mapping); /* The view keeps this alive */
+	if (mem == NULL)
+	{
+		return NULL;
+	}
+
+	*size = (size_t) len.QuadPart;
+	return mem;
+}
+
+void FAudio_PlatformUnmapFile(void *mem, size_t size)
+{
+	UnmapViewOfFile(mem);
+}
+
+#elif defined(__unix__) || defined(__APPLE__)
+
+void* FAudio_PlatformMapFile(const char *path, size_t *size)
+{
+	struct stat st;
+	void *mem;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+	{
+		return NULL;
+	}
+	if (fstat(fd, &st) != 0 || st.st_size <= 0)
+	{
+		close(fd);
+		return NULL;
+	}
+
+	/* Copy-on-write, so FACT can still byteswap in place */
+	mem = mmap(
+		NULL,
+		(size_t) st.st_size,
+		PROT_READ | PROT_WRITE,
+		MAP_PRIVATE,
+		fd,
+		0
+	);
+	close(fd); /* The mapping keeps this alive */
+	if (mem == MAP_FAILED)
+	{
+		return NULL;
+	}
+
+	*size = (size_t) st.st_size;
+	return mem;
+}
+
+void FAudio_PlatformUnmapFile(void *mem, size_t size)
+{
+	munmap(mem, size);
+}
+
+#else
+
+void* FAudio_PlatformMapFile(const char *path, size_t *size)
+{
+	return NULL;
+}
+
+void FAudio_PlatformUnmapFile(void *mem, size_t size)
+{
+}
+
+#endif /* _WIN32 */
+
 /* FAudio I/O */
 
 static size_t FAUDIOCALL FAudio_INTERNAL_ioread(
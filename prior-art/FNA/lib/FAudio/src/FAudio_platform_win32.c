@@ -52,6 +52,14 @@ DEFINE_GUID(CLSID_MMDeviceEnumerator, 0xBCDE0395, 0xE52F, 0x467C, 0x8E, 0x3D, 0x
 
 DEFINE_MEDIATYPE_GUID(MFAudioFormat_XMAudio2, FAUDIO_FORMAT_XMAUDIO2);
 
+/* Older SDKs and MinGW headers may not have these yet */
+#ifndef PF_AVX2_INSTRUCTIONS_AVAILABLE
+#define PF_AVX2_INSTRUCTIONS_AVAILABLE 40
+#endif
+#ifndef PF_AVX512F_INSTRUCTIONS_AVAILABLE
+#define PF_AVX512F_INSTRUCTIONS_AVAILABLE 41
+#endif
+
 static CRITICAL_SECTION faudio_cs = { NULL, -1, 0, 0, 0, 0 };
 static IMMDeviceEnumerator *device_enumerator;
 static HRESULT init_hr;
@@ -355,15 +363,6 @@ void FAudio_PlatformInit(
 	IMMDevice *device = NULL;
 	HRESULT hr;
 	HANDLE audioEvent = NULL;
-	BOOL has_sse2 = IsProcessorFeaturePresent(PF_XMMI64_INSTRUCTIONS_AVAILABLE);
-#if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm64ec__) || defined(_M_ARM64EC)
-	BOOL has_neon = TRUE;
-#elif defined(__arm__) || defined(_M_ARM)
-	BOOL has_neon = IsProcessorFeaturePresent(PF_ARM_NEON_INSTRUCTIONS_AVAILABLE);
-#else
-	BOOL has_neon = FALSE;
-#endif
-	FAudio_INTERNAL_InitSIMDFunctions(has_sse2, has_neon);
 	FAudio_resolve_SetThreadDescription();
 
 	FAudio_PlatformAddRef();
@@ -486,6 +485,21 @@ void FAudio_PlatformQuit(void* platformDevice)
 	FAudio_PlatformRelease();
 }
 
+void FAudio_PlatformInitSIMD()
+{
+	BOOL has_sse2 = IsProcessorFeaturePresent(PF_XMMI64_INSTRUCTIONS_AVAILABLE);
+	BOOL has_avx2 = IsProcessorFeaturePresent(PF_AVX2_INSTRUCTIONS_AVAILABLE);
+	BOOL has_avx512f = IsProcessorFeaturePresent(PF_AVX512F_INSTRUCTIONS_AVAILABLE);
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm64ec__) || defined(_M_ARM64EC)
+	BOOL has_neon = TRUE;
+#elif defined(__arm__) || defined(_M_ARM)
+	BOOL has_neon = IsProcessorFeaturePresent(PF_ARM_NEON_INSTRUCTIONS_AVAILABLE);
+#else
+	BOOL has_neon = FALSE;
+#endif
+	FAudio_INTERNAL_InitSIMDFunctions(has_sse2, has_neon, has_avx2, has_avx512f);
+}
+
 void FAudio_PlatformAddRef()
 {
 	HRESULT hr;
@@ -701,6 +715,65 @@ void FAudio_PlatformDestroyMutex(FAudioMutex mutex)
 	FAudio_free(mutex);
 }
 
+FAudioSemaphore FAudio_PlatformCreateSemaphore(uint32_t initialValue)
+{
+	return CreateSemaphoreW(NULL, initialValue, LONG_MAX, NULL);
+}
+
+void FAudio_PlatformDestroySemaphore(FAudioSemaphore semaphore)
+{
+	if (semaphore) CloseHandle(semaphore);
+}
+
+void FAudio_PlatformWaitSemaphore(FAudioSemaphore semaphore)
+{
+	if (semaphore) WaitForSingleObject(semaphore, INFINITE);
+}
+
+void FAudio_PlatformWaitSemaphoreTimeout(
+	FAudioSemaphore semaphore,
+	uint32_t timeoutMS
+) {
+	if (semaphore) WaitForSingleObject(semaphore, timeoutMS);
+}
+
+void FAudio_PlatformSignalSemaphore(FAudioSemaphore semaphore)
+{
+	if (semaphore) ReleaseSemaphore(semaphore, 1, NULL);
+}
+
+uint32_t FAudio_PlatformGetCPUCount(void)
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors;
+}
+
+int32_t FAudio_PlatformAtomicGet(FAudioAtomic *atomic)
+{
+	return InterlockedCompareExchange((volatile LONG*) &atomic->value, 0, 0);
+}
+
+void FAudio_PlatformAtomicSet(FAudioAtomic *atomic, int32_t value)
+{
+	InterlockedExchange((volatile LONG*) &atomic->value, value);
+}
+
+int32_t FAudio_PlatformAtomicAdd(FAudioAtomic *atomic, int32_t value)
+{
+	return InterlockedExchangeAdd((volatile LONG*) &atomic->value, value);
+}
+
+void* FAudio_PlatformAtomicGetPtr(void **ptr)
+{
+	return InterlockedCompareExchangePointer(ptr, NULL, NULL);
+}
+
+void FAudio_PlatformAtomicSetPtr(void **ptr, void *value)
+{
+	InterlockedExchangePointer(ptr, value);
+}
+
 struct FAudioThreadArgs
 {
 	FAudioThreadFunc func;
@@ -761,6 +834,69 @@ uint32_t FAudio_timems()
 	return GetTickCount();
 }
 
+uint64_t FAudio_timens()
+{
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+
+	/* Split up to avoid overflowing on long uptimes */
+	return (
+		((counter.QuadPart / frequency.QuadPart) * 1000000000) +
+		((counter.QuadPart % frequency.QuadPart) * 1000000000 / frequency.QuadPart)
+	);
+}
+
+/* Memory-mapped files */
+
+void* FAudio_PlatformMapFile(const char *path, size_t *size)
+{
+	HANDLE file, mapping;
+	LARGE_INTEGER len;
+	void *mem;
+
+	file = CreateFileA(
+		path,
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		NULL,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		NULL
+	);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return NULL;
+	}
+	if (!GetFileSizeEx(file, &len) || len.QuadPart <= 0 || len.QuadPart > SIZE_MAX)
+	{
+		CloseHandle(file);
+		return NULL;
+	}
+
+	/* Copy-on-write, so FACT can still byteswap in place */
+	mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	CloseHandle(file);
+	if (mapping == NULL)
+	{
+		return NULL;
+	}
+	mem = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(mapping); /* The view keeps this alive */
+	if (mem == NULL)
+	{
+		return NULL;
+	}
+
+	*size = (size_t) len.QuadPart;
+	return mem;
+}
+
+void FAudio_PlatformUnmapFile(void *mem, size_t size)
+{
+	UnmapViewOfFile(mem);
+}
+
 /* FAudio I/O */
 
 static size_t FAUDIOCALL FAudio_FILE_read(
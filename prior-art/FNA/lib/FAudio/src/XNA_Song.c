@@ -86,6 +86,15 @@
 
 #include "qoa_decoder.h"
 
+/* Decoding happens a buffer ahead of playback on its own thread, see
+ * extensions/SongDecoderEXT.txt for the environment variables.
+ */
+#define XNA_SONG_DEFAULT_BUFFERS	4
+#define XNA_SONG_MAX_BUFFERS		16
+#define XNA_SONG_DEFAULT_BUFFER_MS	250
+#define XNA_SONG_MIN_BUFFER_MS		10
+#define XNA_SONG_MAX_BUFFER_MS		5000
+
 /* Globals */
 
 static float songVolume = 1.0f;
@@ -105,43 +114,63 @@ static unsigned int qoaSampleRate = 0;
 static unsigned int qoaSamplesPerChannelPerFrame = 0;
 static unsigned int qoaTotalSamplesPerChannel = 0;
 
+/* songBufferCount buffers of songBufferBytes each, used in order */
 static uint8_t *songCache;
+static uint32_t songBufferCount = XNA_SONG_DEFAULT_BUFFERS;
+static uint32_t songBufferMS = XNA_SONG_DEFAULT_BUFFER_MS;
+static uint32_t songBufferSamples = 0;
+static uint32_t songBufferBytes = 0;
+static uint32_t songDecodeIndex = 0;
+
+static FAudioThread songThread = NULL;
+static FAudioSemaphore songFreeBuffers = NULL;
+static FAudioAtomic songThreadQuit;
 
 /* Internal Functions */
 
-static void XNA_SongSubmitBuffer(FAudioVoiceCallback *callback, void *pBufferContext)
+/* Decodes into the next cache buffer and queues it on songVoice, returning the
+ * number of samples decoded. Only XNA_PlaySong and the decoder thread call
+ * this, never both at the same time.
+ */
+static uint32_t XNA_SongDecodeBuffer()
 {
 	FAudioBuffer buffer;
-	uint32_t decoded = 0;
+	uint8_t *cache = songCache + (songDecodeIndex * songBufferBytes);
+	uint32_t decoded = 0, frame;
 
 	if (activeVorbisSong != NULL)
 	{
 		decoded = stb_vorbis_get_samples_float_interleaved(
 			activeVorbisSong,
 			activeVorbisSongInfo.channels,
-			(float*) songCache,
-			activeVorbisSongInfo.sample_rate * activeVorbisSongInfo.channels
+			(float*) cache,
+			songBufferSamples * activeVorbisSongInfo.channels
 		);
 		buffer.AudioBytes = decoded * activeVorbisSongInfo.channels * sizeof(float);
 	}
 	else if (activeQoaSong != NULL)
 	{
-		/* TODO: decode multiple frames? */
-		decoded = qoa_decode_next_frame(
-			activeQoaSong,
-			(short*) songCache
-		);
+		/* songBufferSamples is a whole number of frames */
+		do
+		{
+			frame = qoa_decode_next_frame(
+				activeQoaSong,
+				((short*) cache) + (decoded * qoaChannels)
+			);
+			decoded += frame;
+		} while (	frame > 0 &&
+				(decoded + qoaSamplesPerChannelPerFrame) <= songBufferSamples	);
 		buffer.AudioBytes = decoded * qoaChannels * sizeof(short);
 	}
 
 	if (decoded == 0)
 	{
-		return;
+		return 0;
 	}
 
 	songOffset += decoded;
 	buffer.Flags = (songOffset >= songLength) ? FAUDIO_END_OF_STREAM : 0;
-	buffer.pAudioData = songCache;
+	buffer.pAudioData = cache;
 	buffer.PlayBegin = 0;
 	buffer.PlayLength = decoded;
 	buffer.LoopBegin = 0;
@@ -153,16 +182,62 @@ static void XNA_SongSubmitBuffer(FAudioVoiceCallback *callback, void *pBufferCon
 		&buffer,
 		NULL
 	);
+
+	songDecodeIndex = (songDecodeIndex + 1) % songBufferCount;
+	return decoded;
+}
+
+/* Buffers finish in the order they were queued, so the one that just ended is
+ * always the next one the decoder thread will write to.
+ */
+static void XNA_SongBufferEnd(FAudioVoiceCallback *callback, void *pBufferContext)
+{
+	FAudio_PlatformSignalSemaphore(songFreeBuffers);
+}
+
+static int32_t FAUDIOCALL XNA_SongThread(void *data)
+{
+	/* Running dry is audible, so keep up with the mixer */
+	FAudio_PlatformThreadPriority(FAUDIO_THREAD_PRIORITY_HIGH);
+
+	while (1)
+	{
+		FAudio_PlatformWaitSemaphore(songFreeBuffers);
+		if (FAudio_PlatformAtomicGet(&songThreadQuit))
+		{
+			break;
+		}
+		if (	XNA_SongDecodeBuffer() == 0 ||
+			songOffset >= songLength	)
+		{
+			/* End of the song, nothing left for us to do */
+			break;
+		}
+	}
+	return 0;
 }
 
 static void XNA_SongKill()
 {
+	/* The thread submits to songVoice, so it has to go first */
+	if (songThread != NULL)
+	{
+		FAudio_PlatformAtomicSet(&songThreadQuit, 1);
+		FAudio_PlatformSignalSemaphore(songFreeBuffers);
+		FAudio_PlatformWaitThread(songThread, NULL);
+		songThread = NULL;
+	}
 	if (songVoice != NULL)
 	{
 		FAudioSourceVoice_Stop(songVoice, 0, 0);
 		FAudioVoice_DestroyVoice(songVoice);
 		songVoice = NULL;
 	}
+	if (songFreeBuffers != NULL)
+	{
+		FAudio_PlatformDestroySemaphore(songFreeBuffers);
+		songFreeBuffers = NULL;
+	}
 	if (songCache != NULL)
 	{
 		FAudio_free(songCache);
@@ -184,6 +259,27 @@ static void XNA_SongKill()
 
 FAUDIOAPI void XNA_SongInit()
 {
+	const char *env;
+
+	env = FAudio_getenv("XNA_SONG_BUFFERS");
+	if (env != NULL)
+	{
+		songBufferCount = (uint32_t) FAudio_clamp(
+			FAudio_atoi(env),
+			2,
+			XNA_SONG_MAX_BUFFERS
+		);
+	}
+	env = FAudio_getenv("XNA_SONG_BUFFER_MS");
+	if (env != NULL)
+	{
+		songBufferMS = (uint32_t) FAudio_clamp(
+			FAudio_atoi(env),
+			XNA_SONG_MIN_BUFFER_MS,
+			XNA_SONG_MAX_BUFFER_MS
+		);
+	}
+
 	FAudioCreate(&songAudio, 0, FAUDIO_DEFAULT_PROCESSOR);
 	FAudio_CreateMasteringVoice(
 		songAudio,
@@ -249,11 +345,26 @@ FAUDIOAPI float XNA_PlaySong(const char *name)
 	}
 
 	/* Allocate decode cache */
-	songCache = (uint8_t*) FAudio_malloc(format.nAvgBytesPerSec);
+	songBufferSamples = (uint32_t) (
+		(uint64_t) format.nSamplesPerSec * songBufferMS / 1000
+	);
+	if (activeQoaSong != NULL && qoaSamplesPerChannelPerFrame > 0)
+	{
+		/* Round down to whole frames, but always at least one */
+		songBufferSamples -= songBufferSamples % qoaSamplesPerChannelPerFrame;
+		songBufferSamples = FAudio_max(
+			songBufferSamples,
+			qoaSamplesPerChannelPerFrame
+		);
+	}
+	songBufferSamples = FAudio_max(songBufferSamples, 1);
+	songBufferBytes = songBufferSamples * format.nBlockAlign;
+	songCache = (uint8_t*) FAudio_malloc(songBufferBytes * songBufferCount);
+	songDecodeIndex = 0;
 
 	/* Init voice */
 	FAudio_zero(&callbacks, sizeof(FAudioVoiceCallback));
-	callbacks.OnBufferEnd = XNA_SongSubmitBuffer;
+	callbacks.OnBufferEnd = XNA_SongBufferEnd;
 	FAudio_CreateSourceVoice(
 		songAudio,
 		&songVoice,
@@ -276,7 +387,22 @@ FAUDIOAPI float XNA_PlaySong(const char *name)
 		qoa_seek_frame(activeQoaSong, 0);
 	}
 
-	XNA_SongSubmitBuffer(NULL, NULL);
+	/* The first buffer is decoded right away, so the song isn't considered
+	 * finished before the decoder thread gets to it. The thread then keeps
+	 * the rest of the buffers queued up.
+	 */
+	songFreeBuffers = FAudio_PlatformCreateSemaphore(songBufferCount - 1);
+	if (	XNA_SongDecodeBuffer() > 0 &&
+		songOffset < songLength	)
+	{
+		FAudio_PlatformAtomicSet(&songThreadQuit, 0);
+		songThread = FAudio_PlatformCreateThread(
+			XNA_SongThread,
+			"XNA_Song Decoder",
+			NULL
+		);
+		FAudio_assert(songThread != NULL);
+	}
 
 	/* Finally. */
 	FAudioSourceVoice_Start(songVoice, 0, 0);
@@ -355,6 +481,368 @@ FAUDIOAPI void XNA_GetSongVisualizationData(
 	/* TODO: Visualization FAPO that reads in Song samples, FFT analysis */
 }
 
+/* Vorbis/QOA Source Voices, see "extensions/CompressedVoiceEXT.txt" */
+
+FAudioCompressedDecoder* FAudio_INTERNAL_OpenCompressed(
+	FAudioSourceVoice *voice,
+	const FAudioBuffer *buffer
+) {
+	FAudioCompressedDecoder *decoder;
+	stb_vorbis_info info;
+	unsigned int channels, sampleRate, frameLength, length;
+	int error;
+
+	decoder = (FAudioCompressedDecoder*) voice->audio->pMalloc(
+		sizeof(FAudioCompressedDecoder)
+	);
+	FAudio_zero(decoder, sizeof(FAudioCompressedDecoder));
+	decoder->formatTag = voice->src.format->wFormatTag;
+	decoder->channels = voice->src.format->nChannels;
+
+	/* Both decoders read straight from pAudioData, nothing is copied */
+	if (decoder->formatTag == FAUDIO_FORMAT_VORBIS_EXT)
+	{
+		decoder->vorbis = stb_vorbis_open_memory(
+			buffer->pAudioData,
+			(int) buffer->AudioBytes,
+			&error,
+			NULL
+		);
+		if (decoder->vorbis == NULL)
+		{
+			LOG_ERROR(
+				voice->audio,
+				"%p: stb_vorbis_open_memory failed, error %d",
+				(void*) voice,
+				error
+			)
+			goto fail;
+		}
+		info = stb_vorbis_get_info(decoder->vorbis);
+		channels = (unsigned int) info.channels;
+		sampleRate = info.sample_rate;
+		length = stb_vorbis_stream_length_in_samples(decoder->vorbis);
+		decoder->lookahead = (float*) voice->audio->pMalloc(
+			sizeof(float) * EXTRA_DECODE_PADDING * decoder->channels
+		);
+	}
+	else
+	{
+		decoder->qoa = qoa_open_from_memory(
+			(unsigned char*) buffer->pAudioData,
+			buffer->AudioBytes,
+			0
+		);
+		if (decoder->qoa == NULL)
+		{
+			LOG_ERROR(
+				voice->audio,
+				"%p: qoa_open_from_memory failed",
+				(void*) voice
+			)
+			goto fail;
+		}
+		qoa_attributes(
+			decoder->qoa,
+			&channels,
+			&sampleRate,
+			&frameLength,
+			&length
+		);
+
+		/* Frames are always QOA_FRAME_LEN long except for the last one,
+		 * that's what lets qoa_seek_frame find them
+		 */
+		decoder->frame = ~0u;
+		decoder->frameData = (int16_t*) voice->audio->pMalloc(
+			sizeof(int16_t) * QOA_FRAME_LEN * channels
+		);
+	}
+
+	if (	channels != decoder->channels ||
+		sampleRate != voice->src.format->nSamplesPerSec ||
+		length == 0	)
+	{
+		LOG_ERROR(
+			voice->audio,
+			"%p: buffer is %u channels at %u Hz with %u samples, voice is %u channels at %u Hz",
+			(void*) voice,
+			channels,
+			sampleRate,
+			length,
+			voice->src.format->nChannels,
+			voice->src.format->nSamplesPerSec
+		)
+		goto fail;
+	}
+	decoder->length = length;
+	return decoder;
+
+fail:
+	FAudio_INTERNAL_CloseCompressed(voice->audio, decoder);
+	return NULL;
+}
+
+void FAudio_INTERNAL_CloseCompressed(
+	FAudio *audio,
+	FAudioCompressedDecoder *decoder
+) {
+	if (decoder->vorbis != NULL)
+	{
+		stb_vorbis_close(decoder->vorbis);
+	}
+	if (decoder->lookahead != NULL)
+	{
+		audio->pFree(decoder->lookahead);
+	}
+	if (decoder->qoa != NULL)
+	{
+		qoa_close(decoder->qoa);
+	}
+	if (decoder->frameData != NULL)
+	{
+		audio->pFree(decoder->frameData);
+	}
+	audio->pFree(decoder);
+}
+
+/* Decodes [offset, offset + samples), the rest is silent if the file turns out
+ * to be shorter than it claimed
+ */
+static void FAudio_INTERNAL_ReadVorbis(
+	FAudioCompressedDecoder *decoder,
+	uint32_t offset,
+	float *dst,
+	uint32_t samples
+) {
+	uint32_t done = 0, keep;
+	int decoded;
+
+	/* The mixer's padding read leaves us a little past the next offset */
+	if (	offset < decoder->position &&
+		(decoder->position - offset) <= decoder->lookaheadCount	)
+	{
+		done = FAudio_min(samples, decoder->position - offset);
+		FAudio_memcpy(
+			dst,
+			decoder->lookahead + (
+				(decoder->lookaheadCount - (decoder->position - offset)) *
+				decoder->channels
+			),
+			sizeof(float) * done * decoder->channels
+		);
+		if (done == samples)
+		{
+			return;
+		}
+	}
+
+	/* Otherwise reads are sequential until the buffer loops, seeking is
+	 * expensive
+	 */
+	else if (decoder->position != offset)
+	{
+		decoder->lookaheadCount = 0;
+		if (!stb_vorbis_seek(decoder->vorbis, offset))
+		{
+			/* Who knows where we are now, seek again next time */
+			decoder->position = ~0u;
+			FAudio_zero(dst, sizeof(float) * samples * decoder->channels);
+			return;
+		}
+		decoder->position = offset;
+	}
+
+	while (done < samples)
+	{
+		decoded = stb_vorbis_get_samples_float_interleaved(
+			decoder->vorbis,
+			decoder->channels,
+			dst + (done * decoder->channels),
+			(int) ((samples - done) * decoder->channels)
+		);
+		if (decoded <= 0)
+		{
+			break;
+		}
+		done += (uint32_t) decoded;
+		decoder->position += (uint32_t) decoded;
+	}
+
+	/* Everything in dst up to here ends at position, keep the tail */
+	keep = FAudio_min(done, EXTRA_DECODE_PADDING);
+	if (keep > 0)
+	{
+		FAudio_memcpy(
+			decoder->lookahead,
+			dst + ((done - keep) * decoder->channels),
+			sizeof(float) * keep * decoder->channels
+		);
+		decoder->lookaheadCount = keep;
+	}
+
+	if (done < samples)
+	{
+		FAudio_zero(
+			dst + (done * decoder->channels),
+			sizeof(float) * (samples - done) * decoder->channels
+		);
+	}
+}
+
+/* Decodes a QOA frame into frameData, returning its length */
+static uint32_t FAudio_INTERNAL_ReadQOAFrame(
+	FAudioCompressedDecoder *decoder,
+	uint32_t frame
+) {
+	qoa_data *data = (qoa_data*) decoder->qoa;
+	uint64_t p = 8 + ((uint64_t) frame * data->frame_size);
+
+	if (frame == decoder->frame)
+	{
+		return decoder->frameSamples;
+	}
+
+	/* qoa_decode_next_frame trusts the sample count in the frame header,
+	 * so make sure it fits before it gets written to frameData
+	 */
+	decoder->frame = frame;
+	decoder->frameSamples = 0;
+	if (	(p + 8) <= data->size &&
+		((data->bytes[p + 4] << 8) | data->bytes[p + 5]) <= QOA_FRAME_LEN	)
+	{
+		qoa_seek_frame(decoder->qoa, (int) frame);
+		decoder->frameSamples = qoa_decode_next_frame(
+			decoder->qoa,
+			decoder->frameData
+		);
+	}
+	return decoder->frameSamples;
+}
+
+void FAudio_INTERNAL_DecodeCompressedEntire(
+	FAudioCompressedDecoder *decoder,
+	void *pcm
+) {
+	int16_t *dst = (int16_t*) pcm;
+	uint32_t frame, frameSamples, copy;
+
+	if (decoder->vorbis != NULL)
+	{
+		FAudio_INTERNAL_ReadVorbis(decoder, 0, (float*) pcm, decoder->length);
+		return;
+	}
+
+	for (frame = 0; (frame * QOA_FRAME_LEN) < decoder->length; frame += 1)
+	{
+		frameSamples = FAudio_INTERNAL_ReadQOAFrame(decoder, frame);
+		copy = FAudio_min(
+			decoder->length - (frame * QOA_FRAME_LEN),
+			QOA_FRAME_LEN
+		);
+		FAudio_memcpy(
+			dst,
+			decoder->frameData,
+			sizeof(int16_t) * FAudio_min(frameSamples, copy) * decoder->channels
+		);
+		if (frameSamples < copy)
+		{
+			FAudio_zero(
+				dst + (frameSamples * decoder->channels),
+				sizeof(int16_t) * (copy - frameSamples) * decoder->channels
+			);
+		}
+		dst += copy * decoder->channels;
+	}
+}
+
+void FAudio_INTERNAL_DecodeVorbis(
+	FAudioVoice *voice,
+	FAudioBuffer *buffer,
+	float *decodeCache,
+	uint32_t samples
+) {
+	/* Buffers always live in an entry, see FAudioBufferEntry */
+	FAudioBufferEntry *entry = (FAudioBufferEntry*) buffer;
+	const uint32_t channels = voice->src.format->nChannels;
+
+	LOG_FUNC_ENTER(voice->audio)
+
+	/* Already decoded at submission? */
+	if (entry->adpcm != NULL)
+	{
+		FAudio_memcpy(
+			decodeCache,
+			(float*) entry->adpcm->pcm + (voice->src.curBufferOffset * channels),
+			sizeof(float) * samples * channels
+		);
+	}
+	else if (entry->compressed != NULL) /* NULL for empty buffers */
+	{
+		FAudio_INTERNAL_ReadVorbis(
+			entry->compressed,
+			voice->src.curBufferOffset,
+			decodeCache,
+			samples
+		);
+	}
+	LOG_FUNC_EXIT(voice->audio)
+}
+
+void FAudio_INTERNAL_DecodeQOA(
+	FAudioVoice *voice,
+	FAudioBuffer *buffer,
+	float *decodeCache,
+	uint32_t samples
+) {
+	/* Buffers always live in an entry, see FAudioBufferEntry */
+	FAudioBufferEntry *entry = (FAudioBufferEntry*) buffer;
+	FAudioCompressedDecoder *decoder = entry->compressed;
+	const uint32_t channels = voice->src.format->nChannels;
+	uint32_t offset, frame, frameSamples, midOffset, copy, done = 0;
+
+	LOG_FUNC_ENTER(voice->audio)
+
+	/* Already decoded at submission? */
+	if (entry->adpcm != NULL)
+	{
+		FAudio_INTERNAL_Convert_S16_To_F32(
+			(int16_t*) entry->adpcm->pcm + (voice->src.curBufferOffset * channels),
+			decodeCache,
+			samples * channels
+		);
+		LOG_FUNC_EXIT(voice->audio)
+		return;
+	}
+
+	/* Frames are independent, so seeking is just picking the frame */
+	offset = voice->src.curBufferOffset;
+	while (done < samples && decoder != NULL)
+	{
+		frame = offset / QOA_FRAME_LEN;
+		midOffset = offset % QOA_FRAME_LEN;
+		frameSamples = FAudio_INTERNAL_ReadQOAFrame(decoder, frame);
+		if (midOffset >= frameSamples)
+		{
+			/* Truncated file, play silence for the rest */
+			FAudio_zero(
+				decodeCache + (done * channels),
+				sizeof(float) * (samples - done) * channels
+			);
+			break;
+		}
+		copy = FAudio_min(samples - done, frameSamples - midOffset);
+		FAudio_INTERNAL_Convert_S16_To_F32(
+			decoder->frameData + (midOffset * channels),
+			decodeCache + (done * channels),
+			copy * channels
+		);
+		done += copy;
+		offset += copy;
+	}
+	LOG_FUNC_EXIT(voice->audio)
+}
+
 #endif /* DISABLE_XNASONG */
 
 /* vim: set noexpandtab shiftwidth=8 tabstop=8: */
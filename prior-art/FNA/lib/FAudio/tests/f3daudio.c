@@ -0,0 +1,286 @@
+/* F3DAudio batch tests
+ *
+ * This checks F3DAudioCalculateBatchEXT against F3DAudioCalculate, which has
+ * to give the same answer for every emitter, bit for bit. The emitters,
+ * curves, cones and flags are all randomized from a fixed seed.
+ *
+ * Copyright (c) 2011-2024 Ethan Lee, Luigi Auriemma, and the MonoGame Team
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software in a
+ * product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <F3DAudio.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* More than one batch block, and not a multiple of it */
+#define MAX_EMITTERS 333
+#define MAX_CHANNELS 8
+#define ITERATIONS 400
+#define SPEED_OF_SOUND 343.5f
+
+static int failure_count = 0;
+static int success_count = 0;
+
+#define ok(success, fmt, ...) ok_(__FILE__, __LINE__, success, fmt, ##__VA_ARGS__)
+static void ok_(const char *file, int line, int success, const char *fmt, ...)
+{
+    if(!success){
+        va_list va;
+        va_start(va, fmt);
+        fprintf(stdout, "test failed (%s:%u): ", file, line);
+        vfprintf(stdout, fmt, va);
+        va_end(va);
+        ++failure_count;
+    }else
+        ++success_count;
+}
+
+static float random_float(float range)
+{
+    return ((float) rand() / RAND_MAX * 2.0f - 1.0f) * range;
+}
+
+static const uint32_t speaker_masks[] = {
+    SPEAKER_MONO,
+    SPEAKER_STEREO,
+    SPEAKER_QUAD,
+    SPEAKER_5POINT1,
+    SPEAKER_7POINT1_SURROUND
+};
+static const uint32_t speaker_counts[] = { 1, 2, 4, 6, 8 };
+
+static F3DAUDIO_CONE cone = {
+    F3DAUDIO_PI / 2.0f, F3DAUDIO_PI,
+    1.0f, 0.5f,
+    0.9f, 0.3f,
+    1.0f, 0.5f
+};
+
+static F3DAUDIO_DISTANCE_CURVE_POINT curve_points[3] = {
+    { 0.0f, 1.0f },
+    { 0.3f, 0.6f },
+    { 1.0f, 0.1f }
+};
+static F3DAUDIO_DISTANCE_CURVE curve = { curve_points, 3 };
+
+static float azimuths[2] = { 0.3f, F3DAUDIO_2PI - 0.3f };
+
+static float px[MAX_EMITTERS], py[MAX_EMITTERS], pz[MAX_EMITTERS];
+static float vx[MAX_EMITTERS], vy[MAX_EMITTERS], vz[MAX_EMITTERS];
+static float fx[MAX_EMITTERS], fy[MAX_EMITTERS], fz[MAX_EMITTERS];
+static float tx[MAX_EMITTERS], ty[MAX_EMITTERS], tz[MAX_EMITTERS];
+static float scalar_matrix[MAX_EMITTERS][2 * MAX_CHANNELS];
+static float batch_matrix[MAX_EMITTERS][2 * MAX_CHANNELS];
+static F3DAUDIO_DSP_SETTINGS scalar_settings[MAX_EMITTERS];
+static F3DAUDIO_DSP_SETTINGS batch_settings[MAX_EMITTERS];
+
+static uint32_t random_flags(uint32_t speakerMask)
+{
+    uint32_t flags = 0;
+
+    if (rand() & 1) flags |= F3DAUDIO_CALCULATE_LPF_DIRECT;
+    if (rand() & 1) flags |= F3DAUDIO_CALCULATE_LPF_REVERB;
+    if (rand() & 1) flags |= F3DAUDIO_CALCULATE_REVERB;
+    if (rand() & 1) flags |= F3DAUDIO_CALCULATE_DOPPLER;
+    if (rand() & 1) flags |= F3DAUDIO_CALCULATE_EMITTER_ANGLE;
+
+    /* Mostly matrix, since that's where most of the work is */
+    if (rand() % 4)
+    {
+        flags |= F3DAUDIO_CALCULATE_MATRIX;
+        if ((speakerMask & SPEAKER_FRONT_CENTER) && (rand() & 1))
+        {
+            flags |= F3DAUDIO_CALCULATE_ZEROCENTER;
+        }
+        if ((speakerMask & SPEAKER_LOW_FREQUENCY) && (rand() & 1))
+        {
+            flags |= F3DAUDIO_CALCULATE_REDIRECT_TO_LFE;
+        }
+    }
+    return flags;
+}
+
+static void test_batch(void)
+{
+    F3DAUDIO_HANDLE instance;
+    F3DAUDIO_LISTENER listener;
+    F3DAUDIO_EMITTER template, emitter;
+    F3DAUDIO_EMITTER_BATCH_EXT batch;
+    uint32_t iter, i, k, count, channels, flags, matrixSize, mismatches;
+    int useVelocity, useOrient;
+    float slope;
+
+    srand(1);
+    for (iter = 0; iter < ITERATIONS; iter += 1)
+    {
+        k = iter % (sizeof(speaker_masks) / sizeof(speaker_masks[0]));
+        F3DAudioInitialize(speaker_masks[k], SPEED_OF_SOUND, instance);
+        flags = random_flags(speaker_masks[k]);
+        channels = (rand() & 1) + 1;
+        count = rand() % MAX_EMITTERS + 1;
+        useVelocity = rand() & 1;
+        useOrient = rand() & 1;
+
+        memset(&listener, 0, sizeof(listener));
+        listener.OrientFront.z = 1.0f;
+        listener.OrientTop.y = 1.0f;
+        listener.Position.x = random_float(10.0f);
+        listener.Position.y = random_float(2.0f);
+        listener.Position.z = random_float(10.0f);
+        listener.Velocity.x = random_float(5.0f);
+        listener.Velocity.z = random_float(5.0f);
+        listener.pCone = (rand() & 1) ? &cone : NULL;
+
+        memset(&template, 0, sizeof(template));
+        template.OrientFront.z = 1.0f;
+        template.OrientTop.y = 1.0f;
+        template.Velocity.x = random_float(3.0f);
+        template.ChannelCount = channels;
+        template.ChannelRadius = 1.0f;
+        template.pChannelAzimuths = azimuths;
+        template.CurveDistanceScaler = 1.5f + random_float(0.5f);
+        template.DopplerScaler = (rand() % 3) ? 1.0f + random_float(1.0f) : 0.0f;
+        template.InnerRadius = (rand() & 1) ? 2.0f : 0.0f;
+        template.InnerRadiusAngle = (rand() & 1) ? F3DAUDIO_PI / 8.0f : 0.0f;
+        template.pCone = (rand() & 1) ? &cone : NULL;
+        template.pVolumeCurve = (rand() & 1) ? &curve : NULL;
+        template.pLFECurve = (rand() & 1) ? &curve : NULL;
+        template.pLPFDirectCurve = (rand() & 1) ? &curve : NULL;
+        template.pLPFReverbCurve = (rand() & 1) ? &curve : NULL;
+        template.pReverbCurve = (rand() & 1) ? &curve : NULL;
+
+        for (i = 0; i < count; i += 1)
+        {
+            /* Some emitters sit right on the listener */
+            if (i % 17 == 0)
+            {
+                px[i] = listener.Position.x;
+                py[i] = listener.Position.y;
+                pz[i] = listener.Position.z;
+            }
+            else
+            {
+                px[i] = random_float(30.0f);
+                py[i] = random_float(3.0f);
+                pz[i] = random_float(30.0f);
+            }
+
+            /* Fast enough to clamp the doppler factor now and then */
+            vx[i] = random_float(400.0f);
+            vy[i] = random_float(1.0f);
+            vz[i] = random_float(400.0f);
+
+            /* Unit length without libm, the slope can be anything */
+            slope = random_float(4.0f);
+            fx[i] = 2.0f * slope / (1.0f + slope * slope);
+            fy[i] = 0.0f;
+            fz[i] = (1.0f - slope * slope) / (1.0f + slope * slope);
+            tx[i] = 0.0f;
+            ty[i] = 1.0f;
+            tz[i] = 0.0f;
+        }
+
+        batch.pTemplate = &template;
+        batch.EmitterCount = count;
+        batch.pPositionX = px;
+        batch.pPositionY = py;
+        batch.pPositionZ = pz;
+        batch.pVelocityX = useVelocity ? vx : NULL;
+        batch.pVelocityY = vy;
+        batch.pVelocityZ = vz;
+        batch.pOrientFrontX = useOrient ? fx : NULL;
+        batch.pOrientFrontY = fy;
+        batch.pOrientFrontZ = fz;
+        batch.pOrientTopX = useOrient ? tx : NULL;
+        batch.pOrientTopY = ty;
+        batch.pOrientTopZ = tz;
+
+        /* Garbage in anything that isn't written, so that can't differ */
+        memset(scalar_settings, 0xAB, sizeof(scalar_settings));
+        memset(batch_settings, 0xAB, sizeof(batch_settings));
+        memset(scalar_matrix, 0xAB, sizeof(scalar_matrix));
+        memset(batch_matrix, 0xAB, sizeof(batch_matrix));
+        for (i = 0; i < count; i += 1)
+        {
+            scalar_settings[i].pMatrixCoefficients = scalar_matrix[i];
+            scalar_settings[i].pDelayTimes = NULL;
+            scalar_settings[i].SrcChannelCount = channels;
+            scalar_settings[i].DstChannelCount = speaker_counts[k];
+            batch_settings[i] = scalar_settings[i];
+            batch_settings[i].pMatrixCoefficients = batch_matrix[i];
+
+            emitter = template;
+            emitter.Position.x = px[i];
+            emitter.Position.y = py[i];
+            emitter.Position.z = pz[i];
+            if (useVelocity)
+            {
+                emitter.Velocity.x = vx[i];
+                emitter.Velocity.y = vy[i];
+                emitter.Velocity.z = vz[i];
+            }
+            if (useOrient)
+            {
+                emitter.OrientFront.x = fx[i];
+                emitter.OrientFront.y = fy[i];
+                emitter.OrientFront.z = fz[i];
+                emitter.OrientTop.x = tx[i];
+                emitter.OrientTop.y = ty[i];
+                emitter.OrientTop.z = tz[i];
+            }
+            F3DAudioCalculate(instance, &listener, &emitter, flags, &scalar_settings[i]);
+        }
+        F3DAudioCalculateBatchEXT(instance, &listener, &batch, flags, batch_settings);
+
+        matrixSize = sizeof(float) * channels * speaker_counts[k];
+        mismatches = 0;
+        for (i = 0; i < count; i += 1)
+        {
+            batch_settings[i].pMatrixCoefficients = scalar_matrix[i];
+            if (    memcmp(&scalar_settings[i], &batch_settings[i], sizeof(F3DAUDIO_DSP_SETTINGS)) != 0 ||
+                    memcmp(scalar_matrix[i], batch_matrix[i], matrixSize) != 0    )
+            {
+                mismatches += 1;
+            }
+        }
+        ok(mismatches == 0, "Batch differs from F3DAudioCalculate for %u of %u emitters (mask 0x%x, flags 0x%x, iteration %u)\n",
+           mismatches, count, speaker_masks[k], flags, iter);
+    }
+
+    /* An empty batch has nothing to read and nothing to write */
+    batch.EmitterCount = 0;
+    batch.pPositionX = NULL;
+    batch.pPositionY = NULL;
+    batch.pPositionZ = NULL;
+    F3DAudioCalculateBatchEXT(instance, &listener, &batch, flags, NULL);
+}
+
+int main(int argc, char **argv)
+{
+    test_batch();
+
+    fprintf(stdout, "Finished with %u successful tests and %u failed tests.\n",
+            success_count, failure_count);
+
+    return failure_count > 0;
+}
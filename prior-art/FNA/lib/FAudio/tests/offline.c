@@ -0,0 +1,1256 @@
+/* FAudio offline render tests
+ *
+ * This checks FAUDIO_OFFLINE_RENDER_EXT and FAudio_RenderEXT, which have no
+ * XAudio2 equivalent, along with the timing records that offline rendering
+ * makes easy to check. No audio device is needed to run these.
+ *
+ * Copyright (c) 2011-2024 Ethan Lee, Luigi Auriemma, and the MonoGame Team
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software in a
+ * product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include <FAudio.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RATE 48000
+#define CHANNELS 2
+#define QUANTA 8
+#define BUFFER_QUANTA 3
+
+static int failure_count = 0;
+static int success_count = 0;
+
+#define ok(success, fmt, ...) ok_(__FILE__, __LINE__, success, fmt, ##__VA_ARGS__)
+static void ok_(const char *file, int line, int success, const char *fmt, ...)
+{
+    if(!success){
+        va_list va;
+        va_start(va, fmt);
+        fprintf(stdout, "test failed (%s:%u): ", file, line);
+        vfprintf(stdout, fmt, va);
+        va_end(va);
+        ++failure_count;
+    }else
+        ++success_count;
+}
+
+static uint32_t buffer_ends;
+
+static void FAUDIOCALL OnBufferEnd(FAudioVoiceCallback *callback, void *context)
+{
+    ++buffer_ends;
+}
+
+static void FAUDIOCALL OnVoiceProcessingPassStart(FAudioVoiceCallback *callback, uint32_t bytes)
+{
+}
+
+static void FAUDIOCALL OnVoiceProcessingPassEnd(FAudioVoiceCallback *callback)
+{
+}
+
+static void FAUDIOCALL OnStreamEnd(FAudioVoiceCallback *callback)
+{
+}
+
+static void FAUDIOCALL OnBufferStart(FAudioVoiceCallback *callback, void *context)
+{
+}
+
+static void FAUDIOCALL OnLoopEnd(FAudioVoiceCallback *callback, void *context)
+{
+}
+
+static void FAUDIOCALL OnVoiceError(FAudioVoiceCallback *callback, void *context, uint32_t error)
+{
+}
+
+static FAudioVoiceCallback callbacks = {
+    OnBufferEnd,
+    OnBufferStart,
+    OnLoopEnd,
+    OnStreamEnd,
+    OnVoiceError,
+    OnVoiceProcessingPassEnd,
+    OnVoiceProcessingPassStart
+};
+
+/* Renders QUANTA updates of a short stereo ramp, with the engine stopped for
+ * the first update, and returns the quantum size in frames.
+ */
+static uint32_t render_session(float *output, uint32_t flags)
+{
+    FAudio *audio;
+    FAudioMasteringVoice *master;
+    FAudioSourceVoice *src;
+    FAudioWaveFormatEx fmt;
+    FAudioBuffer buffer;
+    float *samples;
+    uint32_t quantum, rate, i, hr;
+
+    hr = FAudioCreate(&audio, FAUDIO_OFFLINE_RENDER_EXT | flags, FAUDIO_DEFAULT_PROCESSOR);
+    ok(hr == 0, "FAudioCreate failed: %08x\n", hr);
+
+    hr = FAudio_CreateMasteringVoice(audio, &master, FAUDIO_DEFAULT_CHANNELS,
+            FAUDIO_DEFAULT_SAMPLERATE, 0, 0, NULL);
+    ok(hr == 0, "CreateMasteringVoice failed: %08x\n", hr);
+
+    FAudio_GetProcessingQuantum(audio, &quantum, &rate);
+    ok(rate == RATE, "Got wrong default rate: %u\n", rate);
+    if(flags & FAUDIO_1024_QUANTUM)
+        ok(quantum == 1024, "Got wrong quantum: %u\n", quantum);
+    else
+        ok(quantum == RATE / 100, "Got wrong quantum: %u\n", quantum);
+
+    fmt.wFormatTag = FAUDIO_FORMAT_IEEE_FLOAT;
+    fmt.nChannels = CHANNELS;
+    fmt.nSamplesPerSec = RATE;
+    fmt.wBitsPerSample = 32;
+    fmt.nBlockAlign = fmt.nChannels * fmt.wBitsPerSample / 8;
+    fmt.nAvgBytesPerSec = fmt.nSamplesPerSec * fmt.nBlockAlign;
+    fmt.cbSize = 0;
+
+    hr = FAudio_CreateSourceVoice(audio, &src, &fmt, FAUDIO_VOICE_NOPITCH | FAUDIO_VOICE_NOSRC,
+            1.0f, &callbacks, NULL, NULL);
+    ok(hr == 0, "CreateSourceVoice failed: %08x\n", hr);
+
+    samples = malloc(sizeof(float) * quantum * BUFFER_QUANTA * CHANNELS);
+    for(i = 0; i < quantum * BUFFER_QUANTA * CHANNELS; ++i)
+        samples[i] = (float) i / (float) (quantum * BUFFER_QUANTA * CHANNELS);
+
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.AudioBytes = sizeof(float) * quantum * BUFFER_QUANTA * CHANNELS;
+    buffer.pAudioData = (uint8_t*) samples;
+    buffer.Flags = FAUDIO_END_OF_STREAM;
+    FAudioSourceVoice_SubmitSourceBuffer(src, &buffer, NULL);
+    FAudioSourceVoice_Start(src, 0, FAUDIO_COMMIT_NOW);
+
+    buffer_ends = 0;
+
+    /* Stopped engines render silence, and don't consume any buffers */
+    FAudio_StopEngine(audio);
+    FAudio_RenderEXT(audio, output, 1);
+    for(i = 0; i < quantum * CHANNELS; ++i)
+        if(output[i] != 0.0f)
+            break;
+    ok(i == quantum * CHANNELS, "Stopped engine rendered audio at %u\n", i);
+
+    FAudio_StartEngine(audio);
+    hr = FAudio_RenderEXT(audio, output + quantum * CHANNELS, QUANTA - 1);
+    ok(hr == 0, "RenderEXT failed: %08x\n", hr);
+    ok(buffer_ends == 1, "Got %u buffer ends\n", buffer_ends);
+
+    /* Stereo to stereo at the same rate, so the ramp should come out as-is */
+    for(i = 0; i < quantum * BUFFER_QUANTA * CHANNELS; ++i)
+        if(output[quantum * CHANNELS + i] != samples[i])
+            break;
+    ok(i == quantum * BUFFER_QUANTA * CHANNELS, "Ramp mismatch at %u\n", i);
+    for(i = quantum * (BUFFER_QUANTA + 1) * CHANNELS; i < quantum * QUANTA * CHANNELS; ++i)
+        if(output[i] != 0.0f)
+            break;
+    ok(i == quantum * QUANTA * CHANNELS, "Rendered audio past the buffer at %u\n", i);
+
+    FAudioVoice_DestroyVoice(src);
+    FAudioVoice_DestroyVoice(master);
+
+    /* No mastering voice, nothing to render */
+    hr = FAudio_RenderEXT(audio, output, 1);
+    ok(hr == FAUDIO_E_INVALID_CALL, "RenderEXT without a master: %08x\n", hr);
+
+    FAudio_Release(audio);
+    free(samples);
+    return quantum;
+}
+
+static void test_render(uint32_t flags)
+{
+    float *first, *second;
+    uint32_t quantum;
+    size_t len = sizeof(float) * 1024 * QUANTA * CHANNELS;
+
+    first = malloc(len);
+    second = malloc(len);
+    memset(second, 0xFF, len);
+
+    quantum = render_session(first, flags);
+    render_session(second, flags);
+    ok(memcmp(first, second, sizeof(float) * quantum * QUANTA * CHANNELS) == 0,
+            "Offline renders are not deterministic\n");
+
+    free(first);
+    free(second);
+}
+
+/* Timing needs the debug configuration, which release builds compile out */
+static void test_timing(void)
+{
+    FAudio *audio;
+    FAudioMasteringVoice *master;
+    FAudioSourceVoice *src;
+    FAudioWaveFormatEx fmt;
+    FAudioBuffer buffer;
+    FAudioDebugConfiguration debug;
+    FAudioQuantumTimingEXT timings[QUANTA + 1];
+    FAudioVoiceTimingEXT voiceTiming;
+    int16_t *samples;
+    float *output;
+    uint32_t quantum, count, i;
+
+    FAudioCreate(&audio, FAUDIO_OFFLINE_RENDER_EXT, FAUDIO_DEFAULT_PROCESSOR);
+    memset(&debug, 0, sizeof(debug));
+    debug.TraceMask = FAUDIO_LOG_TIMING;
+    FAudio_SetDebugConfiguration(audio, &debug, NULL);
+    FAudio_CreateMasteringVoice(audio, &master, CHANNELS, RATE, 0, 0, NULL);
+    FAudio_GetProcessingQuantum(audio, &quantum, NULL);
+
+    fmt.wFormatTag = FAUDIO_FORMAT_PCM;
+    fmt.nChannels = 1;
+    fmt.nSamplesPerSec = 44100;
+    fmt.wBitsPerSample = 16;
+    fmt.nBlockAlign = 2;
+    fmt.nAvgBytesPerSec = fmt.nSamplesPerSec * fmt.nBlockAlign;
+    fmt.cbSize = 0;
+    FAudio_CreateSourceVoice(audio, &src, &fmt, 0, FAUDIO_DEFAULT_FREQ_RATIO, NULL, NULL, NULL);
+
+    samples = calloc(fmt.nSamplesPerSec, sizeof(int16_t));
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.AudioBytes = fmt.nSamplesPerSec * sizeof(int16_t);
+    buffer.pAudioData = (uint8_t*) samples;
+    buffer.LoopCount = FAUDIO_LOOP_INFINITE;
+    FAudioSourceVoice_SubmitSourceBuffer(src, &buffer, NULL);
+    FAudioSourceVoice_Start(src, 0, FAUDIO_COMMIT_NOW);
+
+    output = malloc(sizeof(float) * quantum * CHANNELS * QUANTA);
+    FAudio_RenderEXT(audio, output, QUANTA);
+
+    count = FAudio_GetQuantumTimingsEXT(audio, timings, QUANTA + 1);
+    if(count == 0){
+        fprintf(stdout, "Skipping timing tests, debug configuration is disabled\n");
+        goto end;
+    }
+    ok(count == QUANTA, "Got %u timing records\n", count);
+    for(i = 0; i < count; ++i){
+        ok(timings[i].Quantum == timings[0].Quantum + i, "Record %u is quantum %llu\n",
+                i, (unsigned long long) timings[i].Quantum);
+        ok(timings[i].DroppedQuanta == 0, "Record %u dropped %u\n", i, timings[i].DroppedQuanta);
+        ok(timings[i].TotalNS >= timings[i].StageNS[FAUDIO_TIMING_STAGE_DECODE_EXT] +
+                timings[i].StageNS[FAUDIO_TIMING_STAGE_RESAMPLE_EXT],
+                "Record %u stages exceed the total\n", i);
+        ok(timings[i].SlowestVoice == src || timings[i].SlowestVoice == master,
+                "Record %u has an unknown slowest voice\n", i);
+    }
+    ok(FAudio_GetQuantumTimingsEXT(audio, timings, QUANTA + 1) == 0, "Ring was not drained\n");
+
+    FAudioVoice_GetTimingEXT(src, &voiceTiming);
+    ok(voiceTiming.Quanta == QUANTA, "Source was timed %llu times\n",
+            (unsigned long long) voiceTiming.Quanta);
+    ok(voiceTiming.PeakNS >= voiceTiming.LastNS && voiceTiming.TotalNS >= voiceTiming.PeakNS,
+            "Inconsistent voice timing\n");
+
+    /* Disabling timing stops recording */
+    debug.TraceMask = 0;
+    FAudio_SetDebugConfiguration(audio, &debug, NULL);
+    FAudio_RenderEXT(audio, output, 1);
+    ok(FAudio_GetQuantumTimingsEXT(audio, timings, QUANTA + 1) == 0, "Recorded while disabled\n");
+
+end:
+    FAudioVoice_DestroyVoice(src);
+    FAudioVoice_DestroyVoice(master);
+    FAudio_Release(audio);
+    free(samples);
+    free(output);
+}
+
+#define ADPCM_ALIGN 140
+#define ADPCM_BLOCKS 12
+#define ADPCM_SAMPLES_PER_BLOCK (((ADPCM_ALIGN / CHANNELS) - 6) * 2)
+
+/* Renders a looping stereo MSADPCM buffer, submitted twice, with the given
+ * ADPCMCacheEXT budget. Then refills the buffer in place and submits it again.
+ */
+static void render_adpcm(float *output, uint32_t budget, FAudioADPCMCacheStatsEXT *stats)
+{
+    FAudio *audio;
+    FAudioMasteringVoice *master;
+    FAudioSourceVoice *src;
+    FAudioADPCMWaveFormat fmt;
+    FAudioBuffer buffer;
+    uint8_t data[ADPCM_ALIGN * ADPCM_BLOCKS];
+    uint32_t quantum, i, j;
+
+    FAudioCreate(&audio, FAUDIO_OFFLINE_RENDER_EXT, FAUDIO_DEFAULT_PROCESSOR);
+    FAudio_SetADPCMCacheBudgetEXT(audio, budget);
+    FAudio_CreateMasteringVoice(audio, &master, CHANNELS, RATE, 0, 0, NULL);
+    FAudio_GetProcessingQuantum(audio, &quantum, NULL);
+
+    memset(&fmt, 0, sizeof(fmt));
+    fmt.wfx.wFormatTag = FAUDIO_FORMAT_MSADPCM;
+    fmt.wfx.nChannels = CHANNELS;
+    fmt.wfx.nSamplesPerSec = 44100;
+    fmt.wfx.wBitsPerSample = 4;
+    fmt.wfx.nBlockAlign = ADPCM_ALIGN;
+    fmt.wfx.nAvgBytesPerSec = fmt.wfx.nSamplesPerSec * ADPCM_ALIGN / ADPCM_SAMPLES_PER_BLOCK;
+    fmt.wfx.cbSize = sizeof(fmt) - sizeof(fmt.wfx);
+    fmt.wSamplesPerBlock = ADPCM_SAMPLES_PER_BLOCK;
+    FAudio_CreateSourceVoice(audio, &src, &fmt.wfx, 0, FAUDIO_DEFAULT_FREQ_RATIO, NULL, NULL, NULL);
+
+    /* Small deltas and a fixed predictor keep this from clipping the whole time */
+    for(i = 0; i < ADPCM_BLOCKS; ++i){
+        uint8_t *block = data + i * ADPCM_ALIGN;
+        block[0] = block[1] = i % 7;
+        for(j = 2; j < 14; ++j)
+            block[j] = (j == 2 || j == 4) ? 16 : 0;
+        for(j = 14; j < ADPCM_ALIGN; ++j)
+            block[j] = (uint8_t) (i * 31 + j * 7);
+    }
+
+    /* Loop part of the buffer, starting mid-block, then play it once more */
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.AudioBytes = sizeof(data);
+    buffer.pAudioData = data;
+    buffer.PlayBegin = ADPCM_SAMPLES_PER_BLOCK / 2;
+    buffer.LoopBegin = ADPCM_SAMPLES_PER_BLOCK * 3;
+    buffer.LoopLength = ADPCM_SAMPLES_PER_BLOCK * 5;
+    buffer.LoopCount = 4;
+    FAudioSourceVoice_SubmitSourceBuffer(src, &buffer, NULL);
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.AudioBytes = sizeof(data);
+    buffer.pAudioData = data;
+    FAudioSourceVoice_SubmitSourceBuffer(src, &buffer, NULL);
+    FAudioSourceVoice_Start(src, 0, FAUDIO_COMMIT_NOW);
+    FAudio_RenderEXT(audio, output, QUANTA * 2);
+
+    /* Same memory, new contents, must not play the old PCM */
+    for(i = 0; i < ADPCM_BLOCKS; ++i)
+        for(j = 14; j < ADPCM_ALIGN; ++j)
+            data[i * ADPCM_ALIGN + j] ^= 0x5A;
+    FAudioSourceVoice_SubmitSourceBuffer(src, &buffer, NULL);
+    FAudio_RenderEXT(audio, output + quantum * QUANTA * 2 * CHANNELS, QUANTA);
+
+    FAudio_GetADPCMCacheStatsEXT(audio, &stats[0]);
+    FAudio_SetADPCMCacheBudgetEXT(audio, 0);
+    FAudio_GetADPCMCacheStatsEXT(audio, &stats[1]);
+    FAudioVoice_DestroyVoice(src);
+
+    FAudioVoice_DestroyVoice(master);
+    FAudio_Release(audio);
+}
+
+static void test_adpcm_cache(void)
+{
+    FAudioADPCMCacheStatsEXT uncachedStats[2], cachedStats[2], tinyStats[2];
+    const uint32_t pcmBytes = ADPCM_BLOCKS * ADPCM_SAMPLES_PER_BLOCK * CHANNELS * sizeof(int16_t);
+    size_t len = sizeof(float) * (RATE / 100) * QUANTA * 3 * CHANNELS;
+    float *uncached, *cached, *tiny;
+    uint32_t i;
+
+    uncached = malloc(len);
+    cached = malloc(len);
+    tiny = malloc(len);
+    render_adpcm(uncached, 0, uncachedStats);
+    render_adpcm(cached, 1024 * 1024, cachedStats);
+    render_adpcm(tiny, pcmBytes - 1, tinyStats);
+
+    for(i = 0; i < len / sizeof(float); ++i)
+        if(uncached[i] != 0.0f)
+            break;
+    ok(i < len / sizeof(float), "MSADPCM rendered silence\n");
+    ok(memcmp(uncached, cached, len) == 0, "Cached MSADPCM doesn't match the decoder\n");
+    ok(memcmp(uncached, tiny, len) == 0, "Uncacheable MSADPCM doesn't match the decoder\n");
+
+    ok(uncachedStats[0].Entries == 0 && uncachedStats[0].Misses == 0,
+            "Disabled cache has %u entries, %llu misses\n", uncachedStats[0].Entries,
+            (unsigned long long) uncachedStats[0].Misses);
+    ok(tinyStats[0].Entries == 0 && tinyStats[0].Misses == 0,
+            "Buffer over the budget was cached\n");
+
+    /* The refilled buffer replaces the original once nothing plays it */
+    ok(cachedStats[0].BudgetBytes == 1024 * 1024, "Got budget %u\n", cachedStats[0].BudgetBytes);
+    ok(cachedStats[0].Misses == 2, "Got %llu misses\n", (unsigned long long) cachedStats[0].Misses);
+    ok(cachedStats[0].Hits == 1, "Got %llu hits\n", (unsigned long long) cachedStats[0].Hits);
+    ok(cachedStats[0].Evictions == 1, "Got %llu evictions\n",
+            (unsigned long long) cachedStats[0].Evictions);
+    ok(cachedStats[0].Entries == 1 && cachedStats[0].UsedBytes == pcmBytes,
+            "Got %u entries, %u bytes\n", cachedStats[0].Entries, cachedStats[0].UsedBytes);
+
+    /* Finished buffers are unpinned right away, so a zero budget empties it
+     * even though the voice is still around
+     */
+    ok(cachedStats[1].Entries == 0 && cachedStats[1].UsedBytes == 0,
+            "Got %u entries, %u bytes after clearing\n", cachedStats[1].Entries,
+            cachedStats[1].UsedBytes);
+    ok(cachedStats[1].Evictions == 2, "Got %llu evictions after clearing\n",
+            (unsigned long long) cachedStats[1].Evictions);
+
+    free(uncached);
+    free(cached);
+    free(tiny);
+}
+
+#ifndef DISABLE_XNASONG
+
+#define QOA_FRAME_SAMPLES 5120
+#define QOA_SAMPLES (QOA_FRAME_SAMPLES + 3000)
+#define QOA_SLICES(samples) (((samples) + 19) / 20)
+#define QOA_BYTES (8 + (8 + 16 * CHANNELS) * 2 + QOA_SLICES(QOA_SAMPLES) * 8 * CHANNELS)
+#define COMPRESSED_QUANTA 40
+
+static void write_be64(uint8_t **p, uint64_t v)
+{
+    int i;
+    for(i = 7; i >= 0; --i)
+        *(*p)++ = (uint8_t) (v >> (i * 8));
+}
+
+/* Two frames of stereo QOA, the second one short. The residuals are noise with
+ * a small scalefactor, which is all this needs.
+ */
+static void make_qoa(uint8_t *data)
+{
+    uint8_t *p = data;
+    uint32_t frame, samples, slice, c, seed = 1;
+
+    write_be64(&p, ((uint64_t) 0x716f6166 << 32) | QOA_SAMPLES);
+    for(frame = 0; frame < 2; ++frame){
+        samples = frame ? (QOA_SAMPLES - QOA_FRAME_SAMPLES) : QOA_FRAME_SAMPLES;
+        write_be64(&p, ((uint64_t) CHANNELS << 56) | ((uint64_t) RATE << 32) |
+                ((uint64_t) samples << 16) |
+                (8 + 16 * CHANNELS + QOA_SLICES(samples) * 8 * CHANNELS));
+        for(c = 0; c < CHANNELS; ++c){
+            write_be64(&p, 0); /* History */
+            write_be64(&p, (uint64_t) (uint16_t) -(1 << 13) << 16 | (1 << 14)); /* Weights */
+        }
+        for(slice = 0; slice < QOA_SLICES(samples) * CHANNELS; ++slice){
+            seed = seed * 1103515245 + 12345;
+            write_be64(&p, ((uint64_t) 3 << 60) | ((uint64_t) seed << 28) | (seed >> 4));
+        }
+    }
+}
+
+/* Renders COMPRESSED_QUANTA updates of one compressed buffer with the given
+ * CompressedVoiceEXT settings, returning what SubmitSourceBuffer returned.
+ */
+static uint32_t render_compressed(float *output, uint16_t tag, const uint8_t *data,
+        uint32_t bytes, uint32_t channels, const FAudioBuffer *params, uint32_t budget,
+        FAudioADPCMCacheStatsEXT *stats)
+{
+    FAudio *audio;
+    FAudioMasteringVoice *master;
+    FAudioSourceVoice *src;
+    FAudioWaveFormatEx fmt;
+    FAudioBuffer buffer;
+    uint32_t hr;
+
+    FAudioCreate(&audio, FAUDIO_OFFLINE_RENDER_EXT, FAUDIO_DEFAULT_PROCESSOR);
+    FAudio_SetADPCMCacheBudgetEXT(audio, budget);
+    FAudio_CreateMasteringVoice(audio, &master, CHANNELS, RATE, 0, 0, NULL);
+
+    fmt.wFormatTag = tag;
+    fmt.nChannels = channels;
+    fmt.nSamplesPerSec = RATE;
+    fmt.wBitsPerSample = 16;
+    fmt.nBlockAlign = fmt.nChannels * fmt.wBitsPerSample / 8;
+    fmt.nAvgBytesPerSec = fmt.nSamplesPerSec * fmt.nBlockAlign;
+    fmt.cbSize = 0;
+    FAudio_CreateSourceVoice(audio, &src, &fmt, 0, FAUDIO_DEFAULT_FREQ_RATIO, NULL, NULL, NULL);
+
+    buffer = *params;
+    buffer.AudioBytes = bytes;
+    buffer.pAudioData = data;
+    buffer.Flags = FAUDIO_END_OF_STREAM;
+    hr = FAudioSourceVoice_SubmitSourceBuffer(src, &buffer, NULL);
+    FAudioSourceVoice_Start(src, 0, FAUDIO_COMMIT_NOW);
+    FAudio_RenderEXT(audio, output, COMPRESSED_QUANTA);
+
+    /* Playing the same file again shares the cache entry */
+    if(stats != NULL){
+        FAudioSourceVoice_SubmitSourceBuffer(src, &buffer, NULL);
+        FAudio_GetADPCMCacheStatsEXT(audio, stats);
+    }
+
+    FAudioVoice_DestroyVoice(src);
+    FAudioVoice_DestroyVoice(master);
+    FAudio_Release(audio);
+    return hr;
+}
+
+static void test_compressed(void)
+{
+    const uint32_t frames = (RATE / 100) * COMPRESSED_QUANTA;
+    const uint32_t begin = QOA_FRAME_SAMPLES - 100, loopBegin = 1000, loopLength = 4500;
+    size_t len = sizeof(float) * frames * CHANNELS;
+    FAudioADPCMCacheStatsEXT stats;
+    FAudioBuffer params;
+    float *whole, *cached, *output;
+    uint8_t *data, junk[64];
+    uint32_t hr, i;
+
+    data = malloc(QOA_BYTES);
+    make_qoa(data);
+    whole = malloc(len);
+    cached = malloc(len);
+    output = malloc(len);
+
+    memset(&params, 0, sizeof(params));
+    hr = render_compressed(whole, FAUDIO_FORMAT_QOA_EXT, data, QOA_BYTES, CHANNELS, &params, 0, NULL);
+    ok(hr == 0, "Submitting QOA failed: %08x\n", hr);
+    for(i = 0; i < QOA_SAMPLES * CHANNELS; ++i)
+        if(whole[i] != 0.0f)
+            break;
+    ok(i < QOA_SAMPLES * CHANNELS, "QOA rendered silence\n");
+    for(i = QOA_SAMPLES * CHANNELS; i < frames * CHANNELS; ++i)
+        if(whole[i] != 0.0f)
+            break;
+    ok(i == frames * CHANNELS, "QOA played past the end of the file\n");
+
+    render_compressed(cached, FAUDIO_FORMAT_QOA_EXT, data, QOA_BYTES, CHANNELS, &params, 1024 * 1024, &stats);
+    ok(memcmp(whole, cached, len) == 0, "Cached QOA doesn't match the decoder\n");
+    ok(stats.Misses == 1 && stats.Hits == 1, "Got %llu misses, %llu hits\n",
+            (unsigned long long) stats.Misses, (unsigned long long) stats.Hits);
+    ok(stats.UsedBytes == QOA_SAMPLES * CHANNELS * sizeof(int16_t), "Got %u bytes\n",
+            stats.UsedBytes);
+
+    /* Starting just before the second frame is a seek */
+    params.PlayBegin = begin;
+    render_compressed(output, FAUDIO_FORMAT_QOA_EXT, data, QOA_BYTES, CHANNELS, &params, 0, NULL);
+    ok(memcmp(output, whole + begin * CHANNELS,
+            sizeof(float) * (QOA_SAMPLES - begin) * CHANNELS) == 0,
+            "QOA started at the wrong sample\n");
+
+    /* Loop across the frame boundary twice, then play out */
+    params.PlayBegin = 0;
+    params.LoopBegin = loopBegin;
+    params.LoopLength = loopLength;
+    params.LoopCount = 2;
+    for(i = 0; i < 2; ++i){
+        render_compressed(output, FAUDIO_FORMAT_QOA_EXT, data, QOA_BYTES, CHANNELS, &params, i ? 1024 * 1024 : 0, NULL);
+        ok(memcmp(output, whole, sizeof(float) * (loopBegin + loopLength) * CHANNELS) == 0 &&
+                memcmp(output + (loopBegin + loopLength) * CHANNELS, whole + loopBegin * CHANNELS,
+                        sizeof(float) * loopLength * CHANNELS) == 0 &&
+                memcmp(output + (loopBegin + loopLength * 3) * CHANNELS, whole + (loopBegin + loopLength) * CHANNELS,
+                        sizeof(float) * (frames - loopBegin - loopLength * 3) * CHANNELS) == 0,
+                "QOA loop doesn't match the file, cache %u\n", i);
+    }
+
+    /* Bad files and files that don't match the voice */
+    memset(&params, 0, sizeof(params));
+    memset(junk, 0x5A, sizeof(junk));
+    hr = render_compressed(output, FAUDIO_FORMAT_QOA_EXT, junk, sizeof(junk), CHANNELS, &params, 0, NULL);
+    ok(hr == FAUDIO_E_INVALID_CALL, "Junk QOA: %08x\n", hr);
+    hr = render_compressed(output, FAUDIO_FORMAT_QOA_EXT, data, QOA_BYTES, 1, &params, 0, NULL);
+    ok(hr == FAUDIO_E_INVALID_CALL, "Stereo QOA on a mono voice: %08x\n", hr);
+    params.PlayBegin = QOA_SAMPLES;
+    params.PlayLength = 1;
+    hr = render_compressed(output, FAUDIO_FORMAT_QOA_EXT, data, QOA_BYTES, CHANNELS, &params, 0, NULL);
+    ok(hr == FAUDIO_E_INVALID_CALL, "Playing past the end of the QOA: %08x\n", hr);
+
+    free(data);
+    free(whole);
+    free(cached);
+    free(output);
+}
+
+#define VORBIS_PACKETS 97 /* Each one is 128 samples, except the first */
+#define VORBIS_PACKET_BYTES 40
+#define VORBIS_PAGE_PACKETS 4
+#define VORBIS_SAMPLES ((VORBIS_PACKETS - 1) * 128)
+#define VORBIS_BYTES (4096 + VORBIS_PACKETS * VORBIS_PACKET_BYTES)
+
+typedef struct bit_writer
+{
+    uint8_t *p;
+    uint32_t bit;
+} bit_writer;
+
+/* Vorbis packs setup and audio packets least significant bit first */
+static void write_bits(bit_writer *w, uint32_t value, uint32_t bits)
+{
+    uint32_t i;
+    for(i = 0; i < bits; ++i){
+        if(w->bit == 0)
+            *w->p = 0;
+        *w->p |= ((value >> i) & 1) << w->bit;
+        if(++w->bit == 8){
+            w->bit = 0;
+            ++w->p;
+        }
+    }
+}
+
+static void write_vorbis_header(bit_writer *w, uint8_t type)
+{
+    write_bits(w, type, 8);
+    write_bits(w, 'v', 8); write_bits(w, 'o', 8); write_bits(w, 'r', 8);
+    write_bits(w, 'b', 8); write_bits(w, 'i', 8); write_bits(w, 's', 8);
+}
+
+static uint32_t ogg_crc(const uint8_t *data, uint32_t len)
+{
+    uint32_t crc = 0, i, b;
+    for(i = 0; i < len; ++i){
+        crc ^= (uint32_t) data[i] << 24;
+        for(b = 0; b < 8; ++b)
+            crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04c11db7 : (crc << 1);
+    }
+    return crc;
+}
+
+/* Writes one Ogg page holding the given packets, none of them over 254 bytes */
+static uint8_t *write_ogg_page(uint8_t *p, uint8_t flags, uint64_t granule, uint32_t sequence,
+        const uint8_t *packets, const uint32_t *lengths, uint32_t count)
+{
+    uint8_t *page = p;
+    uint32_t i, total = 0, crc;
+
+    memcpy(p, "OggS", 4);
+    p[4] = 0;
+    p[5] = flags;
+    for(i = 0; i < 8; ++i)
+        p[6 + i] = (uint8_t) (granule >> (i * 8));
+    memset(p + 14, 0, 12); /* Serial 0, sequence and CRC below */
+    for(i = 0; i < 4; ++i)
+        p[18 + i] = (uint8_t) (sequence >> (i * 8));
+    p[26] = (uint8_t) count;
+    p += 27;
+    for(i = 0; i < count; ++i){
+        *p++ = (uint8_t) lengths[i];
+        total += lengths[i];
+    }
+    memcpy(p, packets, total);
+    p += total;
+
+    crc = ogg_crc(page, (uint32_t) (p - page));
+    for(i = 0; i < 4; ++i)
+        page[22 + i] = (uint8_t) (crc >> (i * 8));
+    return p;
+}
+
+/* The smallest Vorbis stereo stream that isn't silent: short blocks only, a
+ * flat floor, and a residue of one random bit per bin that picks +1 or -1.
+ * Returns its size.
+ */
+static uint32_t make_vorbis(uint8_t *data)
+{
+    uint8_t packets[VORBIS_PAGE_PACKETS * VORBIS_PACKET_BYTES], setup[256];
+    uint32_t lengths[VORBIS_PAGE_PACKETS], packet, count, c, seed = 1;
+    uint8_t *p = data;
+    bit_writer w;
+
+    /* Identification: 256 sample blocks, both of them */
+    w.p = packets; w.bit = 0;
+    write_vorbis_header(&w, 1);
+    write_bits(&w, 0, 32);
+    write_bits(&w, CHANNELS, 8);
+    write_bits(&w, RATE, 32);
+    write_bits(&w, 0, 32); write_bits(&w, 0, 32); write_bits(&w, 0, 32);
+    write_bits(&w, 8 | (8 << 4), 8);
+    write_bits(&w, 1, 8);
+    lengths[0] = (uint32_t) (w.p - packets);
+    p = write_ogg_page(p, 0x02, 0, 0, packets, lengths, 1);
+
+    /* Comment, no vendor and no comments */
+    w.p = packets; w.bit = 0;
+    write_vorbis_header(&w, 3);
+    write_bits(&w, 0, 32);
+    write_bits(&w, 0, 32);
+    write_bits(&w, 1, 8);
+    lengths[0] = (uint32_t) (w.p - packets);
+
+    /* Setup */
+    w.p = setup; w.bit = 0;
+    write_vorbis_header(&w, 5);
+    write_bits(&w, 2 - 1, 8);
+    for(c = 0; c < 2; ++c){
+        /* Two entries of one bit, the second book maps them to -1 and +1 */
+        write_bits(&w, 0x564342, 24);
+        write_bits(&w, 1, 16);
+        write_bits(&w, 2, 24);
+        write_bits(&w, 0, 1);
+        write_bits(&w, 0, 1);
+        write_bits(&w, 1 - 1, 5);
+        write_bits(&w, 1 - 1, 5);
+        write_bits(&w, c, 4);
+        if(c){
+            write_bits(&w, 0x80000000 | (788 << 21) | 1, 32);
+            write_bits(&w, (788 << 21) | 2, 32);
+            write_bits(&w, 1 - 1, 4);
+            write_bits(&w, 0, 1);
+            write_bits(&w, 0, 1);
+            write_bits(&w, 1, 1);
+        }
+    }
+    write_bits(&w, 1 - 1, 6); write_bits(&w, 0, 16); /* Time */
+    write_bits(&w, 1 - 1, 6); write_bits(&w, 1, 16); /* Floor 1, no partitions */
+    write_bits(&w, 0, 5);
+    write_bits(&w, 4 - 1, 2);
+    write_bits(&w, 7, 4);
+    write_bits(&w, 1 - 1, 6); write_bits(&w, 1, 16); /* Residue 1 */
+    write_bits(&w, 0, 24);
+    write_bits(&w, 128, 24);
+    write_bits(&w, 8 - 1, 24);
+    write_bits(&w, 1 - 1, 6);
+    write_bits(&w, 0, 8);
+    write_bits(&w, 1, 3); write_bits(&w, 0, 1);
+    write_bits(&w, 1, 8);
+    write_bits(&w, 1 - 1, 6); write_bits(&w, 0, 16); /* Mapping */
+    write_bits(&w, 0, 1); write_bits(&w, 0, 1); write_bits(&w, 0, 2);
+    write_bits(&w, 0, 8); write_bits(&w, 0, 8); write_bits(&w, 0, 8);
+    write_bits(&w, 1 - 1, 6); /* Mode */
+    write_bits(&w, 0, 1); write_bits(&w, 0, 16); write_bits(&w, 0, 16); write_bits(&w, 0, 8);
+    write_bits(&w, 1, 1);
+    if(w.bit != 0)
+        ++w.p;
+    lengths[1] = (uint32_t) (w.p - setup);
+    memcpy(packets + lengths[0], setup, lengths[1]);
+    p = write_ogg_page(p, 0, 0, 1, packets, lengths, 2);
+
+    /* Audio, a few packets to a page so seeks land in the middle of one */
+    for(packet = 0; packet < VORBIS_PACKETS; packet += count){
+        count = VORBIS_PACKETS - packet;
+        if(count > VORBIS_PAGE_PACKETS)
+            count = VORBIS_PAGE_PACKETS;
+        for(c = 0; c < count; ++c){
+            w.p = packets + c * VORBIS_PACKET_BYTES; w.bit = 0;
+            write_bits(&w, 0, 1);
+            write_bits(&w, 1, 1); write_bits(&w, 55, 6); write_bits(&w, 55, 6);
+            write_bits(&w, 1, 1); write_bits(&w, 55, 6); write_bits(&w, 55, 6);
+            while(w.p < packets + (c + 1) * VORBIS_PACKET_BYTES){
+                seed = seed * 1103515245 + 12345;
+                write_bits(&w, seed >> 16, 8);
+            }
+            lengths[c] = VORBIS_PACKET_BYTES;
+        }
+        p = write_ogg_page(p, (packet + count == VORBIS_PACKETS) ? 0x04 : 0,
+                (uint64_t) (packet + count - 1) * 128, 2 + packet / VORBIS_PAGE_PACKETS,
+                packets, lengths, count);
+    }
+    return (uint32_t) (p - data);
+}
+
+static void test_vorbis(void)
+{
+    const uint32_t frames = (RATE / 100) * COMPRESSED_QUANTA;
+    const uint32_t begin = 5000, loopBegin = 1000, loopLength = 4500;
+    size_t len = sizeof(float) * frames * CHANNELS;
+    FAudioADPCMCacheStatsEXT stats;
+    FAudioBuffer params;
+    float *whole, *cached, *output;
+    uint8_t *data;
+    uint32_t bytes, hr, i;
+
+    data = malloc(VORBIS_BYTES);
+    bytes = make_vorbis(data);
+    whole = malloc(len);
+    cached = malloc(len);
+    output = malloc(len);
+
+    /* Streamed, every update decodes right where the last one stopped */
+    memset(&params, 0, sizeof(params));
+    hr = render_compressed(whole, FAUDIO_FORMAT_VORBIS_EXT, data, bytes, CHANNELS, &params, 0, NULL);
+    ok(hr == 0, "Submitting Vorbis failed: %08x\n", hr);
+    for(i = 0; i < VORBIS_SAMPLES * CHANNELS; ++i)
+        if(whole[i] != 0.0f)
+            break;
+    ok(i < VORBIS_SAMPLES * CHANNELS, "Vorbis rendered silence\n");
+    for(i = VORBIS_SAMPLES * CHANNELS; i < frames * CHANNELS; ++i)
+        if(whole[i] != 0.0f)
+            break;
+    ok(i == frames * CHANNELS, "Vorbis played past the end of the file\n");
+
+    /* Decoded in one go at submission */
+    render_compressed(cached, FAUDIO_FORMAT_VORBIS_EXT, data, bytes, CHANNELS, &params, 4 * 1024 * 1024, &stats);
+    ok(memcmp(whole, cached, len) == 0, "Streamed Vorbis doesn't match the whole file\n");
+    ok(stats.Misses == 1 && stats.Hits == 1, "Got %llu misses, %llu hits\n",
+            (unsigned long long) stats.Misses, (unsigned long long) stats.Hits);
+
+    /* Starting in the middle of a page is a seek */
+    params.PlayBegin = begin;
+    render_compressed(output, FAUDIO_FORMAT_VORBIS_EXT, data, bytes, CHANNELS, &params, 0, NULL);
+    ok(memcmp(output, whole + begin * CHANNELS,
+            sizeof(float) * (VORBIS_SAMPLES - begin) * CHANNELS) == 0,
+            "Vorbis started at the wrong sample\n");
+
+    /* Every loop seeks back, then reads on from there */
+    params.PlayBegin = 0;
+    params.LoopBegin = loopBegin;
+    params.LoopLength = loopLength;
+    params.LoopCount = 2;
+    for(i = 0; i < 2; ++i){
+        render_compressed(output, FAUDIO_FORMAT_VORBIS_EXT, data, bytes, CHANNELS, &params, i ? 4 * 1024 * 1024 : 0, NULL);
+        ok(memcmp(output, whole, sizeof(float) * (loopBegin + loopLength) * CHANNELS) == 0 &&
+                memcmp(output + (loopBegin + loopLength) * CHANNELS, whole + loopBegin * CHANNELS,
+                        sizeof(float) * loopLength * CHANNELS) == 0 &&
+                memcmp(output + (loopBegin + loopLength * 3) * CHANNELS, whole + (loopBegin + loopLength) * CHANNELS,
+                        sizeof(float) * (frames - loopBegin - loopLength * 3) * CHANNELS) == 0,
+                "Vorbis loop doesn't match the file, cache %u\n", i);
+    }
+
+    free(data);
+    free(whole);
+    free(cached);
+    free(output);
+}
+
+#endif /* DISABLE_XNASONG */
+
+#define SINC_DELAY 7 /* FAUDIO_SINC_DELAY */
+#define SINC_FRAMES 2400
+
+/* Renders QUANTA updates of one stereo buffer of SINC_FRAMES frames at the
+ * given rate, the same signal on both channels.
+ */
+static void render_resampled(float *output, uint32_t flags, uint32_t rate, const float *signal)
+{
+    FAudio *audio;
+    FAudioMasteringVoice *master;
+    FAudioSourceVoice *src;
+    FAudioWaveFormatEx fmt;
+    FAudioBuffer buffer;
+    float *samples;
+    uint32_t quantum, i;
+
+    FAudioCreate(&audio, FAUDIO_OFFLINE_RENDER_EXT, FAUDIO_DEFAULT_PROCESSOR);
+    FAudio_CreateMasteringVoice(audio, &master, CHANNELS, RATE, 0, 0, NULL);
+    FAudio_GetProcessingQuantum(audio, &quantum, NULL);
+
+    fmt.wFormatTag = FAUDIO_FORMAT_IEEE_FLOAT;
+    fmt.nChannels = CHANNELS;
+    fmt.nSamplesPerSec = rate;
+    fmt.wBitsPerSample = 32;
+    fmt.nBlockAlign = fmt.nChannels * fmt.wBitsPerSample / 8;
+    fmt.nAvgBytesPerSec = fmt.nSamplesPerSec * fmt.nBlockAlign;
+    fmt.cbSize = 0;
+    FAudio_CreateSourceVoice(audio, &src, &fmt, flags, FAUDIO_DEFAULT_FREQ_RATIO, NULL, NULL, NULL);
+
+    samples = malloc(sizeof(float) * SINC_FRAMES * CHANNELS);
+    for(i = 0; i < SINC_FRAMES * CHANNELS; ++i)
+        samples[i] = signal[i / CHANNELS];
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.AudioBytes = sizeof(float) * SINC_FRAMES * CHANNELS;
+    buffer.pAudioData = (uint8_t*) samples;
+    buffer.Flags = FAUDIO_END_OF_STREAM;
+    FAudioSourceVoice_SubmitSourceBuffer(src, &buffer, NULL);
+    FAudioSourceVoice_Start(src, 0, FAUDIO_COMMIT_NOW);
+    FAudio_RenderEXT(audio, output, QUANTA);
+
+    FAudioVoice_DestroyVoice(src);
+    FAudioVoice_DestroyVoice(master);
+    FAudio_Release(audio);
+    free(samples);
+}
+
+/* A quarter of the input rate, sampled every eighth of a cycle */
+static const double eighths[8] = {
+    0.0, 0.35355339059327376, 0.5, 0.35355339059327376,
+    0.0, -0.35355339059327376, -0.5, -0.35355339059327376
+};
+
+/* Mean squared error against the sine, upsampled twice, delayed by a number of
+ * input frames.
+ */
+static double resample_error(const float *output, uint32_t delay)
+{
+    double sum = 0.0, error;
+    uint32_t i;
+
+    /* Away from both ends of the buffer */
+    for(i = 200; i < 2200; ++i){
+        error = output[i * CHANNELS] - eighths[(i - delay * 2) % 8];
+        sum += error * error;
+    }
+    return sum / 2000.0;
+}
+
+static void test_sinc(void)
+{
+    const uint32_t frames = (RATE / 100) * QUANTA;
+    float signal[SINC_FRAMES], *linear, *sinc;
+    double linearError, sincError;
+    uint32_t i;
+
+    linear = calloc(frames * CHANNELS, sizeof(float));
+    sinc = calloc(frames * CHANNELS, sizeof(float));
+
+    /* At the output rate, the input comes out whole, just later */
+    for(i = 0; i < SINC_FRAMES; ++i)
+        signal[i] = 0.25f + (float) i / (SINC_FRAMES * 2);
+    render_resampled(sinc, FAUDIO_VOICE_SINC_EXT, RATE, signal);
+    for(i = 0; i < SINC_FRAMES + SINC_DELAY; ++i)
+        if(sinc[i * CHANNELS + 1] != (i < SINC_DELAY ? 0.0f : signal[i - SINC_DELAY]))
+            break;
+    ok(i == SINC_FRAMES + SINC_DELAY, "Sinc output at 1.0 differs at frame %u\n", i);
+    for(; i < frames; ++i)
+        if(sinc[i * CHANNELS] != 0.0f)
+            break;
+    ok(i == frames, "Sinc output at 1.0 didn't end at frame %u\n", i);
+
+    /* Upsampling a 6KHz sine, the sinc filter should be much closer to it */
+    for(i = 0; i < SINC_FRAMES; ++i)
+        signal[i] = (float) eighths[(i * 2) % 8];
+    render_resampled(linear, 0, 24000, signal);
+    render_resampled(sinc, FAUDIO_VOICE_SINC_EXT, 24000, signal);
+    linearError = resample_error(linear, 0);
+    sincError = resample_error(sinc, SINC_DELAY);
+    ok(sincError < 1e-6 && sincError < linearError / 100.0,
+            "Sinc error %g isn't much better than linear %g\n", sincError, linearError);
+
+    free(linear);
+    free(sinc);
+}
+
+static void test_silent_sends(void)
+{
+    FAudio *audio;
+    FAudioMasteringVoice *master;
+    FAudioSubmixVoice *submix;
+    FAudioSourceVoice *src;
+    FAudioWaveFormatEx fmt;
+    FAudioSendDescriptor send;
+    FAudioVoiceSends sends;
+    FAudioBuffer buffer;
+    float samples[1024 * 4], output[1024 * 8];
+    float matrix[8];
+    uint32_t quantum, rate, i, hr;
+
+    hr = FAudioCreate(&audio, FAUDIO_OFFLINE_RENDER_EXT, FAUDIO_DEFAULT_PROCESSOR);
+    ok(hr == 0, "FAudioCreate failed: %08x\n", hr);
+    hr = FAudio_CreateMasteringVoice(audio, &master, 8, RATE, 0, 0, NULL);
+    ok(hr == 0, "CreateMasteringVoice failed: %08x\n", hr);
+    hr = FAudio_CreateSubmixVoice(audio, &submix, 8, RATE, 0, 0, NULL, NULL);
+    ok(hr == 0, "CreateSubmixVoice failed: %08x\n", hr);
+    FAudio_GetProcessingQuantum(audio, &quantum, &rate);
+
+    fmt.wFormatTag = FAUDIO_FORMAT_IEEE_FLOAT;
+    fmt.nChannels = 1;
+    fmt.nSamplesPerSec = RATE;
+    fmt.wBitsPerSample = 32;
+    fmt.nBlockAlign = fmt.nChannels * fmt.wBitsPerSample / 8;
+    fmt.nAvgBytesPerSec = fmt.nSamplesPerSec * fmt.nBlockAlign;
+    fmt.cbSize = 0;
+    send.Flags = 0;
+    send.pOutputVoice = submix;
+    sends.SendCount = 1;
+    sends.pSends = &send;
+    hr = FAudio_CreateSourceVoice(audio, &src, &fmt, FAUDIO_VOICE_NOPITCH | FAUDIO_VOICE_NOSRC,
+            1.0f, NULL, &sends, NULL);
+    ok(hr == 0, "CreateSourceVoice failed: %08x\n", hr);
+
+    /* Mono panned hard into the third channel only */
+    memset(matrix, 0, sizeof(matrix));
+    matrix[2] = 0.5f;
+    FAudioVoice_SetOutputMatrix(src, submix, 1, 8, matrix, FAUDIO_COMMIT_NOW);
+
+    for(i = 0; i < quantum * 4; ++i)
+        samples[i] = (float) (i + 1) / (float) (quantum * 4);
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.AudioBytes = sizeof(float) * quantum * 4;
+    buffer.pAudioData = (uint8_t*) samples;
+    buffer.LoopCount = FAUDIO_LOOP_INFINITE;
+    FAudioSourceVoice_SubmitSourceBuffer(src, &buffer, NULL);
+    FAudioSourceVoice_Start(src, 0, FAUDIO_COMMIT_NOW);
+
+    FAudio_RenderEXT(audio, output, 1);
+    for(i = 0; i < quantum * 8; ++i)
+        if(output[i] != ((i % 8 == 2) ? samples[i / 8] * 0.5f : 0.0f))
+            break;
+    ok(i == quantum * 8, "Sparse send mismatch at %u\n", i);
+
+    /* A muted source sends nothing, so the submix has nothing to send either */
+    FAudioVoice_SetVolume(src, 0.0f, FAUDIO_COMMIT_NOW);
+    FAudio_RenderEXT(audio, output, 1);
+    for(i = 0; i < quantum * 8; ++i)
+        if(output[i] != 0.0f)
+            break;
+    ok(i == quantum * 8, "Muted source rendered audio at %u\n", i);
+
+    /* ... and picks back up right where the source is */
+    FAudioVoice_SetVolume(src, 1.0f, FAUDIO_COMMIT_NOW);
+    FAudio_RenderEXT(audio, output, 1);
+    ok(output[2] == samples[quantum * 2] * 0.5f && output[0] == 0.0f,
+            "Unmuted source rendered %f %f\n", output[2], output[0]);
+
+    FAudioVoice_DestroyVoice(src);
+    FAudioVoice_DestroyVoice(submix);
+    FAudioVoice_DestroyVoice(master);
+    FAudio_Release(audio);
+}
+
+static void test_operation_sets(void)
+{
+    FAudio *audio;
+    FAudioMasteringVoice *master;
+    FAudioSourceVoice *src, *other;
+    FAudioWaveFormatEx fmt;
+    float output[1024 * CHANNELS];
+    float matrix[CHANNELS], volume;
+    uint32_t i, hr;
+
+    hr = FAudioCreate(&audio, FAUDIO_OFFLINE_RENDER_EXT, FAUDIO_DEFAULT_PROCESSOR);
+    ok(hr == 0, "FAudioCreate failed: %08x\n", hr);
+    hr = FAudio_CreateMasteringVoice(audio, &master, CHANNELS, RATE, 0, 0, NULL);
+    ok(hr == 0, "CreateMasteringVoice failed: %08x\n", hr);
+
+    fmt.wFormatTag = FAUDIO_FORMAT_IEEE_FLOAT;
+    fmt.nChannels = 1;
+    fmt.nSamplesPerSec = RATE;
+    fmt.wBitsPerSample = 32;
+    fmt.nBlockAlign = fmt.nChannels * fmt.wBitsPerSample / 8;
+    fmt.nAvgBytesPerSec = fmt.nSamplesPerSec * fmt.nBlockAlign;
+    fmt.cbSize = 0;
+    hr = FAudio_CreateSourceVoice(audio, &src, &fmt, 0, 2.0f, NULL, NULL, NULL);
+    ok(hr == 0, "CreateSourceVoice failed: %08x\n", hr);
+    hr = FAudio_CreateSourceVoice(audio, &other, &fmt, 0, 2.0f, NULL, NULL, NULL);
+    ok(hr == 0, "CreateSourceVoice failed: %08x\n", hr);
+
+    /* Later calls in the same set replace earlier ones, other sets wait */
+    for(i = 0; i < 100; ++i)
+    {
+        FAudioVoice_SetVolume(src, (float) i / 100.0f, 1);
+        matrix[0] = (float) i;
+        matrix[1] = -(float) i;
+        FAudioVoice_SetOutputMatrix(src, master, 1, CHANNELS, matrix, 1);
+    }
+    FAudioVoice_SetVolume(src, 0.9f, 2);
+    FAudio_CommitOperationSet(audio, 1);
+    FAudio_RenderEXT(audio, output, 1);
+
+    FAudioVoice_GetVolume(src, &volume);
+    ok(volume == 0.99f, "Got volume %f after committing set 1\n", volume);
+    FAudioVoice_GetOutputMatrix(src, master, 1, CHANNELS, matrix);
+    ok(matrix[0] == 99.0f && matrix[1] == -99.0f,
+            "Got matrix %f %f after committing set 1\n", matrix[0], matrix[1]);
+
+    /* Destroying a voice drops its operations, but not anyone else's */
+    FAudioVoice_SetVolume(other, 0.1f, 3);
+    FAudioVoice_SetVolume(src, 0.2f, 3);
+    FAudioSourceVoice_SetFrequencyRatio(other, 1.5f, 3);
+    FAudioVoice_DestroyVoice(other);
+    FAudioVoice_SetVolume(src, 0.3f, 3);
+    FAudio_CommitOperationSet(audio, FAUDIO_COMMIT_ALL);
+    FAudio_RenderEXT(audio, output, 1);
+
+    FAudioVoice_GetVolume(src, &volume);
+    ok(volume == 0.3f, "Got volume %f after committing everything\n", volume);
+
+    /* Nothing left over for the next commit */
+    FAudioVoice_SetVolume(src, 0.4f, 1);
+    FAudioVoice_SetVolume(src, 0.5f, 4);
+    FAudio_CommitOperationSet(audio, 1);
+    FAudio_RenderEXT(audio, output, 1);
+    FAudioVoice_GetVolume(src, &volume);
+    ok(volume == 0.4f, "Got volume %f after committing set 1 again\n", volume);
+
+    /* Replacing a queued value keeps the call order across sets, so the
+     * last call wins when everything is committed
+     */
+    FAudioVoice_SetVolume(src, 0.6f, 5);
+    FAudioVoice_SetVolume(src, 0.7f, 6);
+    FAudioVoice_SetVolume(src, 0.8f, 5);
+    FAudio_CommitOperationSet(audio, FAUDIO_COMMIT_ALL);
+    FAudio_RenderEXT(audio, output, 1);
+    FAudioVoice_GetVolume(src, &volume);
+    ok(volume == 0.8f, "Got volume %f after interleaving sets\n", volume);
+
+    matrix[0] = 1.0f;
+    matrix[1] = 2.0f;
+    FAudioVoice_SetOutputMatrix(src, master, 1, CHANNELS, matrix, 7);
+    matrix[0] = 3.0f;
+    matrix[1] = 4.0f;
+    FAudioVoice_SetOutputMatrix(src, master, 1, CHANNELS, matrix, 8);
+    matrix[0] = 5.0f;
+    matrix[1] = 6.0f;
+    FAudioVoice_SetOutputMatrix(src, master, 1, CHANNELS, matrix, 7);
+    FAudio_CommitOperationSet(audio, FAUDIO_COMMIT_ALL);
+    FAudio_RenderEXT(audio, output, 1);
+    FAudioVoice_GetOutputMatrix(src, master, 1, CHANNELS, matrix);
+    ok(matrix[0] == 5.0f && matrix[1] == 6.0f,
+            "Got matrix %f %f after interleaving sets\n", matrix[0], matrix[1]);
+
+    /* Committing one set at a time runs them in commit order instead */
+    FAudioVoice_SetVolume(src, 0.1f, 9);
+    FAudioVoice_SetVolume(src, 0.2f, 10);
+    FAudioVoice_SetVolume(src, 0.3f, 9);
+    FAudio_CommitOperationSet(audio, 9);
+    FAudio_CommitOperationSet(audio, 10);
+    FAudio_RenderEXT(audio, output, 1);
+    FAudioVoice_GetVolume(src, &volume);
+    ok(volume == 0.2f, "Got volume %f after committing sets in turn\n", volume);
+
+    FAudioVoice_DestroyVoice(src);
+    FAudioVoice_DestroyVoice(master);
+    FAudio_Release(audio);
+}
+
+/* Counts every allocator call made while alloc_counting is set */
+static uint32_t alloc_counting, alloc_calls;
+
+static void* FAUDIOCALL count_malloc(size_t size)
+{
+    alloc_calls += alloc_counting;
+    return malloc(size);
+}
+
+static void FAUDIOCALL count_free(void *ptr)
+{
+    free(ptr);
+}
+
+static void* FAUDIOCALL count_realloc(void *ptr, size_t size)
+{
+    alloc_calls += alloc_counting;
+    return realloc(ptr, size);
+}
+
+static void test_voice_churn(uint32_t flags)
+{
+    FAudio *audio;
+    FAudioMasteringVoice *master;
+    FAudioSubmixVoice *submix;
+    FAudioSourceVoice *src[4];
+    FAudioWaveFormatEx fmt;
+    FAudioSendDescriptor send;
+    FAudioVoiceSends sends;
+    FAudioBuffer buffer;
+    float samples[1024 * 2], *output;
+    uint32_t quantum, rate, i, j, hr, failed = 0, renderCalls = 0;
+
+    hr = FAudioCreateWithCustomAllocatorEXT(&audio, FAUDIO_OFFLINE_RENDER_EXT | flags,
+            FAUDIO_DEFAULT_PROCESSOR, count_malloc, count_free, count_realloc);
+    ok(hr == 0, "FAudioCreate failed: %08x\n", hr);
+    hr = FAudio_CreateMasteringVoice(audio, &master, 2, RATE, 0, 0, NULL);
+    ok(hr == 0, "CreateMasteringVoice failed: %08x\n", hr);
+    hr = FAudio_CreateSubmixVoice(audio, &submix, 2, 32000, 0, 0, NULL, NULL);
+    ok(hr == 0, "CreateSubmixVoice failed: %08x\n", hr);
+    FAudio_GetProcessingQuantum(audio, &quantum, &rate);
+    output = malloc(sizeof(float) * quantum * 2);
+
+    for(i = 0; i < quantum * 2; ++i)
+        samples[i] = (float) i / (float) (quantum * 2);
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.AudioBytes = sizeof(float) * quantum * 2;
+    buffer.pAudioData = (uint8_t*) samples;
+    buffer.LoopCount = FAUDIO_LOOP_INFINITE;
+
+    send.Flags = FAUDIO_SEND_USEFILTER;
+    send.pOutputVoice = submix;
+    sends.SendCount = 1;
+    sends.pSends = &send;
+
+    /* Thousands of short-lived voices, each one a different shape than the
+     * last, and the mixer should never need to allocate for any of them
+     */
+    for(i = 0; i < 512; ++i)
+    {
+        for(j = 0; j < 4; ++j)
+        {
+            fmt.wFormatTag = FAUDIO_FORMAT_IEEE_FLOAT;
+            fmt.nChannels = 1 + (i + j) % 2;
+            fmt.nSamplesPerSec = 22050 + 1000 * ((i * 4 + j) % 27);
+            fmt.wBitsPerSample = 32;
+            fmt.nBlockAlign = fmt.nChannels * fmt.wBitsPerSample / 8;
+            fmt.nAvgBytesPerSec = fmt.nSamplesPerSec * fmt.nBlockAlign;
+            fmt.cbSize = 0;
+            hr = FAudio_CreateSourceVoice(audio, &src[j], &fmt,
+                    FAUDIO_VOICE_USEFILTER | ((j & 1) ? FAUDIO_VOICE_SINC_EXT : 0),
+                    2.0f, NULL, (j & 2) ? &sends : NULL, NULL);
+            failed += (hr != 0);
+            buffer.AudioBytes = sizeof(float) * quantum * fmt.nChannels;
+            FAudioSourceVoice_SubmitSourceBuffer(src[j], &buffer, NULL);
+            FAudioSourceVoice_Start(src[j], 0, FAUDIO_COMMIT_NOW);
+        }
+
+        alloc_counting = 1;
+        FAudio_RenderEXT(audio, output, 1);
+        alloc_counting = 0;
+        renderCalls += alloc_calls;
+        alloc_calls = 0;
+
+        for(j = 0; j < 4; ++j)
+            FAudioVoice_DestroyVoice(src[j]);
+    }
+    ok(failed == 0, "CreateSourceVoice failed %u times\n", failed);
+    ok(renderCalls == 0, "Mixer allocated %u times\n", renderCalls);
+
+    FAudioVoice_DestroyVoice(submix);
+    FAudioVoice_DestroyVoice(master);
+    FAudio_Release(audio);
+    free(output);
+}
+
+/* Device IDs mean nothing to an offline engine, which never opens a device */
+static void test_device_id(void)
+{
+    FAudio *audio;
+    FAudioMasteringVoice *master;
+    uint16_t deviceId[] = { '1', 0 };
+    float output[1024 * CHANNELS];
+    uint32_t hr;
+
+    hr = FAudioCreate(&audio, FAUDIO_OFFLINE_RENDER_EXT, FAUDIO_DEFAULT_PROCESSOR);
+    ok(hr == 0, "FAudioCreate failed: %08x\n", hr);
+    hr = FAudio_CreateMasteringVoice8(audio, &master, CHANNELS, RATE, 0, deviceId,
+            NULL, FAudioStreamCategory_GameEffects);
+    ok(hr == 0, "CreateMasteringVoice8 failed: %08x\n", hr);
+    hr = FAudio_RenderEXT(audio, output, 1);
+    ok(hr == 0, "RenderEXT failed: %08x\n", hr);
+
+    FAudioVoice_DestroyVoice(master);
+    FAudio_Release(audio);
+}
+
+static void test_no_flag(void)
+{
+    FAudio *audio;
+    float output;
+    uint32_t hr;
+
+    hr = FAudioCreate(&audio, 0, FAUDIO_DEFAULT_PROCESSOR);
+    ok(hr == 0, "FAudioCreate failed: %08x\n", hr);
+    hr = FAudio_RenderEXT(audio, &output, 1);
+    ok(hr == FAUDIO_E_INVALID_CALL, "RenderEXT without the flag: %08x\n", hr);
+    FAudio_Release(audio);
+}
+
+int main(int argc, char **argv)
+{
+    test_render(0);
+    test_render(FAUDIO_1024_QUANTUM);
+    test_timing();
+    test_adpcm_cache();
+#ifndef DISABLE_XNASONG
+    test_compressed();
+    test_vorbis();
+#endif /* DISABLE_XNASONG */
+    test_sinc();
+    test_silent_sends();
+    test_operation_sets();
+    test_voice_churn(0);
+    test_voice_churn(FAUDIO_PARALLEL_MIX_EXT);
+    test_device_id();
+    test_no_flag();
+
+    fprintf(stdout, "Finished with %u successful tests and %u failed tests.\n",
+            success_count, failure_count);
+
+    return failure_count > 0;
+}
@@ -0,0 +1,750 @@
+/* FAudio SIMD tests
+ *
+ * This checks every SIMD variant of the converters, linear and sinc resamplers,
+ * amplifier, mixers, MSADPCM decoder and reverb comb bank picked by
+ * FAudio_INTERNAL_InitSIMDFunctions against plain C versions of the same math,
+ * along with the block-based reverb network against its old per-sample self.
+ * Unlike xaudio2.c, this is built directly against FAudio_internal_simd.c and
+ * FAudioFX_reverb.c, and has no XAudio2 equivalent.
+ *
+ * Copyright (c) 2011-2024 Ethan Lee, Luigi Auriemma, and the MonoGame Team
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software in a
+ * product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ */
+
+/* The reverb network is all static functions, so it's built in as well.
+ * This also brings in FAudio_internal.h, which can't be included twice.
+ */
+#include "FAudioFX_reverb.c"
+
+#ifdef FAUDIO_SDL3_PLATFORM
+#include <SDL3/SDL_cpuinfo.h>
+#else
+#include <SDL_cpuinfo.h>
+#endif
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_SAMPLES 4096
+#define MAX_CHANNELS 10
+
+static int failure_count = 0;
+static int success_count = 0;
+static const char *tier_name;
+
+#define ok(success, fmt, ...) ok_(__FILE__, __LINE__, success, fmt, ##__VA_ARGS__)
+static void ok_(const char *file, int line, int success, const char *fmt, ...)
+{
+    if(!success){
+        va_list va;
+        va_start(va, fmt);
+        fprintf(stdout, "test failed (%s:%u, %s): ", file, line, tier_name);
+        vfprintf(stdout, fmt, va);
+        va_end(va);
+        ++failure_count;
+    }else
+        ++success_count;
+}
+
+/* Fixed seed, so failures are reproducible */
+static uint32_t rand_state;
+
+static uint32_t test_rand(void)
+{
+    rand_state = rand_state * 1664525 + 1013904223;
+    return rand_state;
+}
+
+static float test_randf(void)
+{
+    return ((float) (test_rand() >> 8) / (float) (1 << 23)) - 1.0f;
+}
+
+static float test_abs(float f)
+{
+    return (f < 0.0f) ? -f : f;
+}
+
+/* Relative to the size of the values, since FMA changes the last bit */
+static int compare_floats(const float *a, const float *b, uint32_t len, float tolerance, uint32_t *where)
+{
+    uint32_t i;
+    *where = len;
+    for(i = 0; i < len; ++i){
+        float scale = test_abs(a[i]) > 1.0f ? test_abs(a[i]) : 1.0f;
+        if(test_abs(a[i] - b[i]) > tolerance * scale){
+            *where = i;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static const uint32_t lengths[] = { 0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 33, 480, 1021 };
+#define LENGTH_COUNT (sizeof(lengths) / sizeof(lengths[0]))
+
+static void test_converters(void)
+{
+    static uint8_t u8[MAX_SAMPLES];
+    static int16_t s16[MAX_SAMPLES];
+    static int32_t s32[MAX_SAMPLES];
+    static float expected[MAX_SAMPLES], actual[MAX_SAMPLES + 4];
+    uint32_t i, l, offset, where;
+    int match;
+
+    for(i = 0; i < MAX_SAMPLES; ++i){
+        u8[i] = (uint8_t) test_rand();
+        s16[i] = (int16_t) test_rand();
+        s32[i] = (int32_t) test_rand();
+    }
+
+    /* Every length, with the output both aligned and not */
+    for(l = 0; l < LENGTH_COUNT; ++l)
+    for(offset = 0; offset < 4; offset += 3){
+        const uint32_t len = lengths[l];
+
+        for(i = 0; i < len; ++i)
+            expected[i] = (u8[i] * 0.0078125f) - 1.0f;
+        FAudio_INTERNAL_Convert_U8_To_F32(u8, actual + offset, len);
+        ok(memcmp(expected, actual + offset, len * sizeof(float)) == 0,
+                "U8 conversion of %u samples doesn't match\n", len);
+
+        for(i = 0; i < len; ++i)
+            expected[i] = s16[i] * 0.000030517578125f;
+        FAudio_INTERNAL_Convert_S16_To_F32(s16, actual + offset, len);
+        ok(memcmp(expected, actual + offset, len * sizeof(float)) == 0,
+                "S16 conversion of %u samples doesn't match\n", len);
+
+        for(i = 0; i < len; ++i)
+            expected[i] = (s32[i] >> 8) * 0.00000011920930376163766f;
+        FAudio_INTERNAL_Convert_S32_To_F32(s32, actual + offset, len);
+        match = compare_floats(expected, actual + offset, len, 0.0f, &where);
+        ok(match,
+                "S32 conversion of %u samples doesn't match at %u\n", len, where);
+    }
+}
+
+static void test_amplify(void)
+{
+    static float expected[MAX_SAMPLES], actual[MAX_SAMPLES + 4];
+    uint32_t i, l, offset, where;
+    int match;
+
+    for(l = 0; l < LENGTH_COUNT; ++l)
+    for(offset = 0; offset < 4; offset += 1){
+        const uint32_t len = lengths[l];
+        for(i = 0; i < len; ++i){
+            actual[offset + i] = test_randf();
+            expected[i] = actual[offset + i] * 0.3f;
+        }
+        FAudio_INTERNAL_Amplify(actual + offset, len, 0.3f);
+        match = compare_floats(expected, actual + offset, len, 0.0f, &where);
+        ok(match,
+                "Amplify of %u samples doesn't match at %u\n", len, where);
+    }
+}
+
+static void test_resamplers(void)
+{
+    static float src[MAX_SAMPLES * 2], expected[MAX_SAMPLES * 2], actual[MAX_SAMPLES * 2 + 4];
+    static const double ratios[] = { 0.25, 0.5, 0.7256, 1.0884, 2.0, 3.1 };
+    uint64_t step, expectedOffset, actualOffset;
+    uint32_t i, r, l, channels, where;
+    int match;
+
+    for(i = 0; i < MAX_SAMPLES * 2; ++i)
+        src[i] = test_randf();
+
+    for(channels = 1; channels <= 2; ++channels)
+    for(r = 0; r < sizeof(ratios) / sizeof(ratios[0]); ++r)
+    for(l = 0; l < LENGTH_COUNT; ++l){
+        const uint32_t len = lengths[l];
+        step = DOUBLE_TO_FIXED(ratios[r]);
+
+        /* Start partway into a sample, like any update but the first */
+        expectedOffset = actualOffset = test_rand();
+        FAudio_INTERNAL_ResampleGeneric(
+            src, expected, &expectedOffset, step, len, (uint8_t) channels);
+        if(channels == 1)
+            FAudio_INTERNAL_ResampleMono(
+                src, actual + 1, &actualOffset, step, len, 1);
+        else
+            FAudio_INTERNAL_ResampleStereo(
+                src, actual + 2, &actualOffset, step, len, 2);
+
+        ok(actualOffset == expectedOffset,
+                "Resampling %u frames of %u channels at %f ends at the wrong offset\n",
+                len, channels, ratios[r]);
+        match = compare_floats(expected, actual + channels, len * channels, 1e-5f, &where);
+        ok(match,
+                "Resampling %u frames of %u channels at %f doesn't match at %u\n",
+                len, channels, ratios[r], where);
+    }
+}
+
+static void test_sinc_resamplers(void)
+{
+    static float src[(MAX_SAMPLES + FAUDIO_SINC_HISTORY) * 2], expected[MAX_SAMPLES * 2], actual[MAX_SAMPLES * 2 + 4];
+    static const double ratios[] = { 0.25, 0.5, 0.7256, 1.0, 1.0884, 2.0, 3.1, 5.0 };
+    uint64_t step, expectedOffset, actualOffset;
+    uint32_t i, r, l, channels, where;
+    int match;
+
+    for(i = 0; i < (MAX_SAMPLES + FAUDIO_SINC_HISTORY) * 2; ++i)
+        src[i] = test_randf();
+
+    /* The resamplers read FAUDIO_SINC_HISTORY frames before dCache */
+    for(channels = 1; channels <= 2; ++channels)
+    for(r = 0; r < sizeof(ratios) / sizeof(ratios[0]); ++r)
+    for(l = 0; l < LENGTH_COUNT; ++l){
+        const uint32_t len = lengths[l];
+        float *dCache = src + FAUDIO_SINC_HISTORY * channels;
+        step = DOUBLE_TO_FIXED(ratios[r]);
+
+        expectedOffset = actualOffset = test_rand();
+        FAudio_INTERNAL_ResampleSincGeneric(
+            dCache, expected, &expectedOffset, step, len, (uint8_t) channels);
+        if(channels == 1)
+            FAudio_INTERNAL_ResampleSincMono(
+                dCache, actual + 1, &actualOffset, step, len, 1);
+        else
+            FAudio_INTERNAL_ResampleSincStereo(
+                dCache, actual + 2, &actualOffset, step, len, 2);
+
+        ok(actualOffset == expectedOffset,
+                "Sinc resampling %u frames of %u channels at %f ends at the wrong offset\n",
+                len, channels, ratios[r]);
+        match = compare_floats(expected, actual + channels, len * channels, 1e-5f, &where);
+        ok(match,
+                "Sinc resampling %u frames of %u channels at %f doesn't match at %u\n",
+                len, channels, ratios[r], where);
+    }
+
+    /* Whole frames come out as they went in, FAUDIO_SINC_DELAY frames late */
+    for(channels = 1; channels <= 2; ++channels){
+        expectedOffset = 0;
+        (channels == 1 ? FAudio_INTERNAL_ResampleSincMono : FAudio_INTERNAL_ResampleSincStereo)(
+            src + FAUDIO_SINC_HISTORY * channels, actual, &expectedOffset, FIXED_ONE, 480, (uint8_t) channels);
+        match = compare_floats(src + (FAUDIO_SINC_HISTORY - FAUDIO_SINC_DELAY) * channels,
+                actual, 480 * channels, 1e-6f, &where);
+        ok(match, "Sinc resampling %u channels at 1.0 isn't a delay, differs at %u\n",
+                channels, where);
+    }
+
+    /* Unity gain at DC, for every phase and cutoff */
+    for(i = 0; i < MAX_SAMPLES * 2; ++i)
+        expected[i] = 0.5f;
+    for(r = 0; r < sizeof(ratios) / sizeof(ratios[0]); ++r){
+        actualOffset = test_rand();
+        FAudio_INTERNAL_ResampleSincGeneric(expected + FAUDIO_SINC_HISTORY * 3, actual,
+                &actualOffset, DOUBLE_TO_FIXED(ratios[r]), 100, 3);
+        for(i = 0; i < 300; ++i)
+            if(test_abs(actual[i] - 0.5f) > 1e-4f)
+                break;
+        ok(i == 300, "Sinc resampling DC at %f gives %f at %u\n", ratios[r], actual[i % 300], i);
+    }
+}
+
+static void test_mixer(FAudioMixCallback mix, FAudioMixCallback reference,
+        uint32_t srcChans, uint32_t dstChans)
+{
+    static float src[MAX_SAMPLES * MAX_CHANNELS];
+    static float expected[MAX_SAMPLES * MAX_CHANNELS], actual[MAX_SAMPLES * MAX_CHANNELS];
+    float coefficients[MAX_CHANNELS * MAX_CHANNELS];
+    uint32_t i, l, where;
+    int match;
+
+    for(i = 0; i < srcChans * dstChans; ++i)
+        coefficients[i] = test_randf();
+
+    for(l = 0; l < LENGTH_COUNT; ++l){
+        const uint32_t len = lengths[l];
+        for(i = 0; i < len * srcChans; ++i)
+            src[i] = test_randf();
+        for(i = 0; i < len * dstChans; ++i)
+            expected[i] = actual[i] = test_randf();
+
+        reference(len, srcChans, dstChans, src, expected, coefficients);
+        mix(len, srcChans, dstChans, src, actual, coefficients);
+        match = compare_floats(expected, actual, len * dstChans, 1e-5f, &where);
+        ok(match,
+                "Mixing %u frames from %u to %u channels doesn't match at %u\n",
+                len, srcChans, dstChans, where);
+    }
+}
+
+static void test_sparse_mixer(uint32_t srcChans, uint32_t dstChans, uint32_t taps)
+{
+    static float src[MAX_SAMPLES * MAX_CHANNELS];
+    static float expected[MAX_SAMPLES * MAX_CHANNELS], actual[MAX_SAMPLES * MAX_CHANNELS];
+    float coefficients[MAX_CHANNELS * MAX_CHANNELS];
+    FAudioSendPlan plan;
+    uint32_t i, l, where;
+    int match;
+
+    memset(coefficients, 0, sizeof(coefficients));
+    for(i = 0; i < taps; ++i)
+        coefficients[test_rand() % (srcChans * dstChans)] = test_randf();
+    FAudio_INTERNAL_BuildSendPlan(&plan, srcChans, dstChans, coefficients);
+    ok(plan.taps <= taps && plan.sparse == (plan.taps * 4 <= srcChans * dstChans),
+            "Plan for %u taps from %u to %u channels has %u taps, sparse %u\n",
+            taps, srcChans, dstChans, plan.taps, plan.sparse);
+
+    for(l = 0; l < LENGTH_COUNT; ++l){
+        const uint32_t len = lengths[l];
+        for(i = 0; i < len * srcChans; ++i)
+            src[i] = test_randf();
+        for(i = 0; i < len * dstChans; ++i)
+            expected[i] = actual[i] = test_randf();
+
+        FAudio_INTERNAL_Mix_Generic_Scalar(len, srcChans, dstChans, src, expected, coefficients);
+        FAudio_INTERNAL_Mix_Sparse(len, srcChans, dstChans, src, actual, &plan);
+        match = compare_floats(expected, actual, len * dstChans, 1e-5f, &where);
+        ok(match,
+                "Sparse mixing %u frames from %u to %u channels doesn't match at %u\n",
+                len, srcChans, dstChans, where);
+    }
+}
+
+static void test_mixers(void)
+{
+    static const uint32_t generic[][2] = {
+        { 1, 4 }, { 2, 4 }, { 3, 2 }, { 4, 2 }, { 6, 2 },
+        { 6, 6 }, { 8, 2 }, { 8, 8 }, { 9, 3 }, { 10, 6 }
+    };
+    uint32_t i;
+
+    test_mixer(FAudio_INTERNAL_Mix_1in_1out, FAudio_INTERNAL_Mix_1in_1out_Scalar, 1, 1);
+    test_mixer(FAudio_INTERNAL_Mix_1in_2out, FAudio_INTERNAL_Mix_1in_2out_Scalar, 1, 2);
+    test_mixer(FAudio_INTERNAL_Mix_1in_6out, FAudio_INTERNAL_Mix_1in_6out_Scalar, 1, 6);
+    test_mixer(FAudio_INTERNAL_Mix_1in_8out, FAudio_INTERNAL_Mix_1in_8out_Scalar, 1, 8);
+    test_mixer(FAudio_INTERNAL_Mix_2in_1out, FAudio_INTERNAL_Mix_2in_1out_Scalar, 2, 1);
+    test_mixer(FAudio_INTERNAL_Mix_2in_2out, FAudio_INTERNAL_Mix_2in_2out_Scalar, 2, 2);
+    test_mixer(FAudio_INTERNAL_Mix_2in_6out, FAudio_INTERNAL_Mix_2in_6out_Scalar, 2, 6);
+    test_mixer(FAudio_INTERNAL_Mix_2in_8out, FAudio_INTERNAL_Mix_2in_8out_Scalar, 2, 8);
+    for(i = 0; i < sizeof(generic) / sizeof(generic[0]); ++i)
+        test_mixer(FAudio_INTERNAL_Mix_Generic, FAudio_INTERNAL_Mix_Generic_Scalar,
+                generic[i][0], generic[i][1]);
+
+    test_sparse_mixer(1, 8, 1);
+    test_sparse_mixer(1, 6, 0);
+    test_sparse_mixer(2, 8, 2);
+    test_sparse_mixer(2, 6, 3);
+    test_sparse_mixer(6, 2, 6);
+    test_sparse_mixer(8, 8, 64);
+}
+
+static void test_msadpcm(void)
+{
+    /* Odd aligns leave a partial word at the end of each block */
+    static const uint32_t aligns[][2] = {
+        { 1, 8 }, { 1, 36 }, { 1, 70 }, { 1, 71 }, { 1, 512 },
+        { 2, 14 }, { 2, 140 }, { 2, 142 }, { 2, 1024 }
+    };
+    static const uint32_t blockCounts[] = { 0, 1, 3, 4, 7, 8, 9, 17 };
+    static uint8_t src[17 * 1024];
+    static int16_t expected[17 * 2048], actual[17 * 2048 + 1];
+    uint32_t i, a, b, align, channels, blocks, samples;
+
+    for(a = 0; a < sizeof(aligns) / sizeof(aligns[0]); ++a)
+    for(b = 0; b < sizeof(blockCounts) / sizeof(blockCounts[0]); ++b){
+        channels = aligns[a][0];
+        align = aligns[a][1];
+        blocks = blockCounts[b];
+        samples = blocks * ((align / channels) - 6) * 2 * channels;
+
+        /* Random data covers every nibble, predictor and delta, bad ones too */
+        for(i = 0; i < blocks * align; ++i)
+            src[i] = (uint8_t) test_rand();
+        actual[samples] = 0x5A5A;
+
+        FAudio_INTERNAL_DecodeMSADPCMBlocks_Scalar(src, expected, blocks, align, channels);
+        FAudio_INTERNAL_DecodeMSADPCMBlocks(src, actual, blocks, align, channels);
+        ok(memcmp(expected, actual, samples * sizeof(int16_t)) == 0,
+                "Decoding %u MSADPCM blocks of %u bytes and %u channels doesn't match\n",
+                blocks, align, channels);
+        ok(actual[samples] == 0x5A5A,
+                "Decoding %u MSADPCM blocks of %u bytes and %u channels overflowed\n",
+                blocks, align, channels);
+    }
+
+    /* A hand-made block that saturates both ways, decoded by the original
+     * nibble-at-a-time decoder, to pin down the scalar reference itself
+     */
+    {
+        static const uint8_t block[] = {
+            0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+            0x07, 0x77, 0x70, 0x0F, 0xF9, 0x99, 0x90, 0x01
+        };
+        static const int16_t decoded[] = {
+            0, 0, 0, 1610, 7077, 21791, 32767, 32767, 32767,
+            26635, 14994, -31290, -32768, -32768, -32768, -32768, -32768, -27465
+        };
+        FAudio_INTERNAL_DecodeMSADPCMBlocks_Scalar(block, expected, 1, sizeof(block), 1);
+        ok(memcmp(expected, decoded, sizeof(decoded)) == 0,
+                "Known MSADPCM block doesn't match\n");
+    }
+}
+
+/* One lane of the reverb's old per-sample comb filter, as it was written in
+ * FAudioFX_reverb.c before the comb bank, second-order shelf state and all
+ */
+typedef struct RefShelf
+{
+    float a0, a1, a2, b1, b2, c0, d0, delay0, delay1;
+} RefShelf;
+
+static float ref_shelf(RefShelf *f, float sample_in)
+{
+    float result = (f->a0 * sample_in) + f->delay0;
+    f->delay0 = (f->a1 * sample_in) - (f->b1 * result) + f->delay1;
+    f->delay1 = (f->a2 * sample_in) - (f->b2 * result);
+    return (result * f->c0) + (sample_in * f->d0);
+}
+
+static void test_comb_bank(void)
+{
+    /* The shortest lane reads back what it wrote 4 samples earlier */
+    static const uint32_t delays[FAUDIO_COMB_BANK_SIZE] = { 4, 5, 9, 31, 480, 1201, 1311, 1760 };
+    static float in[MAX_SAMPLES], expected[MAX_SAMPLES], actual[MAX_SAMPLES];
+    static float expectedLines[FAUDIO_COMB_BANK_SIZE][1760 + MAX_SAMPLES];
+    static float actualLines[FAUDIO_COMB_BANK_SIZE][1760 + MAX_SAMPLES];
+    RefShelf high[FAUDIO_COMB_BANK_SIZE], low[FAUDIO_COMB_BANK_SIZE];
+    FAudioCombBank bank;
+    uint32_t i, k, l, where;
+    float x, feedback;
+    int match;
+
+    for(l = 0; l < LENGTH_COUNT; ++l){
+        const uint32_t len = lengths[l];
+        for(k = 0; k < FAUDIO_COMB_BANK_SIZE; ++k){
+            /* Shelving filters like DspBiQuad_Change makes them, a2 == b2 == 0 */
+            high[k].a0 = 0.6f + test_randf() * 0.3f;
+            high[k].a1 = -high[k].a0;
+            low[k].a0 = 0.1f + test_randf() * 0.05f;
+            low[k].a1 = low[k].a0;
+            high[k].b1 = -0.5f + test_randf() * 0.2f;
+            low[k].b1 = -0.9f + test_randf() * 0.05f;
+            high[k].c0 = test_randf() * 0.5f - 0.5f;
+            low[k].c0 = test_randf() * 0.5f - 0.5f;
+            high[k].a2 = high[k].b2 = low[k].a2 = low[k].b2 = 0.0f;
+            high[k].d0 = low[k].d0 = 1.0f;
+            high[k].delay0 = test_randf() * 0.1f;
+            low[k].delay0 = test_randf() * 0.1f;
+            high[k].delay1 = low[k].delay1 = 0.0f;
+
+            bank.feedback[k] = 0.5f + test_randf() * 0.3f;
+            bank.high_a0[k] = high[k].a0;
+            bank.high_a1[k] = high[k].a1;
+            bank.high_b1[k] = high[k].b1;
+            bank.high_c0[k] = high[k].c0;
+            bank.high_d0[k] = high[k].d0;
+            bank.high_state[k] = high[k].delay0;
+            bank.low_a0[k] = low[k].a0;
+            bank.low_a1[k] = low[k].a1;
+            bank.low_b1[k] = low[k].b1;
+            bank.low_c0[k] = low[k].c0;
+            bank.low_d0[k] = low[k].d0;
+            bank.low_state[k] = low[k].delay0;
+            bank.read[k] = actualLines[k];
+            bank.write[k] = actualLines[k] + delays[k];
+
+            for(i = 0; i < delays[k] + len; ++i)
+                expectedLines[k][i] = actualLines[k][i] = test_randf();
+        }
+        for(i = 0; i < len; ++i)
+            in[i] = test_randf();
+
+        for(i = 0; i < len; ++i){
+            expected[i] = 0.0f;
+            for(k = 0; k < FAUDIO_COMB_BANK_SIZE; ++k){
+                x = expectedLines[k][i];
+                feedback = ref_shelf(&high[k], x);
+                feedback = ref_shelf(&low[k], feedback);
+                expectedLines[k][delays[k] + i] = in[i] + (bank.feedback[k] * feedback);
+                expected[i] += x;
+            }
+        }
+        FAudio_INTERNAL_ProcessCombBank(&bank, in, actual, len);
+
+        /* Bit-identical without FMA contraction, see FAudio_internal_simd.c */
+        match = compare_floats(expected, actual, len, 1e-6f, &where);
+        ok(match, "Comb bank output of %u samples doesn't match at %u\n", len, where);
+        for(k = 0; k < FAUDIO_COMB_BANK_SIZE; ++k){
+            match = compare_floats(expectedLines[k], actualLines[k], delays[k] + len, 1e-6f, &where);
+            ok(match, "Comb bank lane %u of %u samples doesn't match at %u\n", k, len, where);
+            ok(test_abs(high[k].delay0 - bank.high_state[k]) <= 1e-6f &&
+                    test_abs(low[k].delay0 - bank.low_state[k]) <= 1e-6f,
+                    "Comb bank lane %u of %u samples ends in the wrong state\n", k, len);
+        }
+    }
+}
+
+/* The reverb's whole network, as it was before it was processed in blocks:
+ * every sample goes through every stage before the next one comes in. These
+ * run on the same DspReverb state as the real thing.
+ */
+static float ref_delay(DspDelay *d, float sample_in)
+{
+    float out = d->buffer[d->read_idx];
+    d->read_idx = (d->read_idx + 1) % d->capacity;
+    d->buffer[d->write_idx] = sample_in;
+    d->write_idx = (d->write_idx + 1) % d->capacity;
+    return out;
+}
+
+static float ref_allpass(DspAllPass *f, float sample_in)
+{
+    float delay_out = f->delay.buffer[f->delay.read_idx];
+    float to_buf;
+    f->delay.read_idx = (f->delay.read_idx + 1) % f->delay.capacity;
+    to_buf = Undenormalize(sample_in + (f->feedback_gain * delay_out));
+    f->delay.buffer[f->delay.write_idx] = to_buf;
+    f->delay.write_idx = (f->delay.write_idx + 1) % f->delay.capacity;
+    return Undenormalize(delay_out - (f->feedback_gain * to_buf));
+}
+
+static float ref_comb(DspCombShelving *f, float sample_in)
+{
+    float delay_out = f->comb_delay.buffer[f->comb_delay.read_idx];
+    float feedback;
+    f->comb_delay.read_idx = (f->comb_delay.read_idx + 1) % f->comb_delay.capacity;
+    feedback = DspBiQuad_Process(&f->high_shelving, delay_out);
+    feedback = DspBiQuad_Process(&f->low_shelving, feedback);
+    f->comb_delay.buffer[f->comb_delay.write_idx] =
+            Undenormalize(sample_in + (f->comb_feedback_gain * feedback));
+    f->comb_delay.write_idx = (f->comb_delay.write_idx + 1) % f->comb_delay.capacity;
+    return delay_out;
+}
+
+static float ref_early(DspReverb *reverb, float sample_in)
+{
+    float early = ref_delay(&reverb->early_delay, sample_in);
+    int32_t i;
+    for(i = 0; i < REVERB_COUNT_APF_IN; ++i)
+        early = ref_allpass(&reverb->apf_in[i], early);
+    return early;
+}
+
+static float ref_channel(DspReverb *reverb, DspReverbChannel *channel, float sample_in)
+{
+    float revdelay, early_late, sample_out = 0.0f;
+    int32_t i;
+
+    revdelay = ref_delay(&channel->reverb_delay, sample_in);
+    for(i = 0; i < REVERB_COUNT_COMB; ++i)
+        sample_out += ref_comb(&channel->lpf_comb[i], revdelay);
+    sample_out /= (float) REVERB_COUNT_COMB;
+    for(i = 0; i < REVERB_COUNT_APF_OUT; ++i)
+        sample_out = ref_allpass(&channel->apf_out[i], sample_out);
+    early_late = (sample_in * channel->early_gain) + (sample_out * reverb->reverb_gain);
+    sample_out = DspBiQuad_Process(&channel->room_high_shelf, early_late * reverb->room_gain);
+    return sample_out * channel->gain;
+}
+
+/* Every layout DspReverb supports, one frame at a time */
+static void ref_reverb(DspReverb *reverb, const float *in, float *out, uint32_t frames)
+{
+    const int32_t inChans = reverb->in_channels, outChans = reverb->out_channels;
+    float mono, early, late[5];
+    uint32_t i;
+    int32_t c;
+
+    for(i = 0; i < frames; ++i, in += inChans, out += outChans){
+        if(inChans == 1)
+            mono = in[0];
+        else if(inChans == 2)
+            mono = (in[0] + in[1]) / 2.0f;
+        else
+            mono = (in[0] + in[1] + in[2] + in[4] + in[5]) / 5.0f;
+        early = ref_early(reverb, mono);
+
+        if(outChans == 1){
+            out[0] = (ref_channel(reverb, &reverb->channel[0], early) * reverb->wet_ratio) +
+                    (mono * reverb->dry_ratio);
+        }else if(outChans == 2){
+            for(c = 0; c < 2; ++c)
+                out[c] = (ref_channel(reverb, &reverb->channel[c], early) * reverb->wet_ratio) +
+                        in[c] * reverb->dry_ratio;
+        }else{
+            for(c = 0; c < reverb->reverb_channels; ++c)
+                late[c] = (ref_channel(reverb, &reverb->channel[c], early) * reverb->wet_ratio) +
+                        mono * reverb->dry_ratio;
+            out[0] = late[0];
+            out[1] = late[1];
+            if(inChans == 6){
+                out[2] = late[2];
+                out[3] = in[3];
+                out[4] = late[3];
+                out[5] = late[4];
+            }else{
+                out[2] = out[3] = 0.0f;
+                out[4] = late[2];
+                out[5] = late[3];
+            }
+        }
+    }
+}
+
+static float test_reverb_block(DspReverb *reverb, float *in, float *out, uint32_t frames)
+{
+    const uint32_t count = frames * reverb->in_channels;
+    if(reverb->out_channels == 1)
+        return DspReverb_INTERNAL_Process_1_to_1(reverb, in, out, count);
+    if(reverb->out_channels == 2)
+        return DspReverb_INTERNAL_Process_2_to_2(reverb, in, out, count);
+    if(reverb->in_channels == 1)
+        return DspReverb_INTERNAL_Process_1_to_5p1(reverb, in, out, count);
+    if(reverb->in_channels == 2)
+        return DspReverb_INTERNAL_Process_2_to_5p1(reverb, in, out, count);
+    return DspReverb_INTERNAL_Process_5p1_to_5p1(reverb, in, out, count);
+}
+
+static void test_reverb(void)
+{
+    static const struct { int32_t in, out; } layouts[] = {
+        { 1, 1 }, { 1, 6 }, { 2, 2 }, { 2, 6 }, { 6, 6 }
+    };
+    /* Uneven updates, so blocks and delay lines wrap at odd places */
+    static const uint32_t updates[] = { 480, 1, 17, 256, 257, 1021, 441, 3, 960, 512 };
+    static const int32_t rates[] = { 44100, 48000 };
+    static float in[1024 * 6], expected[1024 * 6], actual[1024 * 6];
+    FAudioFXReverbParameters params;
+    DspReverb *ref, *block;
+    uint32_t l, r, u, i, where, frames;
+    int match;
+
+    ref = (DspReverb*) malloc(sizeof(DspReverb));
+    block = (DspReverb*) malloc(sizeof(DspReverb));
+    for(l = 0; l < sizeof(layouts) / sizeof(layouts[0]); ++l){
+        for(r = 0; r < sizeof(rates) / sizeof(rates[0]); ++r){
+            DspReverb_Create(ref, rates[r], layouts[l].in, layouts[l].out, malloc);
+            DspReverb_Create(block, rates[r], layouts[l].in, layouts[l].out, malloc);
+
+            memset(&params, 0, sizeof(params));
+            params.WetDryMix = 70.0f;
+            params.ReflectionsDelay = FAUDIOFX_REVERB_DEFAULT_REFLECTIONS_DELAY;
+            params.ReverbDelay = FAUDIOFX_REVERB_DEFAULT_REVERB_DELAY;
+            params.RearDelay = FAUDIOFX_REVERB_DEFAULT_REAR_DELAY;
+            params.PositionLeft = FAUDIOFX_REVERB_DEFAULT_POSITION;
+            params.PositionRight = FAUDIOFX_REVERB_DEFAULT_POSITION;
+            params.PositionMatrixLeft = FAUDIOFX_REVERB_DEFAULT_POSITION_MATRIX;
+            params.PositionMatrixRight = FAUDIOFX_REVERB_DEFAULT_POSITION_MATRIX;
+            params.EarlyDiffusion = FAUDIOFX_REVERB_DEFAULT_EARLY_DIFFUSION;
+            params.LateDiffusion = FAUDIOFX_REVERB_DEFAULT_LATE_DIFFUSION;
+            params.LowEQGain = FAUDIOFX_REVERB_DEFAULT_LOW_EQ_GAIN;
+            params.LowEQCutoff = FAUDIOFX_REVERB_DEFAULT_LOW_EQ_CUTOFF;
+            params.HighEQGain = FAUDIOFX_REVERB_DEFAULT_HIGH_EQ_GAIN;
+            params.HighEQCutoff = FAUDIOFX_REVERB_DEFAULT_HIGH_EQ_CUTOFF;
+            params.RoomFilterFreq = FAUDIOFX_REVERB_DEFAULT_ROOM_FILTER_FREQ;
+            params.RoomFilterMain = -3.0f;
+            params.RoomFilterHF = -6.0f;
+            params.ReflectionsGain = FAUDIOFX_REVERB_DEFAULT_REFLECTIONS_GAIN;
+            params.ReverbGain = FAUDIOFX_REVERB_DEFAULT_REVERB_GAIN;
+            params.DecayTime = 2.5f;
+            params.Density = FAUDIOFX_REVERB_DEFAULT_DENSITY;
+            params.RoomSize = FAUDIOFX_REVERB_DEFAULT_ROOM_SIZE;
+            DspReverb_SetParameters(ref, &params);
+            DspReverb_SetParameters(block, &params);
+
+            for(u = 0; u < sizeof(updates) / sizeof(updates[0]); ++u){
+                frames = updates[u];
+
+                /* Parameters change between updates, like SetParameters does */
+                if(u == 5){
+                    params.ReflectionsDelay = 40;
+                    params.ReverbDelay = 30;
+                    params.DecayTime = 0.8f;
+                    params.WetDryMix = 100.0f;
+                    DspReverb_SetParameters(ref, &params);
+                    DspReverb_SetParameters(block, &params);
+                }
+
+                for(i = 0; i < frames * layouts[l].in; ++i)
+                    in[i] = test_randf() * 0.5f;
+                ref_reverb(ref, in, expected, frames);
+                test_reverb_block(block, in, actual, frames);
+
+                /* Bit-identical without FMA contraction, see FAudioFX_reverb.c */
+                match = compare_floats(expected, actual, frames * layouts[l].out, 1e-6f, &where);
+                ok(match, "Reverb %d to %d at %d, update %u doesn't match at %u\n",
+                        layouts[l].in, layouts[l].out, rates[r], u, where);
+            }
+
+            DspReverb_Destroy(ref, free);
+            DspReverb_Destroy(block, free);
+        }
+    }
+    free(ref);
+    free(block);
+}
+
+static void test_tier(const char *name, uint8_t sse2, uint8_t neon, uint8_t avx2, uint8_t avx512f)
+{
+    tier_name = name;
+    rand_state = 0x46417564;
+    FAudio_INTERNAL_InitSIMDFunctions(sse2, neon, avx2, avx512f);
+    test_converters();
+    test_amplify();
+    test_resamplers();
+    test_sinc_resamplers();
+    test_mixers();
+    test_msadpcm();
+    test_comb_bank();
+    test_reverb();
+}
+
+int main(int argc, char **argv)
+{
+#ifdef FAUDIO_WIN32_PLATFORM
+    uint8_t has_sse2 = IsProcessorFeaturePresent(PF_XMMI64_INSTRUCTIONS_AVAILABLE);
+    uint8_t has_avx2 = IsProcessorFeaturePresent(40 /* PF_AVX2_INSTRUCTIONS_AVAILABLE */);
+    uint8_t has_avx512f = IsProcessorFeaturePresent(41 /* PF_AVX512F_INSTRUCTIONS_AVAILABLE */);
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__arm64ec__) || defined(_M_ARM64EC)
+    uint8_t has_neon = 1;
+#else
+    uint8_t has_neon = 0;
+#endif
+#else
+    uint8_t has_sse2 = SDL_HasSSE2();
+    uint8_t has_neon = SDL_HasNEON();
+    uint8_t has_avx2 = SDL_HasAVX2();
+    uint8_t has_avx512f = SDL_HasAVX512F();
+#endif
+
+    if(has_sse2){
+        test_tier("SSE2", 1, 0, 0, 0);
+        if(has_avx2)
+            test_tier("AVX2", 1, 0, 1, 0);
+        if(has_avx512f)
+            test_tier("AVX-512F", 1, 0, has_avx2, 1);
+    }else if(has_neon){
+        test_tier("NEON", 0, 1, 0, 0);
+    }else{
+        test_tier("Scalar", 0, 0, 0, 0);
+    }
+
+    fprintf(stdout, "Finished with %u successful tests and %u failed tests.\n",
+            success_count, failure_count);
+
+    return failure_count > 0;
+}
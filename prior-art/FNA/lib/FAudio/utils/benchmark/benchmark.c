@@ -0,0 +1,676 @@
+/* FAudio - XAudio Reimplementation for FNA
+ *
+ * Copyright (c) 2011-2024 Ethan Lee, Luigi Auriemma, and the MonoGame Team
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software in a
+ * product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ * Ethan "flibitijibibo" Lee <flibitijibibo@flibitijibibo.com>
+ *
+ */
+
+/* Headless mixer benchmark.
+ *
+ * Each scenario builds a canned voice graph on an offline engine (see
+ * "extensions/OfflineRenderEXT.txt") and times how long the engine takes to
+ * render one quantum. The stage breakdown comes from the engine's own timings
+ * (see "extensions/TimingEXT.txt"), recorded over a second set of runs so the
+ * clock reads don't count against the wall time. Builds without the debug
+ * configuration have no timings, so the breakdown is reported as null.
+ *
+ * Results are written to stdout as JSON, everything else goes to stderr.
+ *
+ * Usage: faudio_benchmark [-q quanta] [-r runs] [-l] [-a bytes] [-s] [scenario ...]
+ *
+ * -q	Quanta timed per run (default 500)
+ * -r	Runs per measurement, the fastest run is reported (default 5)
+ * -l	Use FAUDIO_1024_QUANTUM
+ * -a	ADPCMCacheEXT budget in bytes (default 0, disabled)
+ * -s	Create every source voice with FAUDIO_VOICE_SINC_EXT
+ *
+ * Scenario names filter which scenarios run, by default all of them do.
+ */
+
+#include <FAudio.h>
+#include <FAudioFX.h>
+#include <FAPOFX.h>
+#include <stdio.h> /* printf */
+#include <stdlib.h> /* malloc, atoi */
+#include <string.h> /* strcmp, memset */
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define MIX_RATE 48000
+#define MIX_CHANNELS 2
+#define SOURCE_SECONDS 1
+#define WARMUP_QUANTA 16
+#define MAX_SUBMIX_DEPTH 8
+#define ADPCM_BLOCK_ALIGN 512
+#define TIMING_POLL_QUANTA 128 /* Less than the TimingEXT ring */
+
+#define EFFECT_REVERB	0x1
+#define EFFECT_EQ	0x2
+
+typedef enum BenchFormat
+{
+	FORMAT_PCM16,
+	FORMAT_MSADPCM,
+	FORMAT_FLOAT
+} BenchFormat;
+
+static const char *formatNames[] =
+{
+	"pcm16",
+	"msadpcm",
+	"float"
+};
+
+static const char *stageNames[FAUDIO_TIMING_STAGE_COUNT_EXT] =
+{
+	"decode",
+	"resample",
+	"effect",
+	"mix",
+	"submix",
+	"master"
+};
+
+typedef struct BenchScenario
+{
+	const char *name;
+	BenchFormat format;
+	uint32_t sources;
+	uint32_t sourceRate;
+	uint32_t submixDepth;
+	uint32_t effects; /* Applied to the first submix */
+} BenchScenario;
+
+static const BenchScenario scenarios[] =
+{
+	{ "pcm16_48k",		FORMAT_PCM16,	64,	48000,	0,	0 },
+	{ "pcm16_44k",		FORMAT_PCM16,	64,	44100,	0,	0 },
+	{ "pcm16_22k",		FORMAT_PCM16,	64,	22050,	0,	0 },
+	{ "msadpcm_48k",	FORMAT_MSADPCM,	64,	48000,	0,	0 },
+	{ "msadpcm_44k",	FORMAT_MSADPCM,	64,	44100,	0,	0 },
+	{ "msadpcm_22k",	FORMAT_MSADPCM,	64,	22050,	0,	0 },
+	{ "float_48k",		FORMAT_FLOAT,	64,	48000,	0,	0 },
+	{ "float_44k",		FORMAT_FLOAT,	64,	44100,	0,	0 },
+	{ "pcm16_submix1",	FORMAT_PCM16,	64,	44100,	1,	0 },
+	{ "pcm16_submix4",	FORMAT_PCM16,	64,	44100,	4,	0 },
+	{ "pcm16_reverb",	FORMAT_PCM16,	64,	44100,	1,	EFFECT_REVERB },
+	{ "pcm16_eq",		FORMAT_PCM16,	64,	44100,	1,	EFFECT_EQ },
+	{ "pcm16_reverb_eq",	FORMAT_PCM16,	64,	44100,	1,	EFFECT_REVERB | EFFECT_EQ },
+	{ "msadpcm_game",	FORMAT_MSADPCM,	256,	44100,	2,	EFFECT_REVERB | EFFECT_EQ }
+};
+
+#define SCENARIO_COUNT (sizeof(scenarios) / sizeof(scenarios[0]))
+
+typedef struct BenchGraph
+{
+	FAudio *audio;
+	FAudioMasteringVoice *master;
+	FAudioSubmixVoice *submixes[MAX_SUBMIX_DEPTH];
+	FAudioSourceVoice **sources;
+	uint8_t *data;
+	float *output;
+	uint32_t quantum;
+} BenchGraph;
+
+typedef struct BenchResult
+{
+	uint32_t quantum;
+	double ns; /* Wall time */
+	uint8_t hasStages;
+	double stageNS[FAUDIO_TIMING_STAGE_COUNT_EXT];
+} BenchResult;
+
+/* Fixed seed, so every run decodes the same data */
+static uint32_t randState;
+
+/* See "extensions/ADPCMCacheEXT.txt" */
+static uint32_t adpcmCacheBudget = 0;
+
+/* See "extensions/SincResampleEXT.txt" */
+static uint32_t sourceFlags = 0;
+
+static uint32_t bench_rand(void)
+{
+	randState = randState * 1664525 + 1013904223;
+	return randState >> 8;
+}
+
+static uint64_t bench_ticks(void)
+{
+#ifdef _WIN32
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+	return (uint64_t) (
+		(double) counter.QuadPart * 1000000000.0 /
+		(double) frequency.QuadPart
+	);
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t) ts.tv_sec * 1000000000) + ts.tv_nsec;
+#endif
+}
+
+/* Fills a mono buffer with noise in the given format. MSADPCM decoding costs
+ * the same no matter what the nibbles are, so we only keep the block headers
+ * valid.
+ */
+static uint32_t create_source_data(
+	BenchFormat format,
+	uint32_t rate,
+	FAudioADPCMWaveFormat *fmt,
+	uint8_t **data
+) {
+	uint32_t i, j, frames, bytes;
+	int16_t *pcm;
+	float *flt;
+	uint8_t *block;
+
+	frames = rate * SOURCE_SECONDS;
+	memset(fmt, '\0', sizeof(FAudioADPCMWaveFormat));
+	fmt->wfx.nChannels = 1;
+	fmt->wfx.nSamplesPerSec = rate;
+
+	if (format == FORMAT_PCM16)
+	{
+		fmt->wfx.wFormatTag = FAUDIO_FORMAT_PCM;
+		fmt->wfx.wBitsPerSample = 16;
+		fmt->wfx.nBlockAlign = 2;
+		bytes = frames * 2;
+		pcm = (int16_t*) malloc(bytes);
+		for (i = 0; i < frames; i += 1)
+		{
+			pcm[i] = (int16_t) (bench_rand() & 0xFFFF);
+		}
+		*data = (uint8_t*) pcm;
+	}
+	else if (format == FORMAT_FLOAT)
+	{
+		fmt->wfx.wFormatTag = FAUDIO_FORMAT_IEEE_FLOAT;
+		fmt->wfx.wBitsPerSample = 32;
+		fmt->wfx.nBlockAlign = 4;
+		bytes = frames * 4;
+		flt = (float*) malloc(bytes);
+		for (i = 0; i < frames; i += 1)
+		{
+			flt[i] = ((float) bench_rand() / (float) (1 << 23)) - 1.0f;
+		}
+		*data = (uint8_t*) flt;
+	}
+	else
+	{
+		fmt->wfx.wFormatTag = FAUDIO_FORMAT_MSADPCM;
+		fmt->wfx.wBitsPerSample = 4;
+		fmt->wfx.nBlockAlign = ADPCM_BLOCK_ALIGN;
+		fmt->wfx.cbSize = sizeof(FAudioADPCMWaveFormat) - sizeof(FAudioWaveFormatEx);
+		fmt->wSamplesPerBlock = (ADPCM_BLOCK_ALIGN - 6) * 2;
+		bytes = (
+			(frames + fmt->wSamplesPerBlock - 1) /
+			fmt->wSamplesPerBlock
+		) * ADPCM_BLOCK_ALIGN;
+		*data = (uint8_t*) malloc(bytes);
+		for (i = 0; i < bytes; i += ADPCM_BLOCK_ALIGN)
+		{
+			block = *data + i;
+			block[0] = bench_rand() % 7; /* Predictor */
+			block[1] = 16 + (bench_rand() & 0x7F); /* Delta */
+			block[2] = 0;
+			for (j = 3; j < ADPCM_BLOCK_ALIGN; j += 1)
+			{
+				block[j] = bench_rand() & 0xFF;
+			}
+		}
+	}
+	fmt->wfx.nAvgBytesPerSec = (
+		fmt->wfx.nSamplesPerSec *
+		fmt->wfx.nBlockAlign
+	);
+	if (format == FORMAT_MSADPCM)
+	{
+		fmt->wfx.nAvgBytesPerSec /= fmt->wSamplesPerBlock;
+	}
+	return bytes;
+}
+
+static void attach_effects(FAudioVoice *voice, uint32_t effects)
+{
+	FAudioEffectDescriptor desc[2];
+	FAudioEffectChain chain;
+	uint32_t i;
+
+	chain.EffectCount = 0;
+	chain.pEffectDescriptors = desc;
+	if (effects & EFFECT_REVERB)
+	{
+		FAudioCreateReverb(&desc[chain.EffectCount].pEffect, 0);
+		chain.EffectCount += 1;
+	}
+	if (effects & EFFECT_EQ)
+	{
+		FAPOFX_CreateFX(
+			&FAPOFX_CLSID_FXEQ,
+			&desc[chain.EffectCount].pEffect,
+			NULL,
+			0
+		);
+		chain.EffectCount += 1;
+	}
+	for (i = 0; i < chain.EffectCount; i += 1)
+	{
+		desc[i].InitialState = 1;
+		desc[i].OutputChannels = MIX_CHANNELS;
+	}
+
+	FAudioVoice_SetEffectChain(voice, &chain);
+
+	/* The voice holds its own references now */
+	for (i = 0; i < chain.EffectCount; i += 1)
+	{
+		desc[i].pEffect->Release(desc[i].pEffect);
+	}
+}
+
+static uint8_t create_graph(
+	BenchGraph *graph,
+	const BenchScenario *scenario,
+	uint32_t engineFlags
+) {
+	FAudioADPCMWaveFormat fmt;
+	FAudioSendDescriptor send;
+	FAudioVoiceSends sends;
+	FAudioBuffer buffer;
+	uint32_t i, bytes, voiceFlags;
+
+	memset(graph, '\0', sizeof(BenchGraph));
+	if (FAudioCreate(
+		&graph->audio,
+		FAUDIO_OFFLINE_RENDER_EXT | engineFlags,
+		FAUDIO_DEFAULT_PROCESSOR
+	) != 0) {
+		return 0;
+	}
+	if (FAudio_CreateMasteringVoice(
+		graph->audio,
+		&graph->master,
+		MIX_CHANNELS,
+		MIX_RATE,
+		0,
+		0,
+		NULL
+	) != 0) {
+		FAudio_Release(graph->audio);
+		return 0;
+	}
+	FAudio_GetProcessingQuantum(graph->audio, &graph->quantum, NULL);
+	FAudio_SetADPCMCacheBudgetEXT(graph->audio, adpcmCacheBudget);
+	graph->output = (float*) malloc(
+		sizeof(float) * graph->quantum * MIX_CHANNELS
+	);
+
+	/* Submixes feed each other, the last one feeds the master */
+	sends.SendCount = 1;
+	sends.pSends = &send;
+	send.Flags = 0;
+	for (i = scenario->submixDepth; i > 0; i -= 1)
+	{
+		send.pOutputVoice = (i == scenario->submixDepth) ?
+			graph->master :
+			graph->submixes[i];
+		FAudio_CreateSubmixVoice(
+			graph->audio,
+			&graph->submixes[i - 1],
+			MIX_CHANNELS,
+			MIX_RATE,
+			0,
+			i,
+			&sends,
+			NULL
+		);
+	}
+	if (scenario->effects && scenario->submixDepth > 0)
+	{
+		attach_effects(graph->submixes[0], scenario->effects);
+	}
+
+	/* Every source plays the same looping buffer */
+	randState = 0x46417564;
+	bytes = create_source_data(
+		scenario->format,
+		scenario->sourceRate,
+		&fmt,
+		&graph->data
+	);
+	memset(&buffer, '\0', sizeof(buffer));
+	buffer.AudioBytes = bytes;
+	buffer.pAudioData = graph->data;
+	buffer.LoopCount = FAUDIO_LOOP_INFINITE;
+
+	voiceFlags = sourceFlags | ((scenario->sourceRate == MIX_RATE) ?
+		FAUDIO_VOICE_NOSRC | FAUDIO_VOICE_NOPITCH :
+		0
+	);
+	send.pOutputVoice = (scenario->submixDepth > 0) ?
+		graph->submixes[0] :
+		graph->master;
+	graph->sources = (FAudioSourceVoice**) malloc(
+		sizeof(FAudioSourceVoice*) * scenario->sources
+	);
+	for (i = 0; i < scenario->sources; i += 1)
+	{
+		FAudio_CreateSourceVoice(
+			graph->audio,
+			&graph->sources[i],
+			&fmt.wfx,
+			voiceFlags,
+			FAUDIO_DEFAULT_FREQ_RATIO,
+			NULL,
+			&sends,
+			NULL
+		);
+		FAudioSourceVoice_SubmitSourceBuffer(
+			graph->sources[i],
+			&buffer,
+			NULL
+		);
+		FAudioSourceVoice_Start(graph->sources[i], 0, FAUDIO_COMMIT_NOW);
+	}
+	return 1;
+}
+
+static void destroy_graph(BenchGraph *graph, const BenchScenario *scenario)
+{
+	uint32_t i;
+	for (i = 0; i < scenario->sources; i += 1)
+	{
+		FAudioVoice_DestroyVoice(graph->sources[i]);
+	}
+	for (i = 0; i < scenario->submixDepth; i += 1)
+	{
+		FAudioVoice_DestroyVoice(graph->submixes[i]);
+	}
+	FAudioVoice_DestroyVoice(graph->master);
+	FAudio_Release(graph->audio);
+	free(graph->sources);
+	free(graph->data);
+	free(graph->output);
+}
+
+/* Renders the given number of quanta and sums the engine's stage timings.
+ * Returns 0 if the engine has no timings to give.
+ */
+static uint8_t render_timed(
+	BenchGraph *graph,
+	uint32_t quanta,
+	uint64_t *totalNS,
+	uint64_t *stageNS
+) {
+	FAudioQuantumTimingEXT timings[TIMING_POLL_QUANTA];
+	uint32_t i, j, k, chunk, count;
+	uint8_t any = 0;
+
+	*totalNS = 0;
+	memset(stageNS, '\0', sizeof(uint64_t) * FAUDIO_TIMING_STAGE_COUNT_EXT);
+	for (i = 0; i < quanta; i += chunk)
+	{
+		chunk = quanta - i;
+		if (chunk > TIMING_POLL_QUANTA)
+		{
+			chunk = TIMING_POLL_QUANTA;
+		}
+		for (j = 0; j < chunk; j += 1)
+		{
+			FAudio_RenderEXT(graph->audio, graph->output, 1);
+		}
+
+		while ((count = FAudio_GetQuantumTimingsEXT(
+			graph->audio,
+			timings,
+			TIMING_POLL_QUANTA
+		)) > 0) {
+			any = 1;
+			for (j = 0; j < count; j += 1)
+			{
+				*totalNS += timings[j].TotalNS;
+				for (k = 0; k < FAUDIO_TIMING_STAGE_COUNT_EXT; k += 1)
+				{
+					stageNS[k] += timings[j].StageNS[k];
+				}
+			}
+		}
+	}
+	return any;
+}
+
+/* Reports the fastest run's average time per quantum, in nanoseconds */
+static uint8_t time_scenario(
+	const BenchScenario *scenario,
+	uint32_t engineFlags,
+	uint32_t quanta,
+	uint32_t runs,
+	BenchResult *result
+) {
+	BenchGraph graph;
+	FAudioDebugConfiguration debug;
+	FAudioQuantumTimingEXT discard[TIMING_POLL_QUANTA];
+	uint64_t start, elapsed, best, totalNS, bestTotal;
+	uint64_t stageNS[FAUDIO_TIMING_STAGE_COUNT_EXT];
+	uint32_t i, j;
+
+	memset(result, '\0', sizeof(BenchResult));
+	if (!create_graph(&graph, scenario, engineFlags))
+	{
+		fprintf(stderr, "%s: Could not create the voice graph\n", scenario->name);
+		return 0;
+	}
+	result->quantum = graph.quantum;
+
+	for (i = 0; i < WARMUP_QUANTA; i += 1)
+	{
+		FAudio_RenderEXT(graph.audio, graph.output, 1);
+	}
+
+	best = ~((uint64_t) 0);
+	for (i = 0; i < runs; i += 1)
+	{
+		start = bench_ticks();
+		for (j = 0; j < quanta; j += 1)
+		{
+			FAudio_RenderEXT(graph.audio, graph.output, 1);
+		}
+		elapsed = bench_ticks() - start;
+		if (elapsed < best)
+		{
+			best = elapsed;
+		}
+	}
+	result->ns = (double) best / (double) quanta;
+
+	/* Same graph again, this time with the engine timing each stage */
+	memset(&debug, '\0', sizeof(debug));
+	debug.TraceMask = FAUDIO_LOG_TIMING;
+	FAudio_SetDebugConfiguration(graph.audio, &debug, NULL);
+	FAudio_RenderEXT(graph.audio, graph.output, 1);
+	while (FAudio_GetQuantumTimingsEXT(graph.audio, discard, TIMING_POLL_QUANTA) > 0);
+
+	bestTotal = ~((uint64_t) 0);
+	for (i = 0; i < runs; i += 1)
+	{
+		if (!render_timed(&graph, quanta, &totalNS, stageNS))
+		{
+			break;
+		}
+		if (totalNS < bestTotal)
+		{
+			bestTotal = totalNS;
+			result->hasStages = 1;
+			for (j = 0; j < FAUDIO_TIMING_STAGE_COUNT_EXT; j += 1)
+			{
+				result->stageNS[j] = (double) stageNS[j] / (double) quanta;
+			}
+		}
+	}
+
+	destroy_graph(&graph, scenario);
+	return 1;
+}
+
+static uint8_t scenario_selected(const char *name, int argc, char **argv, int first)
+{
+	int i;
+	if (first >= argc)
+	{
+		return 1;
+	}
+	for (i = first; i < argc; i += 1)
+	{
+		if (strcmp(argv[i], name) == 0)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	const BenchScenario *scenario;
+	BenchResult result;
+	double quantumNS;
+	uint32_t quanta = 500, runs = 5, engineFlags = 0;
+	uint32_t i, j, printed = 0;
+	int arg;
+
+	for (arg = 1; arg < argc && argv[arg][0] == '-'; arg += 1)
+	{
+		if (strcmp(argv[arg], "-q") == 0 && arg + 1 < argc)
+		{
+			quanta = (uint32_t) atoi(argv[++arg]);
+		}
+		else if (strcmp(argv[arg], "-r") == 0 && arg + 1 < argc)
+		{
+			runs = (uint32_t) atoi(argv[++arg]);
+		}
+		else if (strcmp(argv[arg], "-l") == 0)
+		{
+			engineFlags |= FAUDIO_1024_QUANTUM;
+		}
+		else if (strcmp(argv[arg], "-a") == 0 && arg + 1 < argc)
+		{
+			adpcmCacheBudget = (uint32_t) atoi(argv[++arg]);
+		}
+		else if (strcmp(argv[arg], "-s") == 0)
+		{
+			sourceFlags |= FAUDIO_VOICE_SINC_EXT;
+		}
+		else
+		{
+			fprintf(
+				stderr,
+				"Usage: %s [-q quanta] [-r runs] [-l] [-a bytes] [-s] [scenario ...]\n",
+				argv[0]
+			);
+			return 1;
+		}
+	}
+	if (quanta == 0 || runs == 0)
+	{
+		fprintf(stderr, "Quanta and runs must be above 0\n");
+		return 1;
+	}
+
+	printf("{\n");
+	printf("\t\"version\": %u,\n", FAudioLinkedVersion());
+	printf("\t\"sample_rate\": %u,\n", MIX_RATE);
+	printf("\t\"channels\": %u,\n", MIX_CHANNELS);
+	printf("\t\"quanta\": %u,\n", quanta);
+	printf("\t\"runs\": %u,\n", runs);
+	printf("\t\"adpcm_cache_budget\": %u,\n", adpcmCacheBudget);
+	printf("\t\"sinc\": %s,\n", (sourceFlags & FAUDIO_VOICE_SINC_EXT) ? "true" : "false");
+	printf("\t\"scenarios\": [");
+	for (i = 0; i < SCENARIO_COUNT; i += 1)
+	{
+		scenario = &scenarios[i];
+		if (!scenario_selected(scenario->name, argc, argv, arg))
+		{
+			continue;
+		}
+		fprintf(stderr, "Running %s...\n", scenario->name);
+
+		if (!time_scenario(scenario, engineFlags, quanta, runs, &result))
+		{
+			continue;
+		}
+
+		/* One quantum is this long in real time */
+		quantumNS = (double) result.quantum * 1000000000.0 / (double) MIX_RATE;
+
+		printf("%s\n\t\t{\n", printed ? "," : "");
+		printf("\t\t\t\"name\": \"%s\",\n", scenario->name);
+		printf("\t\t\t\"format\": \"%s\",\n", formatNames[scenario->format]);
+		printf("\t\t\t\"sources\": %u,\n", scenario->sources);
+		printf("\t\t\t\"source_rate\": %u,\n", scenario->sourceRate);
+		printf("\t\t\t\"submix_depth\": %u,\n", scenario->submixDepth);
+		printf(
+			"\t\t\t\"effects\": [%s%s%s],\n",
+			(scenario->effects & EFFECT_REVERB) ? "\"reverb\"" : "",
+			(scenario->effects == (EFFECT_REVERB | EFFECT_EQ)) ? ", " : "",
+			(scenario->effects & EFFECT_EQ) ? "\"eq\"" : ""
+		);
+		printf("\t\t\t\"quantum_frames\": %u,\n", result.quantum);
+		printf("\t\t\t\"ns_per_quantum\": %.1f,\n", result.ns);
+		printf(
+			"\t\t\t\"voices_per_core\": %.1f,\n",
+			(result.ns > 0.0) ?
+				scenario->sources * quantumNS / result.ns :
+				0.0
+		);
+		if (result.hasStages)
+		{
+			printf("\t\t\t\"stages_ns_per_quantum\": {\n");
+			for (j = 0; j < FAUDIO_TIMING_STAGE_COUNT_EXT; j += 1)
+			{
+				printf(
+					"\t\t\t\t\"%s\": %.1f%s\n",
+					stageNames[j],
+					result.stageNS[j],
+					(j < FAUDIO_TIMING_STAGE_COUNT_EXT - 1) ? "," : ""
+				);
+			}
+			printf("\t\t\t}\n");
+		}
+		else
+		{
+			printf("\t\t\t\"stages_ns_per_quantum\": null\n");
+		}
+		printf("\t\t}");
+		fflush(stdout);
+		printed = 1;
+	}
+	printf("\n\t]\n}\n");
+	return 0;
+}
@@ -570,7 +570,7 @@ void FAudioTool_Update()
 				);
 				ImGui::Text(
 					"RPC Code Count: %d",
-					soundBanks[i]->sounds[j].rpcCodeCount
+					soundBanks[i]->sounds[j].rpcCount
 				);
 				ImGui::Text(
 					"DSP Preset Code Count: %d",
@@ -582,11 +582,13 @@ void FAudioTool_Update()
 				);
 				if (ImGui::TreeNode("RPC Codes"))
 				{
-					for (uint8_t k = 0; k < soundBanks[i]->sounds[j].rpcCodeCount; k += 1)
+					for (uint8_t k = 0; k < soundBanks[i]->sounds[j].rpcCount; k += 1)
 					{
 						ImGui::Text(
 							"%d",
-							soundBanks[i]->sounds[j].rpcCodes[k]
+							soundBanks[i]->parentEngine->rpcCodes[
+								soundBanks[i]->sounds[j].rpcs[k]
+							]
 						);
 					}
 					ImGui::TreePop();
@@ -628,7 +630,7 @@ void FAudioTool_Update()
 						);
 						ImGui::Text(
 							"RPC Code Count: %d",
-							soundBanks[i]->sounds[j].tracks[k].rpcCodeCount
+							soundBanks[i]->sounds[j].tracks[k].rpcCount
 						);
 						ImGui::Text(
 							"Event Count: %d",
@@ -636,11 +638,13 @@ void FAudioTool_Update()
 						);
 						if (ImGui::TreeNode("RPC Codes"))
 						{
-							for (uint8_t l = 0; l < soundBanks[i]->sounds[j].tracks[k].rpcCodeCount; l += 1)
+							for (uint8_t l = 0; l < soundBanks[i]->sounds[j].tracks[k].rpcCount; l += 1)
 							{
 								ImGui::Text(
 									"%d",
-									soundBanks[i]->sounds[j].tracks[k].rpcCodes[l]
+									soundBanks[i]->parentEngine->rpcCodes[
+										soundBanks[i]->sounds[j].tracks[k].rpcs[l]
+									]
 								);
 							}
 							ImGui::TreePop();
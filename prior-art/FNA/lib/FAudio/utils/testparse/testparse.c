@@ -86,9 +86,9 @@ static void print_soundbank(FACTAudioEngine *engine, uint8_t *buf, size_t len)
 			sb->sounds[i].priority
 		);
 		printf("\t\tRPC Codes:");
-		for (j = 0; j < sb->sounds[i].rpcCodeCount; j += 1)
+		for (j = 0; j < sb->sounds[i].rpcCount; j += 1)
 		{
-			printf(" %d", sb->sounds[i].rpcCodes[j]);
+			printf(" %d", sb->parentEngine->rpcCodes[sb->sounds[i].rpcs[j]]);
 		}
 		printf("\n");
 		printf("\t\tDSP Preset Codes:");
@@ -113,11 +113,13 @@ static void print_soundbank(FACTAudioEngine *engine, uint8_t *buf, size_t len)
 				sb->sounds[i].tracks[j].frequency
 			);
 			printf("\t\t\t\tRPC Codes:");
-			for (k = 0; k < sb->sounds[i].tracks[j].rpcCodeCount; k += 1)
+			for (k = 0; k < sb->sounds[i].tracks[j].rpcCount; k += 1)
 			{
 				printf(
 					" %d",
-					sb->sounds[i].tracks[j].rpcCodes[k]
+					sb->parentEngine->rpcCodes[
+						sb->sounds[i].tracks[j].rpcs[k]
+					]
 				);
 			}
 			printf("\n");
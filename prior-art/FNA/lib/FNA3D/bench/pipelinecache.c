@@ -0,0 +1,226 @@
+/* FNA3D - 3D Graphics Library for FNA
+ *
+ * Copyright (c) 2020-2024 Ethan Lee
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software in a
+ * product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ * Ethan "flibitijibibo" Lee <flibitijibibo@flibitijibibo.com>
+ *
+ */
+
+/* Measures lookups in the packed state and vertex bindings caches, which every
+ * backend hits on each state change and draw call.
+ */
+
+#ifdef USE_SDL3
+#include <SDL3/SDL.h>
+#else
+#include <SDL.h>
+#endif
+
+#include "FNA3D_PipelineCache.h"
+
+#define NUM_LOOKUPS 1000000
+
+static const int32_t cacheSizes[] = { 10, 100, 10000 };
+
+/* The old cache was a straight scan, keep it around for comparison */
+static void* LinearFetch(PackedStateArray arr, PackedState key)
+{
+	int32_t i;
+
+	for (i = 0; i < arr.count; i += 1)
+	{
+		if (	key.a == arr.elements[i].key.a &&
+			key.b == arr.elements[i].key.b		)
+		{
+			return arr.elements[i].value;
+		}
+	}
+
+	return NULL;
+}
+
+static FNA3D_SamplerState MakeSamplerState(int32_t i)
+{
+	FNA3D_SamplerState state;
+
+	/* Sampler states mostly differ in a few small fields */
+	state.filter = (FNA3D_TextureFilter) (i % 9);
+	state.addressU = (FNA3D_TextureAddressMode) ((i / 9) % 3);
+	state.addressV = (FNA3D_TextureAddressMode) ((i / 27) % 3);
+	state.addressW = FNA3D_TEXTUREADDRESSMODE_WRAP;
+	state.maxAnisotropy = 4;
+	state.maxMipLevel = i / 81;
+	state.mipMapLevelOfDetailBias = 0.0f;
+	return state;
+}
+
+static double Elapsed(Uint64 start)
+{
+	return (
+		(double) (SDL_GetPerformanceCounter() - start) /
+		(double) SDL_GetPerformanceFrequency()
+	);
+}
+
+static void BenchStates(int32_t count)
+{
+	PackedStateArray arr;
+	PackedState *keys;
+	Uint64 start;
+	double hashed, linear;
+	int32_t i, misses = 0;
+
+	SDL_zero(arr);
+	keys = (PackedState*) SDL_malloc(sizeof(PackedState) * count);
+	for (i = 0; i < count; i += 1)
+	{
+		keys[i] = GetPackedSamplerState(MakeSamplerState(i));
+		PackedStateArray_Insert(&arr, keys[i], (void*) (size_t) (i + 1));
+	}
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < NUM_LOOKUPS; i += 1)
+	{
+		misses += PackedStateArray_Fetch(arr, keys[(i * 7) % count]) == NULL;
+	}
+	hashed = Elapsed(start);
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < NUM_LOOKUPS; i += 1)
+	{
+		misses += LinearFetch(arr, keys[(i * 7) % count]) == NULL;
+	}
+	linear = Elapsed(start);
+
+	SDL_Log(
+		"PackedStateArray, %5d entries: %8.2f ns/fetch (linear: %10.2f)%s",
+		count,
+		hashed * 1e9 / NUM_LOOKUPS,
+		linear * 1e9 / NUM_LOOKUPS,
+		misses ? " MISSES!" : ""
+	);
+
+	/* Churn through twice as many states with a capped cache */
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < count * 2; i += 1)
+	{
+		PackedState key = GetPackedSamplerState(MakeSamplerState(count + i));
+		PackedStateArray_Evict(&arr, NULL, 0);
+		PackedStateArray_Insert(&arr, key, (void*) (size_t) (i + 1));
+		if (PackedStateArray_Fetch(arr, key) == NULL)
+		{
+			misses += 1;
+		}
+	}
+	SDL_Log(
+		"PackedStateArray, %5d entries: %8.2f ns/evict+insert%s",
+		count,
+		Elapsed(start) * 1e9 / (count * 2),
+		misses ? " MISSES!" : ""
+	);
+
+	PackedStateArray_Free(&arr);
+	SDL_free(keys);
+}
+
+static void BenchVertexBindings(int32_t count)
+{
+	PackedVertexBufferBindingsArray arr;
+	FNA3D_VertexElement elements[3];
+	FNA3D_VertexBufferBinding binding;
+	Uint64 start;
+	void* shader;
+	int32_t i, index, misses = 0;
+	uint32_t hash;
+
+	/* Position, color, texcoord, like SpriteBatch */
+	for (i = 0; i < 3; i += 1)
+	{
+		elements[i].offset = i * 12;
+		elements[i].usageIndex = 0;
+	}
+	elements[0].vertexElementFormat = FNA3D_VERTEXELEMENTFORMAT_VECTOR3;
+	elements[0].vertexElementUsage = FNA3D_VERTEXELEMENTUSAGE_POSITION;
+	elements[1].vertexElementFormat = FNA3D_VERTEXELEMENTFORMAT_COLOR;
+	elements[1].vertexElementUsage = FNA3D_VERTEXELEMENTUSAGE_COLOR;
+	elements[2].vertexElementFormat = FNA3D_VERTEXELEMENTFORMAT_VECTOR2;
+	elements[2].vertexElementUsage = FNA3D_VERTEXELEMENTUSAGE_TEXTURECOORDINATE;
+	binding.vertexBuffer = NULL;
+	binding.vertexDeclaration.vertexStride = 24;
+	binding.vertexDeclaration.elementCount = 3;
+	binding.vertexDeclaration.elements = elements;
+	binding.vertexOffset = 0;
+	binding.instanceFrequency = 0;
+
+	/* Same layout with a different shader each time */
+	SDL_zero(arr);
+	for (i = 0; i < count; i += 1)
+	{
+		shader = (void*) (size_t) ((i + 1) * 64);
+		PackedVertexBufferBindingsArray_Insert(
+			&arr,
+			&binding,
+			1,
+			shader,
+			shader
+		);
+	}
+
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < NUM_LOOKUPS; i += 1)
+	{
+		shader = (void*) (size_t) ((((i * 7) % count) + 1) * 64);
+		if (PackedVertexBufferBindingsArray_Fetch(
+			arr,
+			&binding,
+			1,
+			shader,
+			&index,
+			&hash
+		) != shader || arr.elements[index].value != shader)
+		{
+			misses += 1;
+		}
+	}
+
+	SDL_Log(
+		"PackedVertexBufferBindingsArray, %5d entries: %8.2f ns/fetch%s",
+		count,
+		Elapsed(start) * 1e9 / NUM_LOOKUPS,
+		misses ? " MISSES!" : ""
+	);
+
+	PackedVertexBufferBindingsArray_Free(&arr);
+}
+
+int main(int argc, char **argv)
+{
+	int32_t i;
+
+	for (i = 0; i < (int32_t) SDL_arraysize(cacheSizes); i += 1)
+	{
+		BenchStates(cacheSizes[i]);
+		BenchVertexBindings(cacheSizes[i]);
+	}
+	return 0;
+}
+
+/* vim: set noexpandtab shiftwidth=8 tabstop=8: */
@@ -1431,6 +1431,63 @@ FNA3DAPI void FNA3D_EndPassRestore(
 	FNA3D_Effect *effect
 );
 
+/* Describes a draw that FNA3D_PrecompilePipelinesEXT should get ready for.
+ *
+ * effect:		The Effect to be applied.
+ * technique:		The technique to use, or NULL for the current one.
+ * pass:		The technique's pass index.
+ * vertexBindings:	The bindings that ApplyVertexBufferBindings will get.
+ *			vertexBuffer and vertexOffset are ignored.
+ * numVertexBindings:	The number of elements in vertexBindings.
+ * blendState:		The state passed to SetBlendState.
+ * depthStencilState:	The state passed to SetDepthStencilState.
+ * rasterizerState:	The state passed to ApplyRasterizerState.
+ * primitiveType:	The primitive type of the draw call.
+ * colorFormats:	The formats of the bound render targets.
+ * numColorFormats:	The number of render targets, or 0 for the backbuffer.
+ * depthFormat:		The format of the depth-stencil buffer, if any.
+ * multiSampleCount:	The sample count of the render targets.
+ *
+ * depthFormat and multiSampleCount are ignored for the backbuffer.
+ */
+typedef struct FNA3D_PrecompileInfoEXT
+{
+	FNA3D_Effect *effect;
+	MOJOSHADER_effectTechnique *technique;
+	uint32_t pass;
+	FNA3D_VertexBufferBinding *vertexBindings;
+	int32_t numVertexBindings;
+	FNA3D_BlendState blendState;
+	FNA3D_DepthStencilState depthStencilState;
+	FNA3D_RasterizerState rasterizerState;
+	FNA3D_PrimitiveType primitiveType;
+	FNA3D_SurfaceFormat *colorFormats;
+	int32_t numColorFormats;
+	FNA3D_DepthFormat depthFormat;
+	int32_t multiSampleCount;
+} FNA3D_PrecompileInfoEXT;
+
+/* Compiles the shader programs and pipelines for a list of draws ahead of
+ * time, such as during a loading screen, so that the first real draw doesn't
+ * have to. Passes that pick their shaders with a preshader are skipped.
+ *
+ * Depending on the renderer this may return before the work is finished, use
+ * FNA3D_GetPendingPipelinesEXT to check on its progress.
+ *
+ * infos:	The draws to precompile.
+ * numInfos:	The number of elements in infos.
+ */
+FNA3DAPI void FNA3D_PrecompilePipelinesEXT(
+	FNA3D_Device *device,
+	FNA3D_PrecompileInfoEXT *infos,
+	int32_t numInfos
+);
+
+/* Returns the number of pipelines that are still being compiled, either from
+ * FNA3D_PrecompilePipelinesEXT or by asynchronous pipeline compilation.
+ */
+FNA3DAPI int32_t FNA3D_GetPendingPipelinesEXT(FNA3D_Device *device);
+
 /* Queries */
 
 /* Creates an object used to run occlusion queries.
@@ -1538,6 +1595,41 @@ FNA3DAPI void FNA3D_SetStringMarker(FNA3D_Device *device, const char *text);
  */
 FNA3DAPI void FNA3D_SetTextureName(FNA3D_Device *device, FNA3D_Texture *texture, const char *text);
 
+/* State Filtering */
+
+/* If the FNA3D_STATE_FILTER hint is set to "1", FNA3D skips SetBlendState,
+ * VerifySampler and ApplyVertexBufferBindings calls that would not change
+ * anything, before they reach the renderer. Resources may still be created,
+ * updated and disposed from other threads while this is on; nothing is skipped
+ * while one of those calls is running.
+ *
+ * If the FNA3D_MERGE_DRAWS hint is set to "1", DrawIndexedPrimitives calls are
+ * also held back for a moment, so that a following call that continues the
+ * same index range with the same buffers and state can be merged into it. Only
+ * list primitive types are merged. The held draw is submitted before any other
+ * call on the same thread, so this is only safe if buffers and textures used by
+ * the last draw are never updated or disposed from other threads.
+ *
+ * Both hints are read by FNA3D_CreateDevice.
+ */
+typedef struct FNA3D_StateFilterStatsEXT
+{
+	uint64_t blendStatesFiltered;
+	uint64_t samplersFiltered;
+	uint64_t vertexBufferBindingsFiltered;
+	uint64_t drawsMerged;
+} FNA3D_StateFilterStatsEXT;
+
+/* Gets the number of calls that were filtered out since the device was
+ * created.
+ *
+ * stats: Filled with the current counts.
+ */
+FNA3DAPI void FNA3D_GetStateFilterStatsEXT(
+	FNA3D_Device *device,
+	FNA3D_StateFilterStatsEXT *stats
+);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
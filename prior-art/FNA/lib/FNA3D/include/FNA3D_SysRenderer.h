@@ -48,6 +48,7 @@ typedef enum FNA3D_SysRendererTypeEXT
 	FNA3D_RENDERER_TYPE_D3D11_EXT,
 	FNA3D_RENDERER_TYPE_METAL_EXT, /* REMOVED, DO NOT USE */
 	FNA3D_RENDERER_TYPE_SDL_GPU_EXT,
+	FNA3D_RENDERER_TYPE_NULL_EXT,
 } FNA3D_SysRendererTypeEXT;
 
 typedef struct FNA3D_SysRendererEXT
@@ -31,6 +31,10 @@
 #include <SDL3/SDL.h>
 #else
 #include <SDL.h>
+static inline SDL_threadID SDL_GetCurrentThreadID()
+{
+	return SDL_ThreadID();
+}
 #endif
 
 #if !SDL_VERSION_ATLEAST(2, 26, 0)
@@ -48,6 +52,9 @@ static const FNA3D_Driver *drivers[] = {
 #endif
 #if FNA3D_DRIVER_OPENGL
 	&OpenGLDriver,
+#endif
+#if FNA3D_DRIVER_NULL
+	&NullDriver,
 #endif
 	NULL
 };
@@ -217,12 +224,355 @@ FNA3DAPI void FNA3D_GetDrawableSize(void* window, int32_t *w, int32_t *h)
 	SDL_GetWindowSizeInPixels((SDL_Window*) window, w, h);
 }
 
+/* State Filtering */
+
+#define FILTER_BLENDSTATE	0x01
+#define FILTER_SAMPLERS		0x02
+#define FILTER_VERTEXBINDINGS	0x04
+#define FILTER_ALL		0xFF
+
+/* Resource creation, uploads and disposal can be called from any thread, so
+ * the filter is only touched with filter->lock held. The lock only exists if
+ * the filter or draw merging is enabled, otherwise none of this costs anything.
+ */
+
+static void FNA3D_INTERNAL_InitStateFilter(FNA3D_Device *device)
+{
+	FNA3D_StateFilter *filter = &device->stateFilter;
+
+	SDL_zerop(filter);
+	filter->enabled = SDL_GetHintBoolean("FNA3D_STATE_FILTER", 0);
+	filter->mergeDraws = SDL_GetHintBoolean("FNA3D_MERGE_DRAWS", 0);
+	if (filter->enabled || filter->mergeDraws)
+	{
+		filter->lock = SDL_CreateMutex();
+	}
+}
+
+static void FNA3D_INTERNAL_QuitStateFilter(FNA3D_Device *device)
+{
+	if (device->stateFilter.lock != NULL)
+	{
+		SDL_DestroyMutex(device->stateFilter.lock);
+	}
+}
+
+/* Needs filter->lock */
+static void FNA3D_INTERNAL_ResetStateFilter(
+	FNA3D_StateFilter *filter,
+	uint8_t flags
+) {
+	if (flags & FILTER_BLENDSTATE)
+	{
+		filter->blendStateValid = 0;
+	}
+	if (flags & FILTER_SAMPLERS)
+	{
+		SDL_zero(filter->samplerValid);
+	}
+	if (flags & FILTER_VERTEXBINDINGS)
+	{
+		filter->vertexBindingsValid = 0;
+	}
+}
+
+/* Call this after anything that may have changed the driver's state behind
+ * the filter's back, or freed something the filter points to.
+ */
+static void FNA3D_INTERNAL_InvalidateState(
+	FNA3D_Device *device,
+	uint8_t flags
+) {
+	FNA3D_StateFilter *filter = &device->stateFilter;
+
+	if (!filter->enabled)
+	{
+		return;
+	}
+
+	SDL_LockMutex(filter->lock);
+	FNA3D_INTERNAL_ResetStateFilter(filter, flags);
+	SDL_UnlockMutex(filter->lock);
+}
+
+/* Resource calls may change the driver's state behind the filter's back while
+ * another thread is drawing, so nothing gets filtered until they return. Wrap
+ * the driver call with these instead of calling InvalidateState afterward.
+ */
+static void FNA3D_INTERNAL_BeginResourceCall(FNA3D_Device *device)
+{
+	FNA3D_StateFilter *filter = &device->stateFilter;
+
+	if (!filter->enabled)
+	{
+		return;
+	}
+
+	SDL_LockMutex(filter->lock);
+	filter->resourceCalls += 1;
+	SDL_UnlockMutex(filter->lock);
+}
+
+static void FNA3D_INTERNAL_EndResourceCall(
+	FNA3D_Device *device,
+	uint8_t flags
+) {
+	FNA3D_StateFilter *filter = &device->stateFilter;
+
+	if (!filter->enabled)
+	{
+		return;
+	}
+
+	SDL_LockMutex(filter->lock);
+	filter->resourceCalls -= 1;
+	FNA3D_INTERNAL_ResetStateFilter(filter, flags);
+	SDL_UnlockMutex(filter->lock);
+}
+
+/* Call this before passing anything else to the driver */
+static void FNA3D_INTERNAL_SubmitPendingDraw(FNA3D_Device *device)
+{
+	FNA3D_StateFilter *filter = &device->stateFilter;
+	FNA3D_PendingDraw draw;
+
+	if (!filter->mergeDraws)
+	{
+		return;
+	}
+
+	/* Calls from other threads aren't ordered against our draws anyway */
+	SDL_LockMutex(filter->lock);
+	if (	!filter->drawPending ||
+		filter->drawThread != (uint64_t) SDL_GetCurrentThreadID()	)
+	{
+		SDL_UnlockMutex(filter->lock);
+		return;
+	}
+	filter->drawPending = 0;
+	draw = filter->pendingDraw;
+	SDL_UnlockMutex(filter->lock);
+
+	device->DrawIndexedPrimitives(
+		device->driverData,
+		draw.primitiveType,
+		draw.baseVertex,
+		draw.minVertexIndex,
+		draw.numVertices,
+		draw.startIndex,
+		draw.primitiveCount,
+		draw.indices,
+		draw.indexElementSize
+	);
+}
+
+static void FNA3D_INTERNAL_QueueDraw(
+	FNA3D_Device *device,
+	FNA3D_PrimitiveType primitiveType,
+	int32_t baseVertex,
+	int32_t minVertexIndex,
+	int32_t numVertices,
+	int32_t startIndex,
+	int32_t primitiveCount,
+	FNA3D_Buffer *indices,
+	FNA3D_IndexElementSize indexElementSize
+) {
+	FNA3D_StateFilter *filter = &device->stateFilter;
+	FNA3D_PendingDraw *draw = &filter->pendingDraw;
+	FNA3D_PendingDraw held;
+	uint64_t thread = (uint64_t) SDL_GetCurrentThreadID();
+	uint8_t submitHeld = 0, queued = 0;
+	int32_t end;
+
+	SDL_LockMutex(filter->lock);
+
+	/* Strips can't be joined, but lists that pick up where the last draw
+	 * left off can just become one bigger draw.
+	 */
+	if (	filter->drawPending &&
+		filter->drawThread == thread &&
+		primitiveType != FNA3D_PRIMITIVETYPE_TRIANGLESTRIP &&
+		primitiveType != FNA3D_PRIMITIVETYPE_LINESTRIP &&
+		draw->primitiveType == primitiveType &&
+		draw->indices == indices &&
+		draw->indexElementSize == indexElementSize &&
+		draw->baseVertex == baseVertex &&
+		draw->startIndex + PrimitiveVerts(
+			primitiveType,
+			draw->primitiveCount
+		) == startIndex	)
+	{
+		end = SDL_max(
+			draw->minVertexIndex + draw->numVertices,
+			minVertexIndex + numVertices
+		);
+		draw->minVertexIndex = SDL_min(
+			draw->minVertexIndex,
+			minVertexIndex
+		);
+		draw->numVertices = end - draw->minVertexIndex;
+		draw->primitiveCount += primitiveCount;
+		filter->stats.drawsMerged += 1;
+		SDL_UnlockMutex(filter->lock);
+		return;
+	}
+
+	/* Our own held draw goes first. If another thread is holding one,
+	 * don't bother merging this.
+	 */
+	if (filter->drawPending && filter->drawThread == thread)
+	{
+		held = *draw;
+		submitHeld = 1;
+		filter->drawPending = 0;
+	}
+	if (!filter->drawPending)
+	{
+		filter->drawPending = 1;
+		filter->drawThread = thread;
+		draw->primitiveType = primitiveType;
+		draw->baseVertex = baseVertex;
+		draw->minVertexIndex = minVertexIndex;
+		draw->numVertices = numVertices;
+		draw->startIndex = startIndex;
+		draw->primitiveCount = primitiveCount;
+		draw->indices = indices;
+		draw->indexElementSize = indexElementSize;
+		queued = 1;
+	}
+	SDL_UnlockMutex(filter->lock);
+
+	if (submitHeld)
+	{
+		device->DrawIndexedPrimitives(
+			device->driverData,
+			held.primitiveType,
+			held.baseVertex,
+			held.minVertexIndex,
+			held.numVertices,
+			held.startIndex,
+			held.primitiveCount,
+			held.indices,
+			held.indexElementSize
+		);
+	}
+	if (!queued)
+	{
+		device->DrawIndexedPrimitives(
+			device->driverData,
+			primitiveType,
+			baseVertex,
+			minVertexIndex,
+			numVertices,
+			startIndex,
+			primitiveCount,
+			indices,
+			indexElementSize
+		);
+	}
+}
+
+/* Needs filter->lock */
+static uint8_t FNA3D_INTERNAL_FilterVertexBufferBindings(
+	FNA3D_StateFilter *filter,
+	FNA3D_VertexBufferBinding *bindings,
+	int32_t numBindings,
+	int32_t baseVertex
+) {
+	FNA3D_VertexBufferBinding *src, *dst;
+	int32_t i, numElements = 0;
+
+	if (	filter->resourceCalls == 0 &&
+		filter->vertexBindingsValid &&
+		filter->numVertexBindings == numBindings &&
+		filter->baseVertex == baseVertex	)
+	{
+		for (i = 0; i < numBindings; i += 1)
+		{
+			src = &bindings[i];
+			dst = &filter->vertexBindings[i];
+			if (	src->vertexBuffer != dst->vertexBuffer ||
+				src->vertexOffset != dst->vertexOffset ||
+				src->instanceFrequency != dst->instanceFrequency ||
+				src->vertexDeclaration.vertexStride != dst->vertexDeclaration.vertexStride ||
+				src->vertexDeclaration.elementCount != dst->vertexDeclaration.elementCount ||
+				SDL_memcmp(
+					src->vertexDeclaration.elements,
+					dst->vertexDeclaration.elements,
+					sizeof(FNA3D_VertexElement) * src->vertexDeclaration.elementCount
+				) != 0	)
+			{
+				break;
+			}
+		}
+		if (i == numBindings)
+		{
+			return 1;
+		}
+	}
+
+	/* Remember these for next time, if they fit */
+	filter->vertexBindingsValid = 0;
+	if (numBindings > MAX_BOUND_VERTEX_BUFFERS)
+	{
+		return 0;
+	}
+	for (i = 0; i < numBindings; i += 1)
+	{
+		numElements += bindings[i].vertexDeclaration.elementCount;
+	}
+	if (numElements > MAX_VERTEX_ATTRIBUTES)
+	{
+		return 0;
+	}
+
+	numElements = 0;
+	for (i = 0; i < numBindings; i += 1)
+	{
+		dst = &filter->vertexBindings[i];
+		*dst = bindings[i];
+		dst->vertexDeclaration.elements = &filter->vertexElements[numElements];
+		SDL_memcpy(
+			dst->vertexDeclaration.elements,
+			bindings[i].vertexDeclaration.elements,
+			sizeof(FNA3D_VertexElement) * bindings[i].vertexDeclaration.elementCount
+		);
+		numElements += bindings[i].vertexDeclaration.elementCount;
+	}
+	filter->numVertexBindings = numBindings;
+	filter->baseVertex = baseVertex;
+	filter->vertexBindingsValid = 1;
+	return 0;
+}
+
+void FNA3D_GetStateFilterStatsEXT(
+	FNA3D_Device *device,
+	FNA3D_StateFilterStatsEXT *stats
+) {
+	if (device == NULL || stats == NULL)
+	{
+		return;
+	}
+	if (device->stateFilter.lock != NULL)
+	{
+		SDL_LockMutex(device->stateFilter.lock);
+		*stats = device->stateFilter.stats;
+		SDL_UnlockMutex(device->stateFilter.lock);
+	}
+	else
+	{
+		*stats = device->stateFilter.stats;
+	}
+}
+
 /* Init/Quit */
 
 FNA3D_Device* FNA3D_CreateDevice(
 	FNA3D_PresentationParameters *presentationParameters,
 	uint8_t debugMode
 ) {
+	FNA3D_Device *result;
+
 	TRACE_CREATEDEVICE
 	if (selectedDriver < 0)
 	{
@@ -230,10 +580,15 @@ FNA3D_Device* FNA3D_CreateDevice(
 		return NULL;
 	}
 
-	return drivers[selectedDriver]->CreateDevice(
+	result = drivers[selectedDriver]->CreateDevice(
 		presentationParameters,
 		debugMode
 	);
+	if (result != NULL)
+	{
+		FNA3D_INTERNAL_InitStateFilter(result);
+	}
+	return result;
 }
 
 void FNA3D_DestroyDevice(FNA3D_Device *device)
@@ -244,6 +599,7 @@ void FNA3D_DestroyDevice(FNA3D_Device *device)
 		return;
 	}
 
+	FNA3D_INTERNAL_QuitStateFilter(device);
 	device->DestroyDevice(device);
 }
 
@@ -260,12 +616,14 @@ void FNA3D_SwapBuffers(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->SwapBuffers(
 		device->driverData,
 		sourceRectangle,
 		destinationRectangle,
 		overrideWindowHandle
 	);
+	FNA3D_INTERNAL_InvalidateState(device, FILTER_ALL);
 }
 
 /* Drawing */
@@ -282,6 +640,7 @@ void FNA3D_Clear(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->Clear(device->driverData, options, color, depth, stencil);
 }
 
@@ -301,6 +660,21 @@ void FNA3D_DrawIndexedPrimitives(
 	{
 		return;
 	}
+	if (device->stateFilter.mergeDraws)
+	{
+		FNA3D_INTERNAL_QueueDraw(
+			device,
+			primitiveType,
+			baseVertex,
+			minVertexIndex,
+			numVertices,
+			startIndex,
+			primitiveCount,
+			indices,
+			indexElementSize
+		);
+		return;
+	}
 	device->DrawIndexedPrimitives(
 		device->driverData,
 		primitiveType,
@@ -331,6 +705,7 @@ void FNA3D_DrawInstancedPrimitives(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->DrawInstancedPrimitives(
 		device->driverData,
 		primitiveType,
@@ -356,6 +731,7 @@ void FNA3D_DrawPrimitives(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->DrawPrimitives(
 		device->driverData,
 		primitiveType,
@@ -373,7 +749,9 @@ void FNA3D_SetViewport(FNA3D_Device *device, FNA3D_Viewport *viewport)
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->SetViewport(device->driverData, viewport);
+	FNA3D_INTERNAL_InvalidateState(device, FILTER_VERTEXBINDINGS);
 }
 
 void FNA3D_SetScissorRect(FNA3D_Device *device, FNA3D_Rect *scissor)
@@ -383,6 +761,7 @@ void FNA3D_SetScissorRect(FNA3D_Device *device, FNA3D_Rect *scissor)
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->SetScissorRect(device->driverData, scissor);
 }
 
@@ -407,7 +786,14 @@ void FNA3D_SetBlendFactor(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->SetBlendFactor(device->driverData, blendFactor);
+	if (device->stateFilter.enabled)
+	{
+		SDL_LockMutex(device->stateFilter.lock);
+		device->stateFilter.blendState.blendFactor = *blendFactor;
+		SDL_UnlockMutex(device->stateFilter.lock);
+	}
 }
 
 int32_t FNA3D_GetMultiSampleMask(FNA3D_Device *device)
@@ -427,7 +813,14 @@ void FNA3D_SetMultiSampleMask(FNA3D_Device *device, int32_t mask)
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->SetMultiSampleMask(device->driverData, mask);
+	if (device->stateFilter.enabled)
+	{
+		SDL_LockMutex(device->stateFilter.lock);
+		device->stateFilter.blendState.multiSampleMask = mask;
+		SDL_UnlockMutex(device->stateFilter.lock);
+	}
 }
 
 int32_t FNA3D_GetReferenceStencil(FNA3D_Device *device)
@@ -447,6 +840,7 @@ void FNA3D_SetReferenceStencil(FNA3D_Device *device, int32_t ref)
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->SetReferenceStencil(device->driverData, ref);
 }
 
@@ -456,11 +850,36 @@ void FNA3D_SetBlendState(
 	FNA3D_Device *device,
 	FNA3D_BlendState *blendState
 ) {
+	FNA3D_StateFilter *filter;
+
 	TRACE_SETBLENDSTATE
 	if (device == NULL)
 	{
 		return;
 	}
+
+	filter = &device->stateFilter;
+	if (filter->enabled)
+	{
+		SDL_LockMutex(filter->lock);
+		if (	filter->resourceCalls == 0 &&
+			filter->blendStateValid &&
+			SDL_memcmp(
+				&filter->blendState,
+				blendState,
+				sizeof(FNA3D_BlendState)
+			) == 0	)
+		{
+			filter->stats.blendStatesFiltered += 1;
+			SDL_UnlockMutex(filter->lock);
+			return;
+		}
+		filter->blendState = *blendState;
+		filter->blendStateValid = 1;
+		SDL_UnlockMutex(filter->lock);
+	}
+
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->SetBlendState(device->driverData, blendState);
 }
 
@@ -473,6 +892,7 @@ void FNA3D_SetDepthStencilState(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->SetDepthStencilState(device->driverData, depthStencilState);
 }
 
@@ -485,6 +905,7 @@ void FNA3D_ApplyRasterizerState(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->ApplyRasterizerState(device->driverData, rasterizerState);
 }
 
@@ -494,11 +915,46 @@ void FNA3D_VerifySampler(
 	FNA3D_Texture *texture,
 	FNA3D_SamplerState *sampler
 ) {
+	FNA3D_StateFilter *filter;
+
 	TRACE_VERIFYSAMPLER
 	if (device == NULL)
 	{
 		return;
 	}
+
+	filter = &device->stateFilter;
+	if (filter->enabled && index >= 0 && index < MAX_TEXTURE_SAMPLERS)
+	{
+		SDL_LockMutex(filter->lock);
+		if (	filter->resourceCalls == 0 &&
+			filter->samplerValid[index] &&
+			filter->textures[index] == texture &&
+			sampler != NULL &&
+			SDL_memcmp(
+				&filter->samplers[index],
+				sampler,
+				sizeof(FNA3D_SamplerState)
+			) == 0	)
+		{
+			filter->stats.samplersFiltered += 1;
+			SDL_UnlockMutex(filter->lock);
+			return;
+		}
+		if (sampler != NULL)
+		{
+			filter->textures[index] = texture;
+			filter->samplers[index] = *sampler;
+			filter->samplerValid[index] = 1;
+		}
+		else
+		{
+			filter->samplerValid[index] = 0;
+		}
+		SDL_UnlockMutex(filter->lock);
+	}
+
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->VerifySampler(device->driverData, index, texture, sampler);
 }
 
@@ -513,6 +969,7 @@ void FNA3D_VerifyVertexSampler(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->VerifyVertexSampler(device->driverData, index, texture, sampler);
 }
 
@@ -523,11 +980,33 @@ void FNA3D_ApplyVertexBufferBindings(
 	uint8_t bindingsUpdated,
 	int32_t baseVertex
 ) {
+	FNA3D_StateFilter *filter;
+
 	TRACE_APPLYVERTEXBUFFERBINDINGS
 	if (device == NULL)
 	{
 		return;
 	}
+
+	/* bindingsUpdated isn't compared, the contents are what matter */
+	filter = &device->stateFilter;
+	if (filter->enabled)
+	{
+		SDL_LockMutex(filter->lock);
+		if (FNA3D_INTERNAL_FilterVertexBufferBindings(
+			filter,
+			bindings,
+			numBindings,
+			baseVertex
+		)) {
+			filter->stats.vertexBufferBindingsFiltered += 1;
+			SDL_UnlockMutex(filter->lock);
+			return;
+		}
+		SDL_UnlockMutex(filter->lock);
+	}
+
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->ApplyVertexBufferBindings(
 		device->driverData,
 		bindings,
@@ -552,6 +1031,7 @@ void FNA3D_SetRenderTargets(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->SetRenderTargets(
 		device->driverData,
 		renderTargets,
@@ -560,6 +1040,7 @@ void FNA3D_SetRenderTargets(
 		depthFormat,
 		preserveTargetContents
 	);
+	FNA3D_INTERNAL_InvalidateState(device, FILTER_SAMPLERS | FILTER_VERTEXBINDINGS);
 }
 
 void FNA3D_ResolveTarget(
@@ -571,7 +1052,9 @@ void FNA3D_ResolveTarget(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->ResolveTarget(device->driverData, target);
+	FNA3D_INTERNAL_InvalidateState(device, FILTER_SAMPLERS);
 }
 
 /* Backbuffer Functions */
@@ -585,7 +1068,9 @@ void FNA3D_ResetBackbuffer(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->ResetBackbuffer(device->driverData, presentationParameters);
+	FNA3D_INTERNAL_InvalidateState(device, FILTER_ALL);
 }
 
 void FNA3D_ReadBackbuffer(
@@ -602,6 +1087,7 @@ void FNA3D_ReadBackbuffer(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->ReadBackbuffer(
 		device->driverData,
 		x,
@@ -611,6 +1097,7 @@ void FNA3D_ReadBackbuffer(
 		data,
 		dataLength
 	);
+	FNA3D_INTERNAL_InvalidateState(device, FILTER_SAMPLERS);
 }
 
 void FNA3D_GetBackbufferSize(
@@ -676,6 +1163,8 @@ FNA3D_Texture* FNA3D_CreateTexture2D(
 	{
 		return NULL;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
+	FNA3D_INTERNAL_BeginResourceCall(device);
 	result = device->CreateTexture2D(
 		device->driverData,
 		format,
@@ -684,6 +1173,7 @@ FNA3D_Texture* FNA3D_CreateTexture2D(
 		levelCount,
 		isRenderTarget
 	);
+	FNA3D_INTERNAL_EndResourceCall(device, FILTER_SAMPLERS);
 	TRACE_CREATETEXTURE2D
 	return result;
 }
@@ -704,6 +1194,8 @@ FNA3D_Texture* FNA3D_CreateTexture3D(
 	{
 		return NULL;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
+	FNA3D_INTERNAL_BeginResourceCall(device);
 	result = device->CreateTexture3D(
 		device->driverData,
 		format,
@@ -712,6 +1204,7 @@ FNA3D_Texture* FNA3D_CreateTexture3D(
 		depth,
 		levelCount
 	);
+	FNA3D_INTERNAL_EndResourceCall(device, FILTER_SAMPLERS);
 	TRACE_CREATETEXTURE3D
 	return result;
 }
@@ -731,6 +1224,8 @@ FNA3D_Texture* FNA3D_CreateTextureCube(
 	{
 		return NULL;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
+	FNA3D_INTERNAL_BeginResourceCall(device);
 	result = device->CreateTextureCube(
 		device->driverData,
 		format,
@@ -738,6 +1233,7 @@ FNA3D_Texture* FNA3D_CreateTextureCube(
 		levelCount,
 		isRenderTarget
 	);
+	FNA3D_INTERNAL_EndResourceCall(device, FILTER_SAMPLERS);
 	TRACE_CREATETEXTURECUBE
 	return result;
 }
@@ -751,7 +1247,10 @@ void FNA3D_AddDisposeTexture(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
+	FNA3D_INTERNAL_BeginResourceCall(device);
 	device->AddDisposeTexture(device->driverData, texture);
+	FNA3D_INTERNAL_EndResourceCall(device, FILTER_SAMPLERS);
 }
 
 void FNA3D_SetTextureData2D(
@@ -770,6 +1269,8 @@ void FNA3D_SetTextureData2D(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
+	FNA3D_INTERNAL_BeginResourceCall(device);
 	device->SetTextureData2D(
 		device->driverData,
 		texture,
@@ -781,6 +1282,7 @@ void FNA3D_SetTextureData2D(
 		data,
 		dataLength
 	);
+	FNA3D_INTERNAL_EndResourceCall(device, FILTER_SAMPLERS);
 }
 
 void FNA3D_SetTextureData3D(
@@ -801,6 +1303,8 @@ void FNA3D_SetTextureData3D(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
+	FNA3D_INTERNAL_BeginResourceCall(device);
 	device->SetTextureData3D(
 		device->driverData,
 		texture,
@@ -814,6 +1318,7 @@ void FNA3D_SetTextureData3D(
 		data,
 		dataLength
 	);
+	FNA3D_INTERNAL_EndResourceCall(device, FILTER_SAMPLERS);
 }
 
 void FNA3D_SetTextureDataCube(
@@ -833,6 +1338,8 @@ void FNA3D_SetTextureDataCube(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
+	FNA3D_INTERNAL_BeginResourceCall(device);
 	device->SetTextureDataCube(
 		device->driverData,
 		texture,
@@ -845,6 +1352,7 @@ void FNA3D_SetTextureDataCube(
 		data,
 		dataLength
 	);
+	FNA3D_INTERNAL_EndResourceCall(device, FILTER_SAMPLERS);
 }
 
 void FNA3D_SetTextureDataYUV(
@@ -864,6 +1372,8 @@ void FNA3D_SetTextureDataYUV(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
+	FNA3D_INTERNAL_BeginResourceCall(device);
 	device->SetTextureDataYUV(
 		device->driverData,
 		y,
@@ -876,6 +1386,7 @@ void FNA3D_SetTextureDataYUV(
 		data,
 		dataLength
 	);
+	FNA3D_INTERNAL_EndResourceCall(device, FILTER_SAMPLERS);
 }
 
 void FNA3D_GetTextureData2D(
@@ -894,6 +1405,8 @@ void FNA3D_GetTextureData2D(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
+	FNA3D_INTERNAL_BeginResourceCall(device);
 	device->GetTextureData2D(
 		device->driverData,
 		texture,
@@ -905,6 +1418,7 @@ void FNA3D_GetTextureData2D(
 		data,
 		dataLength
 	);
+	FNA3D_INTERNAL_EndResourceCall(device, FILTER_SAMPLERS);
 }
 
 void FNA3D_GetTextureData3D(
@@ -925,6 +1439,8 @@ void FNA3D_GetTextureData3D(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
+	FNA3D_INTERNAL_BeginResourceCall(device);
 	device->GetTextureData3D(
 		device->driverData,
 		texture,
@@ -938,6 +1454,7 @@ void FNA3D_GetTextureData3D(
 		data,
 		dataLength
 	);
+	FNA3D_INTERNAL_EndResourceCall(device, FILTER_SAMPLERS);
 }
 
 void FNA3D_GetTextureDataCube(
@@ -957,6 +1474,8 @@ void FNA3D_GetTextureDataCube(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
+	FNA3D_INTERNAL_BeginResourceCall(device);
 	device->GetTextureDataCube(
 		device->driverData,
 		texture,
@@ -969,6 +1488,7 @@ void FNA3D_GetTextureDataCube(
 		data,
 		dataLength
 	);
+	FNA3D_INTERNAL_EndResourceCall(device, FILTER_SAMPLERS);
 }
 
 /* Renderbuffers */
@@ -989,6 +1509,7 @@ FNA3D_Renderbuffer* FNA3D_GenColorRenderbuffer(
 	{
 		return NULL;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	result = device->GenColorRenderbuffer(
 		device->driverData,
 		width,
@@ -1016,6 +1537,7 @@ FNA3D_Renderbuffer* FNA3D_GenDepthStencilRenderbuffer(
 	{
 		return NULL;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	result = device->GenDepthStencilRenderbuffer(
 		device->driverData,
 		width,
@@ -1036,6 +1558,7 @@ void FNA3D_AddDisposeRenderbuffer(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->AddDisposeRenderbuffer(
 		device->driverData,
 		renderbuffer
@@ -1058,6 +1581,7 @@ FNA3D_Buffer* FNA3D_GenVertexBuffer(
 	{
 		return NULL;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	result = device->GenVertexBuffer(
 		device->driverData,
 		dynamic,
@@ -1077,7 +1601,10 @@ void FNA3D_AddDisposeVertexBuffer(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
+	FNA3D_INTERNAL_BeginResourceCall(device);
 	device->AddDisposeVertexBuffer(device->driverData, buffer);
+	FNA3D_INTERNAL_EndResourceCall(device, FILTER_VERTEXBINDINGS);
 }
 
 void FNA3D_SetVertexBufferData(
@@ -1095,6 +1622,7 @@ void FNA3D_SetVertexBufferData(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->SetVertexBufferData(
 		device->driverData,
 		buffer,
@@ -1121,6 +1649,7 @@ void FNA3D_GetVertexBufferData(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->GetVertexBufferData(
 		device->driverData,
 		buffer,
@@ -1148,6 +1677,7 @@ FNA3D_Buffer* FNA3D_GenIndexBuffer(
 	{
 		return NULL;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	result = device->GenIndexBuffer(
 		device->driverData,
 		dynamic,
@@ -1167,6 +1697,7 @@ void FNA3D_AddDisposeIndexBuffer(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->AddDisposeIndexBuffer(device->driverData, buffer);
 }
 
@@ -1183,6 +1714,7 @@ void FNA3D_SetIndexBufferData(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->SetIndexBufferData(
 		device->driverData,
 		buffer,
@@ -1205,6 +1737,7 @@ void FNA3D_GetIndexBufferData(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->GetIndexBufferData(
 		device->driverData,
 		buffer,
@@ -1232,6 +1765,7 @@ void FNA3D_CreateEffect(
 		*effectData = NULL;
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->CreateEffect(
 		device->driverData,
 		effectCode,
@@ -1257,6 +1791,7 @@ void FNA3D_CloneEffect(
 		*effectData = NULL;
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->CloneEffect(
 		device->driverData,
 		cloneSource,
@@ -1275,7 +1810,10 @@ void FNA3D_AddDisposeEffect(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
+	FNA3D_INTERNAL_BeginResourceCall(device);
 	device->AddDisposeEffect(device->driverData, effect);
+	FNA3D_INTERNAL_EndResourceCall(device, FILTER_SAMPLERS | FILTER_VERTEXBINDINGS);
 }
 
 void FNA3D_SetEffectTechnique(
@@ -1288,6 +1826,7 @@ void FNA3D_SetEffectTechnique(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->SetEffectTechnique(device->driverData, effect, technique);
 }
 
@@ -1302,12 +1841,14 @@ void FNA3D_ApplyEffect(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->ApplyEffect(
 		device->driverData,
 		effect,
 		pass,
 		stateChanges
 	);
+	FNA3D_INTERNAL_InvalidateState(device, FILTER_SAMPLERS | FILTER_VERTEXBINDINGS);
 }
 
 void FNA3D_BeginPassRestore(
@@ -1320,11 +1861,13 @@ void FNA3D_BeginPassRestore(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->BeginPassRestore(
 		device->driverData,
 		effect,
 		stateChanges
 	);
+	FNA3D_INTERNAL_InvalidateState(device, FILTER_SAMPLERS | FILTER_VERTEXBINDINGS);
 }
 
 void FNA3D_EndPassRestore(
@@ -1336,7 +1879,33 @@ void FNA3D_EndPassRestore(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->EndPassRestore(device->driverData, effect);
+	FNA3D_INTERNAL_InvalidateState(device, FILTER_SAMPLERS | FILTER_VERTEXBINDINGS);
+}
+
+void FNA3D_PrecompilePipelinesEXT(
+	FNA3D_Device *device,
+	FNA3D_PrecompileInfoEXT *infos,
+	int32_t numInfos
+) {
+	/* No need to trace this, it doesn't change what gets drawn */
+	if (device == NULL || infos == NULL || numInfos <= 0)
+	{
+		return;
+	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
+	device->PrecompilePipelines(device->driverData, infos, numInfos);
+	FNA3D_INTERNAL_InvalidateState(device, FILTER_SAMPLERS | FILTER_VERTEXBINDINGS);
+}
+
+int32_t FNA3D_GetPendingPipelinesEXT(FNA3D_Device *device)
+{
+	if (device == NULL)
+	{
+		return 0;
+	}
+	return device->GetPendingPipelines(device->driverData);
 }
 
 /* Queries */
@@ -1351,6 +1920,7 @@ FNA3D_Query* FNA3D_CreateQuery(FNA3D_Device *device)
 	{
 		return NULL;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	result = device->CreateQuery(device->driverData);
 	TRACE_CREATEQUERY
 	return result;
@@ -1363,6 +1933,7 @@ void FNA3D_AddDisposeQuery(FNA3D_Device *device, FNA3D_Query *query)
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->AddDisposeQuery(device->driverData, query);
 }
 
@@ -1373,6 +1944,7 @@ void FNA3D_QueryBegin(FNA3D_Device *device, FNA3D_Query *query)
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->QueryBegin(device->driverData, query);
 }
 
@@ -1383,6 +1955,7 @@ void FNA3D_QueryEnd(FNA3D_Device *device, FNA3D_Query *query)
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->QueryEnd(device->driverData, query);
 }
 
@@ -1405,6 +1978,7 @@ int32_t FNA3D_QueryPixelCount(
 	{
 		return 0;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	return device->QueryPixelCount(device->driverData, query);
 }
 
@@ -1514,6 +2088,7 @@ void FNA3D_SetStringMarker(FNA3D_Device *device, const char *text)
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->SetStringMarker(device->driverData, text);
 }
 
@@ -1527,6 +2102,7 @@ void FNA3D_SetTextureName(FNA3D_Device* device, FNA3D_Texture* texture, const ch
 
 	SDL_assert(text);
 
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->SetTextureName(device->driverData, texture, text);
 }
 /* External Interop */
@@ -1544,16 +2120,20 @@ void FNA3D_GetSysRendererEXT(
 	{
 		return;
 	}
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
 	device->GetSysRenderer(
 		device->driverData,
 		sysrenderer
 	);
+	FNA3D_INTERNAL_InvalidateState(device, FILTER_ALL);
 }
 
 FNA3D_Texture* FNA3D_CreateSysTextureEXT(
 	FNA3D_Device *device,
 	FNA3D_SysTextureEXT *systexture
 ) {
+	FNA3D_Texture *result;
+
 #ifdef FNA3D_TRACING
 	SDL_assert(0 && "Tracing does not support SysTextureEXT!");
 #endif
@@ -1563,10 +2143,14 @@ FNA3D_Texture* FNA3D_CreateSysTextureEXT(
 	{
 		return NULL;
 	}
-	return device->CreateSysTexture(
+	FNA3D_INTERNAL_SubmitPendingDraw(device);
+	FNA3D_INTERNAL_BeginResourceCall(device);
+	result = device->CreateSysTexture(
 		device->driverData,
 		systexture
 	);
+	FNA3D_INTERNAL_EndResourceCall(device, FILTER_SAMPLERS);
+	return result;
 }
 
 /* vim: set noexpandtab shiftwidth=8 tabstop=8: */
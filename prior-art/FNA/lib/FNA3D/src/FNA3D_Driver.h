@@ -288,6 +288,53 @@ static inline int32_t BytesPerImage(
 
 #define MAX_RENDERTARGET_BINDINGS	4
 
+/* State Filtering, this is only used by FNA3D.c */
+
+typedef struct FNA3D_PendingDraw
+{
+	FNA3D_PrimitiveType primitiveType;
+	int32_t baseVertex;
+	int32_t minVertexIndex;
+	int32_t numVertices;
+	int32_t startIndex;
+	int32_t primitiveCount;
+	FNA3D_Buffer *indices;
+	FNA3D_IndexElementSize indexElementSize;
+} FNA3D_PendingDraw;
+
+typedef struct FNA3D_StateFilter
+{
+	uint8_t enabled;
+	uint8_t mergeDraws;
+
+	/* SDL_Mutex, guards everything below. NULL if both are disabled. */
+	void *lock;
+
+	/* Resource calls that haven't returned yet, see BeginResourceCall */
+	int32_t resourceCalls;
+
+	/* The last values that were passed to the driver */
+	uint8_t blendStateValid;
+	FNA3D_BlendState blendState;
+
+	uint8_t samplerValid[MAX_TEXTURE_SAMPLERS];
+	FNA3D_Texture *textures[MAX_TEXTURE_SAMPLERS];
+	FNA3D_SamplerState samplers[MAX_TEXTURE_SAMPLERS];
+
+	uint8_t vertexBindingsValid;
+	int32_t numVertexBindings;
+	int32_t baseVertex;
+	FNA3D_VertexBufferBinding vertexBindings[MAX_BOUND_VERTEX_BUFFERS];
+	FNA3D_VertexElement vertexElements[MAX_VERTEX_ATTRIBUTES];
+
+	/* A draw that hasn't been passed to the driver yet */
+	uint8_t drawPending;
+	uint64_t drawThread;
+	FNA3D_PendingDraw pendingDraw;
+
+	FNA3D_StateFilterStatsEXT stats;
+} FNA3D_StateFilter;
+
 /* FNA3D_Device Definition */
 
 typedef struct FNA3D_Renderer FNA3D_Renderer;
@@ -682,6 +729,12 @@ struct FNA3D_Device
 		FNA3D_Renderer *driverData,
 		FNA3D_Effect *effect
 	);
+	void (*PrecompilePipelines)(
+		FNA3D_Renderer *driverData,
+		FNA3D_PrecompileInfoEXT *infos,
+		int32_t numInfos
+	);
+	int32_t (*GetPendingPipelines)(FNA3D_Renderer *driverData);
 
 	/* Queries */
 
@@ -734,6 +787,9 @@ struct FNA3D_Device
 
 	/* Opaque pointer for the Driver */
 	FNA3D_Renderer *driverData;
+
+	/* Set up by FNA3D_CreateDevice, drivers don't touch this */
+	FNA3D_StateFilter stateFilter;
 };
 
 #define ASSIGN_DRIVER_FUNC(func, name) \
@@ -796,6 +852,8 @@ struct FNA3D_Device
 	ASSIGN_DRIVER_FUNC(ApplyEffect, name) \
 	ASSIGN_DRIVER_FUNC(BeginPassRestore, name) \
 	ASSIGN_DRIVER_FUNC(EndPassRestore, name) \
+	ASSIGN_DRIVER_FUNC(PrecompilePipelines, name) \
+	ASSIGN_DRIVER_FUNC(GetPendingPipelines, name) \
 	ASSIGN_DRIVER_FUNC(CreateQuery, name) \
 	ASSIGN_DRIVER_FUNC(AddDisposeQuery, name) \
 	ASSIGN_DRIVER_FUNC(QueryBegin, name) \
@@ -828,6 +886,7 @@ typedef struct FNA3D_Driver
 FNA3D_SHAREDINTERNAL FNA3D_Driver D3D11Driver;
 FNA3D_SHAREDINTERNAL FNA3D_Driver OpenGLDriver;
 FNA3D_SHAREDINTERNAL FNA3D_Driver SDLGPUDriver;
+FNA3D_SHAREDINTERNAL FNA3D_Driver NullDriver;
 
 #endif /* FNA3D_DRIVER_H */
 
@@ -577,6 +577,31 @@ static uint8_t D3D11_INTERNAL_BlendEquals(
 
 /* Pipeline State Object Caching */
 
+/* D3D11 only allows 4096 unique objects of each state type per device, and
+ * the faux backbuffer needs one blend, rasterizer and sampler state too.
+ */
+#define MAX_CACHED_STATE_OBJECTS (D3D11_REQ_BLEND_OBJECT_COUNT_PER_DEVICE - 1)
+
+static void D3D11_INTERNAL_MakeRoomForState(
+	PackedStateArray *cache,
+	void* const *inUse,
+	int32_t numInUse
+) {
+	IUnknown *evicted;
+
+	if (cache->count < MAX_CACHED_STATE_OBJECTS)
+	{
+		return;
+	}
+
+	/* Drop the least recently used state, as long as it's not bound */
+	evicted = (IUnknown*) PackedStateArray_Evict(cache, inUse, numInUse);
+	if (evicted != NULL)
+	{
+		IUnknown_Release(evicted);
+	}
+}
+
 static ID3D11BlendState* D3D11_INTERNAL_FetchBlendState(
 	D3D11Renderer *renderer,
 	FNA3D_BlendState *state
@@ -649,6 +674,11 @@ static ID3D11BlendState* D3D11_INTERNAL_FetchBlendState(
 	);
 
 	/* Bake the state! */
+	D3D11_INTERNAL_MakeRoomForState(
+		&renderer->blendStateCache,
+		(void* const*) &renderer->blendState,
+		1
+	);
 	res = ID3D11Device_CreateBlendState(
 		renderer->device,
 		&desc,
@@ -735,6 +765,11 @@ static ID3D11DepthStencilState* D3D11_INTERNAL_FetchDepthStencilState(
 	desc.BackFace = back;
 
 	/* Bake the state! */
+	D3D11_INTERNAL_MakeRoomForState(
+		&renderer->depthStencilStateCache,
+		(void* const*) &renderer->depthStencilState,
+		1
+	);
 	res = ID3D11Device_CreateDepthStencilState(
 		renderer->device,
 		&desc,
@@ -790,6 +825,11 @@ static ID3D11RasterizerState* D3D11_INTERNAL_FetchRasterizerState(
 	desc.SlopeScaledDepthBias = state->slopeScaleDepthBias;
 
 	/* Bake the state! */
+	D3D11_INTERNAL_MakeRoomForState(
+		&renderer->rasterizerStateCache,
+		(void* const*) &renderer->rasterizerState,
+		1
+	);
 	res = ID3D11Device_CreateRasterizerState(
 		renderer->device,
 		&desc,
@@ -843,6 +883,11 @@ static ID3D11SamplerState* D3D11_INTERNAL_FetchSamplerState(
 	desc.MipLODBias = state->mipMapLevelOfDetailBias;
 
 	/* Bake the state! */
+	D3D11_INTERNAL_MakeRoomForState(
+		&renderer->samplerStateCache,
+		(void* const*) renderer->samplers,
+		MAX_TOTAL_SAMPLERS
+	);
 	res = ID3D11Device_CreateSamplerState(
 		renderer->device,
 		&desc,
@@ -1098,7 +1143,7 @@ static void D3D11_DestroyDevice(FNA3D_Device *device)
 			(ID3D11BlendState*) renderer->blendStateCache.elements[i].value
 		);
 	}
-	SDL_free(renderer->blendStateCache.elements);
+	PackedStateArray_Free(&renderer->blendStateCache);
 
 	/* Release depth stencil states */
 	for (i = 0; i < renderer->depthStencilStateCache.count; i += 1)
@@ -1107,7 +1152,7 @@ static void D3D11_DestroyDevice(FNA3D_Device *device)
 			(ID3D11DepthStencilState*) renderer->depthStencilStateCache.elements[i].value
 		);
 	}
-	SDL_free(renderer->depthStencilStateCache.elements);
+	PackedStateArray_Free(&renderer->depthStencilStateCache);
 
 	/* Release rasterizer states */
 	for (i = 0; i < renderer->rasterizerStateCache.count; i += 1)
@@ -1116,7 +1161,7 @@ static void D3D11_DestroyDevice(FNA3D_Device *device)
 			(ID3D11RasterizerState*) renderer->rasterizerStateCache.elements[i].value
 		);
 	}
-	SDL_free(renderer->rasterizerStateCache.elements);
+	PackedStateArray_Free(&renderer->rasterizerStateCache);
 
 	/* Release sampler states */
 	for (i = 0; i < renderer->samplerStateCache.count; i += 1)
@@ -1125,7 +1170,7 @@ static void D3D11_DestroyDevice(FNA3D_Device *device)
 			(ID3D11SamplerState*) renderer->samplerStateCache.elements[i].value
 		);
 	}
-	SDL_free(renderer->samplerStateCache.elements);
+	PackedStateArray_Free(&renderer->samplerStateCache);
 
 	/* Release input layouts */
 	for (i = 0; i < renderer->inputLayoutCache.count; i += 1)
@@ -1134,7 +1179,7 @@ static void D3D11_DestroyDevice(FNA3D_Device *device)
 			(ID3D11InputLayout*) renderer->inputLayoutCache.elements[i].value
 		);
 	}
-	SDL_free(renderer->inputLayoutCache.elements);
+	PackedVertexBufferBindingsArray_Free(&renderer->inputLayoutCache);
 
 	/* Release the annotation/iconv, if applicable */
 	if (renderer->annotation != NULL)
@@ -4665,11 +4710,12 @@ static void D3D11_INTERNAL_DeleteShader(const void *ctx, void* shader)
 	const MOJOSHADER_parseData *pd;
 	D3D11Renderer *renderer;
 	PackedVertexBufferBindingsArray *arr;
-	int32_t i;
+	int32_t i, oldCount;
 
 	pd = MOJOSHADER_d3d11GetShaderParseData(d3dShader);
 	renderer = (D3D11Renderer*) pd->malloc_data;
 	arr = &renderer->inputLayoutCache;
+	oldCount = arr->count;
 
 	/* Run through input layout cache in reverse order, to minimize the
 	 * damage of doing memmove a bunch of times
@@ -4691,6 +4737,12 @@ static void D3D11_INTERNAL_DeleteShader(const void *ctx, void* shader)
 		}
 	}
 
+	/* The remaining layouts moved, so the lookup table is stale */
+	if (arr->count != oldCount)
+	{
+		PackedVertexBufferBindingsArray_Rehash(arr);
+	}
+
 	MOJOSHADER_d3d11DeleteShader(renderer->shaderContext, d3dShader);
 }
 
@@ -4880,6 +4932,100 @@ static void D3D11_EndPassRestore(
 	SDL_UnlockMutex(renderer->ctxLock);
 }
 
+static void D3D11_PrecompilePipelines(
+	FNA3D_Renderer *driverData,
+	FNA3D_PrecompileInfoEXT *infos,
+	int32_t numInfos
+) {
+	D3D11Renderer *renderer = (D3D11Renderer*) driverData;
+	FNA3D_PrecompileInfoEXT *info;
+	MOJOSHADER_effect *effectData;
+	MOJOSHADER_d3d11Shader *oldVertexShader, *oldPixelShader;
+	FNA3D_DepthFormat oldDepthFormat;
+	int32_t vertexShaderIndex, pixelShaderIndex;
+	uint32_t hash;
+	int32_t i;
+
+	SDL_LockMutex(renderer->ctxLock);
+	MOJOSHADER_d3d11GetBoundShaders(
+		renderer->shaderContext,
+		&oldVertexShader,
+		&oldPixelShader
+	);
+	oldDepthFormat = renderer->currentDepthFormat;
+
+	for (i = 0; i < numInfos; i += 1)
+	{
+		info = &infos[i];
+
+		/* The depth bias scale depends on the depth format */
+		renderer->currentDepthFormat = (info->numColorFormats <= 0) ?
+			renderer->backbuffer->depthFormat :
+			info->depthFormat;
+		D3D11_INTERNAL_FetchBlendState(renderer, &info->blendState);
+		D3D11_INTERNAL_FetchDepthStencilState(
+			renderer,
+			&info->depthStencilState
+		);
+		D3D11_INTERNAL_FetchRasterizerState(
+			renderer,
+			&info->rasterizerState
+		);
+
+		effectData = ((D3D11Effect*) info->effect)->effect;
+		if (!GetEffectPassShaders(
+			effectData,
+			info->technique,
+			info->pass,
+			&vertexShaderIndex,
+			&pixelShaderIndex
+		)) {
+			continue;
+		}
+		MOJOSHADER_d3d11BindShaders(
+			renderer->shaderContext,
+			(MOJOSHADER_d3d11Shader*) effectData->objects[vertexShaderIndex].shader.shader,
+			(MOJOSHADER_d3d11Shader*) effectData->objects[pixelShaderIndex].shader.shader
+		);
+
+		/* This compiles the vertex shader for the input layout... */
+		if (D3D11_INTERNAL_FetchBindingsInputLayout(
+			renderer,
+			info->vertexBindings,
+			info->numVertexBindings,
+			&hash
+		) == NULL) {
+			continue;
+		}
+
+		/* ... and this compiles the pixel shader linked against it */
+		if (MOJOSHADER_d3d11ProgramReady(
+			renderer->shaderContext,
+			(unsigned long long) hash
+		) < 0) {
+			FNA3D_LogError(
+				"%s", MOJOSHADER_d3d11GetError(renderer->shaderContext)
+			);
+		}
+	}
+
+	/* ProgramReady bound the last program, so rebind on the next draw */
+	renderer->currentDepthFormat = oldDepthFormat;
+	MOJOSHADER_d3d11BindShaders(
+		renderer->shaderContext,
+		oldVertexShader,
+		oldPixelShader
+	);
+	renderer->effectApplied = 1;
+	SDL_UnlockMutex(renderer->ctxLock);
+}
+
+static int32_t D3D11_GetPendingPipelines(FNA3D_Renderer *driverData)
+{
+	/* Precompiling is synchronous, there's never anything pending */
+	return 0;
+}
+
 /* Queries */
 
 static FNA3D_Query* D3D11_CreateQuery(FNA3D_Renderer *driverData)
@@ -0,0 +1,2010 @@
+/* FNA3D - 3D Graphics Library for FNA
+ *
+ * Copyright (c) 2020-2024 Ethan Lee
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software in a
+ * product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ * Ethan "flibitijibibo" Lee <flibitijibibo@flibitijibibo.com>
+ *
+ */
+
+#if FNA3D_DRIVER_NULL
+
+#include "FNA3D_Driver.h"
+
+#ifdef USE_SDL3
+#include <SDL3/SDL.h>
+#else
+#include <SDL.h>
+#endif
+
+/* The Null driver does everything a real driver does on the CPU side (resource
+ * bookkeeping, argument validation, MojoShader effect/preshader work) but never
+ * talks to a GPU. It is never picked automatically; set FNA3D_FORCE_DRIVER=Null
+ * to use it, e.g. for measuring submission overhead on headless machines or for
+ * replaying traces without a display.
+ */
+
+/* MojoShader register file sizes, see mojoshader_sdlgpu.c */
+#define MAX_REG_FILE_F 8192
+#define MAX_REG_FILE_I 2047
+#define MAX_REG_FILE_B 2047
+
+/* Internal Structures */
+
+typedef enum NullTextureType
+{
+	NULL_TEXTURETYPE_2D,
+	NULL_TEXTURETYPE_3D,
+	NULL_TEXTURETYPE_CUBE
+} NullTextureType;
+
+typedef struct NullTexture /* Cast FNA3D_Texture* to this! */
+{
+	NullTextureType type;
+	FNA3D_SurfaceFormat format;
+	int32_t width;
+	int32_t height;
+	int32_t depth;
+	int32_t levelCount;
+	uint8_t isRenderTarget;
+
+	/* Allocated on first SetData, laid out as [face][level] */
+	uint8_t *data;
+	int32_t faceSize;
+} NullTexture;
+
+typedef struct NullRenderbuffer /* Cast FNA3D_Renderbuffer* to this! */
+{
+	int32_t width;
+	int32_t height;
+	uint8_t isDepthStencil;
+	FNA3D_SurfaceFormat colorFormat;
+	FNA3D_DepthFormat depthFormat;
+	int32_t multiSampleCount;
+} NullRenderbuffer;
+
+typedef struct NullBuffer /* Cast FNA3D_Buffer* to this! */
+{
+	uint8_t *data;
+	int32_t size;
+	uint8_t dynamic;
+	FNA3D_BufferUsage usage;
+} NullBuffer;
+
+typedef struct NullEffect /* Cast FNA3D_Effect* to this! */
+{
+	MOJOSHADER_effect *effect;
+} NullEffect;
+
+typedef struct NullQuery /* Cast FNA3D_Query* to this! */
+{
+	uint8_t active;
+} NullQuery;
+
+typedef struct NullShader
+{
+	const MOJOSHADER_parseData *parseData;
+	int32_t refcount;
+} NullShader;
+
+typedef struct NullRenderer /* Cast FNA3D_Renderer* to this! */
+{
+	/* Backbuffer */
+	int32_t backbufferWidth;
+	int32_t backbufferHeight;
+	FNA3D_SurfaceFormat backbufferFormat;
+	FNA3D_DepthFormat backbufferDepthFormat;
+	int32_t backbufferMultiSampleCount;
+
+	/* Mutable Render States */
+	FNA3D_Viewport viewport;
+	FNA3D_Rect scissorRect;
+	FNA3D_Color blendFactor;
+	int32_t multiSampleMask;
+	int32_t stencilRef;
+
+	/* Immutable Render States */
+	FNA3D_BlendState blendState;
+	FNA3D_DepthStencilState depthStencilState;
+	FNA3D_RasterizerState rasterizerState;
+	NullTexture *textures[MAX_TOTAL_SAMPLERS];
+	FNA3D_SamplerState samplers[MAX_TOTAL_SAMPLERS];
+
+	/* Vertex Buffer Bindings */
+	FNA3D_VertexBufferBinding vertexBuffers[MAX_BOUND_VERTEX_BUFFERS];
+	int32_t numVertexBindings;
+
+	/* Render Targets */
+	FNA3D_RenderTargetBinding renderTargets[MAX_RENDERTARGET_BINDINGS];
+	int32_t numRenderTargets;
+	NullRenderbuffer *depthStencilBuffer;
+	FNA3D_DepthFormat currentDepthFormat;
+
+	/* Effect State */
+	MOJOSHADER_effect *currentEffect;
+	const MOJOSHADER_effectTechnique *currentTechnique;
+	uint32_t currentPass;
+
+	/* Shader Backend */
+	const char *shaderProfile;
+	NullShader *boundVertexShader;
+	NullShader *boundPixelShader;
+	char shaderError[1024];
+	float vs_reg_file_f[MAX_REG_FILE_F * 4];
+	int32_t vs_reg_file_i[MAX_REG_FILE_I * 4];
+	uint8_t vs_reg_file_b[MAX_REG_FILE_B * 4];
+	float ps_reg_file_f[MAX_REG_FILE_F * 4];
+	int32_t ps_reg_file_i[MAX_REG_FILE_I * 4];
+	uint8_t ps_reg_file_b[MAX_REG_FILE_B * 4];
+
+	/* Statistics, logged when the device is destroyed */
+	uint64_t frameCount;
+	uint64_t drawCount;
+	uint64_t primitiveCount;
+	uint64_t clearCount;
+	uint64_t stateChangeCount;
+	uint64_t validationErrorCount;
+} NullRenderer;
+
+/* Validation */
+
+#define NULL_VALIDATE(renderer, cond, ...) \
+	if (!(cond)) \
+	{ \
+		FNA3D_LogError(__VA_ARGS__); \
+		renderer->validationErrorCount += 1; \
+		return; \
+	}
+
+/* Quit */
+
+static void NULLDRV_DestroyDevice(FNA3D_Device *device)
+{
+	NullRenderer *renderer = (NullRenderer*) device->driverData;
+
+	FNA3D_LogInfo(
+		"Null driver: %llu frames, %llu draws, %llu primitives, "
+		"%llu clears, %llu state changes, %llu validation errors",
+		(unsigned long long) renderer->frameCount,
+		(unsigned long long) renderer->drawCount,
+		(unsigned long long) renderer->primitiveCount,
+		(unsigned long long) renderer->clearCount,
+		(unsigned long long) renderer->stateChangeCount,
+		(unsigned long long) renderer->validationErrorCount
+	);
+
+	SDL_free(renderer);
+	SDL_free(device);
+}
+
+/* Presentation */
+
+static void NULLDRV_SwapBuffers(
+	FNA3D_Renderer *driverData,
+	FNA3D_Rect *sourceRectangle,
+	FNA3D_Rect *destinationRectangle,
+	void* overrideWindowHandle
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	renderer->frameCount += 1;
+}
+
+/* Drawing */
+
+static void NULLDRV_Clear(
+	FNA3D_Renderer *driverData,
+	FNA3D_ClearOptions options,
+	FNA3D_Vec4 *color,
+	float depth,
+	int32_t stencil
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	renderer->clearCount += 1;
+}
+
+static uint8_t NULLDRV_INTERNAL_ValidateVertexRange(
+	NullRenderer *renderer,
+	int32_t firstVertex,
+	int32_t numVertices
+) {
+	FNA3D_VertexBufferBinding *binding;
+	NullBuffer *buffer;
+	int64_t end;
+	int32_t i;
+
+	if (renderer->numVertexBindings <= 0)
+	{
+		FNA3D_LogError("Draw call with no vertex buffers bound!");
+		renderer->validationErrorCount += 1;
+		return 0;
+	}
+
+	for (i = 0; i < renderer->numVertexBindings; i += 1)
+	{
+		binding = &renderer->vertexBuffers[i];
+		buffer = (NullBuffer*) binding->vertexBuffer;
+		if (buffer == NULL)
+		{
+			FNA3D_LogError("Vertex buffer binding %d is NULL!", i);
+			renderer->validationErrorCount += 1;
+			return 0;
+		}
+
+		/* Instance data is indexed by instance, not by vertex */
+		if (binding->instanceFrequency > 0)
+		{
+			continue;
+		}
+
+		end = (
+			(int64_t) binding->vertexOffset +
+			firstVertex +
+			numVertices
+		) * binding->vertexDeclaration.vertexStride;
+		if (firstVertex + binding->vertexOffset < 0 || end > buffer->size)
+		{
+			FNA3D_LogError(
+				"Draw reads past the end of vertex buffer binding %d!",
+				i
+			);
+			renderer->validationErrorCount += 1;
+			return 0;
+		}
+	}
+	return 1;
+}
+
+static void NULLDRV_DrawIndexedPrimitives(
+	FNA3D_Renderer *driverData,
+	FNA3D_PrimitiveType primitiveType,
+	int32_t baseVertex,
+	int32_t minVertexIndex,
+	int32_t numVertices,
+	int32_t startIndex,
+	int32_t primitiveCount,
+	FNA3D_Buffer *indices,
+	FNA3D_IndexElementSize indexElementSize
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	NullBuffer *indexBuffer = (NullBuffer*) indices;
+	int64_t indexEnd;
+
+	NULL_VALIDATE(
+		renderer,
+		primitiveCount > 0,
+		"Invalid primitive count: %d",
+		primitiveCount
+	)
+	NULL_VALIDATE(
+		renderer,
+		indexBuffer != NULL,
+		"DrawIndexedPrimitives with no index buffer!"
+	)
+
+	indexEnd = (
+		(int64_t) startIndex +
+		PrimitiveVerts(primitiveType, primitiveCount)
+	) * IndexSize(indexElementSize);
+	NULL_VALIDATE(
+		renderer,
+		startIndex >= 0 && indexEnd <= indexBuffer->size,
+		"Draw reads past the end of the index buffer!"
+	)
+
+	if (!NULLDRV_INTERNAL_ValidateVertexRange(
+		renderer,
+		baseVertex + minVertexIndex,
+		numVertices
+	)) {
+		return;
+	}
+
+	renderer->drawCount += 1;
+	renderer->primitiveCount += primitiveCount;
+}
+
+static void NULLDRV_DrawInstancedPrimitives(
+	FNA3D_Renderer *driverData,
+	FNA3D_PrimitiveType primitiveType,
+	int32_t baseVertex,
+	int32_t minVertexIndex,
+	int32_t numVertices,
+	int32_t startIndex,
+	int32_t primitiveCount,
+	int32_t instanceCount,
+	FNA3D_Buffer *indices,
+	FNA3D_IndexElementSize indexElementSize
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	uint64_t drawCount;
+
+	NULL_VALIDATE(
+		renderer,
+		instanceCount > 0,
+		"Invalid instance count: %d",
+		instanceCount
+	)
+
+	drawCount = renderer->drawCount;
+	NULLDRV_DrawIndexedPrimitives(
+		driverData,
+		primitiveType,
+		baseVertex,
+		minVertexIndex,
+		numVertices,
+		startIndex,
+		primitiveCount,
+		indices,
+		indexElementSize
+	);
+	if (renderer->drawCount > drawCount)
+	{
+		renderer->primitiveCount += (uint64_t) primitiveCount * (instanceCount - 1);
+	}
+}
+
+static void NULLDRV_DrawPrimitives(
+	FNA3D_Renderer *driverData,
+	FNA3D_PrimitiveType primitiveType,
+	int32_t vertexStart,
+	int32_t primitiveCount
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+
+	NULL_VALIDATE(
+		renderer,
+		primitiveCount > 0,
+		"Invalid primitive count: %d",
+		primitiveCount
+	)
+
+	if (!NULLDRV_INTERNAL_ValidateVertexRange(
+		renderer,
+		vertexStart,
+		PrimitiveVerts(primitiveType, primitiveCount)
+	)) {
+		return;
+	}
+
+	renderer->drawCount += 1;
+	renderer->primitiveCount += primitiveCount;
+}
+
+/* Mutable Render States */
+
+static void NULLDRV_SetViewport(
+	FNA3D_Renderer *driverData,
+	FNA3D_Viewport *viewport
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	renderer->viewport = *viewport;
+	renderer->stateChangeCount += 1;
+}
+
+static void NULLDRV_SetScissorRect(
+	FNA3D_Renderer *driverData,
+	FNA3D_Rect *scissor
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	renderer->scissorRect = *scissor;
+	renderer->stateChangeCount += 1;
+}
+
+static void NULLDRV_GetBlendFactor(
+	FNA3D_Renderer *driverData,
+	FNA3D_Color *blendFactor
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	*blendFactor = renderer->blendFactor;
+}
+
+static void NULLDRV_SetBlendFactor(
+	FNA3D_Renderer *driverData,
+	FNA3D_Color *blendFactor
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	renderer->blendFactor = *blendFactor;
+	renderer->stateChangeCount += 1;
+}
+
+static int32_t NULLDRV_GetMultiSampleMask(FNA3D_Renderer *driverData)
+{
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	return renderer->multiSampleMask;
+}
+
+static void NULLDRV_SetMultiSampleMask(FNA3D_Renderer *driverData, int32_t mask)
+{
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	renderer->multiSampleMask = mask;
+	renderer->stateChangeCount += 1;
+}
+
+static int32_t NULLDRV_GetReferenceStencil(FNA3D_Renderer *driverData)
+{
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	return renderer->stencilRef;
+}
+
+static void NULLDRV_SetReferenceStencil(FNA3D_Renderer *driverData, int32_t ref)
+{
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	renderer->stencilRef = ref;
+	renderer->stateChangeCount += 1;
+}
+
+/* Immutable Render States */
+
+static void NULLDRV_SetBlendState(
+	FNA3D_Renderer *driverData,
+	FNA3D_BlendState *blendState
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	renderer->blendState = *blendState;
+	renderer->blendFactor = blendState->blendFactor;
+	renderer->multiSampleMask = blendState->multiSampleMask;
+	renderer->stateChangeCount += 1;
+}
+
+static void NULLDRV_SetDepthStencilState(
+	FNA3D_Renderer *driverData,
+	FNA3D_DepthStencilState *depthStencilState
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	renderer->depthStencilState = *depthStencilState;
+	renderer->stencilRef = depthStencilState->referenceStencil;
+	renderer->stateChangeCount += 1;
+}
+
+static void NULLDRV_ApplyRasterizerState(
+	FNA3D_Renderer *driverData,
+	FNA3D_RasterizerState *rasterizerState
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	renderer->rasterizerState = *rasterizerState;
+	renderer->stateChangeCount += 1;
+}
+
+static void NULLDRV_VerifySampler(
+	FNA3D_Renderer *driverData,
+	int32_t index,
+	FNA3D_Texture *texture,
+	FNA3D_SamplerState *sampler
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+
+	NULL_VALIDATE(
+		renderer,
+		index >= 0 && index < MAX_TEXTURE_SAMPLERS,
+		"Invalid sampler index: %d",
+		index
+	)
+
+	renderer->textures[index] = (NullTexture*) texture;
+	renderer->samplers[index] = *sampler;
+	renderer->stateChangeCount += 1;
+}
+
+static void NULLDRV_VerifyVertexSampler(
+	FNA3D_Renderer *driverData,
+	int32_t index,
+	FNA3D_Texture *texture,
+	FNA3D_SamplerState *sampler
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+
+	NULL_VALIDATE(
+		renderer,
+		index >= 0 && index < MAX_VERTEXTEXTURE_SAMPLERS,
+		"Invalid vertex sampler index: %d",
+		index
+	)
+
+	index += MAX_TEXTURE_SAMPLERS;
+	renderer->textures[index] = (NullTexture*) texture;
+	renderer->samplers[index] = *sampler;
+	renderer->stateChangeCount += 1;
+}
+
+static void NULLDRV_ApplyVertexBufferBindings(
+	FNA3D_Renderer *driverData,
+	FNA3D_VertexBufferBinding *bindings,
+	int32_t numBindings,
+	uint8_t bindingsUpdated,
+	int32_t baseVertex
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+
+	if (!bindingsUpdated)
+	{
+		return;
+	}
+
+	NULL_VALIDATE(
+		renderer,
+		numBindings >= 0 && numBindings <= MAX_BOUND_VERTEX_BUFFERS,
+		"Invalid vertex buffer binding count: %d",
+		numBindings
+	)
+
+	SDL_memcpy(
+		renderer->vertexBuffers,
+		bindings,
+		sizeof(FNA3D_VertexBufferBinding) * numBindings
+	);
+	renderer->numVertexBindings = numBindings;
+	renderer->stateChangeCount += 1;
+}
+
+/* Render Targets */
+
+static void NULLDRV_SetRenderTargets(
+	FNA3D_Renderer *driverData,
+	FNA3D_RenderTargetBinding *renderTargets,
+	int32_t numRenderTargets,
+	FNA3D_Renderbuffer *depthStencilBuffer,
+	FNA3D_DepthFormat depthFormat,
+	uint8_t preserveTargetContents
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	int32_t i;
+
+	NULL_VALIDATE(
+		renderer,
+		numRenderTargets <= MAX_RENDERTARGET_BINDINGS,
+		"Too many render targets: %d",
+		numRenderTargets
+	)
+
+	for (i = 0; i < numRenderTargets; i += 1)
+	{
+		NULL_VALIDATE(
+			renderer,
+			renderTargets[i].texture != NULL,
+			"Render target %d has no texture!",
+			i
+		)
+		NULL_VALIDATE(
+			renderer,
+			(	renderTargets[i].multiSampleCount <= 1 ||
+				renderTargets[i].colorBuffer != NULL	),
+			"Multisampled render target %d has no color buffer!",
+			i
+		)
+	}
+
+	if (numRenderTargets <= 0)
+	{
+		renderer->numRenderTargets = 0;
+		renderer->depthStencilBuffer = NULL;
+		renderer->currentDepthFormat = renderer->backbufferDepthFormat;
+	}
+	else
+	{
+		SDL_memcpy(
+			renderer->renderTargets,
+			renderTargets,
+			sizeof(FNA3D_RenderTargetBinding) * numRenderTargets
+		);
+		renderer->numRenderTargets = numRenderTargets;
+		renderer->depthStencilBuffer = (NullRenderbuffer*) depthStencilBuffer;
+		renderer->currentDepthFormat = depthFormat;
+	}
+	renderer->stateChangeCount += 1;
+}
+
+static void NULLDRV_ResolveTarget(
+	FNA3D_Renderer *driverData,
+	FNA3D_RenderTargetBinding *target
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+
+	NULL_VALIDATE(
+		renderer,
+		target != NULL && target->texture != NULL,
+		"ResolveTarget called with no texture!"
+	)
+}
+
+/* Backbuffer Functions */
+
+static void NULLDRV_INTERNAL_SetPresentationParameters(
+	NullRenderer *renderer,
+	FNA3D_PresentationParameters *presentationParameters
+) {
+	renderer->backbufferWidth = presentationParameters->backBufferWidth;
+	renderer->backbufferHeight = presentationParameters->backBufferHeight;
+	renderer->backbufferFormat = presentationParameters->backBufferFormat;
+	renderer->backbufferDepthFormat = presentationParameters->depthStencilFormat;
+	renderer->backbufferMultiSampleCount = SDL_min(
+		presentationParameters->multiSampleCount,
+		8
+	);
+}
+
+static void NULLDRV_ResetBackbuffer(
+	FNA3D_Renderer *driverData,
+	FNA3D_PresentationParameters *presentationParameters
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	NULLDRV_INTERNAL_SetPresentationParameters(
+		renderer,
+		presentationParameters
+	);
+}
+
+static void NULLDRV_ReadBackbuffer(
+	FNA3D_Renderer *driverData,
+	int32_t x,
+	int32_t y,
+	int32_t w,
+	int32_t h,
+	void* data,
+	int32_t dataLength
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+
+	NULL_VALIDATE(
+		renderer,
+		(	x >= 0 && y >= 0 && w >= 0 && h >= 0 &&
+			x + w <= renderer->backbufferWidth &&
+			y + h <= renderer->backbufferHeight	),
+		"ReadBackbuffer rectangle is out of bounds!"
+	)
+	NULL_VALIDATE(
+		renderer,
+		dataLength >= w * h * 4,
+		"ReadBackbuffer dataLength is too small!"
+	)
+
+	/* There is nothing to read, so the backbuffer is always black */
+	SDL_memset(data, '\0', w * h * 4);
+}
+
+static void NULLDRV_GetBackbufferSize(
+	FNA3D_Renderer *driverData,
+	int32_t *w,
+	int32_t *h
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	*w = renderer->backbufferWidth;
+	*h = renderer->backbufferHeight;
+}
+
+static FNA3D_SurfaceFormat NULLDRV_GetBackbufferSurfaceFormat(
+	FNA3D_Renderer *driverData
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	return renderer->backbufferFormat;
+}
+
+static FNA3D_DepthFormat NULLDRV_GetBackbufferDepthFormat(
+	FNA3D_Renderer *driverData
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	return renderer->backbufferDepthFormat;
+}
+
+static int32_t NULLDRV_GetBackbufferMultiSampleCount(
+	FNA3D_Renderer *driverData
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	return renderer->backbufferMultiSampleCount;
+}
+
+/* Textures */
+
+static int32_t NULLDRV_INTERNAL_LevelSize(
+	NullTexture *texture,
+	int32_t level
+) {
+	return BytesPerImage(
+		SDL_max(texture->width >> level, 1),
+		SDL_max(texture->height >> level, 1),
+		texture->format
+	) * SDL_max(texture->depth >> level, 1);
+}
+
+static FNA3D_Texture* NULLDRV_INTERNAL_CreateTexture(
+	NullRenderer *renderer,
+	NullTextureType type,
+	FNA3D_SurfaceFormat format,
+	int32_t width,
+	int32_t height,
+	int32_t depth,
+	int32_t levelCount,
+	uint8_t isRenderTarget
+) {
+	NullTexture *result;
+	int32_t i;
+
+	if (	width <= 0 ||
+		height <= 0 ||
+		depth <= 0 ||
+		levelCount <= 0 ||
+		Texture_GetFormatSize(format) == 0	)
+	{
+		FNA3D_LogError(
+			"Invalid texture: %dx%dx%d, %d levels, format %d",
+			width, height, depth, levelCount, format
+		);
+		renderer->validationErrorCount += 1;
+		return NULL;
+	}
+
+	result = (NullTexture*) SDL_malloc(sizeof(NullTexture));
+	result->type = type;
+	result->format = format;
+	result->width = width;
+	result->height = height;
+	result->depth = depth;
+	result->levelCount = levelCount;
+	result->isRenderTarget = isRenderTarget;
+	result->data = NULL;
+	result->faceSize = 0;
+	for (i = 0; i < levelCount; i += 1)
+	{
+		result->faceSize += NULLDRV_INTERNAL_LevelSize(result, i);
+	}
+	return (FNA3D_Texture*) result;
+}
+
+static FNA3D_Texture* NULLDRV_CreateTexture2D(
+	FNA3D_Renderer *driverData,
+	FNA3D_SurfaceFormat format,
+	int32_t width,
+	int32_t height,
+	int32_t levelCount,
+	uint8_t isRenderTarget
+) {
+	return NULLDRV_INTERNAL_CreateTexture(
+		(NullRenderer*) driverData,
+		NULL_TEXTURETYPE_2D,
+		format,
+		width,
+		height,
+		1,
+		levelCount,
+		isRenderTarget
+	);
+}
+
+static FNA3D_Texture* NULLDRV_CreateTexture3D(
+	FNA3D_Renderer *driverData,
+	FNA3D_SurfaceFormat format,
+	int32_t width,
+	int32_t height,
+	int32_t depth,
+	int32_t levelCount
+) {
+	return NULLDRV_INTERNAL_CreateTexture(
+		(NullRenderer*) driverData,
+		NULL_TEXTURETYPE_3D,
+		format,
+		width,
+		height,
+		depth,
+		levelCount,
+		0
+	);
+}
+
+static FNA3D_Texture* NULLDRV_CreateTextureCube(
+	FNA3D_Renderer *driverData,
+	FNA3D_SurfaceFormat format,
+	int32_t size,
+	int32_t levelCount,
+	uint8_t isRenderTarget
+) {
+	return NULLDRV_INTERNAL_CreateTexture(
+		(NullRenderer*) driverData,
+		NULL_TEXTURETYPE_CUBE,
+		format,
+		size,
+		size,
+		1,
+		levelCount,
+		isRenderTarget
+	);
+}
+
+static void NULLDRV_AddDisposeTexture(
+	FNA3D_Renderer *driverData,
+	FNA3D_Texture *texture
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	NullTexture *tex = (NullTexture*) texture;
+	int32_t i;
+
+	for (i = 0; i < MAX_TOTAL_SAMPLERS; i += 1)
+	{
+		if (renderer->textures[i] == tex)
+		{
+			renderer->textures[i] = NULL;
+		}
+	}
+
+	SDL_free(tex->data);
+	SDL_free(tex);
+}
+
+/* Copies a box between the caller and the texture's storage. Block-compressed
+ * formats are addressed in whole blocks, like the real drivers do.
+ */
+static void NULLDRV_INTERNAL_CopyTextureData(
+	NullRenderer *renderer,
+	NullTexture *texture,
+	NullTextureType type,
+	int32_t x,
+	int32_t y,
+	int32_t z,
+	int32_t w,
+	int32_t h,
+	int32_t d,
+	int32_t face,
+	int32_t level,
+	void* data,
+	int32_t dataLength,
+	uint8_t upload
+) {
+	int32_t levelWidth, levelHeight, levelDepth;
+	int32_t blockSize, formatSize, rowPitch, slicePitch;
+	int32_t rowLength, rows, i, j;
+	uint8_t *dst, *src, *base;
+
+	NULL_VALIDATE(
+		renderer,
+		texture != NULL && texture->type == type,
+		"Texture data call on a NULL or mismatched texture!"
+	)
+	NULL_VALIDATE(
+		renderer,
+		level >= 0 && level < texture->levelCount,
+		"Invalid texture level: %d",
+		level
+	)
+
+	blockSize = Texture_GetBlockSize(texture->format);
+	formatSize = Texture_GetFormatSize(texture->format);
+	levelWidth = SDL_max(texture->width >> level, 1);
+	levelHeight = SDL_max(texture->height >> level, 1);
+	levelDepth = SDL_max(texture->depth >> level, 1);
+
+	NULL_VALIDATE(
+		renderer,
+		(	x >= 0 && y >= 0 && z >= 0 &&
+			w > 0 && h > 0 && d > 0 &&
+			(x % blockSize) == 0 && (y % blockSize) == 0 &&
+			BytesPerRow(x + w, texture->format) <=
+				BytesPerRow(levelWidth, texture->format) &&
+			(y + h + blockSize - 1) / blockSize <=
+				(levelHeight + blockSize - 1) / blockSize &&
+			z + d <= levelDepth	),
+		"Texture data rectangle is out of bounds!"
+	)
+
+	rowLength = BytesPerRow(w, texture->format);
+	rows = (h + blockSize - 1) / blockSize;
+	NULL_VALIDATE(
+		renderer,
+		dataLength >= rowLength * rows * d,
+		"Texture dataLength is too small: %d < %d",
+		dataLength,
+		rowLength * rows * d
+	)
+
+	if (texture->data == NULL)
+	{
+		if (!upload)
+		{
+			/* Nothing was ever written, so it's all zeroes */
+			SDL_memset(data, '\0', rowLength * rows * d);
+			return;
+		}
+		texture->data = (uint8_t*) SDL_calloc(
+			(texture->type == NULL_TEXTURETYPE_CUBE) ? 6 : 1,
+			texture->faceSize
+		);
+	}
+
+	base = texture->data + (face * texture->faceSize);
+	for (i = 0; i < level; i += 1)
+	{
+		base += NULLDRV_INTERNAL_LevelSize(texture, i);
+	}
+
+	rowPitch = BytesPerRow(levelWidth, texture->format);
+	slicePitch = BytesPerImage(levelWidth, levelHeight, texture->format);
+	base += (
+		(z * slicePitch) +
+		((y / blockSize) * rowPitch) +
+		((x / blockSize) * formatSize)
+	);
+
+	for (i = 0; i < d; i += 1)
+	{
+		for (j = 0; j < rows; j += 1)
+		{
+			dst = base + (i * slicePitch) + (j * rowPitch);
+			src = (uint8_t*) data + (((i * rows) + j) * rowLength);
+			if (upload)
+			{
+				SDL_memcpy(dst, src, rowLength);
+			}
+			else
+			{
+				SDL_memcpy(src, dst, rowLength);
+			}
+		}
+	}
+}
+
+static void NULLDRV_SetTextureData2D(
+	FNA3D_Renderer *driverData,
+	FNA3D_Texture *texture,
+	int32_t x,
+	int32_t y,
+	int32_t w,
+	int32_t h,
+	int32_t level,
+	void* data,
+	int32_t dataLength
+) {
+	NULLDRV_INTERNAL_CopyTextureData(
+		(NullRenderer*) driverData,
+		(NullTexture*) texture,
+		NULL_TEXTURETYPE_2D,
+		x,
+		y,
+		0,
+		w,
+		h,
+		1,
+		0,
+		level,
+		data,
+		dataLength,
+		1
+	);
+}
+
+static void NULLDRV_SetTextureData3D(
+	FNA3D_Renderer *driverData,
+	FNA3D_Texture *texture,
+	int32_t x,
+	int32_t y,
+	int32_t z,
+	int32_t w,
+	int32_t h,
+	int32_t d,
+	int32_t level,
+	void* data,
+	int32_t dataLength
+) {
+	NULLDRV_INTERNAL_CopyTextureData(
+		(NullRenderer*) driverData,
+		(NullTexture*) texture,
+		NULL_TEXTURETYPE_3D,
+		x,
+		y,
+		z,
+		w,
+		h,
+		d,
+		0,
+		level,
+		data,
+		dataLength,
+		1
+	);
+}
+
+static void NULLDRV_SetTextureDataCube(
+	FNA3D_Renderer *driverData,
+	FNA3D_Texture *texture,
+	int32_t x,
+	int32_t y,
+	int32_t w,
+	int32_t h,
+	FNA3D_CubeMapFace cubeMapFace,
+	int32_t level,
+	void* data,
+	int32_t dataLength
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+
+	NULL_VALIDATE(
+		renderer,
+		cubeMapFace >= 0 && cubeMapFace < 6,
+		"Invalid cube map face: %d",
+		cubeMapFace
+	)
+
+	NULLDRV_INTERNAL_CopyTextureData(
+		renderer,
+		(NullTexture*) texture,
+		NULL_TEXTURETYPE_CUBE,
+		x,
+		y,
+		0,
+		w,
+		h,
+		1,
+		cubeMapFace,
+		level,
+		data,
+		dataLength,
+		1
+	);
+}
+
+static void NULLDRV_SetTextureDataYUV(
+	FNA3D_Renderer *driverData,
+	FNA3D_Texture *y,
+	FNA3D_Texture *u,
+	FNA3D_Texture *v,
+	int32_t yWidth,
+	int32_t yHeight,
+	int32_t uvWidth,
+	int32_t uvHeight,
+	void* data,
+	int32_t dataLength
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	uint8_t *dataPtr = (uint8_t*) data;
+	int32_t yDataLength = yWidth * yHeight;
+	int32_t uvDataLength = uvWidth * uvHeight;
+
+	NULL_VALIDATE(
+		renderer,
+		dataLength >= yDataLength + (uvDataLength * 2),
+		"YUV dataLength is too small!"
+	)
+
+	NULLDRV_INTERNAL_CopyTextureData(
+		renderer,
+		(NullTexture*) y,
+		NULL_TEXTURETYPE_2D,
+		0,
+		0,
+		0,
+		yWidth,
+		yHeight,
+		1,
+		0,
+		0,
+		dataPtr,
+		yDataLength,
+		1
+	);
+	dataPtr += yDataLength;
+	NULLDRV_INTERNAL_CopyTextureData(
+		renderer,
+		(NullTexture*) u,
+		NULL_TEXTURETYPE_2D,
+		0,
+		0,
+		0,
+		uvWidth,
+		uvHeight,
+		1,
+		0,
+		0,
+		dataPtr,
+		uvDataLength,
+		1
+	);
+	dataPtr += uvDataLength;
+	NULLDRV_INTERNAL_CopyTextureData(
+		renderer,
+		(NullTexture*) v,
+		NULL_TEXTURETYPE_2D,
+		0,
+		0,
+		0,
+		uvWidth,
+		uvHeight,
+		1,
+		0,
+		0,
+		dataPtr,
+		uvDataLength,
+		1
+	);
+}
+
+static void NULLDRV_GetTextureData2D(
+	FNA3D_Renderer *driverData,
+	FNA3D_Texture *texture,
+	int32_t x,
+	int32_t y,
+	int32_t w,
+	int32_t h,
+	int32_t level,
+	void* data,
+	int32_t dataLength
+) {
+	NULLDRV_INTERNAL_CopyTextureData(
+		(NullRenderer*) driverData,
+		(NullTexture*) texture,
+		NULL_TEXTURETYPE_2D,
+		x,
+		y,
+		0,
+		w,
+		h,
+		1,
+		0,
+		level,
+		data,
+		dataLength,
+		0
+	);
+}
+
+static void NULLDRV_GetTextureData3D(
+	FNA3D_Renderer *driverData,
+	FNA3D_Texture *texture,
+	int32_t x,
+	int32_t y,
+	int32_t z,
+	int32_t w,
+	int32_t h,
+	int32_t d,
+	int32_t level,
+	void* data,
+	int32_t dataLength
+) {
+	NULLDRV_INTERNAL_CopyTextureData(
+		(NullRenderer*) driverData,
+		(NullTexture*) texture,
+		NULL_TEXTURETYPE_3D,
+		x,
+		y,
+		z,
+		w,
+		h,
+		d,
+		0,
+		level,
+		data,
+		dataLength,
+		0
+	);
+}
+
+static void NULLDRV_GetTextureDataCube(
+	FNA3D_Renderer *driverData,
+	FNA3D_Texture *texture,
+	int32_t x,
+	int32_t y,
+	int32_t w,
+	int32_t h,
+	FNA3D_CubeMapFace cubeMapFace,
+	int32_t level,
+	void* data,
+	int32_t dataLength
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+
+	NULL_VALIDATE(
+		renderer,
+		cubeMapFace >= 0 && cubeMapFace < 6,
+		"Invalid cube map face: %d",
+		cubeMapFace
+	)
+
+	NULLDRV_INTERNAL_CopyTextureData(
+		renderer,
+		(NullTexture*) texture,
+		NULL_TEXTURETYPE_CUBE,
+		x,
+		y,
+		0,
+		w,
+		h,
+		1,
+		cubeMapFace,
+		level,
+		data,
+		dataLength,
+		0
+	);
+}
+
+/* Renderbuffers */
+
+static FNA3D_Renderbuffer* NULLDRV_GenColorRenderbuffer(
+	FNA3D_Renderer *driverData,
+	int32_t width,
+	int32_t height,
+	FNA3D_SurfaceFormat format,
+	int32_t multiSampleCount,
+	FNA3D_Texture *texture
+) {
+	NullRenderbuffer *result;
+
+	result = (NullRenderbuffer*) SDL_malloc(sizeof(NullRenderbuffer));
+	result->width = width;
+	result->height = height;
+	result->isDepthStencil = 0;
+	result->colorFormat = format;
+	result->depthFormat = FNA3D_DEPTHFORMAT_NONE;
+	result->multiSampleCount = SDL_min(multiSampleCount, 8);
+	return (FNA3D_Renderbuffer*) result;
+}
+
+static FNA3D_Renderbuffer* NULLDRV_GenDepthStencilRenderbuffer(
+	FNA3D_Renderer *driverData,
+	int32_t width,
+	int32_t height,
+	FNA3D_DepthFormat format,
+	int32_t multiSampleCount
+) {
+	NullRenderbuffer *result;
+
+	result = (NullRenderbuffer*) SDL_malloc(sizeof(NullRenderbuffer));
+	result->width = width;
+	result->height = height;
+	result->isDepthStencil = 1;
+	result->colorFormat = FNA3D_SURFACEFORMAT_COLOR;
+	result->depthFormat = format;
+	result->multiSampleCount = SDL_min(multiSampleCount, 8);
+	return (FNA3D_Renderbuffer*) result;
+}
+
+static void NULLDRV_AddDisposeRenderbuffer(
+	FNA3D_Renderer *driverData,
+	FNA3D_Renderbuffer *renderbuffer
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+
+	if (renderer->depthStencilBuffer == (NullRenderbuffer*) renderbuffer)
+	{
+		renderer->depthStencilBuffer = NULL;
+	}
+	SDL_free(renderbuffer);
+}
+
+/* Buffers */
+
+static FNA3D_Buffer* NULLDRV_INTERNAL_CreateBuffer(
+	NullRenderer *renderer,
+	uint8_t dynamic,
+	FNA3D_BufferUsage usage,
+	int32_t sizeInBytes
+) {
+	NullBuffer *result;
+
+	if (sizeInBytes <= 0)
+	{
+		FNA3D_LogError("Invalid buffer size: %d", sizeInBytes);
+		renderer->validationErrorCount += 1;
+		return NULL;
+	}
+
+	result = (NullBuffer*) SDL_malloc(sizeof(NullBuffer));
+	result->data = (uint8_t*) SDL_calloc(1, sizeInBytes);
+	result->size = sizeInBytes;
+	result->dynamic = dynamic;
+	result->usage = usage;
+	return (FNA3D_Buffer*) result;
+}
+
+static void NULLDRV_INTERNAL_DisposeBuffer(FNA3D_Buffer *buffer)
+{
+	NullBuffer *buf = (NullBuffer*) buffer;
+	SDL_free(buf->data);
+	SDL_free(buf);
+}
+
+static FNA3D_Buffer* NULLDRV_GenVertexBuffer(
+	FNA3D_Renderer *driverData,
+	uint8_t dynamic,
+	FNA3D_BufferUsage usage,
+	int32_t sizeInBytes
+) {
+	return NULLDRV_INTERNAL_CreateBuffer(
+		(NullRenderer*) driverData,
+		dynamic,
+		usage,
+		sizeInBytes
+	);
+}
+
+static void NULLDRV_AddDisposeVertexBuffer(
+	FNA3D_Renderer *driverData,
+	FNA3D_Buffer *buffer
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	int32_t i;
+
+	for (i = 0; i < renderer->numVertexBindings; i += 1)
+	{
+		if (renderer->vertexBuffers[i].vertexBuffer == buffer)
+		{
+			renderer->vertexBuffers[i].vertexBuffer = NULL;
+		}
+	}
+	NULLDRV_INTERNAL_DisposeBuffer(buffer);
+}
+
+static void NULLDRV_SetVertexBufferData(
+	FNA3D_Renderer *driverData,
+	FNA3D_Buffer *buffer,
+	int32_t offsetInBytes,
+	void* data,
+	int32_t elementCount,
+	int32_t elementSizeInBytes,
+	int32_t vertexStride,
+	FNA3D_SetDataOptions options
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	NullBuffer *buf = (NullBuffer*) buffer;
+	int64_t dataLen = (int64_t) elementCount * vertexStride;
+
+	NULL_VALIDATE(
+		renderer,
+		offsetInBytes >= 0 && offsetInBytes + dataLen <= buf->size,
+		"SetVertexBufferData writes past the end of the buffer!"
+	)
+
+	SDL_memcpy(buf->data + offsetInBytes, data, (size_t) dataLen);
+}
+
+static void NULLDRV_GetVertexBufferData(
+	FNA3D_Renderer *driverData,
+	FNA3D_Buffer *buffer,
+	int32_t offsetInBytes,
+	void* data,
+	int32_t elementCount,
+	int32_t elementSizeInBytes,
+	int32_t vertexStride
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	NullBuffer *buf = (NullBuffer*) buffer;
+	int64_t dataLen = (int64_t) elementCount * vertexStride;
+	uint8_t *src, *dst;
+	int32_t i;
+
+	NULL_VALIDATE(
+		renderer,
+		offsetInBytes >= 0 && offsetInBytes + dataLen <= buf->size,
+		"GetVertexBufferData reads past the end of the buffer!"
+	)
+
+	if (elementSizeInBytes < vertexStride)
+	{
+		src = buf->data + offsetInBytes;
+		dst = (uint8_t*) data;
+		for (i = 0; i < elementCount; i += 1)
+		{
+			SDL_memcpy(dst, src, elementSizeInBytes);
+			dst += elementSizeInBytes;
+			src += vertexStride;
+		}
+	}
+	else
+	{
+		SDL_memcpy(data, buf->data + offsetInBytes, (size_t) dataLen);
+	}
+}
+
+static FNA3D_Buffer* NULLDRV_GenIndexBuffer(
+	FNA3D_Renderer *driverData,
+	uint8_t dynamic,
+	FNA3D_BufferUsage usage,
+	int32_t sizeInBytes
+) {
+	return NULLDRV_INTERNAL_CreateBuffer(
+		(NullRenderer*) driverData,
+		dynamic,
+		usage,
+		sizeInBytes
+	);
+}
+
+static void NULLDRV_AddDisposeIndexBuffer(
+	FNA3D_Renderer *driverData,
+	FNA3D_Buffer *buffer
+) {
+	NULLDRV_INTERNAL_DisposeBuffer(buffer);
+}
+
+static void NULLDRV_SetIndexBufferData(
+	FNA3D_Renderer *driverData,
+	FNA3D_Buffer *buffer,
+	int32_t offsetInBytes,
+	void* data,
+	int32_t dataLength,
+	FNA3D_SetDataOptions options
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	NullBuffer *buf = (NullBuffer*) buffer;
+
+	NULL_VALIDATE(
+		renderer,
+		(	offsetInBytes >= 0 && dataLength >= 0 &&
+			(int64_t) offsetInBytes + dataLength <= buf->size	),
+		"SetIndexBufferData writes past the end of the buffer!"
+	)
+
+	SDL_memcpy(buf->data + offsetInBytes, data, dataLength);
+}
+
+static void NULLDRV_GetIndexBufferData(
+	FNA3D_Renderer *driverData,
+	FNA3D_Buffer *buffer,
+	int32_t offsetInBytes,
+	void* data,
+	int32_t dataLength
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	NullBuffer *buf = (NullBuffer*) buffer;
+
+	NULL_VALIDATE(
+		renderer,
+		(	offsetInBytes >= 0 && dataLength >= 0 &&
+			(int64_t) offsetInBytes + dataLength <= buf->size	),
+		"GetIndexBufferData reads past the end of the buffer!"
+	)
+
+	SDL_memcpy(data, buf->data + offsetInBytes, dataLength);
+}
+
+/* MojoShader Backend */
+
+static void* MOJOSHADERCALL NULLDRV_INTERNAL_CompileShader(
+	const void *ctx,
+	const char *mainfn,
+	const unsigned char *tokenbuf,
+	const unsigned int bufsize,
+	const MOJOSHADER_swizzle *swiz,
+	const unsigned int swizcount,
+	const MOJOSHADER_samplerMap *smap,
+	const unsigned int smapcount
+) {
+	NullRenderer *renderer = (NullRenderer*) ctx;
+	const MOJOSHADER_parseData *pd;
+	NullShader *result;
+
+	/* Translate the shader exactly like the OpenGL driver would, so the
+	 * cost of effect creation is still measured. No GLSL needs a mainfn.
+	 */
+	pd = MOJOSHADER_parse(
+		renderer->shaderProfile,
+		NULL,
+		tokenbuf,
+		bufsize,
+		swiz,
+		swizcount,
+		smap,
+		smapcount,
+		NULL,
+		NULL,
+		NULL
+	);
+	if (pd->error_count > 0)
+	{
+		SDL_strlcpy(
+			renderer->shaderError,
+			pd->errors[0].error,
+			sizeof(renderer->shaderError)
+		);
+		MOJOSHADER_freeParseData(pd);
+		return NULL;
+	}
+
+	result = (NullShader*) SDL_malloc(sizeof(NullShader));
+	result->parseData = pd;
+	result->refcount = 1;
+	return result;
+}
+
+static void MOJOSHADERCALL NULLDRV_INTERNAL_ShaderAddRef(void* shader)
+{
+	((NullShader*) shader)->refcount += 1;
+}
+
+static void MOJOSHADERCALL NULLDRV_INTERNAL_DeleteShader(
+	const void *ctx,
+	void* shader
+) {
+	NullRenderer *renderer = (NullRenderer*) ctx;
+	NullShader *nullShader = (NullShader*) shader;
+
+	if (nullShader == NULL)
+	{
+		return;
+	}
+
+	nullShader->refcount -= 1;
+	if (nullShader->refcount > 0)
+	{
+		return;
+	}
+
+	if (renderer->boundVertexShader == nullShader)
+	{
+		renderer->boundVertexShader = NULL;
+	}
+	if (renderer->boundPixelShader == nullShader)
+	{
+		renderer->boundPixelShader = NULL;
+	}
+	MOJOSHADER_freeParseData(nullShader->parseData);
+	SDL_free(nullShader);
+}
+
+static MOJOSHADER_parseData* MOJOSHADERCALL NULLDRV_INTERNAL_GetParseData(
+	void *shader
+) {
+	return (MOJOSHADER_parseData*) ((NullShader*) shader)->parseData;
+}
+
+static void MOJOSHADERCALL NULLDRV_INTERNAL_BindShaders(
+	const void *ctx,
+	void *vshader,
+	void *pshader
+) {
+	NullRenderer *renderer = (NullRenderer*) ctx;
+	renderer->boundVertexShader = (NullShader*) vshader;
+	renderer->boundPixelShader = (NullShader*) pshader;
+}
+
+static void MOJOSHADERCALL NULLDRV_INTERNAL_GetBoundShaders(
+	const void *ctx,
+	void **vshader,
+	void **pshader
+) {
+	NullRenderer *renderer = (NullRenderer*) ctx;
+	*vshader = renderer->boundVertexShader;
+	*pshader = renderer->boundPixelShader;
+}
+
+static void MOJOSHADERCALL NULLDRV_INTERNAL_MapUniformBufferMemory(
+	const void *ctx,
+	float **vsf, int **vsi, unsigned char **vsb,
+	float **psf, int **psi, unsigned char **psb
+) {
+	NullRenderer *renderer = (NullRenderer*) ctx;
+	*vsf = renderer->vs_reg_file_f;
+	*vsi = renderer->vs_reg_file_i;
+	*vsb = renderer->vs_reg_file_b;
+	*psf = renderer->ps_reg_file_f;
+	*psi = renderer->ps_reg_file_i;
+	*psb = renderer->ps_reg_file_b;
+}
+
+static void MOJOSHADERCALL NULLDRV_INTERNAL_UnmapUniformBufferMemory(
+	const void *ctx
+) {
+	/* Nothing to upload */
+}
+
+static const char* MOJOSHADERCALL NULLDRV_INTERNAL_GetShaderError(
+	const void *ctx
+) {
+	NullRenderer *renderer = (NullRenderer*) ctx;
+	return renderer->shaderError;
+}
+
+/* Effects */
+
+static void NULLDRV_CreateEffect(
+	FNA3D_Renderer *driverData,
+	uint8_t *effectCode,
+	uint32_t effectCodeLength,
+	FNA3D_Effect **effect,
+	MOJOSHADER_effect **effectData
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	MOJOSHADER_effectShaderContext shaderBackend;
+	NullEffect *result;
+	int32_t i;
+
+	shaderBackend.shaderContext = renderer;
+	shaderBackend.compileShader = NULLDRV_INTERNAL_CompileShader;
+	shaderBackend.shaderAddRef = NULLDRV_INTERNAL_ShaderAddRef;
+	shaderBackend.deleteShader = NULLDRV_INTERNAL_DeleteShader;
+	shaderBackend.getParseData = NULLDRV_INTERNAL_GetParseData;
+	shaderBackend.bindShaders = NULLDRV_INTERNAL_BindShaders;
+	shaderBackend.getBoundShaders = NULLDRV_INTERNAL_GetBoundShaders;
+	shaderBackend.mapUniformBufferMemory = NULLDRV_INTERNAL_MapUniformBufferMemory;
+	shaderBackend.unmapUniformBufferMemory = NULLDRV_INTERNAL_UnmapUniformBufferMemory;
+	shaderBackend.getError = NULLDRV_INTERNAL_GetShaderError;
+	shaderBackend.m = NULL;
+	shaderBackend.f = NULL;
+	shaderBackend.malloc_data = NULL;
+
+	*effectData = MOJOSHADER_compileEffect(
+		effectCode,
+		effectCodeLength,
+		NULL,
+		0,
+		NULL,
+		0,
+		&shaderBackend
+	);
+
+	for (i = 0; i < (*effectData)->error_count; i += 1)
+	{
+		FNA3D_LogError(
+			"MOJOSHADER_compileEffect Error: %s",
+			(*effectData)->errors[i].error
+		);
+	}
+
+	result = (NullEffect*) SDL_malloc(sizeof(NullEffect));
+	result->effect = *effectData;
+	*effect = (FNA3D_Effect*) result;
+}
+
+static void NULLDRV_CloneEffect(
+	FNA3D_Renderer *driverData,
+	FNA3D_Effect *cloneSource,
+	FNA3D_Effect **effect,
+	MOJOSHADER_effect **effectData
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	NullEffect *nullCloneSource = (NullEffect*) cloneSource;
+	NullEffect *result;
+
+	*effectData = MOJOSHADER_cloneEffect(nullCloneSource->effect);
+	if (*effectData == NULL)
+	{
+		FNA3D_LogError("%s", renderer->shaderError);
+	}
+
+	result = (NullEffect*) SDL_malloc(sizeof(NullEffect));
+	result->effect = *effectData;
+	*effect = (FNA3D_Effect*) result;
+}
+
+static void NULLDRV_AddDisposeEffect(
+	FNA3D_Renderer *driverData,
+	FNA3D_Effect *effect
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	NullEffect *nullEffect = (NullEffect*) effect;
+	MOJOSHADER_effect *effectData = nullEffect->effect;
+
+	if (effectData == renderer->currentEffect)
+	{
+		MOJOSHADER_effectEndPass(renderer->currentEffect);
+		MOJOSHADER_effectEnd(renderer->currentEffect);
+		renderer->currentEffect = NULL;
+		renderer->currentTechnique = NULL;
+		renderer->currentPass = 0;
+	}
+	MOJOSHADER_deleteEffect(effectData);
+	SDL_free(nullEffect);
+}
+
+static void NULLDRV_SetEffectTechnique(
+	FNA3D_Renderer *driverData,
+	FNA3D_Effect *effect,
+	MOJOSHADER_effectTechnique *technique
+) {
+	NullEffect *nullEffect = (NullEffect*) effect;
+	MOJOSHADER_effectSetTechnique(nullEffect->effect, technique);
+}
+
+static void NULLDRV_ApplyEffect(
+	FNA3D_Renderer *driverData,
+	FNA3D_Effect *effect,
+	uint32_t pass,
+	MOJOSHADER_effectStateChanges *stateChanges
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	NullEffect *nullEffect = (NullEffect*) effect;
+	MOJOSHADER_effect *effectData = nullEffect->effect;
+	const MOJOSHADER_effectTechnique *technique = effectData->current_technique;
+	uint32_t numPasses;
+
+	renderer->stateChangeCount += 1;
+
+	if (effectData == renderer->currentEffect)
+	{
+		if (
+			technique == renderer->currentTechnique &&
+			pass == renderer->currentPass
+		) {
+			MOJOSHADER_effectCommitChanges(
+				renderer->currentEffect
+			);
+
+			return;
+		}
+
+		MOJOSHADER_effectEndPass(renderer->currentEffect);
+		MOJOSHADER_effectBeginPass(renderer->currentEffect, pass);
+		renderer->currentTechnique = technique;
+		renderer->currentPass = pass;
+
+		return;
+	}
+	else if (renderer->currentEffect != NULL)
+	{
+		MOJOSHADER_effectEndPass(renderer->currentEffect);
+		MOJOSHADER_effectEnd(renderer->currentEffect);
+	}
+
+	MOJOSHADER_effectBegin(
+		effectData,
+		&numPasses,
+		0,
+		stateChanges
+	);
+
+	MOJOSHADER_effectBeginPass(effectData, pass);
+	renderer->currentEffect = effectData;
+	renderer->currentTechnique = technique;
+	renderer->currentPass = pass;
+}
+
+static void NULLDRV_BeginPassRestore(
+	FNA3D_Renderer *driverData,
+	FNA3D_Effect *effect,
+	MOJOSHADER_effectStateChanges *stateChanges
+) {
+	MOJOSHADER_effect *effectData = ((NullEffect*) effect)->effect;
+	uint32_t whatever;
+
+	MOJOSHADER_effectBegin(
+		effectData,
+		&whatever,
+		1,
+		stateChanges
+	);
+	MOJOSHADER_effectBeginPass(effectData, 0);
+}
+
+static void NULLDRV_EndPassRestore(
+	FNA3D_Renderer *driverData,
+	FNA3D_Effect *effect
+) {
+	MOJOSHADER_effect *effectData = ((NullEffect*) effect)->effect;
+	MOJOSHADER_effectEndPass(effectData);
+	MOJOSHADER_effectEnd(effectData);
+}
+
+static void NULLDRV_PrecompilePipelines(
+	FNA3D_Renderer *driverData,
+	FNA3D_PrecompileInfoEXT *infos,
+	int32_t numInfos
+) {
+	/* Nothing to compile */
+}
+
+static int32_t NULLDRV_GetPendingPipelines(FNA3D_Renderer *driverData)
+{
+	return 0;
+}
+
+/* Queries */
+
+static FNA3D_Query* NULLDRV_CreateQuery(FNA3D_Renderer *driverData)
+{
+	NullQuery *result = (NullQuery*) SDL_malloc(sizeof(NullQuery));
+	result->active = 0;
+	return (FNA3D_Query*) result;
+}
+
+static void NULLDRV_AddDisposeQuery(
+	FNA3D_Renderer *driverData,
+	FNA3D_Query *query
+) {
+	SDL_free(query);
+}
+
+static void NULLDRV_QueryBegin(
+	FNA3D_Renderer *driverData,
+	FNA3D_Query *query
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	NullQuery *nullQuery = (NullQuery*) query;
+
+	NULL_VALIDATE(
+		renderer,
+		!nullQuery->active,
+		"QueryBegin called on a query that is already active!"
+	)
+	nullQuery->active = 1;
+}
+
+static void NULLDRV_QueryEnd(
+	FNA3D_Renderer *driverData,
+	FNA3D_Query *query
+) {
+	NullRenderer *renderer = (NullRenderer*) driverData;
+	NullQuery *nullQuery = (NullQuery*) query;
+
+	NULL_VALIDATE(
+		renderer,
+		nullQuery->active,
+		"QueryEnd called on a query that is not active!"
+	)
+	nullQuery->active = 0;
+}
+
+static uint8_t NULLDRV_QueryComplete(
+	FNA3D_Renderer *driverData,
+	FNA3D_Query *query
+) {
+	return 1;
+}
+
+static int32_t NULLDRV_QueryPixelCount(
+	FNA3D_Renderer *driverData,
+	FNA3D_Query *query
+) {
+	return 0;
+}
+
+/* Feature Queries */
+
+static uint8_t NULLDRV_SupportsDXT1(FNA3D_Renderer *driverData)
+{
+	return 1;
+}
+
+static uint8_t NULLDRV_SupportsS3TC(FNA3D_Renderer *driverData)
+{
+	return 1;
+}
+
+static uint8_t NULLDRV_SupportsBC7(FNA3D_Renderer *driverData)
+{
+	return 1;
+}
+
+static uint8_t NULLDRV_SupportsHardwareInstancing(FNA3D_Renderer *driverData)
+{
+	return 1;
+}
+
+static uint8_t NULLDRV_SupportsNoOverwrite(FNA3D_Renderer *driverData)
+{
+	return 1;
+}
+
+static uint8_t NULLDRV_SupportsSRGBRenderTargets(FNA3D_Renderer *driverData)
+{
+	return 1;
+}
+
+static void NULLDRV_GetMaxTextureSlots(
+	FNA3D_Renderer *driverData,
+	int32_t *textures,
+	int32_t *vertexTextures
+) {
+	*textures = MAX_TEXTURE_SAMPLERS;
+	*vertexTextures = MAX_VERTEXTEXTURE_SAMPLERS;
+}
+
+static int32_t NULLDRV_GetMaxMultiSampleCount(
+	FNA3D_Renderer *driverData,
+	FNA3D_SurfaceFormat format,
+	int32_t multiSampleCount
+) {
+	return SDL_min(multiSampleCount, 8);
+}
+
+/* Debugging */
+
+static void NULLDRV_SetStringMarker(
+	FNA3D_Renderer *driverData,
+	const char *text
+) {
+	/* No-op */
+}
+
+static void NULLDRV_SetTextureName(
+	FNA3D_Renderer *driverData,
+	FNA3D_Texture *texture,
+	const char *text
+) {
+	/* No-op */
+}
+
+/* External Interop */
+
+static void NULLDRV_GetSysRenderer(
+	FNA3D_Renderer *driverData,
+	FNA3D_SysRendererEXT *sysrenderer
+) {
+	SDL_memset(sysrenderer, '\0', sizeof(FNA3D_SysRendererEXT));
+	sysrenderer->rendererType = FNA3D_RENDERER_TYPE_NULL_EXT;
+}
+
+static FNA3D_Texture* NULLDRV_CreateSysTexture(
+	FNA3D_Renderer *driverData,
+	FNA3D_SysTextureEXT *externalTextureInfo
+) {
+	FNA3D_LogError("The Null driver has no system textures!");
+	return NULL;
+}
+
+/* Driver */
+
+static uint8_t NULLDRV_PrepareWindowAttributes(uint32_t *flags)
+{
+	const char *hint = SDL_GetHint("FNA3D_FORCE_DRIVER");
+
+	/* Never fall back to the Null driver, it has to be asked for */
+	if (hint == NULL || SDL_strcasecmp(hint, "Null") != 0)
+	{
+		return 0;
+	}
+
+	*flags = 0;
+	return 1;
+}
+
+static FNA3D_Device* NULLDRV_CreateDevice(
+	FNA3D_PresentationParameters *presentationParameters,
+	uint8_t debugMode
+) {
+	NullRenderer *renderer;
+	FNA3D_Device *result;
+
+	/* Create the FNA3D_Device */
+	result = (FNA3D_Device*) SDL_malloc(sizeof(FNA3D_Device));
+	ASSIGN_DRIVER(NULLDRV)
+
+	/* Init the NullRenderer */
+	renderer = (NullRenderer*) SDL_malloc(sizeof(NullRenderer));
+	SDL_memset(renderer, '\0', sizeof(NullRenderer));
+	result->driverData = (FNA3D_Renderer*) renderer;
+
+	NULLDRV_INTERNAL_SetPresentationParameters(
+		renderer,
+		presentationParameters
+	);
+	renderer->currentDepthFormat = renderer->backbufferDepthFormat;
+	renderer->multiSampleMask = -1;
+
+	/* The profile only affects how much work shader translation does */
+	renderer->shaderProfile = SDL_GetHint("FNA3D_MOJOSHADER_PROFILE");
+	if (renderer->shaderProfile == NULL || renderer->shaderProfile[0] == '\0')
+	{
+		renderer->shaderProfile = MOJOSHADER_PROFILE_GLSL120;
+	}
+
+	FNA3D_LogInfo("FNA3D Driver: Null");
+	FNA3D_LogInfo("MojoShader Profile: %s", renderer->shaderProfile);
+
+	return result;
+}
+
+FNA3D_Driver NullDriver = {
+	"Null",
+	NULLDRV_PrepareWindowAttributes,
+	NULLDRV_CreateDevice
+};
+
+#else
+
+extern int this_tu_is_empty;
+
+#endif /* FNA3D_DRIVER_NULL */
+
+/* vim: set noexpandtab shiftwidth=8 tabstop=8: */
@@ -27,6 +27,7 @@
 #if FNA3D_DRIVER_OPENGL
 
 #include "FNA3D_Driver.h"
+#include "FNA3D_PipelineCache.h"
 #include "FNA3D_Driver_OpenGL.h"
 
 #ifdef USE_SDL3
@@ -629,6 +630,7 @@ struct FNA3D_Command
 	#define FNA3D_COMMAND_GETTEXTUREDATACUBE 16
 	#define FNA3D_COMMAND_GENCOLORRENDERBUFFER 17
 	#define FNA3D_COMMAND_GENDEPTHRENDERBUFFER 18
+	#define FNA3D_COMMAND_PRECOMPILEPIPELINES 19
 	uint8_t type;
 	FNA3DNAMELESS union
 	{
@@ -826,6 +828,12 @@ struct FNA3D_Command
 			int32_t multiSampleCount;
 			FNA3D_Renderbuffer *retval;
 		} genDepthStencilRenderbuffer;
+
+		struct
+		{
+			FNA3D_PrecompileInfoEXT *infos;
+			int32_t numInfos;
+		} precompilePipelines;
 	};
 	SDL_Semaphore *semaphore;
 	FNA3D_Command *next;
@@ -1044,6 +1052,13 @@ static void FNA3D_ExecuteCommand(
 				cmd->genDepthStencilRenderbuffer.multiSampleCount
 			);
 			break;
+		case FNA3D_COMMAND_PRECOMPILEPIPELINES:
+			device->PrecompilePipelines(
+				device->driverData,
+				cmd->precompilePipelines.infos,
+				cmd->precompilePipelines.numInfos
+			);
+			break;
 		default:
 			FNA3D_LogError(
 				"Cannot execute unknown command (value = %d)",
@@ -5168,6 +5183,60 @@ static void OPENGL_EndPassRestore(
 	renderer->effectApplied = 1;
 }
 
+static void OPENGL_PrecompilePipelines(
+	FNA3D_Renderer *driverData,
+	FNA3D_PrecompileInfoEXT *infos,
+	int32_t numInfos
+) {
+	OpenGLRenderer *renderer = (OpenGLRenderer*) driverData;
+	MOJOSHADER_effect *effectData;
+	MOJOSHADER_glShader *oldVertexShader, *oldPixelShader;
+	int32_t vertexShaderIndex, pixelShaderIndex;
+	int32_t i;
+	FNA3D_Command cmd;
+
+	if (renderer->threadID != SDL_GetCurrentThreadID())
+	{
+		cmd.type = FNA3D_COMMAND_PRECOMPILEPIPELINES;
+		cmd.precompilePipelines.infos = infos;
+		cmd.precompilePipelines.numInfos = numInfos;
+		ForceToMainThread(renderer, &cmd);
+		return;
+	}
+
+	/* GL has no pipeline objects and MojoShader doesn't care about the
+	 * vertex layout, so all we can do here is link the programs.
+	 */
+	MOJOSHADER_glGetBoundShaders(&oldVertexShader, &oldPixelShader);
+	for (i = 0; i < numInfos; i += 1)
+	{
+		effectData = ((OpenGLEffect*) infos[i].effect)->effect;
+		if (!GetEffectPassShaders(
+			effectData,
+			infos[i].technique,
+			infos[i].pass,
+			&vertexShaderIndex,
+			&pixelShaderIndex
+		)) {
+			continue;
+		}
+
+		/* This links the program and puts it in the linker cache */
+		MOJOSHADER_glBindShaders(
+			(MOJOSHADER_glShader*) effectData->objects[vertexShaderIndex].shader.shader,
+			(MOJOSHADER_glShader*) effectData->objects[pixelShaderIndex].shader.shader
+		);
+	}
+	MOJOSHADER_glBindShaders(oldVertexShader, oldPixelShader);
+	renderer->effectApplied = 1;
+}
+
+static int32_t OPENGL_GetPendingPipelines(FNA3D_Renderer *driverData)
+{
+	/* Programs are linked right away, there's never anything pending */
+	return 0;
+}
+
 /* Queries */
 
 static FNA3D_Query* OPENGL_CreateQuery(FNA3D_Renderer *driverData)
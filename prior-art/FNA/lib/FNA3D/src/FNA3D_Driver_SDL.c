@@ -336,6 +336,7 @@ typedef struct SDLGPU_Renderbuffer /* Cast from FNA3D_Renderbuffer* */
 typedef struct SDLGPU_Effect /* Cast from FNA3D_Effect* */
 {
 	MOJOSHADER_effect *effect;
+	uint64_t hash; /* Only set when the pipeline cache is enabled */
 } SDLGPU_Effect;
 
 typedef struct SDLGPU_BufferHandle /* Cast from FNA3D_Buffer* */
@@ -460,6 +461,32 @@ static inline uint64_t GraphicsPipelineHashTable_GetHashCode(GraphicsPipelineHas
 	return result;
 }
 
+static inline uint8_t GraphicsPipelineHash_Equals(
+	const GraphicsPipelineHash *a,
+	const GraphicsPipelineHash *b
+) {
+	return (
+		a->blendState.a == b->blendState.a &&
+		a->blendState.b == b->blendState.b &&
+		a->rasterizerState.a == b->rasterizerState.a &&
+		a->rasterizerState.b == b->rasterizerState.b &&
+		a->depthStencilState.a == b->depthStencilState.a &&
+		a->depthStencilState.b == b->depthStencilState.b &&
+		a->vertexBufferBindingsIndex == b->vertexBufferBindingsIndex &&
+		a->primitiveType == b->primitiveType &&
+		a->sampleMask == b->sampleMask &&
+		a->vertShader == b->vertShader &&
+		a->fragShader == b->fragShader &&
+		a->colorFormatCount == b->colorFormatCount &&
+		a->colorFormats[0] == b->colorFormats[0] &&
+		a->colorFormats[1] == b->colorFormats[1] &&
+		a->colorFormats[2] == b->colorFormats[2] &&
+		a->colorFormats[3] == b->colorFormats[3] &&
+		a->hasDepthStencilAttachment == b->hasDepthStencilAttachment &&
+		a->depthStencilFormat == b->depthStencilFormat
+	);
+}
+
 static inline SDL_GPUGraphicsPipeline *GraphicsPipelineHashTable_Fetch(
 	GraphicsPipelineHashTable *table,
 	GraphicsPipelineHash key
@@ -470,25 +497,7 @@ static inline SDL_GPUGraphicsPipeline *GraphicsPipelineHashTable_Fetch(
 
 	for (i = 0; i < arr->count; i += 1)
 	{
-		const GraphicsPipelineHash *e = &arr->elements[i].key;
-		if (	key.blendState.a == e->blendState.a &&
-			key.blendState.b == e->blendState.b &&
-			key.rasterizerState.a == e->rasterizerState.a &&
-			key.rasterizerState.b == e->rasterizerState.b &&
-			key.depthStencilState.a == e->depthStencilState.a &&
-			key.depthStencilState.b == e->depthStencilState.b &&
-			key.vertexBufferBindingsIndex == e->vertexBufferBindingsIndex &&
-			key.primitiveType == e->primitiveType &&
-			key.sampleMask == e->sampleMask &&
-			key.vertShader == e->vertShader &&
-			key.fragShader == e->fragShader &&
-			key.colorFormatCount == e->colorFormatCount &&
-			key.colorFormats[0] == e->colorFormats[0] &&
-			key.colorFormats[1] == e->colorFormats[1] &&
-			key.colorFormats[2] == e->colorFormats[2] &&
-			key.colorFormats[3] == e->colorFormats[3] &&
-			key.hasDepthStencilAttachment == e->hasDepthStencilAttachment &&
-			key.depthStencilFormat == e->depthStencilFormat )
+		if (GraphicsPipelineHash_Equals(&key, &arr->elements[i].key))
 		{
 			return arr->elements[i].value;
 		}
@@ -514,6 +523,162 @@ static inline void GraphicsPipelineHashTable_Insert(
 	arr->count += 1;
 }
 
+/* SDL_GPU can't serialize pipelines, so the pipeline cache file stores what we
+ * need to build each one again instead: the bytecode hash of the effect, the
+ * index of each shader within the effect's objects, the render state and the
+ * vertex layout. When an effect with a matching hash gets created, its shaders
+ * are linked right away and the pipelines get built on a background thread, so
+ * they're usually ready before the first draw that needs them.
+ *
+ * The cache is opt-in, set the FNA3D_SDLGPU_PIPELINE_CACHE hint to a file path.
+ * The file is read by CreateDevice and written back by DestroyDevice.
+ */
+
+#define PIPELINE_CACHE_MAGIC		0x43503346 /* "F3PC" */
+#define PIPELINE_CACHE_VERSION		2
+#define PIPELINE_CACHE_MAX_ENTRIES	65536
+
+typedef struct PipelineCacheHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t keySize;
+	char deviceDriver[32];
+	uint32_t entryCount;
+	uint64_t bodyHash;
+} PipelineCacheHeader;
+
+/* The FNA3D states have padding after their uint8_t fields, so the key keeps
+ * its own copies with every field widened to 32 bits.
+ * See SDLGPU_INTERNAL_PackPipelineCacheStates.
+ */
+typedef struct PipelineCacheBlendState
+{
+	uint32_t colorSourceBlend;
+	uint32_t colorDestinationBlend;
+	uint32_t colorBlendFunction;
+	uint32_t alphaSourceBlend;
+	uint32_t alphaDestinationBlend;
+	uint32_t alphaBlendFunction;
+	uint32_t colorWriteEnable;
+	uint32_t colorWriteEnable1;
+	uint32_t colorWriteEnable2;
+	uint32_t colorWriteEnable3;
+	uint32_t blendFactor; /* RGBA, R in the low byte */
+	uint32_t multiSampleMask;
+} PipelineCacheBlendState;
+
+typedef struct PipelineCacheRasterizerState
+{
+	uint32_t fillMode;
+	uint32_t cullMode;
+	float depthBias;
+	float slopeScaleDepthBias;
+	uint32_t scissorTestEnable;
+	uint32_t multiSampleAntiAlias;
+} PipelineCacheRasterizerState;
+
+typedef struct PipelineCacheDepthStencilState
+{
+	uint32_t depthBufferEnable;
+	uint32_t depthBufferWriteEnable;
+	uint32_t depthBufferFunction;
+	uint32_t stencilEnable;
+	uint32_t stencilMask;
+	uint32_t stencilWriteMask;
+	uint32_t twoSidedStencilMode;
+	uint32_t stencilFail;
+	uint32_t stencilDepthBufferFail;
+	uint32_t stencilPass;
+	uint32_t stencilFunction;
+	uint32_t ccwStencilFail;
+	uint32_t ccwStencilDepthBufferFail;
+	uint32_t ccwStencilPass;
+	uint32_t ccwStencilFunction;
+	uint32_t referenceStencil;
+} PipelineCacheDepthStencilState;
+
+/* Compared with memcmp and written to the file as-is, so there can't be any
+ * padding in here. It's still zeroed before being filled out.
+ */
+typedef struct PipelineCacheKey
+{
+	uint64_t effectHash;
+	int32_t vertexShaderIndex;
+	int32_t fragmentShaderIndex;
+	PipelineCacheBlendState blendState;
+	PipelineCacheRasterizerState rasterizerState;
+	PipelineCacheDepthStencilState depthStencilState;
+	uint32_t primitiveType;
+	uint32_t sampleCount;
+	uint32_t sampleMask;
+	uint32_t colorFormats[MAX_RENDERTARGET_BINDINGS];
+	uint32_t colorFormatCount;
+	uint32_t hasDepthStencilAttachment;
+	uint32_t depthStencilFormat;
+	uint32_t numVertexBindings;
+	uint32_t reserved; /* Always 0, rounds the size up to effectHash's */
+} PipelineCacheKey;
+
+SDL_COMPILE_TIME_ASSERT(
+	PipelineCacheKey,
+	sizeof(PipelineCacheKey) == offsetof(PipelineCacheKey, reserved) + sizeof(uint32_t)
+);
+
+/* Only the first elementCount elements are written to the file */
+typedef struct PipelineCacheVertexBinding
+{
+	int32_t vertexStride;
+	int32_t instanceFrequency;
+	int32_t elementCount;
+	FNA3D_VertexElement elements[MAX_VERTEX_ATTRIBUTES];
+} PipelineCacheVertexBinding;
+
+typedef struct PipelineCacheEntry
+{
+	PipelineCacheKey key;
+	PipelineCacheVertexBinding *vertexBindings; /* key.numVertexBindings */
+} PipelineCacheEntry;
+
+typedef struct PipelineCacheEntryArray
+{
+	PipelineCacheEntry *elements;
+	int32_t count;
+	int32_t capacity;
+} PipelineCacheEntryArray;
+
+/* Indices into PipelineCacheEntryArray, bucketed by the entry's bytes */
+typedef struct PipelineCacheIndexArray
+{
+	int32_t *elements;
+	int32_t count;
+	int32_t capacity;
+} PipelineCacheIndexArray;
+
+/* Pipelines are also built on worker threads when FNA3D_SDLGPU_ASYNC_PIPELINES
+ * is set, or when FNA3D_PrecompilePipelinesEXT is called. In async mode a
+ * draw that misses the hash table queues its pipeline, and is drawn with a
+ * pipeline that only differs in dynamic state (blend constants and stencil
+ * reference) until the real one is ready. If there isn't one, the draw waits
+ * for its pipeline instead.
+ */
+
+#define MAX_PIPELINE_THREADS 4
+
+/* A pipeline to be created by a pipeline thread. The create info points
+ * into the job itself, so nothing else has to stay alive while it waits.
+ */
+typedef struct SDLGPU_PipelineJob
+{
+	GraphicsPipelineHash hash;
+	SDL_GPUGraphicsPipelineCreateInfo createInfo;
+	SDL_GPUVertexBufferDescription vertexBindings[MAX_BOUND_VERTEX_BUFFERS];
+	SDL_GPUVertexAttribute vertexAttributes[MAX_BOUND_VERTEX_BUFFERS * MAX_VERTEX_ATTRIBUTES];
+	SDL_GPUColorTargetDescription colorAttachmentDescriptions[MAX_RENDERTARGET_BINDINGS];
+	SDL_GPUGraphicsPipeline *pipeline;
+	struct SDLGPU_PipelineJob *next;
+} SDLGPU_PipelineJob;
+
 typedef struct SDLGPU_Renderer
 {
 	SDL_GPUDevice *device;
@@ -626,6 +791,28 @@ typedef struct SDLGPU_Renderer
 	MOJOSHADER_effect *currentEffect;
 	const MOJOSHADER_effectTechnique *currentTechnique;
 	uint32_t currentPass;
+	uint64_t currentEffectHash;
+
+	/* Pipeline cache, see PipelineCacheKey */
+
+	char *pipelineCachePath; /* NULL if the cache is disabled */
+	PipelineCacheEntryArray pipelineCache;
+	PipelineCacheIndexArray pipelineCacheBuckets[NUM_PIPELINE_HASH_BUCKETS];
+
+	SDL_Thread *pipelineThreads[MAX_PIPELINE_THREADS];
+	int32_t pipelineThreadCount;
+	SDL_Mutex *pipelineJobLock;
+	SDL_Condition *pipelineJobCondition;
+	SDL_Condition *pipelineDoneCondition; /* Broadcast for every finished job */
+	SDLGPU_PipelineJob *pendingPipelineJobs;
+	SDLGPU_PipelineJob *pendingPipelineJobsTail;
+	SDLGPU_PipelineJob *finishedPipelineJobs;
+	SDL_AtomicInt finishedPipelineJobCount;
+	uint32_t activePipelineJobs; /* Pending + in progress */
+	uint8_t pipelineThreadQuit;
+	GraphicsPipelineHashArray pendingPipelines; /* Value is unused */
+	GraphicsPipelineHashTable compatiblePipelineHashTable;
+	uint8_t asyncPipelines;
 
 	/* Dummy Samplers */
 
@@ -1411,8 +1598,10 @@ static void SDLGPU_ResolveTarget(
 	SDL_GenerateMipmapsForGPUTexture(renderer->renderCommandBuffer, texture->texture);
 }
 
-static void SDLGPU_INTERNAL_GenerateVertexInputInfo(
+static uint8_t SDLGPU_INTERNAL_GenerateVertexInputInfo(
 	SDLGPU_Renderer *renderer,
+	FNA3D_VertexBufferBinding *vertexBindings,
+	uint32_t numVertexBindings,
 	SDL_GPUVertexBufferDescription *bindings,
 	SDL_GPUVertexAttribute *attributes,
 	uint32_t *attributeCount
@@ -1430,10 +1619,10 @@ static void SDLGPU_INTERNAL_GenerateVertexInputInfo(
 	MOJOSHADER_sdlGetBoundShaderData(renderer->mojoshaderContext, &vertexShader, &blah);
 
 	SDL_memset(attrUse, '\0', sizeof(attrUse));
-	for (i = 0; i < (int32_t) renderer->numVertexBindings; i += 1)
+	for (i = 0; i < (int32_t) numVertexBindings; i += 1)
 	{
 		vertexDeclaration =
-			renderer->vertexBindings[i].vertexDeclaration;
+			vertexBindings[i].vertexDeclaration;
 
 		for (j = 0; j < vertexDeclaration.elementCount; j += 1)
 		{
@@ -1460,66 +1649,1391 @@ static void SDLGPU_INTERNAL_GenerateVertexInputInfo(
 				}
 			}
 
-			attrUse[usage][index] = 1;
+			attrUse[usage][index] = 1;
+
+			attribLoc = MOJOSHADER_sdlGetVertexAttribLocation(
+				vertexShader,
+				VertexAttribUsage(usage),
+				index
+			);
+
+			if (attribLoc == -1)
+			{
+				/* Stream not in use! */
+				continue;
+			}
+
+			attributes[attributeDescriptionCounter].location = attribLoc;
+			attributes[attributeDescriptionCounter].format = XNAToSDL_VertexAttribType[
+				element.vertexElementFormat
+			];
+			attributes[attributeDescriptionCounter].offset = element.offset;
+			attributes[attributeDescriptionCounter].buffer_slot = i;
+
+			mojoshaderVertexAttributes[attributeDescriptionCounter].usage = VertexAttribUsage(element.vertexElementUsage);
+			mojoshaderVertexAttributes[attributeDescriptionCounter].vertexElementFormat = (MOJOSHADER_vertexElementFormat) element.vertexElementFormat; /* FNA3D/MojoShader use the same enum values */
+			mojoshaderVertexAttributes[attributeDescriptionCounter].usageIndex = index;
+
+			attributeDescriptionCounter += 1;
+		}
+
+		bindings[i].slot = i;
+		bindings[i].pitch = vertexDeclaration.vertexStride;
+
+		if (vertexBindings[i].instanceFrequency > 0)
+		{
+			if (vertexBindings[i].instanceFrequency > 1)
+			{
+				FNA3D_LogError("Vertex instanceFrequency must be either 0 or 1!");
+			}
+			bindings[i].input_rate =
+				SDL_GPU_VERTEXINPUTRATE_INSTANCE;
+			bindings[i].instance_step_rate = 0;
+		}
+		else
+		{
+			bindings[i].input_rate =
+				SDL_GPU_VERTEXINPUTRATE_VERTEX;
+			bindings[i].instance_step_rate = 0; /* should be ignored */
+		}
+	}
+
+	*attributeCount = attributeDescriptionCounter;
+
+	return MOJOSHADER_sdlLinkProgram(
+		renderer->mojoshaderContext,
+		mojoshaderVertexAttributes,
+		attributeDescriptionCounter
+	) != NULL;
+}
+
+/* Fills out everything but the shaders and vertex input state */
+static void SDLGPU_INTERNAL_FillGraphicsPipelineCreateInfo(
+	const GraphicsPipelineHash *hash,
+	const FNA3D_BlendState *blendState,
+	const FNA3D_RasterizerState *rasterizerState,
+	const FNA3D_DepthStencilState *depthStencilState,
+	SDL_GPUGraphicsPipelineCreateInfo *createInfo,
+	SDL_GPUColorTargetDescription *colorAttachmentDescriptions
+) {
+	createInfo->primitive_type = XNAToSDL_PrimitiveType[hash->primitiveType];
+
+	/* Rasterizer */
+
+	createInfo->rasterizer_state.cull_mode = XNAToSDL_CullMode[rasterizerState->cullMode];
+	createInfo->rasterizer_state.depth_bias_clamp = 0.0f;
+	createInfo->rasterizer_state.depth_bias_constant_factor = rasterizerState->depthBias;
+	createInfo->rasterizer_state.enable_depth_bias = 1;
+	createInfo->rasterizer_state.enable_depth_clip = 1;
+	createInfo->rasterizer_state.depth_bias_slope_factor = rasterizerState->slopeScaleDepthBias;
+	createInfo->rasterizer_state.fill_mode = XNAToSDL_FillMode[rasterizerState->fillMode];
+	createInfo->rasterizer_state.front_face = SDL_GPU_FRONTFACE_CLOCKWISE;
+
+	/* Multisample */
+
+	SDL_zero(createInfo->multisample_state);
+	createInfo->multisample_state.sample_count = hash->sampleCount;
+	if (hash->sampleMask != 0xFFFFFFFF)
+	{
+		createInfo->multisample_state.enable_mask = true;
+		createInfo->multisample_state.sample_mask = hash->sampleMask;
+	}
+	else
+	{
+		createInfo->multisample_state.enable_mask = false;
+		createInfo->multisample_state.sample_mask = 0;
+	}
+
+	/* Blend State */
+
+	colorAttachmentDescriptions[0].blend_state.enable_blend = !(
+		blendState->colorSourceBlend == FNA3D_BLEND_ONE &&
+		blendState->colorDestinationBlend == FNA3D_BLEND_ZERO &&
+		blendState->alphaSourceBlend == FNA3D_BLEND_ONE &&
+		blendState->alphaDestinationBlend == FNA3D_BLEND_ZERO
+	);
+	if (colorAttachmentDescriptions[0].blend_state.enable_blend)
+	{
+		colorAttachmentDescriptions[0].blend_state.src_color_blendfactor = XNAToSDL_BlendFactor[
+			blendState->colorSourceBlend
+		];
+		colorAttachmentDescriptions[0].blend_state.src_alpha_blendfactor = XNAToSDL_BlendFactor[
+			blendState->alphaSourceBlend
+		];
+		colorAttachmentDescriptions[0].blend_state.dst_color_blendfactor = XNAToSDL_BlendFactor[
+			blendState->colorDestinationBlend
+		];
+		colorAttachmentDescriptions[0].blend_state.dst_alpha_blendfactor = XNAToSDL_BlendFactor[
+			blendState->alphaDestinationBlend
+		];
+
+		colorAttachmentDescriptions[0].blend_state.color_blend_op = XNAToSDL_BlendOp[
+			blendState->colorBlendFunction
+		];
+		colorAttachmentDescriptions[0].blend_state.alpha_blend_op = XNAToSDL_BlendOp[
+			blendState->alphaBlendFunction
+		];
+	}
+	else
+	{
+		colorAttachmentDescriptions[0].blend_state.src_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE;
+		colorAttachmentDescriptions[0].blend_state.src_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE;
+		colorAttachmentDescriptions[0].blend_state.dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ZERO;
+		colorAttachmentDescriptions[0].blend_state.dst_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ZERO;
+		colorAttachmentDescriptions[0].blend_state.color_blend_op = SDL_GPU_BLENDOP_ADD;
+		colorAttachmentDescriptions[0].blend_state.alpha_blend_op = SDL_GPU_BLENDOP_ADD;
+	}
+
+	colorAttachmentDescriptions[1].blend_state = colorAttachmentDescriptions[0].blend_state;
+	colorAttachmentDescriptions[2].blend_state = colorAttachmentDescriptions[0].blend_state;
+	colorAttachmentDescriptions[3].blend_state = colorAttachmentDescriptions[0].blend_state;
+
+	colorAttachmentDescriptions[0].blend_state.color_write_mask =
+		blendState->colorWriteEnable;
+	colorAttachmentDescriptions[1].blend_state.color_write_mask =
+		blendState->colorWriteEnable1;
+	colorAttachmentDescriptions[2].blend_state.color_write_mask =
+		blendState->colorWriteEnable2;
+	colorAttachmentDescriptions[3].blend_state.color_write_mask =
+		blendState->colorWriteEnable3;
+
+	/* FIXME: Can this be disabled when mask is R|G|B|A? -flibit */
+	colorAttachmentDescriptions[0].blend_state.enable_color_write_mask = true;
+	colorAttachmentDescriptions[1].blend_state.enable_color_write_mask = true;
+	colorAttachmentDescriptions[2].blend_state.enable_color_write_mask = true;
+	colorAttachmentDescriptions[3].blend_state.enable_color_write_mask = true;
+
+	colorAttachmentDescriptions[0].format = hash->colorFormats[0];
+	colorAttachmentDescriptions[1].format = hash->colorFormats[1];
+	colorAttachmentDescriptions[2].format = hash->colorFormats[2];
+	colorAttachmentDescriptions[3].format = hash->colorFormats[3];
+
+	createInfo->target_info.num_color_targets = hash->colorFormatCount;
+	createInfo->target_info.color_target_descriptions = colorAttachmentDescriptions;
+	createInfo->target_info.has_depth_stencil_target = hash->hasDepthStencilAttachment;
+	createInfo->target_info.depth_stencil_format = hash->depthStencilFormat;
+
+	/* Depth Stencil */
+
+	createInfo->depth_stencil_state.enable_depth_test =
+		depthStencilState->depthBufferEnable;
+	createInfo->depth_stencil_state.enable_depth_write =
+		depthStencilState->depthBufferWriteEnable;
+	createInfo->depth_stencil_state.compare_op = XNAToSDL_CompareOp[
+		depthStencilState->depthBufferFunction
+	];
+	createInfo->depth_stencil_state.enable_stencil_test =
+		depthStencilState->stencilEnable;
+
+	createInfo->depth_stencil_state.front_stencil_state.compare_op = XNAToSDL_CompareOp[
+		depthStencilState->stencilFunction
+	];
+	createInfo->depth_stencil_state.front_stencil_state.depth_fail_op = XNAToSDL_StencilOp[
+		depthStencilState->stencilDepthBufferFail
+	];
+	createInfo->depth_stencil_state.front_stencil_state.fail_op = XNAToSDL_StencilOp[
+		depthStencilState->stencilFail
+	];
+	createInfo->depth_stencil_state.front_stencil_state.pass_op = XNAToSDL_StencilOp[
+		depthStencilState->stencilPass
+	];
+
+	if (depthStencilState->twoSidedStencilMode)
+	{
+		createInfo->depth_stencil_state.back_stencil_state.compare_op = XNAToSDL_CompareOp[
+			depthStencilState->ccwStencilFunction
+		];
+		createInfo->depth_stencil_state.back_stencil_state.depth_fail_op = XNAToSDL_StencilOp[
+			depthStencilState->ccwStencilDepthBufferFail
+		];
+		createInfo->depth_stencil_state.back_stencil_state.fail_op = XNAToSDL_StencilOp[
+			depthStencilState->ccwStencilFail
+		];
+		createInfo->depth_stencil_state.back_stencil_state.pass_op = XNAToSDL_StencilOp[
+			depthStencilState->ccwStencilPass
+		];
+	}
+	else
+	{
+		createInfo->depth_stencil_state.back_stencil_state = createInfo->depth_stencil_state.front_stencil_state;
+	}
+
+	createInfo->depth_stencil_state.compare_mask =
+		depthStencilState->stencilMask;
+	createInfo->depth_stencil_state.write_mask =
+		depthStencilState->stencilWriteMask;
+
+	createInfo->props = 0;
+}
+
+/* Pipeline Cache */
+
+static uint64_t SDLGPU_INTERNAL_HashBytes(const uint8_t *data, size_t length)
+{
+	/* 64-bit FNV-1a */
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	size_t i;
+	for (i = 0; i < length; i += 1)
+	{
+		hash ^= data[i];
+		hash *= 0x100000001B3ULL;
+	}
+	return hash;
+}
+
+static int32_t SDLGPU_INTERNAL_FindShaderObject(
+	MOJOSHADER_effect *effect,
+	MOJOSHADER_symbolType type,
+	MOJOSHADER_sdlShaderData *shader
+) {
+	int32_t i;
+	const MOJOSHADER_effectObject *object;
+
+	if (shader == NULL)
+	{
+		return -1;
+	}
+
+	for (i = 0; i < effect->object_count; i += 1)
+	{
+		object = &effect->objects[i];
+		if (	object->type == type &&
+			!object->shader.is_preshader &&
+			object->shader.shader == shader	)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+static MOJOSHADER_sdlShaderData* SDLGPU_INTERNAL_GetShaderObject(
+	MOJOSHADER_effect *effect,
+	MOJOSHADER_symbolType type,
+	int32_t index
+) {
+	const MOJOSHADER_effectObject *object;
+
+	if (index < 0 || index >= effect->object_count)
+	{
+		return NULL;
+	}
+
+	object = &effect->objects[index];
+	if (object->type != type || object->shader.is_preshader)
+	{
+		return NULL;
+	}
+	return (MOJOSHADER_sdlShaderData*) object->shader.shader;
+}
+
+static int SDLCALL SDLGPU_INTERNAL_PipelineThread(void *data)
+{
+	SDLGPU_Renderer *renderer = (SDLGPU_Renderer*) data;
+	SDLGPU_PipelineJob *job;
+
+	SDL_LockMutex(renderer->pipelineJobLock);
+	while (1)
+	{
+		while (	renderer->pendingPipelineJobs == NULL &&
+			!renderer->pipelineThreadQuit	)
+		{
+			SDL_WaitCondition(
+				renderer->pipelineJobCondition,
+				renderer->pipelineJobLock
+			);
+		}
+		if (renderer->pendingPipelineJobs == NULL)
+		{
+			break;
+		}
+
+		job = renderer->pendingPipelineJobs;
+		renderer->pendingPipelineJobs = job->next;
+		if (renderer->pendingPipelineJobs == NULL)
+		{
+			renderer->pendingPipelineJobsTail = NULL;
+		}
+		SDL_UnlockMutex(renderer->pipelineJobLock);
+
+		job->pipeline = SDL_CreateGPUGraphicsPipeline(
+			renderer->device,
+			&job->createInfo
+		);
+
+		SDL_LockMutex(renderer->pipelineJobLock);
+		job->next = renderer->finishedPipelineJobs;
+		renderer->finishedPipelineJobs = job;
+		SDL_AddAtomicInt(&renderer->finishedPipelineJobCount, 1);
+		renderer->activePipelineJobs -= 1;
+		SDL_BroadcastCondition(renderer->pipelineDoneCondition);
+	}
+	SDL_UnlockMutex(renderer->pipelineJobLock);
+
+	return 0;
+}
+
+/* Blend constants and the stencil reference are set on the render pass, so
+ * pipelines that only differ in those draw exactly the same thing.
+ */
+static inline GraphicsPipelineHash SDLGPU_INTERNAL_GetCompatiblePipelineHash(
+	const GraphicsPipelineHash *hash
+) {
+	GraphicsPipelineHash result = *hash;
+	result.blendState.b &= 0xFFFFFFFF00000000ULL; /* blendFactor */
+	result.depthStencilState.b &= 0x00000000FFFFFFFFULL; /* referenceStencil */
+	return result;
+}
+
+static void SDLGPU_INTERNAL_InsertGraphicsPipeline(
+	SDLGPU_Renderer *renderer,
+	const GraphicsPipelineHash *hash,
+	SDL_GPUGraphicsPipeline *pipeline
+) {
+	GraphicsPipelineHash compatibleHash;
+
+	GraphicsPipelineHashTable_Insert(
+		&renderer->graphicsPipelineHashTable,
+		*hash,
+		pipeline
+	);
+
+	if (pipeline == NULL)
+	{
+		return;
+	}
+
+	compatibleHash = SDLGPU_INTERNAL_GetCompatiblePipelineHash(hash);
+	if (GraphicsPipelineHashTable_Fetch(
+		&renderer->compatiblePipelineHashTable,
+		compatibleHash
+	) == NULL) {
+		GraphicsPipelineHashTable_Insert(
+			&renderer->compatiblePipelineHashTable,
+			compatibleHash,
+			pipeline
+		);
+	}
+}
+
+static uint8_t SDLGPU_INTERNAL_IsPipelinePending(
+	SDLGPU_Renderer *renderer,
+	const GraphicsPipelineHash *hash
+) {
+	int32_t i;
+
+	for (i = 0; i < renderer->pendingPipelines.count; i += 1)
+	{
+		if (GraphicsPipelineHash_Equals(
+			hash,
+			&renderer->pendingPipelines.elements[i].key
+		)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* Moves a finished pipeline into the hash table and frees the job */
+static void SDLGPU_INTERNAL_FinishPipelineJob(
+	SDLGPU_Renderer *renderer,
+	SDLGPU_PipelineJob *job
+) {
+	GraphicsPipelineHashArray *arr = &renderer->pendingPipelines;
+	int32_t i;
+
+	for (i = 0; i < arr->count; i += 1)
+	{
+		if (GraphicsPipelineHash_Equals(&job->hash, &arr->elements[i].key))
+		{
+			arr->elements[i] = arr->elements[arr->count - 1];
+			arr->count -= 1;
+			break;
+		}
+	}
+
+	if (job->pipeline == NULL)
+	{
+		FNA3D_LogWarn("Failed to create cached graphics pipeline!");
+	}
+	else if (GraphicsPipelineHashTable_Fetch(
+		&renderer->graphicsPipelineHashTable,
+		job->hash
+	) != NULL) {
+		/* A draw needed it before the thread got to it */
+		SDL_ReleaseGPUGraphicsPipeline(
+			renderer->device,
+			job->pipeline
+		);
+	}
+	else
+	{
+		SDLGPU_INTERNAL_InsertGraphicsPipeline(
+			renderer,
+			&job->hash,
+			job->pipeline
+		);
+	}
+
+	SDL_free(job);
+}
+
+static void SDLGPU_INTERNAL_SubmitPipelineJob(
+	SDLGPU_Renderer *renderer,
+	SDLGPU_PipelineJob *job
+) {
+	GraphicsPipelineHashArray *arr = &renderer->pendingPipelines;
+
+	EXPAND_ARRAY_IF_NEEDED(arr, 16, GraphicsPipelineHashMap)
+
+	arr->elements[arr->count].key = job->hash;
+	arr->elements[arr->count].value = NULL;
+	arr->count += 1;
+
+	if (renderer->pipelineThreadCount == 0)
+	{
+		/* No threads to hand it to, just build it now */
+		job->pipeline = SDL_CreateGPUGraphicsPipeline(
+			renderer->device,
+			&job->createInfo
+		);
+		SDLGPU_INTERNAL_FinishPipelineJob(renderer, job);
+		return;
+	}
+
+	job->next = NULL;
+
+	SDL_LockMutex(renderer->pipelineJobLock);
+	if (renderer->pendingPipelineJobsTail == NULL)
+	{
+		renderer->pendingPipelineJobs = job;
+	}
+	else
+	{
+		renderer->pendingPipelineJobsTail->next = job;
+	}
+	renderer->pendingPipelineJobsTail = job;
+	renderer->activePipelineJobs += 1;
+	SDL_SignalCondition(renderer->pipelineJobCondition);
+	SDL_UnlockMutex(renderer->pipelineJobLock);
+}
+
+/* Moves pipelines the threads have finished into the hash table */
+static void SDLGPU_INTERNAL_CollectPipelineJobs(SDLGPU_Renderer *renderer)
+{
+	SDLGPU_PipelineJob *job, *next;
+
+	if (	renderer->pipelineThreadCount == 0 ||
+		SDL_GetAtomicInt(&renderer->finishedPipelineJobCount) == 0	)
+	{
+		return;
+	}
+
+	SDL_LockMutex(renderer->pipelineJobLock);
+	job = renderer->finishedPipelineJobs;
+	renderer->finishedPipelineJobs = NULL;
+	SDL_SetAtomicInt(&renderer->finishedPipelineJobCount, 0);
+	SDL_UnlockMutex(renderer->pipelineJobLock);
+
+	while (job != NULL)
+	{
+		next = job->next;
+		SDLGPU_INTERNAL_FinishPipelineJob(renderer, job);
+		job = next;
+	}
+}
+
+static void SDLGPU_INTERNAL_WaitForPipelineJobs(SDLGPU_Renderer *renderer)
+{
+	if (renderer->pipelineThreadCount == 0)
+	{
+		return;
+	}
+
+	SDL_LockMutex(renderer->pipelineJobLock);
+	while (renderer->activePipelineJobs > 0)
+	{
+		SDL_WaitCondition(
+			renderer->pipelineDoneCondition,
+			renderer->pipelineJobLock
+		);
+	}
+	SDL_UnlockMutex(renderer->pipelineJobLock);
+
+	SDLGPU_INTERNAL_CollectPipelineJobs(renderer);
+}
+
+/* Returns NULL if the pipeline couldn't be created */
+static SDL_GPUGraphicsPipeline* SDLGPU_INTERNAL_WaitForPipeline(
+	SDLGPU_Renderer *renderer,
+	const GraphicsPipelineHash *hash
+) {
+	SDLGPU_PipelineJob *job, *prev = NULL;
+
+	/* If no thread has started it yet, it's quicker to build it here */
+	SDL_LockMutex(renderer->pipelineJobLock);
+	for (job = renderer->pendingPipelineJobs; job != NULL; job = job->next)
+	{
+		if (GraphicsPipelineHash_Equals(hash, &job->hash))
+		{
+			break;
+		}
+		prev = job;
+	}
+	if (job != NULL)
+	{
+		if (prev == NULL)
+		{
+			renderer->pendingPipelineJobs = job->next;
+		}
+		else
+		{
+			prev->next = job->next;
+		}
+		if (renderer->pendingPipelineJobsTail == job)
+		{
+			renderer->pendingPipelineJobsTail = prev;
+		}
+		renderer->activePipelineJobs -= 1;
+	}
+	SDL_UnlockMutex(renderer->pipelineJobLock);
+
+	if (job != NULL)
+	{
+		job->pipeline = SDL_CreateGPUGraphicsPipeline(
+			renderer->device,
+			&job->createInfo
+		);
+		SDLGPU_INTERNAL_FinishPipelineJob(renderer, job);
+	}
+
+	/* Otherwise a thread is building it right now */
+	while (SDLGPU_INTERNAL_IsPipelinePending(renderer, hash))
+	{
+		SDL_LockMutex(renderer->pipelineJobLock);
+		while (renderer->finishedPipelineJobs == NULL)
+		{
+			SDL_WaitCondition(
+				renderer->pipelineDoneCondition,
+				renderer->pipelineJobLock
+			);
+		}
+		SDL_UnlockMutex(renderer->pipelineJobLock);
+
+		SDLGPU_INTERNAL_CollectPipelineJobs(renderer);
+	}
+
+	return GraphicsPipelineHashTable_Fetch(
+		&renderer->graphicsPipelineHashTable,
+		*hash
+	);
+}
+
+static void SDLGPU_INTERNAL_PackPipelineCacheStates(
+	PipelineCacheKey *key,
+	const FNA3D_BlendState *blendState,
+	const FNA3D_RasterizerState *rasterizerState,
+	const FNA3D_DepthStencilState *depthStencilState
+) {
+	PipelineCacheBlendState *blend = &key->blendState;
+	PipelineCacheRasterizerState *rasterizer = &key->rasterizerState;
+	PipelineCacheDepthStencilState *depthStencil = &key->depthStencilState;
+
+	blend->colorSourceBlend = blendState->colorSourceBlend;
+	blend->colorDestinationBlend = blendState->colorDestinationBlend;
+	blend->colorBlendFunction = blendState->colorBlendFunction;
+	blend->alphaSourceBlend = blendState->alphaSourceBlend;
+	blend->alphaDestinationBlend = blendState->alphaDestinationBlend;
+	blend->alphaBlendFunction = blendState->alphaBlendFunction;
+	blend->colorWriteEnable = blendState->colorWriteEnable;
+	blend->colorWriteEnable1 = blendState->colorWriteEnable1;
+	blend->colorWriteEnable2 = blendState->colorWriteEnable2;
+	blend->colorWriteEnable3 = blendState->colorWriteEnable3;
+	blend->blendFactor = (
+		(uint32_t) blendState->blendFactor.r |
+		((uint32_t) blendState->blendFactor.g << 8) |
+		((uint32_t) blendState->blendFactor.b << 16) |
+		((uint32_t) blendState->blendFactor.a << 24)
+	);
+	blend->multiSampleMask = (uint32_t) blendState->multiSampleMask;
+
+	rasterizer->fillMode = rasterizerState->fillMode;
+	rasterizer->cullMode = rasterizerState->cullMode;
+	rasterizer->depthBias = rasterizerState->depthBias;
+	rasterizer->slopeScaleDepthBias = rasterizerState->slopeScaleDepthBias;
+	rasterizer->scissorTestEnable = rasterizerState->scissorTestEnable;
+	rasterizer->multiSampleAntiAlias = rasterizerState->multiSampleAntiAlias;
+
+	depthStencil->depthBufferEnable = depthStencilState->depthBufferEnable;
+	depthStencil->depthBufferWriteEnable = depthStencilState->depthBufferWriteEnable;
+	depthStencil->depthBufferFunction = depthStencilState->depthBufferFunction;
+	depthStencil->stencilEnable = depthStencilState->stencilEnable;
+	depthStencil->stencilMask = (uint32_t) depthStencilState->stencilMask;
+	depthStencil->stencilWriteMask = (uint32_t) depthStencilState->stencilWriteMask;
+	depthStencil->twoSidedStencilMode = depthStencilState->twoSidedStencilMode;
+	depthStencil->stencilFail = depthStencilState->stencilFail;
+	depthStencil->stencilDepthBufferFail = depthStencilState->stencilDepthBufferFail;
+	depthStencil->stencilPass = depthStencilState->stencilPass;
+	depthStencil->stencilFunction = depthStencilState->stencilFunction;
+	depthStencil->ccwStencilFail = depthStencilState->ccwStencilFail;
+	depthStencil->ccwStencilDepthBufferFail = depthStencilState->ccwStencilDepthBufferFail;
+	depthStencil->ccwStencilPass = depthStencilState->ccwStencilPass;
+	depthStencil->ccwStencilFunction = depthStencilState->ccwStencilFunction;
+	depthStencil->referenceStencil = (uint32_t) depthStencilState->referenceStencil;
+}
+
+static void SDLGPU_INTERNAL_UnpackPipelineCacheStates(
+	const PipelineCacheKey *key,
+	FNA3D_BlendState *blendState,
+	FNA3D_RasterizerState *rasterizerState,
+	FNA3D_DepthStencilState *depthStencilState
+) {
+	const PipelineCacheBlendState *blend = &key->blendState;
+	const PipelineCacheRasterizerState *rasterizer = &key->rasterizerState;
+	const PipelineCacheDepthStencilState *depthStencil = &key->depthStencilState;
+
+	blendState->colorSourceBlend = (FNA3D_Blend) blend->colorSourceBlend;
+	blendState->colorDestinationBlend = (FNA3D_Blend) blend->colorDestinationBlend;
+	blendState->colorBlendFunction = (FNA3D_BlendFunction) blend->colorBlendFunction;
+	blendState->alphaSourceBlend = (FNA3D_Blend) blend->alphaSourceBlend;
+	blendState->alphaDestinationBlend = (FNA3D_Blend) blend->alphaDestinationBlend;
+	blendState->alphaBlendFunction = (FNA3D_BlendFunction) blend->alphaBlendFunction;
+	blendState->colorWriteEnable = (FNA3D_ColorWriteChannels) blend->colorWriteEnable;
+	blendState->colorWriteEnable1 = (FNA3D_ColorWriteChannels) blend->colorWriteEnable1;
+	blendState->colorWriteEnable2 = (FNA3D_ColorWriteChannels) blend->colorWriteEnable2;
+	blendState->colorWriteEnable3 = (FNA3D_ColorWriteChannels) blend->colorWriteEnable3;
+	blendState->blendFactor.r = (uint8_t) blend->blendFactor;
+	blendState->blendFactor.g = (uint8_t) (blend->blendFactor >> 8);
+	blendState->blendFactor.b = (uint8_t) (blend->blendFactor >> 16);
+	blendState->blendFactor.a = (uint8_t) (blend->blendFactor >> 24);
+	blendState->multiSampleMask = (int32_t) blend->multiSampleMask;
+
+	rasterizerState->fillMode = (FNA3D_FillMode) rasterizer->fillMode;
+	rasterizerState->cullMode = (FNA3D_CullMode) rasterizer->cullMode;
+	rasterizerState->depthBias = rasterizer->depthBias;
+	rasterizerState->slopeScaleDepthBias = rasterizer->slopeScaleDepthBias;
+	rasterizerState->scissorTestEnable = (uint8_t) rasterizer->scissorTestEnable;
+	rasterizerState->multiSampleAntiAlias = (uint8_t) rasterizer->multiSampleAntiAlias;
+
+	depthStencilState->depthBufferEnable = (uint8_t) depthStencil->depthBufferEnable;
+	depthStencilState->depthBufferWriteEnable = (uint8_t) depthStencil->depthBufferWriteEnable;
+	depthStencilState->depthBufferFunction = (FNA3D_CompareFunction) depthStencil->depthBufferFunction;
+	depthStencilState->stencilEnable = (uint8_t) depthStencil->stencilEnable;
+	depthStencilState->stencilMask = (int32_t) depthStencil->stencilMask;
+	depthStencilState->stencilWriteMask = (int32_t) depthStencil->stencilWriteMask;
+	depthStencilState->twoSidedStencilMode = (uint8_t) depthStencil->twoSidedStencilMode;
+	depthStencilState->stencilFail = (FNA3D_StencilOperation) depthStencil->stencilFail;
+	depthStencilState->stencilDepthBufferFail = (FNA3D_StencilOperation) depthStencil->stencilDepthBufferFail;
+	depthStencilState->stencilPass = (FNA3D_StencilOperation) depthStencil->stencilPass;
+	depthStencilState->stencilFunction = (FNA3D_CompareFunction) depthStencil->stencilFunction;
+	depthStencilState->ccwStencilFail = (FNA3D_StencilOperation) depthStencil->ccwStencilFail;
+	depthStencilState->ccwStencilDepthBufferFail = (FNA3D_StencilOperation) depthStencil->ccwStencilDepthBufferFail;
+	depthStencilState->ccwStencilPass = (FNA3D_StencilOperation) depthStencil->ccwStencilPass;
+	depthStencilState->ccwStencilFunction = (FNA3D_CompareFunction) depthStencil->ccwStencilFunction;
+	depthStencilState->referenceStencil = (int32_t) depthStencil->referenceStencil;
+}
+
+static void SDLGPU_INTERNAL_GetPipelineCacheHash(
+	const PipelineCacheKey *key,
+	const FNA3D_BlendState *blendState,
+	const FNA3D_RasterizerState *rasterizerState,
+	const FNA3D_DepthStencilState *depthStencilState,
+	int32_t vertexBufferBindingsIndex,
+	SDL_GPUShader *vertShader,
+	SDL_GPUShader *fragShader,
+	GraphicsPipelineHash *hash
+) {
+	int32_t i;
+
+	hash->blendState = GetPackedBlendState(*blendState);
+	hash->depthStencilState = GetPackedDepthStencilState(*depthStencilState);
+	hash->rasterizerState = GetPackedRasterizerState(
+		*rasterizerState,
+		rasterizerState->depthBias
+	);
+	hash->vertexBufferBindingsIndex = vertexBufferBindingsIndex;
+	hash->primitiveType = (FNA3D_PrimitiveType) key->primitiveType;
+	hash->sampleCount = (SDL_GPUSampleCount) key->sampleCount;
+	hash->sampleMask = key->sampleMask;
+	hash->vertShader = vertShader;
+	hash->fragShader = fragShader;
+	for (i = 0; i < MAX_RENDERTARGET_BINDINGS; i += 1)
+	{
+		hash->colorFormats[i] = (SDL_GPUTextureFormat) key->colorFormats[i];
+	}
+	hash->colorFormatCount = key->colorFormatCount;
+	hash->hasDepthStencilAttachment = key->hasDepthStencilAttachment;
+	hash->depthStencilFormat = (SDL_GPUTextureFormat) key->depthStencilFormat;
+}
+
+static uint8_t SDLGPU_INTERNAL_PipelineCacheEntryEquals(
+	const PipelineCacheEntry *a,
+	const PipelineCacheEntry *b
+) {
+	return (
+		SDL_memcmp(&a->key, &b->key, sizeof(PipelineCacheKey)) == 0 &&
+		SDL_memcmp(
+			a->vertexBindings,
+			b->vertexBindings,
+			a->key.numVertexBindings * sizeof(PipelineCacheVertexBinding)
+		) == 0
+	);
+}
+
+static PipelineCacheVertexBinding* SDLGPU_INTERNAL_GetPipelineCacheBindings(
+	const FNA3D_VertexBufferBinding *vertexBindings,
+	uint32_t numVertexBindings
+) {
+	PipelineCacheVertexBinding *result, *binding;
+	uint32_t i;
+
+	result = (PipelineCacheVertexBinding*) SDL_calloc(
+		SDL_max(numVertexBindings, 1),
+		sizeof(PipelineCacheVertexBinding)
+	);
+	for (i = 0; i < numVertexBindings; i += 1)
+	{
+		binding = &result[i];
+		binding->vertexStride = vertexBindings[i].vertexDeclaration.vertexStride;
+		binding->instanceFrequency = vertexBindings[i].instanceFrequency;
+		binding->elementCount = SDL_min(
+			vertexBindings[i].vertexDeclaration.elementCount,
+			MAX_VERTEX_ATTRIBUTES
+		);
+		SDL_memcpy(
+			binding->elements,
+			vertexBindings[i].vertexDeclaration.elements,
+			binding->elementCount * sizeof(FNA3D_VertexElement)
+		);
+	}
+	return result;
+}
+
+static uint64_t SDLGPU_INTERNAL_GetPipelineCacheEntryHashCode(
+	const PipelineCacheEntry *entry
+) {
+	/* Bindings are calloc'd, so the unused elements are always zero */
+	return (
+		SDLGPU_INTERNAL_HashBytes(
+			(const uint8_t*) &entry->key,
+			sizeof(PipelineCacheKey)
+		) * 97 +
+		SDLGPU_INTERNAL_HashBytes(
+			(const uint8_t*) entry->vertexBindings,
+			entry->key.numVertexBindings * sizeof(PipelineCacheVertexBinding)
+		)
+	);
+}
+
+/* Takes ownership of entry->vertexBindings */
+static void SDLGPU_INTERNAL_AddPipelineCacheEntry(
+	SDLGPU_Renderer *renderer,
+	const PipelineCacheEntry *entry
+) {
+	PipelineCacheEntryArray *arr = &renderer->pipelineCache;
+	PipelineCacheIndexArray *bucket = &renderer->pipelineCacheBuckets[
+		SDLGPU_INTERNAL_GetPipelineCacheEntryHashCode(entry) %
+		NUM_PIPELINE_HASH_BUCKETS
+	];
+	int32_t i;
+
+	/* Loaded entries can still miss if the thread hasn't finished them */
+	for (i = 0; i < bucket->count; i += 1)
+	{
+		if (SDLGPU_INTERNAL_PipelineCacheEntryEquals(
+			&arr->elements[bucket->elements[i]],
+			entry
+		)) {
+			SDL_free(entry->vertexBindings);
+			return;
+		}
+	}
+
+	EXPAND_ARRAY_IF_NEEDED(arr, 16, PipelineCacheEntry)
+	EXPAND_ARRAY_IF_NEEDED(bucket, 2, int32_t)
+
+	bucket->elements[bucket->count] = arr->count;
+	bucket->count += 1;
+
+	arr->elements[arr->count] = *entry;
+	arr->count += 1;
+}
+
+static void SDLGPU_INTERNAL_RecordPipeline(
+	SDLGPU_Renderer *renderer,
+	const GraphicsPipelineHash *hash
+) {
+	MOJOSHADER_sdlShaderData *vertShader, *fragShader;
+	PipelineCacheEntry entry;
+	int32_t i;
+
+	if (renderer->pipelineCachePath == NULL || renderer->currentEffect == NULL)
+	{
+		return;
+	}
+
+	SDL_zero(entry.key);
+
+	/* Shaders bound outside of the current effect can't be looked up again */
+	MOJOSHADER_sdlGetBoundShaderData(
+		renderer->mojoshaderContext,
+		&vertShader,
+		&fragShader
+	);
+	entry.key.vertexShaderIndex = SDLGPU_INTERNAL_FindShaderObject(
+		renderer->currentEffect,
+		MOJOSHADER_SYMTYPE_VERTEXSHADER,
+		vertShader
+	);
+	entry.key.fragmentShaderIndex = SDLGPU_INTERNAL_FindShaderObject(
+		renderer->currentEffect,
+		MOJOSHADER_SYMTYPE_PIXELSHADER,
+		fragShader
+	);
+	if (entry.key.vertexShaderIndex < 0 || entry.key.fragmentShaderIndex < 0)
+	{
+		return;
+	}
+
+	entry.key.effectHash = renderer->currentEffectHash;
+	SDLGPU_INTERNAL_PackPipelineCacheStates(
+		&entry.key,
+		&renderer->fnaBlendState,
+		&renderer->fnaRasterizerState,
+		&renderer->fnaDepthStencilState
+	);
+	entry.key.primitiveType = hash->primitiveType;
+	entry.key.sampleCount = hash->sampleCount;
+	entry.key.sampleMask = hash->sampleMask;
+	for (i = 0; i < MAX_RENDERTARGET_BINDINGS; i += 1)
+	{
+		entry.key.colorFormats[i] = hash->colorFormats[i];
+	}
+	entry.key.colorFormatCount = hash->colorFormatCount;
+	entry.key.hasDepthStencilAttachment = hash->hasDepthStencilAttachment;
+	entry.key.depthStencilFormat = hash->depthStencilFormat;
+	entry.key.numVertexBindings = renderer->numVertexBindings;
+	entry.vertexBindings = SDLGPU_INTERNAL_GetPipelineCacheBindings(
+		renderer->vertexBindings,
+		renderer->numVertexBindings
+	);
+
+	SDLGPU_INTERNAL_AddPipelineCacheEntry(renderer, &entry);
+}
+
+/* Links the entry's shaders and queues its pipeline for creation. This binds
+ * the shaders, so callers have to restore them and relink afterward.
+ */
+static void SDLGPU_INTERNAL_QueuePipeline(
+	SDLGPU_Renderer *renderer,
+	MOJOSHADER_effect *effect,
+	const PipelineCacheEntry *entry
+) {
+	MOJOSHADER_sdlShaderData *vertShader, *fragShader;
+	FNA3D_VertexBufferBinding bindings[MAX_BOUND_VERTEX_BUFFERS];
+	FNA3D_BlendState blendState;
+	FNA3D_RasterizerState rasterizerState;
+	FNA3D_DepthStencilState depthStencilState;
+	SDLGPU_PipelineJob *job;
+	int32_t bindingsIndex;
+	uint32_t bindingsHash;
+	int32_t i;
+
+	vertShader = SDLGPU_INTERNAL_GetShaderObject(
+		effect,
+		MOJOSHADER_SYMTYPE_VERTEXSHADER,
+		entry->key.vertexShaderIndex
+	);
+	fragShader = SDLGPU_INTERNAL_GetShaderObject(
+		effect,
+		MOJOSHADER_SYMTYPE_PIXELSHADER,
+		entry->key.fragmentShaderIndex
+	);
+	if (vertShader == NULL || fragShader == NULL)
+	{
+		return;
+	}
+
+	MOJOSHADER_sdlBindShaders(
+		renderer->mojoshaderContext,
+		vertShader,
+		fragShader
+	);
+
+	for (i = 0; i < (int32_t) entry->key.numVertexBindings; i += 1)
+	{
+		bindings[i].vertexBuffer = NULL;
+		bindings[i].vertexOffset = 0;
+		bindings[i].instanceFrequency = entry->vertexBindings[i].instanceFrequency;
+		bindings[i].vertexDeclaration.vertexStride = entry->vertexBindings[i].vertexStride;
+		bindings[i].vertexDeclaration.elementCount = entry->vertexBindings[i].elementCount;
+		bindings[i].vertexDeclaration.elements = entry->vertexBindings[i].elements;
+	}
+
+	/* Same as ApplyVertexBufferBindings, so the hashes will match */
+	if (PackedVertexBufferBindingsArray_Fetch(
+		renderer->vertexBufferBindingsCache,
+		bindings,
+		entry->key.numVertexBindings,
+		vertShader,
+		&bindingsIndex,
+		&bindingsHash
+	) == NULL) {
+		PackedVertexBufferBindingsArray_Insert(
+			&renderer->vertexBufferBindingsCache,
+			bindings,
+			entry->key.numVertexBindings,
+			vertShader,
+			(void*) 69420
+		);
+	}
+
+	job = (SDLGPU_PipelineJob*) SDL_calloc(1, sizeof(SDLGPU_PipelineJob));
+	if (!SDLGPU_INTERNAL_GenerateVertexInputInfo(
+		renderer,
+		bindings,
+		entry->key.numVertexBindings,
+		job->vertexBindings,
+		job->vertexAttributes,
+		&job->createInfo.vertex_input_state.num_vertex_attributes
+	)) {
+		SDL_free(job);
+		return;
+	}
+	MOJOSHADER_sdlGetShaders(
+		renderer->mojoshaderContext,
+		&job->createInfo.vertex_shader,
+		&job->createInfo.fragment_shader
+	);
+
+	SDLGPU_INTERNAL_UnpackPipelineCacheStates(
+		&entry->key,
+		&blendState,
+		&rasterizerState,
+		&depthStencilState
+	);
+	SDLGPU_INTERNAL_GetPipelineCacheHash(
+		&entry->key,
+		&blendState,
+		&rasterizerState,
+		&depthStencilState,
+		bindingsIndex,
+		job->createInfo.vertex_shader,
+		job->createInfo.fragment_shader,
+		&job->hash
+	);
+	if (	GraphicsPipelineHashTable_Fetch(
+			&renderer->graphicsPipelineHashTable,
+			job->hash
+		) != NULL ||
+		SDLGPU_INTERNAL_IsPipelinePending(renderer, &job->hash)	)
+	{
+		SDL_free(job);
+		return;
+	}
+
+	job->createInfo.vertex_input_state.vertex_buffer_descriptions = job->vertexBindings;
+	job->createInfo.vertex_input_state.num_vertex_buffers = entry->key.numVertexBindings;
+	job->createInfo.vertex_input_state.vertex_attributes = job->vertexAttributes;
+	SDLGPU_INTERNAL_FillGraphicsPipelineCreateInfo(
+		&job->hash,
+		&blendState,
+		&rasterizerState,
+		&depthStencilState,
+		&job->createInfo,
+		job->colorAttachmentDescriptions
+	);
+
+	SDLGPU_INTERNAL_SubmitPipelineJob(renderer, job);
+}
+
+/* Links every cached pipeline for this effect and queues it for creation */
+static void SDLGPU_INTERNAL_PrewarmEffect(
+	SDLGPU_Renderer *renderer,
+	SDLGPU_Effect *effect
+) {
+	MOJOSHADER_sdlShaderData *oldVertShader = NULL, *oldFragShader = NULL;
+	PipelineCacheEntry *entry;
+	uint8_t shadersChanged = 0;
+	int32_t i;
+
+	for (i = 0; i < renderer->pipelineCache.count; i += 1)
+	{
+		entry = &renderer->pipelineCache.elements[i];
+		if (entry->key.effectHash != effect->hash)
+		{
+			continue;
+		}
+
+		if (!shadersChanged)
+		{
+			MOJOSHADER_sdlGetBoundShaderData(
+				renderer->mojoshaderContext,
+				&oldVertShader,
+				&oldFragShader
+			);
+			shadersChanged = 1;
+		}
+		SDLGPU_INTERNAL_QueuePipeline(renderer, effect->effect, entry);
+	}
+
+	if (shadersChanged)
+	{
+		/* The linked program changed too, so force a relink on the next draw */
+		MOJOSHADER_sdlBindShaders(
+			renderer->mojoshaderContext,
+			oldVertShader,
+			oldFragShader
+		);
+		renderer->needNewGraphicsPipeline = 1;
+	}
+}
+
+static void SDLGPU_INTERNAL_GetPipelineCacheHeader(
+	SDLGPU_Renderer *renderer,
+	PipelineCacheHeader *header
+) {
+	SDL_zerop(header);
+	header->magic = PIPELINE_CACHE_MAGIC;
+	header->version = PIPELINE_CACHE_VERSION;
+	header->keySize = sizeof(PipelineCacheKey);
+	SDL_strlcpy(
+		header->deviceDriver,
+		SDL_GetGPUDeviceDriver(renderer->device),
+		sizeof(header->deviceDriver)
+	);
+}
+
+/* Returns the number of bytes read, or 0 if the entry is invalid */
+static size_t SDLGPU_INTERNAL_ReadPipelineCacheEntry(
+	const uint8_t *data,
+	size_t size,
+	PipelineCacheEntry *entry
+) {
+	const size_t bindingHeaderSize = offsetof(PipelineCacheVertexBinding, elements);
+	PipelineCacheVertexBinding *binding;
+	size_t offset, elementsSize;
+	uint32_t i;
+
+	if (size < sizeof(PipelineCacheKey))
+	{
+		return 0;
+	}
+	SDL_memcpy(&entry->key, data, sizeof(PipelineCacheKey));
+	offset = sizeof(PipelineCacheKey);
+
+	if (	entry->key.numVertexBindings > MAX_BOUND_VERTEX_BUFFERS ||
+		entry->key.colorFormatCount > MAX_RENDERTARGET_BINDINGS	)
+	{
+		return 0;
+	}
+
+	entry->vertexBindings = (PipelineCacheVertexBinding*) SDL_calloc(
+		SDL_max(entry->key.numVertexBindings, 1),
+		sizeof(PipelineCacheVertexBinding)
+	);
+	for (i = 0; i < entry->key.numVertexBindings; i += 1)
+	{
+		binding = &entry->vertexBindings[i];
+		if (size - offset < bindingHeaderSize)
+		{
+			break;
+		}
+		SDL_memcpy(binding, data + offset, bindingHeaderSize);
+		offset += bindingHeaderSize;
+
+		if (	binding->elementCount < 0 ||
+			binding->elementCount > MAX_VERTEX_ATTRIBUTES	)
+		{
+			break;
+		}
+		elementsSize = binding->elementCount * sizeof(FNA3D_VertexElement);
+		if (size - offset < elementsSize)
+		{
+			break;
+		}
+		SDL_memcpy(binding->elements, data + offset, elementsSize);
+		offset += elementsSize;
+	}
+
+	if (i < entry->key.numVertexBindings)
+	{
+		SDL_free(entry->vertexBindings);
+		return 0;
+	}
+	return offset;
+}
+
+static void SDLGPU_INTERNAL_LoadPipelineCache(SDLGPU_Renderer *renderer)
+{
+	PipelineCacheEntryArray *arr = &renderer->pipelineCache;
+	PipelineCacheHeader header, expected;
+	PipelineCacheEntry entry;
+	uint8_t *data;
+	size_t size, offset, entrySize;
+	uint32_t i;
+
+	data = (uint8_t*) SDL_LoadFile(renderer->pipelineCachePath, &size);
+	if (data == NULL)
+	{
+		FNA3D_LogInfo(
+			"Pipeline cache %s not found, starting a new one",
+			renderer->pipelineCachePath
+		);
+		return;
+	}
+
+	/* The body hash catches files that were cut short by a crash */
+	SDLGPU_INTERNAL_GetPipelineCacheHeader(renderer, &expected);
+	if (size >= sizeof(PipelineCacheHeader))
+	{
+		SDL_memcpy(&header, data, sizeof(PipelineCacheHeader));
+		expected.entryCount = header.entryCount;
+		expected.bodyHash = SDLGPU_INTERNAL_HashBytes(
+			data + sizeof(PipelineCacheHeader),
+			size - sizeof(PipelineCacheHeader)
+		);
+	}
+	if (	size < sizeof(PipelineCacheHeader) ||
+		SDL_memcmp(&header, &expected, sizeof(PipelineCacheHeader)) != 0 ||
+		header.entryCount > PIPELINE_CACHE_MAX_ENTRIES	)
+	{
+		FNA3D_LogWarn(
+			"Pipeline cache %s is invalid or out of date, ignoring",
+			renderer->pipelineCachePath
+		);
+		SDL_free(data);
+		return;
+	}
+
+	offset = sizeof(PipelineCacheHeader);
+	for (i = 0; i < header.entryCount; i += 1)
+	{
+		entrySize = SDLGPU_INTERNAL_ReadPipelineCacheEntry(
+			data + offset,
+			size - offset,
+			&entry
+		);
+		if (entrySize == 0)
+		{
+			break;
+		}
+		offset += entrySize;
+
+		SDLGPU_INTERNAL_AddPipelineCacheEntry(renderer, &entry);
+	}
+
+	FNA3D_LogInfo(
+		"Loaded %d of %u cached pipelines from %s",
+		arr->count,
+		header.entryCount,
+		renderer->pipelineCachePath
+	);
+	SDL_free(data);
+}
+
+static void SDLGPU_INTERNAL_SavePipelineCache(SDLGPU_Renderer *renderer)
+{
+	const size_t bindingHeaderSize = offsetof(PipelineCacheVertexBinding, elements);
+	PipelineCacheHeader header;
+	PipelineCacheEntry *entry;
+	uint8_t *data;
+	size_t size, offset, elementsSize;
+	int32_t i;
+	uint32_t j;
+
+	size = sizeof(PipelineCacheHeader);
+	for (i = 0; i < renderer->pipelineCache.count; i += 1)
+	{
+		entry = &renderer->pipelineCache.elements[i];
+		size += sizeof(PipelineCacheKey);
+		for (j = 0; j < entry->key.numVertexBindings; j += 1)
+		{
+			size += bindingHeaderSize;
+			size += entry->vertexBindings[j].elementCount * sizeof(FNA3D_VertexElement);
+		}
+	}
+
+	data = (uint8_t*) SDL_malloc(size);
+	offset = sizeof(PipelineCacheHeader);
+	for (i = 0; i < renderer->pipelineCache.count; i += 1)
+	{
+		entry = &renderer->pipelineCache.elements[i];
+		SDL_memcpy(data + offset, &entry->key, sizeof(PipelineCacheKey));
+		offset += sizeof(PipelineCacheKey);
+		for (j = 0; j < entry->key.numVertexBindings; j += 1)
+		{
+			SDL_memcpy(data + offset, &entry->vertexBindings[j], bindingHeaderSize);
+			offset += bindingHeaderSize;
+
+			elementsSize = entry->vertexBindings[j].elementCount * sizeof(FNA3D_VertexElement);
+			SDL_memcpy(data + offset, entry->vertexBindings[j].elements, elementsSize);
+			offset += elementsSize;
+		}
+	}
+
+	SDLGPU_INTERNAL_GetPipelineCacheHeader(renderer, &header);
+	header.entryCount = renderer->pipelineCache.count;
+	header.bodyHash = SDLGPU_INTERNAL_HashBytes(
+		data + sizeof(PipelineCacheHeader),
+		size - sizeof(PipelineCacheHeader)
+	);
+	SDL_memcpy(data, &header, sizeof(PipelineCacheHeader));
+
+	if (SDL_SaveFile(renderer->pipelineCachePath, data, size))
+	{
+		FNA3D_LogInfo(
+			"Saved %d pipelines to %s",
+			renderer->pipelineCache.count,
+			renderer->pipelineCachePath
+		);
+	}
+	else
+	{
+		FNA3D_LogWarn(
+			"Could not write pipeline cache %s: %s",
+			renderer->pipelineCachePath,
+			SDL_GetError()
+		);
+	}
+	SDL_free(data);
+}
+
+/* Starts the pipeline threads if they aren't running yet. If none can be
+ * started, pipelines get built on the calling thread instead.
+ */
+static uint8_t SDLGPU_INTERNAL_StartPipelineThreads(SDLGPU_Renderer *renderer)
+{
+	int32_t count, i;
+
+	if (renderer->pipelineThreadCount > 0)
+	{
+		return 1;
+	}
+
+	/* Leave a core for the render thread */
+	count = SDL_clamp(
+		SDL_GetNumLogicalCPUCores() - 1,
+		1,
+		MAX_PIPELINE_THREADS
+	);
+
+	renderer->pipelineJobLock = SDL_CreateMutex();
+	renderer->pipelineJobCondition = SDL_CreateCondition();
+	renderer->pipelineDoneCondition = SDL_CreateCondition();
+	renderer->pipelineThreadQuit = 0;
+	SDL_SetAtomicInt(&renderer->finishedPipelineJobCount, 0);
+	for (i = 0; i < count; i += 1)
+	{
+		renderer->pipelineThreads[i] = SDL_CreateThread(
+			SDLGPU_INTERNAL_PipelineThread,
+			"FNA3D Pipelines",
+			renderer
+		);
+		if (renderer->pipelineThreads[i] == NULL)
+		{
+			break;
+		}
+	}
+
+	if (i == 0)
+	{
+		FNA3D_LogWarn(
+			"Could not start pipeline thread: %s",
+			SDL_GetError()
+		);
+		SDL_DestroyCondition(renderer->pipelineDoneCondition);
+		SDL_DestroyCondition(renderer->pipelineJobCondition);
+		SDL_DestroyMutex(renderer->pipelineJobLock);
+		return 0;
+	}
+
+	renderer->pipelineThreadCount = i;
+	return 1;
+}
+
+static void SDLGPU_INTERNAL_StopPipelineThreads(SDLGPU_Renderer *renderer)
+{
+	int32_t i;
+
+	if (renderer->pipelineThreadCount == 0)
+	{
+		return;
+	}
+
+	SDLGPU_INTERNAL_WaitForPipelineJobs(renderer);
 
-			attribLoc = MOJOSHADER_sdlGetVertexAttribLocation(
-				vertexShader,
-				VertexAttribUsage(usage),
-				index
-			);
+	SDL_LockMutex(renderer->pipelineJobLock);
+	renderer->pipelineThreadQuit = 1;
+	SDL_BroadcastCondition(renderer->pipelineJobCondition);
+	SDL_UnlockMutex(renderer->pipelineJobLock);
+	for (i = 0; i < renderer->pipelineThreadCount; i += 1)
+	{
+		SDL_WaitThread(renderer->pipelineThreads[i], NULL);
+	}
+	renderer->pipelineThreadCount = 0;
 
-			if (attribLoc == -1)
-			{
-				/* Stream not in use! */
-				continue;
-			}
+	SDL_DestroyCondition(renderer->pipelineDoneCondition);
+	SDL_DestroyCondition(renderer->pipelineJobCondition);
+	SDL_DestroyMutex(renderer->pipelineJobLock);
+}
 
-			attributes[attributeDescriptionCounter].location = attribLoc;
-			attributes[attributeDescriptionCounter].format = XNAToSDL_VertexAttribType[
-				element.vertexElementFormat
-			];
-			attributes[attributeDescriptionCounter].offset = element.offset;
-			attributes[attributeDescriptionCounter].buffer_slot = i;
+static void SDLGPU_INTERNAL_InitPipelineCache(
+	SDLGPU_Renderer *renderer,
+	const char *path
+) {
+	SDLGPU_INTERNAL_StartPipelineThreads(renderer);
 
-			mojoshaderVertexAttributes[attributeDescriptionCounter].usage = VertexAttribUsage(element.vertexElementUsage);
-			mojoshaderVertexAttributes[attributeDescriptionCounter].vertexElementFormat = (MOJOSHADER_vertexElementFormat) element.vertexElementFormat; /* FNA3D/MojoShader use the same enum values */
-			mojoshaderVertexAttributes[attributeDescriptionCounter].usageIndex = index;
+	renderer->pipelineCachePath = SDL_strdup(path);
+	SDLGPU_INTERNAL_LoadPipelineCache(renderer);
+}
 
-			attributeDescriptionCounter += 1;
-		}
+static void SDLGPU_INTERNAL_QuitPipelineCache(SDLGPU_Renderer *renderer)
+{
+	int32_t i;
 
-		bindings[i].slot = i;
-		bindings[i].pitch = vertexDeclaration.vertexStride;
+	SDLGPU_INTERNAL_StopPipelineThreads(renderer);
+	SDL_free(renderer->pendingPipelines.elements);
+	for (i = 0; i < NUM_PIPELINE_HASH_BUCKETS; i += 1)
+	{
+		SDL_free(renderer->compatiblePipelineHashTable.buckets[i].elements);
+	}
 
-		if (renderer->vertexBindings[i].instanceFrequency > 0)
-		{
-			if (renderer->vertexBindings[i].instanceFrequency > 1)
-			{
-				FNA3D_LogError("Vertex instanceFrequency must be either 0 or 1!");
-			}
-			bindings[i].input_rate =
-				SDL_GPU_VERTEXINPUTRATE_INSTANCE;
-			bindings[i].instance_step_rate = 0;
-		}
-		else
-		{
-			bindings[i].input_rate =
-				SDL_GPU_VERTEXINPUTRATE_VERTEX;
-			bindings[i].instance_step_rate = 0; /* should be ignored */
-		}
+	if (renderer->pipelineCachePath == NULL)
+	{
+		return;
 	}
 
-	*attributeCount = attributeDescriptionCounter;
+	SDLGPU_INTERNAL_SavePipelineCache(renderer);
 
-	MOJOSHADER_sdlLinkProgram(
-		renderer->mojoshaderContext,
-		mojoshaderVertexAttributes,
-		attributeDescriptionCounter
+	for (i = 0; i < renderer->pipelineCache.count; i += 1)
+	{
+		SDL_free(renderer->pipelineCache.elements[i].vertexBindings);
+	}
+	SDL_free(renderer->pipelineCache.elements);
+	for (i = 0; i < NUM_PIPELINE_HASH_BUCKETS; i += 1)
+	{
+		SDL_free(renderer->pipelineCacheBuckets[i].elements);
+	}
+	SDL_free(renderer->pipelineCachePath);
+}
+
+/* Finds a pipeline that can stand in for one that is still being built. It
+ * has to match in everything but the dynamic state, so the draw looks the same.
+ */
+static SDL_GPUGraphicsPipeline* SDLGPU_INTERNAL_FindCompatiblePipeline(
+	SDLGPU_Renderer *renderer,
+	const GraphicsPipelineHash *hash
+) {
+	return GraphicsPipelineHashTable_Fetch(
+		&renderer->compatiblePipelineHashTable,
+		SDLGPU_INTERNAL_GetCompatiblePipelineHash(hash)
 	);
 }
 
 static SDL_GPUGraphicsPipeline* SDLGPU_INTERNAL_FetchGraphicsPipeline(
-	SDLGPU_Renderer *renderer
+	SDLGPU_Renderer *renderer,
+	uint8_t *temporary
 ) {
 	MOJOSHADER_sdlShaderData *vertShader, *fragShader;
 	GraphicsPipelineHash hash;
@@ -1528,8 +3042,13 @@ static SDL_GPUGraphicsPipeline* SDLGPU_INTERNAL_FetchGraphicsPipeline(
 	SDL_GPUColorTargetDescription colorAttachmentDescriptions[MAX_RENDERTARGET_BINDINGS];
 	SDL_GPUVertexBufferDescription *vertexBindings;
 	SDL_GPUVertexAttribute *vertexAttributes;
+	SDLGPU_PipelineJob *job;
 	int32_t i;
 
+	*temporary = 0;
+
+	SDLGPU_INTERNAL_CollectPipelineJobs(renderer);
+
 	vertexBindings = SDL_malloc(
 		renderer->numVertexBindings *
 		sizeof(SDL_GPUVertexBufferDescription)
@@ -1543,6 +3062,8 @@ static SDL_GPUGraphicsPipeline* SDLGPU_INTERNAL_FetchGraphicsPipeline(
 	/* We have to do this to link the vertex attribute modified shader program */
 	SDLGPU_INTERNAL_GenerateVertexInputInfo(
 		renderer,
+		renderer->vertexBindings,
+		renderer->numVertexBindings,
 		vertexBindings,
 		vertexAttributes,
 		&createInfo.vertex_input_state.num_vertex_attributes
@@ -1605,162 +3126,72 @@ static SDL_GPUGraphicsPipeline* SDLGPU_INTERNAL_FetchGraphicsPipeline(
 		return pipeline;
 	}
 
-	createInfo.primitive_type = XNAToSDL_PrimitiveType[renderer->fnaPrimitiveType];
-
 	/* Vertex Input State */
 
 	createInfo.vertex_input_state.vertex_buffer_descriptions = vertexBindings;
 	createInfo.vertex_input_state.num_vertex_buffers = renderer->numVertexBindings;
 	createInfo.vertex_input_state.vertex_attributes = vertexAttributes;
 
-	/* Rasterizer */
-
-	createInfo.rasterizer_state.cull_mode = XNAToSDL_CullMode[renderer->fnaRasterizerState.cullMode];
-	createInfo.rasterizer_state.depth_bias_clamp = 0.0f;
-	createInfo.rasterizer_state.depth_bias_constant_factor = renderer->fnaRasterizerState.depthBias;
-	createInfo.rasterizer_state.enable_depth_bias = 1;
-	createInfo.rasterizer_state.enable_depth_clip = 1;
-	createInfo.rasterizer_state.depth_bias_slope_factor = renderer->fnaRasterizerState.slopeScaleDepthBias;
-	createInfo.rasterizer_state.fill_mode = XNAToSDL_FillMode[renderer->fnaRasterizerState.fillMode];
-	createInfo.rasterizer_state.front_face = SDL_GPU_FRONTFACE_CLOCKWISE;
-
-	/* Multisample */
-
-	SDL_zero(createInfo.multisample_state);
-	createInfo.multisample_state.sample_count = renderer->nextRenderPassMultisampleCount;
-	if (renderer->multisampleMask != 0xFFFFFFFF)
-	{
-		createInfo.multisample_state.enable_mask = true;
-		createInfo.multisample_state.sample_mask = renderer->multisampleMask;
-	}
-	else
-	{
-		createInfo.multisample_state.enable_mask = false;
-		createInfo.multisample_state.sample_mask = 0;
-	}
-
-	/* Blend State */
-
-	colorAttachmentDescriptions[0].blend_state.enable_blend = !(
-		renderer->fnaBlendState.colorSourceBlend == FNA3D_BLEND_ONE &&
-		renderer->fnaBlendState.colorDestinationBlend == FNA3D_BLEND_ZERO &&
-		renderer->fnaBlendState.alphaSourceBlend == FNA3D_BLEND_ONE &&
-		renderer->fnaBlendState.alphaDestinationBlend == FNA3D_BLEND_ZERO
+	SDLGPU_INTERNAL_FillGraphicsPipelineCreateInfo(
+		&hash,
+		&renderer->fnaBlendState,
+		&renderer->fnaRasterizerState,
+		&renderer->fnaDepthStencilState,
+		&createInfo,
+		colorAttachmentDescriptions
 	);
-	if (colorAttachmentDescriptions[0].blend_state.enable_blend)
-	{
-		colorAttachmentDescriptions[0].blend_state.src_color_blendfactor = XNAToSDL_BlendFactor[
-			renderer->fnaBlendState.colorSourceBlend
-		];
-		colorAttachmentDescriptions[0].blend_state.src_alpha_blendfactor = XNAToSDL_BlendFactor[
-			renderer->fnaBlendState.alphaSourceBlend
-		];
-		colorAttachmentDescriptions[0].blend_state.dst_color_blendfactor = XNAToSDL_BlendFactor[
-			renderer->fnaBlendState.colorDestinationBlend
-		];
-		colorAttachmentDescriptions[0].blend_state.dst_alpha_blendfactor = XNAToSDL_BlendFactor[
-			renderer->fnaBlendState.alphaDestinationBlend
-		];
 
-		colorAttachmentDescriptions[0].blend_state.color_blend_op = XNAToSDL_BlendOp[
-			renderer->fnaBlendState.colorBlendFunction
-		];
-		colorAttachmentDescriptions[0].blend_state.alpha_blend_op = XNAToSDL_BlendOp[
-			renderer->fnaBlendState.alphaBlendFunction
-		];
-	}
-	else
+	if (renderer->asyncPipelines)
 	{
-		colorAttachmentDescriptions[0].blend_state.src_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE;
-		colorAttachmentDescriptions[0].blend_state.src_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE;
-		colorAttachmentDescriptions[0].blend_state.dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ZERO;
-		colorAttachmentDescriptions[0].blend_state.dst_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ZERO;
-		colorAttachmentDescriptions[0].blend_state.color_blend_op = SDL_GPU_BLENDOP_ADD;
-		colorAttachmentDescriptions[0].blend_state.alpha_blend_op = SDL_GPU_BLENDOP_ADD;
-	}
-
-	colorAttachmentDescriptions[1].blend_state = colorAttachmentDescriptions[0].blend_state;
-	colorAttachmentDescriptions[2].blend_state = colorAttachmentDescriptions[0].blend_state;
-	colorAttachmentDescriptions[3].blend_state = colorAttachmentDescriptions[0].blend_state;
-
-	colorAttachmentDescriptions[0].blend_state.color_write_mask =
-		renderer->fnaBlendState.colorWriteEnable;
-	colorAttachmentDescriptions[1].blend_state.color_write_mask =
-		renderer->fnaBlendState.colorWriteEnable1;
-	colorAttachmentDescriptions[2].blend_state.color_write_mask =
-		renderer->fnaBlendState.colorWriteEnable2;
-	colorAttachmentDescriptions[3].blend_state.color_write_mask =
-		renderer->fnaBlendState.colorWriteEnable3;
-
-	/* FIXME: Can this be disabled when mask is R|G|B|A? -flibit */
-	colorAttachmentDescriptions[0].blend_state.enable_color_write_mask = true;
-	colorAttachmentDescriptions[1].blend_state.enable_color_write_mask = true;
-	colorAttachmentDescriptions[2].blend_state.enable_color_write_mask = true;
-	colorAttachmentDescriptions[3].blend_state.enable_color_write_mask = true;
-
-	colorAttachmentDescriptions[0].format = hash.colorFormats[0];
-	colorAttachmentDescriptions[1].format = hash.colorFormats[1];
-	colorAttachmentDescriptions[2].format = hash.colorFormats[2];
-	colorAttachmentDescriptions[3].format = hash.colorFormats[3];
-
-	createInfo.target_info.num_color_targets = renderer->nextRenderPassColorAttachmentCount;
-	createInfo.target_info.color_target_descriptions = colorAttachmentDescriptions;
-	createInfo.target_info.has_depth_stencil_target = hash.hasDepthStencilAttachment;
-	createInfo.target_info.depth_stencil_format = hash.depthStencilFormat;
+		if (!SDLGPU_INTERNAL_IsPipelinePending(renderer, &hash))
+		{
+			job = (SDLGPU_PipelineJob*) SDL_calloc(1, sizeof(SDLGPU_PipelineJob));
+			job->hash = hash;
+			job->createInfo = createInfo;
+			SDL_memcpy(
+				job->vertexBindings,
+				vertexBindings,
+				renderer->numVertexBindings * sizeof(SDL_GPUVertexBufferDescription)
+			);
+			SDL_memcpy(
+				job->vertexAttributes,
+				vertexAttributes,
+				createInfo.vertex_input_state.num_vertex_attributes * sizeof(SDL_GPUVertexAttribute)
+			);
+			SDL_memcpy(
+				job->colorAttachmentDescriptions,
+				colorAttachmentDescriptions,
+				sizeof(colorAttachmentDescriptions)
+			);
+			job->createInfo.vertex_input_state.vertex_buffer_descriptions = job->vertexBindings;
+			job->createInfo.vertex_input_state.vertex_attributes = job->vertexAttributes;
+			job->createInfo.target_info.color_target_descriptions = job->colorAttachmentDescriptions;
+			SDLGPU_INTERNAL_SubmitPipelineJob(renderer, job);
 
-	/* Depth Stencil */
+			SDLGPU_INTERNAL_RecordPipeline(renderer, &hash);
+		}
 
-	createInfo.depth_stencil_state.enable_depth_test =
-		renderer->fnaDepthStencilState.depthBufferEnable;
-	createInfo.depth_stencil_state.enable_depth_write =
-		renderer->fnaDepthStencilState.depthBufferWriteEnable;
-	createInfo.depth_stencil_state.compare_op = XNAToSDL_CompareOp[
-		renderer->fnaDepthStencilState.depthBufferFunction
-	];
-	createInfo.depth_stencil_state.enable_stencil_test =
-		renderer->fnaDepthStencilState.stencilEnable;
+		SDL_free(vertexBindings);
+		SDL_free(vertexAttributes);
 
-	createInfo.depth_stencil_state.front_stencil_state.compare_op = XNAToSDL_CompareOp[
-		renderer->fnaDepthStencilState.stencilFunction
-	];
-	createInfo.depth_stencil_state.front_stencil_state.depth_fail_op = XNAToSDL_StencilOp[
-		renderer->fnaDepthStencilState.stencilDepthBufferFail
-	];
-	createInfo.depth_stencil_state.front_stencil_state.fail_op = XNAToSDL_StencilOp[
-		renderer->fnaDepthStencilState.stencilFail
-	];
-	createInfo.depth_stencil_state.front_stencil_state.pass_op = XNAToSDL_StencilOp[
-		renderer->fnaDepthStencilState.stencilPass
-	];
+		pipeline = SDLGPU_INTERNAL_FindCompatiblePipeline(renderer, &hash);
+		if (pipeline != NULL)
+		{
+			*temporary = 1;
+			return pipeline;
+		}
 
-	if (renderer->fnaDepthStencilState.twoSidedStencilMode)
-	{
-		createInfo.depth_stencil_state.back_stencil_state.compare_op = XNAToSDL_CompareOp[
-			renderer->fnaDepthStencilState.ccwStencilFunction
-		];
-		createInfo.depth_stencil_state.back_stencil_state.depth_fail_op = XNAToSDL_StencilOp[
-			renderer->fnaDepthStencilState.ccwStencilDepthBufferFail
-		];
-		createInfo.depth_stencil_state.back_stencil_state.fail_op = XNAToSDL_StencilOp[
-			renderer->fnaDepthStencilState.ccwStencilFail
-		];
-		createInfo.depth_stencil_state.back_stencil_state.pass_op = XNAToSDL_StencilOp[
-			renderer->fnaDepthStencilState.ccwStencilPass
-		];
-	}
-	else
-	{
-		createInfo.depth_stencil_state.back_stencil_state = createInfo.depth_stencil_state.front_stencil_state;
+		/* Nothing draws the same thing, so this draw has to wait */
+		pipeline = SDLGPU_INTERNAL_WaitForPipeline(renderer, &hash);
+		if (pipeline == NULL)
+		{
+			FNA3D_LogError("Failed to create graphics pipeline!");
+		}
+		return pipeline;
 	}
 
-	createInfo.depth_stencil_state.compare_mask =
-		renderer->fnaDepthStencilState.stencilMask;
-	createInfo.depth_stencil_state.write_mask =
-		renderer->fnaDepthStencilState.stencilWriteMask;
-
 	/* Finally, after 1000 years, create the pipeline! */
 
-	createInfo.props = 0;
 	pipeline = SDL_CreateGPUGraphicsPipeline(
 		renderer->device,
 		&createInfo
@@ -1774,21 +3205,23 @@ static SDL_GPUGraphicsPipeline* SDLGPU_INTERNAL_FetchGraphicsPipeline(
 	{
 		FNA3D_LogError("Failed to create graphics pipeline!");
 	}
+	else
+	{
+		SDLGPU_INTERNAL_RecordPipeline(renderer, &hash);
+	}
 
-	GraphicsPipelineHashTable_Insert(
-		&renderer->graphicsPipelineHashTable,
-		hash,
-		pipeline
-	);
+	SDLGPU_INTERNAL_InsertGraphicsPipeline(renderer, &hash, pipeline);
 
 	return pipeline;
 }
 
-static void SDLGPU_INTERNAL_BindGraphicsPipeline(
+/* Returns 0 if the pipeline couldn't be created */
+static uint8_t SDLGPU_INTERNAL_BindGraphicsPipeline(
 	SDLGPU_Renderer *renderer
 ) {
 	SDL_GPUGraphicsPipeline *pipeline;
 	MOJOSHADER_sdlShaderData *vertShaderData, *fragShaderData;
+	uint8_t temporary;
 
 	MOJOSHADER_sdlGetBoundShaderData(
 		renderer->mojoshaderContext,
@@ -1801,10 +3234,17 @@ static void SDLGPU_INTERNAL_BindGraphicsPipeline(
 		renderer->currentVertexShader == vertShaderData &&
 		renderer->currentFragmentShader == fragShaderData
 	) {
-		return;
+		return 1;
 	}
 
-	pipeline = SDLGPU_INTERNAL_FetchGraphicsPipeline(renderer);
+	pipeline = SDLGPU_INTERNAL_FetchGraphicsPipeline(renderer, &temporary);
+
+	if (pipeline == NULL)
+	{
+		/* Try again on the next draw */
+		renderer->needNewGraphicsPipeline = 1;
+		return 0;
+	}
 
 	if (pipeline != renderer->currentGraphicsPipeline)
 	{
@@ -1830,6 +3270,10 @@ static void SDLGPU_INTERNAL_BindGraphicsPipeline(
 	renderer->needVertexSamplerBind = 1;
 	renderer->needVertexBufferBind = 1;
 	renderer->indexBufferBinding.buffer = NULL;
+
+	/* Keep checking for the real pipeline */
+	renderer->needNewGraphicsPipeline = temporary;
+	return 1;
 }
 
 static SDL_GPUSampler* SDLGPU_INTERNAL_FetchSamplerState(
@@ -2383,8 +3827,10 @@ static void SDLGPU_INTERNAL_BindFragmentSamplers(
 	);
 }
 
-/* Actually bind all deferred state before drawing! */
-static void SDLGPU_INTERNAL_BindDeferredState(
+/* Actually bind all deferred state before drawing!
+ * Returns 0 if there is no pipeline to draw with.
+ */
+static uint8_t SDLGPU_INTERNAL_BindDeferredState(
 	SDLGPU_Renderer *renderer,
 	FNA3D_PrimitiveType primitiveType,
 	SDL_GPUBuffer *indexBuffer, /* can be NULL */
@@ -2398,7 +3844,10 @@ static void SDLGPU_INTERNAL_BindDeferredState(
 
 	SDLGPU_INTERNAL_BeginRenderPass(renderer);
 
-	SDLGPU_INTERNAL_BindGraphicsPipeline(renderer);
+	if (!SDLGPU_INTERNAL_BindGraphicsPipeline(renderer))
+	{
+		return 0;
+	}
 
 	if (	renderer->currentBlendConstants.r != renderer->blendConstants[0] ||
 		renderer->currentBlendConstants.g != renderer->blendConstants[1] ||
@@ -2453,6 +3902,8 @@ static void SDLGPU_INTERNAL_BindDeferredState(
 			renderer->numVertexBindings
 		);
 	}
+
+	return 1;
 }
 
 static void SDLGPU_DrawInstancedPrimitives(
@@ -2476,12 +3927,14 @@ static void SDLGPU_DrawInstancedPrimitives(
 		baseVertex = 0;
 	}
 
-	SDLGPU_INTERNAL_BindDeferredState(
+	if (!SDLGPU_INTERNAL_BindDeferredState(
 		renderer,
 		primitiveType,
 		((SDLGPU_BufferHandle*) indices)->buffer,
 		XNAToSDL_IndexElementSize[indexElementSize]
-	);
+	)) {
+		return;
+	}
 
 	SDL_DrawGPUIndexedPrimitives(
 		renderer->renderPass,
@@ -2526,12 +3979,14 @@ static void SDLGPU_DrawPrimitives(
 ) {
 	SDLGPU_Renderer *renderer = (SDLGPU_Renderer*) driverData;
 
-	SDLGPU_INTERNAL_BindDeferredState(
+	if (!SDLGPU_INTERNAL_BindDeferredState(
 		renderer,
 		primitiveType,
 		NULL,
 		SDL_GPU_INDEXELEMENTSIZE_16BIT
-	);
+	)) {
+		return;
+	}
 
 	SDL_DrawGPUPrimitives(
 		renderer->renderPass,
@@ -3858,7 +5313,14 @@ static void SDLGPU_CreateEffect(
 
 	result = (SDLGPU_Effect*) SDL_malloc(sizeof(SDLGPU_Effect));
 	result->effect = *effectData;
+	result->hash = 0;
 	*effect = (FNA3D_Effect*) result;
+
+	if (renderer->pipelineCachePath != NULL)
+	{
+		result->hash = SDLGPU_INTERNAL_HashBytes(effectCode, effectCodeLength);
+		SDLGPU_INTERNAL_PrewarmEffect(renderer, result);
+	}
 }
 
 static void SDLGPU_CloneEffect(
@@ -3879,6 +5341,7 @@ static void SDLGPU_CloneEffect(
 
 	result = (SDLGPU_Effect*) SDL_malloc(sizeof(SDLGPU_Effect));
 	result->effect = *effectData;
+	result->hash = sdlCloneSource->hash;
 	*effect = (FNA3D_Effect*) result;
 }
 
@@ -3898,7 +5361,12 @@ static void SDLGPU_AddDisposeEffect(
 		renderer->currentEffect = NULL;
 		renderer->currentTechnique = NULL;
 		renderer->currentPass = 0;
+		renderer->currentEffectHash = 0;
 	}
+
+	/* Queued pipelines may still be using this effect's shaders */
+	SDLGPU_INTERNAL_WaitForPipelineJobs(renderer);
+
 	MOJOSHADER_deleteEffect(effectData);
 	SDL_free(gpuEffect);
 }
@@ -3965,6 +5433,7 @@ static void SDLGPU_ApplyEffect(
 	renderer->currentEffect = effectData;
 	renderer->currentTechnique = technique;
 	renderer->currentPass = pass;
+	renderer->currentEffectHash = gpuEffect->hash;
 }
 
 static void SDLGPU_BeginPassRestore(
@@ -3993,6 +5462,139 @@ static void SDLGPU_EndPassRestore(
 	MOJOSHADER_effectEnd(effectData);
 }
 
+static void SDLGPU_PrecompilePipelines(
+	FNA3D_Renderer *driverData,
+	FNA3D_PrecompileInfoEXT *infos,
+	int32_t numInfos
+) {
+	SDLGPU_Renderer *renderer = (SDLGPU_Renderer*) driverData;
+	MOJOSHADER_sdlShaderData *oldVertShader, *oldFragShader;
+	FNA3D_PrecompileInfoEXT *info;
+	FNA3D_RasterizerState rasterizerState;
+	SDLGPU_Effect *effect;
+	PipelineCacheEntry entry;
+	SDLGPU_TextureHandle *depthStencil;
+	int32_t i, j;
+
+	SDLGPU_INTERNAL_StartPipelineThreads(renderer);
+
+	MOJOSHADER_sdlGetBoundShaderData(
+		renderer->mojoshaderContext,
+		&oldVertShader,
+		&oldFragShader
+	);
+
+	for (i = 0; i < numInfos; i += 1)
+	{
+		info = &infos[i];
+		effect = (SDLGPU_Effect*) info->effect;
+
+		SDL_zero(entry.key);
+		if (!GetEffectPassShaders(
+			effect->effect,
+			info->technique,
+			info->pass,
+			&entry.key.vertexShaderIndex,
+			&entry.key.fragmentShaderIndex
+		)) {
+			continue;
+		}
+
+		entry.key.effectHash = effect->hash;
+		entry.key.primitiveType = info->primitiveType;
+		entry.key.sampleMask = (uint32_t) info->blendState.multiSampleMask;
+
+		/* Same attachments SetRenderTargets would give us */
+		for (j = 0; j < MAX_RENDERTARGET_BINDINGS; j += 1)
+		{
+			entry.key.colorFormats[j] = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
+		}
+		entry.key.depthStencilFormat = SDL_GPU_TEXTUREFORMAT_D16_UNORM;
+		if (info->numColorFormats <= 0)
+		{
+			entry.key.colorFormats[0] = renderer->fauxBackbufferColorTexture->createInfo.format;
+			entry.key.colorFormatCount = 1;
+			entry.key.sampleCount = (renderer->fauxBackbufferColorRenderbuffer != NULL) ?
+				renderer->fauxBackbufferColorRenderbuffer->createInfo.sample_count :
+				SDL_GPU_SAMPLECOUNT_1;
+			depthStencil = renderer->fauxBackbufferDepthStencil;
+			if (depthStencil != NULL)
+			{
+				entry.key.hasDepthStencilAttachment = 1;
+				entry.key.depthStencilFormat = depthStencil->createInfo.format;
+			}
+		}
+		else
+		{
+			entry.key.colorFormatCount = SDL_min(
+				info->numColorFormats,
+				MAX_RENDERTARGET_BINDINGS
+			);
+			for (j = 0; j < (int32_t) entry.key.colorFormatCount; j += 1)
+			{
+				entry.key.colorFormats[j] = XNAToSDL_SurfaceFormat[info->colorFormats[j]];
+			}
+			entry.key.sampleCount = XNAToSDL_SampleCount(info->multiSampleCount);
+			if (info->depthFormat != FNA3D_DEPTHFORMAT_NONE)
+			{
+				entry.key.hasDepthStencilAttachment = 1;
+				entry.key.depthStencilFormat = XNAToSDL_DepthFormat(
+					renderer,
+					info->depthFormat
+				);
+			}
+		}
+
+		/* Same as ApplyRasterizerState */
+		rasterizerState = info->rasterizerState;
+		rasterizerState.depthBias *= XNAToSDL_DepthBiasScale(
+			(SDL_GPUTextureFormat) entry.key.depthStencilFormat
+		);
+		SDLGPU_INTERNAL_PackPipelineCacheStates(
+			&entry.key,
+			&info->blendState,
+			&rasterizerState,
+			&info->depthStencilState
+		);
+
+		entry.key.numVertexBindings = SDL_clamp(
+			info->numVertexBindings,
+			0,
+			MAX_BOUND_VERTEX_BUFFERS
+		);
+		entry.vertexBindings = SDLGPU_INTERNAL_GetPipelineCacheBindings(
+			info->vertexBindings,
+			entry.key.numVertexBindings
+		);
+
+		SDLGPU_INTERNAL_QueuePipeline(renderer, effect->effect, &entry);
+
+		if (renderer->pipelineCachePath != NULL)
+		{
+			SDLGPU_INTERNAL_AddPipelineCacheEntry(renderer, &entry);
+		}
+		else
+		{
+			SDL_free(entry.vertexBindings);
+		}
+	}
+
+	/* The linked program changed too, so force a relink on the next draw */
+	MOJOSHADER_sdlBindShaders(
+		renderer->mojoshaderContext,
+		oldVertShader,
+		oldFragShader
+	);
+	renderer->needNewGraphicsPipeline = 1;
+}
+
+static int32_t SDLGPU_GetPendingPipelines(FNA3D_Renderer *driverData)
+{
+	SDLGPU_Renderer *renderer = (SDLGPU_Renderer*) driverData;
+	SDLGPU_INTERNAL_CollectPipelineJobs(renderer);
+	return renderer->pendingPipelines.count;
+}
+
 /* Queries */
 
 static FNA3D_Query* SDLGPU_CreateQuery(FNA3D_Renderer *driverData)
@@ -4191,6 +5793,9 @@ static void SDLGPU_DestroyDevice(FNA3D_Device *device)
 
 	SDLGPU_INTERNAL_DestroyFauxBackbuffer(renderer);
 
+	/* Finishes any queued pipelines so they get released below */
+	SDLGPU_INTERNAL_QuitPipelineCache(renderer);
+
 	for (i = 0; i < NUM_PIPELINE_HASH_BUCKETS; i += 1)
 	{
 		for (j = 0; j < renderer->graphicsPipelineHashTable.buckets[i].count; j += 1)
@@ -4210,6 +5815,9 @@ static void SDLGPU_DestroyDevice(FNA3D_Device *device)
 		);
 	}
 
+	/* Bindings indices are baked into pipeline hashes, so this never evicts */
+	PackedVertexBufferBindingsArray_Free(&renderer->vertexBufferBindingsCache);
+
 	SDL_ReleaseGPUTexture(
 		renderer->device,
 		renderer->dummyTexture2D
@@ -4297,6 +5905,7 @@ static FNA3D_Device* SDLGPU_CreateDevice(
 	SDL_GPUSamplerCreateInfo samplerCreateInfo;
 	SDL_GPUTransferBufferCreateInfo transferBufferCreateInfo;
 	SDL_GPUPresentMode desiredPresentMode;
+	const char *pipelineCachePath;
 	uint64_t dummyInt = 0;
 	FNA3D_Device *result;
 	int32_t i;
@@ -4439,6 +6048,19 @@ static FNA3D_Device* SDLGPU_CreateDevice(
 		return NULL;
 	}
 
+	/* Optional on-disk pipeline cache, see PipelineCacheKey */
+	pipelineCachePath = SDL_GetHint("FNA3D_SDLGPU_PIPELINE_CACHE");
+	if (pipelineCachePath != NULL && pipelineCachePath[0] != '\0')
+	{
+		SDLGPU_INTERNAL_InitPipelineCache(renderer, pipelineCachePath);
+	}
+
+	/* Optional asynchronous pipeline creation, see MAX_PIPELINE_THREADS */
+	if (SDL_GetHintBoolean("FNA3D_SDLGPU_ASYNC_PIPELINES", false))
+	{
+		renderer->asyncPipelines = SDLGPU_INTERNAL_StartPipelineThreads(renderer);
+	}
+
 	/* Determine capabilities */
 
 	renderer->supportsDXT1 = SDL_GPUTextureSupportsFormat(
@@ -32,6 +32,104 @@
 #include <SDL.h>
 #endif
 
+/* Hash Slots */
+
+#define MIN_SLOT_COUNT 16
+
+static void PackedSlots_Add(
+	PackedSlot *slots,
+	int32_t slotCount,
+	uint32_t hash,
+	int32_t index
+) {
+	uint32_t mask = slotCount - 1;
+	uint32_t i;
+
+	for (i = hash & mask; slots[i].index != 0; i = (i + 1) & mask);
+	slots[i].hash = hash;
+	slots[i].index = index + 1;
+}
+
+/* Makes sure there's room for one more element, keeping the table at most
+ * half full so that probe sequences stay short.
+ */
+static void PackedSlots_Reserve(
+	PackedSlot **slots,
+	int32_t *slotCount,
+	int32_t count
+) {
+	PackedSlot *oldSlots = *slots;
+	int32_t oldSlotCount = *slotCount;
+	int32_t i;
+
+	if ((count + 1) * 2 <= oldSlotCount)
+	{
+		return;
+	}
+
+	*slotCount = (oldSlotCount == 0) ? MIN_SLOT_COUNT : oldSlotCount * 2;
+	*slots = (PackedSlot*) SDL_calloc(*slotCount, sizeof(PackedSlot));
+	for (i = 0; i < oldSlotCount; i += 1)
+	{
+		if (oldSlots[i].index != 0)
+		{
+			PackedSlots_Add(
+				*slots,
+				*slotCount,
+				oldSlots[i].hash,
+				oldSlots[i].index - 1
+			);
+		}
+	}
+	SDL_free(oldSlots);
+}
+
+static uint32_t PackedSlots_Find(
+	PackedSlot *slots,
+	int32_t slotCount,
+	uint32_t hash,
+	int32_t index
+) {
+	uint32_t mask = slotCount - 1;
+	uint32_t i;
+
+	for (i = hash & mask; slots[i].index != index + 1; i = (i + 1) & mask);
+	return i;
+}
+
+/* Empties a slot, then moves any later slots in the same run back so that
+ * none of them end up behind the hole.
+ */
+static void PackedSlots_Remove(
+	PackedSlot *slots,
+	int32_t slotCount,
+	uint32_t i
+) {
+	uint32_t mask = slotCount - 1;
+	uint32_t j = i, k;
+
+	slots[i].index = 0;
+	while (1)
+	{
+		j = (j + 1) & mask;
+		if (slots[j].index == 0)
+		{
+			break;
+		}
+
+		/* Leave it if its home slot is cyclically within (i, j] */
+		k = slots[j].hash & mask;
+		if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+		{
+			continue;
+		}
+
+		slots[i] = slots[j];
+		slots[j].index = 0;
+		i = j;
+	}
+}
+
 /* Packed Pipeline States */
 
 PackedState GetPackedBlendState(FNA3D_BlendState blendState)
@@ -138,16 +236,40 @@ PackedState GetPackedSamplerState(FNA3D_SamplerState samplerState)
 
 #undef FLOAT_TO_UINT64
 
+static inline uint32_t HashPackedState(PackedState key)
+{
+	/* Both halves are mostly small bitfields, so mix them thoroughly */
+	uint64_t hash = (key.a * 0x9E3779B97F4A7C15ULL) ^ key.b;
+	hash ^= hash >> 31;
+	hash *= 0xBF58476D1CE4E5B9ULL;
+	hash ^= hash >> 29;
+	return (uint32_t) hash;
+}
+
 void* PackedStateArray_Fetch(PackedStateArray arr, PackedState key)
 {
-	int32_t i;
+	uint32_t hash, mask, i;
+	PackedStateMap *elem;
+
+	if (arr.count == 0)
+	{
+		return NULL;
+	}
 
-	for (i = 0; i < arr.count; i += 1)
+	hash = HashPackedState(key);
+	mask = arr.slotCount - 1;
+	for (i = hash & mask; arr.slots[i].index != 0; i = (i + 1) & mask)
 	{
-		if (	key.a == arr.elements[i].key.a &&
-			key.b == arr.elements[i].key.b		)
+		if (arr.slots[i].hash != hash)
 		{
-			return arr.elements[i].value;
+			continue;
+		}
+		elem = &arr.elements[arr.slots[i].index - 1];
+		if (	key.a == elem->key.a &&
+			key.b == elem->key.b	)
+		{
+			elem->referenced = 1;
+			return elem->value;
 		}
 	}
 
@@ -160,13 +282,99 @@ void PackedStateArray_Insert(PackedStateArray *arr, PackedState key, void* value
 	map.key.a = key.a;
 	map.key.b = key.b;
 	map.value = value;
+	map.referenced = 1;
 
 	EXPAND_ARRAY_IF_NEEDED(arr, 4, PackedStateMap)
+	PackedSlots_Reserve(&arr->slots, &arr->slotCount, arr->count);
 
 	arr->elements[arr->count] = map;
+	PackedSlots_Add(
+		arr->slots,
+		arr->slotCount,
+		HashPackedState(key),
+		arr->count
+	);
 	arr->count += 1;
 }
 
+/* Removes the least recently used value and returns it, so the caller can
+ * release it. This uses the "clock" approximation of LRU: the sweep skips
+ * anything that was fetched since it last came by. Values listed in inUse
+ * are never evicted. Returns NULL if everything is in use.
+ */
+void* PackedStateArray_Evict(
+	PackedStateArray *arr,
+	void* const *inUse,
+	int32_t numInUse
+) {
+	PackedStateMap *elem;
+	void* result;
+	int32_t i, j, last;
+	uint8_t skip;
+
+	/* Two sweeps clear every reference bit, so that's as far as we go */
+	for (i = 0; i < arr->count * 2; i += 1)
+	{
+		if (arr->evictIndex >= arr->count)
+		{
+			arr->evictIndex = 0;
+		}
+		elem = &arr->elements[arr->evictIndex];
+
+		skip = elem->referenced;
+		for (j = 0; j < numInUse && !skip; j += 1)
+		{
+			skip = (inUse[j] == elem->value);
+		}
+		if (!skip)
+		{
+			break;
+		}
+
+		elem->referenced = 0;
+		arr->evictIndex += 1;
+	}
+	if (i == arr->count * 2)
+	{
+		return NULL;
+	}
+
+	/* Take it out of the slots, then fill the hole with the last element */
+	i = arr->evictIndex;
+	result = arr->elements[i].value;
+	PackedSlots_Remove(
+		arr->slots,
+		arr->slotCount,
+		PackedSlots_Find(
+			arr->slots,
+			arr->slotCount,
+			HashPackedState(arr->elements[i].key),
+			i
+		)
+	);
+	last = arr->count - 1;
+	if (i != last)
+	{
+		arr->slots[PackedSlots_Find(
+			arr->slots,
+			arr->slotCount,
+			HashPackedState(arr->elements[last].key),
+			last
+		)].index = i + 1;
+		arr->elements[i] = arr->elements[last];
+	}
+	arr->count -= 1;
+
+	return result;
+}
+
+void PackedStateArray_Free(PackedStateArray *arr)
+{
+	SDL_free(arr->elements);
+	SDL_free(arr->slots);
+	SDL_zerop(arr);
+}
+
 /* Vertex Buffer Bindings */
 
 static inline uint32_t GetPackedVertexElement(FNA3D_VertexElement element)
@@ -213,6 +421,18 @@ static uint32_t HashVertexBufferBindings(
 	return hash;
 }
 
+static inline uint32_t HashPackedVertexBufferBindings(
+	PackedVertexBufferBindings key
+) {
+	/* The bindings are already hashed, just fold in the shader */
+	uint64_t hash = (uint64_t) (size_t) key.vertexShader;
+	hash = (hash * 0x9E3779B97F4A7C15ULL) ^ key.hash;
+	hash ^= hash >> 31;
+	hash *= 0xBF58476D1CE4E5B9ULL;
+	hash ^= hash >> 29;
+	return (uint32_t) hash;
+}
+
 void* PackedVertexBufferBindingsArray_Fetch(
 	PackedVertexBufferBindingsArray arr,
 	FNA3D_VertexBufferBinding *bindings,
@@ -221,24 +441,40 @@ void* PackedVertexBufferBindingsArray_Fetch(
 	int32_t *outIndex,
 	uint32_t *outHash
 ) {
-	int32_t i;
-	PackedVertexBufferBindings other;
-	uint32_t hash = HashVertexBufferBindings(bindings, numBindings);
-	void* result = NULL;
+	uint32_t slotHash, mask, i;
+	PackedVertexBufferBindings key;
+	PackedVertexBufferBindingsMap *elem;
+
+	key.vertexShader = vertexShader;
+	key.hash = HashVertexBufferBindings(bindings, numBindings);
+	*outHash = key.hash;
 
-	for (i = 0; i < arr.count; i += 1)
+	/* On a miss, this is the index Insert will use */
+	*outIndex = arr.count;
+
+	if (arr.count == 0)
 	{
-		other = arr.elements[i].key;
-		if (vertexShader == other.vertexShader && hash == other.hash)
+		return NULL;
+	}
+
+	slotHash = HashPackedVertexBufferBindings(key);
+	mask = arr.slotCount - 1;
+	for (i = slotHash & mask; arr.slots[i].index != 0; i = (i + 1) & mask)
+	{
+		if (arr.slots[i].hash != slotHash)
 		{
-			result = arr.elements[i].value;
-			break;
+			continue;
+		}
+		elem = &arr.elements[arr.slots[i].index - 1];
+		if (	vertexShader == elem->key.vertexShader &&
+			key.hash == elem->key.hash	)
+		{
+			*outIndex = arr.slots[i].index - 1;
+			return elem->value;
 		}
 	}
 
-	*outIndex = i;
-	*outHash = hash;
-	return result;
+	return NULL;
 }
 
 void PackedVertexBufferBindingsArray_Insert(
@@ -252,12 +488,119 @@ void PackedVertexBufferBindingsArray_Insert(
 
 	EXPAND_ARRAY_IF_NEEDED(arr, 4, PackedVertexBufferBindingsMap)
 
+	PackedSlots_Reserve(&arr->slots, &arr->slotCount, arr->count);
+
 	map.key.vertexShader = vertexShader;
 	map.key.hash = HashVertexBufferBindings(bindings, numBindings);
 	map.value = value;
 
 	arr->elements[arr->count] = map;
+	PackedSlots_Add(
+		arr->slots,
+		arr->slotCount,
+		HashPackedVertexBufferBindings(map.key),
+		arr->count
+	);
 	arr->count += 1;
 }
 
+/* Call this after removing elements from the array directly */
+void PackedVertexBufferBindingsArray_Rehash(
+	PackedVertexBufferBindingsArray *arr
+) {
+	int32_t i;
+
+	if (arr->slotCount == 0)
+	{
+		return;
+	}
+
+	SDL_memset(arr->slots, '\0', arr->slotCount * sizeof(PackedSlot));
+	for (i = 0; i < arr->count; i += 1)
+	{
+		PackedSlots_Add(
+			arr->slots,
+			arr->slotCount,
+			HashPackedVertexBufferBindings(arr->elements[i].key),
+			i
+		);
+	}
+}
+
+void PackedVertexBufferBindingsArray_Free(
+	PackedVertexBufferBindingsArray *arr
+) {
+	SDL_free(arr->elements);
+	SDL_free(arr->slots);
+	SDL_zerop(arr);
+}
+
+/* Effect Passes */
+
+uint8_t GetEffectPassShaders(
+	MOJOSHADER_effect *effect,
+	const MOJOSHADER_effectTechnique *technique,
+	uint32_t pass,
+	int32_t *vertexShaderIndex,
+	int32_t *pixelShaderIndex
+) {
+	const MOJOSHADER_effectPass *effectPass;
+	const MOJOSHADER_effectState *state;
+	const MOJOSHADER_effectObject *object;
+	int32_t *index;
+	uint32_t i;
+
+	if (technique == NULL)
+	{
+		technique = effect->current_technique;
+	}
+	if (technique == NULL || pass >= technique->pass_count)
+	{
+		return 0;
+	}
+
+	*vertexShaderIndex = -1;
+	*pixelShaderIndex = -1;
+	effectPass = &technique->passes[pass];
+	for (i = 0; i < effectPass->state_count; i += 1)
+	{
+		state = &effectPass->states[i];
+		if (state->type == MOJOSHADER_RS_VERTEXSHADER)
+		{
+			index = vertexShaderIndex;
+		}
+		else if (state->type == MOJOSHADER_RS_PIXELSHADER)
+		{
+			index = pixelShaderIndex;
+		}
+		else
+		{
+			continue;
+		}
+		*index = *state->value.valuesI;
+	}
+
+	/* Shader arrays are picked by a preshader at CommitChanges time, so
+	 * there is no way to know which one we'd get ahead of time.
+	 */
+	if (	*vertexShaderIndex < 0 ||
+		*vertexShaderIndex >= (int32_t) effect->object_count ||
+		*pixelShaderIndex < 0 ||
+		*pixelShaderIndex >= (int32_t) effect->object_count	)
+	{
+		return 0;
+	}
+	object = &effect->objects[*vertexShaderIndex];
+	if (object->type != MOJOSHADER_SYMTYPE_VERTEXSHADER || object->shader.is_preshader)
+	{
+		return 0;
+	}
+	object = &effect->objects[*pixelShaderIndex];
+	if (object->type != MOJOSHADER_SYMTYPE_PIXELSHADER || object->shader.is_preshader)
+	{
+		return 0;
+	}
+	return 1;
+}
+
 /* vim: set noexpandtab shiftwidth=8 tabstop=8: */
@@ -29,6 +29,19 @@
 
 #include "FNA3D_Driver.h"
 
+/* Hash Slots */
+
+/* The arrays below keep their elements in insertion order, so they can be
+ * iterated directly and an element's index doesn't change when others get
+ * added. Lookups go through an open-addressed (linear probing) table of
+ * slots instead, which is kept at most half full.
+ */
+typedef struct PackedSlot
+{
+	uint32_t hash;
+	int32_t index; /* Element index + 1, 0 if the slot is empty */
+} PackedSlot;
+
 /* Packed Pipeline States */
 
 typedef struct PackedState
@@ -41,6 +54,7 @@ typedef struct PackedStateMap
 {
 	PackedState key;
 	void* value;
+	uint8_t referenced; /* Set by Fetch, cleared by Evict */
 } PackedStateMap;
 
 typedef struct PackedStateArray
@@ -48,6 +62,9 @@ typedef struct PackedStateArray
 	PackedStateMap *elements;
 	int32_t count;
 	int32_t capacity;
+	PackedSlot *slots;
+	int32_t slotCount; /* Power of two, or 0 before the first insert */
+	int32_t evictIndex;
 } PackedStateArray;
 
 FNA3D_SHAREDINTERNAL PackedState GetPackedBlendState(FNA3D_BlendState blendState);
@@ -56,6 +73,12 @@ FNA3D_SHAREDINTERNAL PackedState GetPackedRasterizerState(FNA3D_RasterizerState
 FNA3D_SHAREDINTERNAL PackedState GetPackedSamplerState(FNA3D_SamplerState samplerState);
 FNA3D_SHAREDINTERNAL void* PackedStateArray_Fetch(PackedStateArray arr, PackedState key);
 FNA3D_SHAREDINTERNAL void PackedStateArray_Insert(PackedStateArray *arr, PackedState key, void* value);
+FNA3D_SHAREDINTERNAL void* PackedStateArray_Evict(
+	PackedStateArray *arr,
+	void* const *inUse,
+	int32_t numInUse
+);
+FNA3D_SHAREDINTERNAL void PackedStateArray_Free(PackedStateArray *arr);
 
 /* Vertex Buffer Bindings */
 
@@ -77,6 +100,8 @@ typedef struct VertexBufferBindingsArray
 	PackedVertexBufferBindingsMap *elements;
 	int32_t count;
 	int32_t capacity;
+	PackedSlot *slots;
+	int32_t slotCount; /* Power of two, or 0 before the first insert */
 } PackedVertexBufferBindingsArray;
 
 FNA3D_SHAREDINTERNAL void* PackedVertexBufferBindingsArray_Fetch(
@@ -94,6 +119,22 @@ FNA3D_SHAREDINTERNAL void PackedVertexBufferBindingsArray_Insert(
 	void* vertexShader,
 	void* value
 );
+FNA3D_SHAREDINTERNAL void PackedVertexBufferBindingsArray_Rehash(
+	PackedVertexBufferBindingsArray *arr
+);
+FNA3D_SHAREDINTERNAL void PackedVertexBufferBindingsArray_Free(
+	PackedVertexBufferBindingsArray *arr
+);
+
+/* Effect Passes */
+
+FNA3D_SHAREDINTERNAL uint8_t GetEffectPassShaders(
+	MOJOSHADER_effect *effect,
+	const MOJOSHADER_effectTechnique *technique,
+	uint32_t pass,
+	int32_t *vertexShaderIndex,
+	int32_t *pixelShaderIndex
+);
 
 /* Macros */
 
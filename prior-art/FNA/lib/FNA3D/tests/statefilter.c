@@ -0,0 +1,603 @@
+/* FNA3D - 3D Graphics Library for FNA
+ *
+ * Copyright (c) 2020-2024 Ethan Lee
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software in a
+ * product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ * Ethan "flibitijibibo" Lee <flibitijibibo@flibitijibibo.com>
+ *
+ */
+
+/* Tests for the state filter and draw merging in FNA3D.c, which run on the
+ * Null driver so they don't need a GPU or a window. The Null driver's summary
+ * line is read back through the log hooks to see what actually reached it.
+ */
+
+#ifdef USE_SDL3
+#include <SDL3/SDL.h>
+#else
+#include <SDL.h>
+#endif
+
+#include <stdio.h>
+
+#include "FNA3D.h"
+
+#define NUM_THREAD_ITERATIONS 2000
+#define TEXTURE_SIZE 16
+#define NUM_VERTICES 64
+
+static int32_t failureCount = 0;
+static int32_t successCount = 0;
+
+#define CHECK(cond) \
+	if (cond) \
+	{ \
+		successCount += 1; \
+	} \
+	else \
+	{ \
+		SDL_Log("%s:%d: Failed: %s", __FILE__, __LINE__, #cond); \
+		failureCount += 1; \
+	}
+
+/* Filled in by the Null driver's DestroyDevice */
+static unsigned long long summaryDraws;
+static unsigned long long summaryPrimitives;
+static unsigned long long summaryStateChanges;
+static unsigned long long summaryErrors;
+static int32_t errorCount;
+
+static void LogInfo(const char *msg)
+{
+	unsigned long long frames, clears;
+
+	sscanf(
+		msg,
+		"Null driver: %llu frames, %llu draws, %llu primitives, "
+		"%llu clears, %llu state changes, %llu validation errors",
+		&frames,
+		&summaryDraws,
+		&summaryPrimitives,
+		&clears,
+		&summaryStateChanges,
+		&summaryErrors
+	);
+}
+
+static void LogWarn(const char *msg)
+{
+	SDL_Log("%s", msg);
+}
+
+static void LogError(const char *msg)
+{
+	SDL_Log("%s", msg);
+	errorCount += 1;
+}
+
+/* NULL hints are left unset, to get the defaults */
+static FNA3D_Device* CreateDevice(const char *filter, const char *merge)
+{
+	FNA3D_PresentationParameters params;
+
+	if (filter == NULL)
+	{
+		SDL_ResetHint("FNA3D_STATE_FILTER");
+	}
+	else
+	{
+		SDL_SetHint("FNA3D_STATE_FILTER", filter);
+	}
+	if (merge == NULL)
+	{
+		SDL_ResetHint("FNA3D_MERGE_DRAWS");
+	}
+	else
+	{
+		SDL_SetHint("FNA3D_MERGE_DRAWS", merge);
+	}
+
+	SDL_zero(params);
+	params.backBufferWidth = 64;
+	params.backBufferHeight = 64;
+	params.backBufferFormat = FNA3D_SURFACEFORMAT_COLOR;
+	params.multiSampleCount = 0;
+	params.depthStencilFormat = FNA3D_DEPTHFORMAT_NONE;
+	params.presentationInterval = FNA3D_PRESENTINTERVAL_IMMEDIATE;
+	params.displayOrientation = FNA3D_DISPLAYORIENTATION_DEFAULT;
+	params.renderTargetUsage = FNA3D_RENDERTARGETUSAGE_DISCARDCONTENTS;
+
+	summaryDraws = 0;
+	summaryPrimitives = 0;
+	summaryStateChanges = 0;
+	summaryErrors = 0;
+	errorCount = 0;
+	return FNA3D_CreateDevice(&params, 0);
+}
+
+static void MakeBlendState(FNA3D_BlendState *blendState)
+{
+	SDL_zerop(blendState);
+	blendState->colorSourceBlend = FNA3D_BLEND_ONE;
+	blendState->colorDestinationBlend = FNA3D_BLEND_INVERSESOURCEALPHA;
+	blendState->colorBlendFunction = FNA3D_BLENDFUNCTION_ADD;
+	blendState->alphaSourceBlend = FNA3D_BLEND_ONE;
+	blendState->alphaDestinationBlend = FNA3D_BLEND_INVERSESOURCEALPHA;
+	blendState->alphaBlendFunction = FNA3D_BLENDFUNCTION_ADD;
+	blendState->colorWriteEnable = FNA3D_COLORWRITECHANNELS_ALL;
+	blendState->colorWriteEnable1 = FNA3D_COLORWRITECHANNELS_ALL;
+	blendState->colorWriteEnable2 = FNA3D_COLORWRITECHANNELS_ALL;
+	blendState->colorWriteEnable3 = FNA3D_COLORWRITECHANNELS_ALL;
+	blendState->blendFactor.r = 0xFF;
+	blendState->blendFactor.g = 0xFF;
+	blendState->blendFactor.b = 0xFF;
+	blendState->blendFactor.a = 0xFF;
+	blendState->multiSampleMask = -1;
+}
+
+static void MakeSamplerState(FNA3D_SamplerState *samplerState)
+{
+	SDL_zerop(samplerState);
+	samplerState->filter = FNA3D_TEXTUREFILTER_LINEAR;
+	samplerState->addressU = FNA3D_TEXTUREADDRESSMODE_CLAMP;
+	samplerState->addressV = FNA3D_TEXTUREADDRESSMODE_CLAMP;
+	samplerState->addressW = FNA3D_TEXTUREADDRESSMODE_CLAMP;
+	samplerState->maxAnisotropy = 4;
+}
+
+/* Position and color, like a colored SpriteBatch */
+static FNA3D_VertexElement vertexElements[2] =
+{
+	{ 0, FNA3D_VERTEXELEMENTFORMAT_VECTOR3, FNA3D_VERTEXELEMENTUSAGE_POSITION, 0 },
+	{ 12, FNA3D_VERTEXELEMENTFORMAT_COLOR, FNA3D_VERTEXELEMENTUSAGE_COLOR, 0 }
+};
+
+static void MakeBinding(
+	FNA3D_VertexBufferBinding *binding,
+	FNA3D_Buffer *vertexBuffer
+) {
+	binding->vertexBuffer = vertexBuffer;
+	binding->vertexDeclaration.vertexStride = 16;
+	binding->vertexDeclaration.elementCount = 2;
+	binding->vertexDeclaration.elements = vertexElements;
+	binding->vertexOffset = 0;
+	binding->instanceFrequency = 0;
+}
+
+static FNA3D_Buffer* MakeIndexBuffer(FNA3D_Device *device)
+{
+	uint16_t indices[NUM_VERTICES];
+	FNA3D_Buffer *result;
+	int32_t i;
+
+	for (i = 0; i < NUM_VERTICES; i += 1)
+	{
+		indices[i] = (uint16_t) i;
+	}
+	result = FNA3D_GenIndexBuffer(
+		device,
+		0,
+		FNA3D_BUFFERUSAGE_WRITEONLY,
+		sizeof(indices)
+	);
+	FNA3D_SetIndexBufferData(
+		device,
+		result,
+		0,
+		indices,
+		sizeof(indices),
+		FNA3D_SETDATAOPTIONS_NONE
+	);
+	return result;
+}
+
+static void TestDefaultOff(void)
+{
+	FNA3D_Device *device;
+	FNA3D_BlendState blendState;
+	FNA3D_StateFilterStatsEXT stats;
+	int32_t i;
+
+	device = CreateDevice(NULL, NULL);
+	CHECK(device != NULL)
+	if (device == NULL)
+	{
+		return;
+	}
+
+	MakeBlendState(&blendState);
+	for (i = 0; i < 4; i += 1)
+	{
+		FNA3D_SetBlendState(device, &blendState);
+	}
+
+	FNA3D_GetStateFilterStatsEXT(device, &stats);
+	CHECK(stats.blendStatesFiltered == 0)
+	FNA3D_DestroyDevice(device);
+	CHECK(summaryStateChanges == 4)
+}
+
+static void TestFilter(void)
+{
+	FNA3D_Device *device;
+	FNA3D_BlendState blendState;
+	FNA3D_SamplerState samplerState;
+	FNA3D_VertexBufferBinding binding;
+	FNA3D_Viewport viewport;
+	FNA3D_StateFilterStatsEXT stats;
+	FNA3D_Texture *texture;
+	FNA3D_Buffer *vertexBuffer;
+	FNA3D_Color blendFactor;
+	uint8_t pixels[TEXTURE_SIZE * TEXTURE_SIZE * 4];
+
+	device = CreateDevice("1", "0");
+	CHECK(device != NULL)
+	if (device == NULL)
+	{
+		return;
+	}
+
+	/* SetBlendFactor changes part of the last blend state */
+	MakeBlendState(&blendState);
+	FNA3D_SetBlendState(device, &blendState);
+	FNA3D_SetBlendState(device, &blendState);
+	blendFactor.r = 0x80;
+	blendFactor.g = 0x80;
+	blendFactor.b = 0x80;
+	blendFactor.a = 0x80;
+	FNA3D_SetBlendFactor(device, &blendFactor);
+	FNA3D_SetBlendState(device, &blendState);
+	FNA3D_SetBlendFactor(device, &blendFactor);
+	blendState.blendFactor = blendFactor;
+	FNA3D_SetBlendState(device, &blendState);
+	FNA3D_GetStateFilterStatsEXT(device, &stats);
+	CHECK(stats.blendStatesFiltered == 2)
+
+	/* Samplers are filtered until the texture changes behind our back */
+	texture = FNA3D_CreateTexture2D(
+		device,
+		FNA3D_SURFACEFORMAT_COLOR,
+		TEXTURE_SIZE,
+		TEXTURE_SIZE,
+		1,
+		0
+	);
+	MakeSamplerState(&samplerState);
+	FNA3D_VerifySampler(device, 0, texture, &samplerState);
+	FNA3D_VerifySampler(device, 0, texture, &samplerState);
+	FNA3D_VerifySampler(device, 1, texture, &samplerState);
+	FNA3D_GetStateFilterStatsEXT(device, &stats);
+	CHECK(stats.samplersFiltered == 1)
+
+	SDL_memset(pixels, 0x7F, sizeof(pixels));
+	FNA3D_SetTextureData2D(
+		device,
+		texture,
+		0,
+		0,
+		TEXTURE_SIZE,
+		TEXTURE_SIZE,
+		0,
+		pixels,
+		sizeof(pixels)
+	);
+	FNA3D_VerifySampler(device, 0, texture, &samplerState);
+	FNA3D_VerifySampler(device, 0, texture, &samplerState);
+	FNA3D_GetStateFilterStatsEXT(device, &stats);
+	CHECK(stats.samplersFiltered == 2)
+
+	/* Vertex bindings compare the declaration, not the pointer to it */
+	vertexBuffer = FNA3D_GenVertexBuffer(
+		device,
+		0,
+		FNA3D_BUFFERUSAGE_WRITEONLY,
+		NUM_VERTICES * 16
+	);
+	MakeBinding(&binding, vertexBuffer);
+	FNA3D_ApplyVertexBufferBindings(device, &binding, 1, 1, 0);
+	FNA3D_ApplyVertexBufferBindings(device, &binding, 1, 0, 0);
+	FNA3D_ApplyVertexBufferBindings(device, &binding, 1, 0, 4);
+	FNA3D_GetStateFilterStatsEXT(device, &stats);
+	CHECK(stats.vertexBufferBindingsFiltered == 1)
+
+	SDL_zero(viewport);
+	viewport.w = 64;
+	viewport.h = 64;
+	viewport.maxDepth = 1.0f;
+	FNA3D_SetViewport(device, &viewport);
+	FNA3D_ApplyVertexBufferBindings(device, &binding, 1, 0, 4);
+	FNA3D_GetStateFilterStatsEXT(device, &stats);
+	CHECK(stats.vertexBufferBindingsFiltered == 1)
+
+	FNA3D_AddDisposeVertexBuffer(device, vertexBuffer);
+	FNA3D_AddDisposeTexture(device, texture);
+	FNA3D_DestroyDevice(device);
+	CHECK(summaryErrors == 0)
+	CHECK(errorCount == 0)
+}
+
+static void TestMergeDraws(void)
+{
+	FNA3D_Device *device;
+	FNA3D_VertexBufferBinding binding;
+	FNA3D_StateFilterStatsEXT stats;
+	FNA3D_Buffer *vertexBuffer, *indexBuffer;
+
+	device = CreateDevice("1", "1");
+	CHECK(device != NULL)
+	if (device == NULL)
+	{
+		return;
+	}
+
+	vertexBuffer = FNA3D_GenVertexBuffer(
+		device,
+		0,
+		FNA3D_BUFFERUSAGE_WRITEONLY,
+		NUM_VERTICES * 16
+	);
+	indexBuffer = MakeIndexBuffer(device);
+	MakeBinding(&binding, vertexBuffer);
+	FNA3D_ApplyVertexBufferBindings(device, &binding, 1, 1, 0);
+
+	/* Three lists that follow on from each other become one draw */
+	FNA3D_DrawIndexedPrimitives(
+		device,
+		FNA3D_PRIMITIVETYPE_TRIANGLELIST,
+		0, 0, 6, 0, 2,
+		indexBuffer,
+		FNA3D_INDEXELEMENTSIZE_16BIT
+	);
+	FNA3D_ApplyVertexBufferBindings(device, &binding, 1, 0, 0);
+	FNA3D_DrawIndexedPrimitives(
+		device,
+		FNA3D_PRIMITIVETYPE_TRIANGLELIST,
+		0, 6, 6, 6, 2,
+		indexBuffer,
+		FNA3D_INDEXELEMENTSIZE_16BIT
+	);
+	FNA3D_DrawIndexedPrimitives(
+		device,
+		FNA3D_PRIMITIVETYPE_TRIANGLELIST,
+		0, 12, 3, 12, 1,
+		indexBuffer,
+		FNA3D_INDEXELEMENTSIZE_16BIT
+	);
+
+	/* A gap in the index range can't be merged */
+	FNA3D_DrawIndexedPrimitives(
+		device,
+		FNA3D_PRIMITIVETYPE_TRIANGLELIST,
+		0, 30, 3, 30, 1,
+		indexBuffer,
+		FNA3D_INDEXELEMENTSIZE_16BIT
+	);
+
+	/* Neither can strips */
+	FNA3D_DrawIndexedPrimitives(
+		device,
+		FNA3D_PRIMITIVETYPE_TRIANGLESTRIP,
+		0, 0, 4, 0, 2,
+		indexBuffer,
+		FNA3D_INDEXELEMENTSIZE_16BIT
+	);
+	FNA3D_DrawIndexedPrimitives(
+		device,
+		FNA3D_PRIMITIVETYPE_TRIANGLESTRIP,
+		0, 0, 4, 4, 2,
+		indexBuffer,
+		FNA3D_INDEXELEMENTSIZE_16BIT
+	);
+
+	FNA3D_GetStateFilterStatsEXT(device, &stats);
+	CHECK(stats.drawsMerged == 2)
+
+	/* The held draw has to be submitted before the present */
+	FNA3D_SwapBuffers(device, NULL, NULL, NULL);
+
+	FNA3D_AddDisposeVertexBuffer(device, vertexBuffer);
+	FNA3D_AddDisposeIndexBuffer(device, indexBuffer);
+	FNA3D_DestroyDevice(device);
+	CHECK(summaryDraws == 4)
+	CHECK(summaryPrimitives == 10)
+	CHECK(summaryErrors == 0)
+	CHECK(errorCount == 0)
+}
+
+/* Loads resources the way a content loading thread would */
+
+typedef struct LoaderData
+{
+	FNA3D_Device *device;
+	FNA3D_Texture *textures[NUM_THREAD_ITERATIONS];
+	FNA3D_Buffer *buffers[NUM_THREAD_ITERATIONS];
+} LoaderData;
+
+static int SDLCALL LoaderThread(void *userdata)
+{
+	LoaderData *data = (LoaderData*) userdata;
+	uint8_t pixels[TEXTURE_SIZE * TEXTURE_SIZE * 4];
+	uint8_t vertices[NUM_VERTICES * 16];
+	int32_t i;
+
+	SDL_memset(pixels, 0x3F, sizeof(pixels));
+	SDL_memset(vertices, 0, sizeof(vertices));
+	for (i = 0; i < NUM_THREAD_ITERATIONS; i += 1)
+	{
+		data->textures[i] = FNA3D_CreateTexture2D(
+			data->device,
+			FNA3D_SURFACEFORMAT_COLOR,
+			TEXTURE_SIZE,
+			TEXTURE_SIZE,
+			1,
+			0
+		);
+		FNA3D_SetTextureData2D(
+			data->device,
+			data->textures[i],
+			0,
+			0,
+			TEXTURE_SIZE,
+			TEXTURE_SIZE,
+			0,
+			pixels,
+			sizeof(pixels)
+		);
+		FNA3D_GetTextureData2D(
+			data->device,
+			data->textures[i],
+			0,
+			0,
+			TEXTURE_SIZE,
+			TEXTURE_SIZE,
+			0,
+			pixels,
+			sizeof(pixels)
+		);
+		data->buffers[i] = FNA3D_GenVertexBuffer(
+			data->device,
+			0,
+			FNA3D_BUFFERUSAGE_WRITEONLY,
+			sizeof(vertices)
+		);
+		FNA3D_SetVertexBufferData(
+			data->device,
+			data->buffers[i],
+			0,
+			vertices,
+			sizeof(vertices),
+			1,
+			1,
+			FNA3D_SETDATAOPTIONS_NONE
+		);
+	}
+	return 0;
+}
+
+static void TestLoaderThread(void)
+{
+	LoaderData *data;
+	SDL_Thread *thread;
+	FNA3D_BlendState blendState;
+	FNA3D_SamplerState samplerState;
+	FNA3D_VertexBufferBinding binding;
+	FNA3D_StateFilterStatsEXT stats;
+	FNA3D_Texture *texture;
+	FNA3D_Buffer *vertexBuffer, *indexBuffer;
+	uint64_t filtered;
+	int32_t i, draws = 0;
+
+	data = (LoaderData*) SDL_calloc(1, sizeof(LoaderData));
+	data->device = CreateDevice("1", "1");
+	CHECK(data->device != NULL)
+	if (data->device == NULL)
+	{
+		SDL_free(data);
+		return;
+	}
+
+	texture = FNA3D_CreateTexture2D(
+		data->device,
+		FNA3D_SURFACEFORMAT_COLOR,
+		TEXTURE_SIZE,
+		TEXTURE_SIZE,
+		1,
+		0
+	);
+	vertexBuffer = FNA3D_GenVertexBuffer(
+		data->device,
+		0,
+		FNA3D_BUFFERUSAGE_WRITEONLY,
+		NUM_VERTICES * 16
+	);
+	indexBuffer = MakeIndexBuffer(data->device);
+	MakeBlendState(&blendState);
+	MakeSamplerState(&samplerState);
+	MakeBinding(&binding, vertexBuffer);
+
+	/* Draw the same thing over and over while the loader runs */
+	thread = SDL_CreateThread(LoaderThread, "FNA3D Loader", data);
+	CHECK(thread != NULL)
+	for (i = 0; i < NUM_THREAD_ITERATIONS * 4; i += 1)
+	{
+		FNA3D_SetBlendState(data->device, &blendState);
+		FNA3D_VerifySampler(data->device, 0, texture, &samplerState);
+		FNA3D_ApplyVertexBufferBindings(data->device, &binding, 1, i == 0, 0);
+		FNA3D_DrawIndexedPrimitives(
+			data->device,
+			FNA3D_PRIMITIVETYPE_TRIANGLELIST,
+			0, 0, 3, 3 * (i % 16), 1,
+			indexBuffer,
+			FNA3D_INDEXELEMENTSIZE_16BIT
+		);
+		if ((i % 64) == 63)
+		{
+			FNA3D_SwapBuffers(data->device, NULL, NULL, NULL);
+		}
+		draws += 1;
+	}
+	SDL_WaitThread(thread, NULL);
+
+	/* Once the loader is done, filtering has to pick up again */
+	FNA3D_VerifySampler(data->device, 0, texture, &samplerState);
+	FNA3D_GetStateFilterStatsEXT(data->device, &stats);
+	filtered = stats.samplersFiltered;
+	FNA3D_VerifySampler(data->device, 0, texture, &samplerState);
+	FNA3D_GetStateFilterStatsEXT(data->device, &stats);
+	CHECK(stats.samplersFiltered == filtered + 1)
+
+	FNA3D_SwapBuffers(data->device, NULL, NULL, NULL);
+	for (i = 0; i < NUM_THREAD_ITERATIONS; i += 1)
+	{
+		FNA3D_AddDisposeTexture(data->device, data->textures[i]);
+		FNA3D_AddDisposeVertexBuffer(data->device, data->buffers[i]);
+	}
+	FNA3D_AddDisposeTexture(data->device, texture);
+	FNA3D_AddDisposeVertexBuffer(data->device, vertexBuffer);
+	FNA3D_AddDisposeIndexBuffer(data->device, indexBuffer);
+	FNA3D_DestroyDevice(data->device);
+
+	/* Every draw made it, merged or not */
+	CHECK(summaryPrimitives == (unsigned long long) draws)
+	CHECK(summaryDraws + stats.drawsMerged == (unsigned long long) draws)
+	CHECK(summaryErrors == 0)
+	CHECK(errorCount == 0)
+	SDL_free(data);
+}
+
+int main(int argc, char **argv)
+{
+	FNA3D_HookLogFunctions(LogInfo, LogWarn, LogError);
+
+	SDL_SetHint("FNA3D_FORCE_DRIVER", "Null");
+	FNA3D_PrepareWindowAttributes();
+
+	TestDefaultOff();
+	TestFilter();
+	TestMergeDraws();
+	TestLoaderThread();
+
+	SDL_Log(
+		"Finished with %d successful tests and %d failed tests.",
+		successCount,
+		failureCount
+	);
+	return failureCount > 0;
+}